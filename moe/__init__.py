@@ -21,6 +21,11 @@ __version__ = "{0:d}.{1:d}.{2:d}".format(MAJOR, MINOR, PATCH)
 def main(global_config, **settings):
     """Return a WSGI application."""
     config = Configurator(settings=settings, root_factory=Root)
+
+    # Size the process-wide cache of fitted C++ GPs for this deployment's models (bytes; 0 disables caching)
+    if 'gaussian_process_cache.memory_budget' in settings:
+        from moe.optimal_learning.python.cpp_wrappers.gaussian_process import set_gaussian_process_cache_memory_budget
+        set_gaussian_process_cache_memory_budget(int(settings['gaussian_process_cache.memory_budget']))
     config.include('pyramid_mako')
     config.add_static_view('static', 'moe:static')
 
@@ -181,6 +181,7 @@
       OnePotentialSampleExpectedImprovementEvaluator      OnePotentialSampleExpectedImprovementState
       LogMarginalLikelihoodEvaluator                      LogMarginalLikelihoodState
       LeaveOneOutLogLikelihoodEvaluator                   LeaveOneOutLogLikelihoodState
+      StochasticLogMarginalLikelihoodEvaluator            StochasticLogMarginalLikelihoodState
       =================================================  ===============================================
 
       One set of noteable exceptions to this 'rule' is the RNG classes.  These objects' sole purpose
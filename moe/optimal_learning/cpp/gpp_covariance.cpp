@@ -9,7 +9,16 @@
   The shared results are by far the most expensive part of gradient computations; they typically involve exponentiation and are
   further at least partially shared with the base covariance computation.
 
-  TODO(GH-132): compute fcn, gradient, and hessian simultaneously for covariance (optionally skipping some terms).
+  The batch (``*Matrix``) functions evaluate many pairs per call.  The default (CovarianceInterface) versions loop over the
+  per-pair functions.  SquareExponential, MaternNu1p5, and MaternNu2p5 override them: they copy one point list into a
+  dimension-major (structure of arrays) layout so that the distance computations are unit-stride loops over points, which
+  the compiler vectorizes.  These three kernels are all functions of the scaled distance ``r^2`` only, and all of their
+  spatial and length-scale derivatives share the form ``\pderiv{cov}{r^2} * \pderiv{r^2}{\theta}``, so one templated
+  implementation serves all three (see the *Kernel structs below).
+
+  CovarianceWithDerivatives() computes the covariance, hyperparameter gradient, and hyperparameter hessian of one pair
+  together (any subset of them), sharing the distance and the single ``exp`` between them.  The stationary kernels use
+  the same ``r^2`` formulation: the hessian needs one more factor, ``\pderiv{g}{r^2}``, also listed in the *Kernel structs.
 
   TODO(GH-129): Check expression simplification of gradients/hessians (esp the latter) for the various covariance functions.
   Current math was done by hand and maybe I missed something.
@@ -19,11 +28,13 @@
 
 #include <cmath>
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
 #include "gpp_common.hpp"
 #include "gpp_exception.hpp"
+#include "gpp_linear_algebra.hpp"
 
 namespace optimal_learning {
 
@@ -61,11 +72,16 @@ NormSquaredWithInverseWeights(double const * restrict point_one, double const *
     :alpha: the hyperparameter \alpha, (e.g., signal variance, \sigma_f^2)
     :lengths_in: the input length scales, one per spatial dimension
     :lengths_sq[dim]: pointer to an array of at least dim double
+    :inverse_lengths[dim]: pointer to an array of at least dim double
+    :inverse_lengths_sq[dim]: pointer to an array of at least dim double
   \output
     :lengths_sq[dim]: first dim entries overwritten with the square of the entries of lengths_in
+    :inverse_lengths[dim]: first dim entries overwritten with the reciprocals of the entries of lengths_in
+    :inverse_lengths_sq[dim]: first dim entries overwritten with the squares of inverse_lengths
 \endrst*/
 OL_NONNULL_POINTERS void InitializeCovariance(int dim, double alpha, const std::vector<double>& lengths_in,
-                                              double * restrict lengths_sq) {
+                                              double * restrict lengths_sq, double * restrict inverse_lengths,
+                                              double * restrict inverse_lengths_sq) {
   // validate inputs
   if (dim < 0) {
     OL_THROW_EXCEPTION(LowerBoundException<int>, "Negative spatial dimension.", dim, 0);
@@ -79,23 +95,393 @@ OL_NONNULL_POINTERS void InitializeCovariance(int dim, double alpha, const std::
     OL_THROW_EXCEPTION(LowerBoundException<double>, "Invalid hyperparameter (alpha).", alpha, std::numeric_limits<double>::min());
   }
 
-  // fill lengths_sq array
   for (int i = 0; i < dim; ++i) {
-    lengths_sq[i] = Square(lengths_in[i]);
     if (unlikely(lengths_in[i] <= 0.0)) {
       OL_THROW_EXCEPTION(LowerBoundException<double>, "Invalid hyperparameter (length).", lengths_in[i], std::numeric_limits<double>::min());
     }
   }
+
+  // fill lengths_sq, inverse_lengths, inverse_lengths_sq arrays
+  for (int i = 0; i < dim; ++i) {
+    lengths_sq[i] = Square(lengths_in[i]);
+    inverse_lengths[i] = 1.0/lengths_in[i];
+    inverse_lengths_sq[i] = Square(inverse_lengths[i]);
+  }
+}
+
+/*!\rst
+  Computes ``norm_sq_i = \sum_d (points_{d,i} - point_d)^2 * inverse_weights_d`` for ``i = 0..num_points-1``; i.e.,
+  NormSquaredWithInverseWeights() between ``point`` and each of ``points``.
+
+  ``points`` is stored dimension-major (structure of arrays) so that the inner loop is unit-stride over points.
+
+  \param
+    :points_soa[num_points][dim]: list of points, transposed: the ``d``-th coordinate of point ``i`` is
+      ``points_soa[d*lda + i]``
+    :lda: the first dimension of ``points_soa`` as declared by the caller; ``lda >= num_points``
+    :num_points: number of points in ``points_soa``
+    :point[dim]: the other point
+    :inverse_weights[dim]: the reciprocal of the weights (e.g., ``1/L_d^2``)
+    :dim: number of spatial dimensions
+  \output
+    :norm_sq[num_points]: the weighted squared distances
+\endrst*/
+OL_NONNULL_POINTERS void NormSquaredWithInverseWeightsBatch(double const * restrict points_soa, int lda, int num_points,
+                                                            double const * restrict point,
+                                                            double const * restrict inverse_weights, int dim,
+                                                            double * restrict norm_sq) noexcept {
+  std::fill(norm_sq, norm_sq + num_points, 0.0);
+  for (int d = 0; d < dim; ++d) {
+    const double coordinate = point[d];
+    const double inverse_weight = inverse_weights[d];
+    for (int i = 0; i < num_points; ++i) {
+      norm_sq[i] += Square(points_soa[i] - coordinate)*inverse_weight;
+    }
+    points_soa += lda;
+  }
 }
 
+/*!\rst
+  Stationary kernels expressed in terms of ``r^2``, the squared distance scaled by the length scales.  Each provides:
+
+  * ``Value(alpha, r^2)``: the covariance
+  * ``DerivativeFactor(alpha, r^2)``: ``g = -2 * \pderiv{cov}{r^2}``.  Then the spatial gradient is
+    ``\pderiv{cov}{x_{1,d}} = g * (x_{2,d} - x_{1,d}) / L_d^2`` and the length-scale gradient is
+    ``\pderiv{cov}{L_d} = g * q_d``, where ``q_d = ((x_{1,d} - x_{2,d}) / L_d)^2 / L_d``.
+  * ``Factors(alpha, r^2, ...)``: ``Value(alpha, r^2)``, ``Value(1, r^2)``, ``g``, and ``h = -2 * \pderiv{g}{r^2}``, sharing
+    a single ``exp`` (and evaluating the same expressions as Value() and DerivativeFactor(), so results are identical).
+    Then the length-scale hessian is ``\mixpderiv{cov}{L_d}{L_e} = h * q_d * q_e - 3 * g * q_d / L_d * \delta_{d,e}``.
+
+  Note that ``g`` has no ``1/r`` singularity for any of these kernels.  ``h`` has one for MaternNu1p5; but
+  ``q_d * q_e / r -> 0`` as ``r -> 0``, so that kernel reports ``h = 0`` at ``r = 0``.
+\endrst*/
+struct SquareExponentialKernel {
+  static double Value(double alpha, double norm_sq) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT {
+    return alpha*std::exp(-0.5*norm_sq);
+  }
+
+  static double DerivativeFactor(double alpha, double norm_sq) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT {
+    return alpha*std::exp(-0.5*norm_sq);
+  }
+
+  static void Factors(double alpha, double norm_sq, double * restrict value, double * restrict value_per_alpha,
+                      double * restrict derivative_factor, double * restrict second_derivative_factor) noexcept OL_NONNULL_POINTERS {
+    const double exp_part = std::exp(-0.5*norm_sq);
+    *value = alpha*exp_part;
+    *value_per_alpha = exp_part;
+    *derivative_factor = *value;
+    *second_derivative_factor = *value;
+  }
+};
+
+struct MaternNu1p5Kernel {
+  static double Value(double alpha, double norm_sq) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT {
+    const double matern_arg = kSqrt3 * std::sqrt(norm_sq);
+    return alpha*(1.0 + matern_arg)*std::exp(-matern_arg);
+  }
+
+  static double DerivativeFactor(double alpha, double norm_sq) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT {
+    const double matern_arg = kSqrt3 * std::sqrt(norm_sq);
+    return 3.0*alpha*std::exp(-matern_arg);
+  }
+
+  static void Factors(double alpha, double norm_sq, double * restrict value, double * restrict value_per_alpha,
+                      double * restrict derivative_factor, double * restrict second_derivative_factor) noexcept OL_NONNULL_POINTERS {
+    const double norm_val = std::sqrt(norm_sq);
+    const double matern_arg = kSqrt3 * norm_val;
+    const double exp_part = std::exp(-matern_arg);
+    *value = alpha*(1.0 + matern_arg)*exp_part;
+    *value_per_alpha = (1.0 + matern_arg)*exp_part;
+    *derivative_factor = 3.0*alpha*exp_part;
+    *second_derivative_factor = norm_sq == 0.0 ? 0.0 : kSqrt3*(*derivative_factor)/norm_val;
+  }
+};
+
+struct MaternNu2p5Kernel {
+  static double Value(double alpha, double norm_sq) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT {
+    const double matern_arg = kSqrt5 * std::sqrt(norm_sq);
+    return alpha*(1.0 + matern_arg + 5.0/3.0*norm_sq)*std::exp(-matern_arg);
+  }
+
+  static double DerivativeFactor(double alpha, double norm_sq) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT {
+    const double matern_arg = kSqrt5 * std::sqrt(norm_sq);
+    return 5.0/3.0*alpha*(1.0 + matern_arg)*std::exp(-matern_arg);
+  }
+
+  static void Factors(double alpha, double norm_sq, double * restrict value, double * restrict value_per_alpha,
+                      double * restrict derivative_factor, double * restrict second_derivative_factor) noexcept OL_NONNULL_POINTERS {
+    const double matern_arg = kSqrt5 * std::sqrt(norm_sq);
+    const double exp_part = std::exp(-matern_arg);
+    *value = alpha*(1.0 + matern_arg + 5.0/3.0*norm_sq)*exp_part;
+    *value_per_alpha = (1.0 + matern_arg + 5.0/3.0*norm_sq)*exp_part;
+    *derivative_factor = 5.0/3.0*alpha*(1.0 + matern_arg)*exp_part;
+    *second_derivative_factor = 25.0/3.0*alpha*exp_part;
+  }
+};
+
+/*!\rst
+  CovarianceInterface::CovarianceWithDerivatives() for any stationary kernel of the form described above (see e.g.,
+  SquareExponentialKernel), with hyperparameters ``[alpha, lengths[dim]]``.  Inputs and outputs match those of
+  CovarianceInterface::CovarianceWithDerivatives().
+\endrst*/
+template <typename Kernel>
+void StationaryCovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two,
+                                         int outputs, double alpha, double const * restrict lengths, int dim,
+                                         double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                         double * restrict hessian_hyperparameter_cov) noexcept {
+  // distances are formed exactly as in StationaryCovarianceBatch so that both produce identical results
+  double norm_sq = 0.0;
+  for (int d = 0; d < dim; ++d) {
+    const double inverse_length = 1.0/lengths[d];
+    norm_sq += Square(point_one[d] - point_two[d])*Square(inverse_length);
+  }
+  double value, value_per_alpha, derivative_factor, second_derivative_factor;
+  Kernel::Factors(alpha, norm_sq, &value, &value_per_alpha, &derivative_factor, &second_derivative_factor);
+
+  if (outputs & CovarianceInterface::kCovarianceValue) {
+    *cov = value;
+  }
+
+  if (outputs & CovarianceInterface::kHyperparameterGradient) {
+    grad_hyperparameter_cov[0] = value_per_alpha;
+    for (int d = 0; d < dim; ++d) {
+      const double inverse_length = 1.0/lengths[d];
+      grad_hyperparameter_cov[d+1] = Square(point_one[d] - point_two[d])*(Square(inverse_length)*inverse_length)*
+          derivative_factor;
+    }
+  }
+
+  if (outputs & CovarianceInterface::kHyperparameterHessian) {
+    const int num_hyperparameters = dim + 1;
+    // the first column temporarily holds q_d (shifted by one to match hyperparameter indexing); NOT restrict: the
+    // alpha row/column loop below reads q_d through this alias while overwriting it through hessian_hyperparameter_cov
+    double * scaled_distance = hessian_hyperparameter_cov;
+    for (int d = 0; d < dim; ++d) {
+      const double inverse_length = 1.0/lengths[d];
+      scaled_distance[d+1] = Square(point_one[d] - point_two[d])*(Square(inverse_length)*inverse_length);
+    }
+
+    // length-scale block; the hessian is symmetric, so compute the lower triangle and copy it to the upper triangle
+    for (int j = 1; j < num_hyperparameters; ++j) {
+      double * restrict hessian_column = hessian_hyperparameter_cov + j*num_hyperparameters;
+      for (int i = 1; i < j; ++i) {
+        hessian_column[i] = hessian_hyperparameter_cov[i*num_hyperparameters + j];
+      }
+      hessian_column[j] = scaled_distance[j]*(second_derivative_factor*scaled_distance[j] -
+                                              3.0*derivative_factor/lengths[j-1]);
+      for (int i = j+1; i < num_hyperparameters; ++i) {
+        hessian_column[i] = second_derivative_factor*scaled_distance[i]*scaled_distance[j];
+      }
+    }
+
+    // alpha row/column: cov is linear in alpha, so these are the length-scale gradients divided by alpha
+    hessian_hyperparameter_cov[0] = 0.0;
+    for (int i = 1; i < num_hyperparameters; ++i) {
+      hessian_hyperparameter_cov[i] = derivative_factor*scaled_distance[i]/alpha;
+      hessian_hyperparameter_cov[i*num_hyperparameters] = hessian_hyperparameter_cov[i];
+    }
+  }
+}
+
+/*!\rst
+  Scratch space for the SoA point copies and derivative factors of StationaryCovarianceBatch.  One buffer per thread,
+  grown as needed and never shrunk, so steady-state batch calls do not allocate.  The batch functions do not call each
+  other, so one buffer per thread suffices.
+
+  \param
+    :size: number of doubles needed
+  \return
+    pointer to at least ``size`` doubles, valid until the next call on this thread
+\endrst*/
+double * BatchCovarianceScratch(int size) {
+  thread_local std::vector<double> scratch;
+  if (unlikely(scratch.size() < static_cast<std::size_t>(size))) {
+    scratch.resize(size);
+  }
+  return scratch.data();
+}
+
+/*!\rst
+  Batch covariance functions for any stationary kernel of the form described above (see e.g., SquareExponentialKernel).
+  Implements CovarianceInterface::CovarianceMatrix(), etc. for SquareExponential, MaternNu1p5, and MaternNu2p5.
+  Function names, inputs, and outputs match those of CovarianceInterface; additionally, the constructor takes ``dim``,
+  ``alpha``, and the inverse length scales ``1/L_d`` and ``1/L_d^2`` (cached by the covariance object, which must
+  outlive this one).  Constructing one does not allocate; point (SoA) scratch comes from BatchCovarianceScratch().
+\endrst*/
+template <typename Kernel>
+class StationaryCovarianceBatch {
+ public:
+  StationaryCovarianceBatch(int dim, double alpha, double const * restrict inverse_lengths,
+                            double const * restrict inverse_lengths_sq) noexcept
+      : dim_(dim), alpha_(alpha), inverse_lengths_(inverse_lengths), inverse_lengths_sq_(inverse_lengths_sq) {
+  }
+
+  void CovarianceMatrix(double const * restrict points_one, int num_points_one, double const * restrict points_two,
+                        int num_points_two, double * restrict cov_matrix) const noexcept {
+    double * restrict points_one_soa = BatchCovarianceScratch(dim_*num_points_one);
+    MatrixTranspose(points_one, dim_, num_points_one, points_one_soa);
+    for (int j = 0; j < num_points_two; ++j) {
+      NormSquaredWithInverseWeightsBatch(points_one_soa, num_points_one, num_points_one, points_two + j*dim_,
+                                         inverse_lengths_sq_, dim_, cov_matrix);
+      for (int i = 0; i < num_points_one; ++i) {
+        cov_matrix[i] = Kernel::Value(alpha_, cov_matrix[i]);
+      }
+      cov_matrix += num_points_one;
+    }
+  }
+
+  void SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                 double * restrict cov_matrix) const noexcept {
+    double * restrict points_soa = BatchCovarianceScratch(dim_*num_points);
+    MatrixTranspose(points, dim_, num_points, points_soa);
+    // column j: rows i = j..num_points-1
+    for (int j = 0; j < num_points; ++j) {
+      double * restrict cov_column = cov_matrix + j*num_points + j;
+      NormSquaredWithInverseWeightsBatch(points_soa + j, num_points, num_points - j, points + j*dim_,
+                                         inverse_lengths_sq_, dim_, cov_column);
+      for (int i = 0; i < num_points - j; ++i) {
+        cov_column[i] = Kernel::Value(alpha_, cov_column[i]);
+      }
+    }
+  }
+
+  void GradCovarianceMatrix(double const * restrict points_one, int num_points_one, double const * restrict points_two,
+                            int num_points_two, double * restrict grad_cov) const noexcept {
+    // points_two varies fastest (after dim) in the output, so it is the one made unit-stride
+    double * restrict points_two_soa = BatchCovarianceScratch((dim_+1)*num_points_two);
+    double * restrict derivative_factor = points_two_soa + dim_*num_points_two;
+    MatrixTranspose(points_two, dim_, num_points_two, points_two_soa);
+    for (int i = 0; i < num_points_one; ++i) {
+      double const * restrict point_one = points_one + i*dim_;
+      NormSquaredWithInverseWeightsBatch(points_two_soa, num_points_two, num_points_two, point_one,
+                                         inverse_lengths_sq_, dim_, derivative_factor);
+      for (int j = 0; j < num_points_two; ++j) {
+        derivative_factor[j] = Kernel::DerivativeFactor(alpha_, derivative_factor[j]);
+      }
+      for (int d = 0; d < dim_; ++d) {
+        double const * restrict coordinates_two = points_two_soa + d*num_points_two;
+        for (int j = 0; j < num_points_two; ++j) {
+          grad_cov[j*dim_ + d] = (coordinates_two[j] - point_one[d])*inverse_lengths_sq_[d]*derivative_factor[j];
+        }
+      }
+      grad_cov += num_points_two*dim_;
+    }
+  }
+
+  void HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                          double const * restrict points_two, int num_points_two,
+                                          double * restrict grad_hyperparameter_cov) const noexcept {
+    const int block_size = num_points_one*num_points_two;
+    double * restrict points_one_soa = BatchCovarianceScratch((dim_+1)*num_points_one);
+    double * restrict derivative_factor = points_one_soa + dim_*num_points_one;
+    MatrixTranspose(points_one, dim_, num_points_one, points_one_soa);
+    for (int j = 0; j < num_points_two; ++j) {
+      double const * restrict point_two = points_two + j*dim_;
+      // d/d\alpha is cov/\alpha; the r^2 values are staged in the alpha block
+      double * restrict grad_alpha = grad_hyperparameter_cov + j*num_points_one;
+      NormSquaredWithInverseWeightsBatch(points_one_soa, num_points_one, num_points_one, point_two,
+                                         inverse_lengths_sq_, dim_, grad_alpha);
+      for (int i = 0; i < num_points_one; ++i) {
+        derivative_factor[i] = Kernel::DerivativeFactor(alpha_, grad_alpha[i]);
+        grad_alpha[i] = Kernel::Value(1.0, grad_alpha[i]);
+      }
+      for (int d = 0; d < dim_; ++d) {
+        double const * restrict coordinates_one = points_one_soa + d*num_points_one;
+        double * restrict grad_length = grad_hyperparameter_cov + (d+1)*block_size + j*num_points_one;
+        const double scale = inverse_lengths_sq_[d]*inverse_lengths_[d];
+        for (int i = 0; i < num_points_one; ++i) {
+          grad_length[i] = Square(coordinates_one[i] - point_two[d])*scale*derivative_factor[i];
+        }
+      }
+    }
+  }
+
+ private:
+  //! dimension of the problem
+  int dim_;
+  //! ``\sigma_f^2``, signal variance
+  double alpha_;
+  //! ``1/L_d`` (owned by the covariance object)
+  double const * restrict inverse_lengths_;
+  //! ``1/L_d^2`` (owned by the covariance object)
+  double const * restrict inverse_lengths_sq_;
+};
+
 }  // end unnamed namespace
 
+void CovarianceInterface::CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                           double const * restrict points_two, int num_points_two,
+                                           double * restrict cov_matrix) const noexcept {
+  const int dim = GetDimension();
+  for (int j = 0; j < num_points_two; ++j) {
+    for (int i = 0; i < num_points_one; ++i) {
+      cov_matrix[i] = Covariance(points_one + i*dim, points_two + j*dim);
+    }
+    cov_matrix += num_points_one;
+  }
+}
+
+void CovarianceInterface::SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                                    double * restrict cov_matrix) const noexcept {
+  const int dim = GetDimension();
+  for (int j = 0; j < num_points; ++j) {
+    for (int i = j; i < num_points; ++i) {
+      cov_matrix[i] = Covariance(points + i*dim, points + j*dim);
+    }
+    cov_matrix += num_points;
+  }
+}
+
+void CovarianceInterface::GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                               double const * restrict points_two, int num_points_two,
+                                               double * restrict grad_cov) const noexcept {
+  const int dim = GetDimension();
+  for (int i = 0; i < num_points_one; ++i) {
+    for (int j = 0; j < num_points_two; ++j) {
+      GradCovariance(points_one + i*dim, points_two + j*dim, grad_cov);
+      grad_cov += dim;
+    }
+  }
+}
+
+void CovarianceInterface::HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                             double const * restrict points_two, int num_points_two,
+                                                             double * restrict grad_hyperparameter_cov) const noexcept {
+  const int dim = GetDimension();
+  const int num_hyperparameters = GetNumberOfHyperparameters();
+  const int block_size = num_points_one*num_points_two;
+  std::vector<double> grad_covariance(num_hyperparameters);
+  for (int j = 0; j < num_points_two; ++j) {
+    for (int i = 0; i < num_points_one; ++i) {
+      HyperparameterGradCovariance(points_one + i*dim, points_two + j*dim, grad_covariance.data());
+      for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+        grad_hyperparameter_cov[i_hyper*block_size + j*num_points_one + i] = grad_covariance[i_hyper];
+      }
+    }
+  }
+}
+
+void CovarianceInterface::CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two,
+                                                    int outputs, double * restrict cov,
+                                                    double * restrict grad_hyperparameter_cov,
+                                                    double * restrict hessian_hyperparameter_cov) const noexcept {
+  if (outputs & kCovarianceValue) {
+    *cov = Covariance(point_one, point_two);
+  }
+  if (outputs & kHyperparameterGradient) {
+    HyperparameterGradCovariance(point_one, point_two, grad_hyperparameter_cov);
+  }
+  if (outputs & kHyperparameterHessian) {
+    HyperparameterHessianCovariance(point_one, point_two, hessian_hyperparameter_cov);
+  }
+}
+
 void SquareExponential::Initialize() {
-  InitializeCovariance(dim_, alpha_, lengths_, lengths_sq_.data());
+  InitializeCovariance(dim_, alpha_, lengths_, lengths_sq_.data(), inverse_lengths_.data(), inverse_lengths_sq_.data());
 }
 
 SquareExponential::SquareExponential(int dim, double alpha, std::vector<double> lengths)
-    : dim_(dim), alpha_(alpha), lengths_(lengths), lengths_sq_(dim) {
+    : dim_(dim), alpha_(alpha), lengths_(lengths), lengths_sq_(dim), inverse_lengths_(dim), inverse_lengths_sq_(dim) {
   Initialize();
 }
 
@@ -195,6 +581,40 @@ void SquareExponential::HyperparameterHessianCovariance(double const * restrict
   }
 }
 
+void SquareExponential::CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two,
+                                                  int outputs, double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                                  double * restrict hessian_hyperparameter_cov) const noexcept {
+  StationaryCovarianceWithDerivatives<SquareExponentialKernel>(point_one, point_two, outputs, alpha_, lengths_.data(),
+                                                               dim_, cov, grad_hyperparameter_cov, hessian_hyperparameter_cov);
+}
+
+void SquareExponential::CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                         double const * restrict points_two, int num_points_two,
+                                         double * restrict cov_matrix) const noexcept {
+  StationaryCovarianceBatch<SquareExponentialKernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).CovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, cov_matrix);
+}
+
+void SquareExponential::SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                                  double * restrict cov_matrix) const noexcept {
+  StationaryCovarianceBatch<SquareExponentialKernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).SymmetricCovarianceMatrix(
+      points, num_points, cov_matrix);
+}
+
+void SquareExponential::GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                             double const * restrict points_two, int num_points_two,
+                                             double * restrict grad_cov) const noexcept {
+  StationaryCovarianceBatch<SquareExponentialKernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).GradCovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, grad_cov);
+}
+
+void SquareExponential::HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                           double const * restrict points_two, int num_points_two,
+                                                           double * restrict grad_hyperparameter_cov) const noexcept {
+  StationaryCovarianceBatch<SquareExponentialKernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).HyperparameterGradCovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, grad_hyperparameter_cov);
+}
+
 CovarianceInterface * SquareExponential::Clone() const {
   return new SquareExponential(*this);
 }
@@ -267,16 +687,40 @@ void SquareExponentialSingleLength::HyperparameterHessianCovariance(double const
   hessian_hyperparameter_cov[3] = cov*(Square(scaled_norm_val) - 3.0*scaled_norm_val/length_);
 }
 
+void SquareExponentialSingleLength::CovarianceWithDerivatives(double const * restrict point_one,
+                                                              double const * restrict point_two, int outputs,
+                                                              double * restrict cov,
+                                                              double * restrict grad_hyperparameter_cov,
+                                                              double * restrict hessian_hyperparameter_cov) const noexcept {
+  const double norm_val = NormSquaredWithConstInverseWeights(point_one, point_two, length_sq_, dim_);
+  const double cov_value = alpha_*std::exp(-0.5*norm_val);
+  const double scaled_norm_val = norm_val/length_;
+
+  if (outputs & kCovarianceValue) {
+    *cov = cov_value;
+  }
+  if (outputs & kHyperparameterGradient) {
+    grad_hyperparameter_cov[0] = cov_value/alpha_;
+    grad_hyperparameter_cov[1] = cov_value*scaled_norm_val;
+  }
+  if (outputs & kHyperparameterHessian) {
+    hessian_hyperparameter_cov[0] = 0.0;
+    hessian_hyperparameter_cov[1] = cov_value/alpha_*scaled_norm_val;
+    hessian_hyperparameter_cov[2] = hessian_hyperparameter_cov[1];
+    hessian_hyperparameter_cov[3] = cov_value*(Square(scaled_norm_val) - 3.0*scaled_norm_val/length_);
+  }
+}
+
 CovarianceInterface * SquareExponentialSingleLength::Clone() const {
   return new SquareExponentialSingleLength(*this);
 }
 
 void MaternNu1p5::Initialize() {
-  InitializeCovariance(dim_, alpha_, lengths_, lengths_sq_.data());
+  InitializeCovariance(dim_, alpha_, lengths_, lengths_sq_.data(), inverse_lengths_.data(), inverse_lengths_sq_.data());
 }
 
 MaternNu1p5::MaternNu1p5(int dim, double alpha, std::vector<double> lengths)
-    : dim_(dim), alpha_(alpha), lengths_(lengths), lengths_sq_(dim) {
+    : dim_(dim), alpha_(alpha), lengths_(lengths), lengths_sq_(dim), inverse_lengths_(dim), inverse_lengths_sq_(dim) {
   Initialize();
 }
 
@@ -394,16 +838,50 @@ void MaternNu1p5::HyperparameterHessianCovariance(double const * restrict point_
   }
 }
 
+void MaternNu1p5::CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two,
+                                            int outputs, double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                            double * restrict hessian_hyperparameter_cov) const noexcept {
+  StationaryCovarianceWithDerivatives<MaternNu1p5Kernel>(point_one, point_two, outputs, alpha_, lengths_.data(),
+                                                         dim_, cov, grad_hyperparameter_cov, hessian_hyperparameter_cov);
+}
+
+void MaternNu1p5::CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                   double const * restrict points_two, int num_points_two,
+                                   double * restrict cov_matrix) const noexcept {
+  StationaryCovarianceBatch<MaternNu1p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).CovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, cov_matrix);
+}
+
+void MaternNu1p5::SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                            double * restrict cov_matrix) const noexcept {
+  StationaryCovarianceBatch<MaternNu1p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).SymmetricCovarianceMatrix(
+      points, num_points, cov_matrix);
+}
+
+void MaternNu1p5::GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                       double const * restrict points_two, int num_points_two,
+                                       double * restrict grad_cov) const noexcept {
+  StationaryCovarianceBatch<MaternNu1p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).GradCovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, grad_cov);
+}
+
+void MaternNu1p5::HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                     double const * restrict points_two, int num_points_two,
+                                                     double * restrict grad_hyperparameter_cov) const noexcept {
+  StationaryCovarianceBatch<MaternNu1p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).HyperparameterGradCovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, grad_hyperparameter_cov);
+}
+
 CovarianceInterface * MaternNu1p5::Clone() const {
   return new MaternNu1p5(*this);
 }
 
 void MaternNu2p5::Initialize() {
-  InitializeCovariance(dim_, alpha_, lengths_, lengths_sq_.data());
+  InitializeCovariance(dim_, alpha_, lengths_, lengths_sq_.data(), inverse_lengths_.data(), inverse_lengths_sq_.data());
 }
 
 MaternNu2p5::MaternNu2p5(int dim, double alpha, std::vector<double> lengths)
-    : dim_(dim), alpha_(alpha), lengths_(lengths), lengths_sq_(dim) {
+    : dim_(dim), alpha_(alpha), lengths_(lengths), lengths_sq_(dim), inverse_lengths_(dim), inverse_lengths_sq_(dim) {
   Initialize();
 }
 
@@ -529,6 +1007,40 @@ void MaternNu2p5::HyperparameterHessianCovariance(double const * restrict point_
   }
 }
 
+void MaternNu2p5::CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two,
+                                            int outputs, double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                            double * restrict hessian_hyperparameter_cov) const noexcept {
+  StationaryCovarianceWithDerivatives<MaternNu2p5Kernel>(point_one, point_two, outputs, alpha_, lengths_.data(),
+                                                         dim_, cov, grad_hyperparameter_cov, hessian_hyperparameter_cov);
+}
+
+void MaternNu2p5::CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                   double const * restrict points_two, int num_points_two,
+                                   double * restrict cov_matrix) const noexcept {
+  StationaryCovarianceBatch<MaternNu2p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).CovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, cov_matrix);
+}
+
+void MaternNu2p5::SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                            double * restrict cov_matrix) const noexcept {
+  StationaryCovarianceBatch<MaternNu2p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).SymmetricCovarianceMatrix(
+      points, num_points, cov_matrix);
+}
+
+void MaternNu2p5::GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                       double const * restrict points_two, int num_points_two,
+                                       double * restrict grad_cov) const noexcept {
+  StationaryCovarianceBatch<MaternNu2p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).GradCovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, grad_cov);
+}
+
+void MaternNu2p5::HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                     double const * restrict points_two, int num_points_two,
+                                                     double * restrict grad_hyperparameter_cov) const noexcept {
+  StationaryCovarianceBatch<MaternNu2p5Kernel>(dim_, alpha_, inverse_lengths_.data(), inverse_lengths_sq_.data()).HyperparameterGradCovarianceMatrix(
+      points_one, num_points_one, points_two, num_points_two, grad_hyperparameter_cov);
+}
+
 CovarianceInterface * MaternNu2p5::Clone() const {
   return new MaternNu2p5(*this);
 }
@@ -52,10 +52,27 @@ namespace optimal_learning {
 
   Hyperparameters (denoted ``\theta_j``) are stored as class member data by subclasses.
 
-  This class has *only* pure virtual functions, making it abstract. Users cannot instantiate this class directly.
+  The batch functions (CovarianceMatrix(), SymmetricCovarianceMatrix(), GradCovarianceMatrix(),
+  HyperparameterGradCovarianceMatrix()) fill a whole block of pairs in one (virtual) call.  Their default implementations
+  loop over the per-pair functions; subclasses should override them with loops that the compiler can vectorize.
+  Similarly, CovarianceWithDerivatives() computes the value, hyperparameter gradient, and hyperparameter hessian of one
+  pair together; its default implementation calls the individual functions.
+
+  Apart from those, this class has *only* pure virtual functions, making it abstract. Users cannot instantiate this
+  class directly.
 \endrst*/
 class CovarianceInterface {
  public:
+  /*!\rst
+    Flags selecting the outputs of CovarianceWithDerivatives().  Combine with bitwise or, e.g.,
+    ``kHyperparameterGradient | kHyperparameterHessian``.
+  \endrst*/
+  enum CovarianceOutputs {
+    kCovarianceValue = 1,  //!< ``cov(x_1, x_2)``, as in Covariance()
+    kHyperparameterGradient = 2,  //!< as in HyperparameterGradCovariance()
+    kHyperparameterHessian = 4,  //!< as in HyperparameterHessianCovariance()
+  };
+
   virtual ~CovarianceInterface() = default;
 
   /*!\rst
@@ -140,6 +157,101 @@ class CovarianceInterface {
   \endrst*/
   virtual void HyperparameterHessianCovariance(double const * restrict point_one, double const * restrict point_two, double * restrict hessian_hyperparameter_cov) const noexcept OL_NONNULL_POINTERS = 0;
 
+  /*!\rst
+    Computes any combination of Covariance(), HyperparameterGradCovariance(), and HyperparameterHessianCovariance() for one
+    pair of points at once.  Those three share the (scaled) distance and the transcendental (``exp``, ``sqrt``) terms, so
+    requesting several outputs here is cheaper than calling the individual functions.
+
+    Outputs not selected in ``outputs`` are not accessed and may be ``nullptr``.  The default implementation calls the
+    individual functions.
+
+    Let n_hyper = this.GetNumberOfHyperparameters()
+
+    \param
+      :point_one[dim]: first spatial coordinate
+      :point_two[dim]: second spatial coordinate
+      :outputs: bitwise or of CovarianceOutputs flags selecting the quantities to compute
+    \output
+      :cov[1]: ``cov(x_1, x_2)`` if ``kCovarianceValue`` is set
+      :grad_hyperparameter_cov[n_hyper]: hyperparameter gradient if ``kHyperparameterGradient`` is set
+      :hessian_hyperparameter_cov[n_hyper][n_hyper]: hyperparameter hessian if ``kHyperparameterHessian`` is set
+  \endrst*/
+  virtual void CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two, int outputs,
+                                         double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                         double * restrict hessian_hyperparameter_cov) const noexcept;
+
+  /*!\rst
+    Returns the number of spatial dimensions of the points this covariance operates on.
+
+    \return
+      The spatial dimension, ``dim``.
+  \endrst*/
+  virtual int GetDimension() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT = 0;
+
+  /*!\rst
+    Computes the covariance between every pair of points from two lists:
+    ``cov_matrix_{i,j} = Covariance(points_one_i, points_two_j)``.
+
+    \param
+      :points_one[dim][num_points_one]: first list of points
+      :num_points_one: number of points in ``points_one``
+      :points_two[dim][num_points_two]: second list of points
+      :num_points_two: number of points in ``points_two``
+    \output
+      :cov_matrix[num_points_one][num_points_two]: covariance matrix (column-major; i.e., ``points_one`` varies fastest)
+  \endrst*/
+  virtual void CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                double const * restrict points_two, int num_points_two,
+                                double * restrict cov_matrix) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Computes the covariance matrix of a list of points with itself, ``cov_matrix_{i,j} = Covariance(points_i, points_j)``.
+    Only the lower triangle (including the diagonal) is written; the strict upper triangle is NOT accessed.
+
+    \param
+      :points[dim][num_points]: list of points
+      :num_points: number of points
+    \output
+      :cov_matrix[num_points][num_points]: lower triangle of the (symmetric) covariance matrix
+  \endrst*/
+  virtual void SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                         double * restrict cov_matrix) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Computes GradCovariance() for every pair of points from two lists: ``grad_cov_{d,j,i}`` is the derivative of
+    ``Covariance(points_one_i, points_two_j)`` with respect to the ``d``-th coordinate of ``points_one_i``.
+
+    \param
+      :points_one[dim][num_points_one]: points to differentiate against
+      :num_points_one: number of points in ``points_one``
+      :points_two[dim][num_points_two]: second list of points
+      :num_points_two: number of points in ``points_two``
+    \output
+      :grad_cov[dim][num_points_two][num_points_one]: gradients; i.e., the ``dim``-vector for the pair ``(i, j)`` starts
+        at ``grad_cov + (i*num_points_two + j)*dim``, matching the output of GradCovariance()
+  \endrst*/
+  virtual void GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                    double const * restrict points_two, int num_points_two,
+                                    double * restrict grad_cov) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Computes HyperparameterGradCovariance() for every pair of points from two lists.  The output is stored as
+    ``num_hyperparameters`` matrices, each laid out like the output of CovarianceMatrix(): the ``k``-th block holds
+    ``\pderiv{Covariance(points_one_i, points_two_j)}{\theta_k}``.
+
+    \param
+      :points_one[dim][num_points_one]: first list of points
+      :num_points_one: number of points in ``points_one``
+      :points_two[dim][num_points_two]: second list of points
+      :num_points_two: number of points in ``points_two``
+    \output
+      :grad_hyperparameter_cov[num_points_one][num_points_two][num_hyperparameters]: hyperparameter gradients
+        (``points_one`` varies fastest, then ``points_two``, then hyperparameters)
+  \endrst*/
+  virtual void HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                  double const * restrict points_two, int num_points_two,
+                                                  double * restrict grad_hyperparameter_cov) const noexcept OL_NONNULL_POINTERS;
+
   /*!\rst
     Sets the hyperparameters.  Hyperparameter ordering is defined implicitly by GetHyperparameters: ``[alpha=\sigma_f^2, length_0, ..., length_{n-1}]``
 
@@ -221,6 +333,29 @@ class SquareExponential final : public CovarianceInterface {
   virtual void HyperparameterHessianCovariance(double const * restrict point_one, double const * restrict point_two,
                                                double * restrict hessian_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
 
+  virtual void CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two, int outputs,
+                                         double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                         double * restrict hessian_hyperparameter_cov) const noexcept override;
+
+  virtual int GetDimension() const noexcept override OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  virtual void CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                double const * restrict points_two, int num_points_two,
+                                double * restrict cov_matrix) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                         double * restrict cov_matrix) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                    double const * restrict points_two, int num_points_two,
+                                    double * restrict grad_cov) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                  double const * restrict points_two, int num_points_two,
+                                                  double * restrict grad_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
+
   virtual void SetHyperparameters(double const * restrict hyperparameters) noexcept override OL_NONNULL_POINTERS {
     alpha_ = hyperparameters[0];
 
@@ -228,6 +363,8 @@ class SquareExponential final : public CovarianceInterface {
     for (int i = 0; i < dim_; ++i) {
       lengths_[i] = hyperparameters[i];
       lengths_sq_[i] = Square(hyperparameters[i]);
+      inverse_lengths_[i] = 1.0/hyperparameters[i];
+      inverse_lengths_sq_[i] = Square(inverse_lengths_[i]);
     }
   }
 
@@ -259,6 +396,10 @@ class SquareExponential final : public CovarianceInterface {
   std::vector<double> lengths_;
   //! square of the length scales, one per dimension
   std::vector<double> lengths_sq_;
+  //! ``1/L_d``, one per dimension (for the batch functions)
+  std::vector<double> inverse_lengths_;
+  //! ``1/L_d^2``, one per dimension (for the batch functions)
+  std::vector<double> inverse_lengths_sq_;
 };
 
 /*!\rst
@@ -306,6 +447,14 @@ class SquareExponentialSingleLength final : public CovarianceInterface {
   virtual void HyperparameterHessianCovariance(double const * restrict point_one, double const * restrict point_two,
                                                double * restrict hessian_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
 
+  virtual void CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two, int outputs,
+                                         double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                         double * restrict hessian_hyperparameter_cov) const noexcept override;
+
+  virtual int GetDimension() const noexcept override OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
   virtual void SetHyperparameters(double const * restrict hyperparameters) noexcept override OL_NONNULL_POINTERS {
     alpha_ = hyperparameters[0];
     length_ = hyperparameters[1];
@@ -396,6 +545,29 @@ class MaternNu1p5 final : public CovarianceInterface {
   virtual void HyperparameterHessianCovariance(double const * restrict point_one, double const * restrict point_two,
                                                double * restrict hessian_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
 
+  virtual void CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two, int outputs,
+                                         double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                         double * restrict hessian_hyperparameter_cov) const noexcept override;
+
+  virtual int GetDimension() const noexcept override OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  virtual void CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                double const * restrict points_two, int num_points_two,
+                                double * restrict cov_matrix) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                         double * restrict cov_matrix) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                    double const * restrict points_two, int num_points_two,
+                                    double * restrict grad_cov) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                  double const * restrict points_two, int num_points_two,
+                                                  double * restrict grad_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
+
   virtual void SetHyperparameters(double const * restrict hyperparameters) noexcept override OL_NONNULL_POINTERS {
     alpha_ = hyperparameters[0];
 
@@ -403,6 +575,8 @@ class MaternNu1p5 final : public CovarianceInterface {
     for (int i = 0; i < dim_; ++i) {
       lengths_[i] = hyperparameters[i];
       lengths_sq_[i] = Square(hyperparameters[i]);
+      inverse_lengths_[i] = 1.0/hyperparameters[i];
+      inverse_lengths_sq_[i] = Square(inverse_lengths_[i]);
     }
   }
 
@@ -434,6 +608,10 @@ class MaternNu1p5 final : public CovarianceInterface {
   std::vector<double> lengths_;
   //! square of the length scales, one per dimension
   std::vector<double> lengths_sq_;
+  //! ``1/L_d``, one per dimension (for the batch functions)
+  std::vector<double> inverse_lengths_;
+  //! ``1/L_d^2``, one per dimension (for the batch functions)
+  std::vector<double> inverse_lengths_sq_;
 };
 
 /*!\rst
@@ -495,6 +673,29 @@ class MaternNu2p5 final : public CovarianceInterface {
   virtual void HyperparameterHessianCovariance(double const * restrict point_one, double const * restrict point_two,
                                                double * restrict hessian_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
 
+  virtual void CovarianceWithDerivatives(double const * restrict point_one, double const * restrict point_two, int outputs,
+                                         double * restrict cov, double * restrict grad_hyperparameter_cov,
+                                         double * restrict hessian_hyperparameter_cov) const noexcept override;
+
+  virtual int GetDimension() const noexcept override OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  virtual void CovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                double const * restrict points_two, int num_points_two,
+                                double * restrict cov_matrix) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void SymmetricCovarianceMatrix(double const * restrict points, int num_points,
+                                         double * restrict cov_matrix) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void GradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                    double const * restrict points_two, int num_points_two,
+                                    double * restrict grad_cov) const noexcept override OL_NONNULL_POINTERS;
+
+  virtual void HyperparameterGradCovarianceMatrix(double const * restrict points_one, int num_points_one,
+                                                  double const * restrict points_two, int num_points_two,
+                                                  double * restrict grad_hyperparameter_cov) const noexcept override OL_NONNULL_POINTERS;
+
   virtual void SetHyperparameters(double const * restrict hyperparameters) noexcept override OL_NONNULL_POINTERS {
     alpha_ = hyperparameters[0];
 
@@ -502,6 +703,8 @@ class MaternNu2p5 final : public CovarianceInterface {
     for (int i = 0; i < dim_; ++i) {
       lengths_[i] = hyperparameters[i];
       lengths_sq_[i] = Square(hyperparameters[i]);
+      inverse_lengths_[i] = 1.0/hyperparameters[i];
+      inverse_lengths_sq_[i] = Square(inverse_lengths_[i]);
     }
   }
 
@@ -531,6 +734,10 @@ class MaternNu2p5 final : public CovarianceInterface {
   std::vector<double> lengths_;
   //! square of the length scales, one per dimension
   std::vector<double> lengths_sq_;
+  //! ``1/L_d``, one per dimension (for the batch functions)
+  std::vector<double> inverse_lengths_;
+  //! ``1/L_d^2``, one per dimension (for the batch functions)
+  std::vector<double> inverse_lengths_sq_;
 
   OL_DISALLOW_DEFAULT_AND_ASSIGN(MaternNu2p5);
 };
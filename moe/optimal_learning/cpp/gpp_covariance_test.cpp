@@ -689,6 +689,220 @@ OL_WARN_UNUSED_RESULT int RunCovarianceHyperparameterDerivativesTests() noexcept
   return total_errors;
 }
 
+/*!\rst
+  Checks that the batch covariance methods (CovarianceMatrix(), SymmetricCovarianceMatrix(), GradCovarianceMatrix(),
+  HyperparameterGradCovarianceMatrix()) of ``covariance`` agree with looping over the corresponding per-pair calls.
+
+  The point sets include a duplicated point so that the r = 0 case is covered.
+
+  \param
+    :covariance: covariance function to test
+    :class_name: name of the covariance class (for logging)
+  \return
+    number of entries where the batch and per-pair results disagree
+\endrst*/
+OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int CheckBatchCovarianceMatrices(const CovarianceInterface& covariance, char const * class_name) {
+  const double tolerance = 1.0e-13;
+  const double threshold = 1.0e-14;
+  const int dim = covariance.GetDimension();
+  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+  const int num_points_one = 11;
+  const int num_points_two = 7;
+  int total_errors = 0;
+
+  UniformRandomGenerator uniform_generator(8271);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  std::vector<double> points_one(dim*num_points_one);
+  std::vector<double> points_two(dim*num_points_two);
+  for (auto& entry : points_one) {
+    entry = uniform_double(uniform_generator.engine);
+  }
+  for (auto& entry : points_two) {
+    entry = uniform_double(uniform_generator.engine);
+  }
+  // duplicate a point so that r = 0 appears in both the cross and symmetric matrices
+  std::copy(points_one.begin() + 2*dim, points_one.begin() + 3*dim, points_two.begin() + 4*dim);
+  std::copy(points_one.begin() + 2*dim, points_one.begin() + 3*dim, points_one.begin() + 5*dim);
+
+  std::vector<double> cov_matrix(num_points_one*num_points_two);
+  covariance.CovarianceMatrix(points_one.data(), num_points_one, points_two.data(), num_points_two, cov_matrix.data());
+  for (int j = 0; j < num_points_two; ++j) {
+    for (int i = 0; i < num_points_one; ++i) {
+      double truth = covariance.Covariance(points_one.data() + i*dim, points_two.data() + j*dim);
+      if (!CheckDoubleWithinRelativeWithThreshold(cov_matrix[j*num_points_one + i], truth, tolerance, threshold)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  std::vector<double> symmetric_cov_matrix(num_points_one*num_points_one);
+  covariance.SymmetricCovarianceMatrix(points_one.data(), num_points_one, symmetric_cov_matrix.data());
+  for (int j = 0; j < num_points_one; ++j) {
+    for (int i = j; i < num_points_one; ++i) {
+      double truth = covariance.Covariance(points_one.data() + i*dim, points_one.data() + j*dim);
+      if (!CheckDoubleWithinRelativeWithThreshold(symmetric_cov_matrix[j*num_points_one + i], truth, tolerance, threshold)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  std::vector<double> grad_cov_matrix(dim*num_points_one*num_points_two);
+  std::vector<double> grad_cov(dim);
+  covariance.GradCovarianceMatrix(points_one.data(), num_points_one, points_two.data(), num_points_two, grad_cov_matrix.data());
+  for (int i = 0; i < num_points_one; ++i) {
+    for (int j = 0; j < num_points_two; ++j) {
+      covariance.GradCovariance(points_one.data() + i*dim, points_two.data() + j*dim, grad_cov.data());
+      for (int d = 0; d < dim; ++d) {
+        if (!CheckDoubleWithinRelativeWithThreshold(grad_cov_matrix[(i*num_points_two + j)*dim + d], grad_cov[d], tolerance, threshold)) {
+          ++total_errors;
+        }
+      }
+    }
+  }
+
+  std::vector<double> grad_hyperparameter_cov_matrix(num_hyperparameters*num_points_one*num_points_two);
+  std::vector<double> grad_hyperparameter_cov(num_hyperparameters);
+  covariance.HyperparameterGradCovarianceMatrix(points_one.data(), num_points_one, points_two.data(), num_points_two, grad_hyperparameter_cov_matrix.data());
+  for (int j = 0; j < num_points_two; ++j) {
+    for (int i = 0; i < num_points_one; ++i) {
+      covariance.HyperparameterGradCovariance(points_one.data() + i*dim, points_two.data() + j*dim, grad_hyperparameter_cov.data());
+      for (int h = 0; h < num_hyperparameters; ++h) {
+        if (!CheckDoubleWithinRelativeWithThreshold(grad_hyperparameter_cov_matrix[h*num_points_one*num_points_two + j*num_points_one + i], grad_hyperparameter_cov[h], tolerance, threshold)) {
+          ++total_errors;
+        }
+      }
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("%s batch covariance matrices failed with %d errors\n", class_name, total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("%s batch covariance matrices passed\n", class_name);
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that CovarianceWithDerivatives() of ``covariance`` agrees with Covariance(), HyperparameterGradCovariance(),
+  and HyperparameterHessianCovariance() for every combination of requested outputs.  Outputs that are not requested
+  are passed as ``nullptr``.
+
+  Pairs include identical points so that the r = 0 case is covered.
+
+  \param
+    :covariance: covariance function to test
+    :class_name: name of the covariance class (for logging)
+  \return
+    number of entries where the fused and individual results disagree
+\endrst*/
+OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int CheckCovarianceWithDerivatives(const CovarianceInterface& covariance, char const * class_name) {
+  const double tolerance = 1.0e-13;
+  // hessian diagonals are differences of two similar-sized terms; the fused and individual forms group them differently
+  const double tolerance_hessian = 1.0e-12;
+  const double threshold = 1.0e-14;
+  const int dim = covariance.GetDimension();
+  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+  const int num_pairs = 6;
+  int total_errors = 0;
+
+  UniformRandomGenerator uniform_generator(3141);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  std::vector<double> points_one(dim*num_pairs);
+  std::vector<double> points_two(dim*num_pairs);
+  for (auto& entry : points_one) {
+    entry = uniform_double(uniform_generator.engine);
+  }
+  for (auto& entry : points_two) {
+    entry = uniform_double(uniform_generator.engine);
+  }
+  std::copy(points_one.begin(), points_one.begin() + dim, points_two.begin());
+
+  std::vector<double> grad_truth(num_hyperparameters);
+  std::vector<double> hessian_truth(Square(num_hyperparameters));
+  std::vector<double> grad(num_hyperparameters);
+  std::vector<double> hessian(Square(num_hyperparameters));
+  const int all_outputs = CovarianceInterface::kCovarianceValue | CovarianceInterface::kHyperparameterGradient |
+      CovarianceInterface::kHyperparameterHessian;
+  for (int i = 0; i < num_pairs; ++i) {
+    double const * point_one = points_one.data() + i*dim;
+    double const * point_two = points_two.data() + i*dim;
+    const double cov_truth = covariance.Covariance(point_one, point_two);
+    covariance.HyperparameterGradCovariance(point_one, point_two, grad_truth.data());
+    covariance.HyperparameterHessianCovariance(point_one, point_two, hessian_truth.data());
+
+    for (int outputs = 1; outputs <= all_outputs; ++outputs) {
+      double cov;
+      const bool has_value = outputs & CovarianceInterface::kCovarianceValue;
+      const bool has_grad = outputs & CovarianceInterface::kHyperparameterGradient;
+      const bool has_hessian = outputs & CovarianceInterface::kHyperparameterHessian;
+      covariance.CovarianceWithDerivatives(point_one, point_two, outputs, has_value ? &cov : nullptr,
+                                           has_grad ? grad.data() : nullptr, has_hessian ? hessian.data() : nullptr);
+      if (has_value && !CheckDoubleWithinRelativeWithThreshold(cov, cov_truth, tolerance, threshold)) {
+        ++total_errors;
+      }
+      for (int k = 0; has_grad && k < num_hyperparameters; ++k) {
+        if (!CheckDoubleWithinRelativeWithThreshold(grad[k], grad_truth[k], tolerance, threshold)) {
+          ++total_errors;
+        }
+      }
+      for (int k = 0; has_hessian && k < Square(num_hyperparameters); ++k) {
+        if (!CheckDoubleWithinRelativeWithThreshold(hessian[k], hessian_truth[k], tolerance_hessian, threshold)) {
+          ++total_errors;
+        }
+      }
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("%s fused covariance derivatives failed with %d errors\n", class_name, total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("%s fused covariance derivatives passed\n", class_name);
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Test that the batch covariance matrix methods and CovarianceWithDerivatives() match the per-pair covariance calls
+  for every covariance function.
+
+  \return
+    Number of batch/fused vs per-pair mismatches over all covariance functions
+\endrst*/
+OL_WARN_UNUSED_RESULT int RunBatchCovarianceMatrixTests() {
+  const int dim = 4;
+  const double alpha = 1.7;
+  const std::vector<double> lengths = {0.6, 1.3, 0.9, 2.1};
+  int total_errors = 0;
+
+  total_errors += CheckBatchCovarianceMatrices(SquareExponential(dim, alpha, lengths), "Square Exponential");
+  total_errors += CheckBatchCovarianceMatrices(SquareExponentialSingleLength(dim, alpha, lengths[0]), "Square Exponential Single Length");
+  total_errors += CheckBatchCovarianceMatrices(MaternNu1p5(dim, alpha, lengths), "Matern nu=1.5");
+  total_errors += CheckBatchCovarianceMatrices(MaternNu2p5(dim, alpha, lengths), "Matern nu=2.5");
+
+  // the batch methods read inverse length scales cached by the covariance; check they follow SetHyperparameters()
+  {
+    const std::vector<double> hyperparameters = {0.8, 1.9, 0.5, 1.1, 0.7};
+    SquareExponential square_exponential(dim, alpha, lengths);
+    MaternNu1p5 matern_nu1p5(dim, alpha, lengths);
+    MaternNu2p5 matern_nu2p5(dim, alpha, lengths);
+    square_exponential.SetHyperparameters(hyperparameters.data());
+    matern_nu1p5.SetHyperparameters(hyperparameters.data());
+    matern_nu2p5.SetHyperparameters(hyperparameters.data());
+    total_errors += CheckBatchCovarianceMatrices(square_exponential, "Square Exponential (new hyperparameters)");
+    total_errors += CheckBatchCovarianceMatrices(matern_nu1p5, "Matern nu=1.5 (new hyperparameters)");
+    total_errors += CheckBatchCovarianceMatrices(matern_nu2p5, "Matern nu=2.5 (new hyperparameters)");
+  }
+
+  total_errors += CheckCovarianceWithDerivatives(SquareExponential(dim, alpha, lengths), "Square Exponential");
+  total_errors += CheckCovarianceWithDerivatives(SquareExponentialSingleLength(dim, alpha, lengths[0]), "Square Exponential Single Length");
+  total_errors += CheckCovarianceWithDerivatives(MaternNu1p5(dim, alpha, lengths), "Matern nu=1.5");
+  total_errors += CheckCovarianceWithDerivatives(MaternNu2p5(dim, alpha, lengths), "Matern nu=2.5");
+
+  return total_errors;
+}
+
 }  // end unnamed namespace
 
 int RunCovarianceTests() {
@@ -707,6 +921,12 @@ int RunCovarianceTests() {
   }
   total_errors += current_errors;
 
+  current_errors = RunBatchCovarianceMatrixTests();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("Batch and fused covariance evaluations failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
   return total_errors;
 }
 
@@ -104,6 +104,12 @@ void TensorProductDomain::LimitUpdate(double max_relative_change, double const *
   }
 }
 
+void TensorProductDomain::ProjectPointIntoDomain(double * restrict point) const noexcept {
+  for (int j = 0; j < dim_; ++j) {
+    point[j] = std::fmin(std::fmax(point[j], domain_[j].min), domain_[j].max);
+  }
+}
+
 SimplexIntersectTensorProductDomain::SimplexIntersectTensorProductDomain(ClosedInterval const * restrict domain,
                                                                          int dim_in)
     : dim_(dim_in), tensor_product_domain_(domain, dim_), simplex_plane_(dim_) {
@@ -191,6 +191,19 @@ class TensorProductDomain {
   void LimitUpdate(double max_relative_change, double const * restrict current_point,
                    double * restrict update_vector) const OL_NONNULL_POINTERS;
 
+  /*!\rst
+    Projects point onto the domain (in the 2-norm): each coordinate is clamped to its interval, so afterward
+    ``CheckPointInside(point)`` returns true.  Coordinates already inside the domain are UNMODIFIED.
+
+    Used by optimizers that handle box constraints by projection (e.g., LBFGSOptimization() in gpp_optimization.hpp).
+
+    \param
+      :point[dim]: point to project
+    \output
+      :point[dim]: closest point in the domain to the input
+  \endrst*/
+  void ProjectPointIntoDomain(double * restrict point) const noexcept OL_NONNULL_POINTERS;
+
  private:
   //! the number of spatial dimensions of this domain
   int dim_;
@@ -528,6 +541,22 @@ class RepeatedDomain {
     }
   }
 
+  /*!\rst
+    Projects each of the num_repeats points onto the repeated domain; see the repeated domain's
+    ProjectPointIntoDomain() for details.  Requires DomainType to provide ProjectPointIntoDomain()
+    (e.g., TensorProductDomain).
+
+    \param
+      :point[dim][num_repeats]: points to project
+    \output
+      :point[dim][num_repeats]: closest points in the domain to the inputs
+  \endrst*/
+  void ProjectPointIntoDomain(double * restrict point) const noexcept OL_NONNULL_POINTERS {
+    for (int i = 0; i < num_repeats_; ++i) {
+      domain_->ProjectPointIntoDomain(point + i*dim());
+    }
+  }
+
  private:
   //! number of times to repeat the input domain
   int num_repeats_;
@@ -86,11 +86,8 @@ int main() {
 
   // set up RNG containers
   int64_t pi_array[] = {314, 3141, 31415, 314159, 3141592, 31415926, 314159265, 3141592653, 31415926535, 314159265359};  // arbitrarily used digits of pi as seeds
-  std::vector<NormalRNG> normal_rng_vec(max_num_threads);
-  for (int i = 0; i < max_num_threads; ++i) {
-    normal_rng_vec[i].SetExplicitSeed(pi_array[i]);  // to get repeatable results
-    // call SetRandomizedSeed(base_seed, thread_id) to automatically choose 'random' seeds
-  }
+  // counter-based generators: every thread gets the same seed; each multistart draws from its own stream
+  std::vector<PhiloxNormalRNG> normal_rng_vec(max_num_threads, PhiloxNormalRNG(pi_array[1]));  // to get repeatable results
   UniformRandomGenerator uniform_generator(pi_array[0]);  // repeatable results
   // construct with (base_seed, thread_id) to generate a 'random' seed
 
@@ -231,7 +228,8 @@ int main() {
   ComputeOptimalPointsToSampleWithRandomStarts(gp, gd_params, domain, thread_schedule,
                                                points_being_sampled.data(), num_to_sample,
                                                num_being_sampled, best_so_far, max_int_steps,
-                                               &found_flag, &uniform_generator, normal_rng_vec.data(),
+                                               MonteCarloIntegrationTypes::kPseudoRandom,
+                                               ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag, &uniform_generator, normal_rng_vec.data(),
                                                next_point_winner.data());
   printf(OL_ANSI_COLOR_CYAN "EI OPTIMIZATION FINISHED. Success status: %s\n" OL_ANSI_COLOR_RESET, found_flag ? "True" : "False");
   printf("Next best sample point according to EI:\n");
@@ -264,7 +264,8 @@ void CudaEvaluateEIAtPointList(const GaussianProcess& gaussian_process, const Th
   if (num_to_sample == 1 && num_being_sampled == 0) {
     // special analytic case when we are not using (or not accounting for) multiple, simultaneous experiments
     EvaluateEIAtPointList(gaussian_process, thread_schedule, initial_guesses, points_being_sampled, num_multistarts,
-                          num_to_sample, num_being_sampled, best_so_far, max_int_steps, found_flag, nullptr, function_values, best_next_point);
+                          num_to_sample, num_being_sampled, best_so_far, max_int_steps,
+                          MonteCarloIntegrationTypes::kPseudoRandom, found_flag, nullptr, function_values, best_next_point);
   } else {
     CudaExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far, which_gpu);
 
@@ -483,7 +483,8 @@ OL_NONNULL_POINTERS void CudaComputeOptimalPointsToSampleViaMultistartGradientDe
     // special analytic case when we are not using (or not accounting for) multiple, simultaneous experiments
     ComputeOptimalPointsToSampleViaMultistartGradientDescent(gaussian_process, optimizer_parameters, domain, thread_schedule,
                                                              start_point_set, points_being_sampled, num_multistarts, num_to_sample,
-                                                             num_being_sampled, best_so_far, max_int_steps, nullptr, found_flag,
+                                                             num_being_sampled, best_so_far, max_int_steps,
+                                                             MonteCarloIntegrationTypes::kPseudoRandom, nullptr, found_flag,
                                                              best_next_point);
   } else {
     CudaExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far, which_gpu);
@@ -84,7 +84,7 @@ void ComputeHeuristicPointsToSample(const GaussianProcess& gaussian_process,
   const int num_being_sampled = 0;
   const int max_int_steps = 0;
   double * const points_being_sampled = nullptr;
-  NormalRNG * const normal_rng = nullptr;
+  PhiloxNormalRNG * const normal_rng = nullptr;
 
   // Cannot/Should not modify the input gaussian_process (the GP with the estimated objective values is of little use;
   // the caller at most wants to do other optimization tasks on the GP with only prior data), so Clone() it first and
@@ -98,8 +98,10 @@ void ComputeHeuristicPointsToSample(const GaussianProcess& gaussian_process,
       ComputeOptimalPointsToSampleWithRandomStarts(*gaussian_process_local, optimizer_parameters,
                                                    domain, thread_schedule, points_being_sampled,
                                                    num_to_sample_per_iteration, num_being_sampled,
-                                                   best_so_far, max_int_steps, &found_flag_local,
-                                                   uniform_generator, normal_rng, best_points_to_sample);
+                                                   best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                   ExpectedImprovementEvaluationTypes::kAnalytic,
+                                                   &found_flag_local, uniform_generator, normal_rng,
+                                                   best_points_to_sample);
     }
     // if gradient descent EI optimization failed OR we're only doing latin hypercube searches
     if (unlikely(found_flag_local == false || lhc_search_only == true)) {
@@ -117,7 +119,8 @@ void ComputeHeuristicPointsToSample(const GaussianProcess& gaussian_process,
                                                             points_being_sampled, num_lhc_samples,
                                                             num_to_sample_per_iteration,
                                                             num_being_sampled, best_so_far,
-                                                            max_int_steps,
+                                                            max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                            ExpectedImprovementEvaluationTypes::kAnalytic,
                                                             &found_flag_local, uniform_generator,
                                                             normal_rng, best_points_to_sample);
 
@@ -7,11 +7,18 @@
   Linear algebra functions currently do not call libraries like the BLAS/LAPACK because for [currently] small problem
   sizes, overhead kills their performance advantage.  Additionally, for the custom implementations on our specific use
   cases we also gain some performance through more restrictive assumptions on data ordering and no need (due to small
-  problem size) for advanced and complex optimizations like blocking.
+  problem size) for advanced and complex optimizations like blocking.  The exception is cholesky factorization of
+  ``num_sampled x num_sampled`` covariance matrices, which can outgrow cache; large factorizations are blocked
+  (see ComputeBlockedCholeskyFactorL()), and for very large matrices the tiles can be factored by several threads
+  (see ComputeTiledCholeskyFactorL()).
 
   However, if/when BLAS is needed, current linear algebra functions are designed to easily map into BLAS calls so they
   can serve as wrappers later.  This also makes it easy to handle BLAS from different vendors and on different computing
-  environments (e.g., GPUs, Xeon Phi).
+  environments (e.g., GPUs, Xeon Phi).  When built with ``OL_BLAS_ENABLED`` (cmake: ``MOE_USE_BLAS``),
+  GeneralMatrixMatrixMultiply(), TriangularMatrixMatrixSolve(), SymmetricMatrixVectorMultiply(),
+  ComputeCholeskyFactorL(), and ComputePLUFactorization() call CBLAS/LAPACK for problems of dimension
+  ``>= kLinearAlgebraLibraryMinimumSize``; the loops here remain the implementation for smaller problems (and for
+  builds without a library).
 
   See gpp_linear_algebra.hpp file docs and (primarily) gpp_common.hpp for a few important implementation notes
   (e.g., restrict, memory allocation, matrix storage style, etc).  Note the matrix looping idiom (gpp_common.hpp,
@@ -34,8 +41,23 @@
 #include <limits>
 #include <vector>
 
+#include <omp.h>  // NOLINT(build/include_order)
+
+#ifdef OL_BLAS_ENABLED
+#include <cblas.h>  // NOLINT(build/include_order)
+#endif
+
 #include "gpp_common.hpp"
 #include "gpp_logging.hpp"
+#include "gpp_thread_schedule.hpp"
+
+#ifdef OL_BLAS_ENABLED
+// LAPACK (Fortran interface); declared here so that we do not additionally depend on LAPACKE.
+extern "C" {
+void dpotrf_(const char * uplo, const int * n, double * a, const int * lda, int * info);
+void dgetrf_(const int * m, const int * n, double * a, const int * lda, int * ipiv, int * info);
+}
+#endif
 
 namespace optimal_learning {
 
@@ -89,6 +111,8 @@ void ZeroUpperTriangle(int size, double * restrict matrix) noexcept {
   }
 }
 
+namespace {
+
 /*!\rst
   Cholesky factorization, ``A = L * L^T`` (see Smith 1995 or Golub, Van Loan 1983, etc.)
   This implementation uses the outer-product formulation.  The outer-product version is
@@ -100,19 +124,26 @@ void ZeroUpperTriangle(int size, double * restrict matrix) noexcept {
 
   Instead, non-SPD matrices trigger an error printed to stdout.
 
-  Should be the same as BLAS call:
-  ``dpotrf('L', size_m, A, size_m, &info);``
-  Implementation is similar to ``dpotf2``, the unblocked version (same arg list as ``dpotrf``).
+  Should be the same as LAPACK call:
+  ``dpotf2('L', size_m, A, lda, &info);``
+  the unblocked version (same arg list as ``dpotrf``).
+
+  \param
+    :size_m: dimension of matrix
+    :lda: the first dimension of ``chol`` as declared by the caller; ``lda >= size_m``
+    :chol[size_m][lda]: SPD (square) matrix (``A``) (on entry)
+  \output
+    :chol[size_m][lda]: cholesky factor of ``A`` (``L``) in the lower triangle (on exit)
+  \return
+    0 if successful. Otherwise the 1-based index of the first leading minor that is not positive definite.
 \endrst*/
-// TODO(GH-172): change this to be gaxpy or (block) dot-prod style
-// to improve performance & numerical characteristics.
-int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept {
+OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int ComputeCholeskyFactorLUnblocked(int size_m, int lda, double * restrict chol) noexcept {
   double * restrict chol_temp = chol;
   // Apply outer-product-based Cholesky algorithm: 1/3*N^3 + O(N^2)
-  // Here, L_{ij} = chol[j*size_m + i] is the input matrix (on input) and the cholesky factor of that matrix (on exit).
+  // Here, L_{ij} = chol[j*lda + i] is the input matrix (on input) and the cholesky factor of that matrix (on exit).
   // Define a macro specifying the data layout assumption on L_{ij}. The macro simplifies complex indexing
   // so that OL_CHOL(i, j) reads just like L_{ij}.
-#define OL_CHOL(i, j) chol[((j)*size_m + (i))]
+#define OL_CHOL(i, j) chol[((j)*lda + (i))]
   double A_kk;
   for (int k = 0; k < size_m; ++k) {
     if (likely(chol_temp[k] > 1.0e-16)) {
@@ -133,7 +164,6 @@ int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept {
           OL_CHOL(i, j) = OL_CHOL(i, j) - OL_CHOL(i, k) * OL_CHOL(j, k);
         }
       }
-#undef OL_CHOL
     } else {
       // We fail if the matrix is singular. In the outer-product formulation here,
       // you can ignore the "0" diagonal entry and continue, which produces a
@@ -141,12 +171,283 @@ int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept {
       OL_ERROR_PRINTF("cholesky matrix singular %.18E ", chol_temp[k]);
       return k + 1;
     }
-    chol_temp += size_m;
+    chol_temp += lda;
+  }
+#undef OL_CHOL
+
+  return 0;
+}
+
+}  // end unnamed namespace
+
+int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept {
+#ifdef OL_BLAS_ENABLED
+  if (size_m >= kLinearAlgebraLibraryMinimumSize) {
+    const char uplo = 'L';
+    int info;
+    dpotrf_(&uplo, &size_m, chol, &size_m, &info);
+    // dpotrf only rejects pivots <= 0; also reject the tiny pivots ComputeCholeskyFactorLUnblocked() does
+    // so that (nearly) singular matrices fail the same way regardless of backend.
+    const int num_checked = info == 0 ? size_m : info - 1;
+    for (int k = 0; k < num_checked; ++k) {
+      if (unlikely(!(Square(chol[k*size_m + k]) > 1.0e-16))) {
+        info = k + 1;
+        break;
+      }
+    }
+    if (unlikely(info != 0)) {
+      OL_ERROR_PRINTF("cholesky matrix singular, leading minor %d ", info);
+    }
+    return info;
+  }
+#endif
+  if (size_m >= kCholeskyBlockedMinimumSize) {
+    return ComputeBlockedCholeskyFactorL(size_m, kCholeskyBlockSize, chol);
+  }
+  return ComputeCholeskyFactorLUnblocked(size_m, size_m, chol);
+}
+
+/*!\rst
+  Right-looking blocked cholesky factorization.  Partition ``A`` (after ``k`` columns have been factored) as::
+
+    [ A_11    *   ]   A_11 is block_size x block_size
+    [ A_21  A_22  ]
+
+  and for each block column:
+
+  1. ``L_11 = chol(A_11)`` (unblocked; ComputeCholeskyFactorLUnblocked)
+  2. ``L_21 = A_21 * L_11^-T``; i.e., ``L_11 * L_21^T = A_21^T`` (TriangularMatrixMatrixSolve)
+  3. ``A_22 = A_22 - L_21 * L_21^T`` (lower triangle only; GeneralMatrixMatrixMultiply over block columns of ``A_22``)
+
+  Steps 2 and 3 are ``O(n^3)`` in total and dominate the cost; they now stream through one cache-sized panel
+  (``block_size`` columns) at a time instead of sweeping the whole trailing matrix once per column.
+
+  ``L_21^T`` is packed into a contiguous ``block_size x (n - k - block_size)`` buffer: in that layout its columns
+  (rows of ``L_21``) are contiguous, so the solve in step 2 and the dot-product form of GeneralMatrixMatrixMultiply
+  (``transA = 'T'``) in step 3 both work on unit-stride data.  Each block column of ``A_22`` is also copied
+  into a contiguous buffer for step 3 since GeneralMatrixMatrixMultiply does not take a leading dimension.
+
+  Should be the same as LAPACK call:
+  ``dpotrf('L', size_m, A, size_m, &info);``
+\endrst*/
+int ComputeBlockedCholeskyFactorL(int size_m, int block_size, double * restrict chol) noexcept {
+  // packed L_21^T for the current panel
+  std::vector<double> panel_transpose(block_size*size_m);
+  // packed block column of A_22
+  std::vector<double> trailing_block(block_size*size_m);
+
+  for (int k = 0; k < size_m; k += block_size) {
+    const int size_diag = std::min(block_size, size_m - k);
+    const int size_trailing = size_m - k - size_diag;
+    double * restrict chol_diag = chol + k*size_m + k;
+
+    // 1. factor the diagonal block
+    int leading_minor_index = ComputeCholeskyFactorLUnblocked(size_diag, size_m, chol_diag);
+    if (unlikely(leading_minor_index != 0)) {
+      return k + leading_minor_index;
+    }
+    if (size_trailing == 0) {
+      break;
+    }
+
+    // 2. pack A_21^T, solve L_11 * X = A_21^T in place for X = L_21^T, then unpack L_21
+    double * restrict chol_panel = chol_diag + size_diag;
+    for (int j = 0; j < size_diag; ++j) {
+      for (int i = 0; i < size_trailing; ++i) {
+        panel_transpose[i*size_diag + j] = chol_panel[j*size_m + i];
+      }
+    }
+    TriangularMatrixMatrixSolve(chol_diag, 'N', size_diag, size_trailing, size_m, panel_transpose.data());
+    for (int j = 0; j < size_diag; ++j) {
+      for (int i = 0; i < size_trailing; ++i) {
+        chol_panel[j*size_m + i] = panel_transpose[i*size_diag + j];
+      }
+    }
+
+    // 3. A_22 -= L_21 * L_21^T, one block column at a time.  Each block column is a (lower) triangle on the
+    // diagonal of A_22, updated directly, and a rectangle below it, updated with one GEMM.
+    double * restrict chol_trailing = chol_diag + size_diag*size_m + size_diag;
+    for (int jj = 0; jj < size_trailing; jj += block_size) {
+      const int size_cols = std::min(block_size, size_trailing - jj);
+      const int size_rows = size_trailing - jj - size_cols;
+      double const * restrict panel_cols = panel_transpose.data() + jj*size_diag;
+      double * restrict chol_block = chol_trailing + jj*size_m + jj;
+
+      for (int j = 0; j < size_cols; ++j) {
+        for (int i = j; i < size_cols; ++i) {
+          chol_block[j*size_m + i] -= DotProduct(panel_cols + i*size_diag, panel_cols + j*size_diag, size_diag);
+        }
+      }
+
+      if (size_rows > 0) {
+        double * restrict chol_rectangle = chol_block + size_cols;
+        for (int j = 0; j < size_cols; ++j) {
+          std::copy(chol_rectangle + j*size_m, chol_rectangle + j*size_m + size_rows,
+                    trailing_block.data() + j*size_rows);
+        }
+        GeneralMatrixMatrixMultiply(panel_cols + size_cols*size_diag, 'T', panel_cols, -1.0, 1.0,
+                                    size_rows, size_diag, size_cols, trailing_block.data());
+        for (int j = 0; j < size_cols; ++j) {
+          std::copy(trailing_block.data() + j*size_rows, trailing_block.data() + (j+1)*size_rows,
+                    chol_rectangle + j*size_m);
+        }
+      }
+    }
   }
 
   return 0;
 }
 
+/*!\rst
+  Tile cholesky factorization; see e.g., Buttari, Langou, Kurzak, Dongarra 2009 (PLASMA).  With ``T`` tiles per
+  dimension and ``A_{ij}`` denoting tile ``(i, j)``, ``i >= j``, the algorithm is::
+
+    for k = 0..T-1:
+      A_kk = chol(A_kk)                          (POTRF)
+      for i = k+1..T-1:
+        A_ik = A_ik * A_kk^-T                    (TRSM)
+      for i = k+1..T-1:
+        A_ii = A_ii - A_ik * A_ik^T              (SYRK, lower triangle only)
+        for j = k+1..i-1:
+          A_ij = A_ij - A_ik * A_jk^T            (GEMM)
+
+  Each tile operation is an OpenMP task.  Dependencies are expressed through one token per tile in
+  ``tile_tokens``; a task lists the tokens of the tiles it reads (``in``) and writes (``inout``).  The tasks for
+  a given tile are created in the same order as the serial algorithm runs them, so the dependencies serialize
+  them in that order and each tile receives exactly the operations it would in ComputeBlockedCholeskyFactorL().
+
+  The tile kernels use the same packed (transposed) layouts as ComputeBlockedCholeskyFactorL(); each task packs
+  the tiles it needs into task-local buffers (``O(block_size^2)`` work for ``O(block_size^3)`` flops).
+
+  If a diagonal tile fails to factor, the failing index is recorded and all remaining tasks return immediately.
+  Every later task depends (transitively) on the failed factorization, so there is no race on the result.
+\endrst*/
+int ComputeTiledCholeskyFactorL(int size_m, int block_size, const ThreadSchedule& thread_schedule, double * restrict chol) noexcept {
+  const int num_tiles = (size_m + block_size - 1)/block_size;
+  std::vector<char> tile_tokens(num_tiles*num_tiles);
+  char * tokens = tile_tokens.data();
+  (void) tokens;  // quiet the compiler warning (only used in depend() clauses, which gcc does not count)
+  int leading_minor_index = 0;
+
+  // pointer to the upper-left corner of tile (i, j)
+  auto tile = [chol, size_m, block_size](int i, int j) {
+    return chol + j*block_size*size_m + i*block_size;
+  };
+  // number of rows (or columns) in the i-th tile row (column)
+  auto tile_size = [size_m, block_size](int i) {
+    return std::min(block_size, size_m - i*block_size);
+  };
+  auto failed = [&leading_minor_index]() {
+    int index;
+#pragma omp atomic read
+    index = leading_minor_index;
+    return index != 0;
+  };
+
+#pragma omp parallel num_threads(thread_schedule.max_num_threads)
+  {
+#pragma omp single
+    {
+      for (int k = 0; k < num_tiles; ++k) {
+        const int size_k = tile_size(k);
+
+#pragma omp task depend(inout: tokens[k*num_tiles + k])
+        {
+          if (!failed()) {
+            int tile_minor_index = ComputeCholeskyFactorLUnblocked(size_k, size_m, tile(k, k));
+            if (unlikely(tile_minor_index != 0)) {
+#pragma omp atomic write
+              leading_minor_index = k*block_size + tile_minor_index;
+            }
+          }
+        }
+
+        for (int i = k+1; i < num_tiles; ++i) {
+#pragma omp task depend(in: tokens[k*num_tiles + k]) depend(inout: tokens[k*num_tiles + i])
+          {
+            if (!failed()) {
+              // solve L_kk * X = A_ik^T for X = L_ik^T
+              const int size_i = tile_size(i);
+              double * restrict chol_ik = tile(i, k);
+              std::vector<double> tile_transpose(size_i*size_k);
+              for (int j = 0; j < size_k; ++j) {
+                for (int ii = 0; ii < size_i; ++ii) {
+                  tile_transpose[ii*size_k + j] = chol_ik[j*size_m + ii];
+                }
+              }
+              TriangularMatrixMatrixSolve(tile(k, k), 'N', size_k, size_i, size_m, tile_transpose.data());
+              for (int j = 0; j < size_k; ++j) {
+                for (int ii = 0; ii < size_i; ++ii) {
+                  chol_ik[j*size_m + ii] = tile_transpose[ii*size_k + j];
+                }
+              }
+            }
+          }
+        }
+
+        for (int i = k+1; i < num_tiles; ++i) {
+#pragma omp task depend(in: tokens[k*num_tiles + i]) depend(inout: tokens[i*num_tiles + i])
+          {
+            if (!failed()) {
+              // A_ii -= L_ik * L_ik^T, lower triangle only
+              const int size_i = tile_size(i);
+              double const * restrict chol_ik = tile(i, k);
+              double * restrict chol_ii = tile(i, i);
+              std::vector<double> tile_transpose(size_i*size_k);
+              for (int j = 0; j < size_k; ++j) {
+                for (int ii = 0; ii < size_i; ++ii) {
+                  tile_transpose[ii*size_k + j] = chol_ik[j*size_m + ii];
+                }
+              }
+              for (int j = 0; j < size_i; ++j) {
+                for (int ii = j; ii < size_i; ++ii) {
+                  chol_ii[j*size_m + ii] -= DotProduct(tile_transpose.data() + ii*size_k,
+                                                       tile_transpose.data() + j*size_k, size_k);
+                }
+              }
+            }
+          }
+
+          for (int j = k+1; j < i; ++j) {
+#pragma omp task depend(in: tokens[k*num_tiles + i], tokens[k*num_tiles + j]) depend(inout: tokens[j*num_tiles + i])
+            {
+              if (!failed()) {
+                // A_ij -= L_ik * L_jk^T
+                const int size_i = tile_size(i);
+                const int size_j = tile_size(j);
+                double const * restrict chol_ik = tile(i, k);
+                double const * restrict chol_jk = tile(j, k);
+                double * restrict chol_ij = tile(i, j);
+                std::vector<double> tile_i_transpose(size_i*size_k);
+                std::vector<double> tile_j_transpose(size_j*size_k);
+                std::vector<double> tile_ij(size_i*size_j);
+                for (int kk = 0; kk < size_k; ++kk) {
+                  for (int ii = 0; ii < size_i; ++ii) {
+                    tile_i_transpose[ii*size_k + kk] = chol_ik[kk*size_m + ii];
+                  }
+                  for (int jj = 0; jj < size_j; ++jj) {
+                    tile_j_transpose[jj*size_k + kk] = chol_jk[kk*size_m + jj];
+                  }
+                }
+                for (int jj = 0; jj < size_j; ++jj) {
+                  std::copy(chol_ij + jj*size_m, chol_ij + jj*size_m + size_i, tile_ij.data() + jj*size_i);
+                }
+                GeneralMatrixMatrixMultiply(tile_i_transpose.data(), 'T', tile_j_transpose.data(), -1.0, 1.0,
+                                            size_i, size_k, size_j, tile_ij.data());
+                for (int jj = 0; jj < size_j; ++jj) {
+                  std::copy(tile_ij.data() + jj*size_i, tile_ij.data() + (jj+1)*size_i, chol_ij + jj*size_m);
+                }
+              }
+            }
+          }
+        }
+      }
+    }  // end omp single; the implicit barrier waits for all tasks
+  }  // end omp parallel
+
+  return leading_minor_index;
+}
+
 /*!\rst
   Solve ``A*x = b`` or ``A^T*x = b`` when ``A`` is lower triangular IN-PLACE.
   Uses the standard "backsolve" technique, instead of forming ``A^-1`` which is
@@ -201,12 +502,27 @@ void TriangularMatrixVectorSolve(double const * restrict A, char trans, int size
   ``dtrsm('L', 'L', 'N', 'N', size_m, size_n, 1.0, A, lda, B, size_m);``
 \endrst*/
 void TriangularMatrixMatrixSolve(double const * restrict A, char trans, int size_m, int size_n, int lda, double * restrict X) noexcept {
+#ifdef OL_BLAS_ENABLED
+  if (size_m >= kLinearAlgebraLibraryMinimumSize) {
+    cblas_dtrsm(CblasColMajor, CblasLeft, CblasLower, trans == 'N' ? CblasNoTrans : CblasTrans, CblasNonUnit,
+                size_m, size_n, 1.0, A, lda, X, size_m);
+    return;
+  }
+#endif
   for (int k = 0; k < size_n; ++k) {
     TriangularMatrixVectorSolve(A, trans, size_m, lda, X);
     X += size_m;
   }
 }
 
+void ParallelTriangularMatrixMatrixSolve(double const * restrict A, char trans, int size_m, int size_n, int lda, const ThreadSchedule& thread_schedule, double * restrict X) noexcept {
+  omp_set_schedule(thread_schedule.schedule, thread_schedule.chunk_size);
+#pragma omp parallel for num_threads(thread_schedule.max_num_threads) schedule(runtime)
+  for (int k = 0; k < size_n; ++k) {
+    TriangularMatrixVectorSolve(A, trans, size_m, lda, X + k*size_m);
+  }
+}
+
 /*!\rst
   Computes ``A^-1``, the inverse of ``A`` when ``A`` has been previously cholesky-factored.
   Only the lower triangle of ``A`` is read.
@@ -297,6 +613,12 @@ void TriangularMatrixVectorMultiply(double const * restrict A, char trans, int s
   ``dsymv('L', size_m, 1.0, A, size_m, x, 1, 0.0, y, 1);``
 \endrst*/
 void SymmetricMatrixVectorMultiply(double const * restrict A, double const * restrict x, int size_m, double * restrict y) noexcept {
+#ifdef OL_BLAS_ENABLED
+  if (size_m >= kLinearAlgebraLibraryMinimumSize) {
+    cblas_dsymv(CblasColMajor, CblasLower, size_m, 1.0, A, size_m, x, 1, 0.0, y, 1);
+    return;
+  }
+#endif
   std::fill(y, y+size_m, 0.0);
   double temp1 = x[0], temp2 = 0.0;
 
@@ -382,6 +704,13 @@ void GeneralMatrixVectorMultiply(double const * restrict A, char trans, double c
   ``dgemm('N', 'N', size_m, size_n, size_k, alpha, A, size_m, B, size_k, beta, C, size_m);``
 \endrst*/
 void GeneralMatrixMatrixMultiply(double const * restrict Amat, char transA, double const * restrict Bmat, double alpha, double beta, int size_m, int size_k, int size_n, double * restrict Cmat) noexcept {
+#ifdef OL_BLAS_ENABLED
+  if (std::max({size_m, size_k, size_n}) >= kLinearAlgebraLibraryMinimumSize) {
+    cblas_dgemm(CblasColMajor, transA == 'N' ? CblasNoTrans : CblasTrans, CblasNoTrans, size_m, size_n, size_k,
+                alpha, Amat, transA == 'N' ? size_m : size_k, Bmat, size_k, beta, Cmat, size_m);
+    return;
+  }
+#endif
   if (transA == 'N') {
     for (int j = 0; j < size_n; ++j) {
       GeneralMatrixVectorMultiply(Amat, 'N', Bmat, alpha, beta, size_m, size_k, size_m, Cmat);
@@ -412,7 +741,20 @@ void SPDMatrixInverse(double const * restrict chol_matrix, int size_m, double *
 }
 
 int ComputePLUFactorization(int r, int * restrict pivot, double * restrict A) noexcept {
-  // TODO(GH-50): after linking to BLAS, this code should only run for r < 64 or so
+#ifdef OL_BLAS_ENABLED
+  if (r >= kLinearAlgebraLibraryMinimumSize) {
+    int info;
+    dgetrf_(&r, &r, A, &r, pivot, &info);
+    // dgetrf only rejects exactly 0 pivots; also reject subnormal pivots, matching the loops below
+    const int num_checked = info == 0 ? r : info - 1;
+    for (int k = 0; k < num_checked; ++k) {
+      if (unlikely(std::fabs(A[k*r + k]) < std::numeric_limits<double>::min())) {
+        return k + 1;
+      }
+    }
+    return info;
+  }
+#endif
   // Equivalent LAPACK call:
   // dgetrf_(&r, &r, A, &r, pivot, &info);
   if (unlikely(r == 1)) {
@@ -34,6 +34,8 @@
 
 namespace optimal_learning {
 
+struct ThreadSchedule;
+
 /*!\rst
   Computes ``\|x\|_2`` in a reasonably (see implementation notes) accurate and stable way.
 
@@ -131,6 +133,18 @@ inline OL_PURE_FUNCTION OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT double DotProd
   return sum;
 }
 
+//! Smallest problem dimension for which gemm, trsm, symv, potrf, and getrf call the system BLAS/LAPACK when
+//! built with ``OL_BLAS_ENABLED``.  Library call overhead dominates for smaller problems (e.g., the
+//! ``num_to_sample``-sized factorizations in the q,p-EI Monte-Carlo loop).
+static constexpr int kLinearAlgebraLibraryMinimumSize = 64;
+
+//! Panel width (columns) used by ComputeBlockedCholeskyFactorL() when called from ComputeCholeskyFactorL().
+//! A ``size_m x 64`` panel of doubles fits in L2 for ``size_m`` up to several thousand.
+static constexpr int kCholeskyBlockSize = 64;
+//! Smallest matrix dimension for which ComputeCholeskyFactorL() uses the blocked factorization.  Below this,
+//! the whole matrix fits in cache and packing overhead outweighs any benefit from blocking.
+static constexpr int kCholeskyBlockedMinimumSize = 256;
+
 /*!\rst
   Computes the cholesky factorization of a symmetric, positive-definite (SPD) matrix,
   ``A = L * L^T``; ``A`` is the input matrix, ``L`` is the (lower triangular) cholesky factor.
@@ -144,6 +158,10 @@ inline OL_PURE_FUNCTION OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT double DotProd
 
   The strict upper triangle of chol is NOT accessed.
 
+  For ``size_m >= kCholeskyBlockedMinimumSize``, this dispatches to ComputeBlockedCholeskyFactorL() with
+  ``block_size = kCholeskyBlockSize``; otherwise it uses an unblocked (``dpotf2``-like) algorithm.
+  With ``OL_BLAS_ENABLED``, LAPACK's ``dpotrf`` is used instead for ``size_m >= kLinearAlgebraLibraryMinimumSize``.
+
   \param
     :size_m: dimension of matrix
     :chol[size_m][size_m]: SPD (square) matrix (``A``) (on entry)
@@ -156,6 +174,57 @@ inline OL_PURE_FUNCTION OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT double DotProd
 \endrst*/
 int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
 
+/*!\rst
+  Computes the cholesky factorization of an SPD matrix, ``A = L * L^T``, using a blocked (right-looking) algorithm.
+  Same inputs, outputs, and requirements as ComputeCholeskyFactorL(); the result agrees with it up to rounding.
+
+  The matrix is processed in panels of ``block_size`` columns; the ``O(n^3)`` work is done by
+  TriangularMatrixMatrixSolve() and GeneralMatrixMatrixMultiply() on cache-sized blocks.
+  Uses ``O(block_size * size_m)`` extra space.
+
+  The strict upper triangle of chol is NOT accessed.
+
+  \param
+    :size_m: dimension of matrix
+    :block_size: number of columns per panel; ``block_size >= 1``
+    :chol[size_m][size_m]: SPD (square) matrix (``A``) (on entry)
+  \output
+    :chol[size_m][size_m]: cholesky factor of ``A`` (``L``) in the lower triangle (on exit)
+  \return
+    0 if successful. Otherwise the matrix is NOT positive definite and this returns ``i``, the
+    index of the ``i``-th leading minor that is not positive definite.
+\endrst*/
+int ComputeBlockedCholeskyFactorL(int size_m, int block_size, double * restrict chol) noexcept OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
+/*!\rst
+  Computes the cholesky factorization of an SPD matrix, ``A = L * L^T``, using a multithreaded tile algorithm.
+  Same inputs, outputs, and requirements as ComputeCholeskyFactorL().
+
+  The lower triangle is split into ``block_size x block_size`` tiles.  Each tile operation (factor a diagonal tile,
+  triangular solve of an off-diagonal tile, symmetric/general update of a trailing tile) is an OpenMP task; tasks
+  declare the tiles they read and write, and the OpenMP runtime runs them as soon as their inputs are ready.
+  Unlike a fork-join parallelization of ComputeBlockedCholeskyFactorL(), updates to the trailing matrix for panel
+  ``k`` overlap with factoring panel ``k+1``.
+
+  Every tile sees the same sequence of floating point operations as in ComputeBlockedCholeskyFactorL() (with the
+  same ``block_size``), so the result is identical to that function's and does not depend on the number of threads.
+  (With ``OL_BLAS_ENABLED``, the two call the library on different problem sizes and agree only up to rounding.)
+
+  The strict upper triangle of chol is NOT accessed.
+
+  \param
+    :size_m: dimension of matrix
+    :block_size: tile dimension; ``block_size >= 1``
+    :thread_schedule: number of threads to use (``schedule`` and ``chunk_size`` are ignored)
+    :chol[size_m][size_m]: SPD (square) matrix (``A``) (on entry)
+  \output
+    :chol[size_m][size_m]: cholesky factor of ``A`` (``L``) in the lower triangle (on exit)
+  \return
+    0 if successful. Otherwise the matrix is NOT positive definite and this returns ``i``, the
+    index of the ``i``-th leading minor that is not positive definite.
+\endrst*/
+int ComputeTiledCholeskyFactorL(int size_m, int block_size, const ThreadSchedule& thread_schedule, double * restrict chol) noexcept OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
 /*!\rst
   Solves the system ``A*x = b`` or ``A^T * x = b`` when ``A`` is lower triangular. ``A`` must be nonsingular.
   Before calling, ``x`` holds the RHS, ``b``.  After return, ``x`` will be OVERWRITTEN with
@@ -193,6 +262,24 @@ void TriangularMatrixVectorSolve(double const * restrict A, char trans, int size
 \endrst*/
 void TriangularMatrixMatrixSolve(double const * restrict A, char trans, int size_m, int size_n, int lda, double * restrict X) noexcept OL_NONNULL_POINTERS;
 
+/*!\rst
+  Multithreaded TriangularMatrixMatrixSolve(): the columns of ``X`` are independent, so they are distributed
+  across threads according to ``thread_schedule``.  Each column is solved with TriangularMatrixVectorSolve(), so
+  results are identical to TriangularMatrixMatrixSolve() without ``OL_BLAS_ENABLED``.
+
+  \param
+    :A[size_m][size_m]: input to be solved; must be lower triangular and non-singular
+    :trans: 'N' to solve ``A * X = B``, 'T' to solve ``A^T * X = B``
+    :size_m: dimension of ``A``
+    :size_n: number of columns of ``X``
+    :lda: the first dimension of ``A`` as declared by the caller; ``lda >= size_m``
+    :thread_schedule: number of threads and schedule to use when distributing columns of ``X``
+    :X[size_m][size_n]: the RHS matrix, ``B``
+  \output
+    :X[size_m][size_n]: the solution, ``A\B``.
+\endrst*/
+void ParallelTriangularMatrixMatrixSolve(double const * restrict A, char trans, int size_m, int size_n, int lda, const ThreadSchedule& thread_schedule, double * restrict X) noexcept OL_NONNULL_POINTERS;
+
 /*!\rst
   Solves ``A * x = b`` IN-PLACE, where ``A`` has been previously cholesky-factored (``A = L * L^T``) such that
   the lower triangle of ``A`` contains ``L``.
@@ -39,6 +39,7 @@
 #include "gpp_linear_algebra.hpp"
 #include "gpp_linear_algebra-inl.hpp"
 #include "gpp_logging.hpp"
+#include "gpp_optimization.hpp"
 #include "gpp_random.hpp"
 #include "gpp_test_utils.hpp"
 
@@ -335,6 +336,220 @@ OL_WARN_UNUSED_RESULT int TestCholesky() {
   return total_errors;
 }
 
+/*!\rst
+  Check blocked Cholesky factorization against the unblocked version.
+  Uses:
+
+  1. Random, well-conditioned SPD matrices factored with several block sizes, including block sizes that
+     do not divide the matrix size and the degenerate cases ``block_size = 1`` and ``block_size >= size``.
+     The blocked and unblocked factors must agree and ``L * L^T`` must reproduce ``A``.
+  2. The dispatch in ComputeCholeskyFactorL() at ``kCholeskyBlockedMinimumSize``.
+  3. Matrices that are not SPD; the blocked version must report the same failing leading minor.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int TestBlockedCholesky() {
+  int total_errors = 0;
+
+  UniformRandomGenerator uniform_generator(61203);
+  const std::vector<int> sizes = {7, 40, 97, kCholeskyBlockedMinimumSize + 3};
+  const std::vector<int> block_sizes = {1, 3, 16, 64, 200};
+  for (auto size : sizes) {
+    std::vector<double> spd_matrix(size*size);
+    std::vector<double> cholesky_unblocked(size*size);
+    std::vector<double> cholesky_blocked(size*size);
+    std::vector<double> cholesky_blocked_T(size*size);
+    std::vector<double> product_matrix(size*size);
+
+    BuildRandomSPDMatrix(size, &uniform_generator, spd_matrix.data());
+    ModifyMatrixDiagonal(size, static_cast<double>(size), spd_matrix.data());
+
+    std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_unblocked.begin());
+    // below the dispatch threshold, this is the unblocked algorithm; above it, compare vs block_size = 1
+    if (size < kCholeskyBlockedMinimumSize) {
+      if (ComputeCholeskyFactorL(size, cholesky_unblocked.data()) != 0) {
+        ++total_errors;
+      }
+    } else {
+      if (ComputeBlockedCholeskyFactorL(size, 1, cholesky_unblocked.data()) != 0) {
+        ++total_errors;
+      }
+    }
+    ZeroUpperTriangle(size, cholesky_unblocked.data());
+
+    const double tolerance = 10 * size * std::numeric_limits<double>::epsilon();
+    const double norm_spd = VectorNorm(spd_matrix.data(), size*size);
+    const double norm_cholesky = VectorNorm(cholesky_unblocked.data(), size*size);
+    for (auto block_size : block_sizes) {
+      std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_blocked.begin());
+      if (ComputeBlockedCholeskyFactorL(size, block_size, cholesky_blocked.data()) != 0) {
+        ++total_errors;
+      }
+      // the strict upper triangle must not be touched
+      for (int j = 0; j < size; ++j) {
+        for (int i = 0; i < j; ++i) {
+          if (!CheckDoubleWithinRelative(cholesky_blocked[j*size + i], spd_matrix[j*size + i], 0.0)) {
+            ++total_errors;
+          }
+        }
+      }
+      ZeroUpperTriangle(size, cholesky_blocked.data());
+
+      if (!CheckMatrixNormWithin(cholesky_blocked.data(), cholesky_unblocked.data(), size, size,
+                                 tolerance*norm_cholesky)) {
+        ++total_errors;
+      }
+
+      // backward stability: L * L^T = A + \delta A, with ||\delta A||/||A|| = O(\epsilon_{machine})
+      MatrixTranspose(cholesky_blocked.data(), size, size, cholesky_blocked_T.data());
+      GeneralMatrixMatrixMultiply(cholesky_blocked.data(), 'N', cholesky_blocked_T.data(), 1.0, 0.0, size, size, size,
+                                  product_matrix.data());
+      if (!CheckMatrixNormWithin(product_matrix.data(), spd_matrix.data(), size, size, tolerance*norm_spd)) {
+        ++total_errors;
+      }
+    }
+
+    // ComputeCholeskyFactorL must dispatch to the blocked version (with kCholeskyBlockSize) above the threshold.
+    // With OL_BLAS_ENABLED, it calls dpotrf instead, which need only agree up to rounding.
+#ifdef OL_BLAS_ENABLED
+    const double dispatch_tolerance = tolerance*norm_cholesky;
+#else
+    const double dispatch_tolerance = 0.0;
+#endif
+    if (size >= kCholeskyBlockedMinimumSize) {
+      std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_unblocked.begin());
+      std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_blocked.begin());
+      if (ComputeCholeskyFactorL(size, cholesky_unblocked.data()) != 0) {
+        ++total_errors;
+      }
+      if (ComputeBlockedCholeskyFactorL(size, kCholeskyBlockSize, cholesky_blocked.data()) != 0) {
+        ++total_errors;
+      }
+      if (!CheckMatrixNormWithin(cholesky_unblocked.data(), cholesky_blocked.data(), size, size,
+                                 dispatch_tolerance)) {
+        ++total_errors;
+      }
+    }
+
+    // make the matrix indefinite: a negative diagonal entry in a trailing block makes that leading minor fail
+    const int bad_index = (2 * size) / 3;
+    spd_matrix[bad_index*size + bad_index] = -1.0;
+    std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_unblocked.begin());
+    std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_blocked.begin());
+    int leading_minor_unblocked = ComputeBlockedCholeskyFactorL(size, 1, cholesky_unblocked.data());
+    int leading_minor_blocked = ComputeBlockedCholeskyFactorL(size, 16, cholesky_blocked.data());
+    if (!CheckIntEquals(leading_minor_unblocked, bad_index + 1)) {
+      ++total_errors;
+    }
+    if (!CheckIntEquals(leading_minor_blocked, bad_index + 1)) {
+      ++total_errors;
+    }
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Check that the multithreaded ComputeTiledCholeskyFactorL() and ParallelTriangularMatrixMatrixSolve() produce
+  exactly the same results as their serial counterparts, ComputeBlockedCholeskyFactorL() (same block size;
+  up to rounding with ``OL_BLAS_ENABLED``) and column-by-column TriangularMatrixVectorSolve(), for several
+  thread counts.  Also check that the tiled factorization does not
+  touch the strict upper triangle and reports the same failing leading minor as the serial code.
+
+  \return
+    number of entries (or return codes) that differ from the serial results
+\endrst*/
+OL_WARN_UNUSED_RESULT int TestParallelCholeskyAndSolve() {
+  int total_errors = 0;
+
+  UniformRandomGenerator uniform_generator(31415);
+  const std::vector<int> sizes = {1, 23, 130, kCholeskyBlockedMinimumSize + 5};
+  const std::vector<int> block_sizes = {1, 7, 32, kCholeskyBlockSize};
+  const std::vector<int> thread_counts = {1, 2, 4};
+  const int num_rhs = 19;
+  for (auto size : sizes) {
+    std::vector<double> spd_matrix(size*size);
+    std::vector<double> cholesky_serial(size*size);
+    std::vector<double> cholesky_tiled(size*size);
+    std::vector<double> rhs(size*num_rhs);
+    std::vector<double> solution_serial(size*num_rhs);
+    std::vector<double> solution_parallel(size*num_rhs);
+
+    BuildRandomSPDMatrix(size, &uniform_generator, spd_matrix.data());
+    ModifyMatrixDiagonal(size, static_cast<double>(size), spd_matrix.data());
+    BuildRandomVector(size*num_rhs, -1.0, 1.0, &uniform_generator, rhs.data());
+
+    // With OL_BLAS_ENABLED, the large trsm/gemm calls in the blocked factorization go to the library while the
+    // tiled version calls it on tile-sized (often smaller) problems, so they need only agree up to rounding.
+#ifdef OL_BLAS_ENABLED
+    const double tiled_tolerance = 10 * size * std::numeric_limits<double>::epsilon() *
+        VectorNorm(spd_matrix.data(), size*size);
+#else
+    const double tiled_tolerance = 0.0;
+#endif
+
+    for (auto block_size : block_sizes) {
+      std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_serial.begin());
+      if (ComputeBlockedCholeskyFactorL(size, block_size, cholesky_serial.data()) != 0) {
+        ++total_errors;
+      }
+
+      for (auto num_threads : thread_counts) {
+        ThreadSchedule thread_schedule(num_threads, omp_sched_dynamic);
+        std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_tiled.begin());
+        if (ComputeTiledCholeskyFactorL(size, block_size, thread_schedule, cholesky_tiled.data()) != 0) {
+          ++total_errors;
+        }
+        // the strict upper triangle must not be touched
+        for (int j = 0; j < size; ++j) {
+          for (int i = 0; i < j; ++i) {
+            if (!CheckDoubleWithinRelative(cholesky_tiled[j*size + i], spd_matrix[j*size + i], 0.0)) {
+              ++total_errors;
+            }
+          }
+        }
+        if (!CheckMatrixNormWithin(cholesky_tiled.data(), cholesky_serial.data(), size, size, tiled_tolerance)) {
+          ++total_errors;
+        }
+      }
+    }
+
+    // cholesky_serial holds L with the upper triangle of A; solves only read the lower triangle
+    for (auto trans : {'N', 'T'}) {
+      std::copy(rhs.begin(), rhs.end(), solution_serial.begin());
+      for (int k = 0; k < num_rhs; ++k) {
+        TriangularMatrixVectorSolve(cholesky_serial.data(), trans, size, size, solution_serial.data() + k*size);
+      }
+      for (auto num_threads : thread_counts) {
+        ThreadSchedule thread_schedule(num_threads, omp_sched_static);
+        std::copy(rhs.begin(), rhs.end(), solution_parallel.begin());
+        ParallelTriangularMatrixMatrixSolve(cholesky_serial.data(), trans, size, num_rhs, size, thread_schedule,
+                                            solution_parallel.data());
+        for (int i = 0; i < size*num_rhs; ++i) {
+          if (!CheckDoubleWithinRelative(solution_parallel[i], solution_serial[i], 0.0)) {
+            ++total_errors;
+          }
+        }
+      }
+    }
+
+    // make the matrix indefinite; the tiled version must report the same leading minor
+    const int bad_index = (2 * size) / 3;
+    spd_matrix[bad_index*size + bad_index] = -1.0;
+    for (auto num_threads : thread_counts) {
+      ThreadSchedule thread_schedule(num_threads);
+      std::copy(spd_matrix.begin(), spd_matrix.end(), cholesky_tiled.begin());
+      int leading_minor_index = ComputeTiledCholeskyFactorL(size, 7, thread_schedule, cholesky_tiled.data());
+      if (!CheckIntEquals(leading_minor_index, bad_index + 1)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  return total_errors;
+}
+
 /*!\rst
   Test that SPDMatrixInverse and CholeskyFactorLMatrixVectorSolve are  working correctly
   against some especially bad named matrices and some random inputs.
@@ -1279,6 +1494,18 @@ int RunLinearAlgebraTests() {
     OL_PARTIAL_FAILURE_PRINTF("cholesky errors = %d\n", current_errors);
   }
 
+  current_errors = TestBlockedCholesky();
+  total_errors += current_errors;
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("blocked cholesky errors = %d\n", current_errors);
+  }
+
+  current_errors = TestParallelCholeskyAndSolve();
+  total_errors += current_errors;
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("tiled cholesky, parallel triangular solve errors = %d\n", current_errors);
+  }
+
   current_errors = TestSPDLinearSolvers();
   total_errors += current_errors;
   if (current_errors != 0) {
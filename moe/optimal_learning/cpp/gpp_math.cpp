@@ -261,9 +261,14 @@
 #include <cmath>
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include <omp.h>  // NOLINT(build/include_order)
+
 #include <boost/math/distributions/normal.hpp>  // NOLINT(build/include_order)
 
 #include "gpp_common.hpp"
@@ -274,13 +279,14 @@
 #include "gpp_linear_algebra.hpp"
 #include "gpp_linear_algebra-inl.hpp"
 #include "gpp_logging.hpp"
+#include "gpp_memory_pool.hpp"
 #include "gpp_optimization.hpp"
 #include "gpp_optimizer_parameters.hpp"
 #include "gpp_random.hpp"
 
 namespace optimal_learning {
 
-namespace {  // utilities for A_{k,j,i}*x_j and building covariance matrices
+namespace {  // utilities for A_{k,j,i}*x_j, building covariance matrices, and batched monte-carlo draws
 
 /*!\rst
   Helper function to perform the following math (in index notation)::
@@ -326,24 +332,20 @@ OL_NONNULL_POINTERS void SpecialTensorVectorMultiply(double const * restrict ten
   Point list cannot contain duplicates.  Doing so (or providing nearly duplicate points) can lead to
   semi-definite matrices or very poor numerical conditioning.
 
+  The matrix is filled by CovarianceInterface::SymmetricCovarianceMatrix() (one virtual call).
+
   \param
     :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
     :points_sampled[dim][num_sampled]: list of points
-    :dim: spatial dimension of a point
     :num_sampled: number of points
   \output
     :cov_matrix[num_sampled][num_sampled]: computed covariance matrix
 \endrst*/
 OL_NONNULL_POINTERS void BuildCovarianceMatrix(const CovarianceInterface& covariance,
                                                double const * restrict points_sampled,
-                                               int dim, int num_sampled, double * restrict cov_matrix) noexcept {
+                                               int num_sampled, double * restrict cov_matrix) noexcept {
   // we only work with lower triangular parts of symmetric matrices, so only fill half of it
-  for (int i = 0; i < num_sampled; ++i) {
-    for (int j = i; j < num_sampled; ++j) {
-      cov_matrix[j] = covariance.Covariance(points_sampled + i*dim, points_sampled+j*dim);
-    }
-    cov_matrix += num_sampled;
-  }
+  covariance.SymmetricCovarianceMatrix(points_sampled, num_sampled, cov_matrix);
 }
 
 /*!\rst
@@ -357,15 +359,11 @@ OL_NONNULL_POINTERS void BuildCovarianceMatrix(const CovarianceInterface& covari
 OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const CovarianceInterface& covariance,
                                                                 double const * restrict noise_variance,
                                                                 double const * restrict points_sampled,
-                                                                int dim, int num_sampled,
+                                                                int num_sampled,
                                                                 double * restrict cov_matrix) noexcept {
-  // we only work with lower triangular parts of symmetric matrices, so only fill half of it
+  BuildCovarianceMatrix(covariance, points_sampled, num_sampled, cov_matrix);
   for (int i = 0; i < num_sampled; ++i) {
-    for (int j = i; j < num_sampled; ++j) {
-      cov_matrix[j] = covariance.Covariance(points_sampled + i*dim, points_sampled+j*dim);
-    }
-    cov_matrix[i] += noise_variance[i];
-    cov_matrix += num_sampled;
+    cov_matrix[i*num_sampled + i] += noise_variance[i];
   }
 }
 
@@ -385,11 +383,12 @@ OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const Covariance
 
   Point lists cannot contain duplicates with each other or within themselves.
 
+  The matrix is filled by CovarianceInterface::CovarianceMatrix() (one virtual call).
+
   \param
     :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
     :points_sampled[dim][num_sampled]: list of points, ``X``
     :points_to_sample[dim][num_to_sample]: list of points, ``Xs``
-    :dim: spatial dimension of a point
     :num_sampled: number of points in points_sampled
     :num_to_sample: number of points in points_to_sample
   \output
@@ -398,52 +397,219 @@ OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const Covariance
 OL_NONNULL_POINTERS void BuildMixCovarianceMatrix(const CovarianceInterface& covariance,
                                                   double const * restrict points_sampled,
                                                   double const * restrict points_to_sample,
-                                                  int dim, int num_sampled, int num_to_sample,
+                                                  int num_sampled, int num_to_sample,
                                                   double * restrict cov_matrix) noexcept {
   // calculate the covariance matrix defined in gpp_covariance.hpp
-  for (int j = 0; j < num_to_sample; ++j) {
-    for (int i = 0; i < num_sampled; ++i) {
-      cov_matrix[i] = covariance.Covariance(points_sampled + i*dim, points_to_sample + j*dim);
+  covariance.CovarianceMatrix(points_sampled, num_sampled, points_to_sample, num_to_sample, cov_matrix);
+}
+
+/*!\rst
+  Draws ``num_draws`` vectors of ``size`` IID normal(0, 1) random numbers.  The draws are taken from ``normal_rng``
+  one vector at a time (i.e., in the same order as ``num_draws`` separate loops over ``size``), but the ``b``-th vector
+  is stored in the ``b``-th column of the (row-major) output so that later loops over draws are unit-stride.
+
+  \param
+    :size: number of components in each vector
+    :num_draws: number of vectors to draw
+    :ld_draws: leading dimension of ``normals``; ``ld_draws >= num_draws``
+    :normal_rng[1]: a properly seeded NormalRNGInterface
+  \output
+    :normal_rng[1]: rng advanced by ``size * num_draws`` draws
+    :normals[size][ld_draws]: ``normals[j*ld_draws + b]`` is the ``j``-th component of the ``b``-th vector
+\endrst*/
+OL_NONNULL_POINTERS void DrawNormalVectors(int size, int num_draws, int ld_draws, NormalRNGInterface * normal_rng,
+                                           double * restrict normals) {
+  for (int b = 0; b < num_draws; ++b) {
+    for (int j = 0; j < size; ++j) {
+      normals[j*ld_draws + b] = (*normal_rng)();
+    }
+  }
+}
+
+/*!\rst
+  Computes ``y_b = L * w_b`` for a batch of vectors ``w_b``, where ``L`` is lower triangular.  This is
+  TriangularMatrixVectorMultiply(L, 'N', ...) applied to each ``w_b`` (with the same operation order, so the results
+  are identical), but the innermost loop runs over the batch.
+
+  \param
+    :chol[size][size]: lower triangular matrix ``L``; the strict upper triangle is not accessed
+    :normals[size][ld_draws]: vectors ``w_b``, stored as columns (see DrawNormalVectors())
+    :size: dimension of ``L``
+    :num_draws: number of vectors ``w_b``
+    :ld_draws: leading dimension of ``normals`` and ``samples``; ``ld_draws >= num_draws``
+  \output
+    :samples[size][ld_draws]: vectors ``y_b``, stored as columns
+\endrst*/
+OL_NONNULL_POINTERS void TriangularMatrixMultiplyVectors(double const * restrict chol,
+                                                         double const * restrict normals,
+                                                         int size, int num_draws, int ld_draws,
+                                                         double * restrict samples) noexcept {
+  for (int i = 0; i < size; ++i) {
+    double * restrict samples_row = samples + i*ld_draws;
+    const double chol_diagonal = chol[i*size + i];
+    double const * restrict normals_row = normals + i*ld_draws;
+    for (int b = 0; b < num_draws; ++b) {
+      samples_row[b] = normals_row[b]*chol_diagonal;
+    }
+    // sub-diagonal contributions, in the order TriangularMatrixVectorMultiply() adds them
+    for (int j = i - 1; j >= 0; --j) {
+      const double chol_ij = chol[j*size + i];
+      normals_row = normals + j*ld_draws;
+      for (int b = 0; b < num_draws; ++b) {
+        samples_row[b] += normals_row[b]*chol_ij;
+      }
+    }
+  }
+}
+
+/*!\rst
+  Copy-on-write for cholesky factors shared among clones of a GP: if ``factor`` is shared (or null), replaces it with a
+  new factor, owned by the caller alone, that holds the first ``num_entries`` entries of the old one.
+
+  \param
+    :num_entries: number of entries to keep if ``factor`` is replaced (0 if it will be overwritten anyway)
+    :factor[1]: shared cholesky factor
+  \output
+    :factor[1]: unshared cholesky factor
+  \return
+    ``**factor``, which may now be modified
+\endrst*/
+std::vector<double>& UnshareCholeskyFactor(int num_entries, std::shared_ptr<std::vector<double> > * factor) {
+  if (factor->use_count() != 1) {
+    if (*factor) {
+      *factor = std::make_shared<std::vector<double> >((*factor)->begin(), (*factor)->begin() + num_entries);
+    } else {
+      *factor = std::make_shared<std::vector<double> >();
     }
-    cov_matrix += num_sampled;
   }
+  return **factor;
 }
 
 }  // end unnamed namespace
 
+std::uint64_t NewGaussianProcessGeneration() noexcept {
+  static std::atomic<std::uint64_t> last_generation(0);
+  return ++last_generation;
+}
+
 void GaussianProcess::BuildCovarianceMatrixWithNoiseVariance() noexcept {
   optimal_learning::BuildCovarianceMatrixWithNoiseVariance(*covariance_ptr_, noise_variance_.data(),
-                                                           points_sampled_.data(), dim_, num_sampled_,
-                                                           K_chol_.data());
+                                                           points_sampled_.data(), num_sampled_, K_chol_->data());
 }
 
 void GaussianProcess::BuildMixCovarianceMatrix(double const * restrict points_to_sample,
                                                int num_to_sample,
                                                double * restrict covariance_matrix) const noexcept {
   optimal_learning::BuildMixCovarianceMatrix(*covariance_ptr_, points_sampled_.data(),
-                                             points_to_sample, dim_, num_sampled_,
+                                             points_to_sample, num_sampled_,
                                              num_to_sample, covariance_matrix);
 }
 
 void GaussianProcess::RecomputeDerivedVariables() {
+  DetachCholeskyFactor(0);
+  std::vector<double>& K_chol = *K_chol_;
   // resize if needed
-  if (unlikely(static_cast<int>(K_inv_y_.size()) != num_sampled_)) {
-    K_chol_.resize(num_sampled_*num_sampled_);
+  if (unlikely(static_cast<int>(K_inv_y_.size()) != num_sampled_ ||
+               static_cast<int>(K_chol.size()) != num_sampled_*num_sampled_)) {
+    K_chol.resize(num_sampled_*num_sampled_);
     K_inv_y_.resize(num_sampled_);
   }
 
   // recompute derived quantities
   BuildCovarianceMatrixWithNoiseVariance();
-  int leading_minor_index = ComputeCholeskyFactorL(num_sampled_, K_chol_.data());
+  int leading_minor_index;
+#ifdef OL_BLAS_ENABLED
+  // LAPACK's (vendor-)threaded dpotrf takes over large factorizations
+  leading_minor_index = ComputeCholeskyFactorL(num_sampled_, K_chol.data());
+#else
+  if (num_sampled_ >= kCholeskyBlockedMinimumSize) {
+    leading_minor_index = ComputeTiledCholeskyFactorL(num_sampled_, kCholeskyBlockSize, thread_schedule_,
+                                                      K_chol.data());
+  } else {
+    leading_minor_index = ComputeCholeskyFactorL(num_sampled_, K_chol.data());
+  }
+#endif
   if (unlikely(leading_minor_index != 0)) {
     OL_THROW_EXCEPTION(SingularMatrixException,
                        "Covariance matrix (K) singular. Check for duplicate points_sampled "
                        "(with 0 noise) and/or extreme hyperparameter values.",
-                       K_chol_.data(), num_sampled_, leading_minor_index);
+                       K_chol.data(), num_sampled_, leading_minor_index);
+  }
+
+  std::copy(points_sampled_value_.begin(), points_sampled_value_.end(), K_inv_y_.begin());
+  CholeskyFactorLMatrixVectorSolve(K_chol.data(), num_sampled_, K_inv_y_.data());
+}
+
+/*!\rst
+  Let ``K`` (``N x N``) be the current covariance matrix (with noise) and ``L * L^T = K`` its cholesky factorization.
+  Appending ``k`` new points produces::
+
+    K_new = [ K    B ]    L_new = [ L    0   ]
+            [ B^T  C ]            [ S  L_22  ]
+
+  where ``B = K(X, X_new)`` is ``N x k`` and ``C = K(X_new, X_new) + \sigma_n^2 I`` is ``k x k``.  Matching blocks of
+  ``L_new * L_new^T = K_new`` gives:
+
+  | ``L * S^T = B``                          (triangular solve, ``O(N^2 * k)``; columns split across threads)
+  | ``L_22 * L_22^T = C - S * S^T``          (cholesky of the Schur complement, ``O(N * k^2 + k^3)``)
+
+  So only ``B`` and ``C`` are built; ``L`` is reused.  ``L_22`` is the trailing block of what a from-scratch
+  factorization would produce (up to rounding), so its pivots fail under the same conditions as ComputeCholeskyFactorL
+  would on ``K_new``.  Finally ``K_new^-1 * y`` is recomputed via two ``O((N+k)^2)`` triangular solves.
+\endrst*/
+bool GaussianProcess::ExtendDerivedVariables(int num_sampled_old) {
+  DetachCholeskyFactor(num_sampled_old*num_sampled_old);
+  std::vector<double>& K_chol = *K_chol_;
+  const int num_new_points = num_sampled_ - num_sampled_old;
+  double const * restrict new_points = points_sampled_.data() + num_sampled_old*dim_;
+
+  // cross_covariance holds B on input to the solve and S^T on output
+  std::vector<double> cross_covariance(num_sampled_old*num_new_points);
+  optimal_learning::BuildMixCovarianceMatrix(*covariance_ptr_, points_sampled_.data(), new_points,
+                                             num_sampled_old, num_new_points, cross_covariance.data());
+  // K_chol still has leading dimension num_sampled_old here
+#ifdef OL_BLAS_ENABLED
+  TriangularMatrixMatrixSolve(K_chol.data(), 'N', num_sampled_old, num_new_points, num_sampled_old,
+                              cross_covariance.data());
+#else
+  ParallelTriangularMatrixMatrixSolve(K_chol.data(), 'N', num_sampled_old, num_new_points, num_sampled_old,
+                                      thread_schedule_, cross_covariance.data());
+#endif
+
+  // schur_complement = C - S * S^T, then factor it in place to get L_22
+  std::vector<double> schur_complement(num_new_points*num_new_points);
+  optimal_learning::BuildCovarianceMatrixWithNoiseVariance(*covariance_ptr_, noise_variance_.data() + num_sampled_old,
+                                                           new_points, num_new_points, schur_complement.data());
+  GeneralMatrixMatrixMultiply(cross_covariance.data(), 'T', cross_covariance.data(), -1.0, 1.0,
+                              num_new_points, num_sampled_old, num_new_points, schur_complement.data());
+  if (unlikely(ComputeCholeskyFactorL(num_new_points, schur_complement.data()) != 0)) {
+    return false;
+  }
+
+  // re-stride the existing factor to the new leading dimension; columns only move toward the end
+  // of the array, so copying backward (last column first) never overwrites unread data
+  K_chol.resize(num_sampled_*num_sampled_);
+  for (int j = num_sampled_old - 1; j > 0; --j) {
+    std::copy_backward(K_chol.begin() + j*num_sampled_old, K_chol.begin() + (j+1)*num_sampled_old,
+                       K_chol.begin() + j*num_sampled_ + num_sampled_old);
+  }
+
+  // fill in S (transposed out of cross_covariance) and L_22
+  for (int j = 0; j < num_sampled_old; ++j) {
+    for (int i = 0; i < num_new_points; ++i) {
+      K_chol[j*num_sampled_ + num_sampled_old + i] = cross_covariance[i*num_sampled_old + j];
+    }
+  }
+  for (int j = 0; j < num_new_points; ++j) {
+    for (int i = j; i < num_new_points; ++i) {
+      K_chol[(num_sampled_old + j)*num_sampled_ + num_sampled_old + i] = schur_complement[j*num_new_points + i];
+    }
   }
 
+  K_inv_y_.resize(num_sampled_);
   std::copy(points_sampled_value_.begin(), points_sampled_value_.end(), K_inv_y_.begin());
-  CholeskyFactorLMatrixVectorSolve(K_chol_.data(), num_sampled_, K_inv_y_.data());
+  CholeskyFactorLMatrixVectorSolve(K_chol.data(), num_sampled_, K_inv_y_.data());
+  return true;
 }
 
 GaussianProcess::GaussianProcess(const CovarianceInterface& covariance_in,
@@ -451,18 +617,55 @@ GaussianProcess::GaussianProcess(const CovarianceInterface& covariance_in,
                                  double const * restrict points_sampled_value_in,
                                  double const * restrict noise_variance_in,
                                  int dim_in, int num_sampled_in)
+    : GaussianProcess(covariance_in, points_sampled_in, points_sampled_value_in, noise_variance_in, dim_in,
+                      num_sampled_in, ThreadSchedule(1)) {
+}
+
+GaussianProcess::GaussianProcess(const CovarianceInterface& covariance_in,
+                                 double const * restrict points_sampled_in,
+                                 double const * restrict points_sampled_value_in,
+                                 double const * restrict noise_variance_in,
+                                 int dim_in, int num_sampled_in,
+                                 const ThreadSchedule& thread_schedule)
     : dim_(dim_in),
       num_sampled_(num_sampled_in),
       covariance_ptr_(covariance_in.Clone()),
       points_sampled_(points_sampled_in, points_sampled_in + num_sampled_in*dim_in),
       points_sampled_value_(points_sampled_value_in, points_sampled_value_in + num_sampled_in),
       noise_variance_(noise_variance_in, noise_variance_in + num_sampled_),
-      K_chol_(num_sampled_in*num_sampled_in),
+      K_chol_(std::make_shared<std::vector<double> >(num_sampled_in*num_sampled_in)),
       K_inv_y_(num_sampled_),
+      K_chol_view_(nullptr),
+      K_chol_storage_(),
+      thread_schedule_(thread_schedule),
+      generation_(NewGaussianProcessGeneration()),
       normal_rng_(kDefaultSeed) {
   RecomputeDerivedVariables();
 }
 
+GaussianProcess::GaussianProcess(const CovarianceInterface& covariance_in,
+                                 double const * restrict points_sampled_in,
+                                 double const * restrict points_sampled_value_in,
+                                 double const * restrict noise_variance_in,
+                                 double const * restrict K_chol_in,
+                                 double const * restrict K_inv_y_in,
+                                 std::shared_ptr<const void> K_chol_storage,
+                                 int dim_in, int num_sampled_in)
+    : dim_(dim_in),
+      num_sampled_(num_sampled_in),
+      covariance_ptr_(covariance_in.Clone()),
+      points_sampled_(points_sampled_in, points_sampled_in + num_sampled_in*dim_in),
+      points_sampled_value_(points_sampled_value_in, points_sampled_value_in + num_sampled_in),
+      noise_variance_(noise_variance_in, noise_variance_in + num_sampled_),
+      K_chol_(),
+      K_inv_y_(K_inv_y_in, K_inv_y_in + num_sampled_in),
+      K_chol_view_(K_chol_in),
+      K_chol_storage_(std::move(K_chol_storage)),
+      thread_schedule_(1),
+      generation_(NewGaussianProcessGeneration()),
+      normal_rng_(kDefaultSeed) {
+}
+
 GaussianProcess::GaussianProcess(const GaussianProcess& source)
     : dim_(source.dim_),
       num_sampled_(source.num_sampled_),
@@ -472,9 +675,23 @@ GaussianProcess::GaussianProcess(const GaussianProcess& source)
       noise_variance_(source.noise_variance_),
       K_chol_(source.K_chol_),
       K_inv_y_(source.K_inv_y_),
+      K_chol_view_(source.K_chol_view_),
+      K_chol_storage_(source.K_chol_storage_),
+      thread_schedule_(source.thread_schedule_),
+      generation_(source.generation_),
       normal_rng_(source.normal_rng_) {
 }
 
+void GaussianProcess::DetachCholeskyFactor(int num_entries) {
+  if (K_chol_view_ != nullptr) {
+    K_chol_ = std::make_shared<std::vector<double> >(K_chol_view_, K_chol_view_ + num_entries);
+    K_chol_view_ = nullptr;
+    K_chol_storage_.reset();
+  } else {
+    UnshareCholeskyFactor(num_entries, &K_chol_);
+  }
+}
+
 /*!\rst
   Sets up precomputed quantities needed for mean, variance, and gradients thereof.  These quantities are:
 
@@ -484,28 +701,41 @@ GaussianProcess::GaussianProcess(const GaussianProcess& source)
 
   | ``K^-1 * Ks := solution X of K_{k,l} * X_{l,i} = Ks{k,i}`` (used by variance, grad variance)
   | ``gradient of Ks := C_{d,k,i} = \pderiv{Ks_{k,i}}{Xs_{d,i}}`` (used by grad mean, grad variance)
+
+  Otherwise, if there are fixed points (``num_fixed > 0``), their columns of ``V := L^-1 * Ks`` (used by variance)
+  are precomputed too.
+
+  Each column of these quantities depends only on the corresponding point of ``Xs``, so columns of the
+  trailing ``num_cached`` (fixed) points are left untouched.
 \endrst*/
 void GaussianProcess::FillPointsToSampleState(StateType * points_to_sample_state) const {
-  BuildMixCovarianceMatrix(points_to_sample_state->points_to_sample.data(),
-                           points_to_sample_state->num_to_sample, points_to_sample_state->K_star.data());
+  const int num_to_sample = points_to_sample_state->num_to_sample;
+  const int num_fixed = points_to_sample_state->num_fixed;
+  const int num_moving = num_to_sample - points_to_sample_state->num_cached;
+  BuildMixCovarianceMatrix(points_to_sample_state->points_to_sample.data(), num_moving,
+                           points_to_sample_state->K_star.data());
 
   if (points_to_sample_state->num_derivatives > 0) {
     // to save on duplicate storage, precompute K^-1 * Ks
-    std::copy(points_to_sample_state->K_star.begin(), points_to_sample_state->K_star.end(),
+    std::copy(points_to_sample_state->K_star.begin(), points_to_sample_state->K_star.begin() + num_moving*num_sampled_,
               points_to_sample_state->K_inv_times_K_star.begin());
-    CholeskyFactorLMatrixMatrixSolve(K_chol_.data(), num_sampled_, points_to_sample_state->num_to_sample,
+    CholeskyFactorLMatrixMatrixSolve(K_chol(), num_sampled_, num_moving,
                                      points_to_sample_state->K_inv_times_K_star.data());
 
-    double * restrict gKs_temp = points_to_sample_state->grad_K_star.data();
     // also precompute C_{d,k,i} = \pderiv{Ks_{k,i}}{Xs_{d,i}}, stored in grad_K_star_
-    for (int i = 0; i < points_to_sample_state->num_derivatives; ++i) {
-      for (int j = 0; j < num_sampled_; ++j) {
-        covariance_ptr_->GradCovariance(points_to_sample_state->points_to_sample.data() + i*dim_,
-                                        points_sampled_.data() + j*dim_, gKs_temp);
-        gKs_temp += dim_;
-      }
-    }
+    covariance_ptr_->GradCovarianceMatrix(points_to_sample_state->points_to_sample.data(),
+                                          points_to_sample_state->num_derivatives, points_sampled_.data(),
+                                          num_sampled_, points_to_sample_state->grad_K_star.data());
+  } else if (num_moving > num_to_sample - num_fixed) {
+    // fixed columns of V := L^-1 * Ks; ComputeVarianceOfPoints() only solves for the moving columns
+    const int offset = (num_to_sample - num_fixed)*num_sampled_;
+    std::copy(points_to_sample_state->K_star.begin() + offset, points_to_sample_state->K_star.end(),
+              points_to_sample_state->V.begin() + offset);
+    TriangularMatrixMatrixSolve(K_chol(), 'N', num_sampled_, num_fixed, num_sampled_,
+                                points_to_sample_state->V.data() + offset);
   }
+  points_to_sample_state->num_cached = num_fixed;
+  points_to_sample_state->gaussian_process_generation = generation_;
 }
 
 /*!\rst
@@ -587,14 +817,16 @@ void GaussianProcess::ComputeVarianceOfPoints(StateType * points_to_sample_state
   const int num_to_sample = points_to_sample_state->num_to_sample;
 
   // Vars = Kss
-  BuildCovarianceMatrix(*covariance_ptr_, points_to_sample_state->points_to_sample.data(), dim_, num_to_sample, var_star);
+  BuildCovarianceMatrix(*covariance_ptr_, points_to_sample_state->points_to_sample.data(), num_to_sample, var_star);
   // following block computes Vars -= V^T*V, with the exact method depending on what quantities were precomputed
   if (unlikely(points_to_sample_state->num_derivatives == 0)) {
-    std::copy(points_to_sample_state->K_star.begin(), points_to_sample_state->K_star.end(),
+    // columns of V for the fixed points were precomputed by FillPointsToSampleState()
+    const int num_moving = num_to_sample - points_to_sample_state->num_fixed;
+    std::copy(points_to_sample_state->K_star.begin(), points_to_sample_state->K_star.begin() + num_moving*num_sampled_,
               points_to_sample_state->V.begin());
 
     // V := L^-1 * K_star
-    TriangularMatrixMatrixSolve(K_chol_.data(), 'N', num_sampled_, num_to_sample, num_sampled_,
+    TriangularMatrixMatrixSolve(K_chol(), 'N', num_sampled_, num_moving, num_sampled_,
                                 points_to_sample_state->V.data());
 
     // compute V^T V = (L^-1 * Ks)^T * (L^-1 * Ks).
@@ -609,6 +841,66 @@ void GaussianProcess::ComputeVarianceOfPoints(StateType * points_to_sample_state
   }
 }
 
+void GaussianProcess::ComputeMeanAndMarginalVarianceOfPoints(double const * restrict points_to_sample,
+                                                             int num_to_sample, double * restrict mean_of_points,
+                                                             double * restrict variance_of_points) const {
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict V = scratch.Allocate<double>(num_sampled_*num_to_sample);
+
+  // mus = Ks^T * K^-1 * y
+  BuildMixCovarianceMatrix(points_to_sample, num_to_sample, V);
+  GeneralMatrixVectorMultiply(V, 'T', K_inv_y_.data(), 1.0, 0.0, num_sampled_, num_to_sample, num_sampled_,
+                              mean_of_points);
+
+  // V := L^-1 * Ks, then Vars_{i,i} = Kss_{i,i} - V_i^T * V_i
+  TriangularMatrixMatrixSolve(K_chol(), 'N', num_sampled_, num_to_sample, num_sampled_, V);
+  for (int i = 0; i < num_to_sample; ++i) {
+    double const * restrict point = points_to_sample + i*dim_;
+    variance_of_points[i] = covariance_ptr_->Covariance(point, point) -
+        DotProduct(V + i*num_sampled_, V + i*num_sampled_, num_sampled_);
+  }
+}
+
+int MarginalPredictionChunkSize(int num_sampled) noexcept {
+  // 2^16 doubles = 512KB
+  const int cache_size_in_doubles = 1 << 16;
+  const int min_chunk_size = 64;
+  const int max_chunk_size = 1024;
+  return std::min(max_chunk_size, std::max(min_chunk_size, cache_size_in_doubles/std::max(num_sampled, 1)));
+}
+
+template <typename GaussianProcessType>
+void ComputeMeanAndMarginalVarianceOfPointList(const GaussianProcessType& gaussian_process,
+                                               const ThreadSchedule& thread_schedule,
+                                               double const * restrict points_to_sample, int num_points,
+                                               double * restrict mean_of_points,
+                                               double * restrict variance_of_points) {
+  const int dim = gaussian_process.dim();
+  const int chunk_size = MarginalPredictionChunkSize(gaussian_process.num_sampled());
+  const int num_chunks = (num_points + chunk_size - 1)/chunk_size;
+
+  omp_set_schedule(thread_schedule.schedule, thread_schedule.chunk_size);
+#pragma omp parallel for num_threads(thread_schedule.max_num_threads) schedule(runtime)
+  for (int i = 0; i < num_chunks; ++i) {
+    const int offset = i*chunk_size;
+    gaussian_process.ComputeMeanAndMarginalVarianceOfPoints(points_to_sample + offset*dim,
+                                                            std::min(chunk_size, num_points - offset),
+                                                            mean_of_points + offset, variance_of_points + offset);
+  }
+}
+
+// template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
+template void ComputeMeanAndMarginalVarianceOfPointList(
+    const GaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict points_to_sample, int num_points, double * restrict mean_of_points,
+    double * restrict variance_of_points);
+template void ComputeMeanAndMarginalVarianceOfPointList(
+    const SparseGaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict points_to_sample, int num_points, double * restrict mean_of_points,
+    double * restrict variance_of_points);
+
+namespace {  // gradients of the GP variance, shared by GaussianProcess and SparseGaussianProcess
+
 /*!\rst
   **CORE IDEA**
 
@@ -699,72 +991,60 @@ void GaussianProcess::ComputeVarianceOfPoints(StateType * points_to_sample_state
 
   Again, only the ``p``-th point of ``points_to_sample`` is differentiated against; ``p`` specfied in ``diff_index``.
 \endrst*/
-void GaussianProcess::ComputeGradVarianceOfPointsPerPoint(StateType * points_to_sample_state,
-                                                          int diff_index, double * restrict grad_var) const noexcept {
+OL_NONNULL_POINTERS void ComputeGradVarianceOfPointsPerPoint(const CovarianceInterface& covariance,
+                                                             PointsToSampleState * points_to_sample_state,
+                                                             int diff_index, double * restrict grad_var) noexcept {
+  const int dim = points_to_sample_state->dim;
+  const int num_sampled = points_to_sample_state->num_sampled;
   const int num_to_sample = points_to_sample_state->num_to_sample;
 
   // we only visit a small subset of the entries in this matrix; need to ensure the others are zero'd
-  std::fill(grad_var, grad_var + dim_*Square(num_to_sample), 0.0);
+  std::fill(grad_var, grad_var + dim*Square(num_to_sample), 0.0);
 
   // Compute: \pderiv{Ks_{i,l}}{Xs_{d,p}} * K^-1_{l,k} * Ks_{k,j} (the second term in DVvars, above).
   // Retrieve C_{l,j} = K^-1_{l,k} * Ks_{k,j}, from C stored in K_inv_times_K_star
   // Retrieve \pderiv{Ks_{l,i=p}}{Xs_{d,p}} from state struct (stored as A_{d,l,p}), use in matrix product
   // Result is computed as: A_{d,l,p} * C_{l,j}.  (Again, recall that p is fixed, so this output is over a matrix indexed {d,j}.)
-  double * restrict grad_var_target_column = grad_var + diff_index*dim_*num_to_sample;
-  GeneralMatrixMatrixMultiply(points_to_sample_state->grad_K_star.data() + diff_index*dim_*num_sampled_, 'N',
+  double * restrict grad_var_target_column = grad_var + diff_index*dim*num_to_sample;
+  GeneralMatrixMatrixMultiply(points_to_sample_state->grad_K_star.data() + diff_index*dim*num_sampled, 'N',
                               points_to_sample_state->K_inv_times_K_star.data(), 1.0, 0.0,
-                              dim_, num_sampled_, num_to_sample, grad_var_target_column);
+                              dim, num_sampled, num_to_sample, grad_var_target_column);
 
   // Fill the p-th block column of the output (p = diff_index); we will then copy this into the p-th block column.
   for (int j = 0; j < num_to_sample; ++j) {
     // Compute the leading term: \pderiv{K_ss{i=p,j}}{Xs_{d,p}}.
-    covariance_ptr_->GradCovariance(points_to_sample_state->points_to_sample.data() + diff_index*dim_,
-                                    points_to_sample_state->points_to_sample.data() + j*dim_,
-                                    points_to_sample_state->grad_cov.data());
+    covariance.GradCovariance(points_to_sample_state->points_to_sample.data() + diff_index*dim,
+                              points_to_sample_state->points_to_sample.data() + j*dim,
+                              points_to_sample_state->grad_cov.data());
     // Flip the sign, add leading term in.
     if (j == diff_index) {  // Block diagonal term needs to be multiplied by 2.
-      for (int m = 0; m < dim_; ++m) {
+      for (int m = 0; m < dim; ++m) {
         grad_var_target_column[m] *= -2.0;
         grad_var_target_column[m] += points_to_sample_state->grad_cov[m];
       }
     } else {
-      for (int m = 0; m < dim_; ++m) {
+      for (int m = 0; m < dim; ++m) {
         grad_var_target_column[m] *= -1.0;
         grad_var_target_column[m] += points_to_sample_state->grad_cov[m];
       }
     }
-    grad_var_target_column += dim_;
+    grad_var_target_column += dim;
   }
 
-  grad_var_target_column -= dim_*num_to_sample;
+  grad_var_target_column -= dim*num_to_sample;
   // Pointer to the first element of the block row we're filling.
-  double * restrict grad_var_target_row = grad_var + diff_index*dim_;
+  double * restrict grad_var_target_row = grad_var + diff_index*dim;
   // Fill in the diff_index-th block row by copying from the diff_index-th block column.
   for (int j = 0; j < num_to_sample; ++j) {
     // Skip the diagonal block (we'd just be copying it onto itself).
     if (j != diff_index) {
       // From function comments, the matrix is block-symmetric so we just copy directly.
-      for (int m = 0; m < dim_; ++m) {
+      for (int m = 0; m < dim; ++m) {
         grad_var_target_row[m] = grad_var_target_column[m];
       }
     }
-    grad_var_target_column += dim_;
-    grad_var_target_row += num_to_sample*dim_;
-  }
-}
-
-/*!\rst
-  This is just a thin wrapper that calls ComputeGradVarianceOfPointsPerPoint() in a loop ``num_derivatives`` times.
-
-  See ComputeGradVarianceOfPointsPerPoint()'s function comments and implementation for more mathematical details
-  on the derivation, algorithm, optimizations, etc.
-\endrst*/
-void GaussianProcess::ComputeGradVarianceOfPoints(StateType * points_to_sample_state,
-                                                  double * restrict grad_var) const noexcept {
-  int block_size = Square(points_to_sample_state->num_to_sample)*dim_;
-  for (int k = 0; k < points_to_sample_state->num_derivatives; ++k) {
-    ComputeGradVarianceOfPointsPerPoint(points_to_sample_state, k, grad_var);
-    grad_var += block_size;
+    grad_var_target_column += dim;
+    grad_var_target_row += num_to_sample*dim;
   }
 }
 
@@ -781,52 +1061,54 @@ void GaussianProcess::ComputeGradVarianceOfPoints(StateType * points_to_sample_s
 
   See Smith 1995 for full details of computing gradients of the cholesky factorization
 \endrst*/
-void GaussianProcess::ComputeGradCholeskyVarianceOfPointsPerPoint(StateType * points_to_sample_state,
-                                                                  int diff_index, double const * restrict chol_var,
-                                                                  double * restrict grad_chol) const noexcept {
-  ComputeGradVarianceOfPointsPerPoint(points_to_sample_state, diff_index, grad_chol);
+OL_NONNULL_POINTERS void ComputeGradCholeskyVarianceOfPointsPerPoint(const CovarianceInterface& covariance,
+                                                                     PointsToSampleState * points_to_sample_state,
+                                                                     int diff_index, double const * restrict chol_var,
+                                                                     double * restrict grad_chol) noexcept {
+  ComputeGradVarianceOfPointsPerPoint(covariance, points_to_sample_state, diff_index, grad_chol);
 
   // TODO(GH-173): Try reorganizing Smith's algorithm to use an ordering analogous to the gaxpy
   // formulation of cholesky (currently it's organized like the outer-product version which results in
   // more memory accesses).
 
+  const int dim = points_to_sample_state->dim;
   const int num_to_sample = points_to_sample_state->num_to_sample;
   // input is upper block triangular, zero the lower block triangle
   for (int i = 0; i < num_to_sample; ++i) {
-    int end_index = dim_*num_to_sample;
-    // In GV_{mji}, each j > i specifies a lower diagonal block; each block has dim_ elements.
+    int end_index = dim*num_to_sample;
+    // In GV_{mji}, each j > i specifies a lower diagonal block; each block has dim elements.
     // So we start on the (i+1)-th block and go to the end of this block column.
-    for (int j = (i+1)*dim_; j < end_index; ++j) {
+    for (int j = (i+1)*dim; j < end_index; ++j) {
       grad_chol[j] = 0.0;
     }
-    grad_chol += num_to_sample*dim_;
+    grad_chol += num_to_sample*dim;
   }
-  grad_chol -= num_to_sample*num_to_sample*dim_;
+  grad_chol -= num_to_sample*num_to_sample*dim;
 
   // Loop annotations match those in ComputeCholeskyFactorL() to describe what each segment differentiates and how.
   // In the following comments, L_{ij} := chol_var[j*num_to_sample + i] is the cholesky factorization of the variance,
-  // and GV_{mij} := grad_chol[j*num_to_sample*dim_ + i*dim_ + m] is the gradient of variance (input),
-  // and GL_{mij} := grad_chol[j*num_to_sample*dim_ + i*dim_ + m] is the gradient of cholesky of variance (on exit)
+  // and GV_{mij} := grad_chol[j*num_to_sample*dim + i*dim + m] is the gradient of variance (input),
+  // and GL_{mij} := grad_chol[j*num_to_sample*dim + i*dim + m] is the gradient of cholesky of variance (on exit)
   // Define macros specifying the data layout assumption on L_{ij} and GV_{mij}. The macro simplifies complex indexing
   // so that OL_CHOL_VAR(i, j) reads just like L_{ij}, for example.
 #define OL_CHOL_VAR(i, j) chol_var[((j)*num_to_sample + (i))]
-#define OL_GRAD_CHOL(m, i, j) grad_chol[((j)*num_to_sample*dim_ + (i)*dim_ + (m))]
+#define OL_GRAD_CHOL(m, i, j) grad_chol[((j)*num_to_sample*dim + (i)*dim + (m))]
 
   for (int k = 0; k < num_to_sample; ++k) {
     // L_kk := L_{kk}
     const double L_kk = OL_CHOL_VAR(k, k);
 
-    if (likely(L_kk > kMinimumStdDev)) {
+    if (likely(L_kk > GaussianProcess::kMinimumStdDev)) {
       // differentiates L_kk := L_{kk}
       // GL_{mkk} = 0.5 * GV_{mkk}/L_{kk}
-      for (int m = 0; m < dim_; ++m) {
+      for (int m = 0; m < dim; ++m) {
         OL_GRAD_CHOL(m, k, k) = 0.5*OL_GRAD_CHOL(m, k, k)/L_kk;
       }
 
       // differentiates L_{jk} = L_{jk}/L_{kk}
       // GL_{mkj} = (GV_{mkj} - L_{jk}*GV_{mkk})/L_{kk}
       for (int j = k+1; j < num_to_sample; ++j) {
-        for (int m = 0; m < dim_; ++m) {
+        for (int m = 0; m < dim; ++m) {
           OL_GRAD_CHOL(m, k, j) = (OL_GRAD_CHOL(m, k, j) - OL_CHOL_VAR(j, k)*OL_GRAD_CHOL(m, k, k))/L_kk;
         }
       }  // end for j: num_to_sample
@@ -835,7 +1117,7 @@ void GaussianProcess::ComputeGradCholeskyVarianceOfPointsPerPoint(StateType * po
       // GL_{mji} = GV_{mji} - GV_{mki}*L_{jk} - L_{ik}*GV_{mkj}
       for (int j = k+1; j < num_to_sample; ++j) {
         for (int i = j; i < num_to_sample; ++i) {
-          for (int m = 0; m < dim_; ++m) {
+          for (int m = 0; m < dim; ++m) {
             OL_GRAD_CHOL(m, j, i) = OL_GRAD_CHOL(m, j, i)
                 - OL_GRAD_CHOL(m, k, i)*OL_CHOL_VAR(j, k) - OL_CHOL_VAR(i, k)*OL_GRAD_CHOL(m, k, j);
           }
@@ -849,6 +1131,23 @@ void GaussianProcess::ComputeGradCholeskyVarianceOfPointsPerPoint(StateType * po
 #undef OL_GRAD_CHOL
 }
 
+}  // end unnamed namespace
+
+/*!\rst
+  This is just a thin wrapper that calls ComputeGradVarianceOfPointsPerPoint() in a loop ``num_derivatives`` times.
+
+  See ComputeGradVarianceOfPointsPerPoint()'s function comments and implementation for more mathematical details
+  on the derivation, algorithm, optimizations, etc.
+\endrst*/
+void GaussianProcess::ComputeGradVarianceOfPoints(StateType * points_to_sample_state,
+                                                  double * restrict grad_var) const noexcept {
+  int block_size = Square(points_to_sample_state->num_to_sample)*dim_;
+  for (int k = 0; k < points_to_sample_state->num_derivatives; ++k) {
+    ComputeGradVarianceOfPointsPerPoint(*covariance_ptr_, points_to_sample_state, k, grad_var);
+    grad_var += block_size;
+  }
+}
+
 /*!\rst
   This is just a thin wrapper that calls ComputeGradCholeskyVarianceOfPointsPerPoint() in a loop ``num_derivatives`` times.
 
@@ -860,7 +1159,7 @@ void GaussianProcess::ComputeGradCholeskyVarianceOfPoints(StateType * points_to_
                                                           double * restrict grad_chol) const noexcept {
   int block_size = Square(points_to_sample_state->num_to_sample)*dim_;
   for (int k = 0; k < points_to_sample_state->num_derivatives; ++k) {
-    ComputeGradCholeskyVarianceOfPointsPerPoint(points_to_sample_state, k, chol_var, grad_chol);
+    ComputeGradCholeskyVarianceOfPointsPerPoint(*covariance_ptr_, points_to_sample_state, k, chol_var, grad_chol);
     grad_chol += block_size;
   }
 }
@@ -870,6 +1169,7 @@ void GaussianProcess::AddPointsToGP(double const * restrict new_points,
                                     double const * restrict new_points_noise_variance,
                                     int num_new_points) {
   // update sizes
+  const int num_sampled_old = num_sampled_;
   num_sampled_ += num_new_points;
 
   // update state variables
@@ -881,11 +1181,13 @@ void GaussianProcess::AddPointsToGP(double const * restrict new_points,
 
   noise_variance_.resize(num_sampled_);
   std::copy_backward(new_points_noise_variance, new_points_noise_variance + num_new_points, noise_variance_.end());
+  generation_ = NewGaussianProcessGeneration();
 
-  // recompute derived quantities
-  // TODO(GH-192): Insert the new covariance (and cholesky covariance) rows into the current matrix  (O(N^2))
-  // instead of recomputing everything (O(N^3)).
-  RecomputeDerivedVariables();
+  // update derived quantities: extend the existing factorization (O(N^2)) when possible; fall back to
+  // recomputing everything (O(N^3)) if there is nothing to extend or the new pivots are singular
+  if (unlikely(num_sampled_old == 0 || !ExtendDerivedVariables(num_sampled_old))) {
+    RecomputeDerivedVariables();
+  }
 }
 
 /*!\rst
@@ -907,7 +1209,7 @@ double GaussianProcess::SamplePointFromGP(double const * restrict point_to_sampl
   const int num_to_sample = 1;  // we will only draw 1 point at a time from the GP
 
   if (unlikely(num_sampled_ == 0)) {
-    BuildCovarianceMatrix(*covariance_ptr_, point_to_sample, dim_, num_to_sample, &gpp_variance);
+    BuildCovarianceMatrix(*covariance_ptr_, point_to_sample, num_to_sample, &gpp_variance);
     return std::sqrt(gpp_variance) * normal_rng_() + std::sqrt(noise_variance_this_point)*normal_rng_();  // first draw has mean 0
   } else {
     int num_derivatives = 0;
@@ -936,249 +1238,806 @@ GaussianProcess * GaussianProcess::Clone() const {
   return new GaussianProcess(*this);
 }
 
-void PointsToSampleState::SetupState(const GaussianProcess& gaussian_process, double const * restrict points_to_sample_in,
-                                     int num_to_sample_in, int num_derivatives_in) {
-  // resize data depending on to sample points
-  if (unlikely(num_to_sample != num_to_sample_in || num_derivatives != num_derivatives_in)) {
-    // update sizes
-    num_to_sample = num_to_sample_in;
-    num_derivatives = num_derivatives_in;
-    // resize vectors
-    points_to_sample.resize(dim*num_to_sample);
-    K_star.resize(num_to_sample*num_sampled);
-    grad_K_star.resize(num_derivatives*num_sampled*dim);
-    V.resize(num_to_sample*num_sampled);
-    K_inv_times_K_star.resize(num_to_sample*num_sampled);
-  }
-
-  // resize data depending on sampled points
-  if (unlikely(num_sampled != gaussian_process.num_sampled())) {
-    num_sampled = gaussian_process.num_sampled();
-    K_star.resize(num_to_sample*num_sampled);
-    grad_K_star.resize(num_to_sample*num_sampled*dim);
-    V.resize(num_to_sample*num_sampled);
-    K_inv_times_K_star.resize(num_to_sample*num_sampled);
+SparseGaussianProcess::SparseGaussianProcess(const CovarianceInterface& covariance_in,
+                                             double const * restrict points_sampled_in,
+                                             double const * restrict points_sampled_value_in,
+                                             double const * restrict noise_variance_in,
+                                             double const * restrict inducing_points_in,
+                                             int dim_in, int num_sampled_in, int num_inducing_in,
+                                             SparseGaussianProcessTypes approximation_type_in)
+    : dim_(dim_in),
+      num_sampled_(num_sampled_in),
+      num_inducing_(num_inducing_in),
+      approximation_type_(approximation_type_in),
+      covariance_ptr_(covariance_in.Clone()),
+      points_sampled_(points_sampled_in, points_sampled_in + num_sampled_in*dim_in),
+      points_sampled_value_(points_sampled_value_in, points_sampled_value_in + num_sampled_in),
+      noise_variance_(noise_variance_in, noise_variance_in + num_sampled_in),
+      inducing_points_(inducing_points_in, inducing_points_in + num_inducing_in*dim_in),
+      K_uu_chol_(),
+      B_chol_(),
+      weights_(num_inducing_in),
+      generation_(NewGaussianProcessGeneration()) {
+  for (int i = 0; i < num_sampled_; ++i) {
+    if (unlikely(noise_variance_[i] <= 0.0)) {
+      OL_THROW_EXCEPTION(LowerBoundException<double>, "SparseGaussianProcess requires noise_variance > 0.",
+                         noise_variance_[i], 0.0);
+    }
   }
-
-  // set new points to sample
-  std::copy(points_to_sample_in, points_to_sample_in + dim*num_to_sample, points_to_sample.begin());
-
-  gaussian_process.FillPointsToSampleState(this);
-}
-
-PointsToSampleState::PointsToSampleState(const GaussianProcess& gaussian_process,
-                                         double const * restrict points_to_sample_in,
-                                         int num_to_sample_in, int num_derivatives_in)
-    : dim(gaussian_process.dim()),
-      num_sampled(gaussian_process.num_sampled()),
-      num_to_sample(num_to_sample_in),
-      num_derivatives(num_derivatives_in),
-      points_to_sample(dim*num_to_sample),
-      K_star(num_to_sample*num_sampled),
-      grad_K_star(num_derivatives*num_sampled*dim),
-      V(num_to_sample*num_sampled),
-      K_inv_times_K_star(num_to_sample*num_sampled),
-      grad_cov(dim) {
-  SetupState(gaussian_process, points_to_sample_in, num_to_sample_in, num_derivatives_in);
+  RecomputeDerivedVariables();
 }
 
-PointsToSampleState::PointsToSampleState(PointsToSampleState&& OL_UNUSED(other)) = default;
-
-ExpectedImprovementEvaluator::ExpectedImprovementEvaluator(const GaussianProcess& gaussian_process_in,
-                                                           int num_mc_iterations, double best_so_far)
-    : dim_(gaussian_process_in.dim()),
-      num_mc_iterations_(num_mc_iterations),
-      best_so_far_(best_so_far),
-      gaussian_process_(&gaussian_process_in) {
+SparseGaussianProcess::SparseGaussianProcess(const SparseGaussianProcess& source)
+    : dim_(source.dim_),
+      num_sampled_(source.num_sampled_),
+      num_inducing_(source.num_inducing_),
+      approximation_type_(source.approximation_type_),
+      covariance_ptr_(source.covariance_ptr_->Clone()),
+      points_sampled_(source.points_sampled_),
+      points_sampled_value_(source.points_sampled_value_),
+      noise_variance_(source.noise_variance_),
+      inducing_points_(source.inducing_points_),
+      K_uu_chol_(source.K_uu_chol_),
+      B_chol_(source.B_chol_),
+      weights_(source.weights_),
+      generation_(source.generation_) {
 }
 
 /*!\rst
-  Let ``Ls * Ls^T = Vars`` and ``w`` = vector of IID normal(0,1) variables
-  Then:
-
-  ``y = mus + Ls * w``  (Equation 4, from file docs)
-
-  simulates drawing from our GP with mean mus and variance Vars.
-
-  Then as given in the file docs, we compute the improvement:
-  Then the improvement for this single sample is::
-
-    I = { best_known - min(y)   if (best_known - min(y) > 0)      (Equation 5 from file docs)
-        {          0               else
+  With ``Lu * Lu^T = Ku`` and ``A = Lu^{-1} * Kuf * \Lambda^{-1/2}`` (``M x N``):
 
-  This is implemented as ``max_{y} (best_known - y)``.  Notice that improvement takes the value 0 if it would be negative.
-
-  Since we cannot compute ``min(y)`` directly, we do so via monte-carlo (MC) integration.  That is, we draw from the GP
-  repeatedly, computing improvement during each iteration, and averaging the result.
+  ``Ku + Kuf * \Lambda^{-1} * Kuf^T = Lu * B * Lu^T``, where ``B = I + A * A^T``
 
-  See Scott's PhD thesis, sec 6.2.
+  So ``\Sigma = Lu^{-T} * B^{-1} * Lu^{-1}`` only needs the cholesky factors of the ``M x M`` matrices ``Ku`` and ``B``.
+  ``A`` is the only ``O(N*M)`` quantity; forming it costs ``O(N*M^2)`` (triangular solves) as does ``A * A^T``.
+  Column ``i`` of ``Lu^{-1} * Kuf`` has squared norm ``Q_{ii}``, which gives the FITC correction
+  ``\Lambda_{ii} = K_{ii} - Q_{ii} + \sigma_n^2`` at no extra cost.
 
-  .. Note:: comments here are copied to _compute_expected_improvement_monte_carlo() in python_version/expected_improvement.py
+  Then the mean weights are ``\Sigma * Kuf * \Lambda^{-1} * y = Lu^{-T} * B^{-1} * A * \Lambda^{-1/2} * y``.
 \endrst*/
-double ExpectedImprovementEvaluator::ComputeExpectedImprovement(StateType * ei_state) const {
-  int num_union = ei_state->num_union;
-  gaussian_process_->ComputeMeanOfPoints(ei_state->points_to_sample_state, ei_state->to_sample_mean.data());
-  gaussian_process_->ComputeVarianceOfPoints(&(ei_state->points_to_sample_state), ei_state->cholesky_to_sample_var.data());
-  int leading_minor_index = ComputeCholeskyFactorL(num_union, ei_state->cholesky_to_sample_var.data());
+void SparseGaussianProcess::RecomputeDerivedVariables() {
+  // the factors may be shared with clones; both are recomputed from scratch
+  std::vector<double>& K_uu_chol = UnshareCholeskyFactor(0, &K_uu_chol_);
+  std::vector<double>& B_chol = UnshareCholeskyFactor(0, &B_chol_);
+  K_uu_chol.resize(num_inducing_*num_inducing_);
+  B_chol.resize(num_inducing_*num_inducing_);
+
+  // Ku = K(U,U) (plus jitter) = Lu * Lu^T
+  BuildCovarianceMatrix(*covariance_ptr_, inducing_points_.data(), num_inducing_, K_uu_chol.data());
+  for (int i = 0; i < num_inducing_; ++i) {
+    K_uu_chol[i*num_inducing_ + i] *= 1.0 + kInducingPointJitter;
+  }
+  int leading_minor_index = ComputeCholeskyFactorL(num_inducing_, K_uu_chol.data());
   if (unlikely(leading_minor_index != 0)) {
-    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample/being_sampled or points_to_sample/being_sampled duplicating points_sampled with 0 noise.", ei_state->cholesky_to_sample_var.data(), num_union, leading_minor_index);
+    OL_THROW_EXCEPTION(SingularMatrixException,
+                       "Inducing point covariance matrix (K_uu) singular. Check for duplicate inducing_points "
+                       "and/or extreme hyperparameter values.",
+                       K_uu_chol.data(), num_inducing_, leading_minor_index);
   }
 
-  double aggregate = 0.0;
-  for (int i = 0; i < num_mc_iterations_; ++i) {
-    double improvement_this_step = 0.0;
-    for (int j = 0; j < num_union; ++j) {
-      ei_state->EI_this_step_from_var[j] = (*(ei_state->normal_rng))();  // EI_this_step now holds "normals"
+  // A = Lu^-1 * Kuf, then each column is scaled by \Lambda_{ii}^{-1/2}
+  std::vector<double> A(num_inducing_*num_sampled_);
+  optimal_learning::BuildMixCovarianceMatrix(*covariance_ptr_, inducing_points_.data(), points_sampled_.data(),
+                                             num_inducing_, num_sampled_, A.data());
+  TriangularMatrixMatrixSolve(K_uu_chol.data(), 'N', num_inducing_, num_sampled_, num_inducing_, A.data());
+
+  // accumulate B = I + A * A^T (lower triangle) and weights_ = A * \Lambda^{-1/2} * y one column of A at a time
+  std::fill(B_chol.begin(), B_chol.end(), 0.0);
+  std::fill(weights_.begin(), weights_.end(), 0.0);
+  double * restrict A_column = A.data();
+  for (int i = 0; i < num_sampled_; ++i) {
+    double lambda = noise_variance_[i];
+    if (approximation_type_ == SparseGaussianProcessTypes::kFITC) {
+      double const * restrict point = points_sampled_.data() + i*dim_;
+      // K_{ii} - Q_{ii} >= 0 in exact arithmetic
+      lambda += std::fmax(0.0, covariance_ptr_->Covariance(point, point) - DotProduct(A_column, A_column, num_inducing_));
     }
-
-    // compute EI_this_step_from_far = cholesky * normals   as  EI = cholesky * EI
-    // b/c normals currently held in EI_this_step_from_var
-    TriangularMatrixVectorMultiply(ei_state->cholesky_to_sample_var.data(), 'N', num_union,
-                                   ei_state->EI_this_step_from_var.data());
-    for (int j = 0; j < num_union; ++j) {
-      double EI_total = best_so_far_ - (ei_state->to_sample_mean[j] + ei_state->EI_this_step_from_var[j]);
-      if (EI_total > improvement_this_step) {
-        improvement_this_step = EI_total;
+    const double inverse_sqrt_lambda = 1.0/std::sqrt(lambda);
+    VectorScale(num_inducing_, inverse_sqrt_lambda, A_column);
+    VectorAXPY(num_inducing_, inverse_sqrt_lambda*points_sampled_value_[i], A_column, weights_.data());
+
+    double * restrict B_column = B_chol.data();
+    for (int k = 0; k < num_inducing_; ++k) {
+      for (int j = k; j < num_inducing_; ++j) {
+        B_column[j] += A_column[j]*A_column[k];
       }
+      B_column += num_inducing_;
     }
+    A_column += num_inducing_;
+  }
+  for (int j = 0; j < num_inducing_; ++j) {
+    B_chol[j*num_inducing_ + j] += 1.0;
+  }
 
-    if (improvement_this_step > 0.0) {
-      aggregate += improvement_this_step;
-    }
+  // B >= I, so this only fails on non-finite inputs
+  leading_minor_index = ComputeCholeskyFactorL(num_inducing_, B_chol.data());
+  if (unlikely(leading_minor_index != 0)) {
+    OL_THROW_EXCEPTION(SingularMatrixException, "Sparse GP matrix (B = I + A * A^T) singular. Check for non-finite inputs.",
+                       B_chol.data(), num_inducing_, leading_minor_index);
   }
 
-  return aggregate/static_cast<double>(num_mc_iterations_);
+  CholeskyFactorLMatrixVectorSolve(B_chol.data(), num_inducing_, weights_.data());
+  TriangularMatrixVectorSolve(K_uu_chol.data(), 'T', num_inducing_, num_inducing_, weights_.data());
 }
 
 /*!\rst
-  Computes gradient of EI (see ExpectedImprovementEvaluator::ComputeGradExpectedImprovement) wrt points_to_sample (stored in
-  ``union_of_points[0:num_to_sample]``).
-
-  Mechanism is similar to the computation of EI, where points' contributions to the gradient are thrown out of their
-  corresponding ``improvement <= 0.0``.
+  Same as GaussianProcess::FillPointsToSampleState(), with ``X`` replaced by the inducing points ``U`` and ``K^-1``
+  replaced by ``Ku^{-1} - \Sigma = Lu^{-T} * (I - B^{-1}) * Lu^{-1}`` (see RecomputeDerivedVariables()), which is
+  applied with triangular solves in ``O(M^2)`` per point.
+\endrst*/
+void SparseGaussianProcess::FillPointsToSampleState(StateType * points_to_sample_state) const {
+  // columns of the trailing num_cached (fixed) points are up to date
+  const int num_moving = points_to_sample_state->num_to_sample - points_to_sample_state->num_cached;
+  optimal_learning::BuildMixCovarianceMatrix(*covariance_ptr_, inducing_points_.data(),
+                                             points_to_sample_state->points_to_sample.data(), num_inducing_,
+                                             num_moving, points_to_sample_state->K_star.data());
 
-  Thus ``\nabla(\mu)`` only contributes when the ``winner`` (point w/best improvement this iteration) is the current point.
-  That is, the gradient of ``\mu`` at ``x_i`` wrt ``x_j`` is 0 unless ``i == j`` (and only this result is stored in
-  ``ei_state->grad_mu``).  The interaction with ``ei_state->grad_chol_decomp`` is harder to know a priori (like with
-  ``grad_mu``) and has a more complex structure (rank 3 tensor), so the derivative wrt ``x_j`` is computed fully, and
-  the relevant submatrix (indexed by the current ``winner``) is accessed each iteration.
+  if (points_to_sample_state->num_derivatives > 0) {
+    // precompute [Ku^-1 - \Sigma] * Ks; V holds B^-1 * Lu^-1 * Ks temporarily
+    double * restrict K_inv_times_K_star = points_to_sample_state->K_inv_times_K_star.data();
+    double * restrict V = points_to_sample_state->V.data();
+    std::copy(points_to_sample_state->K_star.begin(), points_to_sample_state->K_star.begin() + num_moving*num_inducing_,
+              K_inv_times_K_star);
+    TriangularMatrixMatrixSolve(K_uu_chol_->data(), 'N', num_inducing_, num_moving, num_inducing_,
+                                K_inv_times_K_star);
+    std::copy(K_inv_times_K_star, K_inv_times_K_star + num_inducing_*num_moving, V);
+    CholeskyFactorLMatrixMatrixSolve(B_chol_->data(), num_inducing_, num_moving, V);
+    VectorAXPY(num_inducing_*num_moving, -1.0, V, K_inv_times_K_star);
+    TriangularMatrixMatrixSolve(K_uu_chol_->data(), 'T', num_inducing_, num_moving, num_inducing_,
+                                K_inv_times_K_star);
 
-  .. Note:: comments here are copied to _compute_grad_expected_improvement_monte_carlo() in python_version/expected_improvement.py
-\endrst*/
-void ExpectedImprovementEvaluator::ComputeGradExpectedImprovement(StateType * ei_state, double * restrict grad_EI) const {
-  const int num_union = ei_state->num_union;
-  gaussian_process_->ComputeMeanOfPoints(ei_state->points_to_sample_state, ei_state->to_sample_mean.data());
-  gaussian_process_->ComputeGradMeanOfPoints(ei_state->points_to_sample_state, ei_state->grad_mu.data());
-  gaussian_process_->ComputeVarianceOfPoints(&(ei_state->points_to_sample_state), ei_state->cholesky_to_sample_var.data());
-  int leading_minor_index = ComputeCholeskyFactorL(num_union, ei_state->cholesky_to_sample_var.data());
-  if (unlikely(leading_minor_index != 0)) {
-    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample/being_sampled or points_to_sample/being_sampled duplicating points_sampled with 0 noise.", ei_state->cholesky_to_sample_var.data(), num_union, leading_minor_index);
+    // also precompute C_{d,k,i} = \pderiv{Ks_{k,i}}{Xs_{d,i}}, stored in grad_K_star_
+    covariance_ptr_->GradCovarianceMatrix(points_to_sample_state->points_to_sample.data(),
+                                          points_to_sample_state->num_derivatives, inducing_points_.data(),
+                                          num_inducing_, points_to_sample_state->grad_K_star.data());
   }
+  points_to_sample_state->num_cached = points_to_sample_state->num_fixed;
+  points_to_sample_state->gaussian_process_generation = generation_;
+}
 
-  gaussian_process_->ComputeGradCholeskyVarianceOfPoints(&(ei_state->points_to_sample_state),
-                                                         ei_state->cholesky_to_sample_var.data(),
-                                                         ei_state->grad_chol_decomp.data());
+void SparseGaussianProcess::ComputeMeanOfPoints(const StateType& points_to_sample_state,
+                                                double * restrict mean_of_points) const noexcept {
+  GeneralMatrixVectorMultiply(points_to_sample_state.K_star.data(), 'T', weights_.data(), 1.0, 0.0,
+                              num_inducing_, points_to_sample_state.num_to_sample, num_inducing_, mean_of_points);
+}
 
-  std::fill(ei_state->aggregate.begin(), ei_state->aggregate.end(), 0.0);
-  double aggregate_EI = 0.0;
-  for (int i = 0; i < num_mc_iterations_; ++i) {
-    for (int j = 0; j < num_union; ++j) {
-      ei_state->EI_this_step_from_var[j] = (*(ei_state->normal_rng))();  // EI_this_step now holds "normals"
-      ei_state->normals[j] = ei_state->EI_this_step_from_var[j];  // orig value of normals needed if improvement_this_step > 0.0
-    }
+void SparseGaussianProcess::ComputeGradMeanOfPoints(const StateType& points_to_sample_state,
+                                                    double * restrict grad_mu) const noexcept {
+  SpecialTensorVectorMultiply(points_to_sample_state.grad_K_star.data(), weights_.data(),
+                              points_to_sample_state.num_derivatives, num_inducing_, dim_, grad_mu);
+}
 
-    // compute EI_this_step_from_far = cholesky * normals   as  EI = cholesky * EI
-    // b/c normals currently held in EI_this_step_from_var
-    TriangularMatrixVectorMultiply(ei_state->cholesky_to_sample_var.data(), 'N', num_union,
-                                   ei_state->EI_this_step_from_var.data());
+/*!\rst
+  ``Vars = Kss - Ks^T * [Ku^{-1} - \Sigma] * Ks = Kss - V^T * V + W^T * W``, where ``V = Lu^{-1} * Ks`` and
+  ``W = L_B^{-1} * V`` (``L_B`` the cholesky factor of ``B``; see RecomputeDerivedVariables()).  As in
+  GaussianProcess::ComputeVarianceOfPoints(), the precomputed ``[Ku^{-1} - \Sigma] * Ks`` is used when available.
+\endrst*/
+void SparseGaussianProcess::ComputeVarianceOfPoints(StateType * points_to_sample_state,
+                                                    double * restrict var_star) const noexcept {
+  const int num_to_sample = points_to_sample_state->num_to_sample;
+
+  // Vars = Kss
+  BuildCovarianceMatrix(*covariance_ptr_, points_to_sample_state->points_to_sample.data(), num_to_sample, var_star);
+  if (unlikely(points_to_sample_state->num_derivatives == 0)) {
+    std::copy(points_to_sample_state->K_star.begin(), points_to_sample_state->K_star.end(),
+              points_to_sample_state->V.begin());
+
+    // Vars -= V^T * V, V := Lu^-1 * K_star
+    TriangularMatrixMatrixSolve(K_uu_chol_->data(), 'N', num_inducing_, num_to_sample, num_inducing_,
+                                points_to_sample_state->V.data());
+    GeneralMatrixMatrixMultiply(points_to_sample_state->V.data(), 'T', points_to_sample_state->V.data(),
+                                -1.0, 1.0, num_to_sample, num_inducing_, num_to_sample, var_star);
+
+    // Vars += W^T * W, W := L_B^-1 * V
+    TriangularMatrixMatrixSolve(B_chol_->data(), 'N', num_inducing_, num_to_sample, num_inducing_,
+                                points_to_sample_state->V.data());
+    GeneralMatrixMatrixMultiply(points_to_sample_state->V.data(), 'T', points_to_sample_state->V.data(),
+                                1.0, 1.0, num_to_sample, num_inducing_, num_to_sample, var_star);
+  } else {
+    GeneralMatrixMatrixMultiply(points_to_sample_state->K_star.data(), 'T',
+                                points_to_sample_state->K_inv_times_K_star.data(),
+                                -1.0, 1.0, num_to_sample, num_inducing_, num_to_sample, var_star);
+  }
+}
+
+void SparseGaussianProcess::ComputeMeanAndMarginalVarianceOfPoints(double const * restrict points_to_sample,
+                                                                   int num_to_sample,
+                                                                   double * restrict mean_of_points,
+                                                                   double * restrict variance_of_points) const {
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict V = scratch.Allocate<double>(num_inducing_*num_to_sample);
+
+  optimal_learning::BuildMixCovarianceMatrix(*covariance_ptr_, inducing_points_.data(), points_to_sample,
+                                             num_inducing_, num_to_sample, V);
+  GeneralMatrixVectorMultiply(V, 'T', weights_.data(), 1.0, 0.0, num_inducing_, num_to_sample, num_inducing_,
+                              mean_of_points);
+
+  // Vars_{i,i} = Kss_{i,i} - V_i^T * V_i + W_i^T * W_i, V := Lu^-1 * Ks, W := L_B^-1 * V
+  TriangularMatrixMatrixSolve(K_uu_chol_->data(), 'N', num_inducing_, num_to_sample, num_inducing_, V);
+  for (int i = 0; i < num_to_sample; ++i) {
+    double const * restrict point = points_to_sample + i*dim_;
+    variance_of_points[i] = covariance_ptr_->Covariance(point, point) -
+        DotProduct(V + i*num_inducing_, V + i*num_inducing_, num_inducing_);
+  }
+  TriangularMatrixMatrixSolve(B_chol_->data(), 'N', num_inducing_, num_to_sample, num_inducing_, V);
+  for (int i = 0; i < num_to_sample; ++i) {
+    variance_of_points[i] += DotProduct(V + i*num_inducing_, V + i*num_inducing_, num_inducing_);
+  }
+}
+
+/*!\rst
+  Identical to GaussianProcess::ComputeGradVarianceOfPoints() given the precomputed quantities in
+  ``points_to_sample_state`` (see FillPointsToSampleState()); ``[Ku^{-1} - \Sigma]`` is symmetric, as ``K^-1`` is.
+\endrst*/
+void SparseGaussianProcess::ComputeGradVarianceOfPoints(StateType * points_to_sample_state,
+                                                        double * restrict grad_var) const noexcept {
+  int block_size = Square(points_to_sample_state->num_to_sample)*dim_;
+  for (int k = 0; k < points_to_sample_state->num_derivatives; ++k) {
+    ComputeGradVarianceOfPointsPerPoint(*covariance_ptr_, points_to_sample_state, k, grad_var);
+    grad_var += block_size;
+  }
+}
+
+void SparseGaussianProcess::ComputeGradCholeskyVarianceOfPoints(StateType * points_to_sample_state,
+                                                                double const * restrict chol_var,
+                                                                double * restrict grad_chol) const noexcept {
+  int block_size = Square(points_to_sample_state->num_to_sample)*dim_;
+  for (int k = 0; k < points_to_sample_state->num_derivatives; ++k) {
+    ComputeGradCholeskyVarianceOfPointsPerPoint(*covariance_ptr_, points_to_sample_state, k, chol_var, grad_chol);
+    grad_chol += block_size;
+  }
+}
+
+SparseGaussianProcess * SparseGaussianProcess::Clone() const {
+  return new SparseGaussianProcess(*this);
+}
+
+void PointsToSampleState::ResizeState(int num_sampled_in, int num_to_sample_in, int num_derivatives_in) {
+  if (unlikely(num_fixed > num_to_sample_in || num_derivatives_in > num_to_sample_in - num_fixed)) {
+    OL_THROW_EXCEPTION(BoundsException<int>, "num_fixed + num_derivatives must be <= num_to_sample.",
+                       num_fixed + num_derivatives_in, 0, num_to_sample_in);
+  }
+  num_cached = 0;
+
+  // resize data depending on to sample points and sampled points
+  if (unlikely(num_to_sample != num_to_sample_in || num_derivatives != num_derivatives_in ||
+               num_sampled != num_sampled_in)) {
+    // update sizes
+    num_sampled = num_sampled_in;
+    num_to_sample = num_to_sample_in;
+    num_derivatives = num_derivatives_in;
+    // resize vectors
+    points_to_sample.resize(dim*num_to_sample);
+    K_star.resize(num_to_sample*num_sampled);
+    grad_K_star.resize(num_derivatives*num_sampled*dim);
+    V.resize(num_to_sample*num_sampled);
+    K_inv_times_K_star.resize(num_to_sample*num_sampled);
+  }
+}
+
+void PointsToSampleState::SetupState(const GaussianProcess& gaussian_process, double const * restrict points_to_sample_in,
+                                     int num_to_sample_in, int num_derivatives_in) {
+  ResizeState(gaussian_process.num_sampled(), num_to_sample_in, num_derivatives_in);
+  std::copy(points_to_sample_in, points_to_sample_in + dim*num_to_sample, points_to_sample.begin());
+  gaussian_process.FillPointsToSampleState(this);
+}
+
+void PointsToSampleState::SetupState(const SparseGaussianProcess& gaussian_process,
+                                     double const * restrict points_to_sample_in,
+                                     int num_to_sample_in, int num_derivatives_in) {
+  ResizeState(gaussian_process.num_inducing(), num_to_sample_in, num_derivatives_in);
+  std::copy(points_to_sample_in, points_to_sample_in + dim*num_to_sample, points_to_sample.begin());
+  gaussian_process.FillPointsToSampleState(this);
+}
+
+void PointsToSampleState::UpdateMovingPoints(const GaussianProcess& gaussian_process,
+                                             double const * restrict points_to_sample_moving) {
+  // the cached columns are only valid for the GP (generation) that computed them
+  if (unlikely(gaussian_process_generation != gaussian_process.generation())) {
+    ResizeState(gaussian_process.num_sampled(), num_to_sample, num_derivatives);
+  }
+  std::copy(points_to_sample_moving, points_to_sample_moving + dim*(num_to_sample - num_fixed),
+            points_to_sample.begin());
+  gaussian_process.FillPointsToSampleState(this);
+}
+
+void PointsToSampleState::UpdateMovingPoints(const SparseGaussianProcess& gaussian_process,
+                                             double const * restrict points_to_sample_moving) {
+  if (unlikely(gaussian_process_generation != gaussian_process.generation())) {
+    ResizeState(gaussian_process.num_inducing(), num_to_sample, num_derivatives);
+  }
+  std::copy(points_to_sample_moving, points_to_sample_moving + dim*(num_to_sample - num_fixed),
+            points_to_sample.begin());
+  gaussian_process.FillPointsToSampleState(this);
+}
+
+PointsToSampleState::PointsToSampleState(const GaussianProcess& gaussian_process,
+                                         double const * restrict points_to_sample_in,
+                                         int num_to_sample_in, int num_derivatives_in)
+    : PointsToSampleState(gaussian_process, points_to_sample_in, num_to_sample_in, num_derivatives_in, 0) {
+}
+
+PointsToSampleState::PointsToSampleState(const SparseGaussianProcess& gaussian_process,
+                                         double const * restrict points_to_sample_in,
+                                         int num_to_sample_in, int num_derivatives_in)
+    : PointsToSampleState(gaussian_process, points_to_sample_in, num_to_sample_in, num_derivatives_in, 0) {
+}
+
+PointsToSampleState::PointsToSampleState(const GaussianProcess& gaussian_process,
+                                         double const * restrict points_to_sample_in,
+                                         int num_to_sample_in, int num_derivatives_in, int num_fixed_in)
+    : dim(gaussian_process.dim()),
+      num_sampled(gaussian_process.num_sampled()),
+      num_to_sample(num_to_sample_in),
+      num_derivatives(num_derivatives_in),
+      num_fixed(num_fixed_in),
+      num_cached(0),
+      gaussian_process_generation(0),
+      points_to_sample(dim*num_to_sample),
+      K_star(num_to_sample*num_sampled),
+      grad_K_star(num_derivatives*num_sampled*dim),
+      V(num_to_sample*num_sampled),
+      K_inv_times_K_star(num_to_sample*num_sampled),
+      grad_cov(dim) {
+  SetupState(gaussian_process, points_to_sample_in, num_to_sample_in, num_derivatives_in);
+}
+
+PointsToSampleState::PointsToSampleState(const SparseGaussianProcess& gaussian_process,
+                                         double const * restrict points_to_sample_in,
+                                         int num_to_sample_in, int num_derivatives_in, int num_fixed_in)
+    : dim(gaussian_process.dim()),
+      num_sampled(gaussian_process.num_inducing()),
+      num_to_sample(num_to_sample_in),
+      num_derivatives(num_derivatives_in),
+      num_fixed(num_fixed_in),
+      num_cached(0),
+      gaussian_process_generation(0),
+      points_to_sample(dim*num_to_sample),
+      K_star(num_to_sample*num_sampled),
+      grad_K_star(num_derivatives*num_sampled*dim),
+      V(num_to_sample*num_sampled),
+      K_inv_times_K_star(num_to_sample*num_sampled),
+      grad_cov(dim) {
+  SetupState(gaussian_process, points_to_sample_in, num_to_sample_in, num_derivatives_in);
+}
+
+PointsToSampleState::PointsToSampleState(PointsToSampleState&& OL_UNUSED(other)) = default;
+
+template <typename GaussianProcessType>
+BasicExpectedImprovementEvaluator<GaussianProcessType>::BasicExpectedImprovementEvaluator(
+    const GaussianProcessType& gaussian_process_in, int num_mc_iterations, double best_so_far,
+    MonteCarloIntegrationTypes integration_type, WorkStealingTaskPool * task_pool)
+    : dim_(gaussian_process_in.dim()),
+      num_mc_iterations_(num_mc_iterations),
+      integration_type_(integration_type),
+      best_so_far_(best_so_far),
+      gaussian_process_(&gaussian_process_in),
+      task_pool_(task_pool) {
+}
+
+template <typename GaussianProcessType>
+BasicExpectedImprovementEvaluator<GaussianProcessType>::BasicExpectedImprovementEvaluator(
+    const GaussianProcessType& gaussian_process_in, int num_mc_iterations, double best_so_far,
+    MonteCarloIntegrationTypes integration_type)
+    : BasicExpectedImprovementEvaluator(gaussian_process_in, num_mc_iterations, best_so_far, integration_type, nullptr) {
+}
 
-    double improvement_this_step = 0.0;
-    int winner = num_union + 1;  // an out of-bounds initial value
+template <typename GaussianProcessType>
+BasicExpectedImprovementEvaluator<GaussianProcessType>::BasicExpectedImprovementEvaluator(
+    const GaussianProcessType& gaussian_process_in, int num_mc_iterations, double best_so_far)
+    : BasicExpectedImprovementEvaluator(gaussian_process_in, num_mc_iterations, best_so_far,
+                                        MonteCarloIntegrationTypes::kPseudoRandom) {
+}
+
+template <typename GaussianProcessType>
+void BasicExpectedImprovementEvaluator<GaussianProcessType>::ComputeMeanAndCholeskyVariance(
+    StateType * ei_state) const {
+  gaussian_process_->ComputeMeanOfPoints(ei_state->points_to_sample_state, ei_state->to_sample_mean.data());
+  gaussian_process_->ComputeVarianceOfPoints(&(ei_state->points_to_sample_state), ei_state->cholesky_to_sample_var.data());
+  int leading_minor_index = ComputeCholeskyFactorL(ei_state->num_union, ei_state->cholesky_to_sample_var.data());
+  if (unlikely(leading_minor_index != 0)) {
+    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample/being_sampled or points_to_sample/being_sampled duplicating points_sampled with 0 noise.", ei_state->cholesky_to_sample_var.data(), ei_state->num_union, leading_minor_index);
+  }
+}
+
+/*!\rst
+  The MC iterations are processed in batches of kEIMonteCarloBatchSize: draw all the normals for the batch, form
+  ``Ls * w`` for every draw at once, then take the max/sum across the batch.  Draws and arithmetic happen in the same
+  order as one-iteration-at-a-time evaluation, so the result does not depend on the batch size.
+
+  The batch temporaries come from this thread's ScratchArena, so chunks of one evaluation can run on different threads
+  against the same (read-only) state.
+\endrst*/
+template <typename GaussianProcessType>
+double BasicExpectedImprovementEvaluator<GaussianProcessType>::AccumulateImprovement(
+    const StateType& ei_state, int num_iterations, NormalRNGInterface * normal_rng) const {
+  const int num_union = ei_state.num_union;
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict normals = scratch.Allocate<double>(num_union*kEIMonteCarloBatchSize);
+  double * restrict EI_this_step_from_var = scratch.Allocate<double>(num_union*kEIMonteCarloBatchSize);
+  double * restrict improvement_this_step = scratch.Allocate<double>(kEIMonteCarloBatchSize);
+  double aggregate = 0.0;
+  for (int i = 0; i < num_iterations; i += kEIMonteCarloBatchSize) {
+    const int num_draws = std::min(kEIMonteCarloBatchSize, num_iterations - i);
+    DrawNormalVectors(num_union, num_draws, kEIMonteCarloBatchSize, normal_rng, normals);
+
+    // compute EI_this_step_from_var = cholesky * normals for every draw in the batch
+    TriangularMatrixMultiplyVectors(ei_state.cholesky_to_sample_var.data(), normals, num_union,
+                                    num_draws, kEIMonteCarloBatchSize, EI_this_step_from_var);
+
+    std::fill(improvement_this_step, improvement_this_step + num_draws, 0.0);
     for (int j = 0; j < num_union; ++j) {
-      double EI_total = best_so_far_ - (ei_state->to_sample_mean[j] + ei_state->EI_this_step_from_var[j]);
-      if (EI_total > improvement_this_step) {
-        improvement_this_step = EI_total;
-        winner = j;
+      const double mean = ei_state.to_sample_mean[j];
+      double const * restrict EI_this_step_from_var_j = EI_this_step_from_var + j*kEIMonteCarloBatchSize;
+      for (int b = 0; b < num_draws; ++b) {
+        double EI_total = best_so_far_ - (mean + EI_this_step_from_var_j[b]);
+        improvement_this_step[b] = std::max(improvement_this_step[b], EI_total);
       }
     }
 
-    if (improvement_this_step > 0.0) {
-      // improvement > 0.0 implies winner will be valid; i.e., in 0:ei_state->num_to_sample
-      aggregate_EI += improvement_this_step;
+    // improvement_this_step >= 0.0, so iterations without improvement add nothing
+    for (int b = 0; b < num_draws; ++b) {
+      aggregate += improvement_this_step[b];
+    }
+  }
+  return aggregate;
+}
+
+/*!\rst
+  Let ``Ls * Ls^T = Vars`` and ``w`` = vector of IID normal(0,1) variables
+  Then:
+
+  ``y = mus + Ls * w``  (Equation 4, from file docs)
+
+  simulates drawing from our GP with mean mus and variance Vars.
+
+  Then as given in the file docs, we compute the improvement:
+  Then the improvement for this single sample is::
+
+    I = { best_known - min(y)   if (best_known - min(y) > 0)      (Equation 5 from file docs)
+        {          0               else
+
+  This is implemented as ``max_{y} (best_known - y)``.  Notice that improvement takes the value 0 if it would be negative.
+
+  Since we cannot compute ``min(y)`` directly, we do so via monte-carlo (MC) integration.  That is, we draw from the GP
+  repeatedly, computing improvement during each iteration, and averaging the result.
+
+  See Scott's PhD thesis, sec 6.2.
+
+  For quasi-random integration, the ``w`` come from kNumMonteCarloErrorGroups Sobol sequences, each with its own
+  random digital shift (drawn from ``normal_rng``).  Each shifted point is uniform on the cube, so the average stays
+  unbiased, but the points fill the space far more evenly than IID draws; for this smooth-ish integrand, the error
+  decays nearly like ``1/n`` instead of ``1/\sqrt{n}``.
+
+  .. Note:: comments here are copied to _compute_expected_improvement_monte_carlo() in python_version/expected_improvement.py
+\endrst*/
+template <typename GaussianProcessType>
+double BasicExpectedImprovementEvaluator<GaussianProcessType>::ComputeExpectedImprovement(
+    StateType * ei_state) const {
+  ComputeMeanAndCholeskyVariance(ei_state);
+
+  ei_state->SetMonteCarloIteration(0);
+  if (integration_type_ == MonteCarloIntegrationTypes::kPseudoRandom) {
+    return AccumulateImprovementInChunks(ei_state)/static_cast<double>(num_mc_iterations_);
+  }
+
+  double aggregate = 0.0;
+  const int num_groups = std::min(kNumMonteCarloErrorGroups, num_mc_iterations_);
+  for (int group = 0; group < num_groups; ++group) {
+    const int num_iterations = num_mc_iterations_/num_groups + (group < num_mc_iterations_ % num_groups);
+    ei_state->qmc_normal_rng->Randomize(ei_state->normal_rng);
+    aggregate += AccumulateImprovement(*ei_state, num_iterations, ei_state->qmc_normal_rng.get());
+  }
+  return aggregate/static_cast<double>(num_mc_iterations_);
+}
+
+/*!\rst
+  Chunk ``c`` covers MC iterations ``[c*kEIMonteCarloChunkSize, (c+1)*kEIMonteCarloChunkSize)`` and the chunk sums are
+  added in order.  With a task pool and a counter-based generator, the chunks run as nested tasks, each on its own copy
+  of the generator positioned at the chunk's first iteration; otherwise they run in order on ``normal_rng``.  Both read
+  the same draws and add in the same order, so the result is bitwise the same.
+\endrst*/
+template <typename GaussianProcessType>
+double BasicExpectedImprovementEvaluator<GaussianProcessType>::AccumulateImprovementInChunks(
+    StateType * ei_state) const {
+  const int num_chunks = (num_mc_iterations_ + kEIMonteCarloChunkSize - 1)/kEIMonteCarloChunkSize;
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict chunk_aggregate = scratch.Allocate<double>(num_chunks);
+  if (task_pool_ != nullptr && ei_state->stream_normal_rng != nullptr && num_chunks > 1) {
+    const StateType& chunk_state = *ei_state;
+    task_pool_->NestedParallelFor(ei_state->worker_id, num_chunks, [&](int chunk, int OL_UNUSED(worker_id)) {
+        const int first_iteration = chunk*kEIMonteCarloChunkSize;
+        PhiloxNormalRNG chunk_normal_rng(chunk_state.stream_normal_rng->last_seed(),
+                                         chunk_state.stream_normal_rng->stream());
+        chunk_normal_rng.SetDrawIndex(static_cast<std::uint64_t>(first_iteration)*chunk_state.num_union);
+        chunk_aggregate[chunk] = AccumulateImprovement(
+            chunk_state, std::min(kEIMonteCarloChunkSize, num_mc_iterations_ - first_iteration), &chunk_normal_rng);
+      });
+  } else {
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+      const int first_iteration = chunk*kEIMonteCarloChunkSize;
+      chunk_aggregate[chunk] = AccumulateImprovement(
+          *ei_state, std::min(kEIMonteCarloChunkSize, num_mc_iterations_ - first_iteration), ei_state->normal_rng);
+    }
+  }
+
+  double aggregate = 0.0;
+  for (int chunk = 0; chunk < num_chunks; ++chunk) {
+    aggregate += chunk_aggregate[chunk];
+  }
+  return aggregate;
+}
+
+/*!\rst
+  Group ``g`` gets ``n/G`` iterations, plus one more for the first ``n mod G`` groups.  Group means are unbiased,
+  independent estimates of EI; the weighted average over groups is the EI estimate and the spread of the group means
+  gives its standard error.
+\endrst*/
+template <typename GaussianProcessType>
+double BasicExpectedImprovementEvaluator<GaussianProcessType>::ComputeExpectedImprovementWithErrorEstimate(
+    StateType * ei_state, double * restrict standard_error) const {
+  ComputeMeanAndCholeskyVariance(ei_state);
 
-      // recall that grad_mu only stores \frac{d mu_i}{d Xs_i}, since \frac{d mu_j}{d Xs_i} = 0 for i != j.
-      // hence the only relevant term from grad_mu is the one describing the gradient wrt winner-th point,
-      // and this term only arises if the winner (for most improvement) index is less than num_to_sample
-      if (winner < ei_state->num_to_sample) {
-        for (int k = 0; k < dim_; ++k) {
-          ei_state->aggregate[winner*dim_ + k] -= ei_state->grad_mu[winner*dim_ + k];
+  const int num_groups = std::min(kNumMonteCarloErrorGroups, num_mc_iterations_);
+  double group_means[kNumMonteCarloErrorGroups];
+  double aggregate = 0.0;
+  ei_state->SetMonteCarloIteration(0);
+  for (int group = 0; group < num_groups; ++group) {
+    const int num_iterations = num_mc_iterations_/num_groups + (group < num_mc_iterations_ % num_groups);
+    NormalRNGInterface * normal_rng = ei_state->normal_rng;
+    if (integration_type_ == MonteCarloIntegrationTypes::kQuasiRandom) {
+      ei_state->qmc_normal_rng->Randomize(ei_state->normal_rng);
+      normal_rng = ei_state->qmc_normal_rng.get();
+    }
+    double group_aggregate = AccumulateImprovement(*ei_state, num_iterations, normal_rng);
+    aggregate += group_aggregate;
+    group_means[group] = group_aggregate/static_cast<double>(num_iterations);
+  }
+
+  if (num_groups < 2) {
+    *standard_error = std::numeric_limits<double>::infinity();
+  } else {
+    double mean_of_means = 0.0;
+    for (int group = 0; group < num_groups; ++group) {
+      mean_of_means += group_means[group];
+    }
+    mean_of_means /= static_cast<double>(num_groups);
+    double sum_of_squares = 0.0;
+    for (int group = 0; group < num_groups; ++group) {
+      sum_of_squares += Square(group_means[group] - mean_of_means);
+    }
+    *standard_error = std::sqrt(sum_of_squares/static_cast<double>(num_groups*(num_groups - 1)));
+  }
+  return aggregate/static_cast<double>(num_mc_iterations_);
+}
+
+/*!\rst
+  As in AccumulateImprovement(), iterations are processed in batches of kEIMonteCarloBatchSize (with temporaries from
+  this thread's ScratchArena).  Only the iterations with positive improvement touch the gradient tensors, one at a time.
+\endrst*/
+template <typename GaussianProcessType>
+void BasicExpectedImprovementEvaluator<GaussianProcessType>::AccumulateGradImprovement(
+    const StateType& ei_state, int num_iterations, NormalRNGInterface * normal_rng, double * restrict aggregate) const {
+  const int num_union = ei_state.num_union;
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict normals = scratch.Allocate<double>(num_union*kEIMonteCarloBatchSize);
+  double * restrict EI_this_step_from_var = scratch.Allocate<double>(num_union*kEIMonteCarloBatchSize);
+  double * restrict normals_this_step = scratch.Allocate<double>(num_union);
+  double * restrict improvement_this_step = scratch.Allocate<double>(kEIMonteCarloBatchSize);
+  int * restrict winner = scratch.Allocate<int>(kEIMonteCarloBatchSize);
+  for (int i = 0; i < num_iterations; i += kEIMonteCarloBatchSize) {
+    const int num_draws = std::min(kEIMonteCarloBatchSize, num_iterations - i);
+    // orig value of normals needed if improvement_this_step > 0.0
+    DrawNormalVectors(num_union, num_draws, kEIMonteCarloBatchSize, normal_rng, normals);
+
+    // compute EI_this_step_from_var = cholesky * normals for every draw in the batch
+    TriangularMatrixMultiplyVectors(ei_state.cholesky_to_sample_var.data(), normals, num_union,
+                                    num_draws, kEIMonteCarloBatchSize, EI_this_step_from_var);
+
+    std::fill(improvement_this_step, improvement_this_step + num_draws, 0.0);
+    std::fill(winner, winner + num_draws, num_union + 1);  // an out of-bounds initial value
+    for (int j = 0; j < num_union; ++j) {
+      const double mean = ei_state.to_sample_mean[j];
+      double const * restrict EI_this_step_from_var_j = EI_this_step_from_var + j*kEIMonteCarloBatchSize;
+      for (int b = 0; b < num_draws; ++b) {
+        double EI_total = best_so_far_ - (mean + EI_this_step_from_var_j[b]);
+        if (EI_total > improvement_this_step[b]) {
+          improvement_this_step[b] = EI_total;
+          winner[b] = j;
         }
       }
+    }
 
-      // let L_{d,i,j,k} = grad_chol_decomp, d over dim_, i, j over num_union, k over num_to_sample
-      // we want to compute: agg_dx_{d,k} = L_{d,i,j=winner,k} * normals_i
-      // TODO(GH-92): Form this as one GeneralMatrixVectorMultiply() call by storing data as L_{d,i,k,j} if it's faster.
-      double const * restrict grad_chol_decomp_winner_block = ei_state->grad_chol_decomp.data() + winner*dim_*(num_union);
-      for (int k = 0; k < ei_state->num_to_sample; ++k) {
-        GeneralMatrixVectorMultiply(grad_chol_decomp_winner_block, 'N', ei_state->normals.data(), -1.0, 1.0,
-                                    dim_, num_union, dim_, ei_state->aggregate.data() + k*dim_);
-        grad_chol_decomp_winner_block += dim_*Square(num_union);
-      }
-    }  // end if: improvement_this_step > 0.0
-  }  // end for i: num_mc_iterations_
+    for (int b = 0; b < num_draws; ++b) {
+      if (improvement_this_step[b] > 0.0) {
+        // improvement > 0.0 implies winner will be valid; i.e., in 0:ei_state.num_to_sample
+
+        // recall that grad_mu only stores \frac{d mu_i}{d Xs_i}, since \frac{d mu_j}{d Xs_i} = 0 for i != j.
+        // hence the only relevant term from grad_mu is the one describing the gradient wrt winner-th point,
+        // and this term only arises if the winner (for most improvement) index is less than num_to_sample
+        if (winner[b] < ei_state.num_to_sample) {
+          for (int k = 0; k < dim_; ++k) {
+            aggregate[winner[b]*dim_ + k] -= ei_state.grad_mu[winner[b]*dim_ + k];
+          }
+        }
+
+        for (int j = 0; j < num_union; ++j) {
+          normals_this_step[j] = normals[j*kEIMonteCarloBatchSize + b];
+        }
+
+        // let L_{d,i,j,k} = grad_chol_decomp, d over dim_, i, j over num_union, k over num_to_sample
+        // we want to compute: agg_dx_{d,k} = L_{d,i,j=winner,k} * normals_i
+        // TODO(GH-92): Form this as one GeneralMatrixVectorMultiply() call by storing data as L_{d,i,k,j} if it's faster.
+        double const * restrict grad_chol_decomp_winner_block = ei_state.grad_chol_decomp.data() + winner[b]*dim_*(num_union);
+        for (int k = 0; k < ei_state.num_to_sample; ++k) {
+          GeneralMatrixVectorMultiply(grad_chol_decomp_winner_block, 'N', normals_this_step, -1.0, 1.0,
+                                      dim_, num_union, dim_, aggregate + k*dim_);
+          grad_chol_decomp_winner_block += dim_*Square(num_union);
+        }
+      }  // end if: improvement_this_step > 0.0
+    }  // end for b: num_draws
+  }  // end for i: num_iterations
+}
+
+/*!\rst
+  Same chunking as AccumulateImprovementInChunks(); each chunk adds into its own gradient aggregate, and the chunk
+  aggregates are added (in order) to ``ei_state->aggregate``.
+\endrst*/
+template <typename GaussianProcessType>
+void BasicExpectedImprovementEvaluator<GaussianProcessType>::AccumulateGradImprovementInChunks(
+    StateType * ei_state) const {
+  const int num_chunks = (num_mc_iterations_ + kEIMonteCarloChunkSize - 1)/kEIMonteCarloChunkSize;
+  const int aggregate_size = ei_state->num_to_sample*dim_;
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict chunk_aggregate = scratch.Allocate<double>(num_chunks*aggregate_size);
+  std::fill(chunk_aggregate, chunk_aggregate + num_chunks*aggregate_size, 0.0);
+  if (task_pool_ != nullptr && ei_state->stream_normal_rng != nullptr && num_chunks > 1) {
+    const StateType& chunk_state = *ei_state;
+    task_pool_->NestedParallelFor(ei_state->worker_id, num_chunks, [&](int chunk, int OL_UNUSED(worker_id)) {
+        const int first_iteration = chunk*kEIMonteCarloChunkSize;
+        PhiloxNormalRNG chunk_normal_rng(chunk_state.stream_normal_rng->last_seed(),
+                                         chunk_state.stream_normal_rng->stream());
+        chunk_normal_rng.SetDrawIndex(static_cast<std::uint64_t>(first_iteration)*chunk_state.num_union);
+        AccumulateGradImprovement(chunk_state, std::min(kEIMonteCarloChunkSize, num_mc_iterations_ - first_iteration),
+                                  &chunk_normal_rng, chunk_aggregate + chunk*aggregate_size);
+      });
+  } else {
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+      const int first_iteration = chunk*kEIMonteCarloChunkSize;
+      AccumulateGradImprovement(*ei_state, std::min(kEIMonteCarloChunkSize, num_mc_iterations_ - first_iteration),
+                                ei_state->normal_rng, chunk_aggregate + chunk*aggregate_size);
+    }
+  }
+
+  for (int chunk = 0; chunk < num_chunks; ++chunk) {
+    for (int k = 0; k < aggregate_size; ++k) {
+      ei_state->aggregate[k] += chunk_aggregate[chunk*aggregate_size + k];
+    }
+  }
+}
+
+/*!\rst
+  Computes gradient of EI (see ExpectedImprovementEvaluator::ComputeGradExpectedImprovement) wrt points_to_sample (stored in
+  ``union_of_points[0:num_to_sample]``).
+
+  Mechanism is similar to the computation of EI, where points' contributions to the gradient are thrown out of their
+  corresponding ``improvement <= 0.0``.
+
+  Thus ``\nabla(\mu)`` only contributes when the ``winner`` (point w/best improvement this iteration) is the current point.
+  That is, the gradient of ``\mu`` at ``x_i`` wrt ``x_j`` is 0 unless ``i == j`` (and only this result is stored in
+  ``ei_state->grad_mu``).  The interaction with ``ei_state->grad_chol_decomp`` is harder to know a priori (like with
+  ``grad_mu``) and has a more complex structure (rank 3 tensor), so the derivative wrt ``x_j`` is computed fully, and
+  the relevant submatrix (indexed by the current ``winner``) is accessed each iteration.
+
+  Quasi-random integration draws the ``w`` exactly as in ComputeExpectedImprovement().
+
+  .. Note:: comments here are copied to _compute_grad_expected_improvement_monte_carlo() in python_version/expected_improvement.py
+\endrst*/
+template <typename GaussianProcessType>
+void BasicExpectedImprovementEvaluator<GaussianProcessType>::ComputeGradExpectedImprovement(
+    StateType * ei_state, double * restrict grad_EI) const {
+  ComputeMeanAndCholeskyVariance(ei_state);
+  gaussian_process_->ComputeGradMeanOfPoints(ei_state->points_to_sample_state, ei_state->grad_mu.data());
+  gaussian_process_->ComputeGradCholeskyVarianceOfPoints(&(ei_state->points_to_sample_state),
+                                                         ei_state->cholesky_to_sample_var.data(),
+                                                         ei_state->grad_chol_decomp.data());
+
+  std::fill(ei_state->aggregate.begin(), ei_state->aggregate.end(), 0.0);
+  ei_state->SetMonteCarloIteration(0);
+  if (integration_type_ == MonteCarloIntegrationTypes::kPseudoRandom) {
+    AccumulateGradImprovementInChunks(ei_state);
+  } else {
+    const int num_groups = std::min(kNumMonteCarloErrorGroups, num_mc_iterations_);
+    for (int group = 0; group < num_groups; ++group) {
+      const int num_iterations = num_mc_iterations_/num_groups + (group < num_mc_iterations_ % num_groups);
+      ei_state->qmc_normal_rng->Randomize(ei_state->normal_rng);
+      AccumulateGradImprovement(*ei_state, num_iterations, ei_state->qmc_normal_rng.get(), ei_state->aggregate.data());
+    }
+  }
 
   for (int k = 0; k < ei_state->num_to_sample*dim_; ++k) {
     grad_EI[k] = ei_state->aggregate[k]/static_cast<double>(num_mc_iterations_);
   }
 }
 
-void ExpectedImprovementState::SetCurrentPoint(const EvaluatorType& ei_evaluator,
-                          double const * restrict points_to_sample) {
+template <typename GaussianProcessType>
+void BasicExpectedImprovementState<GaussianProcessType>::SetCurrentPoint(const EvaluatorType& ei_evaluator,
+                                                                         double const * restrict points_to_sample) {
   // update points_to_sample in union_of_points
   std::copy(points_to_sample, points_to_sample + num_to_sample*dim, union_of_points.data());
 
-  // evaluate derived quantities for the GP
-  points_to_sample_state.SetupState(*ei_evaluator.gaussian_process(), union_of_points.data(),
-                                    num_union, num_derivatives);
+  // evaluate derived quantities for the GP; points_being_sampled have not moved
+  points_to_sample_state.UpdateMovingPoints(*ei_evaluator.gaussian_process(), union_of_points.data());
 }
 
-ExpectedImprovementState::ExpectedImprovementState(const EvaluatorType& ei_evaluator,
-                                                   double const * restrict points_to_sample,
-                                                   double const * restrict points_being_sampled,
-                                                   int num_to_sample_in, int num_being_sampled_in,
-                                                   bool configure_for_gradients, NormalRNGInterface * normal_rng_in)
+template <typename GaussianProcessType>
+BasicExpectedImprovementState<GaussianProcessType>::BasicExpectedImprovementState(
+    const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
+    double const * restrict points_being_sampled, int num_to_sample_in, int num_being_sampled_in,
+    bool configure_for_gradients, NormalRNGInterface * normal_rng_in)
     : dim(ei_evaluator.dim()),
       num_to_sample(num_to_sample_in),
       num_being_sampled(num_being_sampled_in),
       num_derivatives(configure_for_gradients ? num_to_sample : 0),
       num_union(num_to_sample + num_being_sampled),
       union_of_points(BuildUnionOfPoints(points_to_sample, points_being_sampled, num_to_sample, num_being_sampled, dim)),
-      points_to_sample_state(*ei_evaluator.gaussian_process(), union_of_points.data(), num_union, num_derivatives),
+      points_to_sample_state(*ei_evaluator.gaussian_process(), union_of_points.data(), num_union, num_derivatives,
+                             num_being_sampled),
       normal_rng(normal_rng_in),
+      stream_normal_rng(nullptr),
+      qmc_normal_rng(ei_evaluator.integration_type() == MonteCarloIntegrationTypes::kQuasiRandom ?
+                     new SobolNormalRNG(num_union) : nullptr),
       to_sample_mean(num_union),
       grad_mu(dim*num_derivatives),
       cholesky_to_sample_var(Square(num_union)),
       grad_chol_decomp(dim*Square(num_union)*num_derivatives),
-      EI_this_step_from_var(num_union),
       aggregate(dim*num_derivatives),
-      normals(num_union) {
+      worker_id(0) {
+}
+
+template <typename GaussianProcessType>
+BasicExpectedImprovementState<GaussianProcessType>::BasicExpectedImprovementState(
+    const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
+    double const * restrict points_being_sampled, int num_to_sample_in, int num_being_sampled_in,
+    bool configure_for_gradients, PhiloxNormalRNG * normal_rng_in)
+    : BasicExpectedImprovementState(ei_evaluator, points_to_sample, points_being_sampled, num_to_sample_in,
+                                    num_being_sampled_in, configure_for_gradients,
+                                    static_cast<NormalRNGInterface *>(normal_rng_in)) {
+  stream_normal_rng = normal_rng_in;
 }
 
-ExpectedImprovementState::ExpectedImprovementState(ExpectedImprovementState&& OL_UNUSED(other)) = default;
+template <typename GaussianProcessType>
+BasicExpectedImprovementState<GaussianProcessType>::BasicExpectedImprovementState(
+    BasicExpectedImprovementState&& OL_UNUSED(other)) = default;
 
-void ExpectedImprovementState::SetupState(const EvaluatorType& ei_evaluator,
-                                          double const * restrict points_to_sample) {
+template <typename GaussianProcessType>
+void BasicExpectedImprovementState<GaussianProcessType>::SetupState(const EvaluatorType& ei_evaluator,
+                                                                    double const * restrict points_to_sample) {
   if (unlikely(dim != ei_evaluator.dim())) {
     OL_THROW_EXCEPTION(InvalidValueException<int>, "Evaluator's and State's dim do not match!", dim, ei_evaluator.dim());
   }
 
-  // update quantities derived from points_to_sample
-  SetCurrentPoint(ei_evaluator, points_to_sample);
+  if (ei_evaluator.integration_type() == MonteCarloIntegrationTypes::kQuasiRandom && qmc_normal_rng == nullptr) {
+    qmc_normal_rng.reset(new SobolNormalRNG(num_union));
+  }
+
+  // update points_to_sample in union_of_points
+  std::copy(points_to_sample, points_to_sample + num_to_sample*dim, union_of_points.data());
+
+  // recompute all quantities derived from union_of_points (the GP may have changed)
+  points_to_sample_state.SetupState(*ei_evaluator.gaussian_process(), union_of_points.data(),
+                                    num_union, num_derivatives);
 }
 
-OnePotentialSampleExpectedImprovementEvaluator::OnePotentialSampleExpectedImprovementEvaluator(
-    const GaussianProcess& gaussian_process_in,
-    double best_so_far)
+// template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
+template class BasicExpectedImprovementEvaluator<GaussianProcess>;
+template class BasicExpectedImprovementEvaluator<SparseGaussianProcess>;
+template struct BasicExpectedImprovementState<GaussianProcess>;
+template struct BasicExpectedImprovementState<SparseGaussianProcess>;
+
+template <typename GaussianProcessType>
+BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::BasicOnePotentialSampleExpectedImprovementEvaluator(
+    const GaussianProcessType& gaussian_process_in, double best_so_far)
     : dim_(gaussian_process_in.dim()),
       best_so_far_(best_so_far),
       normal_(0.0, 1.0),
@@ -1192,7 +2051,9 @@ OnePotentialSampleExpectedImprovementEvaluator::OnePotentialSampleExpectedImprov
 
   See Ginsbourger, Le Riche, and Carraro.
 \endrst*/
-double OnePotentialSampleExpectedImprovementEvaluator::ComputeExpectedImprovement(StateType * ei_state) const {
+template <typename GaussianProcessType>
+double BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::ComputeExpectedImprovement(
+    StateType * ei_state) const {
   double to_sample_mean;
   double to_sample_var;
 
@@ -1214,7 +2075,8 @@ double OnePotentialSampleExpectedImprovementEvaluator::ComputeExpectedImprovemen
 
   See Ginsbourger, Le Riche, and Carraro.
 \endrst*/
-void OnePotentialSampleExpectedImprovementEvaluator::ComputeGradExpectedImprovement(
+template <typename GaussianProcessType>
+void BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::ComputeGradExpectedImprovement(
     StateType * ei_state,
     double * restrict exp_grad_EI) const {
   double to_sample_mean;
@@ -1245,8 +2107,9 @@ void OnePotentialSampleExpectedImprovementEvaluator::ComputeGradExpectedImprovem
   }
 }
 
-void OnePotentialSampleExpectedImprovementState::SetCurrentPoint(const EvaluatorType& ei_evaluator,
-                                                                    double const * restrict point_to_sample_in) {
+template <typename GaussianProcessType>
+void BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType>::SetCurrentPoint(
+    const EvaluatorType& ei_evaluator, double const * restrict point_to_sample_in) {
   // update current point in union_of_points
   std::copy(point_to_sample_in, point_to_sample_in + dim, point_to_sample.data());
 
@@ -1255,7 +2118,8 @@ void OnePotentialSampleExpectedImprovementState::SetCurrentPoint(const Evaluator
                                     num_to_sample, num_derivatives);
 }
 
-OnePotentialSampleExpectedImprovementState::OnePotentialSampleExpectedImprovementState(
+template <typename GaussianProcessType>
+BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType>::BasicOnePotentialSampleExpectedImprovementState(
     const EvaluatorType& ei_evaluator,
     double const * restrict point_to_sample_in,
     bool configure_for_gradients)
@@ -1267,7 +2131,8 @@ OnePotentialSampleExpectedImprovementState::OnePotentialSampleExpectedImprovemen
       grad_chol_decomp(dim*num_derivatives) {
 }
 
-OnePotentialSampleExpectedImprovementState::OnePotentialSampleExpectedImprovementState(
+template <typename GaussianProcessType>
+BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType>::BasicOnePotentialSampleExpectedImprovementState(
     const EvaluatorType& ei_evaluator,
     double const * restrict points_to_sample,
     double const * restrict OL_UNUSED(points_being_sampled),
@@ -1275,14 +2140,16 @@ OnePotentialSampleExpectedImprovementState::OnePotentialSampleExpectedImprovemen
     int OL_UNUSED(num_being_sampled_in),
     bool configure_for_gradients,
     NormalRNGInterface * OL_UNUSED(normal_rng_in))
-    : OnePotentialSampleExpectedImprovementState(ei_evaluator, points_to_sample, configure_for_gradients) {
+    : BasicOnePotentialSampleExpectedImprovementState(ei_evaluator, points_to_sample, configure_for_gradients) {
 }
 
-OnePotentialSampleExpectedImprovementState::OnePotentialSampleExpectedImprovementState(
-    OnePotentialSampleExpectedImprovementState&& OL_UNUSED(other)) = default;
+template <typename GaussianProcessType>
+BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType>::BasicOnePotentialSampleExpectedImprovementState(
+    BasicOnePotentialSampleExpectedImprovementState&& OL_UNUSED(other)) = default;
 
-void OnePotentialSampleExpectedImprovementState::SetupState(const EvaluatorType& ei_evaluator,
-                                                            double const * restrict point_to_sample_in) {
+template <typename GaussianProcessType>
+void BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType>::SetupState(
+    const EvaluatorType& ei_evaluator, double const * restrict point_to_sample_in) {
   if (unlikely(dim != ei_evaluator.dim())) {
     OL_THROW_EXCEPTION(InvalidValueException<int>, "Evaluator's and State's dim do not match!", dim, ei_evaluator.dim());
   }
@@ -1290,45 +2157,641 @@ void OnePotentialSampleExpectedImprovementState::SetupState(const EvaluatorType&
   SetCurrentPoint(ei_evaluator, point_to_sample_in);
 }
 
+// template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
+template class BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcess>;
+template class BasicOnePotentialSampleExpectedImprovementEvaluator<SparseGaussianProcess>;
+template struct BasicOnePotentialSampleExpectedImprovementState<GaussianProcess>;
+template struct BasicOnePotentialSampleExpectedImprovementState<SparseGaussianProcess>;
+
+namespace {  // utilities for multivariate normal CDFs
+
+//! Abscissae of the 20-point Gauss-Legendre rule on ``[-1, 1]``; the rule is symmetric so only ``x > 0`` is stored
+constexpr double kGaussLegendreAbscissae[10] = {
+  0.07652652113349733, 0.2277858511416451, 0.3737060887154196, 0.5108670019508271, 0.6360536807265150,
+  0.7463319064601508, 0.8391169718222188, 0.9122344282513259, 0.9639719272779138, 0.9931285991850949};
+//! Weights of the 20-point Gauss-Legendre rule, matching kGaussLegendreAbscissae
+constexpr double kGaussLegendreWeights[10] = {
+  0.1527533871307259, 0.1491729864726037, 0.1420961093183821, 0.1316886384491766, 0.1181945319615184,
+  0.1019301198172404, 0.08327674157670475, 0.06267204833410906, 0.04060142980038694, 0.01761400713915212};
+
+//! Integrand terms with ``exp(x)`` for ``x`` below this are negligible (``e^{-100} \approx 4e-44``)
+constexpr double kMinimumExponent = -100.0;
+
+//! Correlations (in magnitude) up to this are integrated by one 20-point Gauss-Legendre rule in CorrelationNormalCDF();
+//! beyond it, the integrand steepens near ``|\sin\theta| = 1`` and AdaptiveGaussLegendre() is used instead
+constexpr double kMaxFixedQuadratureCorrelation = 0.925;
+//! Error tolerance of AdaptiveGaussLegendre() in CorrelationNormalCDF(), per unit length of ``\theta``; the errors sum
+//! to at most ``\pi/2`` times this over all accepted intervals
+constexpr double kAdaptiveQuadratureTolerance = 1.0e-13;
+//! Absolute error accepted on any one interval regardless of its length: the integrand (at most 1) is only accurate
+//! to a few ulps, so below this bisection stops converging and runs to kMaxAdaptiveQuadratureDepth
+constexpr double kAdaptiveQuadratureRoundoff = 1.0e-14;
+//! Maximum interval bisection depth of AdaptiveGaussLegendre()
+constexpr int kMaxAdaptiveQuadratureDepth = 16;
+
+/*!\rst
+  Applies the 20-point Gauss-Legendre rule to ``\int_{lower}^{upper} integrand(x) dx``.
+\endrst*/
+template <typename Integrand>
+OL_WARN_UNUSED_RESULT double GaussLegendre(const Integrand& integrand, double lower, double upper) {
+  const double half_width = 0.5*(upper - lower);
+  const double midpoint = 0.5*(upper + lower);
+  double sum = 0.0;
+  for (int i = 0; i < 10; ++i) {
+    sum += kGaussLegendreWeights[i]*(integrand(midpoint - half_width*kGaussLegendreAbscissae[i]) +
+                                     integrand(midpoint + half_width*kGaussLegendreAbscissae[i]));
+  }
+  return sum*half_width;
+}
+
+/*!\rst
+  Computes ``\int_{lower}^{upper} integrand(x) dx`` by recursive bisection: ``whole`` (the 20-point Gauss-Legendre
+  estimate over the interval) is accepted once the estimates over its two halves agree with it to
+  ``tolerance*(upper - lower) + roundoff``; otherwise each half is refined separately, up to ``depth`` more levels.
+\endrst*/
+template <typename Integrand>
+OL_WARN_UNUSED_RESULT double AdaptiveGaussLegendre(const Integrand& integrand, double lower, double upper,
+                                                   double whole, double tolerance, double roundoff, int depth) {
+  const double midpoint = 0.5*(lower + upper);
+  const double left = GaussLegendre(integrand, lower, midpoint);
+  const double right = GaussLegendre(integrand, midpoint, upper);
+  if (depth <= 0 || std::fabs(left + right - whole) <= tolerance*std::fabs(upper - lower) + roundoff) {
+    return left + right;
+  }
+  return AdaptiveGaussLegendre(integrand, lower, midpoint, left, tolerance, roundoff, depth - 1) +
+      AdaptiveGaussLegendre(integrand, midpoint, upper, right, tolerance, roundoff, depth - 1);
+}
+
+OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT double StandardNormalCDF(double x) noexcept {
+  static constexpr double kSqrtHalf = 0.70710678118654752440;
+  return 0.5*std::erfc(-x*kSqrtHalf);
+}
+
+/*!\rst
+  Computes ``P(X_0 > h, X_1 > k)`` for standard normals with correlation ``r``; a port of Genz's ``bvnu``.
+
+  For ``|r| < 0.925``, integrates the bivariate density over ``\arcsin r`` (Drezner & Wesolowsky).  Otherwise,
+  integrates the difference from the perfectly (anti-)correlated case, subtracting off the leading terms of its
+  asymptotic expansion so that the remaining integrand is smooth.
+\endrst*/
+OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT double BivariateNormalUpperTail(double h, double k, double r) noexcept {
+  static constexpr double kInfinity = std::numeric_limits<double>::infinity();
+  if (h == kInfinity || k == kInfinity) {
+    return 0.0;
+  } else if (h == -kInfinity) {
+    return k == -kInfinity ? 1.0 : StandardNormalCDF(-k);
+  } else if (k == -kInfinity) {
+    return StandardNormalCDF(-h);
+  } else if (r == 0.0) {
+    return StandardNormalCDF(-h)*StandardNormalCDF(-k);
+  }
+
+  double hk = h*k;
+  double bvn = 0.0;
+  if (std::fabs(r) < 0.925) {
+    const double hs = 0.5*(h*h + k*k);
+    const double asr = 0.5*std::asin(r);
+    for (int i = 0; i < 10; ++i) {
+      for (const double sign : {-1.0, 1.0}) {
+        const double sn = std::sin(asr*(1.0 + sign*kGaussLegendreAbscissae[i]));
+        bvn += kGaussLegendreWeights[i]*std::exp((sn*hk - hs)/(1.0 - sn*sn));
+      }
+    }
+    bvn = bvn*asr/(2.0*kPi) + StandardNormalCDF(-h)*StandardNormalCDF(-k);
+  } else {
+    if (r < 0.0) {
+      k = -k;
+      hk = -hk;
+    }
+    if (std::fabs(r) < 1.0) {
+      const double as = (1.0 - r)*(1.0 + r);
+      double a = std::sqrt(as);
+      const double bs = Square(h - k);
+      const double c = (4.0 - hk)/8.0;
+      const double d = (12.0 - hk)/80.0;
+      const double asr = -0.5*(bs/as + hk);
+      if (asr > kMinimumExponent) {
+        bvn = a*std::exp(asr)*(1.0 - c*(bs - as)*(1.0 - d*bs)/3.0 + c*d*as*as);
+      }
+      if (hk > kMinimumExponent) {
+        const double b = std::sqrt(bs);
+        const double sp = std::sqrt(2.0*kPi)*StandardNormalCDF(-b/a);
+        bvn -= std::exp(-0.5*hk)*sp*b*(1.0 - c*bs*(1.0 - d*bs)/3.0);
+      }
+      a *= 0.5;
+      double sum = 0.0;
+      for (int i = 0; i < 10; ++i) {
+        for (const double sign : {-1.0, 1.0}) {
+          const double xs = Square(a*(1.0 + sign*kGaussLegendreAbscissae[i]));
+          const double asr_i = -0.5*(bs/xs + hk);
+          if (asr_i > kMinimumExponent) {
+            const double sp = 1.0 + c*xs*(1.0 + 5.0*d*xs);
+            const double rs = std::sqrt(1.0 - xs);
+            const double ep = std::exp(-0.5*hk*xs/Square(1.0 + rs))/rs;
+            sum += kGaussLegendreWeights[i]*std::exp(asr_i)*(sp - ep);
+          }
+        }
+      }
+      bvn = (a*sum - bvn)/(2.0*kPi);
+    }
+    if (r > 0.0) {
+      bvn += StandardNormalCDF(-std::fmax(h, k));
+    } else if (h >= k) {
+      bvn = -bvn;
+    } else {
+      const double lower = h < 0.0 ? StandardNormalCDF(k) - StandardNormalCDF(h) : StandardNormalCDF(-h) - StandardNormalCDF(-k);
+      bvn = lower - bvn;
+    }
+  }
+  return std::fmax(0.0, std::fmin(1.0, bvn));
+}
+
+OL_WARN_UNUSED_RESULT double CovarianceNormalCDF(double const * restrict limits, double const * restrict covariance,
+                                                 int num_variables) noexcept;
+
+/*!\rst
+  Computes ``P(X < h)`` for ``X ~ N(0, R)``, ``R`` a correlation matrix (unit diagonal), ``1 <= num_variables <=
+  kMaxMultivariateNormalCDFDim``.  See ComputeMultivariateNormalCDF() for the method used beyond 2 variables.
+\endrst*/
+OL_WARN_UNUSED_RESULT double CorrelationNormalCDF(double const * restrict h, double const * restrict correlation,
+                                                  int num_variables) noexcept {
+  const int n = num_variables;
+  if (n == 1) {
+    return StandardNormalCDF(h[0]);
+  } else if (n == 2) {
+    return BivariateNormalUpperTail(-h[0], -h[1], correlation[1]);
+  }
+
+  // decouple the variable whose largest correlation (in magnitude) is smallest: the integrands are then smoothest
+  int pivot = 0;
+  double pivot_max_correlation = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < n; ++i) {
+    double max_correlation = 0.0;
+    for (int j = 0; j < n; ++j) {
+      if (j != i) {
+        max_correlation = std::fmax(max_correlation, std::fabs(correlation[i*n + j]));
+      }
+    }
+    if (max_correlation < pivot_max_correlation) {
+      pivot = i;
+      pivot_max_correlation = max_correlation;
+    }
+  }
+
+  // t = 0: the pivot is independent of the others
+  double rest_limits[kMaxMultivariateNormalCDFDim] = {};
+  double rest_correlation[Square(kMaxMultivariateNormalCDFDim)] = {};
+  int rest[kMaxMultivariateNormalCDFDim];
+  for (int i = 0, a = 0; i < n; ++i) {
+    if (i != pivot) {
+      rest[a++] = i;
+    }
+  }
+  for (int a = 0; a < n - 1; ++a) {
+    rest_limits[a] = h[rest[a]];
+    for (int b = 0; b < n - 1; ++b) {
+      rest_correlation[b*(n - 1) + a] = correlation[rest[b]*n + rest[a]];
+    }
+  }
+  double result = StandardNormalCDF(h[pivot])*CorrelationNormalCDF(rest_limits, rest_correlation, n - 1);
+
+  // integrate d/dt over t in [0, 1]; term j differentiates wrt correlation(pivot, j), substituting sin(theta) = t*r
+  const double h_p = h[pivot];
+  int others[kMaxMultivariateNormalCDFDim];
+  for (int j = 0; j < n; ++j) {
+    const double r = correlation[pivot*n + j];
+    if (j == pivot || r == 0.0) {
+      continue;
+    }
+    for (int i = 0, a = 0; i < n; ++i) {
+      if (i != pivot && i != j) {
+        others[a++] = i;
+      }
+    }
+
+    const double h_j = h[j];
+    auto integrand = [&](double theta) {
+      const double s = std::sin(theta);
+      const double c2 = (1.0 - s)*(1.0 + s);
+      const double exponent = -0.5*(h_p*h_p - 2.0*s*h_p*h_j + h_j*h_j)/c2;
+      if (exponent < kMinimumExponent) {
+        return 0.0;
+      }
+
+      // distribution of the others conditioned on X_pivot = h_p, X_j = h_j, at correlation matrix R(t)
+      double conditional_limits[kMaxMultivariateNormalCDFDim];
+      double conditional_covariance[Square(kMaxMultivariateNormalCDFDim)];
+      const double t = s/r;
+      for (int a = 0; a < n - 2; ++a) {
+        const double r_pa = t*correlation[pivot*n + others[a]];
+        const double r_ja = correlation[j*n + others[a]];
+        conditional_limits[a] = h[others[a]] - (r_pa*(h_p - s*h_j) + r_ja*(h_j - s*h_p))/c2;
+        for (int b = 0; b < n - 2; ++b) {
+          const double r_pb = t*correlation[pivot*n + others[b]];
+          const double r_jb = correlation[j*n + others[b]];
+          conditional_covariance[b*(n - 2) + a] = correlation[others[b]*n + others[a]] -
+              (r_pa*r_pb - s*(r_pa*r_jb + r_ja*r_pb) + r_ja*r_jb)/c2;
+        }
+      }
+      return std::exp(exponent)*CovarianceNormalCDF(conditional_limits, conditional_covariance, n - 2);
+    };
+
+    const double theta_max = std::asin(r);
+    double term = GaussLegendre(integrand, 0.0, theta_max);
+    if (std::fabs(r) > kMaxFixedQuadratureCorrelation) {
+      term = AdaptiveGaussLegendre(integrand, 0.0, theta_max, term, kAdaptiveQuadratureTolerance,
+                                   kAdaptiveQuadratureRoundoff, kMaxAdaptiveQuadratureDepth);
+    }
+    result += term/(2.0*kPi);
+  }
+
+  return std::fmax(0.0, std::fmin(1.0, result));
+}
+
+/*!\rst
+  Computes ``P(Y < limits)`` for ``Y ~ N(0, covariance)``, ``0 <= num_variables <= kMaxMultivariateNormalCDFDim``,
+  by standardizing and calling CorrelationNormalCDF().  Components with (numerically) zero variance are point
+  masses at 0.
+\endrst*/
+double CovarianceNormalCDF(double const * restrict limits, double const * restrict covariance,
+                           int num_variables) noexcept {
+  int kept[kMaxMultivariateNormalCDFDim];
+  double std_dev[kMaxMultivariateNormalCDFDim];
+  int num_kept = 0;
+  for (int i = 0; i < num_variables; ++i) {
+    const double variance = covariance[i*num_variables + i];
+    if (variance > 0.0) {
+      std_dev[num_kept] = std::sqrt(variance);
+      kept[num_kept++] = i;
+    } else if (limits[i] < 0.0) {
+      return 0.0;
+    }
+  }
+  if (num_kept == 0) {
+    return 1.0;
+  }
+
+  double standardized_limits[kMaxMultivariateNormalCDFDim];
+  double correlation[Square(kMaxMultivariateNormalCDFDim)];
+  for (int a = 0; a < num_kept; ++a) {
+    standardized_limits[a] = limits[kept[a]]/std_dev[a];
+    for (int b = 0; b < num_kept; ++b) {
+      double correlation_ab = covariance[kept[b]*num_variables + kept[a]]/(std_dev[a]*std_dev[b]);
+      correlation[b*num_kept + a] = a == b ? 1.0 : std::fmax(-1.0, std::fmin(1.0, correlation_ab));
+    }
+  }
+  return CorrelationNormalCDF(standardized_limits, correlation, num_kept);
+}
+
+}  // end unnamed namespace
+
+double ComputeBivariateNormalCDF(double h_0, double h_1, double rho) noexcept {
+  return BivariateNormalUpperTail(-h_0, -h_1, rho);
+}
+
+double ComputeMultivariateNormalCDF(double const * restrict upper_limits, double const * restrict covariance,
+                                    int num_variables) {
+  if (unlikely(num_variables < 0 || num_variables > kMaxMultivariateNormalCDFDim)) {
+    OL_THROW_EXCEPTION(BoundsException<int>, "Unsupported number of variables for the multivariate normal CDF.",
+                       num_variables, 0, kMaxMultivariateNormalCDFDim);
+  }
+  return CovarianceNormalCDF(upper_limits, covariance, num_variables);
+}
+
+template <typename GaussianProcessType>
+BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>::BasicAnalyticExpectedImprovementEvaluator(
+    const GaussianProcessType& gaussian_process_in, double best_so_far)
+    : dim_(gaussian_process_in.dim()),
+      best_so_far_(best_so_far),
+      gaussian_process_(&gaussian_process_in) {
+}
+
+/*!\rst
+  For each ``k``, the pairwise differences ``W^{(k)}`` (see class docs) are a linear map of ``Y``: with ``v = Var[Y]``,
+  ``Cov(W_i, W_j) = v_{kk} - [j \neq k] v_{kj} - [i \neq k] v_{ik} + [i \neq k][j \neq k] v_{ij}``.  Then
+  ``D^{(k)}_l = \phi(b_l; S_{ll}) \Phi_{n-1}(b_{-l} - S_{-l,l} b_l/S_{ll}; S_{-l,-l} - S_{-l,l} S_{l,-l}/S_{ll})``
+  conditions on ``W_l = b_l``.
+\endrst*/
+template <typename GaussianProcessType>
+double BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>::ComputeWinProbabilities(
+    StateType * ei_state) const {
+  const int num_union = ei_state->num_union;
+  double * restrict to_sample_var = ei_state->to_sample_var.data();
+  gaussian_process_->ComputeMeanOfPoints(ei_state->points_to_sample_state, ei_state->to_sample_mean.data());
+  gaussian_process_->ComputeVarianceOfPoints(&(ei_state->points_to_sample_state), to_sample_var);
+  // the GP fills only the lower triangle
+  for (int j = 0; j < num_union; ++j) {
+    for (int i = j + 1; i < num_union; ++i) {
+      to_sample_var[i*num_union + j] = to_sample_var[j*num_union + i];
+    }
+  }
+
+  std::copy(ei_state->to_sample_var.begin(), ei_state->to_sample_var.end(), ei_state->cholesky_to_sample_var.begin());
+  int leading_minor_index = ComputeCholeskyFactorL(num_union, ei_state->cholesky_to_sample_var.data());
+  if (unlikely(leading_minor_index != 0)) {
+    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample/being_sampled or points_to_sample/being_sampled duplicating points_sampled with 0 noise.", ei_state->cholesky_to_sample_var.data(), num_union, leading_minor_index);
+  }
+
+  double const * restrict mean = ei_state->to_sample_mean.data();
+  double * restrict limits = ei_state->difference_limits.data();
+  double * restrict difference_var = ei_state->difference_var.data();
+  double * restrict conditional_limits = ei_state->conditional_limits.data();
+  double * restrict conditional_var = ei_state->conditional_var.data();
+  double EI = 0.0;
+  for (int k = 0; k < num_union; ++k) {
+    for (int i = 0; i < num_union; ++i) {
+      limits[i] = i == k ? best_so_far_ - mean[k] : mean[i] - mean[k];
+    }
+    for (int j = 0; j < num_union; ++j) {
+      for (int i = 0; i < num_union; ++i) {
+        double covariance = to_sample_var[k*num_union + k];
+        if (j != k) {
+          covariance -= to_sample_var[j*num_union + k];
+        }
+        if (i != k) {
+          covariance -= to_sample_var[k*num_union + i];
+          if (j != k) {
+            covariance += to_sample_var[j*num_union + i];
+          }
+        }
+        difference_var[j*num_union + i] = covariance;
+      }
+    }
+
+    ei_state->win_probability[k] = ComputeMultivariateNormalCDF(limits, difference_var, num_union);
+
+    double * restrict win_density = ei_state->win_density.data() + k*num_union;
+    for (int l = 0; l < num_union; ++l) {
+      const double var_l = difference_var[l*num_union + l];
+      for (int i = 0, a = 0; i < num_union; ++i) {
+        if (i == l) {
+          continue;
+        }
+        conditional_limits[a] = limits[i] - difference_var[l*num_union + i]*limits[l]/var_l;
+        for (int j = 0, b = 0; j < num_union; ++j) {
+          if (j == l) {
+            continue;
+          }
+          conditional_var[b*(num_union - 1) + a] = difference_var[j*num_union + i] -
+              difference_var[l*num_union + i]*difference_var[l*num_union + j]/var_l;
+          ++b;
+        }
+        ++a;
+      }
+      win_density[l] = std::exp(-0.5*Square(limits[l])/var_l)/std::sqrt(2.0*kPi*var_l)*
+          ComputeMultivariateNormalCDF(conditional_limits, conditional_var, num_union - 1);
+    }
+
+    EI += limits[k]*ei_state->win_probability[k];
+    for (int i = 0; i < num_union; ++i) {
+      EI += difference_var[k*num_union + i]*win_density[i];
+    }
+  }
+  return EI;
+}
+
+/*!\rst
+  Computes q,p-EI as the sum over ``k`` of ``E[(f^* - Y_k) 1\{Y_k \text{ wins}\}]``: the win probability times the mean
+  improvement, plus Tallis' correction ``E[U_k 1\{U \leq b\}] = -(S \nabla_b \Phi_n)_k``.
+
+  See Chevalier and Ginsbourger.
+\endrst*/
+template <typename GaussianProcessType>
+double BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>::ComputeExpectedImprovement(
+    StateType * ei_state) const {
+  return std::fmax(0.0, ComputeWinProbabilities(ei_state));
+}
+
+template <typename GaussianProcessType>
+void BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>::ComputeGradExpectedImprovement(
+    StateType * ei_state, double * restrict grad_EI) const {
+  const int num_union = ei_state->num_union;
+  ComputeWinProbabilities(ei_state);
+  gaussian_process_->ComputeGradMeanOfPoints(ei_state->points_to_sample_state, ei_state->grad_mu.data());
+  gaussian_process_->ComputeGradVarianceOfPoints(&(ei_state->points_to_sample_state), ei_state->grad_var.data());
+
+  double const * restrict win_density = ei_state->win_density.data();
+  for (int p = 0; p < ei_state->num_to_sample; ++p) {
+    for (int d = 0; d < dim_; ++d) {
+      grad_EI[p*dim_ + d] = -ei_state->win_probability[p]*ei_state->grad_mu[p*dim_ + d];
+    }
+
+    // dEI/dvar_{ij} = 0.5*H_{ij}, where H = E[second derivatives of the improvement] (symmetrized)
+    double const * restrict grad_var = ei_state->grad_var.data() + p*Square(num_union)*dim_;
+    for (int j = 0; j < num_union; ++j) {
+      for (int i = 0; i < num_union; ++i) {
+        double H_ij = 0.0;
+        if (i == j) {
+          for (int l = 0; l < num_union; ++l) {
+            H_ij += win_density[i*num_union + l];
+          }
+        } else {
+          H_ij = -0.5*(win_density[j*num_union + i] + win_density[i*num_union + j]);
+        }
+        for (int d = 0; d < dim_; ++d) {
+          grad_EI[p*dim_ + d] += 0.5*H_ij*grad_var[j*num_union*dim_ + i*dim_ + d];
+        }
+      }
+    }
+  }
+}
+
+template <typename GaussianProcessType>
+void BasicAnalyticExpectedImprovementState<GaussianProcessType>::SetCurrentPoint(
+    const EvaluatorType& ei_evaluator, double const * restrict points_to_sample) {
+  // update points_to_sample in union_of_points
+  std::copy(points_to_sample, points_to_sample + num_to_sample*dim, union_of_points.data());
+
+  // evaluate derived quantities for the GP; points_being_sampled have not moved
+  points_to_sample_state.UpdateMovingPoints(*ei_evaluator.gaussian_process(), union_of_points.data());
+}
+
+template <typename GaussianProcessType>
+BasicAnalyticExpectedImprovementState<GaussianProcessType>::BasicAnalyticExpectedImprovementState(
+    const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
+    double const * restrict points_being_sampled, int num_to_sample_in, int num_being_sampled_in,
+    bool configure_for_gradients, NormalRNGInterface * OL_UNUSED(normal_rng_in))
+    : dim(ei_evaluator.dim()),
+      num_to_sample(num_to_sample_in),
+      num_being_sampled(num_being_sampled_in),
+      num_derivatives(configure_for_gradients ? num_to_sample : 0),
+      num_union(num_to_sample + num_being_sampled),
+      union_of_points(ExpectedImprovementState::BuildUnionOfPoints(points_to_sample, points_being_sampled,
+                                                                   num_to_sample, num_being_sampled, dim)),
+      points_to_sample_state(*ei_evaluator.gaussian_process(), union_of_points.data(), num_union, num_derivatives,
+                             num_being_sampled),
+      to_sample_mean(num_union),
+      grad_mu(dim*num_derivatives),
+      to_sample_var(Square(num_union)),
+      grad_var(dim*Square(num_union)*num_derivatives),
+      cholesky_to_sample_var(Square(num_union)),
+      difference_limits(num_union),
+      difference_var(Square(num_union)),
+      conditional_limits(num_union),
+      conditional_var(Square(num_union)),
+      win_probability(num_union),
+      win_density(Square(num_union)) {
+  if (unlikely(num_union > EvaluatorType::kMaxNumUnion)) {
+    OL_THROW_EXCEPTION(BoundsException<int>, "Analytic EI supports only a few points (num_to_sample + num_being_sampled).",
+                       num_union, 1, EvaluatorType::kMaxNumUnion);
+  }
+}
+
+template <typename GaussianProcessType>
+BasicAnalyticExpectedImprovementState<GaussianProcessType>::BasicAnalyticExpectedImprovementState(
+    BasicAnalyticExpectedImprovementState&& OL_UNUSED(other)) = default;
+
+template <typename GaussianProcessType>
+void BasicAnalyticExpectedImprovementState<GaussianProcessType>::SetupState(
+    const EvaluatorType& ei_evaluator, double const * restrict points_to_sample) {
+  if (unlikely(dim != ei_evaluator.dim())) {
+    OL_THROW_EXCEPTION(InvalidValueException<int>, "Evaluator's and State's dim do not match!", dim, ei_evaluator.dim());
+  }
+
+  // update points_to_sample in union_of_points
+  std::copy(points_to_sample, points_to_sample + num_to_sample*dim, union_of_points.data());
+
+  // recompute all quantities derived from union_of_points (the GP may have changed)
+  points_to_sample_state.SetupState(*ei_evaluator.gaussian_process(), union_of_points.data(),
+                                    num_union, num_derivatives);
+}
+
+// template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
+template class BasicAnalyticExpectedImprovementEvaluator<GaussianProcess>;
+template class BasicAnalyticExpectedImprovementEvaluator<SparseGaussianProcess>;
+template struct BasicAnalyticExpectedImprovementState<GaussianProcess>;
+template struct BasicAnalyticExpectedImprovementState<SparseGaussianProcess>;
+
+template <typename GaussianProcessType>
+BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::BasicBatchOnePotentialSampleExpectedImprovementEvaluator(
+    const GaussianProcessType& gaussian_process_in, double best_so_far)
+    : dim_(gaussian_process_in.dim()),
+      best_so_far_(best_so_far),
+      gaussian_process_(&gaussian_process_in) {
+}
+
+/*!\rst
+  Same formula as OnePotentialSampleExpectedImprovementEvaluator::ComputeExpectedImprovement(), evaluated over a
+  block of points at a time.  The normal pdf & cdf are written out with ``exp`` and ``erfc`` so that the inner loop is
+  a flat, branch-free pass over the block.
+\endrst*/
+template <typename GaussianProcessType>
+void BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::ComputeExpectedImprovement(
+    double const * restrict points_to_sample, int num_points, double * restrict ei_values) const {
+  static constexpr double kMinimumVarianceEI =
+      BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::kMinimumVarianceEI;
+  const double inv_sqrt_2_pi = 1.0/std::sqrt(2.0*kPi);
+  const int max_block_size = kBlockSize;
+  double to_sample_mean[kBlockSize];
+
+  for (int block_start = 0; block_start < num_points; block_start += kBlockSize) {
+    const int block_size = std::min(num_points - block_start, max_block_size);
+    // variances are written straight into ei_values and overwritten by EI below
+    double * restrict ei_block = ei_values + block_start;
+    gaussian_process_->ComputeMeanAndMarginalVarianceOfPoints(points_to_sample + block_start*dim_, block_size,
+                                                              to_sample_mean, ei_block);
+
+    for (int i = 0; i < block_size; ++i) {
+      const double sigma = std::sqrt(std::fmax(kMinimumVarianceEI, ei_block[i]));
+      const double temp = best_so_far_ - to_sample_mean[i];
+      const double normalized_improvement = temp/sigma;
+      const double EI = temp*StandardNormalCDF(normalized_improvement) +
+          sigma*inv_sqrt_2_pi*std::exp(-0.5*Square(normalized_improvement));
+      ei_block[i] = std::fmax(0.0, EI);
+    }
+  }
+}
+
+// template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
+template class BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcess>;
+template class BasicBatchOnePotentialSampleExpectedImprovementEvaluator<SparseGaussianProcess>;
+
 /*!\rst
   Routes the EI computation through MultistartOptimizer + NullOptimizer to perform EI function evaluations at the list of input
-  points, using the appropriate EI evaluator (e.g., monte carlo vs analytic) depending on inputs.
+  points, using the appropriate EI evaluator (e.g., monte carlo vs analytic) depending on inputs and ``evaluation_type``.
+  1,0-EI is the exception: it is scored directly by BatchOnePotentialSampleExpectedImprovementEvaluator, with threads
+  splitting the list into blocks.
 \endrst*/
-void EvaluateEIAtPointList(const GaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+template <typename GaussianProcessType>
+void EvaluateEIAtPointList(const GaussianProcessType& gaussian_process, const ThreadSchedule& thread_schedule,
                            double const * restrict initial_guesses, double const * restrict points_being_sampled,
                            int num_multistarts, int num_to_sample, int num_being_sampled, double best_so_far,
-                           int max_int_steps, bool * restrict found_flag, NormalRNG * normal_rng,
+                           int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                           ExpectedImprovementEvaluationTypes evaluation_type,
+                           bool * restrict found_flag, PhiloxNormalRNG * normal_rng,
                            double * restrict function_values, double * restrict best_next_point) {
   if (unlikely(num_multistarts <= 0)) {
     OL_THROW_EXCEPTION(LowerBoundException<int>, "num_multistarts must be > 1", num_multistarts, 1);
   }
 
+  // EI evaluators for this type of GP
+  using BatchOnePotentialSampleEIEvaluator = BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>;
+  using AnalyticEIEvaluator = BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>;
+  using EIEvaluator = BasicExpectedImprovementEvaluator<GaussianProcessType>;
+
   using DomainType = DummyDomain;
   DomainType dummy_domain;
   bool configure_for_gradients = false;
   if (num_to_sample == 1 && num_being_sampled == 0) {
-    // special analytic case when we are not using (or not accounting for) multiple, simultaneous experiments
-    OnePotentialSampleExpectedImprovementEvaluator ei_evaluator(gaussian_process, best_so_far);
+    // special analytic case when we are not using (or not accounting for) multiple, simultaneous experiments;
+    // no optimizer is involved, so skip the per-point state setup and score the points in blocks
+    BatchOnePotentialSampleEIEvaluator ei_evaluator(gaussian_process, best_so_far);
+    const int dim = gaussian_process.dim();
+    const int block_size = BatchOnePotentialSampleEIEvaluator::kBlockSize;
+    const int num_blocks = (num_multistarts + block_size - 1)/block_size;
+
+    std::vector<double> ei_values_local;
+    double * restrict ei_values = function_values;
+    if (function_values == nullptr) {
+      ei_values_local.resize(num_multistarts);
+      ei_values = ei_values_local.data();
+    }
+
+    omp_set_schedule(thread_schedule.schedule, thread_schedule.chunk_size);
+#pragma omp parallel for num_threads(thread_schedule.max_num_threads) schedule(runtime)
+    for (int i = 0; i < num_blocks; ++i) {
+      const int offset = i*block_size;
+      ei_evaluator.ComputeExpectedImprovement(initial_guesses + offset*dim,
+                                              std::min(block_size, num_multistarts - offset), ei_values + offset);
+    }
 
-    std::vector<typename OnePotentialSampleExpectedImprovementEvaluator::StateType> ei_state_vector;
-    SetupExpectedImprovementState(ei_evaluator, initial_guesses, thread_schedule.max_num_threads,
+    // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
+    int best_index = 0;
+    double best_EI = 0.0;
+    *found_flag = false;
+    for (int i = 0; i < num_multistarts; ++i) {
+      if (best_EI < ei_values[i]) {
+        best_EI = ei_values[i];
+        best_index = i;
+        *found_flag = true;
+      }
+    }
+    std::copy(initial_guesses + best_index*dim, initial_guesses + (best_index + 1)*dim, best_next_point);
+  } else if (evaluation_type == ExpectedImprovementEvaluationTypes::kAnalytic &&
+             num_to_sample + num_being_sampled <= AnalyticEIEvaluator::kMaxNumUnion) {
+    // few enough points for EI via multivariate normal CDFs; faster and more accurate than monte-carlo
+    AnalyticEIEvaluator ei_evaluator(gaussian_process, best_so_far);
+
+    std::vector<typename AnalyticEIEvaluator::StateType> ei_state_vector;
+    SetupExpectedImprovementState(ei_evaluator, initial_guesses, points_being_sampled, num_to_sample,
+                                  num_being_sampled, thread_schedule.max_num_threads,
                                   configure_for_gradients, &ei_state_vector);
 
     // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
     OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, initial_guesses);
 
-    NullOptimizer<OnePotentialSampleExpectedImprovementEvaluator, DomainType> null_opt;
-    typename NullOptimizer<OnePotentialSampleExpectedImprovementEvaluator, DomainType>::ParameterStruct null_parameters;
-    MultistartOptimizer<NullOptimizer<OnePotentialSampleExpectedImprovementEvaluator, DomainType> > multistart_optimizer;
+    NullOptimizer<AnalyticEIEvaluator, DomainType> null_opt;
+    typename NullOptimizer<AnalyticEIEvaluator, DomainType>::ParameterStruct null_parameters;
+    MultistartOptimizer<NullOptimizer<AnalyticEIEvaluator, DomainType> > multistart_optimizer;
     multistart_optimizer.MultistartOptimize(null_opt, ei_evaluator, null_parameters, dummy_domain,
                                             thread_schedule, initial_guesses, num_multistarts,
                                             ei_state_vector.data(), function_values, &io_container);
     *found_flag = io_container.found_flag;
     std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_next_point);
   } else {
-    ExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far);
+    EIEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far, integration_type);
 
-    std::vector<typename ExpectedImprovementEvaluator::StateType> ei_state_vector;
+    std::vector<typename EIEvaluator::StateType> ei_state_vector;
     SetupExpectedImprovementState(ei_evaluator, initial_guesses, points_being_sampled, num_to_sample,
                                   num_being_sampled, thread_schedule.max_num_threads,
                                   configure_for_gradients, normal_rng, &ei_state_vector);
@@ -1336,9 +2799,9 @@ void EvaluateEIAtPointList(const GaussianProcess& gaussian_process, const Thread
     // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
     OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, initial_guesses);
 
-    NullOptimizer<ExpectedImprovementEvaluator, DomainType> null_opt;
-    typename NullOptimizer<ExpectedImprovementEvaluator, DomainType>::ParameterStruct null_parameters;
-    MultistartOptimizer<NullOptimizer<ExpectedImprovementEvaluator, DomainType> > multistart_optimizer;
+    NullOptimizer<EIEvaluator, DomainType> null_opt;
+    typename NullOptimizer<EIEvaluator, DomainType>::ParameterStruct null_parameters;
+    MultistartOptimizer<NullOptimizer<EIEvaluator, DomainType> > multistart_optimizer;
     multistart_optimizer.MultistartOptimize(null_opt, ei_evaluator, null_parameters, dummy_domain,
                                             thread_schedule, initial_guesses, num_multistarts,
                                             ei_state_vector.data(), function_values, &io_container);
@@ -1347,26 +2810,90 @@ void EvaluateEIAtPointList(const GaussianProcess& gaussian_process, const Thread
   }
 }
 
+// template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
+template void EvaluateEIAtPointList(
+    const GaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict initial_guesses, double const * restrict points_being_sampled, int num_multistarts,
+    int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool * restrict found_flag, PhiloxNormalRNG * normal_rng,
+    double * restrict function_values, double * restrict best_next_point);
+template void EvaluateEIAtPointList(
+    const SparseGaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict initial_guesses, double const * restrict points_being_sampled, int num_multistarts,
+    int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool * restrict found_flag, PhiloxNormalRNG * normal_rng,
+    double * restrict function_values, double * restrict best_next_point);
+
+namespace {  // ComputeOptimalPointsToSample() for each optimizer
+
+/*!\rst
+  Runs ComputeOptimalPointsToSampleWithRandomStarts() for ComputeOptimalPointsToSampleWithFallback(), picking the overload
+  by the type of ``optimizer_parameters``.  Only L-BFGS offers adaptive multistart; the gradient descent overload requires
+  ``adaptive_parameters`` to be nullptr.
+\endrst*/
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSampleWithRandomStartsFor(const GaussianProcessType& gaussian_process,
+                                                     const GradientDescentParameters& optimizer_parameters,
+                                                     AdaptiveMultistartParameters const * OL_UNUSED(adaptive_parameters),
+                                                     const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                                     double const * restrict points_being_sampled,
+                                                     int num_to_sample, int num_being_sampled, double best_so_far,
+                                                     int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                                     ExpectedImprovementEvaluationTypes evaluation_type,
+                                                     bool * restrict found_flag,
+                                                     UniformRandomGenerator * uniform_generator,
+                                                     PhiloxNormalRNG * normal_rng, double * restrict best_next_point) {
+  ComputeOptimalPointsToSampleWithRandomStarts(gaussian_process, optimizer_parameters, domain, thread_schedule,
+                                               points_being_sampled, num_to_sample, num_being_sampled, best_so_far,
+                                               max_int_steps, integration_type, evaluation_type,
+                                               found_flag, uniform_generator,
+                                               normal_rng, best_next_point);
+}
+
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSampleWithRandomStartsFor(const GaussianProcessType& gaussian_process,
+                                                     const LBFGSParameters& optimizer_parameters,
+                                                     AdaptiveMultistartParameters const * adaptive_parameters,
+                                                     const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                                     double const * restrict points_being_sampled,
+                                                     int num_to_sample, int num_being_sampled, double best_so_far,
+                                                     int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                                     ExpectedImprovementEvaluationTypes evaluation_type,
+                                                     bool * restrict found_flag,
+                                                     UniformRandomGenerator * uniform_generator,
+                                                     PhiloxNormalRNG * normal_rng, double * restrict best_next_point) {
+  ComputeOptimalPointsToSampleWithRandomStarts(gaussian_process, optimizer_parameters, adaptive_parameters, domain,
+                                               thread_schedule, points_being_sampled, num_to_sample,
+                                               num_being_sampled, best_so_far, max_int_steps, integration_type,
+                                               evaluation_type,
+                                               found_flag, uniform_generator, normal_rng, best_next_point);
+}
+
 /*!\rst
   This is a simple wrapper around ComputeOptimalPointsToSampleWithRandomStarts() and
   ComputeOptimalPointsToSampleViaLatinHypercubeSearch(). That is, this method attempts multistart gradient descent
-  and falls back to latin hypercube search if gradient descent fails (or is not desired).
+  (or L-BFGS, chosen by the type of ``optimizer_parameters``; optionally adaptive, see ``adaptive_parameters``) and falls
+  back to latin hypercube search if it fails (or is not desired).
 
   TODO(GH-77): Instead of random search, we may want to fall back on the methods in
   ``gpp_heuristic_expected_improvement_optimization.hpp`` if gradient descent fails; esp for larger q
   (even ``q \approx 4``), latin hypercube search does a pretty terrible job.
   This is more for general q,p-EI as these two things are equivalent for 1,0-EI.
 \endrst*/
-template <typename DomainType>
-void ComputeOptimalPointsToSample(const GaussianProcess& gaussian_process,
-                                  const GradientDescentParameters& optimizer_parameters,
-                                  const DomainType& domain, const ThreadSchedule& thread_schedule,
-                                  double const * restrict points_being_sampled,
-                                  int num_to_sample, int num_being_sampled, double best_so_far,
-                                  int max_int_steps, bool lhc_search_only,
-                                  int num_lhc_samples, bool * restrict found_flag,
-                                  UniformRandomGenerator * uniform_generator,
-                                  NormalRNG * normal_rng, double * restrict best_points_to_sample) {
+template <typename ParameterStruct, typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSampleWithFallback(const GaussianProcessType& gaussian_process,
+                                              const ParameterStruct& optimizer_parameters,
+                                              AdaptiveMultistartParameters const * adaptive_parameters,
+                                              const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                              double const * restrict points_being_sampled,
+                                              int num_to_sample, int num_being_sampled, double best_so_far,
+                                              int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                              ExpectedImprovementEvaluationTypes evaluation_type,
+                                              bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+                                              UniformRandomGenerator * uniform_generator,
+                                              PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample) {
   if (unlikely(num_to_sample <= 0)) {
     return;
   }
@@ -1375,15 +2902,15 @@ void ComputeOptimalPointsToSample(const GaussianProcess& gaussian_process,
 
   bool found_flag_local = false;
   if (lhc_search_only == false) {
-    ComputeOptimalPointsToSampleWithRandomStarts(gaussian_process, optimizer_parameters,
-                                                 domain, thread_schedule, points_being_sampled,
-                                                 num_to_sample, num_being_sampled,
-                                                 best_so_far, max_int_steps,
-                                                 &found_flag_local, uniform_generator, normal_rng,
-                                                 next_points_to_sample.data());
+    ComputeOptimalPointsToSampleWithRandomStartsFor(gaussian_process, optimizer_parameters, adaptive_parameters,
+                                                    domain, thread_schedule, points_being_sampled,
+                                                    num_to_sample, num_being_sampled,
+                                                    best_so_far, max_int_steps, integration_type, evaluation_type,
+                                                    &found_flag_local, uniform_generator, normal_rng,
+                                                    next_points_to_sample.data());
   }
 
-  // if gradient descent EI optimization failed OR we're only doing latin hypercube searches
+  // if multistart EI optimization failed OR we're only doing latin hypercube searches
   if (found_flag_local == false || lhc_search_only == true) {
     if (unlikely(lhc_search_only == false)) {
       OL_WARNING_PRINTF("WARNING: %d,%d-EI opt DID NOT CONVERGE\n", num_to_sample, num_being_sampled);
@@ -1400,7 +2927,7 @@ void ComputeOptimalPointsToSample(const GaussianProcess& gaussian_process,
                                                           points_being_sampled,
                                                           num_lhc_samples, num_to_sample,
                                                           num_being_sampled, best_so_far,
-                                                          max_int_steps,
+                                                          max_int_steps, integration_type, evaluation_type,
                                                           &found_flag_local, uniform_generator,
                                                           normal_rng, next_points_to_sample.data());
 
@@ -1418,20 +2945,94 @@ void ComputeOptimalPointsToSample(const GaussianProcess& gaussian_process,
   std::copy(next_points_to_sample.begin(), next_points_to_sample.end(), best_points_to_sample);
 }
 
+}  // end unnamed namespace
+
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSample(const GaussianProcessType& gaussian_process,
+                                  const GradientDescentParameters& optimizer_parameters,
+                                  const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                  double const * restrict points_being_sampled,
+                                  int num_to_sample, int num_being_sampled, double best_so_far,
+                                  int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                  ExpectedImprovementEvaluationTypes evaluation_type,
+                                  bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+                                  UniformRandomGenerator * uniform_generator,
+                                  PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample) {
+  ComputeOptimalPointsToSampleWithFallback(gaussian_process, optimizer_parameters, nullptr, domain, thread_schedule,
+                                           points_being_sampled, num_to_sample, num_being_sampled, best_so_far,
+                                           max_int_steps, integration_type, evaluation_type,
+                                           lhc_search_only, num_lhc_samples,
+                                           found_flag, uniform_generator, normal_rng, best_points_to_sample);
+}
+
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSample(const GaussianProcessType& gaussian_process,
+                                  const LBFGSParameters& optimizer_parameters,
+                                  AdaptiveMultistartParameters const * adaptive_parameters,
+                                  const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                  double const * restrict points_being_sampled,
+                                  int num_to_sample, int num_being_sampled, double best_so_far,
+                                  int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                  ExpectedImprovementEvaluationTypes evaluation_type,
+                                  bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+                                  UniformRandomGenerator * uniform_generator,
+                                  PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample) {
+  ComputeOptimalPointsToSampleWithFallback(gaussian_process, optimizer_parameters, adaptive_parameters, domain,
+                                           thread_schedule, points_being_sampled, num_to_sample, num_being_sampled,
+                                           best_so_far, max_int_steps, integration_type, evaluation_type,
+                                           lhc_search_only,
+                                           num_lhc_samples, found_flag, uniform_generator, normal_rng,
+                                           best_points_to_sample);
+}
+
 // template explicit instantiation definitions, see gpp_common.hpp header comments, item 6
 template void ComputeOptimalPointsToSample(
     const GaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
     const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
     double const * restrict points_being_sampled, int num_to_sample,
-    int num_being_sampled, double best_so_far, int max_int_steps, bool lhc_search_only,
-    int num_lhc_samples, bool * restrict found_flag, UniformRandomGenerator * uniform_generator,
-    NormalRNG * normal_rng, double * restrict best_points_to_sample);
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag, UniformRandomGenerator * uniform_generator,
+    PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
 template void ComputeOptimalPointsToSample(
     const GaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
     const SimplexIntersectTensorProductDomain& domain, const ThreadSchedule& thread_schedule,
     double const * restrict points_being_sampled,
     int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+template void ComputeOptimalPointsToSample(
+    const SparseGaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
+    const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled, int num_to_sample,
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+template void ComputeOptimalPointsToSample(
+    const SparseGaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
+    const SimplexIntersectTensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled,
+    int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+template void ComputeOptimalPointsToSample(
+    const GaussianProcess& gaussian_process, const LBFGSParameters& optimizer_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters, const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled, int num_to_sample,
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+template void ComputeOptimalPointsToSample(
+    const SparseGaussianProcess& gaussian_process, const LBFGSParameters& optimizer_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters, const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled, int num_to_sample,
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
     bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
-    UniformRandomGenerator * uniform_generator, NormalRNG * normal_rng, double * restrict best_points_to_sample);
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
 
 }  // end namespace optimal_learning
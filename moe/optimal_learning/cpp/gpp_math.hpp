@@ -109,7 +109,8 @@
 
   Functions here generally require some combination of a CovarianceInterface object as well as
   data about prior and current (i.e., concurrent) experiments.  These data are encapsulated in
-  the GaussianProcess class.  Then we build an ExpectedImprovementEvaluator object (with
+  the GaussianProcess class (or its sparse, inducing-point approximation, SparseGaussianProcess, for large
+  ``num_sampled``).  Then we build an ExpectedImprovementEvaluator object (with
   associated state, see ``gpp_common.hpp`` item 5 for (Evaluator, State) relations) on top of a
   GaussianProcess for computing and optimizing EI.
 
@@ -197,6 +198,22 @@
   e. Efficient Global Optimization of Expensive Black-Box Functions.
      Jones, D.R., Schonlau, M., Welch, W.J. 1998.
      Journal of Global Optimization, 13, 455-492.
+
+  f. Fast Computation of the Multi-points Expected Improvement with Applications in Batch Selection.
+     Clement Chevalier and David Ginsbourger.  2013.
+     Learning and Intelligent Optimization (LION 7), Lecture Notes in Computer Science 7997, p59-69.
+
+  g. Numerical Computation of Rectangular Bivariate and Trivariate Normal and t Probabilities.
+     Alan Genz.  2004.
+     Statistics and Computing, 14, 251-260.
+
+  h. A Unifying View of Sparse Approximate Gaussian Process Regression.
+     Joaquin Quinonero-Candela and Carl Edward Rasmussen.  2005.
+     Journal of Machine Learning Research, 6, 1939-1959.
+
+  i. Variational Learning of Inducing Variables in Sparse Gaussian Processes.
+     Michalis K. Titsias.  2009.
+     Proceedings of the 12th International Conference on Artificial Intelligence and Statistics (AISTATS), p567-574.
 \endrst*/
 
 #ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MATH_HPP_
@@ -217,12 +234,23 @@
 #include "gpp_optimization.hpp"
 #include "gpp_optimizer_parameters.hpp"
 #include "gpp_random.hpp"
+#include "gpp_task_pool.hpp"
 
 namespace optimal_learning {
 
 struct ThreadSchedule;
 struct PointsToSampleState;
 
+/*!\rst
+  Draws a new generation id for a GaussianProcess or SparseGaussianProcess whose data or hyperparameters just changed.
+  Ids are unique across all GPs in the process (and never 0), so two GPs share a generation only if one is a clone of
+  the other and neither has been modified since.  Thread-safe.
+
+  \return
+    a generation id that has not been returned before
+\endrst*/
+std::uint64_t NewGaussianProcessGeneration() noexcept OL_WARN_UNUSED_RESULT;
+
 /*!\rst
   Object that encapsulates Gaussian Process Priors (GPPs).  A GPP is defined by a set of
   (sample point, function value, noise variance) triples along with a covariance function that relates the points.
@@ -297,6 +325,54 @@ class GaussianProcess final {
                   double const * restrict noise_variance_in,
                   int dim_in, int num_sampled_in) OL_NONNULL_POINTERS;
 
+  /*!\rst
+    Same as the previous constructor, except that ``K`` is factored with up to ``thread_schedule.max_num_threads``
+    threads (the previous constructor uses one).  The schedule is kept for later recomputations of the derived
+    quantities (e.g., SetCovarianceHyperparameters(), AddPointsToGP()); see SetThreadSchedule().
+
+    \param
+      (as in the previous constructor)
+      :thread_schedule: number of threads for factoring ``K`` and related triangular solves (``schedule`` and
+        ``chunk_size`` are used for the latter only)
+  \endrst*/
+  GaussianProcess(const CovarianceInterface& covariance_in,
+                  double const * restrict points_sampled_in,
+                  double const * restrict points_sampled_value_in,
+                  double const * restrict noise_variance_in,
+                  int dim_in, int num_sampled_in,
+                  const ThreadSchedule& thread_schedule) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Constructs a GaussianProcess from previously computed derived quantities (e.g., LoadGaussianProcessSnapshot() in
+    gpp_model_snapshot.hpp), skipping the ``O(N^3)`` factorization of ``K``.
+
+    ``K_chol`` (``N^2`` entries, the bulk of a large model) is NOT copied: it is read in place until the first change to
+    this GP's data or hyperparameters, which copies it first (copy-on-write).  ``K_chol_storage`` owns the memory holding
+    ``K_chol`` (e.g., a memory-mapped file); this GP and its clones keep it alive.  All other inputs are copied.
+
+    .. Warning:: the derived quantities are NOT checked: ``K_chol`` and ``K_inv_y`` must be those of a GaussianProcess
+      with the same covariance and data (i.e., K_chol() and K_inv_y()).
+
+    \param
+      :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
+      :points_sampled[dim][num_sampled]: points that have already been sampled
+      :points_sampled_value[num_sampled]: values of the already-sampled points
+      :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+      :K_chol[num_sampled][num_sampled]: cholesky factor of ``K``, as returned by K_chol()
+      :K_inv_y[num_sampled]: ``K^-1 * y``, as returned by K_inv_y()
+      :K_chol_storage: owner of the memory holding ``K_chol``, which must stay valid and unchanged while it is alive
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+  \endrst*/
+  GaussianProcess(const CovarianceInterface& covariance_in,
+                  double const * restrict points_sampled_in,
+                  double const * restrict points_sampled_value_in,
+                  double const * restrict noise_variance_in,
+                  double const * restrict K_chol_in,
+                  double const * restrict K_inv_y_in,
+                  std::shared_ptr<const void> K_chol_storage,
+                  int dim_in, int num_sampled_in) OL_NONNULL_POINTERS;
+
   int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
     return dim_;
   }
@@ -317,25 +393,62 @@ class GaussianProcess final {
     return noise_variance_;
   }
 
+  const CovarianceInterface& covariance() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return *covariance_ptr_;
+  }
+
+  //! \return cholesky factor of ``K`` (``[num_sampled][num_sampled]``; only the lower triangle is meaningful)
+  double const * K_chol() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return K_chol_view_ != nullptr ? K_chol_view_ : K_chol_->data();
+  }
+
+  //! \return ``K^-1 * y``
+  const std::vector<double>& K_inv_y() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return K_inv_y_;
+  }
+
+  //! \return id of the current (points_sampled, hyperparameters); changes whenever either does (see NewGaussianProcessGeneration())
+  std::uint64_t generation() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return generation_;
+  }
+
+  const ThreadSchedule& thread_schedule() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return thread_schedule_;
+  }
+
+  /*!\rst
+    Sets the threads used whenever this GP recomputes its derived quantities (factoring ``K`` in
+    SetCovarianceHyperparameters(), extending it in AddPointsToGP(), etc.).
+
+    \param
+      :thread_schedule: number of threads for factoring ``K`` and related triangular solves
+  \endrst*/
+  void SetThreadSchedule(const ThreadSchedule& thread_schedule) noexcept {
+    thread_schedule_ = thread_schedule;
+  }
+
   /*!\rst
     Change the hyperparameters of this GP's covariance function.
     Also forces recomputation of all derived quantities for GP to remain consistent.
 
     .. WARNING::
          Using this function invalidates any PointsToSampleState objects created with "this" object.
-         For any such objects "state", call state.SetupState(...) to restore them.
+         For any such objects "state", call state.SetupState(...) to restore them.  (UpdateMovingPoints() detects
+         the change through generation() and recomputes everything.)
 
     \param
       :hyperparameters_new[covariance_ptr->GetNumberOfHyperparameters]: new hyperparameter array
   \endrst*/
   void SetCovarianceHyperparameters(double const * restrict hyperparameters_new) OL_NONNULL_POINTERS {
     covariance_ptr_->SetHyperparameters(hyperparameters_new);
+    generation_ = NewGaussianProcessGeneration();
     RecomputeDerivedVariables();
   }
 
   /*!\rst
     Sets up the PointsToSampleState object so that it can be used to compute GP mean, variance, and gradients thereof.
-    ASSUMES all needed space is ALREADY ALLOCATED.
+    ASSUMES all needed space is ALREADY ALLOCATED.  Columns of the last ``points_to_sample_state->num_cached``
+    points are assumed up to date and skipped.
 
     This function should not be called directly; instead use PointsToSampleState::SetupState().
 
@@ -349,7 +462,14 @@ class GaussianProcess final {
   /*!\rst
     Add the specified (point, fcn value, noise variance) historical data to this GP.
 
-    Forces recomputation of all derived quantities for GP to remain consistent.
+    Updates all derived quantities for GP to remain consistent.  Rather than refactoring ``K`` from scratch
+    (``O((N+k)^3)``), the existing cholesky factor is extended with the ``k = num_new_points`` new rows
+    (``O(N^2*k)``).  If the new diagonal block is numerically singular, this falls back to a full refactorization.
+
+    .. WARNING::
+         Using this function invalidates any PointsToSampleState objects created with "this" object.
+         For any such objects "state", call state.SetupState(...) to restore them.  (UpdateMovingPoints() detects
+         the change through generation() and recomputes everything.)
 
     \param
       :new_points[dim][num_new_points]: coordinates of each new point to add
@@ -437,6 +557,27 @@ class GaussianProcess final {
   void ComputeVarianceOfPoints(StateType * points_to_sample_state,
                                double * restrict var_star) const noexcept OL_NONNULL_POINTERS;
 
+  /*!\rst
+    Computes the mean and the marginal variance (i.e., the diagonal of ComputeVarianceOfPoints()) of this GP at each
+    point of ``Xs`` (``points_to_sample``), treating the points independently.  This is the kernel for scoring many
+    candidate points at once: it builds ``Ks = K(X, Xs)`` as one ``num_sampled x num_to_sample`` block, does a single
+    multi-RHS triangular solve ``V = L^-1 * Ks``, and reads off ``Vars_{i,i} = Kss_{i,i} - V_i^T * V_i``.  No
+    PointsToSampleState is needed and the ``num_to_sample x num_to_sample`` covariance is never formed.
+
+    Temporary storage (``num_sampled * num_to_sample`` doubles) comes from the calling thread's ScratchArena, so callers
+    with many points should pass them in cache-sized blocks.
+
+    \param
+      :points_to_sample[dim][num_to_sample]: points at which to evaluate the GP mean and variance
+      :num_to_sample: number of points in ``points_to_sample``
+    \output
+      :mean_of_points[num_to_sample]: mean of GP evaluated at each point of ``points_to_sample``
+      :variance_of_points[num_to_sample]: variance of GP evaluated at each point of ``points_to_sample``
+  \endrst*/
+  void ComputeMeanAndMarginalVarianceOfPoints(double const * restrict points_to_sample, int num_to_sample,
+                                              double * restrict mean_of_points,
+                                              double * restrict variance_of_points) const OL_NONNULL_POINTERS;
+
   /*!\rst
     Similar to ComputeGradCholeskyVarianceOfPoints() except this does not include the gradient terms from
     the cholesky factorization.  Description will not be duplicated here.
@@ -500,7 +641,9 @@ class GaussianProcess final {
   void ResetToMostRecentSeed() noexcept;
 
   /*!\rst
-    Clones "this" GaussianProcess.
+    Clones "this" GaussianProcess.  The cholesky factor of ``K`` (``N^2`` entries) is shared with the clone, not copied:
+    whichever GP is modified first (e.g., AddPointsToGP(), SetCovarianceHyperparameters()) copies it (copy-on-write), so
+    cloning costs ``O(N*dim)``.
 
     \return
       Pointer to a constructed object that is a copy of "this"
@@ -518,41 +661,40 @@ class GaussianProcess final {
                                 double * restrict cov_mat) const noexcept OL_NONNULL_POINTERS;
 
   /*!\rst
-    Similar to ComputeGradCholeskyVarianceOfPointsPerPoint() except this does not include the gradient terms from
-    the cholesky factorization.  Description will not be duplicated here.
+    Recomputes (including resizing as needed) the derived quantities in this class.
+    This function should be called any time state variables are changed.
+
+    Large covariance matrices (``num_sampled >= kCholeskyBlockedMinimumSize``) are factored with the multithreaded
+    ComputeTiledCholeskyFactorL(), using ``thread_schedule_`` (one thread unless set by the constructor or
+    SetThreadSchedule()).  When called from inside an OpenMP parallel region (with nested parallelism disabled, the
+    default), this runs on the calling thread only.
+    With ``OL_BLAS_ENABLED``, ComputeCholeskyFactorL() (LAPACK) is used instead.
   \endrst*/
-  void ComputeGradVarianceOfPointsPerPoint(StateType * points_to_sample_state, int diff_index,
-                                           double * restrict grad_var) const noexcept OL_NONNULL_POINTERS;
+  void RecomputeDerivedVariables();
 
   /*!\rst
-    Computes the gradient of the cholesky factorization of the variance of this GP with respect to the
-    ``diff_index``-th point in ``points_to_sample``.
-
-    This internal method is meant to be used by ComputeGradCholeskyVarianceOfPoints() to construct the gradient wrt all
-    points of ``points_to_sample``. See that function for more details.
+    Extends the derived quantities in this class after new points have been appended to the state variables.
+    ``K_chol_`` gains ``num_sampled_ - num_sampled_old`` new rows/columns; ``K_inv_y_`` is recomputed from the result.
+    Only the new cross-covariance block is built; the leading ``num_sampled_old x num_sampled_old`` block
+    of ``K_chol_`` is reused as-is.
 
     \param
-      :points_to_sample_state[1]: ptr to a FULLY CONFIGURED PointsToSampleState (configure via PointsToSampleState::SetupState)
-      :diff_index: index of ``points_to_sample`` in {0, .. ``num_to_sample``-1} to be differentiated against
-      :chol_var[num_to_sample][num_to_sample]: the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``)
-        e.g., from the cholesky factorization of ``ComputeVarianceOfPoints``
-    \output
-      :points_to_sample_state[1]: ptr to a FULLY CONFIGURED PointsToSampleState; only temporary state may be mutated
-      :grad_chol[dim][num_to_sample][num_to_sample]: gradient of the cholesky-factored
-        variance of the GP.  ``grad_chol[d][i][j]`` is actually the gradients of ``var_{i,j}`` with
-        respect to ``x_{d,k}``, the d-th dimension of the k-th entry of ``points_to_sample``, where
-        k = ``diff_index``
+      :num_sampled_old: number of points sampled before the most recent append; ``0 < num_sampled_old <= num_sampled_``
+    \return
+      true if successful; false if the new diagonal block of the cholesky factor is (numerically) singular.
+      On failure, the derived quantities are INVALID and RecomputeDerivedVariables() must be called.
   \endrst*/
-  void ComputeGradCholeskyVarianceOfPointsPerPoint(StateType * points_to_sample_state, int diff_index,
-                                                   double const * restrict chol_var,
-                                                   double * restrict grad_chol) const noexcept OL_NONNULL_POINTERS;
+  bool ExtendDerivedVariables(int num_sampled_old) OL_WARN_UNUSED_RESULT;
 
   /*!\rst
-    Recomputes (including resizing as needed) the derived quantities in this class.
-    This function should be called any time state variables are changed.
-  \endrst*/
-  void RecomputeDerivedVariables();
+    Makes ``K_chol_`` safe to modify: if ``K_chol`` is read in place from external storage (see the derived-quantities
+    constructor) or shared with clones, copies its first ``num_entries`` entries into a new ``K_chol_`` owned by this
+    GP alone (releasing this GP's reference to the storage).  Call before modifying ``K_chol_``.
 
+    \param
+      :num_entries: number of entries of the current ``K_chol`` to copy (0 if it will be overwritten anyway)
+  \endrst*/
+  void DetachCholeskyFactor(int num_entries);
 
   // size information
   //! spatial dimension (e.g., entries per point of ``points_sampled``)
@@ -571,456 +713,1543 @@ class GaussianProcess final {
   std::vector<double> noise_variance_;
 
   // derived variables for prior
-  //! cholesky factorization of ``K`` (i.e., ``K(X,X)`` covariance matrix (prior), includes noise variance)
-  std::vector<double> K_chol_;
+  //! cholesky factorization of ``K`` (i.e., ``K(X,X)`` covariance matrix (prior), includes noise variance); shared
+  //! with clones, so only modified after DetachCholeskyFactor()
+  std::shared_ptr<std::vector<double> > K_chol_;
   //! ``K^-1 * y``; computed WITHOUT forming ``K^-1``
   std::vector<double> K_inv_y_;
+  //! if not nullptr, the cholesky factor of ``K`` is read from here instead of ``K_chol_`` (which is then null)
+  double const * K_chol_view_;
+  //! owner of the memory K_chol_view_ points into
+  std::shared_ptr<const void> K_chol_storage_;
+  //! threads for (re)computing the derived variables
+  ThreadSchedule thread_schedule_;
+  //! id of the current state & derived variables; see generation()
+  std::uint64_t generation_;
 
   //! Normal PRNG for use with sampling points from GP
   NormalGeneratorType normal_rng_;
 };
 
 /*!\rst
-  This object holds the state needed for a GaussianProcess object characterize the distribution of function values arising from
-  sampling the GP at a list of ``points_to_sample``.  This object is required by the GaussianProcess to access functionality for
-  computing the mean, variance, and spatial gradients thereof.
+  Enum for the approximation used by SparseGaussianProcess.  Both approximate the training covariance by the Nystrom
+  approximation through the inducing points ``U``, ``Q = K(X,U) * K(U,U)^{-1} * K(U,X)``, and differ only in the
+  diagonal correction added to it.
+\endrst*/
+enum class SparseGaussianProcessTypes {
+  //! fully independent training conditional: ``K(X,X) \approx Q + diag(K(X,X) - Q) + \sigma_n^2 I``
+  kFITC = 0,
+  //! variational free energy (Titsias 2009): ``K(X,X) \approx Q + \sigma_n^2 I``; predictions match DTC
+  kVFE = 1,
+};
 
-  The "independent variables" for this object are ``points_to_sample``. These points are both the "p" and the "q" in q,p-EI;
-  i.e., they are the parameters of both ongoing experiments and new predictions. Recall that in q,p-EI, the q points are
-  called ``points_to_sample`` and the p points are called ``points_being_sampled.`` Here, we need to make predictions about
-  both point sets with the GP, so we simply call the union of point sets ``points_to_sample.``
+/*!\rst
+  Sparse (inducing-point) approximation to GaussianProcess.  The ``num_sampled`` training points only interact through
+  ``num_inducing`` inducing points, ``U`` (``M = num_inducing``, ``N = num_sampled``, ``M << N``), so building this object
+  costs ``O(N*M^2)`` time and ``O(N*M)`` memory (vs ``O(N^3)`` and ``O(N^2)`` for GaussianProcess).  Following
+  Quinonero-Candela & Rasmussen (2005), with ``Ku = K(U,U)``, ``Kuf = K(U,X)``, and ``\Lambda`` the diagonal
+  correction (see SparseGaussianProcessTypes):
+
+  | ``\Sigma = [Ku + Kuf * \Lambda^{-1} * Kuf^T]^{-1}``
+  | ComputeMeanOfPoints    : ``K(Xs, U) * \Sigma * Kuf * \Lambda^{-1} * y``
+  | ComputeVarianceOfPoints: ``K(Xs, Xs) - K(Xs, U) * [Ku^{-1} - \Sigma] * K(U, Xs)``
+
+  These have exactly the form of the GaussianProcess mean and variance with ``X`` replaced by ``U``, ``K^{-1} * y``
+  by the precomputed ``\Sigma * Kuf * \Lambda^{-1} * y``, and ``K^{-1}`` by ``Ku^{-1} - \Sigma``.  So this class
+  shares PointsToSampleState (sized by ``num_inducing``) and the mean/variance/gradient API with GaussianProcess,
+  and the EI evaluators and optimizers (e.g., ComputeOptimalPointsToSample()) accept either GP.  The mean costs
+  ``O(M)`` and the variance ``O(M^2)`` per point.
+
+  With ``num_inducing = num_sampled`` and ``U = X``, the kVFE approximation reproduces GaussianProcess (up to the jitter
+  added to ``Ku``).
+
+  Unlike GaussianProcess, this class does not support adding points or sampling from the GP.  ``noise_variance`` must be
+  strictly positive.
+\endrst*/
+class SparseGaussianProcess final {
+ public:
+  using StateType = PointsToSampleState;
 
-  In GP computations, there is really no distinction between the "q" and "p" points from EI, ``points_to_sample`` and
-  ``points_being_sampled``, respectively. However, in EI optimization, we only need gradients of GP quantities wrt
-  ``points_to_sample``, so users should build PointsToSampleState() with ``num_derivatives = num_to_sample``.
+  //! Minimum allowed standard deviation value in the gradient of the cholesky factored variance; see GaussianProcess.
+  static constexpr double kMinimumStdDev = GaussianProcess::kMinimumStdDev;
 
-  Once constructed, this object provides the SetupState() function to update it for computations at different sets of
-  potential points to sample.
+  //! Relative jitter added to the diagonal of ``K(U,U)``, which is often nearly singular when inducing points cluster.
+  static constexpr double kInducingPointJitter = 1.0e-10;
 
-  See general comments on State structs in ``gpp_common.hpp``'s header docs.
-\endrst*/
-struct PointsToSampleState final {
   /*!\rst
-    Constructs a PointsToSampleState object with new ``points_to_sample``.
-    Ensures all state variables & temporaries are properly sized.
-    Properly sets all state variables so that GaussianProcess's mean, variance (and gradients thereof) functions can be called.
-
-    .. WARNING::
-         This object's state is INVALIDATED if the gaussian_process used in construction is mutated!
-         SetupState() should be called again in such a situation.
+    Constructs a SparseGaussianProcess object.  All inputs are required; no default constructor nor copy/assignment are allowed.
 
-    .. WARNING::
-         Using this object to compute gradients when ``num_derivatives`` := 0 results in UNDEFINED BEHAVIOR.
+    .. Warning::
+        ``inducing_points`` is not allowed to contain duplicate points.
 
     \param
-      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
-        that describes the underlying GP
-      :points_to_sample[dim][num_to_sample]: points at which to compute GP-derived quantities (mean, variance, etc.)
-      :num_to_sample: number of points being sampled concurrently
-      :num_derivatives: configure this object to compute ``num_derivatives`` derivative terms wrt
-        points_to_sample[:][0:num_derivatives]; 0 means no gradient computation will be performed.
+      :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
+      :points_sampled[dim][num_sampled]: points that have already been sampled
+      :points_sampled_value[num_sampled]: values of the already-sampled points
+      :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value;
+        must be > 0
+      :inducing_points[dim][num_inducing]: the inducing points, ``U``; e.g., a subset of ``points_sampled``
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+      :num_inducing: number of inducing points
+      :approximation_type: which sparse approximation (FITC or VFE) to build
   \endrst*/
-  PointsToSampleState(const GaussianProcess& gaussian_process,
-                      double const * restrict points_to_sample_in,
-                      int num_to_sample_in, int num_derivatives_in) OL_NONNULL_POINTERS;
+  SparseGaussianProcess(const CovarianceInterface& covariance_in,
+                        double const * restrict points_sampled_in,
+                        double const * restrict points_sampled_value_in,
+                        double const * restrict noise_variance_in,
+                        double const * restrict inducing_points_in,
+                        int dim_in, int num_sampled_in, int num_inducing_in,
+                        SparseGaussianProcessTypes approximation_type_in) OL_NONNULL_POINTERS;
 
-  PointsToSampleState(PointsToSampleState&& other);
+  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
 
-  /*!\rst
-    Configures this object with new ``points_to_sample``.
-    Ensures all state variables & temporaries are properly sized.
-    Properly sets all state variables so that GaussianProcess's mean, variance (and gradients thereof) functions can be called.
+  int num_sampled() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return num_sampled_;
+  }
 
-    .. WARNING::
-         This object's state is INVALIDATED if the gaussian_process used in SetupState is mutated!
-         SetupState() should be called again in such a situation.
+  int num_inducing() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return num_inducing_;
+  }
 
-    .. WARNING::
-         Using this object to compute gradients when ``num_derivatives`` := 0 results in UNDEFINED BEHAVIOR.
+  SparseGaussianProcessTypes approximation_type() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return approximation_type_;
+  }
 
-    \param
-      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
-        that describes the underlying GP
-      :points_to_sample[dim][num_to_sample]: points at which to compute GP-derived quantities (mean, variance, etc.)
-      :num_to_sample: number of points being sampled concurrently
-      :num_derivatives: configure this object to compute ``num_derivatives`` derivative terms wrt
-        points_to_sample[:][0:num_derivatives]; 0 means no gradient computation will be performed.
-  \endrst*/
-  void SetupState(const GaussianProcess& gaussian_process, double const * restrict points_to_sample_in,
-                  int num_to_sample_in, int num_derivatives_in) OL_NONNULL_POINTERS;
+  const std::vector<double>& points_sampled() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return points_sampled_;
+  }
 
-  //! spatial dimension (e.g., entries per point of ``points_sampled``)
-  const int dim;
-  //! number of points alerady sampled
-  int num_sampled;
-  //! number of points currently being sampled
-  int num_to_sample;
+  const std::vector<double>& points_sampled_value() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return points_sampled_value_;
+  }
 
-  //! this object can compute ``num_derivatives`` derivative terms wrt
-  //! points_to_sample[:][0:num_derivatives]; 0 means no gradient computation will be performed
-  int num_derivatives;
+  const std::vector<double>& noise_variance() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return noise_variance_;
+  }
 
-  // state variables for predictive component
-  //! points to make predictions about, ``Xs``
-  std::vector<double> points_to_sample;
+  const std::vector<double>& inducing_points() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return inducing_points_;
+  }
 
-  // derived variables for predictive component; these are all *temporary* quantities
-  //! the "mixed" covariance matrix: ``Ks, Ks_{ij}, K(X,Xs) = covariance(X_i, Xs_j)``, covariance matrix between training and test inputs (``num_sampled x num_to_sample``)
-  std::vector<double> K_star;
-  //! the gradient of mixed covariance matrix, ``Ks``, wrt ``Xs``
-  std::vector<double> grad_K_star;
-  //! the variance matrix (output from the GP)
-  std::vector<double> V;
-  //! ``K^{-1} Ks`` (computed without taking an inverse)
-  std::vector<double> K_inv_times_K_star;
-  //! the gradient of covariance(x_1, x_2) wrt x_1
-  std::vector<double> grad_cov;
+  //! \return id of the current (points_sampled, hyperparameters); see GaussianProcess::generation()
+  std::uint64_t generation() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return generation_;
+  }
 
-  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(PointsToSampleState);
-};
+  /*!\rst
+    Change the hyperparameters of this GP's covariance function.
+    Also forces recomputation of all derived quantities for GP to remain consistent.
 
-struct ExpectedImprovementState;
-struct OnePotentialSampleExpectedImprovementState;
+    .. WARNING::
+         Using this function invalidates any PointsToSampleState objects created with "this" object.
+         For any such objects "state", call state.SetupState(...) to restore them.  (UpdateMovingPoints() detects
+         the change through generation() and recomputes everything.)
 
-/*!\rst
-  A class to encapsulate the computation of expected improvement and its spatial gradient. This class handles the
-  general EI computation case using monte carlo integration; it can support q,p-EI optimization. It is designed to work
-  with any GaussianProcess.  Additionally, this class has no state and within the context of EI optimization, it is
-  meant to be accessed by const reference only.
+    \param
+      :hyperparameters_new[covariance_ptr->GetNumberOfHyperparameters]: new hyperparameter array
+  \endrst*/
+  void SetCovarianceHyperparameters(double const * restrict hyperparameters_new) OL_NONNULL_POINTERS {
+    covariance_ptr_->SetHyperparameters(hyperparameters_new);
+    generation_ = NewGaussianProcessGeneration();
+    RecomputeDerivedVariables();
+  }
 
-  The random numbers needed for EI computation will be passed as parameters instead of contained as members to make
-  multithreading more straightforward.
-\endrst*/
-class ExpectedImprovementEvaluator final {
- public:
-  using StateType = ExpectedImprovementState;
   /*!\rst
-    Constructs a ExpectedImprovementEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
+    Sets up the PointsToSampleState object so that it can be used to compute GP mean, variance, and gradients thereof.
+    ASSUMES all needed space is ALREADY ALLOCATED.  Columns of the last ``points_to_sample_state->num_cached``
+    points are assumed up to date and skipped.
+
+    This function should not be called directly; instead use PointsToSampleState::SetupState().
 
     \param
-      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
-        that describes the underlying GP
-      :num_mc_iterations: number of monte carlo iterations
-      :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
+      :points_to_sample_state[1]: pointer to a PointsToSampleState object where all space has been properly allocated
+    \output
+      :points_to_sample_state[1]: pointer to a fully configured PointsToSampleState object. overwrites input
   \endrst*/
-  ExpectedImprovementEvaluator(const GaussianProcess& gaussian_process_in, int num_mc_iterations, double best_so_far);
-
-  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
-    return dim_;
-  }
-
-  const GaussianProcess * gaussian_process() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
-    return gaussian_process_;
-  }
+  void FillPointsToSampleState(StateType * points_to_sample_state) const OL_NONNULL_POINTERS;
 
   /*!\rst
-    Wrapper for ComputeExpectedImprovement(); see that function for details.
+    Computes the mean of this GP at each of ``Xs`` (``points_to_sample``); see GaussianProcess::ComputeMeanOfPoints().
+
+    \param
+      :points_to_sample_state: a FULLY CONFIGURED PointsToSampleState (configure via PointsToSampleState::SetupState)
+    \output
+      :mean_of_points[num_to_sample]: mean of GP, one per GP dimension
   \endrst*/
-  double ComputeObjectiveFunction(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT {
-    return ComputeExpectedImprovement(ei_state);
-  }
+  void ComputeMeanOfPoints(const StateType& points_to_sample_state,
+                           double * restrict mean_of_points) const noexcept OL_NONNULL_POINTERS;
 
   /*!\rst
-    Wrapper for ComputeGradExpectedImprovement(); see that function for details.
+    Computes the gradient of the mean of this GP at each of ``Xs`` (``points_to_sample``) wrt ``Xs``;
+    see GaussianProcess::ComputeGradMeanOfPoints().
+
+    \param
+      :points_to_sample_state: a FULLY CONFIGURED PointsToSampleState (configure via PointsToSampleState::SetupState)
+    \output
+      :grad_mu[dim][state.num_derivatives]: gradient of the mean of the GP.  ``grad_mu[d][i]`` is
+        actually the gradient of ``\mu_i`` with respect to ``x_{d,i}``, the d-th dimension of
+        the i-th entry of ``points_to_sample``.
   \endrst*/
-  void ComputeGradObjectiveFunction(StateType * ei_state, double * restrict grad_EI) const OL_NONNULL_POINTERS {
-    ComputeGradExpectedImprovement(ei_state, grad_EI);
-  }
+  void ComputeGradMeanOfPoints(const StateType& points_to_sample_state,
+                               double * restrict grad_mu) const noexcept OL_NONNULL_POINTERS;
 
   /*!\rst
-    Computes the expected improvement ``EI(Xs) = E_n[[f^*_n(X) - min(f(Xs_1),...,f(Xs_m))]^+]``, where ``Xs``
-    are potential points to sample (union of ``points_to_sample`` and ``points_being_sampled``) and ``X`` are
-    already sampled points.  The ``^+`` indicates that the expression in the expectation evaluates to 0 if it
-    is negative.  ``f^*(X)`` is the MINIMUM over all known function evaluations (``points_sampled_value``),
-    whereas ``f(Xs)`` are *GP-predicted* function evaluations.
+    Computes the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``);
+    see GaussianProcess::ComputeVarianceOfPoints().
 
-    ``points_to_sample`` is the "q" and ``points_being_sampled`` is the "p" in q,p-EI.
+    \param
+      :points_to_sample_state[1]: ptr to a FULLY CONFIGURED PointsToSampleState (configure via PointsToSampleState::SetupState)
+    \output
+      :points_to_sample_state[1]: ptr to a FULLY CONFIGURED PointsToSampleState; only temporary state may be mutated
+      :var_star[num_to_sample][num_to_sample]: variance of GP evaluated at ``points_to_sample``
+  \endrst*/
+  void ComputeVarianceOfPoints(StateType * points_to_sample_state,
+                               double * restrict var_star) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Computes the mean and the marginal variance of this GP at each point of ``Xs`` (``points_to_sample``);
+    see GaussianProcess::ComputeMeanAndMarginalVarianceOfPoints().  Costs ``O(M^2)`` per point.
+
+    \param
+      :points_to_sample[dim][num_to_sample]: points at which to evaluate the GP mean and variance
+      :num_to_sample: number of points in ``points_to_sample``
+    \output
+      :mean_of_points[num_to_sample]: mean of GP evaluated at each point of ``points_to_sample``
+      :variance_of_points[num_to_sample]: variance of GP evaluated at each point of ``points_to_sample``
+  \endrst*/
+  void ComputeMeanAndMarginalVarianceOfPoints(double const * restrict points_to_sample, int num_to_sample,
+                                              double * restrict mean_of_points,
+                                              double * restrict variance_of_points) const OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Similar to ComputeGradCholeskyVarianceOfPoints() except this does not include the gradient terms from
+    the cholesky factorization.  Description will not be duplicated here.
+  \endrst*/
+  void ComputeGradVarianceOfPoints(StateType * points_to_sample_state,
+                                   double * restrict grad_var) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Computes the gradient of the cholesky factorization of the variance of this GP with respect to ``points_to_sample``;
+    see GaussianProcess::ComputeGradCholeskyVarianceOfPoints().
+
+    \param
+      :points_to_sample_state[1]: ptr to a FULLY CONFIGURED PointsToSampleState (configure via PointsToSampleState::SetupState)
+      :chol_var[num_to_sample][num_to_sample]: the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``)
+        e.g., from the cholesky factorization of ``ComputeVarianceOfPoints``
+    \output
+      :points_to_sample_state[1]: ptr to a FULLY CONFIGURED PointsToSampleState; only temporary state may be mutated
+      :grad_chol[dim][num_to_sample][num_to_sample][state->num_derivatives]: gradient of the cholesky-factored
+        variance of the GP.  ``grad_chol[d][i][j][k]`` is actually the gradients of ``var_{i,j}`` with
+        respect to ``x_{d,k}``, the d-th dimension of the k-th entry of ``points_to_sample``
+  \endrst*/
+  void ComputeGradCholeskyVarianceOfPoints(StateType * points_to_sample_state,
+                                           double const * restrict chol_var,
+                                           double * restrict grad_chol) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Clones "this" SparseGaussianProcess.  As with GaussianProcess::Clone(), the cholesky factors are shared with the
+    clone until either one is modified.
+
+    \return
+      Pointer to a constructed object that is a copy of "this"
+  \endrst*/
+  SparseGaussianProcess * Clone() const OL_WARN_UNUSED_RESULT;
+
+  OL_DISALLOW_DEFAULT_AND_ASSIGN(SparseGaussianProcess);
+
+ protected:
+  explicit SparseGaussianProcess(const SparseGaussianProcess& source);
+
+ private:
+  /*!\rst
+    Recomputes (including resizing as needed) the derived quantities in this class.
+    This function should be called any time state variables are changed.
+  \endrst*/
+  void RecomputeDerivedVariables();
+
+  // size information
+  //! spatial dimension (e.g., entries per point of ``points_sampled``)
+  int dim_;
+  //! number of points in ``points_sampled``
+  int num_sampled_;
+  //! number of points in ``inducing_points``
+  int num_inducing_;
+  //! the sparse approximation (determines ``\Lambda``)
+  SparseGaussianProcessTypes approximation_type_;
+
+  // state variables for prior
+  //! covariance class (for computing covariance and its gradients)
+  std::unique_ptr<CovarianceInterface> covariance_ptr_;
+  //! coordinates of already-sampled points, ``X``
+  std::vector<double> points_sampled_;
+  //! function values at points_sampled, ``y``
+  std::vector<double> points_sampled_value_;
+  //! ``\sigma_n^2``, the noise variance
+  std::vector<double> noise_variance_;
+  //! coordinates of the inducing points, ``U``
+  std::vector<double> inducing_points_;
+
+  // derived variables for prior
+  //! cholesky factorization of ``Ku = K(U,U)`` (plus jitter); shared with clones (copy-on-write)
+  std::shared_ptr<std::vector<double> > K_uu_chol_;
+  //! cholesky factorization of ``B = I + A * A^T``, ``A = Lu^{-1} * Kuf * \Lambda^{-1/2}`` (``Lu`` = K_uu_chol_);
+  //! shared with clones (copy-on-write)
+  std::shared_ptr<std::vector<double> > B_chol_;
+  //! ``\Sigma * Kuf * \Lambda^{-1} * y``; plays the role of GaussianProcess's ``K^-1 * y``
+  std::vector<double> weights_;
+  //! id of the current state & derived variables; see generation()
+  std::uint64_t generation_;
+};
+
+/*!\rst
+  Computes the mean and the marginal variance (the diagonal of the posterior covariance) of a GP at each of a large list
+  of points (e.g., the 10^5 - 10^6 points of a plotting grid), treating the points independently.
+
+  ComputeVarianceOfPoints() builds the full ``num_points x num_points`` covariance (and PointsToSampleState sizes
+  ``K_star`` and ``V`` for all points at once).  Instead, points are processed in chunks of
+  MarginalPredictionChunkSize() points by GaussianProcessType::ComputeMeanAndMarginalVarianceOfPoints(), with OpenMP
+  threads splitting the chunks.  Each thread needs ``O(num_sampled * chunk_size)`` temporary storage (from its
+  ScratchArena), independent of ``num_points``.
+
+  Results match ComputeMeanOfPoints() and the diagonal of ComputeVarianceOfPoints() up to roundoff, and do not depend
+  on the number of threads.
+
+  \param
+    :gaussian_process: GaussianProcess or SparseGaussianProcess to evaluate
+    :thread_schedule: struct instructing OpenMP on how to schedule threads; i.e., (suggestions in parens)
+      max_num_threads (num cpu cores), schedule type (omp_sched_static), chunk_size (0).
+    :points_to_sample[dim][num_points]: points at which to evaluate the GP mean and variance
+    :num_points: number of points in ``points_to_sample``
+  \output
+    :mean_of_points[num_points]: mean of GP evaluated at each point of ``points_to_sample``
+    :variance_of_points[num_points]: variance of GP evaluated at each point of ``points_to_sample``
+\endrst*/
+template <typename GaussianProcessType>
+void ComputeMeanAndMarginalVarianceOfPointList(const GaussianProcessType& gaussian_process,
+                                               const ThreadSchedule& thread_schedule,
+                                               double const * restrict points_to_sample, int num_points,
+                                               double * restrict mean_of_points,
+                                               double * restrict variance_of_points) OL_NONNULL_POINTERS;
+
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template void ComputeMeanAndMarginalVarianceOfPointList(
+    const GaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict points_to_sample, int num_points, double * restrict mean_of_points,
+    double * restrict variance_of_points);
+extern template void ComputeMeanAndMarginalVarianceOfPointList(
+    const SparseGaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict points_to_sample, int num_points, double * restrict mean_of_points,
+    double * restrict variance_of_points);
+
+/*!\rst
+  Number of points per chunk in ComputeMeanAndMarginalVarianceOfPointList().  Chunks are sized so that the
+  ``num_sampled x chunk_size`` covariance block fits in (L2) cache, but hold at least 64 points: every chunk streams
+  the cholesky factor of ``K`` once, so very small chunks would be dominated by that for large ``num_sampled``.
+
+  \param
+    :num_sampled: number of sampled points in the GP
+  \return
+    number of points per chunk, in ``[64, 1024]``
+\endrst*/
+int MarginalPredictionChunkSize(int num_sampled) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT;
+
+/*!\rst
+  This object holds the state needed for a GaussianProcess object characterize the distribution of function values arising from
+  sampling the GP at a list of ``points_to_sample``.  This object is required by the GaussianProcess to access functionality for
+  computing the mean, variance, and spatial gradients thereof.
+
+  The "independent variables" for this object are ``points_to_sample``. These points are both the "p" and the "q" in q,p-EI;
+  i.e., they are the parameters of both ongoing experiments and new predictions. Recall that in q,p-EI, the q points are
+  called ``points_to_sample`` and the p points are called ``points_being_sampled.`` Here, we need to make predictions about
+  both point sets with the GP, so we simply call the union of point sets ``points_to_sample.``
+
+  In GP computations, there is really no distinction between the "q" and "p" points from EI, ``points_to_sample`` and
+  ``points_being_sampled``, respectively. However, in EI optimization, we only need gradients of GP quantities wrt
+  ``points_to_sample``, so users should build PointsToSampleState() with ``num_derivatives = num_to_sample``.
+
+  Once constructed, this object provides the SetupState() function to update it for computations at different sets of
+  potential points to sample.
+
+  During EI optimization, only the "q" points move; ``points_being_sampled`` stay put.  Constructing with ``num_fixed``
+  (the trailing ``points_being_sampled``) and then calling UpdateMovingPoints() each step reuses the fixed points'
+  columns of ``K_star`` and the (expensive) solves against them instead of recomputing them every step.
+
+  This object also serves SparseGaussianProcess; then the role of ``points_sampled`` is played by the inducing points
+  (so e.g., ``num_sampled`` is the number of inducing points).
+
+  See general comments on State structs in ``gpp_common.hpp``'s header docs.
+\endrst*/
+struct PointsToSampleState final {
+  /*!\rst
+    Constructs a PointsToSampleState object with new ``points_to_sample``.
+    Ensures all state variables & temporaries are properly sized.
+    Properly sets all state variables so that GaussianProcess's mean, variance (and gradients thereof) functions can be called.
+
+    .. WARNING::
+         This object's state is INVALIDATED if the gaussian_process used in construction is mutated!
+         SetupState() should be called again in such a situation.
+
+    .. WARNING::
+         Using this object to compute gradients when ``num_derivatives`` := 0 results in UNDEFINED BEHAVIOR.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :points_to_sample[dim][num_to_sample]: points at which to compute GP-derived quantities (mean, variance, etc.)
+      :num_to_sample: number of points being sampled concurrently
+      :num_derivatives: configure this object to compute ``num_derivatives`` derivative terms wrt
+        points_to_sample[:][0:num_derivatives]; 0 means no gradient computation will be performed.
+  \endrst*/
+  PointsToSampleState(const GaussianProcess& gaussian_process,
+                      double const * restrict points_to_sample_in,
+                      int num_to_sample_in, int num_derivatives_in) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Constructs a PointsToSampleState object for use with a SparseGaussianProcess; see the GaussianProcess overload.
+  \endrst*/
+  PointsToSampleState(const SparseGaussianProcess& gaussian_process,
+                      double const * restrict points_to_sample_in,
+                      int num_to_sample_in, int num_derivatives_in) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Constructs a PointsToSampleState object whose last ``num_fixed`` points_to_sample do not move between calls to
+    UpdateMovingPoints() (e.g., ``points_being_sampled`` in q,p-EI).  Their columns of ``K_star``, ``K_inv_times_K_star``
+    (and ``V``) are computed once here and on every SetupState(), then reused.
+
+    \param
+      :gaussian_process: GaussianProcess object that describes the underlying GP
+      :points_to_sample[dim][num_to_sample]: points at which to compute GP-derived quantities; the last ``num_fixed``
+        are the fixed points
+      :num_to_sample: number of points being sampled concurrently (moving + fixed)
+      :num_derivatives: configure this object to compute ``num_derivatives`` derivative terms wrt
+        points_to_sample[:][0:num_derivatives]; ``num_derivatives <= num_to_sample - num_fixed``
+      :num_fixed: number of (trailing) fixed points; ``0 <= num_fixed <= num_to_sample``
+  \endrst*/
+  PointsToSampleState(const GaussianProcess& gaussian_process,
+                      double const * restrict points_to_sample_in,
+                      int num_to_sample_in, int num_derivatives_in, int num_fixed_in) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Constructs a PointsToSampleState object with ``num_fixed`` cached points for use with a SparseGaussianProcess;
+    see the GaussianProcess overload.
+  \endrst*/
+  PointsToSampleState(const SparseGaussianProcess& gaussian_process,
+                      double const * restrict points_to_sample_in,
+                      int num_to_sample_in, int num_derivatives_in, int num_fixed_in) OL_NONNULL_POINTERS;
+
+  PointsToSampleState(PointsToSampleState&& other);
+
+  /*!\rst
+    Configures this object with new ``points_to_sample``.
+    Ensures all state variables & temporaries are properly sized.
+    Properly sets all state variables so that GaussianProcess's mean, variance (and gradients thereof) functions can be called.
+
+    .. WARNING::
+         This object's state is INVALIDATED if the gaussian_process used in SetupState is mutated!
+         SetupState() should be called again in such a situation.
+
+    .. WARNING::
+         Using this object to compute gradients when ``num_derivatives`` := 0 results in UNDEFINED BEHAVIOR.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :points_to_sample[dim][num_to_sample]: points at which to compute GP-derived quantities (mean, variance, etc.)
+      :num_to_sample: number of points being sampled concurrently
+      :num_derivatives: configure this object to compute ``num_derivatives`` derivative terms wrt
+        points_to_sample[:][0:num_derivatives]; 0 means no gradient computation will be performed.
+  \endrst*/
+  void SetupState(const GaussianProcess& gaussian_process, double const * restrict points_to_sample_in,
+                  int num_to_sample_in, int num_derivatives_in) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Configures this object with new ``points_to_sample`` for use with a SparseGaussianProcess; see the GaussianProcess overload.
+  \endrst*/
+  void SetupState(const SparseGaussianProcess& gaussian_process, double const * restrict points_to_sample_in,
+                  int num_to_sample_in, int num_derivatives_in) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Replaces the first ``num_to_sample - num_fixed`` (moving) points of ``points_to_sample`` and updates only the
+    derived quantities that depend on them: ``O(N*(q-f)*d)`` covariance work plus ``O(N^2*(q-f))`` for the solves,
+    instead of ``O(N*q*d)`` and ``O(N^2*q)`` (``q = num_to_sample, f = num_fixed``).  The fixed points' quantities
+    are reused from the last SetupState() (or construction); with ``num_fixed = 0``, this is just SetupState() with
+    the same sizes.
+
+    If ``gaussian_process`` is not the GP (with the same generation()) used in the last fill, e.g., because it was
+    mutated by AddPointsToGP() or SetCovarianceHyperparameters(), the fixed points' quantities are recomputed too.
+
+    \param
+      :gaussian_process: GaussianProcess object that describes the underlying GP
+      :points_to_sample_moving[dim][num_to_sample - num_fixed]: new values of the moving points
+  \endrst*/
+  void UpdateMovingPoints(const GaussianProcess& gaussian_process,
+                          double const * restrict points_to_sample_moving) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Updates the moving points for use with a SparseGaussianProcess; see the GaussianProcess overload.
+  \endrst*/
+  void UpdateMovingPoints(const SparseGaussianProcess& gaussian_process,
+                          double const * restrict points_to_sample_moving) OL_NONNULL_POINTERS;
+
+  //! spatial dimension (e.g., entries per point of ``points_sampled``)
+  const int dim;
+  //! number of points alerady sampled (number of inducing points for SparseGaussianProcess)
+  int num_sampled;
+  //! number of points currently being sampled
+  int num_to_sample;
+
+  //! this object can compute ``num_derivatives`` derivative terms wrt
+  //! points_to_sample[:][0:num_derivatives]; 0 means no gradient computation will be performed
+  int num_derivatives;
+  //! number of trailing points of ``points_to_sample`` that are fixed across UpdateMovingPoints() calls
+  int num_fixed;
+  //! number of trailing points whose columns of ``K_star``, ``K_inv_times_K_star`` (and ``V``) are up to date;
+  //! either 0 (everything is recomputed on the next fill) or ``num_fixed``
+  int num_cached;
+  //! generation() of the GP this state was last filled by; the cached columns are only valid for that generation
+  std::uint64_t gaussian_process_generation;
+
+  // state variables for predictive component
+  //! points to make predictions about, ``Xs``
+  std::vector<double> points_to_sample;
+
+  // derived variables for predictive component; these are all *temporary* quantities
+  //! the "mixed" covariance matrix: ``Ks, Ks_{ij}, K(X,Xs) = covariance(X_i, Xs_j)``, covariance matrix between training and test inputs (``num_sampled x num_to_sample``)
+  std::vector<double> K_star;
+  //! the gradient of mixed covariance matrix, ``Ks``, wrt ``Xs``
+  std::vector<double> grad_K_star;
+  //! the variance matrix (output from the GP)
+  std::vector<double> V;
+  //! ``K^{-1} Ks`` (computed without taking an inverse; ``[Ku^{-1} - \Sigma] Ks`` for SparseGaussianProcess)
+  std::vector<double> K_inv_times_K_star;
+  //! the gradient of covariance(x_1, x_2) wrt x_1
+  std::vector<double> grad_cov;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(PointsToSampleState);
+
+ private:
+  /*!\rst
+    Resizes the state variables & temporaries for the given problem size and invalidates the cached
+    fixed-point quantities.  Shared by the SetupState() and UpdateMovingPoints() overloads, which then have the GP
+    fill in the derived quantities.
+
+    \param
+      :num_sampled_in: number of points the GP conditions on (sampled points or inducing points)
+      :num_to_sample: number of points being sampled concurrently
+      :num_derivatives: number of derivative terms to configure for
+  \endrst*/
+  void ResizeState(int num_sampled_in, int num_to_sample_in, int num_derivatives_in);
+};
+
+template <typename GaussianProcessType> struct BasicExpectedImprovementState;
+template <typename GaussianProcessType> struct BasicAnalyticExpectedImprovementState;
+template <typename GaussianProcessType> struct BasicOnePotentialSampleExpectedImprovementState;
+
+//! Number of monte-carlo draws ExpectedImprovementEvaluator processes together.  Each batch is stored draw-fastest,
+//! so the ``L * w`` products and the improvement max/sum are unit-stride loops over 64 draws (which the compiler
+//! vectorizes) instead of loops over the (usually tiny) ``num_union``.
+static constexpr int kEIMonteCarloBatchSize = 64;
+
+//! Number of pseudo-random monte-carlo iterations ExpectedImprovementEvaluator sums as one unit (and hands to the
+//! task pool as one nested task).  Chunk sums always start from 0 and are added in chunk order, so the result is the
+//! same with or without a task pool, and for any number of workers.
+static constexpr int kEIMonteCarloChunkSize = 8*kEIMonteCarloBatchSize;
+
+/*!\rst
+  Enum for the source of the ``num_union``-dimensional normal vectors ``w`` that ExpectedImprovementEvaluator
+  integrates over (see ExpectedImprovementEvaluator::ComputeExpectedImprovement()).
+\endrst*/
+enum class MonteCarloIntegrationTypes {
+  //! plain monte-carlo: IID pseudo-random normals from the state's ``normal_rng``
+  kPseudoRandom = 0,
+  //! randomized quasi-monte-carlo: digitally shifted Sobol points (SobolNormalRNG), shifts drawn from ``normal_rng``
+  kQuasiRandom = 1,
+};
+
+/*!\rst
+  Enum for how the EI optimizers (ComputeOptimalPointsToSample() and friends, EvaluateEIAtPointList()) compute q,p-EI
+  when ``num_to_sample + num_being_sampled > 1``.  (1,0-EI always has a closed form and ignores this.)
+\endrst*/
+enum class ExpectedImprovementEvaluationTypes {
+  //! monte-carlo integration (ExpectedImprovementEvaluator), with ``max_int_steps`` and ``integration_type``
+  kMonteCarlo = 0,
+  //! multivariate normal CDFs (AnalyticExpectedImprovementEvaluator) if ``num_to_sample + num_being_sampled <=
+  //! kMaxMultivariateNormalCDFDim``; monte-carlo as with kMonteCarlo for larger problems
+  kAnalytic = 1,
+};
+
+//! Number of independent groups the MC iterations are split into for error estimation.  With
+//! MonteCarloIntegrationTypes::kQuasiRandom, each group is an independently shifted Sobol sequence (so
+//! ``num_mc_iterations`` should be a multiple of ``kNumMonteCarloErrorGroups * 2^k`` for best accuracy).
+static constexpr int kNumMonteCarloErrorGroups = 8;
+
+/*!\rst
+  A class to encapsulate the computation of expected improvement and its spatial gradient. This class handles the
+  general EI computation case using monte carlo integration; it can support q,p-EI optimization. It is designed to work
+  with any GaussianProcess.  Additionally, this class has no state and within the context of EI optimization, it is
+  meant to be accessed by const reference only.
+
+  Like the other EI evaluators, this class is templated on the type of GP: GaussianProcess or SparseGaussianProcess
+  (anything with the same mean/variance/gradient API and ``StateType``).  ExpectedImprovementEvaluator names the
+  GaussianProcess version.
+
+  The random numbers needed for EI computation will be passed as parameters instead of contained as members to make
+  multithreading more straightforward.
+
+  .. Note:: with a counter-based ``normal_rng`` (PhiloxNormalRNG), every evaluation starts from MC iteration 0 of the
+    state's stream (see ExpectedImprovementState::SetMonteCarloIteration()).  So repeated evaluations with the same
+    state reuse the same normal draws (common random numbers) instead of taking fresh, independent draws as a
+    sequential generator (NormalRNG) does.  EI and its gradient are then deterministic functions of the points to
+    sample, which makes optimization steps comparable and results independent of threading; but the MC error is
+    shared by all evaluations along an optimization path instead of averaging out.  Different multistarts use
+    different streams, so their errors remain independent.  Pass a NormalRNG for independent draws per evaluation.
+\endrst*/
+template <typename GaussianProcessType>
+class BasicExpectedImprovementEvaluator final {
+ public:
+  using StateType = BasicExpectedImprovementState<GaussianProcessType>;
+  /*!\rst
+    Constructs a ExpectedImprovementEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :num_mc_iterations: number of monte carlo iterations
+      :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
+  \endrst*/
+  BasicExpectedImprovementEvaluator(const GaussianProcessType& gaussian_process_in, int num_mc_iterations,
+                                    double best_so_far);
+
+  /*!\rst
+    Constructs a ExpectedImprovementEvaluator object that integrates with the specified type of sample points.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :num_mc_iterations: number of monte carlo iterations
+      :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
+      :integration_type: pseudo-random (plain MC) or quasi-random (randomized QMC) sample points
+  \endrst*/
+  BasicExpectedImprovementEvaluator(const GaussianProcessType& gaussian_process_in, int num_mc_iterations,
+                                    double best_so_far, MonteCarloIntegrationTypes integration_type);
+
+  /*!\rst
+    Constructs a ExpectedImprovementEvaluator object that splits its pseudo-random MC iterations into chunks of
+    kEIMonteCarloChunkSize and runs them as nested tasks on ``task_pool``.  Chunks only go to the pool for states whose
+    ``normal_rng`` is a PhiloxNormalRNG (each chunk then positions its own copy of the generator); other states run the
+    chunks in order on the calling thread.  Either way the result is bitwise the same.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :num_mc_iterations: number of monte carlo iterations
+      :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
+      :integration_type: pseudo-random (plain MC) or quasi-random (randomized QMC) sample points
+      :task_pool[1]: pool to run chunks of MC iterations on; nullptr to always run them on the calling thread.
+        Must outlive this object.
+  \endrst*/
+  BasicExpectedImprovementEvaluator(const GaussianProcessType& gaussian_process_in, int num_mc_iterations,
+                                    double best_so_far, MonteCarloIntegrationTypes integration_type,
+                                    WorkStealingTaskPool * task_pool);
+
+  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  MonteCarloIntegrationTypes integration_type() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return integration_type_;
+  }
+
+  const GaussianProcessType * gaussian_process() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return gaussian_process_;
+  }
+
+  WorkStealingTaskPool * task_pool() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return task_pool_;
+  }
+
+  /*!\rst
+    Wrapper for ComputeExpectedImprovement(); see that function for details.
+  \endrst*/
+  double ComputeObjectiveFunction(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT {
+    return ComputeExpectedImprovement(ei_state);
+  }
+
+  /*!\rst
+    Wrapper for ComputeGradExpectedImprovement(); see that function for details.
+  \endrst*/
+  void ComputeGradObjectiveFunction(StateType * ei_state, double * restrict grad_EI) const OL_NONNULL_POINTERS {
+    ComputeGradExpectedImprovement(ei_state, grad_EI);
+  }
+
+  /*!\rst
+    Computes the expected improvement ``EI(Xs) = E_n[[f^*_n(X) - min(f(Xs_1),...,f(Xs_m))]^+]``, where ``Xs``
+    are potential points to sample (union of ``points_to_sample`` and ``points_being_sampled``) and ``X`` are
+    already sampled points.  The ``^+`` indicates that the expression in the expectation evaluates to 0 if it
+    is negative.  ``f^*(X)`` is the MINIMUM over all known function evaluations (``points_sampled_value``),
+    whereas ``f(Xs)`` are *GP-predicted* function evaluations.
+
+    ``points_to_sample`` is the "q" and ``points_being_sampled`` is the "p" in q,p-EI.
+
+    In words, we are computing the expected improvement (over the current ``best_so_far``, best known
+    objective function value) that would result from sampling (aka running new experiments) at
+    ``points_to_sample`` with ``points_being_sampled`` concurrent/ongoing experiments.
+
+    In general, the EI expression is complex and difficult to evaluate; hence we use Monte-Carlo simulation to approximate it.
+    When faster (e.g., analytic) techniques are available, we will prefer them.
+
+    The idea of the MC approach is to repeatedly sample at the union of ``points_to_sample`` and
+    ``points_being_sampled``. This is analogous to gaussian_process_interface.sample_point_from_gp,
+    but we sample ``num_union`` points at once:
+
+    ``y = \mu + Lw``
+
+    where ``\mu`` is the GP-mean, ``L`` is the ``chol_factor(GP-variance)`` and ``w`` is a vector
+    of ``num_union`` draws from N(0, 1). Then:
+
+    ``improvement_per_step = max(max(best_so_far - y), 0.0)``
+
+    Observe that the inner ``max`` means only the smallest component of ``y`` contributes in each iteration.
+    We compute the improvement over many random draws and average.
+
+    With MonteCarloIntegrationTypes::kQuasiRandom, the ``w`` are instead inverse-normal-transformed points of
+    kNumMonteCarloErrorGroups independently shifted Sobol sequences, and the result is the average over all of them.
+
+    .. Note:: These comments were copied into ExpectedImprovementInterface.compute_expected_improvement() in interfaces/expected_improvement_interface.py.
+
+    \param
+      :ei_state[1]: properly configured state object
+    \output
+      :ei_state[1]: state with temporary storage modified; ``normal_rng`` modified
+    \return
+      the expected improvement from sampling ``points_to_sample`` with ``points_being_sampled`` concurrent experiments
+  \endrst*/
+  double ComputeExpectedImprovement(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
+  /*!\rst
+    Computes the expected improvement (as in ComputeExpectedImprovement()) along with an estimate of the standard error
+    of the result.  The ``num_mc_iterations`` draws are split into ``G = min(kNumMonteCarloErrorGroups, num_mc_iterations)``
+    groups whose means are IID (independent shifts for quasi-random integration; disjoint blocks of IID draws for
+    pseudo-random integration), and the standard error is the sample standard deviation of the group means over
+    ``\sqrt{G}``.
+
+    For quasi-random integration, the estimate is identical to ComputeExpectedImprovement() given the same
+    ``normal_rng`` state.  For pseudo-random integration, it uses the same draws but may differ in the last bits
+    (the sum is grouped differently).
+
+    \param
+      :ei_state[1]: properly configured state object
+    \output
+      :ei_state[1]: state with temporary storage modified; ``normal_rng`` modified
+      :standard_error[1]: estimated standard error of the returned EI; infinity if ``G < 2``
+    \return
+      the expected improvement from sampling ``points_to_sample`` with ``points_being_sampled`` concurrent experiments
+  \endrst*/
+  double ComputeExpectedImprovementWithErrorEstimate(StateType * ei_state, double * restrict standard_error) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
+  /*!\rst
+    Computes the (partial) derivatives of the expected improvement with respect to each point of ``points_to_sample``.
+    As with ComputeExpectedImprovement(), this computation accounts for the effect of ``points_being_sampled``
+    concurrent experiments.
+
+    ``points_to_sample`` is the "q" and ``points_being_sampled`` is the "p" in q,p-EI..
+
+    In general, the expressions for gradients of EI are complex and difficult to evaluate; hence we use
+    Monte-Carlo simulation to approximate it. When faster (e.g., analytic) techniques are available, we will prefer them.
+
+    The MC computation of grad EI is similar to the computation of EI (decsribed in
+    compute_expected_improvement). We differentiate ``y = \mu + Lw`` wrt ``points_to_sample``;
+    only terms from the gradient of ``\mu`` and ``L`` contribute. In EI, we computed:
+
+    ``improvement_per_step = max(max(best_so_far - y), 0.0)``
+
+    and noted that only the smallest component of ``y`` may contribute (if it is > 0.0).
+    Call this index ``winner``. Thus in computing grad EI, we only add gradient terms
+    that are attributable to the ``winner``-th component of ``y``.
+
+    .. Note:: These comments were copied into ExpectedImprovementInterface.compute_expected_improvement() in interfaces/expected_improvement_interface.py.
+
+    \param
+      :ei_state[1]: properly configured state object
+    \output
+      :ei_state[1]: state with temporary storage modified; ``normal_rng`` modified
+      :grad_EI[dim][num_to_sample]: gradient of EI, ``\pderiv{EI(Xq \cup Xp)}{Xq_{d,i}}`` where ``Xq`` is ``points_to_sample``
+          and ``Xp`` is ``points_being_sampled`` (grad EI from sampling ``points_to_sample`` with
+          ``points_being_sampled`` concurrent experiments wrt each dimension of the points in ``points_to_sample``)
+  \endrst*/
+  void ComputeGradExpectedImprovement(StateType * ei_state, double * restrict grad_EI) const OL_NONNULL_POINTERS;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicExpectedImprovementEvaluator);
+
+ private:
+  /*!\rst
+    Sets up the GP mean and the cholesky factor of the GP variance at ``union_of_points`` (in ``ei_state``).
+
+    \param
+      :ei_state[1]: properly configured state object
+    \output
+      :ei_state[1]: ``to_sample_mean`` and ``cholesky_to_sample_var`` are set
+  \endrst*/
+  void ComputeMeanAndCholeskyVariance(StateType * ei_state) const OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Sums the improvement over ``num_iterations`` MC iterations drawn from ``normal_rng``.
+    Requires ComputeMeanAndCholeskyVariance().
+
+    \param
+      :ei_state: state object with mean and cholesky factor of the variance set up
+      :num_iterations: number of MC iterations
+      :normal_rng[1]: source of the normal vectors ``w``
+    \output
+      :normal_rng[1]: rng advanced by ``num_union * num_iterations`` draws
+    \return
+      the sum of the improvement over all iterations
+  \endrst*/
+  double AccumulateImprovement(const StateType& ei_state, int num_iterations, NormalRNGInterface * normal_rng) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
+  /*!\rst
+    Sums the improvement over all ``num_mc_iterations`` pseudo-random MC iterations, in chunks of
+    kEIMonteCarloChunkSize (on ``task_pool_`` if possible).  Requires ComputeMeanAndCholeskyVariance().
+
+    \param
+      :ei_state[1]: state object with mean and cholesky factor of the variance set up
+    \output
+      :ei_state[1]: ``normal_rng`` advanced if the chunks ran on the calling thread
+    \return
+      the sum of the improvement over all iterations
+  \endrst*/
+  double AccumulateImprovementInChunks(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
+  /*!\rst
+    Adds the (unnormalized) gradient of the improvement over ``num_iterations`` MC iterations drawn from ``normal_rng``
+    to ``aggregate``.  Requires ComputeMeanAndCholeskyVariance() and the gradients of the GP mean and of the
+    cholesky factor of the variance.
+
+    \param
+      :ei_state: state object with means, variance factors, and their gradients set up
+      :num_iterations: number of MC iterations
+      :normal_rng[1]: source of the normal vectors ``w``
+      :aggregate[dim][num_to_sample]: gradient accumulated so far
+    \output
+      :normal_rng[1]: rng advanced by ``num_union * num_iterations`` draws
+      :aggregate[dim][num_to_sample]: gradient of these iterations added
+  \endrst*/
+  void AccumulateGradImprovement(const StateType& ei_state, int num_iterations, NormalRNGInterface * normal_rng,
+                                 double * restrict aggregate) const OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Gradient counterpart of AccumulateImprovementInChunks(): adds the (unnormalized) gradient of the improvement over
+    all ``num_mc_iterations`` pseudo-random MC iterations to ``ei_state->aggregate``.
+
+    \param
+      :ei_state[1]: state object with means, variance factors, and their gradients set up
+    \output
+      :ei_state[1]: ``aggregate`` updated; ``normal_rng`` advanced if the chunks ran on the calling thread
+  \endrst*/
+  void AccumulateGradImprovementInChunks(StateType * ei_state) const OL_NONNULL_POINTERS;
+
+  //! spatial dimension (e.g., entries per point of points_sampled)
+  const int dim_;
+  //! number of monte carlo iterations
+  int num_mc_iterations_;
+  //! source of the normal vectors ``w`` in the MC integration
+  MonteCarloIntegrationTypes integration_type_;
+  //! best (minimum) objective function value (in points_sampled_value)
+  double best_so_far_;
+  //! pointer to gaussian process used in EI computations
+  const GaussianProcessType * gaussian_process_;
+  //! pool for chunks of pseudo-random MC iterations (nullptr: run them on the calling thread)
+  WorkStealingTaskPool * task_pool_;
+};
+
+/*!\rst
+  State object for ExpectedImprovementEvaluator.  This tracks the points being sampled in concurrent experiments
+  (``points_being_sampled``) ALONG with the points currently being evaluated via expected improvement for future experiments
+  (called ``points_to_sample``); these are the p and q of q,p-EI, respectively.  ``points_to_sample`` joined with
+  ``points_being_sampled`` is stored in ``union_of_points`` in that order.
+
+  This struct also tracks the state of the GaussianProcess that underlies the expected improvement computation: the GP state
+  is built to handle the initial ``union_of_points``, and subsequent updates to ``points_to_sample`` in this object also update
+  the GP state.
+
+  This struct also holds a pointer to a random number generator needed for Monte Carlo integrated EI computations.
+  If that generator is a (counter-based) PhiloxNormalRNG, the draws are keyed instead of sequential: SetStream() selects
+  the stream (MultistartOptimizer selects one per start, see BeginMultistart() below) and MC iteration ``k`` of every
+  EI or grad EI evaluation reads draws ``[k*num_union, (k+1)*num_union)`` of that stream.  So EI optimization results
+  depend on the seed and the start, but not on the ThreadSchedule or on which thread ran the start.
+  If the evaluator uses MonteCarloIntegrationTypes::kQuasiRandom, it additionally owns a SobolNormalRNG of dimension
+  ``num_union``; then ``num_union`` may not exceed SobolNormalRNG::kMaxDimension.
+
+  .. WARNING::
+       Users MUST guarantee that multiple state objects DO NOT point to the same RNG (in a multithreaded env).
+
+  See general comments on State structs in ``gpp_common.hpp``'s header docs.
+\endrst*/
+template <typename GaussianProcessType>
+struct BasicExpectedImprovementState final {
+  using EvaluatorType = BasicExpectedImprovementEvaluator<GaussianProcessType>;
+
+  /*!\rst
+    Constructs an ExpectedImprovementState object with a specified source of randomness for the purpose of computing EI
+    (and its gradient) over the specified set of points to sample.
+    This establishes properly sized/initialized temporaries for EI computation, including dependent state from the
+    associated Gaussian Process (which arrives as part of the ei_evaluator).
+
+    .. WARNING:: This object is invalidated if the associated ei_evaluator is mutated.  SetupState() should be called to reset.
+
+    .. WARNING::
+         Using this object to compute gradients when ``configure_for_gradients`` := false results in UNDEFINED BEHAVIOR.
+
+    \param
+      :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
+      :points_to_sample[dim][num_to_sample]: points at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test points for GP predictions)
+      :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
+      :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+      :num_being_sampled: number of points being sampled in concurrent experiments (i.e., the "p" in q,p-EI)
+      :configure_for_gradients: true if this object will be used to compute gradients, false otherwise
+      :normal_rng[1]: pointer to a properly initialized\* NormalRNG object
+
+    .. NOTE::
+         \* The NormalRNG object must already be seeded.  If multithreaded computation is used for EI, then every state object
+         must have a different NormalRNG (different seeds, not just different objects).
+  \endrst*/
+  BasicExpectedImprovementState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
+                                double const * restrict points_being_sampled, int num_to_sample_in,
+                                int num_being_sampled_in, bool configure_for_gradients,
+                                NormalRNGInterface * normal_rng_in);
+
+  /*!\rst
+    Same as the NormalRNGInterface ctor, but the draws are keyed by (seed, stream, MC iteration); see the struct docs.
+    Unlike the sequential generators, every state object may hold a PhiloxNormalRNG with the same seed (and should, for
+    results that do not depend on the thread schedule); they must still be different objects.
+
+    \param
+      :normal_rng[1]: pointer to a PhiloxNormalRNG; its stream is changed by SetStream()
+  \endrst*/
+  BasicExpectedImprovementState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
+                                double const * restrict points_being_sampled, int num_to_sample_in,
+                                int num_being_sampled_in, bool configure_for_gradients,
+                                PhiloxNormalRNG * normal_rng_in);
+
+  BasicExpectedImprovementState(BasicExpectedImprovementState&& other);
+
+  /*!\rst
+    Create a vector with the union of points_to_sample and points_being_sampled (the latter is appended to the former).
+
+    Note the l-value return. Assigning the return to a std::vector<double> or passing it as an argument to the ctor
+    will result in copy-elision or move semantics; no copying/performance loss.
+
+    \param:
+      :points_to_sample[dim][num_to_sample]: points at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test points for GP predictions)
+      :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
+      :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+      :num_being_sampled: number of points being sampled in concurrent experiments (i.e., the "p" in q,p-EI)
+      :dim: the number of spatial dimensions of each point array
+    \return
+      std::vector<double> with the union of the input arrays: points_being_sampled is *appended* to points_to_sample
+  \endrst*/
+  static std::vector<double> BuildUnionOfPoints(double const * restrict points_to_sample,
+                                                double const * restrict points_being_sampled,
+                                                int num_to_sample, int num_being_sampled,
+                                                int dim) noexcept OL_WARN_UNUSED_RESULT {
+    std::vector<double> union_of_points(dim*(num_to_sample + num_being_sampled));
+    std::copy(points_to_sample, points_to_sample + dim*num_to_sample, union_of_points.data());
+    std::copy(points_being_sampled, points_being_sampled + dim*num_being_sampled,
+              union_of_points.data() + dim*num_to_sample);
+    return union_of_points;
+  }
 
-    In words, we are computing the expected improvement (over the current ``best_so_far``, best known
-    objective function value) that would result from sampling (aka running new experiments) at
-    ``points_to_sample`` with ``points_being_sampled`` concurrent/ongoing experiments.
+  int GetProblemSize() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim*num_to_sample;
+  }
 
-    In general, the EI expression is complex and difficult to evaluate; hence we use Monte-Carlo simulation to approximate it.
-    When faster (e.g., analytic) techniques are available, we will prefer them.
+  /*!\rst
+    Get the ``points_to_sample``: potential future samples whose EI (and/or gradients) are being evaluated
 
-    The idea of the MC approach is to repeatedly sample at the union of ``points_to_sample`` and
-    ``points_being_sampled``. This is analogous to gaussian_process_interface.sample_point_from_gp,
-    but we sample ``num_union`` points at once:
+    \output
+      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
+  \endrst*/
+  void GetCurrentPoint(double * restrict points_to_sample) const noexcept OL_NONNULL_POINTERS {
+    std::copy(union_of_points.data(), union_of_points.data() + num_to_sample*dim, points_to_sample);
+  }
 
-    ``y = \mu + Lw``
+  /*!\rst
+    Change the potential samples whose EI (and/or gradient) are being evaluated.
+    Update the state's derived quantities to be consistent with the new points.
 
-    where ``\mu`` is the GP-mean, ``L`` is the ``chol_factor(GP-variance)`` and ``w`` is a vector
-    of ``num_union`` draws from N(0, 1). Then:
+    Quantities derived from ``points_being_sampled`` alone are reused (see PointsToSampleState::UpdateMovingPoints()),
+    so ``ei_evaluator`` must use the same (unmutated) GP as the last SetupState() or construction.
 
-    ``improvement_per_step = max(max(best_so_far - y), 0.0)``
+    \param
+      :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
+      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
+  \endrst*/
+  void SetCurrentPoint(const EvaluatorType& ei_evaluator,
+                          double const * restrict points_to_sample) OL_NONNULL_POINTERS;
 
-    Observe that the inner ``max`` means only the smallest component of ``y`` contributes in each iteration.
-    We compute the improvement over many random draws and average.
+  /*!\rst
+    Configures this state object with new ``points_to_sample``, the location of the potential samples whose EI is to be evaluated.
+    Ensures all state variables & temporaries are properly sized.
+    Properly sets all dependent state variables (e.g., GaussianProcess's state) for EI evaluation.
 
-    .. Note:: These comments were copied into ExpectedImprovementInterface.compute_expected_improvement() in interfaces/expected_improvement_interface.py.
+    .. WARNING::
+         This object's state is INVALIDATED if the ``ei_evaluator`` (including the GaussianProcess it depends on) used in
+         SetupState is mutated! SetupState() should be called again in such a situation.
 
     \param
-      :ei_state[1]: properly configured state object
-    \output
-      :ei_state[1]: state with temporary storage modified; ``normal_rng`` modified
-    \return
-      the expected improvement from sampling ``points_to_sample`` with ``points_being_sampled`` concurrent experiments
+      :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
+      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
   \endrst*/
-  double ComputeExpectedImprovement(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+  void SetupState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample);
 
   /*!\rst
-    Computes the (partial) derivatives of the expected improvement with respect to each point of ``points_to_sample``.
-    As with ComputeExpectedImprovement(), this computation accounts for the effect of ``points_being_sampled``
-    concurrent experiments.
+    Select the stream of a counter-based ``normal_rng``; no-op for sequential generators.
 
-    ``points_to_sample`` is the "q" and ``points_being_sampled`` is the "p" in q,p-EI..
+    \param
+      :stream: index of the stream to draw from (e.g., multistart index)
+  \endrst*/
+  void SetStream(std::uint64_t stream) noexcept {
+    if (stream_normal_rng != nullptr) {
+      stream_normal_rng->SetStream(stream);
+    }
+  }
 
-    In general, the expressions for gradients of EI are complex and difficult to evaluate; hence we use
-    Monte-Carlo simulation to approximate it. When faster (e.g., analytic) techniques are available, we will prefer them.
+  /*!\rst
+    Position a counter-based ``normal_rng`` at the draws of MC iteration ``iteration``, i.e., draw ``iteration*num_union``
+    of the current stream; no-op for sequential generators (they are read in order).
 
-    The MC computation of grad EI is similar to the computation of EI (decsribed in
-    compute_expected_improvement). We differentiate ``y = \mu + Lw`` wrt ``points_to_sample``;
-    only terms from the gradient of ``\mu`` and ``L`` contribute. In EI, we computed:
+    \param
+      :iteration: index of the MC iteration whose normal vector is drawn next
+  \endrst*/
+  void SetMonteCarloIteration(int iteration) noexcept {
+    if (stream_normal_rng != nullptr) {
+      stream_normal_rng->SetDrawIndex(static_cast<std::uint64_t>(iteration)*num_union);
+    }
+  }
 
-    ``improvement_per_step = max(max(best_so_far - y), 0.0)``
+  // size information
+  //! spatial dimension (e.g., entries per point of ``points_sampled``)
+  const int dim;
+  //! number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+  const int num_to_sample;
+  //! number of points being sampled concurrently (i.e., the "p" in q,p-EI)
+  const int num_being_sampled;
+  //! number of derivative terms desired (usually 0 for no derivatives or num_to_sample)
+  const int num_derivatives;
+  //! number of points in union_of_points: num_to_sample + num_being_sampled
+  const int num_union;
 
-    and noted that only the smallest component of ``y`` may contribute (if it is > 0.0).
-    Call this index ``winner``. Thus in computing grad EI, we only add gradient terms
-    that are attributable to the ``winner``-th component of ``y``.
+  //! points currently being sampled; this is the union of the points represented by "q" and "p" in q,p-EI
+  //! ``points_to_sample`` is stored first in memory, immediately followed by ``points_being_sampled``
+  std::vector<double> union_of_points;
 
-    .. Note:: These comments were copied into ExpectedImprovementInterface.compute_expected_improvement() in interfaces/expected_improvement_interface.py.
+  //! gaussian process state
+  typename GaussianProcessType::StateType points_to_sample_state;
+
+  //! random number generator
+  NormalRNGInterface * normal_rng;
+  //! ``normal_rng`` if it is counter-based (PhiloxNormalRNG), nullptr otherwise
+  PhiloxNormalRNG * stream_normal_rng;
+  //! quasi-random (Sobol) source of normal vectors; only allocated for MonteCarloIntegrationTypes::kQuasiRandom
+  std::unique_ptr<SobolNormalRNG> qmc_normal_rng;
+
+  // temporary storage: preallocated space used by ExpectedImprovementEvaluator's member functions
+  //! the mean of the GP evaluated at union_of_points
+  std::vector<double> to_sample_mean;
+  //! the gradient of the GP mean evaluated at union_of_points, wrt union_of_points[0:num_to_sample]
+  std::vector<double> grad_mu;
+  //! the cholesky (``LL^T``) factorization of the GP variance evaluated at union_of_points
+  std::vector<double> cholesky_to_sample_var;
+  //! the gradient of the cholesky (``LL^T``) factorization of the GP variance evaluated at union_of_points wrt union_of_points[0:num_to_sample]
+  std::vector<double> grad_chol_decomp;
+
+  //! tracks the aggregate grad EI from all mc iterations
+  std::vector<double> aggregate;
+
+  //! id of the WorkStealingTaskPool worker using this state (0 outside a pool); see the evaluator's ``task_pool``
+  int worker_id;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicExpectedImprovementState);
+};
+
+/*!\rst
+  MultistartOptimizer hook (see BeginMultistart() in gpp_optimization.hpp): start ``multistart_index`` draws from
+  stream ``multistart_index``, so its result does not depend on which thread runs it.
+
+  \param
+    :ei_state[1]: state that will run the start
+    :multistart_index: index of the start
+  \output
+    :ei_state[1]: ``stream_normal_rng`` (if any) moved to the start of stream ``multistart_index``
+\endrst*/
+template <typename GaussianProcessType>
+inline OL_NONNULL_POINTERS void BeginMultistart(BasicExpectedImprovementState<GaussianProcessType> * ei_state,
+                                                int multistart_index) noexcept {
+  ei_state->SetStream(multistart_index);
+}
+
+//! q,p-EI evaluator (and its state) for the exact GaussianProcess
+using ExpectedImprovementEvaluator = BasicExpectedImprovementEvaluator<GaussianProcess>;
+using ExpectedImprovementState = BasicExpectedImprovementState<GaussianProcess>;
+
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template class BasicExpectedImprovementEvaluator<GaussianProcess>;
+extern template class BasicExpectedImprovementEvaluator<SparseGaussianProcess>;
+extern template struct BasicExpectedImprovementState<GaussianProcess>;
+extern template struct BasicExpectedImprovementState<SparseGaussianProcess>;
+
+/*!\rst
+  This is a specialization of the ExpectedImprovementEvaluator class for when the number of potential samples is 1; i.e.,
+  ``num_to_sample == 1`` and the number of concurrent samples is 0; i.e. ``num_being_sampled == 0``.
+  In other words, this class only supports the computation of 1,0-EI.  In this case, we have analytic formulas
+  for computing EI and its gradient.
+
+  Thus this class does not perform any explicit numerical integration, nor do its EI functions require access to a
+  random number generator.
+
+  This class's methods have some parameters that are unused or redundant.  This is so that the interface matches that of
+  the more general ExpectedImprovementEvaluator.
+
+  For other details, see ExpectedImprovementEvaluator for more complete description of what EI is and the outputs of
+  EI and grad EI computations.
+\endrst*/
+template <typename GaussianProcessType>
+class BasicOnePotentialSampleExpectedImprovementEvaluator final {
+ public:
+  using StateType = BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType>;
+
+  //! Minimum allowed variance value in the "1D" analytic EI computation.
+  //! Values that are too small result in problems b/c we may compute ``std_dev/var`` (which is enormous
+  //! if ``std_dev = 1.0e-150`` and ``var = 1.0e-300``) since this only arises when we fail to compute ``std_dev = var = 0.0``.
+  //! Note: this is only relevant if noise = 0.0; this minimum will not affect EI computation with noise since this value
+  //! is below the smallest amount of noise users can meaningfully add.
+  //! This is the smallest possible value that prevents the denominator (best_so_far - mean) / sqrt(variance)
+  //! from being 0. 1D analytic EI is simple and no other robustness considerations are needed.
+  static constexpr double kMinimumVarianceEI = std::numeric_limits<double>::min();
+
+  //! Minimum allowed variance value in the "1D" analytic grad EI computation.
+  //! See kMinimumVarianceEI for more details.
+  //! This value was chosen so its sqrt would be a little larger than GaussianProcess::kMinimumStdDev (by ~12x).
+  //! The 150.0 was determined by numerical experiment with the setup in EIOnePotentialSampleEdgeCasesTest
+  //! in order to find a setting that would be robust (no 0/0) while introducing minimal error.
+  static constexpr double kMinimumVarianceGradEI = 150.0*Square(GaussianProcessType::kMinimumStdDev);
+
+  /*!\rst
+    Constructs a OnePotentialSampleExpectedImprovementEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
+  \endrst*/
+  BasicOnePotentialSampleExpectedImprovementEvaluator(const GaussianProcessType& gaussian_process_in, double best_so_far);
+
+  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  const GaussianProcessType * gaussian_process() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return gaussian_process_;
+  }
+
+  /*!\rst
+    Wrapper for ComputeExpectedImprovement(); see that function for details.
+  \endrst*/
+  double ComputeObjectiveFunction(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT {
+    return ComputeExpectedImprovement(ei_state);
+  }
+
+  /*!\rst
+    Wrapper for ComputeGradExpectedImprovement(); see that function for details.
+  \endrst*/
+  void ComputeGradObjectiveFunction(StateType * ei_state, double * restrict grad_EI) const OL_NONNULL_POINTERS {
+    ComputeGradExpectedImprovement(ei_state, grad_EI);
+  }
+
+  /*!\rst
+    Computes the expected improvement ``EI(Xs) = E_n[[f^*_n(X) - min(f(Xs_1),...,f(Xs_m))]^+]``
+
+    Uses analytic formulas to evaluate the expected improvement.
 
     \param
       :ei_state[1]: properly configured state object
     \output
-      :ei_state[1]: state with temporary storage modified; ``normal_rng`` modified
-      :grad_EI[dim][num_to_sample]: gradient of EI, ``\pderiv{EI(Xq \cup Xp)}{Xq_{d,i}}`` where ``Xq`` is ``points_to_sample``
-          and ``Xp`` is ``points_being_sampled`` (grad EI from sampling ``points_to_sample`` with
-          ``points_being_sampled`` concurrent experiments wrt each dimension of the points in ``points_to_sample``)
+      :ei_state[1]: state with temporary storage modified
+    \return
+      the expected improvement from sampling ``point_to_sample``
   \endrst*/
-  void ComputeGradExpectedImprovement(StateType * ei_state, double * restrict grad_EI) const OL_NONNULL_POINTERS;
+  double ComputeExpectedImprovement(StateType * ei_state) const;
+
+  /*!\rst
+    Computes the (partial) derivatives of the expected improvement with respect to the point to sample.
+
+    Uses analytic formulas to evaluate the spatial gradient of the expected improvement.
+
+    \param
+      :ei_state[1]: properly configured state object
+    \output
+      :ei_state[1]: state with temporary storage modified
+      :grad_EI[dim]: gradient of EI, ``\pderiv{EI(x)}{x_d}``, where ``x`` is ``points_to_sample``
+  \endrst*/
+  void ComputeGradExpectedImprovement(StateType * ei_state, double * restrict grad_EI) const;
 
-  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(ExpectedImprovementEvaluator);
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicOnePotentialSampleExpectedImprovementEvaluator);
 
  private:
-  //! spatial dimension (e.g., entries per point of points_sampled)
+  //! spatial dimension (e.g., entries per point of ``points_sampled``)
   const int dim_;
-  //! number of monte carlo iterations
-  int num_mc_iterations_;
-  //! best (minimum) objective function value (in points_sampled_value)
+  //! best (minimum) objective function value (in ``points_sampled_value``)
   double best_so_far_;
+
+  //! normal distribution object
+  const boost::math::normal_distribution<double> normal_;
   //! pointer to gaussian process used in EI computations
-  const GaussianProcess * gaussian_process_;
+  const GaussianProcessType * gaussian_process_;
 };
 
 /*!\rst
-  State object for ExpectedImprovementEvaluator.  This tracks the points being sampled in concurrent experiments
-  (``points_being_sampled``) ALONG with the points currently being evaluated via expected improvement for future experiments
-  (called ``points_to_sample``); these are the p and q of q,p-EI, respectively.  ``points_to_sample`` joined with
-  ``points_being_sampled`` is stored in ``union_of_points`` in that order.
-
-  This struct also tracks the state of the GaussianProcess that underlies the expected improvement computation: the GP state
-  is built to handle the initial ``union_of_points``, and subsequent updates to ``points_to_sample`` in this object also update
-  the GP state.
-
-  This struct also holds a pointer to a random number generator needed for Monte Carlo integrated EI computations.
-
-  .. WARNING::
-       Users MUST guarantee that multiple state objects DO NOT point to the same RNG (in a multithreaded env).
+  State object for OnePotentialSampleExpectedImprovementEvaluator.  This tracks the *ONE* ``point_to_sample``
+  being evaluated via expected improvement.
 
+  This is just a special case of ExpectedImprovementState; see those class docs for more details.
   See general comments on State structs in ``gpp_common.hpp``'s header docs.
 \endrst*/
-struct ExpectedImprovementState final {
-  using EvaluatorType = ExpectedImprovementEvaluator;
+template <typename GaussianProcessType>
+struct BasicOnePotentialSampleExpectedImprovementState final {
+  using EvaluatorType = BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>;
 
   /*!\rst
-    Constructs an ExpectedImprovementState object with a specified source of randomness for the purpose of computing EI
-    (and its gradient) over the specified set of points to sample.
+    Constructs an OnePotentialSampleExpectedImprovementState object for the purpose of computing EI
+    (and its gradient) over the specified point to sample.
     This establishes properly sized/initialized temporaries for EI computation, including dependent state from the
-    associated Gaussian Process (which arrives as part of the ei_evaluator).
+    associated Gaussian Process (which arrives as part of the ``ei_evaluator``).
 
-    .. WARNING:: This object is invalidated if the associated ei_evaluator is mutated.  SetupState() should be called to reset.
+    .. WARNING::
+         This object is invalidated if the associated ei_evaluator is mutated.  SetupState() should be called to reset.
 
     .. WARNING::
          Using this object to compute gradients when ``configure_for_gradients`` := false results in UNDEFINED BEHAVIOR.
 
     \param
       :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
-      :points_to_sample[dim][num_to_sample]: points at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test points for GP predictions)
-      :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
-      :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
-      :num_being_sampled: number of points being sampled in concurrent experiments (i.e., the "p" in q,p-EI)
+      :point_to_sample[dim]: point at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test point for GP predictions)
       :configure_for_gradients: true if this object will be used to compute gradients, false otherwise
-      :normal_rng[1]: pointer to a properly initialized\* NormalRNG object
-
-    .. NOTE::
-         \* The NormalRNG object must already be seeded.  If multithreaded computation is used for EI, then every state object
-         must have a different NormalRNG (different seeds, not just different objects).
   \endrst*/
-  ExpectedImprovementState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
-                           double const * restrict points_being_sampled, int num_to_sample_in,
-                           int num_being_sampled_in, bool configure_for_gradients, NormalRNGInterface * normal_rng_in);
-
-  ExpectedImprovementState(ExpectedImprovementState&& other);
+  BasicOnePotentialSampleExpectedImprovementState(const EvaluatorType& ei_evaluator,
+                                                  double const * restrict point_to_sample_in,
+                                                  bool configure_for_gradients);
 
   /*!\rst
-    Create a vector with the union of points_to_sample and points_being_sampled (the latter is appended to the former).
-
-    Note the l-value return. Assigning the return to a std::vector<double> or passing it as an argument to the ctor
-    will result in copy-elision or move semantics; no copying/performance loss.
-
-    \param:
-      :points_to_sample[dim][num_to_sample]: points at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test points for GP predictions)
-      :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
-      :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
-      :num_being_sampled: number of points being sampled in concurrent experiments (i.e., the "p" in q,p-EI)
-      :dim: the number of spatial dimensions of each point array
-    \return
-      std::vector<double> with the union of the input arrays: points_being_sampled is *appended* to points_to_sample
+    Constructor wrapper to match the signature of the ctor for ExpectedImprovementState().
   \endrst*/
-  static std::vector<double> BuildUnionOfPoints(double const * restrict points_to_sample,
-                                                double const * restrict points_being_sampled,
-                                                int num_to_sample, int num_being_sampled,
-                                                int dim) noexcept OL_WARN_UNUSED_RESULT {
-    std::vector<double> union_of_points(dim*(num_to_sample + num_being_sampled));
-    std::copy(points_to_sample, points_to_sample + dim*num_to_sample, union_of_points.data());
-    std::copy(points_being_sampled, points_being_sampled + dim*num_being_sampled,
-              union_of_points.data() + dim*num_to_sample);
-    return union_of_points;
-  }
+  BasicOnePotentialSampleExpectedImprovementState(const EvaluatorType& ei_evaluator,
+                                                  double const * restrict points_to_sample,
+                                                  double const * restrict OL_UNUSED(points_being_sampled),
+                                                  int OL_UNUSED(num_to_sample_in), int OL_UNUSED(num_being_sampled_in),
+                                                  bool configure_for_gradients,
+                                                  NormalRNGInterface * OL_UNUSED(normal_rng_in));
+
+  BasicOnePotentialSampleExpectedImprovementState(BasicOnePotentialSampleExpectedImprovementState&& other);
 
   int GetProblemSize() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
-    return dim*num_to_sample;
+    return dim;
   }
 
   /*!\rst
-    Get the ``points_to_sample``: potential future samples whose EI (and/or gradients) are being evaluated
+    Get ``point_to_sample``: the potential future sample whose EI (and/or gradients) is being evaluated
 
     \output
-      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
+      :point_to_sample[dim]: potential sample whose EI is being evaluted
   \endrst*/
-  void GetCurrentPoint(double * restrict points_to_sample) const noexcept OL_NONNULL_POINTERS {
-    std::copy(union_of_points.data(), union_of_points.data() + num_to_sample*dim, points_to_sample);
+  void GetCurrentPoint(double * restrict point_to_sample_out) const noexcept OL_NONNULL_POINTERS {
+    std::copy(point_to_sample.begin(), point_to_sample.end(), point_to_sample_out);
   }
 
   /*!\rst
-    Change the potential samples whose EI (and/or gradient) are being evaluated.
-    Update the state's derived quantities to be consistent with the new points.
+    Change the potential sample whose EI (and/or gradient) is being evaluated.
+    Update the state's derived quantities to be consistent with the new point.
 
     \param
       :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
-      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
+      :point_to_sample[dim]: potential future sample whose EI (and/or gradients) is being evaluated
   \endrst*/
   void SetCurrentPoint(const EvaluatorType& ei_evaluator,
-                          double const * restrict points_to_sample) OL_NONNULL_POINTERS;
+                          double const * restrict point_to_sample_in) OL_NONNULL_POINTERS;
 
   /*!\rst
-    Configures this state object with new ``points_to_sample``, the location of the potential samples whose EI is to be evaluated.
+    Configures this state object with a new ``point_to_sample``, the location of the potential sample whose EI is to be evaluated.
     Ensures all state variables & temporaries are properly sized.
     Properly sets all dependent state variables (e.g., GaussianProcess's state) for EI evaluation.
 
     .. WARNING::
-         This object's state is INVALIDATED if the ``ei_evaluator`` (including the GaussianProcess it depends on) used in
+         This object's state is INVALIDATED if the ei_evaluator (including the GaussianProcess it depends on) used in
          SetupState is mutated! SetupState() should be called again in such a situation.
 
     \param
       :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
-      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
+      :point_to_sample[dim]: potential future sample whose EI (and/or gradients) is being evaluated
   \endrst*/
-  void SetupState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample);
+  void SetupState(const EvaluatorType& ei_evaluator,
+                  double const * restrict point_to_sample_in) OL_NONNULL_POINTERS;
 
   // size information
   //! spatial dimension (e.g., entries per point of ``points_sampled``)
   const int dim;
-  //! number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
-  const int num_to_sample;
-  //! number of points being sampled concurrently (i.e., the "p" in q,p-EI)
-  const int num_being_sampled;
+  //! number of points to sample (i.e., the "q" in q,p-EI); MUST be 1
+  const int num_to_sample = 1;
   //! number of derivative terms desired (usually 0 for no derivatives or num_to_sample)
   const int num_derivatives;
-  //! number of points in union_of_points: num_to_sample + num_being_sampled
-  const int num_union;
 
-  //! points currently being sampled; this is the union of the points represented by "q" and "p" in q,p-EI
-  //! ``points_to_sample`` is stored first in memory, immediately followed by ``points_being_sampled``
-  std::vector<double> union_of_points;
+  //! point at which to evaluate EI and/or its gradient (e.g., to check its value in future experiments)
+  std::vector<double> point_to_sample;
 
   //! gaussian process state
-  GaussianProcess::StateType points_to_sample_state;
-
-  //! random number generator
-  NormalRNGInterface * normal_rng;
+  typename GaussianProcessType::StateType points_to_sample_state;
 
-  // temporary storage: preallocated space used by ExpectedImprovementEvaluator's member functions
-  //! the mean of the GP evaluated at union_of_points
-  std::vector<double> to_sample_mean;
-  //! the gradient of the GP mean evaluated at union_of_points, wrt union_of_points[0:num_to_sample]
+  // temporary storage: preallocated space used by OnePotentialSampleExpectedImprovementEvaluator's member functions
+  //! the gradient of the GP mean evaluated at point_to_sample, wrt point_to_sample
   std::vector<double> grad_mu;
-  //! the cholesky (``LL^T``) factorization of the GP variance evaluated at union_of_points
-  std::vector<double> cholesky_to_sample_var;
-  //! the gradient of the cholesky (``LL^T``) factorization of the GP variance evaluated at union_of_points wrt union_of_points[0:num_to_sample]
+  //! the gradient of the sqrt of the GP variance evaluated at point_to_sample wrt point_to_sample
   std::vector<double> grad_chol_decomp;
 
-  //! improvement (per mc iteration) evaluated at each of union_of_points
-  std::vector<double> EI_this_step_from_var;
-  //! tracks the aggregate grad EI from all mc iterations
-  std::vector<double> aggregate;
-  //! normal rng draws
-  std::vector<double> normals;
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicOnePotentialSampleExpectedImprovementState);
+};
+
+//! 1,0-EI evaluator (and its state) for the exact GaussianProcess
+using OnePotentialSampleExpectedImprovementEvaluator = BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcess>;
+using OnePotentialSampleExpectedImprovementState = BasicOnePotentialSampleExpectedImprovementState<GaussianProcess>;
+
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template class BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcess>;
+extern template class BasicOnePotentialSampleExpectedImprovementEvaluator<SparseGaussianProcess>;
+extern template struct BasicOnePotentialSampleExpectedImprovementState<GaussianProcess>;
+extern template struct BasicOnePotentialSampleExpectedImprovementState<SparseGaussianProcess>;
+
+/*!\rst
+  Batched version of OnePotentialSampleExpectedImprovementEvaluator::ComputeExpectedImprovement(): computes 1,0-EI at
+  each of a list of candidate points.  Used to score large candidate sets (e.g., latin hypercube search; see
+  EvaluateEIAtPointList()).
+
+  Scoring candidates one at a time costs a PointsToSampleState setup per point (a ``num_sampled x 1`` covariance block and
+  a matrix-vector triangular solve).  Instead, candidates are processed kBlockSize at a time via
+  GaussianProcess::ComputeMeanAndMarginalVarianceOfPoints(): one ``num_sampled x kBlockSize`` covariance block, one
+  multi-RHS triangular solve, and then the analytic EI formula evaluated in a flat loop over the block.
+
+  This class only computes EI values; there is no state object and no gradient.  Results match
+  OnePotentialSampleExpectedImprovementEvaluator up to roundoff.
+\endrst*/
+template <typename GaussianProcessType>
+class BasicBatchOnePotentialSampleExpectedImprovementEvaluator final {
+ public:
+  //! Number of candidate points scored together.  The covariance block is ``num_sampled x kBlockSize``; e.g.,
+  //! 256KB for ``num_sampled = 500``.
+  static constexpr int kBlockSize = 64;
+
+  /*!\rst
+    Constructs a BatchOnePotentialSampleExpectedImprovementEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
+
+    \param
+      :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
+        that describes the underlying GP
+      :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
+  \endrst*/
+  BasicBatchOnePotentialSampleExpectedImprovementEvaluator(const GaussianProcessType& gaussian_process_in,
+                                                           double best_so_far);
+
+  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  const GaussianProcessType * gaussian_process() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return gaussian_process_;
+  }
+
+  /*!\rst
+    Computes 1,0-EI at each of ``points_to_sample`` (each point is a separate candidate, NOT a set to sample
+    concurrently).  Not multithreaded; callers may split the point list across threads.
+
+    \param
+      :points_to_sample[dim][num_points]: candidate points at which to evaluate EI
+      :num_points: number of candidate points
+    \output
+      :ei_values[num_points]: ``ei_values[i]`` is the expected improvement from sampling the ``i``-th point
+  \endrst*/
+  void ComputeExpectedImprovement(double const * restrict points_to_sample, int num_points,
+                                  double * restrict ei_values) const OL_NONNULL_POINTERS;
 
-  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(ExpectedImprovementState);
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicBatchOnePotentialSampleExpectedImprovementEvaluator);
+
+ private:
+  //! spatial dimension (e.g., entries per point of ``points_sampled``)
+  const int dim_;
+  //! best (minimum) objective function value (in ``points_sampled_value``)
+  double best_so_far_;
+
+  //! pointer to gaussian process used in EI computations
+  const GaussianProcessType * gaussian_process_;
 };
 
+//! batched 1,0-EI evaluator for the exact GaussianProcess
+using BatchOnePotentialSampleExpectedImprovementEvaluator =
+    BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcess>;
+
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template class BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcess>;
+extern template class BasicBatchOnePotentialSampleExpectedImprovementEvaluator<SparseGaussianProcess>;
+
 /*!\rst
-  This is a specialization of the ExpectedImprovementEvaluator class for when the number of potential samples is 1; i.e.,
-  ``num_to_sample == 1`` and the number of concurrent samples is 0; i.e. ``num_being_sampled == 0``.
-  In other words, this class only supports the computation of 1,0-EI.  In this case, we have analytic formulas
-  for computing EI and its gradient.
+  Set up vector of OnePotentialSampleExpectedImprovementEvaluator::StateType.
 
-  Thus this class does not perform any explicit numerical integration, nor do its EI functions require access to a
-  random number generator.
+  This is a utility function just for reducing code duplication.
 
-  This class's methods have some parameters that are unused or redundant.  This is so that the interface matches that of
-  the more general ExpectedImprovementEvaluator.
+  dim is the spatial dimension, ``ei_evaluator.dim()``
 
-  For other details, see ExpectedImprovementEvaluator for more complete description of what EI is and the outputs of
-  EI and grad EI computations.
+  \param
+    :ei_evaluator: evaluator object associated w/the state objects being constructed
+    :starting_point[dim]: initial point to load into state (must be a valid point for the problem)
+    :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
+    :configure_for_gradients: true if these state objects will be used to compute gradients, false otherwise
+    :state_vector[arbitrary]: vector of state objects, arbitrary size (usually 0)
+  \output
+    :state_vector[max_num_threads]: vector of states containing ``max_num_threads`` properly initialized state objects
 \endrst*/
-class OnePotentialSampleExpectedImprovementEvaluator final {
- public:
-  using StateType = OnePotentialSampleExpectedImprovementState;
+template <typename GaussianProcessType>
+inline OL_NONNULL_POINTERS void SetupExpectedImprovementState(
+    const BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>& ei_evaluator,
+    double const * restrict starting_point,
+    int max_num_threads,
+    bool configure_for_gradients,
+    std::vector<BasicOnePotentialSampleExpectedImprovementState<GaussianProcessType> > * state_vector) {
+  state_vector->reserve(max_num_threads);
+  for (int i = 0; i < max_num_threads; ++i) {
+    state_vector->emplace_back(ei_evaluator, starting_point, configure_for_gradients);
+  }
+}
 
-  //! Minimum allowed variance value in the "1D" analytic EI computation.
-  //! Values that are too small result in problems b/c we may compute ``std_dev/var`` (which is enormous
-  //! if ``std_dev = 1.0e-150`` and ``var = 1.0e-300``) since this only arises when we fail to compute ``std_dev = var = 0.0``.
-  //! Note: this is only relevant if noise = 0.0; this minimum will not affect EI computation with noise since this value
-  //! is below the smallest amount of noise users can meaningfully add.
-  //! This is the smallest possible value that prevents the denominator (best_so_far - mean) / sqrt(variance)
-  //! from being 0. 1D analytic EI is simple and no other robustness considerations are needed.
-  static constexpr double kMinimumVarianceEI = std::numeric_limits<double>::min();
+/*!\rst
+  Set up vector of ExpectedImprovementEvaluator::StateType.
 
-  //! Minimum allowed variance value in the "1D" analytic grad EI computation.
-  //! See kMinimumVarianceEI for more details.
-  //! This value was chosen so its sqrt would be a little larger than GaussianProcess::kMinimumStdDev (by ~12x).
-  //! The 150.0 was determined by numerical experiment with the setup in EIOnePotentialSampleEdgeCasesTest
-  //! in order to find a setting that would be robust (no 0/0) while introducing minimal error.
-  static constexpr double kMinimumVarianceGradEI = 150.0*Square(GaussianProcess::kMinimumStdDev);
+  This is a utility function just for reducing code duplication.
+
+  \param
+    :ei_evaluator: evaluator object associated w/the state objects being constructed
+    :points_to_sample[dim][num_to_sample]: initial points to load into state (must be a valid point for the problem);
+      i.e., points at which to evaluate EI and/or its gradient
+    :points_being_sampled[dim][num_being_sampled]: points that are being sampled in concurrently experiments
+    :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+    :num_being_sampled: number of points being sampled concurrently (i.e., the p in q,p-EI)
+    :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
+    :configure_for_gradients: true if these state objects will be used to compute gradients, false otherwise
+    :state_vector[arbitrary]: vector of state objects, arbitrary size (usually 0)
+    :normal_rng[max_num_threads]: a vector of PhiloxNormalRNG objects that provide the (pesudo)random source for MC integration
+  \output
+    :state_vector[max_num_threads]: vector of states containing ``max_num_threads`` properly initialized state objects;
+      state ``i`` has ``worker_id = i`` (matching WorkStealingTaskPool worker ``i``)
+\endrst*/
+template <typename GaussianProcessType>
+inline OL_NONNULL_POINTERS void SetupExpectedImprovementState(
+    const BasicExpectedImprovementEvaluator<GaussianProcessType>& ei_evaluator,
+    double const * restrict points_to_sample,
+    double const * restrict points_being_sampled,
+    int num_to_sample,
+    int num_being_sampled,
+    int max_num_threads,
+    bool configure_for_gradients,
+    PhiloxNormalRNG * normal_rng,
+    std::vector<BasicExpectedImprovementState<GaussianProcessType> > * state_vector) {
+  state_vector->reserve(max_num_threads);
+  for (int i = 0; i < max_num_threads; ++i) {
+    state_vector->emplace_back(ei_evaluator, points_to_sample, points_being_sampled, num_to_sample,
+                               num_being_sampled, configure_for_gradients, normal_rng + i);
+    state_vector->back().worker_id = i;
+  }
+}
+
+//! Largest number of variables ComputeMultivariateNormalCDF() supports, and hence the largest ``num_union`` that
+//! AnalyticExpectedImprovementEvaluator handles.  The cost of the CDF grows roughly like ``(20 n)^{n/2}``, so
+//! larger q,p-EI problems are left to monte-carlo integration (ExpectedImprovementEvaluator).
+static constexpr int kMaxMultivariateNormalCDFDim = 4;
+
+/*!\rst
+  Computes the bivariate standard normal CDF, ``P(X_0 < h_0, X_1 < h_1)``, where ``X_0, X_1`` are N(0, 1) with
+  correlation ``rho``.  Uses Genz's (2004) refinement of the Drezner & Wesolowsky method (20-point Gauss-Legendre
+  quadrature in ``\arcsin\rho``, plus an asymptotic expansion for ``|\rho| \geq 0.925``); accurate to ~1e-15.
+
+  \param
+    :h_0: upper limit of integration for ``X_0``
+    :h_1: upper limit of integration for ``X_1``
+    :rho: correlation between ``X_0`` and ``X_1``, in ``[-1, 1]``
+  \return
+    ``P(X_0 < h_0, X_1 < h_1)``
+\endrst*/
+double ComputeBivariateNormalCDF(double h_0, double h_1, double rho) noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT;
+
+/*!\rst
+  Computes the multivariate normal CDF, ``P(Y < upper_limits)`` (componentwise), for ``Y ~ N(0, covariance)`` with at
+  most kMaxMultivariateNormalCDFDim components.
+
+  Up to 2 components, this is exact (to ~1e-15).  For 3 and 4 components, we use Plackett's identity: decouple one
+  variable (the one least correlated with the rest) by scaling its correlations by ``t``, and integrate
+  ``\pderiv{}{t}`` of the CDF from ``t = 0`` (a product of lower dimensional CDFs) to ``t = 1``.  Each derivative
+  term is a bivariate density times a CDF in 2 fewer dimensions; after substituting ``\sin\theta = t\rho``
+  (as in Genz's trivariate method) the integrands are smooth and 20-point Gauss-Legendre is accurate to ~1e-10
+  unless the correlations are very near ``\pm 1``.
+
+  Components with zero variance are treated as point masses at 0.
+
+  \param
+    :upper_limits[num_variables]: upper limits of integration
+    :covariance[num_variables][num_variables]: covariance matrix of ``Y`` (symmetric positive semi-definite;
+      all entries are read)
+    :num_variables: number of components of ``Y``, in ``[0, kMaxMultivariateNormalCDFDim]``
+  \return
+    ``P(Y_i < upper_limits_i`` for all ``i)``
+\endrst*/
+double ComputeMultivariateNormalCDF(double const * restrict upper_limits, double const * restrict covariance,
+                                    int num_variables) OL_WARN_UNUSED_RESULT;
+
+/*!\rst
+  A class to encapsulate the computation of q,p-EI and its spatial gradient *without* monte-carlo integration, for small
+  ``num_union = num_to_sample + num_being_sampled`` (at most kMaxMultivariateNormalCDFDim).  Following Chevalier and
+  Ginsbourger, EI is expressed through multivariate normal CDFs: for ``Y ~ N(\mu, \Sigma)`` (the GP at
+  ``union_of_points``) and each ``k``, let ``W^{(k)} = (Y_k - Y_j)_{j \neq k}`` with ``W^{(k)}_k = Y_k - f^*``.  Then
+  ``Y_k`` is the winning (smallest, improving) component exactly when ``W^{(k)} \leq 0``, and
+
+  ``EI = \sum_k (f^* - \mu_k) P_k + \sum_{k,i} S^{(k)}_{ki} D^{(k)}_i``
+
+  where ``P_k = \Phi_n(b^{(k)}; S^{(k)})`` is the probability that ``Y_k`` wins, ``b^{(k)} = -E[W^{(k)}]``,
+  ``S^{(k)} = Var[W^{(k)}]``, and ``D^{(k)}_i = \pderiv{P_k}{b^{(k)}_i}`` (a normal density times an ``n-1``
+  dimensional CDF; Tallis' formula).
+
+  This class otherwise mirrors ExpectedImprovementEvaluator (and uses the same inputs), so it plugs into the same
+  optimizers.  No random numbers are used; results are deterministic.
+\endrst*/
+template <typename GaussianProcessType>
+class BasicAnalyticExpectedImprovementEvaluator final {
+ public:
+  using StateType = BasicAnalyticExpectedImprovementState<GaussianProcessType>;
+
+  //! largest ``num_union`` supported
+  static constexpr int kMaxNumUnion = kMaxMultivariateNormalCDFDim;
 
   /*!\rst
-    Constructs a OnePotentialSampleExpectedImprovementEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
+    Constructs a AnalyticExpectedImprovementEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
 
     \param
       :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
         that describes the underlying GP
       :best_so_far: best (minimum) objective function value (in ``points_sampled_value``)
   \endrst*/
-  OnePotentialSampleExpectedImprovementEvaluator(const GaussianProcess& gaussian_process_in, double best_so_far);
+  BasicAnalyticExpectedImprovementEvaluator(const GaussianProcessType& gaussian_process_in, double best_so_far);
 
   int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
     return dim_;
   }
 
-  const GaussianProcess * gaussian_process() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+  const GaussianProcessType * gaussian_process() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
     return gaussian_process_;
   }
 
@@ -1039,181 +2268,197 @@ class OnePotentialSampleExpectedImprovementEvaluator final {
   }
 
   /*!\rst
-    Computes the expected improvement ``EI(Xs) = E_n[[f^*_n(X) - min(f(Xs_1),...,f(Xs_m))]^+]``
-
-    Uses analytic formulas to evaluate the expected improvement.
+    Computes the expected improvement ``EI(Xs) = E_n[[f^*_n(X) - min(f(Xs_1),...,f(Xs_m))]^+]`` (see
+    ExpectedImprovementEvaluator::ComputeExpectedImprovement()) using multivariate normal CDFs.
 
     \param
       :ei_state[1]: properly configured state object
     \output
       :ei_state[1]: state with temporary storage modified
     \return
-      the expected improvement from sampling ``point_to_sample``
+      the expected improvement from sampling ``points_to_sample`` with ``points_being_sampled`` concurrent experiments
   \endrst*/
-  double ComputeExpectedImprovement(StateType * ei_state) const;
+  double ComputeExpectedImprovement(StateType * ei_state) const OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
 
   /*!\rst
-    Computes the (partial) derivatives of the expected improvement with respect to the point to sample.
+    Computes the (partial) derivatives of the expected improvement with respect to each point of ``points_to_sample``.
 
-    Uses analytic formulas to evaluate the spatial gradient of the expected improvement.
+    By the Gaussian identities ``\pderiv{E[g(Y)]}{\mu} = E[\nabla g]`` and
+    ``\pderiv{E[g(Y)]}{\Sigma_{ij}} = \frac{1}{2}E[\partial_i\partial_j g]`` (counting ``ij`` and ``ji`` separately),
+    we have ``\pderiv{EI}{\mu_k} = -P_k`` and ``\pderiv{EI}{\Sigma_{ij}} = \frac{1}{2}H_{ij}`` with
+    ``H_{kk} = \sum_i D^{(k)}_i`` and ``H_{ij} = -D^{(j)}_i``; these are chained with the gradients of the GP mean and
+    variance.  So the gradient costs little more than EI itself.
 
     \param
       :ei_state[1]: properly configured state object
     \output
       :ei_state[1]: state with temporary storage modified
-      :grad_EI[dim]: gradient of EI, ``\pderiv{EI(x)}{x_d}``, where ``x`` is ``points_to_sample``
+      :grad_EI[dim][num_to_sample]: gradient of EI, ``\pderiv{EI(Xq \cup Xp)}{Xq_{d,i}}`` where ``Xq`` is ``points_to_sample``
+          and ``Xp`` is ``points_being_sampled``
   \endrst*/
-  void ComputeGradExpectedImprovement(StateType * ei_state, double * restrict grad_EI) const;
+  void ComputeGradExpectedImprovement(StateType * ei_state, double * restrict grad_EI) const OL_NONNULL_POINTERS;
 
-  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(OnePotentialSampleExpectedImprovementEvaluator);
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicAnalyticExpectedImprovementEvaluator);
 
  private:
-  //! spatial dimension (e.g., entries per point of ``points_sampled``)
+  /*!\rst
+    Computes the GP mean and variance at ``union_of_points`` and from them, the win probabilities ``P_k`` and their
+    derivatives ``D^{(k)}_i`` (see class docs).
+
+    \param
+      :ei_state[1]: properly configured state object
+    \output
+      :ei_state[1]: ``to_sample_mean``, ``to_sample_var``, ``win_probability``, ``win_density`` are set
+    \return
+      the expected improvement (before clamping to be non-negative)
+  \endrst*/
+  double ComputeWinProbabilities(StateType * ei_state) const OL_NONNULL_POINTERS;
+
+  //! spatial dimension (e.g., entries per point of points_sampled)
   const int dim_;
-  //! best (minimum) objective function value (in ``points_sampled_value``)
+  //! best (minimum) objective function value (in points_sampled_value)
   double best_so_far_;
-
-  //! normal distribution object
-  const boost::math::normal_distribution<double> normal_;
   //! pointer to gaussian process used in EI computations
-  const GaussianProcess * gaussian_process_;
+  const GaussianProcessType * gaussian_process_;
 };
 
 /*!\rst
-  State object for OnePotentialSampleExpectedImprovementEvaluator.  This tracks the *ONE* ``point_to_sample``
-  being evaluated via expected improvement.
+  State object for AnalyticExpectedImprovementEvaluator.  Like ExpectedImprovementState, this tracks ``points_to_sample``
+  and ``points_being_sampled`` (stored together in ``union_of_points``) and the associated GP state; it has no random
+  number generator.  ``num_union`` may not exceed AnalyticExpectedImprovementEvaluator::kMaxNumUnion.
 
-  This is just a special case of ExpectedImprovementState; see those class docs for more details.
   See general comments on State structs in ``gpp_common.hpp``'s header docs.
 \endrst*/
-struct OnePotentialSampleExpectedImprovementState final {
-  using EvaluatorType = OnePotentialSampleExpectedImprovementEvaluator;
-
-  /*!\rst
-    Constructs an OnePotentialSampleExpectedImprovementState object for the purpose of computing EI
-    (and its gradient) over the specified point to sample.
-    This establishes properly sized/initialized temporaries for EI computation, including dependent state from the
-    associated Gaussian Process (which arrives as part of the ``ei_evaluator``).
+template <typename GaussianProcessType>
+struct BasicAnalyticExpectedImprovementState final {
+  using EvaluatorType = BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>;
 
-    .. WARNING::
-         This object is invalidated if the associated ei_evaluator is mutated.  SetupState() should be called to reset.
+  /*!\rst
+    Constructs an AnalyticExpectedImprovementState object for the purpose of computing EI (and its gradient) over the
+    specified set of points to sample.
+
+    .. WARNING:: This object is invalidated if the associated ei_evaluator is mutated.  SetupState() should be called to reset.
 
     .. WARNING::
          Using this object to compute gradients when ``configure_for_gradients`` := false results in UNDEFINED BEHAVIOR.
 
     \param
       :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
-      :point_to_sample[dim]: point at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test point for GP predictions)
+      :points_to_sample[dim][num_to_sample]: points at which to evaluate EI and/or its gradient to check their value in future experiments (i.e., test points for GP predictions)
+      :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
+      :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+      :num_being_sampled: number of points being sampled in concurrent experiments (i.e., the "p" in q,p-EI)
       :configure_for_gradients: true if this object will be used to compute gradients, false otherwise
+      :normal_rng[1]: UNUSED; present to match the signature of the ctor for ExpectedImprovementState()
   \endrst*/
-  OnePotentialSampleExpectedImprovementState(const EvaluatorType& ei_evaluator,
-                                             double const * restrict point_to_sample_in, bool configure_for_gradients);
-
-  /*!\rst
-    Constructor wrapper to match the signature of the ctor for ExpectedImprovementState().
-  \endrst*/
-  OnePotentialSampleExpectedImprovementState(const EvaluatorType& ei_evaluator,
-                                             double const * restrict points_to_sample,
-                                             double const * restrict OL_UNUSED(points_being_sampled),
-                                             int OL_UNUSED(num_to_sample_in), int OL_UNUSED(num_being_sampled_in),
-                                             bool configure_for_gradients, NormalRNGInterface * OL_UNUSED(normal_rng_in));
+  BasicAnalyticExpectedImprovementState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample,
+                                        double const * restrict points_being_sampled, int num_to_sample_in,
+                                        int num_being_sampled_in, bool configure_for_gradients,
+                                        NormalRNGInterface * OL_UNUSED(normal_rng_in));
 
-  OnePotentialSampleExpectedImprovementState(OnePotentialSampleExpectedImprovementState&& other);
+  BasicAnalyticExpectedImprovementState(BasicAnalyticExpectedImprovementState&& other);
 
   int GetProblemSize() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
-    return dim;
+    return dim*num_to_sample;
   }
 
   /*!\rst
-    Get ``point_to_sample``: the potential future sample whose EI (and/or gradients) is being evaluated
+    Get the ``points_to_sample``: potential future samples whose EI (and/or gradients) are being evaluated
 
     \output
-      :point_to_sample[dim]: potential sample whose EI is being evaluted
+      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
   \endrst*/
-  void GetCurrentPoint(double * restrict point_to_sample_out) const noexcept OL_NONNULL_POINTERS {
-    std::copy(point_to_sample.begin(), point_to_sample.end(), point_to_sample_out);
+  void GetCurrentPoint(double * restrict points_to_sample) const noexcept OL_NONNULL_POINTERS {
+    std::copy(union_of_points.data(), union_of_points.data() + num_to_sample*dim, points_to_sample);
   }
 
   /*!\rst
-    Change the potential sample whose EI (and/or gradient) is being evaluated.
-    Update the state's derived quantities to be consistent with the new point.
+    Change the potential samples whose EI (and/or gradient) are being evaluated.
+    Update the state's derived quantities to be consistent with the new points.
+
+    As with BasicExpectedImprovementState::SetCurrentPoint(), quantities derived from ``points_being_sampled`` alone
+    are reused, so ``ei_evaluator`` must use the same (unmutated) GP as the last SetupState() or construction.
 
     \param
       :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
-      :point_to_sample[dim]: potential future sample whose EI (and/or gradients) is being evaluated
+      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
   \endrst*/
   void SetCurrentPoint(const EvaluatorType& ei_evaluator,
-                          double const * restrict point_to_sample_in) OL_NONNULL_POINTERS;
+                       double const * restrict points_to_sample) OL_NONNULL_POINTERS;
 
   /*!\rst
-    Configures this state object with a new ``point_to_sample``, the location of the potential sample whose EI is to be evaluated.
+    Configures this state object with new ``points_to_sample``, the location of the potential samples whose EI is to be evaluated.
     Ensures all state variables & temporaries are properly sized.
     Properly sets all dependent state variables (e.g., GaussianProcess's state) for EI evaluation.
 
     .. WARNING::
-         This object's state is INVALIDATED if the ei_evaluator (including the GaussianProcess it depends on) used in
+         This object's state is INVALIDATED if the ``ei_evaluator`` (including the GaussianProcess it depends on) used in
          SetupState is mutated! SetupState() should be called again in such a situation.
 
     \param
       :ei_evaluator: expected improvement evaluator object that specifies the parameters & GP for EI evaluation
-      :point_to_sample[dim]: potential future sample whose EI (and/or gradients) is being evaluated
+      :points_to_sample[dim][num_to_sample]: potential future samples whose EI (and/or gradients) are being evaluated
   \endrst*/
-  void SetupState(const EvaluatorType& ei_evaluator,
-                  double const * restrict point_to_sample_in) OL_NONNULL_POINTERS;
+  void SetupState(const EvaluatorType& ei_evaluator, double const * restrict points_to_sample);
 
   // size information
   //! spatial dimension (e.g., entries per point of ``points_sampled``)
   const int dim;
-  //! number of points to sample (i.e., the "q" in q,p-EI); MUST be 1
-  const int num_to_sample = 1;
+  //! number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+  const int num_to_sample;
+  //! number of points being sampled concurrently (i.e., the "p" in q,p-EI)
+  const int num_being_sampled;
   //! number of derivative terms desired (usually 0 for no derivatives or num_to_sample)
   const int num_derivatives;
+  //! number of points in union_of_points: num_to_sample + num_being_sampled
+  const int num_union;
 
-  //! point at which to evaluate EI and/or its gradient (e.g., to check its value in future experiments)
-  std::vector<double> point_to_sample;
+  //! points currently being sampled; this is the union of the points represented by "q" and "p" in q,p-EI
+  //! ``points_to_sample`` is stored first in memory, immediately followed by ``points_being_sampled``
+  std::vector<double> union_of_points;
 
   //! gaussian process state
-  GaussianProcess::StateType points_to_sample_state;
+  typename GaussianProcessType::StateType points_to_sample_state;
 
-  // temporary storage: preallocated space used by OnePotentialSampleExpectedImprovementEvaluator's member functions
-  //! the gradient of the GP mean evaluated at point_to_sample, wrt point_to_sample
+  // temporary storage: preallocated space used by AnalyticExpectedImprovementEvaluator's member functions
+  //! the mean of the GP evaluated at union_of_points
+  std::vector<double> to_sample_mean;
+  //! the gradient of the GP mean evaluated at union_of_points, wrt union_of_points[0:num_to_sample]
   std::vector<double> grad_mu;
-  //! the gradient of the sqrt of the GP variance evaluated at point_to_sample wrt point_to_sample
-  std::vector<double> grad_chol_decomp;
-
-  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(OnePotentialSampleExpectedImprovementState);
+  //! the GP variance evaluated at union_of_points (full symmetric matrix)
+  std::vector<double> to_sample_var;
+  //! the gradient of the GP variance evaluated at union_of_points wrt union_of_points[0:num_to_sample]
+  std::vector<double> grad_var;
+  //! cholesky factor of to_sample_var (only used to detect singular variance matrices)
+  std::vector<double> cholesky_to_sample_var;
+  //! ``b^{(k)}``, the negated mean of the pairwise differences ``W^{(k)}``, for the current ``k``
+  std::vector<double> difference_limits;
+  //! ``S^{(k)}``, the variance of the pairwise differences ``W^{(k)}``, for the current ``k``
+  std::vector<double> difference_var;
+  //! limits of integration of ``W^{(k)}`` conditioned on one component
+  std::vector<double> conditional_limits;
+  //! variance of ``W^{(k)}`` conditioned on one component
+  std::vector<double> conditional_var;
+  //! ``P_k``, the probability that ``union_of_points[k]`` gives the (positive) improvement
+  std::vector<double> win_probability;
+  //! ``D^{(k)}_i = \pderiv{P_k}{b^{(k)}_i}``, stored ``[num_union (k)][num_union (i)]``, i varying fastest
+  std::vector<double> win_density;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(BasicAnalyticExpectedImprovementState);
 };
 
-/*!\rst
-  Set up vector of OnePotentialSampleExpectedImprovementEvaluator::StateType.
-
-  This is a utility function just for reducing code duplication.
-
-  dim is the spatial dimension, ``ei_evaluator.dim()``
+//! analytic q,p-EI evaluator (and its state) for the exact GaussianProcess
+using AnalyticExpectedImprovementEvaluator = BasicAnalyticExpectedImprovementEvaluator<GaussianProcess>;
+using AnalyticExpectedImprovementState = BasicAnalyticExpectedImprovementState<GaussianProcess>;
 
-  \param
-    :ei_evaluator: evaluator object associated w/the state objects being constructed
-    :starting_point[dim]: initial point to load into state (must be a valid point for the problem)
-    :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
-    :configure_for_gradients: true if these state objects will be used to compute gradients, false otherwise
-    :state_vector[arbitrary]: vector of state objects, arbitrary size (usually 0)
-  \output
-    :state_vector[max_num_threads]: vector of states containing ``max_num_threads`` properly initialized state objects
-\endrst*/
-inline OL_NONNULL_POINTERS void SetupExpectedImprovementState(
-    const OnePotentialSampleExpectedImprovementEvaluator& ei_evaluator,
-    double const * restrict starting_point,
-    int max_num_threads,
-    bool configure_for_gradients,
-    std::vector<typename OnePotentialSampleExpectedImprovementEvaluator::StateType> * state_vector) {
-  state_vector->reserve(max_num_threads);
-  for (int i = 0; i < max_num_threads; ++i) {
-    state_vector->emplace_back(ei_evaluator, starting_point, configure_for_gradients);
-  }
-}
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template class BasicAnalyticExpectedImprovementEvaluator<GaussianProcess>;
+extern template class BasicAnalyticExpectedImprovementEvaluator<SparseGaussianProcess>;
+extern template struct BasicAnalyticExpectedImprovementState<GaussianProcess>;
+extern template struct BasicAnalyticExpectedImprovementState<SparseGaussianProcess>;
 
 /*!\rst
-  Set up vector of ExpectedImprovementEvaluator::StateType.
+  Set up vector of AnalyticExpectedImprovementEvaluator::StateType.
 
   This is a utility function just for reducing code duplication.
 
@@ -1227,24 +2472,23 @@ inline OL_NONNULL_POINTERS void SetupExpectedImprovementState(
     :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
     :configure_for_gradients: true if these state objects will be used to compute gradients, false otherwise
     :state_vector[arbitrary]: vector of state objects, arbitrary size (usually 0)
-    :normal_rng[max_num_threads]: a vector of NormalRNG objects that provide the (pesudo)random source for MC integration
   \output
     :state_vector[max_num_threads]: vector of states containing ``max_num_threads`` properly initialized state objects
 \endrst*/
+template <typename GaussianProcessType>
 inline OL_NONNULL_POINTERS void SetupExpectedImprovementState(
-    const ExpectedImprovementEvaluator& ei_evaluator,
+    const BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>& ei_evaluator,
     double const * restrict points_to_sample,
     double const * restrict points_being_sampled,
     int num_to_sample,
     int num_being_sampled,
     int max_num_threads,
     bool configure_for_gradients,
-    NormalRNG * normal_rng,
-    std::vector<typename ExpectedImprovementEvaluator::StateType> * state_vector) {
+    std::vector<BasicAnalyticExpectedImprovementState<GaussianProcessType> > * state_vector) {
   state_vector->reserve(max_num_threads);
   for (int i = 0; i < max_num_threads; ++i) {
     state_vector->emplace_back(ei_evaluator, points_to_sample, points_being_sampled, num_to_sample,
-                               num_being_sampled, configure_for_gradients, normal_rng + i);
+                               num_being_sampled, configure_for_gradients, nullptr);
   }
 }
 
@@ -1275,9 +2519,9 @@ inline OL_NONNULL_POINTERS void SetupExpectedImprovementState(
     :points_being_sampled[dim][num_being_sampled]: points that are being sampled in concurrent experiments
     :num_to_sample: number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
     :num_being_sampled: number of points being sampled concurrently (i.e., the "p" in q,p-EI)
-    :normal_rng[1]: a NormalRNG object that provides the (pesudo)random source for MC integration
+    :normal_rng[1]: a PhiloxNormalRNG object that provides the (pesudo)random source for MC integration
   \output
-    :normal_rng[1]: NormalRNG object will have its state changed due to random draws
+    :normal_rng[1]: PhiloxNormalRNG object will have its state changed due to random draws
     :next_point[dim][num_to_sample]: points yielding the best EI according to gradient descent
 \endrst*/
 template <typename ExpectedImprovementEvaluator, typename DomainType>
@@ -1285,7 +2529,7 @@ void RestartedGradientDescentEIOptimization(const ExpectedImprovementEvaluator&
                                             const GradientDescentParameters& optimizer_parameters,
                                             const DomainType& domain, double const * restrict initial_guess,
                                             double const * restrict points_being_sampled, int num_to_sample,
-                                            int num_being_sampled, NormalRNG * normal_rng,
+                                            int num_being_sampled, PhiloxNormalRNG * normal_rng,
                                             double * restrict next_point) {
   if (unlikely(optimizer_parameters.max_num_restarts <= 0)) {
     return;
@@ -1307,6 +2551,160 @@ void RestartedGradientDescentEIOptimization(const ExpectedImprovementEvaluator&
   ei_state.GetCurrentPoint(next_point);
 }
 
+/*!\rst
+  Runs ``optimizer`` from each of the ``num_multistarts`` starts in ``start_point_set`` on OpenMP threads; used by
+  ComputeOptimalPointsToSampleViaMultistartOptimization().  Calls MultistartOptimizer<...>::MultistartOptimize() if
+  ``adaptive_parameters`` is nullptr and MultistartOptimizeAdaptive() (screening with ``screening_parameters``) otherwise;
+  see those functions for the inputs and outputs.
+\endrst*/
+template <typename Optimizer>
+void MultistartOptimizeExpectedImprovement(
+    const Optimizer& optimizer,
+    const typename Optimizer::ObjectiveFunctionEvaluator& ei_evaluator,
+    const typename Optimizer::ParameterStruct& optimizer_parameters,
+    typename Optimizer::ParameterStruct const * screening_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters,
+    const typename Optimizer::DomainType& domain,
+    const ThreadSchedule& thread_schedule,
+    double const * restrict start_point_set,
+    int num_multistarts,
+    typename Optimizer::ObjectiveFunctionEvaluator::StateType * ei_state_vector,
+    OptimizationIOContainer * restrict io_container) {
+  MultistartOptimizer<Optimizer> multistart_optimizer;
+  if (adaptive_parameters == nullptr) {
+    multistart_optimizer.MultistartOptimize(optimizer, ei_evaluator, optimizer_parameters, domain, thread_schedule,
+                                            start_point_set, num_multistarts, ei_state_vector, nullptr, io_container);
+  } else {
+    multistart_optimizer.MultistartOptimizeAdaptive(optimizer, ei_evaluator, *screening_parameters, optimizer_parameters,
+                                                    *adaptive_parameters, domain, thread_schedule, start_point_set,
+                                                    num_multistarts, ei_state_vector, nullptr, io_container);
+  }
+}
+
+/*!\rst
+  Multistart optimization of q,p-EI with the optimizer ``Optimizer`` (GradientDescentOptimizer or LBFGSOptimizer; see
+  gpp_optimization.hpp), configured by ``optimizer_parameters`` (its ParameterStruct).  Implements
+  ComputeOptimalPointsToSampleViaMultistartGradientDescent() and ComputeOptimalPointsToSampleViaMultistartLBFGS(); see
+  the former for inputs and outputs.  ``DomainType`` must meet the requirements of ``Optimizer`` (e.g., L-BFGS projects
+  onto the domain, so it requires ProjectPointIntoDomain()).
+
+  If ``adaptive_parameters`` is not nullptr, the starts are run with MultistartOptimizer<...>::MultistartOptimizeAdaptive()
+  (successive halving and pruning), with ``screening_parameters`` for the screening rounds.  Then monte-carlo EI runs each
+  start's MC iterations on the OpenMP thread that owns it (no WorkStealingTaskPool).
+
+  ``points_being_sampled`` may be nullptr if ``num_being_sampled == 0``, and ``normal_rng`` may be nullptr if EI is
+  computed analytically (1,0-EI, or ExpectedImprovementEvaluationTypes::kAnalytic with few enough points), so neither is
+  marked nonnull.  The same holds for the GradientDescent and LBFGS wrappers below.
+
+  \param
+    :screening_parameters: ParameterStruct for the screening rounds; nullptr iff ``adaptive_parameters`` is nullptr
+    :adaptive_parameters: AdaptiveMultistartParameters for adaptive multistart; nullptr to optimize every start fully
+\endrst*/
+template <template <typename, typename> class Optimizer, typename ParameterStruct, typename DomainType,
+          typename GaussianProcessType>
+OL_NONNULL_POINTERS_LIST(7, 17, 18) void ComputeOptimalPointsToSampleViaMultistartOptimization(
+    const GaussianProcessType& gaussian_process,
+    const ParameterStruct& optimizer_parameters,
+    ParameterStruct const * screening_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters,
+    const DomainType& domain,
+    const ThreadSchedule& thread_schedule,
+    double const * restrict start_point_set,
+    double const * restrict points_being_sampled,
+    int num_multistarts,
+    int num_to_sample,
+    int num_being_sampled,
+    double best_so_far,
+    int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    PhiloxNormalRNG * normal_rng,
+    bool * restrict found_flag,
+    double * restrict best_next_point) {
+  if (unlikely(num_multistarts <= 0)) {
+    OL_THROW_EXCEPTION(LowerBoundException<int>, "num_multistarts must be > 1", num_multistarts, 1);
+  }
+
+  // EI evaluators for this type of GP
+  using OnePotentialSampleEIEvaluator = BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>;
+  using AnalyticEIEvaluator = BasicAnalyticExpectedImprovementEvaluator<GaussianProcessType>;
+  using EIEvaluator = BasicExpectedImprovementEvaluator<GaussianProcessType>;
+
+  bool configure_for_gradients = true;
+  if (num_to_sample == 1 && num_being_sampled == 0) {
+    // special analytic case when we are not using (or not accounting for) multiple, simultaneous experiments
+    OnePotentialSampleEIEvaluator ei_evaluator(gaussian_process, best_so_far);
+
+    std::vector<typename OnePotentialSampleEIEvaluator::StateType> ei_state_vector;
+    SetupExpectedImprovementState(ei_evaluator, start_point_set, thread_schedule.max_num_threads,
+                                  configure_for_gradients, &ei_state_vector);
+
+    // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
+    OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, start_point_set);
+
+    Optimizer<OnePotentialSampleEIEvaluator, DomainType> optimizer;
+    MultistartOptimizeExpectedImprovement(optimizer, ei_evaluator, optimizer_parameters, screening_parameters,
+                                          adaptive_parameters, domain, thread_schedule, start_point_set,
+                                          num_multistarts, ei_state_vector.data(), &io_container);
+    *found_flag = io_container.found_flag;
+    std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_next_point);
+  } else if (evaluation_type == ExpectedImprovementEvaluationTypes::kAnalytic &&
+             num_to_sample + num_being_sampled <= AnalyticEIEvaluator::kMaxNumUnion) {
+    // few enough points for EI via multivariate normal CDFs; faster and more accurate than monte-carlo
+    AnalyticEIEvaluator ei_evaluator(gaussian_process, best_so_far);
+
+    std::vector<typename AnalyticEIEvaluator::StateType> ei_state_vector;
+    SetupExpectedImprovementState(ei_evaluator, start_point_set, points_being_sampled,
+                                  num_to_sample, num_being_sampled, thread_schedule.max_num_threads,
+                                  configure_for_gradients, &ei_state_vector);
+
+    // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
+    OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, start_point_set);
+
+    using RepeatedDomain = RepeatedDomain<DomainType>;
+    RepeatedDomain repeated_domain(domain, num_to_sample);
+    Optimizer<AnalyticEIEvaluator, RepeatedDomain> optimizer;
+    MultistartOptimizeExpectedImprovement(optimizer, ei_evaluator, optimizer_parameters, screening_parameters,
+                                          adaptive_parameters, repeated_domain, thread_schedule, start_point_set,
+                                          num_multistarts, ei_state_vector.data(), &io_container);
+    *found_flag = io_container.found_flag;
+    std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_next_point);
+  } else {
+    // monte-carlo EI is expensive and its cost varies with how far each start travels, so the starts run on a
+    // work-stealing pool; idle workers also pick up chunks of the MC iterations of the starts still running.
+    // Adaptive multistart balances the load itself (shared queue of starts) and runs on OpenMP threads instead.
+    std::unique_ptr<WorkStealingTaskPool> task_pool;
+    if (adaptive_parameters == nullptr) {
+      task_pool.reset(new WorkStealingTaskPool(thread_schedule.max_num_threads));
+    }
+    EIEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far, integration_type, task_pool.get());
+
+    std::vector<typename EIEvaluator::StateType> ei_state_vector;
+    SetupExpectedImprovementState(ei_evaluator, start_point_set, points_being_sampled,
+                                  num_to_sample, num_being_sampled, thread_schedule.max_num_threads,
+                                  configure_for_gradients, normal_rng, &ei_state_vector);
+
+    // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
+    OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, start_point_set);
+
+    using RepeatedDomain = RepeatedDomain<DomainType>;
+    RepeatedDomain repeated_domain(domain, num_to_sample);
+    Optimizer<EIEvaluator, RepeatedDomain> optimizer;
+    if (adaptive_parameters == nullptr) {
+      MultistartOptimizer<Optimizer<EIEvaluator, RepeatedDomain> > multistart_optimizer;
+      multistart_optimizer.MultistartOptimize(optimizer, ei_evaluator, optimizer_parameters,
+                                              repeated_domain, task_pool.get(), start_point_set,
+                                              num_multistarts,
+                                              ei_state_vector.data(), nullptr, &io_container);
+    } else {
+      MultistartOptimizeExpectedImprovement(optimizer, ei_evaluator, optimizer_parameters, screening_parameters,
+                                            adaptive_parameters, repeated_domain, thread_schedule, start_point_set,
+                                            num_multistarts, ei_state_vector.data(), &io_container);
+    }
+    *found_flag = io_container.found_flag;
+    std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_next_point);
+  }
+}
+
 /*!\rst
   Perform multistart gradient descent (MGD) to solve the q,p-EI problem (see ComputeOptimalPointsToSample and/or
   header docs).  Starts a GD run from each point in ``start_point_set``.  The point corresponding to the
@@ -1324,6 +2722,8 @@ void RestartedGradientDescentEIOptimization(const ExpectedImprovementEvaluator&
 
   Users may prefer to call ComputeOptimalPointsToSample(), which applies other heuristics to improve robustness.
 
+  As in EvaluateEIAtPointList(), the EI evaluator is chosen by problem size and ``evaluation_type``.
+
   Currently, during optimization, we recommend that the coordinates of the initial guesses not differ from the
   coordinates of the optima by more than about 1 order of magnitude. This is a very (VERY!) rough guideline for
   sizing the domain and num_multistarts; i.e., be wary of sets of initial guesses that cover the space too sparsely.
@@ -1343,7 +2743,8 @@ void RestartedGradientDescentEIOptimization(const ExpectedImprovementEvaluator&
       (e.g., number of iterations, tolerances, learning rate)
     :domain: object specifying the domain to optimize over (see ``gpp_domain.hpp``)
     :thread_schedule: struct instructing OpenMP on how to schedule threads; i.e., (suggestions in parens)
-      max_num_threads (num cpu cores), schedule type (omp_sched_dynamic), chunk_size (0).
+      max_num_threads (num cpu cores), schedule type (omp_sched_dynamic), chunk_size (0).  Monte-carlo EI runs on a
+      WorkStealingTaskPool with max_num_threads workers instead, so it ignores schedule type and chunk_size.
     :start_point_set[dim][num_to_sample][num_multistarts]: set of initial guesses for MGD (one block of num_to_sample points per multistart)
     :points_being_sampled[dim][num_being_sampled]: points that are being sampled in concurrent experiments
     :num_multistarts: number of points in set of initial guesses
@@ -1351,16 +2752,19 @@ void RestartedGradientDescentEIOptimization(const ExpectedImprovementEvaluator&
     :num_being_sampled: number of points being sampled concurrently (i.e., the "p" in q,p-EI)
     :best_so_far: value of the best sample so far (must be ``min(points_sampled_value)``)
     :max_int_steps: maximum number of MC iterations
-    :normal_rng[thread_schedule.max_num_threads]: a vector of NormalRNG objects that provide
-      the (pesudo)random source for MC integration
+    :integration_type: source of the sample points for MC integration (pseudo-random or quasi-random)
+    :evaluation_type: how q,p-EI with ``q + p > 1`` is computed: analytically (if ``q + p`` is small enough) or by MC
+    :normal_rng[thread_schedule.max_num_threads]: a vector of PhiloxNormalRNG objects that provide
+      the (pesudo)random source for MC integration; give them all the same seed (start ``i`` draws from stream ``i``,
+      so the result does not depend on thread_schedule)
   \output
-    :normal_rng[thread_schedule.max_num_threads]: NormalRNG objects will have their state changed due to random draws
+    :normal_rng[thread_schedule.max_num_threads]: PhiloxNormalRNG objects will have their state changed due to random draws
     :found_flag[1]: true if ``best_next_point`` corresponds to a nonzero EI
     :best_next_point[dim][num_to_sample]: points yielding the best EI according to MGD
 \endrst*/
-template <typename DomainType>
-OL_NONNULL_POINTERS void ComputeOptimalPointsToSampleViaMultistartGradientDescent(
-    const GaussianProcess& gaussian_process,
+template <typename DomainType, typename GaussianProcessType>
+OL_NONNULL_POINTERS_LIST(5, 15, 16) void ComputeOptimalPointsToSampleViaMultistartGradientDescent(
+    const GaussianProcessType& gaussian_process,
     const GradientDescentParameters& optimizer_parameters,
     const DomainType& domain,
     const ThreadSchedule& thread_schedule,
@@ -1371,54 +2775,64 @@ OL_NONNULL_POINTERS void ComputeOptimalPointsToSampleViaMultistartGradientDescen
     int num_being_sampled,
     double best_so_far,
     int max_int_steps,
-    NormalRNG * normal_rng,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    PhiloxNormalRNG * normal_rng,
     bool * restrict found_flag,
     double * restrict best_next_point) {
-  if (unlikely(num_multistarts <= 0)) {
-    OL_THROW_EXCEPTION(LowerBoundException<int>, "num_multistarts must be > 1", num_multistarts, 1);
-  }
+  ComputeOptimalPointsToSampleViaMultistartOptimization<GradientDescentOptimizer, GradientDescentParameters>(
+      gaussian_process, optimizer_parameters, nullptr, nullptr, domain, thread_schedule, start_point_set, points_being_sampled,
+      num_multistarts, num_to_sample, num_being_sampled, best_so_far, max_int_steps, integration_type, evaluation_type,
+      normal_rng,
+      found_flag, best_next_point);
+}
 
-  bool configure_for_gradients = true;
-  if (num_to_sample == 1 && num_being_sampled == 0) {
-    // special analytic case when we are not using (or not accounting for) multiple, simultaneous experiments
-    OnePotentialSampleExpectedImprovementEvaluator ei_evaluator(gaussian_process, best_so_far);
+/*!\rst
+  Perform multistart (projected) L-BFGS to solve the q,p-EI problem (see ComputeOptimalPointsToSample and/or header
+  docs).  Starts an L-BFGS run from each point in ``start_point_set``.  L-BFGS needs no step size tuning and usually
+  converges in far fewer EI (gradient) evaluations than gradient descent; see LBFGSOptimizer in gpp_optimization.hpp.
 
-    std::vector<typename OnePotentialSampleExpectedImprovementEvaluator::StateType> ei_state_vector;
-    SetupExpectedImprovementState(ei_evaluator, start_point_set, thread_schedule.max_num_threads,
-                                  configure_for_gradients, &ei_state_vector);
+  Identical to ComputeOptimalPointsToSampleViaMultistartGradientDescent() (see it for inputs, outputs, and caveats) except
+  that ``optimizer_parameters`` is an LBFGSParameters object and ``domain`` must be box-shaped (e.g., TensorProductDomain),
+  since L-BFGS projects its iterates onto the domain.
 
-    // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
-    OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, start_point_set);
+  With ``adaptive_parameters``, the starts are screened with a few L-BFGS steps each and only the best survivors are
+  optimized fully (see MultistartOptimizer<...>::MultistartOptimizeAdaptive()); this pays off when ``num_multistarts`` is
+  large.  The screening rounds use LBFGSScreeningParameters().
 
-    GradientDescentOptimizer<OnePotentialSampleExpectedImprovementEvaluator, DomainType> gd_opt;
-    MultistartOptimizer<GradientDescentOptimizer<OnePotentialSampleExpectedImprovementEvaluator, DomainType> > multistart_optimizer;
-    multistart_optimizer.MultistartOptimize(gd_opt, ei_evaluator, optimizer_parameters,
-                                            domain, thread_schedule, start_point_set,
-                                            num_multistarts,
-                                            ei_state_vector.data(), nullptr, &io_container);
-    *found_flag = io_container.found_flag;
-    std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_next_point);
+  \param
+    :adaptive_parameters: AdaptiveMultistartParameters for adaptive multistart; nullptr to optimize every start fully
+  \raise
+    LowerBoundException if ``adaptive_parameters->num_screening_steps < 1``; see MultistartOptimizeAdaptive() for the rest
+\endrst*/
+template <typename DomainType, typename GaussianProcessType>
+OL_NONNULL_POINTERS_LIST(6, 16, 17) void ComputeOptimalPointsToSampleViaMultistartLBFGS(
+    const GaussianProcessType& gaussian_process,
+    const LBFGSParameters& optimizer_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters,
+    const DomainType& domain,
+    const ThreadSchedule& thread_schedule,
+    double const * restrict start_point_set,
+    double const * restrict points_being_sampled,
+    int num_multistarts,
+    int num_to_sample,
+    int num_being_sampled,
+    double best_so_far,
+    int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    PhiloxNormalRNG * normal_rng,
+    bool * restrict found_flag,
+    double * restrict best_next_point) {
+  if (adaptive_parameters == nullptr) {
+    ComputeOptimalPointsToSampleViaMultistartOptimization<LBFGSOptimizer, LBFGSParameters>(
+        gaussian_process, optimizer_parameters, nullptr, nullptr, domain, thread_schedule, start_point_set,
+        points_being_sampled, num_multistarts, num_to_sample, num_being_sampled, best_so_far, max_int_steps,
+        integration_type, evaluation_type, normal_rng, found_flag, best_next_point);
   } else {
-    ExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far);
-
-    std::vector<typename ExpectedImprovementEvaluator::StateType> ei_state_vector;
-    SetupExpectedImprovementState(ei_evaluator, start_point_set, points_being_sampled,
-                                  num_to_sample, num_being_sampled, thread_schedule.max_num_threads,
-                                  configure_for_gradients, normal_rng, &ei_state_vector);
-
-    // init winner to be first point in set and 'force' its value to be 0.0; we cannot do worse than this
-    OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, start_point_set);
-
-    using RepeatedDomain = RepeatedDomain<DomainType>;
-    RepeatedDomain repeated_domain(domain, num_to_sample);
-    GradientDescentOptimizer<ExpectedImprovementEvaluator, RepeatedDomain> gd_opt;
-    MultistartOptimizer<GradientDescentOptimizer<ExpectedImprovementEvaluator, RepeatedDomain> > multistart_optimizer;
-    multistart_optimizer.MultistartOptimize(gd_opt, ei_evaluator, optimizer_parameters,
-                                            repeated_domain, thread_schedule, start_point_set,
-                                            num_multistarts,
-                                            ei_state_vector.data(), nullptr, &io_container);
-    *found_flag = io_container.found_flag;
-    std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_next_point);
+    LBFGSParameters screening_parameters(LBFGSScreeningParameters(optimizer_parameters, *adaptive_parameters));
+    ComputeOptimalPointsToSampleViaMultistartOptimization<LBFGSOptimizer>(
+        gaussian_process, optimizer_parameters, &screening_parameters, adaptive_parameters, domain, thread_schedule,
+        start_point_set, points_being_sampled, num_multistarts, num_to_sample, num_being_sampled, best_so_far,
+        max_int_steps, integration_type, evaluation_type, normal_rng, found_flag, best_next_point);
   }
 }
 
@@ -1445,23 +2859,28 @@ OL_NONNULL_POINTERS void ComputeOptimalPointsToSampleViaMultistartGradientDescen
     :num_being_sampled: number of points being sampled concurrently (i.e., the "p" in q,p-EI)
     :best_so_far: value of the best sample so far (must be ``min(points_sampled_value)``)
     :max_int_steps: maximum number of MC iterations
+    :integration_type: source of the sample points for MC integration (pseudo-random or quasi-random)
+    :evaluation_type: how q,p-EI with ``q + p > 1`` is computed: analytically (if ``q + p`` is small enough) or by MC
     :uniform_generator[1]: a UniformRandomGenerator object providing the random engine for uniform random numbers
-    :normal_rng[thread_schedule.max_num_threads]: a vector of NormalRNG objects that provide
-      the (pesudo)random source for MC integration
+    :normal_rng[thread_schedule.max_num_threads]: a vector of PhiloxNormalRNG objects that provide
+      the (pesudo)random source for MC integration; give them all the same seed (start ``i`` draws from stream ``i``,
+      so the result does not depend on thread_schedule)
   \output
     :found_flag[1]: true if best_next_point corresponds to a nonzero EI
     :uniform_generator[1]: UniformRandomGenerator object will have its state changed due to random draws
-    :normal_rng[thread_schedule.max_num_threads]: NormalRNG objects will have their state changed due to random draws
+    :normal_rng[thread_schedule.max_num_threads]: PhiloxNormalRNG objects will have their state changed due to random draws
     :best_next_point[dim][num_to_sample]: points yielding the best EI according to MGD
 \endrst*/
-template <typename DomainType>
-void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcess& gaussian_process,
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcessType& gaussian_process,
                                                   const GradientDescentParameters& optimizer_parameters,
                                                   const DomainType& domain, const ThreadSchedule& thread_schedule,
                                                   double const * restrict points_being_sampled,
                                                   int num_to_sample, int num_being_sampled, double best_so_far,
-                                                  int max_int_steps, bool * restrict found_flag,
-                                                  UniformRandomGenerator * uniform_generator, NormalRNG * normal_rng,
+                                                  int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                                  ExpectedImprovementEvaluationTypes evaluation_type,
+                                                  bool * restrict found_flag,
+                                                  UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng,
                                                   double * restrict best_next_point) {
   std::vector<double> starting_points(gaussian_process.dim()*optimizer_parameters.num_multistarts*num_to_sample);
 
@@ -1474,6 +2893,7 @@ void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcess& gaussia
                                                            thread_schedule, starting_points.data(),
                                                            points_being_sampled, num_multistarts, num_to_sample,
                                                            num_being_sampled, best_so_far, max_int_steps,
+                                                           integration_type, evaluation_type,
                                                            normal_rng, found_flag, best_next_point);
 #ifdef OL_WARNING_PRINT
   if (false == *found_flag) {
@@ -1484,6 +2904,47 @@ void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcess& gaussia
 #endif
 }
 
+/*!\rst
+  Same as the GradientDescentParameters overload above, except that it runs multistart L-BFGS; i.e., it wraps
+  ComputeOptimalPointsToSampleViaMultistartLBFGS().  ``domain`` must be box-shaped (e.g., TensorProductDomain).
+
+  \param
+    :adaptive_parameters: AdaptiveMultistartParameters for adaptive multistart; nullptr to optimize every start fully
+\endrst*/
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcessType& gaussian_process,
+                                                  const LBFGSParameters& optimizer_parameters,
+                                                  AdaptiveMultistartParameters const * adaptive_parameters,
+                                                  const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                                  double const * restrict points_being_sampled,
+                                                  int num_to_sample, int num_being_sampled, double best_so_far,
+                                                  int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                                  ExpectedImprovementEvaluationTypes evaluation_type,
+                                                  bool * restrict found_flag,
+                                                  UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng,
+                                                  double * restrict best_next_point) {
+  std::vector<double> starting_points(gaussian_process.dim()*optimizer_parameters.num_multistarts*num_to_sample);
+
+  // GenerateUniformPointsInDomain() is allowed to return fewer than the requested number of multistarts
+  RepeatedDomain<DomainType> repeated_domain(domain, num_to_sample);
+  int num_multistarts = repeated_domain.GenerateUniformPointsInDomain(optimizer_parameters.num_multistarts,
+                                                                      uniform_generator, starting_points.data());
+
+  ComputeOptimalPointsToSampleViaMultistartLBFGS(gaussian_process, optimizer_parameters, adaptive_parameters, domain,
+                                                 thread_schedule, starting_points.data(), points_being_sampled,
+                                                 num_multistarts, num_to_sample, num_being_sampled, best_so_far,
+                                                 max_int_steps, integration_type, evaluation_type,
+                                                 normal_rng, found_flag,
+                                                 best_next_point);
+#ifdef OL_WARNING_PRINT
+  if (false == *found_flag) {
+    OL_WARNING_PRINTF("WARNING: %s DID NOT CONVERGE\n", OL_CURRENT_FUNCTION_NAME);
+    OL_WARNING_PRINTF("First multistart point was returned:\n");
+    PrintMatrixTrans(starting_points.data(), num_to_sample, gaussian_process.dim());
+  }
+#endif
+}
+
 /*!\rst
   Function to evaluate Expected Improvement (q,p-EI) over a specified list of ``num_multistarts`` points.
   Optionally outputs the EI at each of these points.
@@ -1493,7 +2954,14 @@ void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcess& gaussia
   This function is also useful for plotting or debugging purposes (just to get a bunch of EI values).
 
   This function is just a wrapper that builds the required state objects and a NullOptimizer object and calls
-  MultistartOptimizer<...>::MultistartOptimize(...); see gpp_optimization.hpp.
+  MultistartOptimizer<...>::MultistartOptimize(...); see gpp_optimization.hpp.  1,0-EI skips all that: the points are
+  scored in blocks by BatchOnePotentialSampleExpectedImprovementEvaluator (one covariance block and multi-RHS solve per
+  block instead of a full state setup per point), which is what makes large latin hypercube searches cheap.
+
+  The EI evaluator is chosen by problem size and ``evaluation_type``: BatchOnePotentialSampleExpectedImprovementEvaluator
+  for 1,0-EI, AnalyticExpectedImprovementEvaluator for ExpectedImprovementEvaluationTypes::kAnalytic if
+  ``num_to_sample + num_being_sampled <= kMaxMultivariateNormalCDFDim``, and monte-carlo (ExpectedImprovementEvaluator;
+  the only one that uses ``max_int_steps``, ``integration_type``, and ``normal_rng``) otherwise.
 
   \param
     :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
@@ -1507,26 +2975,47 @@ void ComputeOptimalPointsToSampleWithRandomStarts(const GaussianProcess& gaussia
     :num_being_sampled: number of points being sampled concurrently (i.e., the "p" in q,p-EI)
     :best_so_far: value of the best sample so far (must be ``min(points_sampled_value)``)
     :max_int_steps: maximum number of MC iterations
-    :normal_rng[thread_schedule.max_num_threads]: a vector of NormalRNG objects that provide
-      the (pesudo)random source for MC integration
+    :integration_type: source of the sample points for MC integration (pseudo-random or quasi-random)
+    :evaluation_type: how q,p-EI with ``q + p > 1`` is computed: analytically (if ``q + p`` is small enough) or by MC
+    :normal_rng[thread_schedule.max_num_threads]: a vector of PhiloxNormalRNG objects that provide
+      the (pesudo)random source for MC integration; give them all the same seed (start ``i`` draws from stream ``i``,
+      so the result does not depend on thread_schedule)
   \output
     :found_flag[1]: true if best_next_point corresponds to a nonzero EI
-    :normal_rng[thread_schedule.max_num_threads]: NormalRNG objects will have their state changed due to random draws
+    :normal_rng[thread_schedule.max_num_threads]: PhiloxNormalRNG objects will have their state changed due to random draws
     :function_values[num_multistarts]: EI evaluated at each point of ``initial_guesses``, in the same order as
       ``initial_guesses``; never dereferenced if nullptr
     :best_next_point[dim][num_to_sample]: points yielding the best EI according to dumb search
 \endrst*/
-void EvaluateEIAtPointList(const GaussianProcess& gaussian_process,
+template <typename GaussianProcessType>
+void EvaluateEIAtPointList(const GaussianProcessType& gaussian_process,
                            const ThreadSchedule& thread_schedule,
                            double const * restrict initial_guesses,
                            double const * restrict points_being_sampled,
                            int num_multistarts, int num_to_sample,
                            int num_being_sampled, double best_so_far,
-                           int max_int_steps,
-                           bool * restrict found_flag, NormalRNG * normal_rng,
+                           int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                           ExpectedImprovementEvaluationTypes evaluation_type,
+                           bool * restrict found_flag, PhiloxNormalRNG * normal_rng,
                            double * restrict function_values,
                            double * restrict best_next_point);
 
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template void EvaluateEIAtPointList(
+    const GaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict initial_guesses, double const * restrict points_being_sampled, int num_multistarts,
+    int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool * restrict found_flag, PhiloxNormalRNG * normal_rng,
+    double * restrict function_values, double * restrict best_next_point);
+extern template void EvaluateEIAtPointList(
+    const SparseGaussianProcess& gaussian_process, const ThreadSchedule& thread_schedule,
+    double const * restrict initial_guesses, double const * restrict points_being_sampled, int num_multistarts,
+    int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool * restrict found_flag, PhiloxNormalRNG * normal_rng,
+    double * restrict function_values, double * restrict best_next_point);
+
 /*!\rst
   Perform a random, naive search to "solve" the q,p-EI problem (see ComputeOptimalPointsToSample and/or
   header docs).  Evaluates EI at ``num_multistarts`` points (e.g., on a latin hypercube) to find the
@@ -1538,6 +3027,8 @@ void EvaluateEIAtPointList(const GaussianProcess& gaussian_process,
   true optima (i.e., the gradient may be substantially nonzero).
 
   Wraps EvaluateEIAtPointList(); constructs the input point list with a uniform random sampling from the given Domain object.
+  For 1,0-EI, the points are scored in blocks (BatchOnePotentialSampleExpectedImprovementEvaluator), so searches over
+  ``10^5`` or more points are practical.
 
   \param
     :gaussian_process: GaussianProcess object (holds ``points_sampled``, ``values``, ``noise_variance``, derived quantities)
@@ -1551,26 +3042,31 @@ void EvaluateEIAtPointList(const GaussianProcess& gaussian_process,
     :num_being_sampled: number of points being sampled concurrently (i.e., the "p" in q,p-EI)
     :best_so_far: value of the best sample so far (must be ``min(points_sampled_value)``)
     :max_int_steps: maximum number of MC iterations
+    :integration_type: source of the sample points for MC integration (pseudo-random or quasi-random)
+    :evaluation_type: how q,p-EI with ``q + p > 1`` is computed: analytically (if ``q + p`` is small enough) or by MC
     :uniform_generator[1]: a UniformRandomGenerator object providing the random engine for uniform random numbers
-    :normal_rng[thread_schedule.max_num_threads]: a vector of NormalRNG objects that provide
-      the (pesudo)random source for MC integration
+    :normal_rng[thread_schedule.max_num_threads]: a vector of PhiloxNormalRNG objects that provide
+      the (pesudo)random source for MC integration; give them all the same seed (start ``i`` draws from stream ``i``,
+      so the result does not depend on thread_schedule)
   \output
     found_flag[1]: true if best_next_point corresponds to a nonzero EI
     :uniform_generator[1]: UniformRandomGenerator object will have its state changed due to random draws
-    :normal_rng[thread_schedule.max_num_threads]: NormalRNG objects will have their state changed due to random draws
+    :normal_rng[thread_schedule.max_num_threads]: PhiloxNormalRNG objects will have their state changed due to random draws
     :best_next_point[dim][num_to_sample]: points yielding the best EI according to dumb search
 \endrst*/
-template <typename DomainType>
-void ComputeOptimalPointsToSampleViaLatinHypercubeSearch(const GaussianProcess& gaussian_process,
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSampleViaLatinHypercubeSearch(const GaussianProcessType& gaussian_process,
                                                          const DomainType& domain,
                                                          const ThreadSchedule& thread_schedule,
                                                          double const * restrict points_being_sampled,
                                                          int num_multistarts, int num_to_sample,
                                                          int num_being_sampled, double best_so_far,
                                                          int max_int_steps,
+                                                         MonteCarloIntegrationTypes integration_type,
+                                                         ExpectedImprovementEvaluationTypes evaluation_type,
                                                          bool * restrict found_flag,
                                                          UniformRandomGenerator * uniform_generator,
-                                                         NormalRNG * normal_rng,
+                                                         PhiloxNormalRNG * normal_rng,
                                                          double * restrict best_next_point) {
   std::vector<double> initial_guesses(gaussian_process.dim()*num_multistarts*num_to_sample);
   RepeatedDomain<DomainType> repeated_domain(domain, num_to_sample);
@@ -1579,7 +3075,7 @@ void ComputeOptimalPointsToSampleViaLatinHypercubeSearch(const GaussianProcess&
 
   EvaluateEIAtPointList(gaussian_process, thread_schedule, initial_guesses.data(),
                         points_being_sampled, num_multistarts, num_to_sample,
-                        num_being_sampled, best_so_far, max_int_steps,
+                        num_being_sampled, best_so_far, max_int_steps, integration_type, evaluation_type,
                         found_flag, normal_rng, nullptr, best_next_point);
 }
 
@@ -1616,43 +3112,107 @@ void ComputeOptimalPointsToSampleViaLatinHypercubeSearch(const GaussianProcess&
     :num_being_sampled: number of points being sampled concurrently (i.e., the p in q,p-EI)
     :best_so_far: value of the best sample so far (must be ``min(points_sampled_value)``)
     :max_int_steps: maximum number of MC iterations
+    :integration_type: source of the sample points for MC integration (pseudo-random or quasi-random)
+    :evaluation_type: how q,p-EI with ``q + p > 1`` is computed: analytically (if ``q + p`` is small enough) or by MC
     :lhc_search_only: whether to ONLY use latin hypercube search (and skip gradient descent EI opt)
     :num_lhc_samples: number of samples to draw if/when doing latin hypercube search
     :uniform_generator[1]: a UniformRandomGenerator object providing the random engine for uniform random numbers
-    :normal_rng[thread_schedule.max_num_threads]: a vector of NormalRNG objects that provide
-      the (pesudo)random source for MC integration
+    :normal_rng[thread_schedule.max_num_threads]: a vector of PhiloxNormalRNG objects that provide
+      the (pesudo)random source for MC integration; give them all the same seed (start ``i`` draws from stream ``i``,
+      so the result does not depend on thread_schedule)
   \output
     :found_flag[1]: true if best_points_to_sample corresponds to a nonzero EI if sampled simultaneously
     :uniform_generator[1]: UniformRandomGenerator object will have its state changed due to random draws
-    :normal_rng[thread_schedule.max_num_threads]: NormalRNG objects will have their state changed due to random draws
+    :normal_rng[thread_schedule.max_num_threads]: PhiloxNormalRNG objects will have their state changed due to random draws
     :best_points_to_sample[num_to_sample*dim]: point yielding the best EI according to MGD
 \endrst*/
-template <typename DomainType>
-void ComputeOptimalPointsToSample(const GaussianProcess& gaussian_process,
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSample(const GaussianProcessType& gaussian_process,
                                   const GradientDescentParameters& optimizer_parameters,
                                   const DomainType& domain, const ThreadSchedule& thread_schedule,
                                   double const * restrict points_being_sampled,
                                   int num_to_sample, int num_being_sampled, double best_so_far,
-                                  int max_int_steps, bool lhc_search_only,
-                                  int num_lhc_samples, bool * restrict found_flag,
+                                  int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                  ExpectedImprovementEvaluationTypes evaluation_type,
+                                  bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
                                   UniformRandomGenerator * uniform_generator,
-                                  NormalRNG * normal_rng, double * restrict best_points_to_sample);
+                                  PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
 
 // template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
 extern template void ComputeOptimalPointsToSample(
     const GaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
     const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
     double const * restrict points_being_sampled, int num_to_sample,
-    int num_being_sampled, double best_so_far, int max_int_steps, bool lhc_search_only,
-    int num_lhc_samples, bool * restrict found_flag, UniformRandomGenerator * uniform_generator,
-    NormalRNG * normal_rng, double * restrict best_points_to_sample);
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag, UniformRandomGenerator * uniform_generator,
+    PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
 extern template void ComputeOptimalPointsToSample(
     const GaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
     const SimplexIntersectTensorProductDomain& domain, const ThreadSchedule& thread_schedule,
     double const * restrict points_being_sampled,
     int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+extern template void ComputeOptimalPointsToSample(
+    const SparseGaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
+    const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled, int num_to_sample,
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+extern template void ComputeOptimalPointsToSample(
+    const SparseGaussianProcess& gaussian_process, const GradientDescentParameters& optimizer_parameters,
+    const SimplexIntersectTensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled,
+    int num_to_sample, int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+
+/*!\rst
+  Same as the GradientDescentParameters overload above, except that the multistart optimization uses (projected) L-BFGS
+  (see ComputeOptimalPointsToSampleViaMultistartLBFGS()).  Only box-shaped domains (TensorProductDomain) are supported.
+
+  \param
+    :optimizer_parameters: LBFGSParameters object that describes the parameters controlling EI optimization
+      (e.g., number of iterations, history size, tolerance)
+    :adaptive_parameters: AdaptiveMultistartParameters for adaptive multistart (see
+      ComputeOptimalPointsToSampleViaMultistartLBFGS()); nullptr to optimize every start fully
+    (all other inputs and outputs are as in the GradientDescentParameters overload)
+\endrst*/
+template <typename DomainType, typename GaussianProcessType>
+void ComputeOptimalPointsToSample(const GaussianProcessType& gaussian_process,
+                                  const LBFGSParameters& optimizer_parameters,
+                                  AdaptiveMultistartParameters const * adaptive_parameters,
+                                  const DomainType& domain, const ThreadSchedule& thread_schedule,
+                                  double const * restrict points_being_sampled,
+                                  int num_to_sample, int num_being_sampled, double best_so_far,
+                                  int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                  ExpectedImprovementEvaluationTypes evaluation_type,
+                                  bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+                                  UniformRandomGenerator * uniform_generator,
+                                  PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+
+// template explicit instantiation declarations, see gpp_common.hpp header comments, item 6
+extern template void ComputeOptimalPointsToSample(
+    const GaussianProcess& gaussian_process, const LBFGSParameters& optimizer_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters, const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled, int num_to_sample,
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
+    bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
+extern template void ComputeOptimalPointsToSample(
+    const SparseGaussianProcess& gaussian_process, const LBFGSParameters& optimizer_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters, const TensorProductDomain& domain, const ThreadSchedule& thread_schedule,
+    double const * restrict points_being_sampled, int num_to_sample,
+    int num_being_sampled, double best_so_far, int max_int_steps,
+    MonteCarloIntegrationTypes integration_type, ExpectedImprovementEvaluationTypes evaluation_type,
     bool lhc_search_only, int num_lhc_samples, bool * restrict found_flag,
-    UniformRandomGenerator * uniform_generator, NormalRNG * normal_rng, double * restrict best_points_to_sample);
+    UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng, double * restrict best_points_to_sample);
 
 }  // end namespace optimal_learning
 
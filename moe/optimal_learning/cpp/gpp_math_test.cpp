@@ -36,6 +36,8 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <vector>
 
@@ -54,6 +56,7 @@
 #include "gpp_optimization.hpp"
 #include "gpp_optimizer_parameters.hpp"
 #include "gpp_random.hpp"
+#include "gpp_task_pool.hpp"
 #include "gpp_test_utils.hpp"
 
 namespace optimal_learning {
@@ -573,6 +576,108 @@ class PingOnePotentialSampleExpectedImprovement final : public PingableMatrixInp
   OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(PingOnePotentialSampleExpectedImprovement);
 };
 
+/*!\rst
+  Supports evaluating expected improvement via AnalyticExpectedImprovementEvaluator (multivariate normal CDFs; no monte-carlo).
+
+  The gradient is taken wrt ``points_to_sample[dim][num_to_sample]``, so this is the ``input_matrix``, ``X_{d,i}``.
+  The other inputs to EI are not differentiated against, so they are taken as input and stored by the constructor.
+
+  The output of EI is a scalar.
+\endrst*/
+class PingAnalyticExpectedImprovement final : public PingableMatrixInputVectorOutputInterface {
+ public:
+  constexpr static char const * const kName = "EI analytic (multivariate normal CDF)";
+
+  PingAnalyticExpectedImprovement(double const * restrict lengths, double const * restrict points_being_sampled, double const * restrict points_sampled, double const * restrict points_sampled_value, double alpha, double best_so_far, int dim, int num_to_sample, int num_being_sampled, int num_sampled, int OL_UNUSED(num_mc_iter)) OL_NONNULL_POINTERS
+      : dim_(dim),
+        num_to_sample_(num_to_sample),
+        num_being_sampled_(num_being_sampled),
+        num_sampled_(num_sampled),
+        gradients_already_computed_(false),
+        noise_variance_(num_sampled_, 0.0),
+        points_sampled_(points_sampled, points_sampled + dim_*num_sampled_),
+        points_sampled_value_(points_sampled_value, points_sampled_value + num_sampled_),
+        points_being_sampled_(points_being_sampled, points_being_sampled + num_being_sampled_*dim_),
+        grad_EI_(num_to_sample_*dim_),
+        sqexp_covariance_(dim_, alpha, lengths),
+        gaussian_process_(sqexp_covariance_, points_sampled_.data(), points_sampled_value_.data(), noise_variance_.data(), dim_, num_sampled_), ei_evaluator_(gaussian_process_, best_so_far) {
+  }
+
+  virtual void GetInputSizes(int * num_rows, int * num_cols) const noexcept override OL_NONNULL_POINTERS {
+    *num_rows = dim_;
+    *num_cols = num_to_sample_;
+  }
+
+  virtual int GetGradientsSize() const noexcept override OL_WARN_UNUSED_RESULT {
+    return dim_*GetOutputSize();
+  }
+
+  virtual int GetOutputSize() const noexcept override OL_WARN_UNUSED_RESULT {
+    return 1;
+  }
+
+  virtual void EvaluateAndStoreAnalyticGradient(double const * restrict points_to_sample, double * restrict gradients) noexcept override OL_NONNULL_POINTERS_LIST(2) {
+    if (gradients_already_computed_ == true) {
+      OL_WARNING_PRINTF("WARNING: grad_EI data already set.  Overwriting...\n");
+    }
+    gradients_already_computed_ = true;
+
+    bool configure_for_gradients = true;
+    AnalyticExpectedImprovementEvaluator::StateType ei_state(ei_evaluator_, points_to_sample, points_being_sampled_.data(), num_to_sample_, num_being_sampled_, configure_for_gradients, nullptr);
+    ei_evaluator_.ComputeGradExpectedImprovement(&ei_state, grad_EI_.data());
+
+    if (gradients != nullptr) {
+      std::copy(grad_EI_.begin(), grad_EI_.end(), gradients);
+    }
+  }
+
+  virtual double GetAnalyticGradient(int row_index, int column_index, int OL_UNUSED(output_index)) const override OL_WARN_UNUSED_RESULT {
+    if (gradients_already_computed_ == false) {
+      OL_THROW_EXCEPTION(OptimalLearningException, "PingAnalyticExpectedImprovement::GetAnalyticGradient() called BEFORE EvaluateAndStoreAnalyticGradient. NO DATA!");
+    }
+
+    return grad_EI_[column_index*dim_ + row_index];
+  }
+
+  virtual void EvaluateFunction(double const * restrict points_to_sample, double * restrict function_values) const noexcept override OL_NONNULL_POINTERS {
+    bool configure_for_gradients = false;
+    AnalyticExpectedImprovementEvaluator::StateType ei_state(ei_evaluator_, points_to_sample, points_being_sampled_.data(), num_to_sample_, num_being_sampled_, configure_for_gradients, nullptr);
+    *function_values = ei_evaluator_.ComputeExpectedImprovement(&ei_state);
+  }
+
+ private:
+  //! spatial dimension (e.g., entries per point of ``points_sampled``)
+  int dim_;
+  //! number of potential future samples; gradients are evaluated wrt these points (i.e., the "q" in q,p-EI)
+  int num_to_sample_;
+  //! number of points being sampled concurrently (i.e., the "p" in q,p-EI)
+  int num_being_sampled_;
+  //! number of points in ``points_sampled``
+  int num_sampled_;
+  //! whether gradients been computed and stored--whether this class is ready for use
+  bool gradients_already_computed_;
+
+  //! ``\sigma_n^2``, the noise variance
+  std::vector<double> noise_variance_;
+  //! coordinates of already-sampled points, ``X``
+  std::vector<double> points_sampled_;
+  //! function values at points_sampled, ``y``
+  std::vector<double> points_sampled_value_;
+  //! points that are being sampled in concurrently experiments
+  std::vector<double> points_being_sampled_;
+  //! the gradient of EI at union_of_points, wrt union_of_points[0:num_to_sample]
+  std::vector<double> grad_EI_;
+
+  //! covariance class (for computing covariance and its gradients)
+  SquareExponential sqexp_covariance_;
+  //! gaussian process used for computations
+  GaussianProcess gaussian_process_;
+  //! expected improvement evaluator object that specifies the parameters & GP for EI evaluation
+  AnalyticExpectedImprovementEvaluator ei_evaluator_;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(PingAnalyticExpectedImprovement);
+};
+
 /*!\rst
   Pings gradients (spatial) of GP components (e.g., mean, variance, cholesky of variance) 50 times with randomly generated test cases
 
@@ -755,6 +860,27 @@ int PingEIOnePotentialSampleTest() {
   return total_errors;
 }
 
+/*!\rst
+  Pings the gradients (spatial) of the analytic (multivariate normal CDF) EI 50 times with randomly generated test cases
+
+  \return
+    number of ping/test failures
+\endrst*/
+int PingEIAnalyticTest() {
+  // the CDF quadrature is accurate to ~1e-15, so keep h large enough that truncation (not rounding) error dominates
+  double epsilon_EI_analytic[2] = {2.0e-2, 4.0e-3};
+  int total_errors = PingEITest<PingAnalyticExpectedImprovement>(2, 0, epsilon_EI_analytic, 5.0e-2, 3.0e-1, 1.0e-18);
+
+  total_errors += PingEITest<PingAnalyticExpectedImprovement>(1, 1, epsilon_EI_analytic, 5.0e-2, 3.0e-1, 1.0e-18);
+
+  total_errors += PingEITest<PingAnalyticExpectedImprovement>(2, 2, epsilon_EI_analytic, 5.0e-2, 3.0e-1, 1.0e-18);
+
+  total_errors += PingEITest<PingAnalyticExpectedImprovement>(3, 1, epsilon_EI_analytic, 5.0e-2, 3.0e-1, 1.0e-18);
+
+  total_errors += PingEITest<PingAnalyticExpectedImprovement>(4, 0, epsilon_EI_analytic, 5.0e-2, 3.0e-1, 1.0e-18);
+  return total_errors;
+}
+
 /*!\rst
   Test cases where analytic EI would attempt to compute 0/0 without variance lower bounds.
 
@@ -849,17 +975,1185 @@ int EIOnePotentialSampleEdgeCasesTest() {
   ei = ei_evaluator.ComputeExpectedImprovement(&ei_state);
   ei_evaluator.ComputeGradExpectedImprovement(&ei_state, &grad_ei);
 
-  if (!CheckDoubleWithinRelative(ei, 0.0, 0.0)) {
-    ++total_errors;
+  if (!CheckDoubleWithinRelative(ei, 0.0, 0.0)) {
+    ++total_errors;
+  }
+  if (!CheckDoubleWithinRelative(grad_ei, 0.0, 0.0)) {
+    ++total_errors;
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("1D analytic EI 0/0 edge case tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("1D analytic EI 0/0 edge case tests passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Tests that GaussianProcess::AddPointsToGP, which extends the existing cholesky factor of ``K`` instead of
+  refactoring it, produces the same GP as one built from scratch on the full set of points.  Points are added in
+  several batches (of sizes 1 and > 1) so that repeated extension is exercised.  The GPs are compared through their
+  mean and variance (which depend on ``K^-1 * y`` and ``L``, respectively) at a set of random test points.
+
+  Also checks that adding a duplicate point to a noiseless GP (a singular pivot in the new block) still
+  falls back to a full refactorization and reports a SingularMatrixException, and that clones share the cholesky
+  factor until one of them is modified.
+
+  \return
+    number of test failures
+\endrst*/
+int GaussianProcessAddPointsTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled_initial = 25;
+  const std::vector<int> batch_sizes = {1, 4, 1, 7};
+  const int num_sampled_total = num_sampled_initial + std::accumulate(batch_sizes.begin(), batch_sizes.end(), 0);
+  const int num_to_sample = 5;
+
+  UniformRandomGenerator uniform_generator(93281);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled_total, num_to_sample, 0, 0.02, uniform_double, &uniform_generator);
+
+  SquareExponential covariance(dim, 1.2, 0.9);
+  GaussianProcess gaussian_process_truth(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                         gp_data.noise_variance.data(), dim, num_sampled_total);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled_initial);
+  int offset = num_sampled_initial;
+  for (auto batch_size : batch_sizes) {
+    gaussian_process.AddPointsToGP(gp_data.points_sampled.data() + offset*dim,
+                                   gp_data.points_sampled_value.data() + offset, gp_data.noise_variance.data() + offset,
+                                   batch_size);
+    offset += batch_size;
+  }
+
+  std::vector<double> mean_truth(num_to_sample);
+  std::vector<double> mean(num_to_sample);
+  std::vector<double> variance_truth(Square(num_to_sample));
+  std::vector<double> variance(Square(num_to_sample));
+  const int num_derivatives = 0;
+  PointsToSampleState points_to_sample_state_truth(gaussian_process_truth, gp_data.points_to_sample.data(),
+                                                   num_to_sample, num_derivatives);
+  PointsToSampleState points_to_sample_state(gaussian_process, gp_data.points_to_sample.data(),
+                                             num_to_sample, num_derivatives);
+  gaussian_process_truth.ComputeMeanOfPoints(points_to_sample_state_truth, mean_truth.data());
+  gaussian_process.ComputeMeanOfPoints(points_to_sample_state, mean.data());
+  gaussian_process_truth.ComputeVarianceOfPoints(&points_to_sample_state_truth, variance_truth.data());
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, variance.data());
+
+  const double tolerance = 5.0e-12;
+  if (!CheckIntEquals(gaussian_process.num_sampled(), num_sampled_total)) {
+    ++total_errors;
+  }
+  for (int i = 0; i < num_to_sample; ++i) {
+    if (!CheckDoubleWithinRelative(mean[i], mean_truth[i], tolerance)) {
+      ++total_errors;
+    }
+    // variance is only valid in the lower triangle
+    for (int j = i; j < num_to_sample; ++j) {
+      if (!CheckDoubleWithinRelative(variance[i*num_to_sample + j], variance_truth[i*num_to_sample + j], tolerance)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // the thread schedule only splits independent work: multithreaded factorization (large enough to be tiled) and
+  // extension reproduce the single-threaded GP exactly
+  {
+    const int num_sampled_large = kCholeskyBlockedMinimumSize + 40;
+    const int num_new_points = 7;
+    std::vector<double> points_sampled_large(dim*(num_sampled_large + num_new_points));
+    std::vector<double> points_sampled_value_large(num_sampled_large + num_new_points);
+    std::vector<double> noise_variance_large(num_sampled_large + num_new_points, 0.02);
+    for (auto& entry : points_sampled_large) {
+      entry = uniform_double(uniform_generator.engine);
+    }
+    for (auto& entry : points_sampled_value_large) {
+      entry = uniform_double(uniform_generator.engine);
+    }
+    GaussianProcess gaussian_process_serial(covariance, points_sampled_large.data(), points_sampled_value_large.data(),
+                                            noise_variance_large.data(), dim, num_sampled_large);
+    GaussianProcess gaussian_process_parallel(covariance, points_sampled_large.data(),
+                                              points_sampled_value_large.data(), noise_variance_large.data(), dim,
+                                              num_sampled_large, ThreadSchedule(4, omp_sched_static));
+    for (auto gaussian_process_ptr : {&gaussian_process_serial, &gaussian_process_parallel}) {
+      gaussian_process_ptr->AddPointsToGP(points_sampled_large.data() + num_sampled_large*dim,
+                                          points_sampled_value_large.data() + num_sampled_large,
+                                          noise_variance_large.data() + num_sampled_large, num_new_points);
+    }
+    const int num_entries = Square(num_sampled_large + num_new_points);
+    if (!std::equal(gaussian_process_serial.K_chol(), gaussian_process_serial.K_chol() + num_entries,
+                    gaussian_process_parallel.K_chol()) ||
+        gaussian_process_serial.K_inv_y() != gaussian_process_parallel.K_inv_y()) {
+      ++total_errors;
+    }
+  }
+
+  // Clone() shares the cholesky factor; modifying either GP copies it first, leaving the other one untouched
+  {
+    GaussianProcess gaussian_process_source(covariance, gp_data.points_sampled.data(),
+                                            gp_data.points_sampled_value.data(), gp_data.noise_variance.data(), dim,
+                                            num_sampled_initial);
+    std::unique_ptr<GaussianProcess> gaussian_process_clone(gaussian_process_source.Clone());
+    const int num_entries = Square(num_sampled_initial);
+    const std::vector<double> K_chol_source(gaussian_process_source.K_chol(),
+                                            gaussian_process_source.K_chol() + num_entries);
+    if (gaussian_process_clone->K_chol() != gaussian_process_source.K_chol()) {
+      ++total_errors;
+    }
+
+    gaussian_process_clone->AddPointsToGP(gp_data.points_sampled.data() + num_sampled_initial*dim,
+                                          gp_data.points_sampled_value.data() + num_sampled_initial,
+                                          gp_data.noise_variance.data() + num_sampled_initial, batch_sizes[1]);
+    if (gaussian_process_clone->K_chol() == gaussian_process_source.K_chol() ||
+        !std::equal(K_chol_source.begin(), K_chol_source.end(), gaussian_process_source.K_chol())) {
+      ++total_errors;
+    }
+
+    std::unique_ptr<GaussianProcess> gaussian_process_second_clone(gaussian_process_source.Clone());
+    std::vector<double> hyperparameters(covariance.GetNumberOfHyperparameters());
+    covariance.GetHyperparameters(hyperparameters.data());
+    hyperparameters[0] *= 2.0;
+    gaussian_process_source.SetCovarianceHyperparameters(hyperparameters.data());
+    if (gaussian_process_second_clone->K_chol() == gaussian_process_source.K_chol() ||
+        !std::equal(K_chol_source.begin(), K_chol_source.end(), gaussian_process_second_clone->K_chol())) {
+      ++total_errors;
+    }
+  }
+
+  // a duplicate point with 0 noise makes the new pivot singular; with alpha = 1 and a single prior point,
+  // L = 1 and S = 1 exactly, so the Schur complement is exactly 0 (no dependence on rounding)
+  {
+    SquareExponential covariance_unit_alpha(dim, 1.0, 0.9);
+    std::vector<double> noise_variance_zero(num_sampled_initial, 0.0);
+    GaussianProcess gaussian_process_noiseless(covariance_unit_alpha, gp_data.points_sampled.data(),
+                                               gp_data.points_sampled_value.data(), noise_variance_zero.data(), dim, 1);
+    bool caught_singular = false;
+    try {
+      gaussian_process_noiseless.AddPointsToGP(gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                               noise_variance_zero.data(), 1);
+    } catch (const SingularMatrixException& exception) {
+      caught_singular = true;
+    }
+    if (!caught_singular) {
+      ++total_errors;
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GP incremental AddPointsToGP tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("GP incremental AddPointsToGP tests passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks SparseGaussianProcess:
+
+  1. VFE with the inducing points equal to ``points_sampled`` reproduces GaussianProcess (mean, variance, and their
+     gradients) up to the inducing point jitter.
+  2. FITC with fewer inducing points than samples: gradients of mean and variance match central finite differences,
+     and variance computed with and without precomputed derivative terms agree.
+  3. EI optimization runs on the FITC GP.
+  4. Zero noise is rejected.
+
+  \return
+    number of test failures
+\endrst*/
+int SparseGaussianProcessTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 20;
+  const int num_inducing = 8;
+  const int num_to_sample = 3;
+
+  UniformRandomGenerator uniform_generator(31415);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, num_to_sample, 0, 0.02, uniform_double, &uniform_generator);
+
+  SquareExponential covariance(dim, 1.2, 0.9);
+
+  // VFE with U = X is the exact GP
+  {
+    GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                     gp_data.noise_variance.data(), dim, num_sampled);
+    SparseGaussianProcess sparse_gaussian_process(covariance, gp_data.points_sampled.data(),
+                                                  gp_data.points_sampled_value.data(), gp_data.noise_variance.data(),
+                                                  gp_data.points_sampled.data(), dim, num_sampled, num_sampled,
+                                                  SparseGaussianProcessTypes::kVFE);
+
+    const int num_derivatives = num_to_sample;
+    PointsToSampleState points_to_sample_state_truth(gaussian_process, gp_data.points_to_sample.data(),
+                                                     num_to_sample, num_derivatives);
+    PointsToSampleState points_to_sample_state(sparse_gaussian_process, gp_data.points_to_sample.data(),
+                                               num_to_sample, num_derivatives);
+
+    std::vector<double> truth(dim*Square(num_to_sample)*num_derivatives);
+    std::vector<double> result(truth.size());
+    const double tolerance = 1.0e-7;
+    auto check_outputs = [&](int size) {
+      for (int i = 0; i < size; ++i) {
+        if (!CheckDoubleWithin(result[i], truth[i], tolerance)) {
+          ++total_errors;
+        }
+      }
+    };
+
+    gaussian_process.ComputeMeanOfPoints(points_to_sample_state_truth, truth.data());
+    sparse_gaussian_process.ComputeMeanOfPoints(points_to_sample_state, result.data());
+    check_outputs(num_to_sample);
+
+    gaussian_process.ComputeGradMeanOfPoints(points_to_sample_state_truth, truth.data());
+    sparse_gaussian_process.ComputeGradMeanOfPoints(points_to_sample_state, result.data());
+    check_outputs(dim*num_derivatives);
+
+    // variance is only valid in the lower triangle; zero the rest so the full matrices can be compared
+    std::fill(truth.begin(), truth.end(), 0.0);
+    std::fill(result.begin(), result.end(), 0.0);
+    gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state_truth, truth.data());
+    sparse_gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, result.data());
+    ZeroUpperTriangle(num_to_sample, truth.data());
+    ZeroUpperTriangle(num_to_sample, result.data());
+    check_outputs(Square(num_to_sample));
+
+    gaussian_process.ComputeGradVarianceOfPoints(&points_to_sample_state_truth, truth.data());
+    sparse_gaussian_process.ComputeGradVarianceOfPoints(&points_to_sample_state, result.data());
+    check_outputs(dim*Square(num_to_sample)*num_derivatives);
+  }
+
+  // FITC with M < N: finite difference checks
+  SparseGaussianProcess sparse_gaussian_process(covariance, gp_data.points_sampled.data(),
+                                                gp_data.points_sampled_value.data(), gp_data.noise_variance.data(),
+                                                gp_data.points_sampled.data(), dim, num_sampled, num_inducing,
+                                                SparseGaussianProcessTypes::kFITC);
+  {
+    const int num_derivatives = num_to_sample;
+    PointsToSampleState points_to_sample_state(sparse_gaussian_process, gp_data.points_to_sample.data(),
+                                               num_to_sample, num_derivatives);
+    std::vector<double> mean(num_to_sample);
+    std::vector<double> variance(Square(num_to_sample));
+    std::vector<double> variance_no_derivatives(Square(num_to_sample));
+    std::vector<double> grad_mu(dim*num_derivatives);
+    std::vector<double> grad_variance(dim*Square(num_to_sample)*num_derivatives);
+    sparse_gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, variance.data());
+    sparse_gaussian_process.ComputeGradMeanOfPoints(points_to_sample_state, grad_mu.data());
+    sparse_gaussian_process.ComputeGradVarianceOfPoints(&points_to_sample_state, grad_variance.data());
+
+    PointsToSampleState points_to_sample_state_no_derivatives(sparse_gaussian_process, gp_data.points_to_sample.data(),
+                                                              num_to_sample, 0);
+    sparse_gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state_no_derivatives,
+                                                    variance_no_derivatives.data());
+    for (int j = 0; j < num_to_sample; ++j) {
+      for (int i = j; i < num_to_sample; ++i) {
+        if (!CheckDoubleWithin(variance_no_derivatives[j*num_to_sample + i], variance[j*num_to_sample + i],
+                               1.0e-12)) {
+          ++total_errors;
+        }
+      }
+    }
+
+    const double epsilon = 1.0e-5;
+    const double tolerance = 1.0e-7;
+    std::vector<double> mean_p(num_to_sample), mean_m(num_to_sample);
+    std::vector<double> variance_p(Square(num_to_sample)), variance_m(Square(num_to_sample));
+    std::vector<double> points_to_sample_shifted(gp_data.points_to_sample);
+    for (int k = 0; k < num_to_sample; ++k) {
+      for (int m = 0; m < dim; ++m) {
+        points_to_sample_shifted[k*dim + m] = gp_data.points_to_sample[k*dim + m] + epsilon;
+        points_to_sample_state_no_derivatives.SetupState(sparse_gaussian_process, points_to_sample_shifted.data(),
+                                                         num_to_sample, 0);
+        sparse_gaussian_process.ComputeMeanOfPoints(points_to_sample_state_no_derivatives, mean_p.data());
+        sparse_gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state_no_derivatives, variance_p.data());
+
+        points_to_sample_shifted[k*dim + m] = gp_data.points_to_sample[k*dim + m] - epsilon;
+        points_to_sample_state_no_derivatives.SetupState(sparse_gaussian_process, points_to_sample_shifted.data(),
+                                                         num_to_sample, 0);
+        sparse_gaussian_process.ComputeMeanOfPoints(points_to_sample_state_no_derivatives, mean_m.data());
+        sparse_gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state_no_derivatives, variance_m.data());
+        points_to_sample_shifted[k*dim + m] = gp_data.points_to_sample[k*dim + m];
+
+        if (!CheckDoubleWithin(grad_mu[k*dim + m], (mean_p[k] - mean_m[k])/(2.0*epsilon), tolerance)) {
+          ++total_errors;
+        }
+        for (int j = 0; j < num_to_sample; ++j) {
+          for (int i = j; i < num_to_sample; ++i) {
+            const int index = j*num_to_sample + i;
+            double finite_difference = (variance_p[index] - variance_m[index])/(2.0*epsilon);
+            if (!CheckDoubleWithin(grad_variance[(k*Square(num_to_sample) + index)*dim + m],
+                                   finite_difference, tolerance)) {
+              ++total_errors;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // EI optimization on the sparse GP
+  {
+    const int num_multistarts = 8;
+    GradientDescentParameters gd_params(num_multistarts, 200, 3, 0, 0.5, 1.0, 1.0, 1.0e-6);
+    std::vector<ClosedInterval> domain_bounds(dim, ClosedInterval(-2.0, 2.0));
+    TensorProductDomain domain(domain_bounds.data(), dim);
+    ThreadSchedule thread_schedule(1, omp_sched_static);
+    PhiloxNormalRNG normal_rng(314);
+    const double best_so_far = *std::min_element(gp_data.points_sampled_value.begin(),
+                                                 gp_data.points_sampled_value.end());
+
+    std::vector<double> points_being_sampled;
+    bool found_flag = false;
+    std::vector<double> best_next_point(dim);
+    ComputeOptimalPointsToSample(sparse_gaussian_process, gd_params, domain, thread_schedule,
+                                 points_being_sampled.data(), 1, 0,
+                                 best_so_far, 1000, MonteCarloIntegrationTypes::kPseudoRandom,
+                                 ExpectedImprovementEvaluationTypes::kMonteCarlo, false, 100,
+                                 &found_flag, &uniform_generator, &normal_rng, best_next_point.data());
+    if (!found_flag || !domain.CheckPointInside(best_next_point.data())) {
+      ++total_errors;
+    }
+  }
+
+  // gp_data.noise_variance = 0 is rejected
+  {
+    std::vector<double> noise_variance_zero(num_sampled, 0.0);
+    bool caught_exception = false;
+    try {
+      SparseGaussianProcess sparse_gaussian_process_noiseless(covariance, gp_data.points_sampled.data(),
+                                                              gp_data.points_sampled_value.data(),
+                                                              noise_variance_zero.data(), gp_data.points_sampled.data(),
+                                                              dim, num_sampled, num_inducing,
+                                                              SparseGaussianProcessTypes::kVFE);
+    } catch (const LowerBoundException<double>& exception) {
+      caught_exception = true;
+    }
+    if (!caught_exception) {
+      ++total_errors;
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("sparse GP tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("sparse GP tests passed\n");
+  }
+
+  return total_errors;
+}
+
+namespace {  // helper for PointsToSampleStateFixedPointsTest
+
+/*!\rst
+  Compares every output of ``gaussian_process`` (mean, variance, and, if ``num_derivatives > 0``, their gradients)
+  computed from ``points_to_sample_state`` against those from a freshly built PointsToSampleState.
+
+  \return
+    number of mismatches
+\endrst*/
+template <typename GaussianProcessType>
+OL_WARN_UNUSED_RESULT int CheckPointsToSampleStateAgainstFresh(const GaussianProcessType& gaussian_process,
+                                                               double const * restrict points_to_sample,
+                                                               int num_to_sample, int num_derivatives,
+                                                               PointsToSampleState * points_to_sample_state) {
+  const int dim = gaussian_process.dim();
+  const double tolerance = 1.0e-12;
+  int total_errors = 0;
+  PointsToSampleState points_to_sample_state_truth(gaussian_process, points_to_sample, num_to_sample,
+                                                   num_derivatives);
+  std::vector<double> truth(dim*Square(num_to_sample)*std::max(num_derivatives, 1));
+  std::vector<double> result(truth.size());
+  auto check_outputs = [&](int size) {
+    for (int i = 0; i < size; ++i) {
+      if (!CheckDoubleWithinRelative(result[i], truth[i], tolerance)) {
+        ++total_errors;
+      }
+    }
+  };
+
+  gaussian_process.ComputeMeanOfPoints(points_to_sample_state_truth, truth.data());
+  gaussian_process.ComputeMeanOfPoints(*points_to_sample_state, result.data());
+  check_outputs(num_to_sample);
+
+  // variance is only valid in the lower triangle
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state_truth, truth.data());
+  gaussian_process.ComputeVarianceOfPoints(points_to_sample_state, result.data());
+  ZeroUpperTriangle(num_to_sample, truth.data());
+  ZeroUpperTriangle(num_to_sample, result.data());
+  check_outputs(Square(num_to_sample));
+
+  if (num_derivatives > 0) {
+    gaussian_process.ComputeGradMeanOfPoints(points_to_sample_state_truth, truth.data());
+    gaussian_process.ComputeGradMeanOfPoints(*points_to_sample_state, result.data());
+    check_outputs(dim*num_derivatives);
+
+    gaussian_process.ComputeGradVarianceOfPoints(&points_to_sample_state_truth, truth.data());
+    gaussian_process.ComputeGradVarianceOfPoints(points_to_sample_state, result.data());
+    check_outputs(dim*Square(num_to_sample)*num_derivatives);
+  }
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+/*!\rst
+  Checks that PointsToSampleState::UpdateMovingPoints() (which reuses the fixed points' derived quantities) matches
+  building a fresh PointsToSampleState, with and without gradients, for GaussianProcess and SparseGaussianProcess.
+  Also checks that a GP that has been mutated (SetCovarianceHyperparameters, AddPointsToGP) since the state was
+  filled, or a clone that has diverged from it, is detected and triggers a full recompute.
+
+  \return
+    number of test failures
+\endrst*/
+int PointsToSampleStateFixedPointsTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 20;
+  const int num_moving = 2;
+  const int num_fixed = 3;
+  const int num_to_sample = num_moving + num_fixed;
+  const int num_steps = 3;
+
+  UniformRandomGenerator uniform_generator(2718);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  // points_to_sample holds the initial point set, then the replacement moving points for each step
+  RandomGaussianProcessData gp_data(dim, num_sampled + 1, num_to_sample + num_moving*num_steps, 0, 0.02, uniform_double,
+                                    &uniform_generator);
+
+  SquareExponential covariance(dim, 1.2, 0.9);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  SparseGaussianProcess sparse_gaussian_process(covariance, gp_data.points_sampled.data(),
+                                                gp_data.points_sampled_value.data(), gp_data.noise_variance.data(),
+                                                gp_data.points_sampled.data(), dim, num_sampled, 8,
+                                                SparseGaussianProcessTypes::kFITC);
+
+  std::vector<double> union_of_points(gp_data.points_to_sample.begin(),
+                                      gp_data.points_to_sample.begin() + dim*num_to_sample);
+  for (int num_derivatives : {0, num_moving}) {
+    std::copy(gp_data.points_to_sample.begin(), gp_data.points_to_sample.begin() + dim*num_to_sample,
+              union_of_points.begin());
+    PointsToSampleState state(gaussian_process, union_of_points.data(), num_to_sample, num_derivatives, num_fixed);
+    PointsToSampleState sparse_state(sparse_gaussian_process, union_of_points.data(), num_to_sample,
+                                     num_derivatives, num_fixed);
+    for (int step = 0; step < num_steps; ++step) {
+      double const * restrict points_moving = gp_data.points_to_sample.data() + dim*num_to_sample + dim*num_moving*step;
+      std::copy(points_moving, points_moving + dim*num_moving, union_of_points.begin());
+      state.UpdateMovingPoints(gaussian_process, points_moving);
+      sparse_state.UpdateMovingPoints(sparse_gaussian_process, points_moving);
+      total_errors += CheckPointsToSampleStateAgainstFresh(gaussian_process, union_of_points.data(), num_to_sample,
+                                                           num_derivatives, &state);
+      total_errors += CheckPointsToSampleStateAgainstFresh(sparse_gaussian_process, union_of_points.data(),
+                                                           num_to_sample, num_derivatives, &sparse_state);
+    }
+  }
+
+  // changing the hyperparameters keeps every size the same; the cached columns must still not be reused
+  {
+    PointsToSampleState state(gaussian_process, union_of_points.data(), num_to_sample, num_moving, num_fixed);
+    PointsToSampleState sparse_state(sparse_gaussian_process, union_of_points.data(), num_to_sample, num_moving,
+                                     num_fixed);
+    SquareExponential covariance_new(dim, 0.8, 1.4);
+    std::vector<double> hyperparameters_new(covariance_new.GetNumberOfHyperparameters());
+    covariance_new.GetHyperparameters(hyperparameters_new.data());
+    gaussian_process.SetCovarianceHyperparameters(hyperparameters_new.data());
+    sparse_gaussian_process.SetCovarianceHyperparameters(hyperparameters_new.data());
+    state.UpdateMovingPoints(gaussian_process, union_of_points.data());
+    sparse_state.UpdateMovingPoints(sparse_gaussian_process, union_of_points.data());
+    total_errors += CheckPointsToSampleStateAgainstFresh(gaussian_process, union_of_points.data(), num_to_sample,
+                                                         num_moving, &state);
+    total_errors += CheckPointsToSampleStateAgainstFresh(sparse_gaussian_process, union_of_points.data(),
+                                                         num_to_sample, num_moving, &sparse_state);
+  }
+
+  // adding a point to the GP changes num_sampled; the cached columns must not be reused
+  {
+    PointsToSampleState state(gaussian_process, union_of_points.data(), num_to_sample, num_moving, num_fixed);
+    gaussian_process.AddPointsToGP(gp_data.points_sampled.data() + dim*num_sampled,
+                                   gp_data.points_sampled_value.data() + num_sampled,
+                                   gp_data.noise_variance.data() + num_sampled, 1);
+    state.UpdateMovingPoints(gaussian_process, union_of_points.data());
+    total_errors += CheckPointsToSampleStateAgainstFresh(gaussian_process, union_of_points.data(), num_to_sample,
+                                                         num_moving, &state);
+  }
+
+  // a clone shares its source's generation until either is mutated
+  {
+    std::unique_ptr<GaussianProcess> gaussian_process_clone(gaussian_process.Clone());
+    PointsToSampleState state(*gaussian_process_clone, union_of_points.data(), num_to_sample, num_moving, num_fixed);
+    if (gaussian_process_clone->generation() != gaussian_process.generation()) {
+      ++total_errors;
+    }
+    std::vector<double> hyperparameters_old(covariance.GetNumberOfHyperparameters());
+    covariance.GetHyperparameters(hyperparameters_old.data());
+    gaussian_process.SetCovarianceHyperparameters(hyperparameters_old.data());
+    if (gaussian_process_clone->generation() == gaussian_process.generation()) {
+      ++total_errors;
+    }
+    state.UpdateMovingPoints(gaussian_process, union_of_points.data());
+    total_errors += CheckPointsToSampleStateAgainstFresh(gaussian_process, union_of_points.data(), num_to_sample,
+                                                         num_moving, &state);
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("PointsToSampleState fixed points tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("PointsToSampleState fixed points tests passed\n");
+  }
+
+  return total_errors;
+}
+
+namespace {  // helper for BatchOnePotentialSampleExpectedImprovementTest
+
+/*!\rst
+  Compares ``gaussian_process.ComputeMeanAndMarginalVarianceOfPoints()`` against the mean and variance diagonal from a
+  PointsToSampleState holding each point, and BatchOnePotentialSampleExpectedImprovementEvaluator against
+  OnePotentialSampleExpectedImprovementEvaluator.
+
+  \return
+    number of mismatches
+\endrst*/
+template <typename GaussianProcessType>
+OL_WARN_UNUSED_RESULT int CheckBatchOnePotentialSampleAgainstPointwise(const GaussianProcessType& gaussian_process,
+                                                                       double const * restrict points_to_sample,
+                                                                       int num_points, double best_so_far) {
+  const int dim = gaussian_process.dim();
+  const double tolerance = 1.0e-12;
+  int total_errors = 0;
+
+  std::vector<double> mean(num_points);
+  std::vector<double> variance(num_points);
+  gaussian_process.ComputeMeanAndMarginalVarianceOfPoints(points_to_sample, num_points, mean.data(), variance.data());
+  for (int i = 0; i < num_points; ++i) {
+    PointsToSampleState points_to_sample_state(gaussian_process, points_to_sample + i*dim, 1, 0);
+    double mean_truth;
+    double variance_truth;
+    gaussian_process.ComputeMeanOfPoints(points_to_sample_state, &mean_truth);
+    gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, &variance_truth);
+    if (!CheckDoubleWithinRelative(mean[i], mean_truth, tolerance)) {
+      ++total_errors;
+    }
+    if (!CheckDoubleWithinRelative(variance[i], variance_truth, tolerance)) {
+      ++total_errors;
+    }
+  }
+
+  BasicBatchOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType> batch_ei_evaluator(gaussian_process,
+                                                                                                   best_so_far);
+  BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType> ei_evaluator(gaussian_process,
+                                                                                        best_so_far);
+  std::vector<double> ei_values(num_points);
+  batch_ei_evaluator.ComputeExpectedImprovement(points_to_sample, num_points, ei_values.data());
+  for (int i = 0; i < num_points; ++i) {
+    bool configure_for_gradients = false;
+    typename BasicOnePotentialSampleExpectedImprovementEvaluator<GaussianProcessType>::StateType ei_state(
+        ei_evaluator, points_to_sample + i*dim, configure_for_gradients);
+    // tiny EI (far from improvement) is dominated by cancellation error, so compare absolutely
+    if (!CheckDoubleWithin(ei_values[i], ei_evaluator.ComputeExpectedImprovement(&ei_state), tolerance)) {
+      ++total_errors;
+    }
+  }
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+/*!\rst
+  Checks that BatchOnePotentialSampleExpectedImprovementEvaluator (and the GP's block mean/variance kernel underneath
+  it) matches scoring each point separately, for GaussianProcess and SparseGaussianProcess.  ``num_points`` is chosen
+  so that the last block is partial.
+
+  \return
+    number of test failures
+\endrst*/
+int BatchOnePotentialSampleExpectedImprovementTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 30;
+  const int num_points = 2*BatchOnePotentialSampleExpectedImprovementEvaluator::kBlockSize + 7;
+
+  UniformRandomGenerator uniform_generator(1618);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, num_points, 0, 0.01, uniform_double, &uniform_generator);
+  const double best_so_far = *std::min_element(gp_data.points_sampled_value.begin(),
+                                               gp_data.points_sampled_value.end());
+
+  SquareExponential covariance(dim, 1.0, 0.8);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  SparseGaussianProcess sparse_gaussian_process(covariance, gp_data.points_sampled.data(),
+                                                gp_data.points_sampled_value.data(), gp_data.noise_variance.data(),
+                                                gp_data.points_sampled.data(), dim, num_sampled, 10,
+                                                SparseGaussianProcessTypes::kVFE);
+
+  total_errors += CheckBatchOnePotentialSampleAgainstPointwise(gaussian_process, gp_data.points_to_sample.data(),
+                                                               num_points, best_so_far);
+  total_errors += CheckBatchOnePotentialSampleAgainstPointwise(sparse_gaussian_process, gp_data.points_to_sample.data(),
+                                                               num_points, best_so_far);
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("batched 1,0-EI tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("batched 1,0-EI tests passed\n");
+  }
+
+  return total_errors;
+}
+
+namespace {  // helper for MarginalPredictionPointListTest
+
+/*!\rst
+  Compares ComputeMeanAndMarginalVarianceOfPointList() (single and multithreaded) against the mean and variance
+  diagonal from a PointsToSampleState holding each point.
+
+  \return
+    number of mismatches
+\endrst*/
+template <typename GaussianProcessType>
+OL_WARN_UNUSED_RESULT int CheckMarginalPredictionAgainstPointwise(const GaussianProcessType& gaussian_process,
+                                                                  double const * restrict points_to_sample,
+                                                                  int num_points) {
+  const int dim = gaussian_process.dim();
+  const double tolerance = 1.0e-12;
+  int total_errors = 0;
+
+  std::vector<double> mean(num_points);
+  std::vector<double> variance(num_points);
+  ThreadSchedule thread_schedule(1, omp_sched_static);
+  ComputeMeanAndMarginalVarianceOfPointList(gaussian_process, thread_schedule, points_to_sample, num_points,
+                                            mean.data(), variance.data());
+  for (int i = 0; i < num_points; ++i) {
+    PointsToSampleState points_to_sample_state(gaussian_process, points_to_sample + i*dim, 1, 0);
+    double mean_truth;
+    double variance_truth;
+    gaussian_process.ComputeMeanOfPoints(points_to_sample_state, &mean_truth);
+    gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, &variance_truth);
+    if (!CheckDoubleWithinRelative(mean[i], mean_truth, tolerance)) {
+      ++total_errors;
+    }
+    if (!CheckDoubleWithinRelative(variance[i], variance_truth, tolerance)) {
+      ++total_errors;
+    }
+  }
+
+  // chunks are fixed, so the thread count cannot change the results
+  std::vector<double> mean_multithreaded(num_points);
+  std::vector<double> variance_multithreaded(num_points);
+  ThreadSchedule thread_schedule_multithreaded(4, omp_sched_dynamic);
+  ComputeMeanAndMarginalVarianceOfPointList(gaussian_process, thread_schedule_multithreaded, points_to_sample,
+                                            num_points, mean_multithreaded.data(), variance_multithreaded.data());
+  if (mean_multithreaded != mean || variance_multithreaded != variance) {
+    ++total_errors;
+  }
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+/*!\rst
+  Checks that ComputeMeanAndMarginalVarianceOfPointList() matches the per-point mean and variance for GaussianProcess
+  and SparseGaussianProcess, independent of the number of threads.  ``num_points`` is chosen so that the last chunk is
+  partial.
+
+  \return
+    number of test failures
+\endrst*/
+int MarginalPredictionPointListTest() {
+  int total_errors = 0;
+
+  const int dim = 2;
+  const int num_sampled = 200;
+  const int chunk_size = MarginalPredictionChunkSize(num_sampled);
+  const int num_points = 2*chunk_size + 7;
+  if (!CheckIntEquals(MarginalPredictionChunkSize(1), 1024) || !CheckIntEquals(MarginalPredictionChunkSize(100000), 64)) {
+    ++total_errors;
+  }
+
+  UniformRandomGenerator uniform_generator(2236);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, num_points, 0, 0.01, uniform_double, &uniform_generator);
+
+  SquareExponential covariance(dim, 1.0, 0.8);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  SparseGaussianProcess sparse_gaussian_process(covariance, gp_data.points_sampled.data(),
+                                                gp_data.points_sampled_value.data(), gp_data.noise_variance.data(),
+                                                gp_data.points_sampled.data(), dim, num_sampled, 20,
+                                                SparseGaussianProcessTypes::kVFE);
+
+  total_errors += CheckMarginalPredictionAgainstPointwise(gaussian_process, gp_data.points_to_sample.data(),
+                                                          num_points);
+  total_errors += CheckMarginalPredictionAgainstPointwise(sparse_gaussian_process, gp_data.points_to_sample.data(),
+                                                          num_points);
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("chunked mean/marginal variance tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("chunked mean/marginal variance tests passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that the batched monte-carlo loops in ExpectedImprovementEvaluator (kEIMonteCarloBatchSize draws at a time)
+  match evaluating one iteration at a time.  The reference calls the same evaluator with ``num_mc_iterations = 1``
+  repeatedly, continuing the same normal RNG stream, and averages.  ``num_mc_iterations`` is chosen so that the
+  last batch is partial.
+
+  \return
+    number of test failures
+\endrst*/
+int ExpectedImprovementMonteCarloBatchTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 20;
+  const int num_to_sample = 3;
+  const int num_being_sampled = 2;
+  const int num_mc_iterations = 2*kEIMonteCarloBatchSize + 37;
+  const double best_so_far = 0.5;
+
+  UniformRandomGenerator uniform_generator(60149);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, num_to_sample, num_being_sampled, 0.01, uniform_double,
+                                    &uniform_generator);
+
+  SquareExponential covariance(dim, 1.0, 1.2);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  ExpectedImprovementEvaluator ei_evaluator(gaussian_process, num_mc_iterations, best_so_far);
+  ExpectedImprovementEvaluator ei_evaluator_reference(gaussian_process, 1, best_so_far);
+
+  const double tolerance = 1.0e-13;
+  const int seed = 8317;
+  NormalRNG normal_rng(seed);
+  ExpectedImprovementState ei_state(ei_evaluator, gp_data.points_to_sample.data(), gp_data.points_being_sampled.data(),
+                                    num_to_sample, num_being_sampled, true, &normal_rng);
+  NormalRNG normal_rng_reference(seed);
+  ExpectedImprovementState ei_state_reference(ei_evaluator_reference, gp_data.points_to_sample.data(),
+                                              gp_data.points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                              true, &normal_rng_reference);
+
+  {
+    double ei = ei_evaluator.ComputeExpectedImprovement(&ei_state);
+    double ei_reference = 0.0;
+    for (int i = 0; i < num_mc_iterations; ++i) {
+      ei_reference += ei_evaluator_reference.ComputeExpectedImprovement(&ei_state_reference);
+    }
+    ei_reference /= static_cast<double>(num_mc_iterations);
+    if (!CheckDoubleWithinRelative(ei, ei_reference, tolerance)) {
+      ++total_errors;
+    }
+    // the test is vacuous if no iteration improved
+    if (!(ei > 0.0)) {
+      ++total_errors;
+    }
+  }
+
+  {
+    normal_rng.ResetToMostRecentSeed();
+    normal_rng_reference.ResetToMostRecentSeed();
+    std::vector<double> grad_ei(dim*num_to_sample);
+    std::vector<double> grad_ei_reference(dim*num_to_sample, 0.0);
+    std::vector<double> grad_ei_this_step(dim*num_to_sample);
+    ei_evaluator.ComputeGradExpectedImprovement(&ei_state, grad_ei.data());
+    for (int i = 0; i < num_mc_iterations; ++i) {
+      ei_evaluator_reference.ComputeGradExpectedImprovement(&ei_state_reference, grad_ei_this_step.data());
+      for (int k = 0; k < dim*num_to_sample; ++k) {
+        grad_ei_reference[k] += grad_ei_this_step[k];
+      }
+    }
+    for (int k = 0; k < dim*num_to_sample; ++k) {
+      grad_ei_reference[k] /= static_cast<double>(num_mc_iterations);
+      if (!CheckDoubleWithinRelative(grad_ei[k], grad_ei_reference[k], tolerance)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("batched monte-carlo EI tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("batched monte-carlo EI tests passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that monte-carlo EI and grad EI split across a WorkStealingTaskPool (chunks of kEIMonteCarloChunkSize MC
+  iterations run as nested tasks) are bitwise identical to the same evaluation on one thread.  The pooled evaluations run
+  inside ParallelFor() (so chunks really are shared between workers), with ``num_mc_iterations`` chosen so that the
+  last chunk is partial.
+
+  \return
+    number of test failures
+\endrst*/
+int ExpectedImprovementTaskPoolTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 20;
+  const int num_to_sample = 3;
+  const int num_being_sampled = 2;
+  const int num_mc_iterations = 5*kEIMonteCarloChunkSize + 37;
+  const double best_so_far = 0.5;
+  const int num_workers = 4;
+  const int num_evaluations = 2*num_workers;
+  const int stream = 3;
+
+  UniformRandomGenerator uniform_generator(28411);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, num_to_sample, num_being_sampled, 0.01, uniform_double,
+                                    &uniform_generator);
+
+  SquareExponential covariance(dim, 1.0, 1.2);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+
+  const int seed = 5227;
+  ExpectedImprovementEvaluator ei_evaluator_reference(gaussian_process, num_mc_iterations, best_so_far);
+  PhiloxNormalRNG normal_rng_reference(seed);
+  ExpectedImprovementState ei_state_reference(ei_evaluator_reference, gp_data.points_to_sample.data(),
+                                              gp_data.points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                              true, &normal_rng_reference);
+  ei_state_reference.SetStream(stream);
+  const double ei_reference = ei_evaluator_reference.ComputeExpectedImprovement(&ei_state_reference);
+  std::vector<double> grad_ei_reference(dim*num_to_sample);
+  ei_evaluator_reference.ComputeGradExpectedImprovement(&ei_state_reference, grad_ei_reference.data());
+  // the test is vacuous if no iteration improved
+  if (!(ei_reference > 0.0)) {
+    ++total_errors;
+  }
+
+  WorkStealingTaskPool task_pool(num_workers);
+  ExpectedImprovementEvaluator ei_evaluator(gaussian_process, num_mc_iterations, best_so_far,
+                                            MonteCarloIntegrationTypes::kPseudoRandom, &task_pool);
+  std::vector<PhiloxNormalRNG> normal_rng_vec(num_workers, PhiloxNormalRNG(seed));
+  std::vector<ExpectedImprovementState> ei_state_vector;
+  SetupExpectedImprovementState(ei_evaluator, gp_data.points_to_sample.data(), gp_data.points_being_sampled.data(),
+                                num_to_sample, num_being_sampled, num_workers, true, normal_rng_vec.data(),
+                                &ei_state_vector);
+
+  std::vector<double> ei(num_evaluations + 1);
+  std::vector<double> grad_ei((num_evaluations + 1)*dim*num_to_sample);
+  task_pool.ParallelFor(num_evaluations, [&](int i, int worker_id) {
+      ExpectedImprovementState * ei_state = ei_state_vector.data() + worker_id;
+      ei_state->SetStream(stream);
+      ei[i] = ei_evaluator.ComputeExpectedImprovement(ei_state);
+      ei_evaluator.ComputeGradExpectedImprovement(ei_state, grad_ei.data() + i*dim*num_to_sample);
+    });
+  // outside of ParallelFor(), the chunks run inline
+  ei_state_vector[0].SetStream(stream);
+  ei[num_evaluations] = ei_evaluator.ComputeExpectedImprovement(ei_state_vector.data());
+  ei_evaluator.ComputeGradExpectedImprovement(ei_state_vector.data(), grad_ei.data() + num_evaluations*dim*num_to_sample);
+
+  for (int i = 0; i <= num_evaluations; ++i) {
+    if (!CheckDoubleWithinRelative(ei[i], ei_reference, 0.0)) {
+      ++total_errors;
+    }
+    for (int k = 0; k < dim*num_to_sample; ++k) {
+      if (!CheckDoubleWithinRelative(grad_ei[i*dim*num_to_sample + k], grad_ei_reference[k], 0.0)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("monte-carlo EI on a task pool tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("monte-carlo EI on a task pool tests passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks randomized quasi-monte-carlo (QMC) integration of q,p-EI against a high-accuracy pseudo-random estimate:
+
+  1. QMC (and pseudo-random) EI agree with the reference within a few (combined) standard errors
+  2. The QMC standard error is well below the pseudo-random standard error at the same number of iterations
+  3. ComputeExpectedImprovement() and ComputeExpectedImprovementWithErrorEstimate() agree exactly in QMC mode
+  4. The QMC gradient agrees with a high-accuracy pseudo-random gradient
+
+  \return
+    number of test failures
+\endrst*/
+int ExpectedImprovementQuasiMonteCarloTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 20;
+  const int num_to_sample = 3;
+  const int num_being_sampled = 2;
+  const int num_mc_iterations = 8192;
+  const int num_mc_iterations_reference = 4000000;
+  const double best_so_far = 0.5;
+
+  UniformRandomGenerator uniform_generator(71933);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, num_to_sample, num_being_sampled, 0.01, uniform_double,
+                                    &uniform_generator);
+
+  SquareExponential covariance(dim, 1.0, 1.2);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  ExpectedImprovementEvaluator ei_evaluator_qmc(gaussian_process, num_mc_iterations, best_so_far,
+                                                MonteCarloIntegrationTypes::kQuasiRandom);
+  ExpectedImprovementEvaluator ei_evaluator_mc(gaussian_process, num_mc_iterations, best_so_far,
+                                               MonteCarloIntegrationTypes::kPseudoRandom);
+  ExpectedImprovementEvaluator ei_evaluator_reference(gaussian_process, num_mc_iterations_reference, best_so_far,
+                                                      MonteCarloIntegrationTypes::kPseudoRandom);
+
+  NormalRNG normal_rng(6173);
+  ExpectedImprovementState ei_state_qmc(ei_evaluator_qmc, gp_data.points_to_sample.data(),
+                                        gp_data.points_being_sampled.data(), num_to_sample, num_being_sampled, true,
+                                        &normal_rng);
+  ExpectedImprovementState ei_state_mc(ei_evaluator_mc, gp_data.points_to_sample.data(),
+                                       gp_data.points_being_sampled.data(), num_to_sample, num_being_sampled, false,
+                                       &normal_rng);
+  ExpectedImprovementState ei_state_reference(ei_evaluator_reference, gp_data.points_to_sample.data(),
+                                              gp_data.points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                              true, &normal_rng);
+
+  double standard_error_reference;
+  double ei_reference = ei_evaluator_reference.ComputeExpectedImprovementWithErrorEstimate(&ei_state_reference,
+                                                                                           &standard_error_reference);
+  double standard_error_mc;
+  double ei_mc = ei_evaluator_mc.ComputeExpectedImprovementWithErrorEstimate(&ei_state_mc, &standard_error_mc);
+
+  normal_rng.SetExplicitSeed(3701);
+  double standard_error_qmc;
+  double ei_qmc = ei_evaluator_qmc.ComputeExpectedImprovementWithErrorEstimate(&ei_state_qmc, &standard_error_qmc);
+  // the test is vacuous if no iteration improved
+  if (!(ei_reference > 0.0)) {
+    ++total_errors;
+  }
+  if (std::fabs(ei_mc - ei_reference) > 5.0*std::sqrt(Square(standard_error_mc) + Square(standard_error_reference))) {
+    ++total_errors;
+  }
+  if (std::fabs(ei_qmc - ei_reference) > 5.0*std::sqrt(Square(standard_error_qmc) + Square(standard_error_reference))) {
+    ++total_errors;
+  }
+  if (!(standard_error_qmc > 0.0 && standard_error_qmc < 0.5*standard_error_mc)) {
+    ++total_errors;
+  }
+
+  normal_rng.ResetToMostRecentSeed();
+  if (ei_evaluator_qmc.ComputeExpectedImprovement(&ei_state_qmc) != ei_qmc) {
+    ++total_errors;
+  }
+
+  {
+    std::vector<double> grad_ei_qmc(dim*num_to_sample);
+    std::vector<double> grad_ei_reference(dim*num_to_sample);
+    ei_evaluator_qmc.ComputeGradExpectedImprovement(&ei_state_qmc, grad_ei_qmc.data());
+    ei_evaluator_reference.ComputeGradExpectedImprovement(&ei_state_reference, grad_ei_reference.data());
+    double norm_difference = 0.0;
+    double norm_reference = 0.0;
+    for (int k = 0; k < dim*num_to_sample; ++k) {
+      norm_difference += Square(grad_ei_qmc[k] - grad_ei_reference[k]);
+      norm_reference += Square(grad_ei_reference[k]);
+    }
+    if (!(std::sqrt(norm_difference) <= 2.0e-2*std::sqrt(norm_reference))) {
+      ++total_errors;
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("quasi-monte-carlo EI tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("quasi-monte-carlo EI tests passed (standard error: %.3e QMC vs %.3e MC)\n",
+                              standard_error_qmc, standard_error_mc);
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks ComputeMultivariateNormalCDF() against closed forms and quadrature references:
+
+  1. ``\Phi_2(0,0;\rho) = 1/4 + \arcsin(\rho)/(2\pi)`` and ``\Phi_3(0,0,0;R) = 1/8 + \sum_{i<j} \arcsin(\rho_{ij})/(4\pi)``
+  2. equicorrelated CDFs match the 1D integral ``\int \phi(z) \Phi((h - \sqrt{\rho}z)/\sqrt{1-\rho})^n dz`` (n = 3, 4)
+  3. unstandardized covariances are handled (scaling limits and covariance together leaves the CDF unchanged)
+
+  \return
+    number of test failures
+\endrst*/
+int MultivariateNormalCDFTest() {
+  int total_errors = 0;
+  const double tolerance = 1.0e-13;
+
+  for (double rho : {-0.99, -0.5, 0.0, 0.3, 0.9, 0.999}) {
+    double expected = 0.25 + std::asin(rho)/(2.0*kPi);
+    if (!CheckDoubleWithinRelative(ComputeBivariateNormalCDF(0.0, 0.0, rho), expected, tolerance)) {
+      ++total_errors;
+    }
+  }
+
+  {
+    double covariance[9] = {1.0, 0.3, -0.4, 0.3, 1.0, 0.6, -0.4, 0.6, 1.0};
+    double limits[3] = {0.0, 0.0, 0.0};
+    double expected = 0.125 + (std::asin(0.3) + std::asin(-0.4) + std::asin(0.6))/(4.0*kPi);
+    if (!CheckDoubleWithinRelative(ComputeMultivariateNormalCDF(limits, covariance, 3), expected, tolerance)) {
+      ++total_errors;
+    }
+  }
+
+  // trapezoid rule on [-10, 10]: the integrand is smooth & decays like a gaussian, so this is accurate to ~1e-15
+  auto equicorrelated_cdf = [](double h, double rho, int n) {
+    const int num_intervals = 20000;
+    const double half_width = 10.0;
+    const double step = 2.0*half_width/static_cast<double>(num_intervals);
+    double integral = 0.0;
+    for (int i = 0; i <= num_intervals; ++i) {
+      double z = -half_width + step*static_cast<double>(i);
+      double weight = (i == 0 || i == num_intervals) ? 0.5 : 1.0;
+      double inner = 0.5*std::erfc(-(h - std::sqrt(rho)*z)/std::sqrt(2.0*(1.0 - rho)));
+      integral += weight*std::exp(-0.5*z*z)*std::pow(inner, n);
+    }
+    return integral*step/std::sqrt(2.0*kPi);
+  };
+
+  // 0.999 and 0.9999 exercise the adaptive quadrature used for nearly singular correlation matrices
+  for (int num_variables = 3; num_variables <= kMaxMultivariateNormalCDFDim; ++num_variables) {
+    for (double rho : {0.1, 0.5, 0.95, 0.999, 0.9999}) {
+      for (double h : {-1.0, 0.0, 1.5}) {
+        std::vector<double> covariance(num_variables*num_variables, rho);
+        std::vector<double> limits(num_variables, h);
+        for (int i = 0; i < num_variables; ++i) {
+          covariance[i*num_variables + i] = 1.0;
+        }
+        double cdf = ComputeMultivariateNormalCDF(limits.data(), covariance.data(), num_variables);
+        if (!CheckDoubleWithinRelative(cdf, equicorrelated_cdf(h, rho, num_variables), 1.0e-12)) {
+          OL_PARTIAL_FAILURE_PRINTF("n = %d, rho = %.18E, h = %.18E\n", num_variables, rho, h);
+          ++total_errors;
+        }
+
+        // N(0, s^2 R) evaluated at s*h has the same CDF as N(0, R) at h
+        const double scale = 2.5;
+        for (auto& entry : covariance) {
+          entry *= Square(scale);
+        }
+        for (auto& entry : limits) {
+          entry *= scale;
+        }
+        if (!CheckDoubleWithinRelative(ComputeMultivariateNormalCDF(limits.data(), covariance.data(), num_variables), cdf, tolerance)) {
+          ++total_errors;
+        }
+      }
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("multivariate normal CDF tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("multivariate normal CDF tests passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks AnalyticExpectedImprovementEvaluator for consistency with the other EI evaluators:
+
+  1. for 1,0-EI, it matches OnePotentialSampleExpectedImprovementEvaluator (value and gradient); the tolerance allows for
+     cancellation when EI is deep in the tail (e.g., ``EI pprox 10^{-30}``)
+  2. for several q,p, it matches high-accuracy monte-carlo EI to within a few standard errors
+
+  \return
+    number of test failures
+\endrst*/
+int AnalyticExpectedImprovementConsistencyTest() {
+  int total_errors = 0;
+
+  const int dim = 3;
+  const int num_sampled = 20;
+  const int num_mc_iterations = 2000000;
+  const double best_so_far = 0.0;
+
+  UniformRandomGenerator uniform_generator(60149);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, 0, 0, 0.01, uniform_double, &uniform_generator);
+
+  SquareExponential covariance(dim, 1.0, 1.2);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  AnalyticExpectedImprovementEvaluator ei_evaluator_analytic(gaussian_process, best_so_far);
+  ExpectedImprovementEvaluator ei_evaluator_mc(gaussian_process, num_mc_iterations, best_so_far);
+  NormalRNG normal_rng(8017);
+
+  {
+    std::vector<double> point_to_sample(dim);
+    std::vector<double> grad_ei_analytic(dim);
+    std::vector<double> grad_ei_one_potential_sample(dim);
+    OnePotentialSampleExpectedImprovementEvaluator ei_evaluator_one_potential_sample(gaussian_process, best_so_far);
+    for (int i = 0; i < 10; ++i) {
+      for (auto& entry : point_to_sample) {
+        entry = uniform_double(uniform_generator.engine);
+      }
+      AnalyticExpectedImprovementState ei_state_analytic(ei_evaluator_analytic, point_to_sample.data(), nullptr,
+                                                         1, 0, true, nullptr);
+      OnePotentialSampleExpectedImprovementState ei_state_one_potential_sample(ei_evaluator_one_potential_sample,
+                                                                               point_to_sample.data(), true);
+      if (!CheckDoubleWithinRelative(ei_evaluator_analytic.ComputeExpectedImprovement(&ei_state_analytic),
+                                     ei_evaluator_one_potential_sample.ComputeExpectedImprovement(&ei_state_one_potential_sample),
+                                     1.0e-10)) {
+        ++total_errors;
+      }
+      ei_evaluator_analytic.ComputeGradExpectedImprovement(&ei_state_analytic, grad_ei_analytic.data());
+      ei_evaluator_one_potential_sample.ComputeGradExpectedImprovement(&ei_state_one_potential_sample,
+                                                                       grad_ei_one_potential_sample.data());
+      for (int d = 0; d < dim; ++d) {
+        if (!CheckDoubleWithinRelative(grad_ei_analytic[d], grad_ei_one_potential_sample[d], 1.0e-11)) {
+          ++total_errors;
+        }
+      }
+    }
   }
-  if (!CheckDoubleWithinRelative(grad_ei, 0.0, 0.0)) {
-    ++total_errors;
+
+  const int num_cases = 5;
+  const int num_to_sample_list[num_cases] = {2, 1, 2, 3, 4};
+  const int num_being_sampled_list[num_cases] = {0, 1, 2, 1, 0};
+  for (int i = 0; i < num_cases; ++i) {
+    const int num_to_sample = num_to_sample_list[i];
+    const int num_being_sampled = num_being_sampled_list[i];
+    std::vector<double> points_to_sample(dim*num_to_sample);
+    std::vector<double> points_being_sampled(dim*num_being_sampled);
+    for (auto& entry : points_to_sample) {
+      entry = uniform_double(uniform_generator.engine);
+    }
+    for (auto& entry : points_being_sampled) {
+      entry = uniform_double(uniform_generator.engine);
+    }
+
+    AnalyticExpectedImprovementState ei_state_analytic(ei_evaluator_analytic, points_to_sample.data(),
+                                                       points_being_sampled.data(), num_to_sample,
+                                                       num_being_sampled, false, nullptr);
+    ExpectedImprovementState ei_state_mc(ei_evaluator_mc, points_to_sample.data(), points_being_sampled.data(),
+                                         num_to_sample, num_being_sampled, false, &normal_rng);
+    double ei_analytic = ei_evaluator_analytic.ComputeExpectedImprovement(&ei_state_analytic);
+    double standard_error_mc;
+    double ei_mc = ei_evaluator_mc.ComputeExpectedImprovementWithErrorEstimate(&ei_state_mc, &standard_error_mc);
+    if (!(ei_analytic > 0.0) || std::fabs(ei_analytic - ei_mc) > 5.0*standard_error_mc) {
+      OL_PARTIAL_FAILURE_PRINTF("%d,%d-EI: analytic = %.18E, monte-carlo = %.18E +/- %.18E\n", num_to_sample,
+                                num_being_sampled, ei_analytic, ei_mc, standard_error_mc);
+      ++total_errors;
+    }
   }
 
   if (total_errors != 0) {
-    OL_PARTIAL_FAILURE_PRINTF("1D analytic EI 0/0 edge case tests failed with %d errors\n", total_errors);
+    OL_PARTIAL_FAILURE_PRINTF("analytic q,p-EI consistency tests failed with %d errors\n", total_errors);
   } else {
-    OL_PARTIAL_SUCCESS_PRINTF("1D analytic EI 0/0 edge case tests passed\n");
+    OL_PARTIAL_SUCCESS_PRINTF("analytic q,p-EI consistency tests passed\n");
   }
 
   return total_errors;
@@ -995,6 +2289,46 @@ int RunGPTests() {
     total_errors += current_errors;
   }
 
+  {
+    current_errors = GaussianProcessAddPointsTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("GP incremental update (AddPointsToGP) failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = SparseGaussianProcessTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("sparse (FITC/VFE) GP failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = PointsToSampleStateFixedPointsTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("PointsToSampleState with fixed points failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = BatchOnePotentialSampleExpectedImprovementTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("batched analytic (one potential sample) EI failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = MarginalPredictionPointListTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("chunked GP mean/marginal variance failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
   {
     current_errors = EIOnePotentialSampleEdgeCasesTest();
     if (current_errors != 0) {
@@ -1003,6 +2337,54 @@ int RunGPTests() {
     total_errors += current_errors;
   }
 
+  {
+    current_errors = ExpectedImprovementMonteCarloBatchTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("batched monte-carlo EI failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = ExpectedImprovementTaskPoolTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("monte-carlo EI on a task pool failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = ExpectedImprovementQuasiMonteCarloTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("quasi-monte-carlo EI failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = PingEIAnalyticTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("pinging analytic (multivariate normal CDF) EI failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = MultivariateNormalCDFTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("multivariate normal CDF failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = AnalyticExpectedImprovementConsistencyTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("analytic q,p-EI consistency failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
   if (total_errors != 0) {
     OL_PARTIAL_FAILURE_PRINTF("GP functions failed with %d errors\n\n", total_errors);
   } else {
@@ -1015,19 +2397,11 @@ int RunGPTests() {
 /*!\rst
   Tests that single & multithreaded EI optimization produce *the exact same* results.
 
-  We do this by first setting up EI optimization in a single threaded scenario with 2 starting points and 2 random number generators.
-  Optimization is run one from starting point 0 with RNG 0, and then again from starting point 1 with RNG 1.
-
-  Then we run the optimization multithreaded (with 2 threads) over both starting points simultaneously.  One of the threads
-  will see the winning (point, RNG) pair from the single-threaded won.  Hence one result point will match with the single threaded
-  results exactly.
-
-  Then we re-run the multithreaded optimization, swapping the position of the RNGs and starting points.  If thread 0 won in the
-  previous test, thread 1 will win here (and vice versa).
-
-  Note that it's tricky to run single-threaded optimization over both starting points simultaneously because we won't know which
-  (point, RNG) pair won (which is required to ascertain the 'winner' since we are not computing EI accurately enough to avoid
-  error).
+  Every thread gets a PhiloxNormalRNG with the same seed, and start ``i`` draws from stream ``i`` (see BeginMultistart()
+  in gpp_math.hpp).  So each start does the same arithmetic whichever thread runs it, and the best point of a
+  multistart run (and the EI at every start, from EvaluateEIAtPointList()) must be bitwise identical for any number of
+  threads and any OpenMP schedule.  We compare one thread against several thread counts/schedules, with more starts
+  than threads.
 \endrst*/
 int MultithreadedEIOptimizationTest(ExpectedImprovementEvaluationMode ei_mode) {
   using DomainType = TensorProductDomain;
@@ -1076,18 +2450,16 @@ int MultithreadedEIOptimizationTest(ExpectedImprovementEvaluationMode ei_mode) {
     mock_gp_data.domain_ptr->GeneratePointInDomain(&uniform_generator, points_being_sampled.data() + j*kDim);
   }
 
-  const int pi_array[] = {314, 3141, 31415, 314159};
-  static const int kMaxNumThreads = 2;
-  std::vector<NormalRNG> normal_rng_vec(kMaxNumThreads);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    normal_rng_vec[j].SetExplicitSeed(pi_array[j]);
-  }
+  // counter-based generators: every thread gets the same seed and start i draws from stream i, so neither the number of
+  // threads nor the assignment of starts to threads may change the result
+  const PhiloxNormalRNG::SeedType seed = 31415;
+  static const int kMaxNumThreads = 4;
+  const int num_multistarts = 2*kMaxNumThreads + 1;  // more starts than threads: some threads run several starts
+  std::vector<PhiloxNormalRNG> normal_rng_vec(kMaxNumThreads, PhiloxNormalRNG(seed));
 
-  std::vector<double> starting_points(kDim*kMaxNumThreads*num_to_sample);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    for (int k = 0; k < num_to_sample; ++k) {
-      mock_gp_data.domain_ptr->GeneratePointInDomain(&uniform_generator, starting_points.data() + j*kDim*num_to_sample + k*kDim);
-    }
+  std::vector<double> starting_points(kDim*num_to_sample*num_multistarts);
+  for (int j = 0; j < num_multistarts*num_to_sample; ++j) {
+    mock_gp_data.domain_ptr->GeneratePointInDomain(&uniform_generator, starting_points.data() + j*kDim);
   }
 
   // we will optimize over the expanded region
@@ -1095,139 +2467,79 @@ int MultithreadedEIOptimizationTest(ExpectedImprovementEvaluationMode ei_mode) {
   ExpandDomainBounds(3.2, &domain_bounds);
   DomainType domain(domain_bounds.data(), kDim);
 
-  // build truth data by using single threads
+  // build truth data by using a single thread
   bool found_flag = false;
-  std::vector<double> best_next_point_single_thread(kDim*num_to_sample*kMaxNumThreads*kMaxNumThreads);
-  int num_threads = 1;
-  ThreadSchedule thread_schedule(num_threads, omp_sched_static);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    NormalRNG normal_rng(pi_array[j]);
-    int one_multistart = 1;  // truth values come from single threaded execution
-    ComputeOptimalPointsToSampleViaMultistartGradientDescent(*mock_gp_data.gaussian_process_ptr, gd_params,
-                                                             domain, thread_schedule,
-                                                             starting_points.data() + j*kDim*num_to_sample,
-                                                             points_being_sampled.data(), one_multistart,
-                                                             num_to_sample, num_being_sampled,
-                                                             mock_gp_data.best_so_far, max_mc_iterations,
-                                                             &normal_rng, &found_flag,
-                                                             best_next_point_single_thread.data() + j*kDim*num_to_sample);
-    if (!found_flag) {
-      ++total_errors;
-    }
-
-    normal_rng.SetExplicitSeed(pi_array[kMaxNumThreads - j - 1]);
-    ComputeOptimalPointsToSampleViaMultistartGradientDescent(*mock_gp_data.gaussian_process_ptr, gd_params,
-                                                             domain, thread_schedule,
-                                                             starting_points.data() + j*kDim*num_to_sample,
-                                                             points_being_sampled.data(), one_multistart,
-                                                             num_to_sample, num_being_sampled,
-                                                             mock_gp_data.best_so_far, max_mc_iterations,
-                                                             &normal_rng, &found_flag,
-                                                             best_next_point_single_thread.data() + j*kDim*num_to_sample + kDim*kMaxNumThreads*num_to_sample);
-    if (!found_flag) {
-      ++total_errors;
-    }
-  }
-
-  // now multithreaded to generate test data
-  std::vector<double> best_next_point_multithread(kDim*num_to_sample);
-  thread_schedule.max_num_threads = kMaxNumThreads;
-  found_flag = false;
-  ComputeOptimalPointsToSampleViaMultistartGradientDescent(*mock_gp_data.gaussian_process_ptr, gd_params,
-                                                           domain, thread_schedule, starting_points.data(),
-                                                           points_being_sampled.data(), kMaxNumThreads,
+  std::vector<double> best_next_point_single_thread(kDim*num_to_sample);
+  std::vector<double> function_values_single_thread(num_multistarts);
+  ThreadSchedule single_thread_schedule(1, omp_sched_static);
+  ComputeOptimalPointsToSampleViaMultistartGradientDescent(*mock_gp_data.gaussian_process_ptr, gd_params, domain,
+                                                           single_thread_schedule, starting_points.data(),
+                                                           points_being_sampled.data(), num_multistarts,
                                                            num_to_sample, num_being_sampled,
-                                                           mock_gp_data.best_so_far,
-                                                           max_mc_iterations, normal_rng_vec.data(),
-                                                           &found_flag, best_next_point_multithread.data());
+                                                           mock_gp_data.best_so_far, max_mc_iterations,
+                                                           MonteCarloIntegrationTypes::kPseudoRandom,
+                                                           ExpectedImprovementEvaluationTypes::kMonteCarlo,
+                                                           normal_rng_vec.data(), &found_flag,
+                                                           best_next_point_single_thread.data());
   if (!found_flag) {
     ++total_errors;
   }
-
-  // best_next_point_multithread must be PRECISELY one of the points determined by single threaded runs
-  double error[kMaxNumThreads*kMaxNumThreads];
-  for (int i = 0; i < kMaxNumThreads; ++i) {
-    for (int j = 0; j < kMaxNumThreads; ++j) {
-      error[i*kMaxNumThreads + j] = 0.0;
-      for (int k = 0; k < num_to_sample; ++k) {
-        for (int d = 0; d < kDim; ++d) {
-          error[i*kMaxNumThreads + j] += std::fabs(best_next_point_multithread[k*kDim + d] -
-                                                   best_next_point_single_thread[i*kDim*kMaxNumThreads*num_to_sample +
-                                                                                 j*kDim*num_to_sample + k*kDim + d]);
-        }
-      }
-    }
-  }
-  // normally double precision checks like this are bad
-  // but here, we want to ensure that the multithreaded & singlethreaded paths executed THE EXACT SAME CODE IN THE SAME ORDER
-  // and hence their results must be identical
-  bool pass = false;
-  for (int i = 0; i < kMaxNumThreads*kMaxNumThreads; ++i) {
-    if (error[i] == 0.0) {
-      pass = true;
-      break;
+  std::vector<double> best_point_single_thread(kDim*num_to_sample);
+  EvaluateEIAtPointList(*mock_gp_data.gaussian_process_ptr, single_thread_schedule, starting_points.data(),
+                        points_being_sampled.data(), num_multistarts, num_to_sample, num_being_sampled,
+                        mock_gp_data.best_so_far, max_mc_iterations, MonteCarloIntegrationTypes::kPseudoRandom,
+                        ExpectedImprovementEvaluationTypes::kMonteCarlo,
+                        &found_flag, normal_rng_vec.data(), function_values_single_thread.data(),
+                        best_point_single_thread.data());
+
+  // now multithreaded, with different thread counts and schedules, to generate test data
+  const ThreadSchedule thread_schedules[] = {ThreadSchedule(2, omp_sched_static),
+                                             ThreadSchedule(kMaxNumThreads, omp_sched_dynamic),
+                                             ThreadSchedule(kMaxNumThreads, omp_sched_static, 3)};
+  std::vector<double> best_next_point_multithread(kDim*num_to_sample);
+  std::vector<double> function_values_multithread(num_multistarts);
+  std::vector<double> best_point_multithread(kDim*num_to_sample);
+  for (const auto& thread_schedule : thread_schedules) {
+    found_flag = false;
+    ComputeOptimalPointsToSampleViaMultistartGradientDescent(*mock_gp_data.gaussian_process_ptr, gd_params, domain,
+                                                             thread_schedule, starting_points.data(),
+                                                             points_being_sampled.data(), num_multistarts,
+                                                             num_to_sample, num_being_sampled,
+                                                             mock_gp_data.best_so_far, max_mc_iterations,
+                                                             MonteCarloIntegrationTypes::kPseudoRandom,
+                                                             ExpectedImprovementEvaluationTypes::kMonteCarlo,
+                                                             normal_rng_vec.data(), &found_flag,
+                                                             best_next_point_multithread.data());
+    if (!found_flag) {
+      ++total_errors;
     }
-  }
-  if (pass == false) {
-    OL_PARTIAL_FAILURE_PRINTF("multi & single threaded results differ 1: ");
-    PrintMatrix(error, 1, Square(kMaxNumThreads));
-    ++total_errors;
-  }
-
-  // reset random state & flip the points & generators so that if thread 0 won before, thread 1 wins now (or vice versa)
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    normal_rng_vec[kMaxNumThreads-j-1].SetExplicitSeed(pi_array[j]);
-  }
-
-  std::vector<double> starting_points_flip(kDim*kMaxNumThreads*num_to_sample);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    for (int k = 0; k < num_to_sample; ++k) {
-      for (int d = 0; d < kDim; ++d) {
-        starting_points_flip[(kMaxNumThreads-j-1)*kDim*num_to_sample + k*kDim + d] = starting_points[j*kDim*num_to_sample + k*kDim + d];
+    EvaluateEIAtPointList(*mock_gp_data.gaussian_process_ptr, thread_schedule, starting_points.data(),
+                          points_being_sampled.data(), num_multistarts, num_to_sample, num_being_sampled,
+                          mock_gp_data.best_so_far, max_mc_iterations, MonteCarloIntegrationTypes::kPseudoRandom,
+                          ExpectedImprovementEvaluationTypes::kMonteCarlo,
+                          &found_flag, normal_rng_vec.data(), function_values_multithread.data(),
+                          best_point_multithread.data());
+
+    // normally double precision checks like this are bad
+    // but here, we want to ensure that the multithreaded & singlethreaded paths executed THE EXACT SAME CODE IN THE SAME ORDER
+    // (for each start) and hence their results must be identical
+    int num_differences = 0;
+    for (int i = 0; i < kDim*num_to_sample; ++i) {
+      if (best_next_point_multithread[i] != best_next_point_single_thread[i]) {
+        ++num_differences;
       }
     }
-  }
-
-  // check multithreaded results again
-  found_flag = false;
-  ComputeOptimalPointsToSampleViaMultistartGradientDescent(*mock_gp_data.gaussian_process_ptr, gd_params,
-                                                           domain, thread_schedule, starting_points_flip.data(),
-                                                           points_being_sampled.data(), kMaxNumThreads,
-                                                           num_to_sample, num_being_sampled,
-                                                           mock_gp_data.best_so_far,
-                                                           max_mc_iterations, normal_rng_vec.data(),
-                                                           &found_flag, best_next_point_multithread.data());
-  if (!found_flag) {
-    ++total_errors;
-  }
-
-  for (int i = 0; i < kMaxNumThreads; ++i) {
-    for (int j = 0; j < kMaxNumThreads; ++j) {
-      error[i*kMaxNumThreads + j] = 0.0;
-      for (int k = 0; k < num_to_sample; ++k) {
-        for (int d = 0; d < kDim; ++d) {
-          error[i*kMaxNumThreads + j] += std::fabs(best_next_point_multithread[k*kDim + d] -
-                                                   best_next_point_single_thread[i*kDim*kMaxNumThreads*num_to_sample +
-                                                                                 j*kDim*num_to_sample + k*kDim + d]);
-        }
+    for (int i = 0; i < num_multistarts; ++i) {
+      if (function_values_multithread[i] != function_values_single_thread[i]) {
+        ++num_differences;
       }
     }
-  }
-  // normally double precision checks like this are bad
-  // but here, we want to ensure that the multithreaded & singlethreaded paths executed THE EXACT SAME CODE IN THE SAME ORDER
-  // and hence their results must be identical
-  pass = false;
-  for (int i = 0; i < kMaxNumThreads*kMaxNumThreads; ++i) {
-    if (error[i] == 0.0) {
-      pass = true;
-      break;
+    if (num_differences != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("multi (%d threads) & single threaded results differ in %d entries\n",
+                                thread_schedule.max_num_threads, num_differences);
+      ++total_errors;
     }
   }
-  if (pass == false) {
-    OL_PARTIAL_FAILURE_PRINTF("multi & single threaded results differ 2: ");
-    PrintMatrix(error, 1, Square(kMaxNumThreads));
-    ++total_errors;
-  }
 
   if (total_errors != 0) {
     OL_PARTIAL_FAILURE_PRINTF("Single/Multithreaded EI Optimization Consistency Check failed with %d errors\n", total_errors);
@@ -1285,10 +2597,7 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationTestCore(ExpectedImprov
   const int64_t pi_array[] = {314, 3141, 31415, 314159, 3141592, 31415926, 314159265, 3141592653, 31415926535, 314159265359};
   static const int kMaxNumThreads = 4;
   ThreadSchedule thread_schedule(kMaxNumThreads, omp_sched_static);
-  std::vector<NormalRNG> normal_rng_vec(kMaxNumThreads);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    normal_rng_vec[j].SetExplicitSeed(pi_array[j]);
-  }
+  std::vector<PhiloxNormalRNG> normal_rng_vec(kMaxNumThreads, PhiloxNormalRNG(pi_array[0]));
 
   int num_sampled = 20;
 
@@ -1327,7 +2636,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationTestCore(ExpectedImprov
                                                    gd_params, domain, thread_schedule,
                                                    points_being_sampled.data(),
                                                    num_to_sample, j, mock_gp_data.best_so_far,
-                                                   max_int_steps, &found_flag,
+                                                   max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                   ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                                                    &uniform_generator, normal_rng_vec.data(),
                                                    points_being_sampled.data() + j*dim);
     }
@@ -1342,7 +2652,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationTestCore(ExpectedImprov
                                                       thread_schedule, points_being_sampled.data(),
                                                       num_grid_search_points, num_to_sample,
                                                       num_being_sampled, mock_gp_data.best_so_far,
-                                                      max_int_steps, &found_flag,
+                                                      max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                      ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                                                       &uniform_generator, normal_rng_vec.data(),
                                                       grid_search_best_point.data());
   if (!found_flag) {
@@ -1355,7 +2666,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationTestCore(ExpectedImprov
     ComputeOptimalPointsToSampleWithRandomStarts(*mock_gp_data.gaussian_process_ptr, gd_params,
                                                  domain, thread_schedule, points_being_sampled.data(),
                                                  num_to_sample, num_being_sampled,
-                                                 mock_gp_data.best_so_far, max_int_steps,
+                                                 mock_gp_data.best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                 ExpectedImprovementEvaluationTypes::kMonteCarlo,
                                                  &found_flag,
                                                  &uniform_generator, normal_rng_vec.data(),
                                                  next_point.data());
@@ -1377,7 +2689,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationTestCore(ExpectedImprov
                                                              num_multistarts_mc, num_to_sample,
                                                              num_being_sampled,
                                                              mock_gp_data.best_so_far,
-                                                             max_int_steps,
+                                                             max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                             ExpectedImprovementEvaluationTypes::kMonteCarlo,
                                                              normal_rng_vec.data(), &found_flag,
                                                              next_point.data());
     if (!found_flag) {
@@ -1487,10 +2800,7 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationSimplexTestCore(Expecte
   const int64_t pi_array[] = {314, 3141, 31415, 314159, 3141592, 31415926, 314159265, 3141592653, 31415926535, 314159265359};
   static const int kMaxNumThreads = 4;
   ThreadSchedule thread_schedule(kMaxNumThreads, omp_sched_static);
-  std::vector<NormalRNG> normal_rng_vec(kMaxNumThreads);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    normal_rng_vec[j].SetExplicitSeed(pi_array[j]);
-  }
+  std::vector<PhiloxNormalRNG> normal_rng_vec(kMaxNumThreads, PhiloxNormalRNG(pi_array[0]));
 
   int num_sampled = 20;
 
@@ -1536,7 +2846,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationSimplexTestCore(Expecte
                                                    gd_params, domain, thread_schedule,
                                                    points_being_sampled.data(),
                                                    num_to_sample, j, mock_gp_data.best_so_far,
-                                                   max_int_steps, &found_flag,
+                                                   max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                   ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                                                    &uniform_generator, normal_rng_vec.data(),
                                                    points_being_sampled.data() + j*dim);
     }
@@ -1551,7 +2862,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationSimplexTestCore(Expecte
                                                       thread_schedule, points_being_sampled.data(),
                                                       num_grid_search_points, num_to_sample,
                                                       num_being_sampled, mock_gp_data.best_so_far,
-                                                      max_int_steps, &found_flag,
+                                                      max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                      ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                                                       &uniform_generator, normal_rng_vec.data(),
                                                       grid_search_best_point.data());
   if (!found_flag) {
@@ -1565,7 +2877,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationSimplexTestCore(Expecte
                                                  domain, thread_schedule,
                                                  points_being_sampled.data(), num_to_sample,
                                                  num_being_sampled, mock_gp_data.best_so_far,
-                                                 max_int_steps, &found_flag,
+                                                 max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                 ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                                                  &uniform_generator, normal_rng_vec.data(),
                                                  next_point.data());
     if (!found_flag) {
@@ -1586,7 +2899,8 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationSimplexTestCore(Expecte
                                                              domain, thread_schedule, initial_guesses.data(),
                                                              points_being_sampled.data(), num_multistarts_mc,
                                                              num_to_sample, num_being_sampled,
-                                                             mock_gp_data.best_so_far, max_int_steps,
+                                                             mock_gp_data.best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                             ExpectedImprovementEvaluationTypes::kMonteCarlo,
                                                              normal_rng_vec.data(),
                                                              &found_flag, next_point.data());
     if (!found_flag) {
@@ -1704,10 +3018,7 @@ int ExpectedImprovementOptimizationMultipleSamplesTest() {
   const int64_t pi_array[] = {314, 3141, 31415, 314159, 3141592, 31415926, 314159265, 3141592653, 31415926535, 314159265359};
   static const int kMaxNumThreads = 4;
   ThreadSchedule thread_schedule(kMaxNumThreads, omp_sched_static);
-  std::vector<NormalRNG> normal_rng_vec(kMaxNumThreads);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    normal_rng_vec[j].SetExplicitSeed(pi_array[j]);
-  }
+  std::vector<PhiloxNormalRNG> normal_rng_vec(kMaxNumThreads, PhiloxNormalRNG(pi_array[0]));
 
   const int num_sampled = 20;
   std::vector<double> noise_variance(num_sampled, 0.002);
@@ -1730,7 +3041,8 @@ int ExpectedImprovementOptimizationMultipleSamplesTest() {
                                                       thread_schedule, points_being_sampled.data(),
                                                       num_grid_search_points, num_to_sample,
                                                       num_being_sampled, mock_gp_data.best_so_far,
-                                                      max_int_steps, &found_flag,
+                                                      max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                                      ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                                                       &uniform_generator, normal_rng_vec.data(),
                                                       grid_search_best_point_set.data());
   if (!found_flag) {
@@ -1744,7 +3056,8 @@ int ExpectedImprovementOptimizationMultipleSamplesTest() {
   ComputeOptimalPointsToSample(*mock_gp_data.gaussian_process_ptr, gd_params, domain,
                                thread_schedule, points_being_sampled.data(),
                                num_to_sample, num_being_sampled, mock_gp_data.best_so_far,
-                               max_int_steps, lhc_search_only,
+                               max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                               ExpectedImprovementEvaluationTypes::kMonteCarlo, lhc_search_only,
                                num_grid_search_points, &found_flag, &uniform_generator,
                                normal_rng_vec.data(), best_points_to_sample.data());
   if (!found_flag) {
@@ -1824,6 +3137,250 @@ int ExpectedImprovementOptimizationMultipleSamplesTest() {
   return total_errors;
 }
 
+/*!\rst
+  Runs MultistartOptimizer<LBFGSOptimizer<...>> on analytic q,p-EI over a RepeatedDomain<TensorProductDomain> (q = 2)
+  and checks that:
+
+  1. l-bfgs finds an update and its points are inside the domain and distinct
+  2. l-bfgs EI is *no worse* than the best EI found by a random grid search
+  3. grad EI at the l-bfgs solution is small (in the coordinates not on a boundary)
+  4. through ComputeOptimalPointsToSample(), l-bfgs EI is no worse than grid search, with and without adaptive
+     multistart (which also runs on monte-carlo EI and rejects invalid parameters)
+
+  Different optimizers can converge to different local optima from the same starts, so l-bfgs is not compared against
+  gradient descent directly.
+\endrst*/
+int ExpectedImprovementLBFGSOptimizationTest() {
+  using DomainType = TensorProductDomain;
+  using RepeatedDomainType = RepeatedDomain<DomainType>;
+  const int dim = 3;
+
+  int total_errors = 0;
+
+  // grid search parameters
+  const int num_grid_search_points = 10000;
+
+  // l-bfgs parameters
+  const double tolerance = 1.0e-7;
+  const int num_multistarts = 20;
+  const int max_lbfgs_steps = 200;
+  const int history_size = 10;
+  const int max_num_line_search_steps = 30;
+  LBFGSParameters lbfgs_params(num_multistarts, max_lbfgs_steps, history_size, max_num_line_search_steps, tolerance);
+
+  // q,p-EI computation parameters
+  const int num_to_sample = 2;
+  const int num_being_sampled = 0;
+  std::vector<double> points_being_sampled(dim*num_being_sampled);
+
+  // random number generators
+  UniformRandomGenerator uniform_generator(314);
+  boost::uniform_real<double> uniform_double_hyperparameter(0.4, 1.3);
+  boost::uniform_real<double> uniform_double_lower_bound(-2.0, 0.5);
+  boost::uniform_real<double> uniform_double_upper_bound(1.0, 2.5);
+
+  static const int kMaxNumThreads = 4;
+  ThreadSchedule thread_schedule(kMaxNumThreads, omp_sched_dynamic);
+
+  const int num_sampled = 20;
+  std::vector<double> noise_variance(num_sampled, 0.002);
+  MockGaussianProcessPriorData<DomainType> mock_gp_data(SquareExponential(dim, 1.0, 1.0),
+                                                        noise_variance, dim, num_sampled,
+                                                        uniform_double_lower_bound,
+                                                        uniform_double_upper_bound,
+                                                        uniform_double_hyperparameter,
+                                                        &uniform_generator);
+
+  // we will optimize over the expanded region
+  std::vector<ClosedInterval> domain_bounds(mock_gp_data.domain_bounds);
+  ExpandDomainBounds(1.5, &domain_bounds);
+  DomainType domain(domain_bounds.data(), dim);
+  RepeatedDomainType repeated_domain(domain, num_to_sample);
+
+  std::vector<double> starting_points(dim*num_to_sample*num_multistarts);
+  if (repeated_domain.GenerateUniformPointsInDomain(num_multistarts, &uniform_generator,
+                                                    starting_points.data()) != num_multistarts) {
+    ++total_errors;
+  }
+
+  AnalyticExpectedImprovementEvaluator ei_evaluator(*mock_gp_data.gaussian_process_ptr, mock_gp_data.best_so_far);
+  const bool configure_for_gradients = true;
+
+  // best EI over uniform random points in the (repeated) domain
+  double ei_grid_search = 0.0;
+  {
+    std::vector<double> grid_search_points(dim*num_to_sample*num_grid_search_points);
+    if (repeated_domain.GenerateUniformPointsInDomain(num_grid_search_points, &uniform_generator,
+                                                      grid_search_points.data()) != num_grid_search_points) {
+      ++total_errors;
+    }
+    AnalyticExpectedImprovementState ei_state(ei_evaluator, grid_search_points.data(), points_being_sampled.data(),
+                                              num_to_sample, num_being_sampled, false, nullptr);
+    for (int i = 0; i < num_grid_search_points; ++i) {
+      ei_state.SetCurrentPoint(ei_evaluator, grid_search_points.data() + i*dim*num_to_sample);
+      ei_grid_search = std::fmax(ei_grid_search, ei_evaluator.ComputeExpectedImprovement(&ei_state));
+    }
+  }
+
+  std::vector<double> best_points_lbfgs(dim*num_to_sample);
+  bool found_flag_lbfgs = false;
+  {
+    std::vector<AnalyticExpectedImprovementState> ei_state_vector;
+    SetupExpectedImprovementState(ei_evaluator, starting_points.data(), points_being_sampled.data(),
+                                  num_to_sample, num_being_sampled, thread_schedule.max_num_threads,
+                                  configure_for_gradients, &ei_state_vector);
+    OptimizationIOContainer io_container(ei_state_vector[0].GetProblemSize(), 0.0, starting_points.data());
+
+    LBFGSOptimizer<AnalyticExpectedImprovementEvaluator, RepeatedDomainType> lbfgs_opt;
+    MultistartOptimizer<LBFGSOptimizer<AnalyticExpectedImprovementEvaluator, RepeatedDomainType> > multistart_optimizer;
+    multistart_optimizer.MultistartOptimize(lbfgs_opt, ei_evaluator, lbfgs_params, repeated_domain, thread_schedule,
+                                            starting_points.data(), num_multistarts, ei_state_vector.data(),
+                                            nullptr, &io_container);
+    found_flag_lbfgs = io_container.found_flag;
+    std::copy(io_container.best_point.begin(), io_container.best_point.end(), best_points_lbfgs.begin());
+  }
+  if (!found_flag_lbfgs) {
+    ++total_errors;
+  }
+
+  if (!repeated_domain.CheckPointInside(best_points_lbfgs.data())) {
+    OL_ERROR_PRINTF("ERROR: l-bfgs points were not in domain!\n");
+    ++total_errors;
+  }
+  const double distinct_point_tolerance = 1.0e-5;
+  total_errors += CheckPointsAreDistinct(best_points_lbfgs.data(), num_to_sample, dim, distinct_point_tolerance);
+
+  AnalyticExpectedImprovementState ei_state_lbfgs(ei_evaluator, best_points_lbfgs.data(), points_being_sampled.data(),
+                                                  num_to_sample, num_being_sampled, configure_for_gradients, nullptr);
+  const double ei_lbfgs = ei_evaluator.ComputeExpectedImprovement(&ei_state_lbfgs);
+  std::vector<double> grad_ei(dim*num_to_sample);
+  ei_evaluator.ComputeGradExpectedImprovement(&ei_state_lbfgs, grad_ei.data());
+
+  // a local optimizer run from 20 starts should beat sampling: it refines the best basins it finds
+  const double grid_search_tolerance = 1.0e-3;
+  if (ei_lbfgs < ei_grid_search*(1.0 - grid_search_tolerance)) {
+    OL_ERROR_PRINTF("ERROR: l-bfgs EI = %.18E is worse than grid search EI = %.18E\n", ei_lbfgs, ei_grid_search);
+    ++total_errors;
+  }
+
+  // the gradient need not vanish in coordinates that l-bfgs pinned to the boundary
+  for (int i = 0; i < num_to_sample; ++i) {
+    for (int d = 0; d < dim; ++d) {
+      const double coordinate = best_points_lbfgs[i*dim + d];
+      if (coordinate > domain_bounds[d].min && coordinate < domain_bounds[d].max &&
+          !CheckDoubleWithinRelative(grad_ei[i*dim + d], 0.0, 1.0e-5)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // the ComputeOptimalPointsToSample() entry point
+  {
+    const int seed = 2718;
+    const bool lhc_search_only = false;
+    const int num_lhc_samples = 0;
+    std::vector<PhiloxNormalRNG> normal_rng_vec(thread_schedule.max_num_threads, PhiloxNormalRNG(seed));
+
+    UniformRandomGenerator uniform_generator_lbfgs(seed);
+    bool found_flag_entry_lbfgs = false;
+    ComputeOptimalPointsToSample(*mock_gp_data.gaussian_process_ptr, lbfgs_params, nullptr, domain, thread_schedule,
+                                 points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                 mock_gp_data.best_so_far, 0, MonteCarloIntegrationTypes::kPseudoRandom,
+                                 ExpectedImprovementEvaluationTypes::kAnalytic,
+                                 lhc_search_only, num_lhc_samples, &found_flag_entry_lbfgs, &uniform_generator_lbfgs,
+                                 normal_rng_vec.data(), best_points_lbfgs.data());
+    if (!found_flag_entry_lbfgs) {
+      ++total_errors;
+    }
+    if (!repeated_domain.CheckPointInside(best_points_lbfgs.data())) {
+      OL_ERROR_PRINTF("ERROR: ComputeOptimalPointsToSample l-bfgs points were not in domain!\n");
+      ++total_errors;
+    }
+
+    AnalyticExpectedImprovementState ei_state_entry_lbfgs(ei_evaluator, best_points_lbfgs.data(),
+                                                          points_being_sampled.data(), num_to_sample,
+                                                          num_being_sampled, configure_for_gradients, nullptr);
+    const double ei_entry_lbfgs = ei_evaluator.ComputeExpectedImprovement(&ei_state_entry_lbfgs);
+    if (ei_entry_lbfgs < ei_grid_search*(1.0 - grid_search_tolerance)) {
+      OL_ERROR_PRINTF("ERROR: ComputeOptimalPointsToSample l-bfgs EI = %.18E is worse than grid search EI = %.18E\n",
+                      ei_entry_lbfgs, ei_grid_search);
+      ++total_errors;
+    }
+
+    // adaptive multistart l-bfgs: screen every start with a few steps, fully optimize the best few
+    const int num_screening_steps = 3;
+    AdaptiveMultistartParameters adaptive_params(num_screening_steps, 0.5, kMaxNumThreads,
+                                                 std::numeric_limits<double>::infinity());
+    UniformRandomGenerator uniform_generator_adaptive(seed);
+    bool found_flag_entry_adaptive = false;
+    std::vector<double> best_points_adaptive(dim*num_to_sample);
+    ComputeOptimalPointsToSample(*mock_gp_data.gaussian_process_ptr, lbfgs_params, &adaptive_params, domain,
+                                 thread_schedule, points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                 mock_gp_data.best_so_far, 0, MonteCarloIntegrationTypes::kPseudoRandom,
+                                 ExpectedImprovementEvaluationTypes::kAnalytic,
+                                 lhc_search_only, num_lhc_samples, &found_flag_entry_adaptive,
+                                 &uniform_generator_adaptive, normal_rng_vec.data(), best_points_adaptive.data());
+    if (!found_flag_entry_adaptive) {
+      ++total_errors;
+    }
+    if (!repeated_domain.CheckPointInside(best_points_adaptive.data())) {
+      OL_ERROR_PRINTF("ERROR: adaptive l-bfgs points were not in domain!\n");
+      ++total_errors;
+    }
+    AnalyticExpectedImprovementState ei_state_entry_adaptive(ei_evaluator, best_points_adaptive.data(),
+                                                             points_being_sampled.data(), num_to_sample,
+                                                             num_being_sampled, configure_for_gradients, nullptr);
+    const double ei_entry_adaptive = ei_evaluator.ComputeExpectedImprovement(&ei_state_entry_adaptive);
+    if (ei_entry_adaptive < ei_grid_search*(1.0 - grid_search_tolerance)) {
+      OL_ERROR_PRINTF("ERROR: adaptive l-bfgs EI = %.18E is worse than grid search EI = %.18E\n",
+                      ei_entry_adaptive, ei_grid_search);
+      ++total_errors;
+    }
+
+    // adaptive multistart on monte-carlo EI (too many points for the analytic evaluator) runs without a task pool
+    const int num_being_sampled_mc = AnalyticExpectedImprovementEvaluator::kMaxNumUnion;
+    std::vector<double> points_being_sampled_mc(dim*num_being_sampled_mc);
+    domain.GenerateUniformPointsInDomain(num_being_sampled_mc, &uniform_generator, points_being_sampled_mc.data());
+    const int max_int_steps = 1000;
+    bool found_flag_entry_mc = false;
+    std::vector<double> best_point_mc(dim);
+    ComputeOptimalPointsToSample(*mock_gp_data.gaussian_process_ptr, lbfgs_params, &adaptive_params, domain,
+                                 thread_schedule, points_being_sampled_mc.data(), 1, num_being_sampled_mc,
+                                 mock_gp_data.best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                                 ExpectedImprovementEvaluationTypes::kAnalytic,
+                                 lhc_search_only, num_lhc_samples, &found_flag_entry_mc, &uniform_generator_adaptive,
+                                 normal_rng_vec.data(), best_point_mc.data());
+    if (!found_flag_entry_mc || !domain.CheckPointInside(best_point_mc.data())) {
+      OL_ERROR_PRINTF("ERROR: adaptive l-bfgs on monte-carlo EI failed!\n");
+      ++total_errors;
+    }
+
+    // screening needs at least one step
+    AdaptiveMultistartParameters invalid_adaptive_params(0, 0.5, kMaxNumThreads, 0.0);
+    try {
+      // increment errors: we must catch an exception to decrement
+      total_errors += 1;
+      ComputeOptimalPointsToSample(*mock_gp_data.gaussian_process_ptr, lbfgs_params, &invalid_adaptive_params, domain,
+                                   thread_schedule, points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                   mock_gp_data.best_so_far, 0, MonteCarloIntegrationTypes::kPseudoRandom,
+                                   ExpectedImprovementEvaluationTypes::kAnalytic,
+                                   lhc_search_only, num_lhc_samples, &found_flag_entry_adaptive,
+                                   &uniform_generator_adaptive, normal_rng_vec.data(), best_points_adaptive.data());
+    } catch (const LowerBoundException<int>&) {
+      // exception occurred, good! remove the increment from the try block.
+      total_errors -= 1;
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("multistart l-bfgs EI optimization failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("multistart l-bfgs EI optimization passed\n");
+  }
+
+  return total_errors;
+}
+
 int EvaluateEIAtPointListTest() {
   using DomainType = TensorProductDomain;
   const int dim = 3;
@@ -1847,10 +3404,7 @@ int EvaluateEIAtPointListTest() {
   const int64_t pi_array[] = {314, 3141, 31415, 314159, 3141592, 31415926, 314159265, 3141592653, 31415926535, 314159265359};
   static const int kMaxNumThreads = 4;
   ThreadSchedule thread_schedule(kMaxNumThreads, omp_sched_static);
-  std::vector<NormalRNG> normal_rng_vec(kMaxNumThreads);
-  for (int j = 0; j < kMaxNumThreads; ++j) {
-    normal_rng_vec[j].SetExplicitSeed(pi_array[j]);
-  }
+  std::vector<PhiloxNormalRNG> normal_rng_vec(kMaxNumThreads, PhiloxNormalRNG(pi_array[0]));
 
   int num_sampled = 20;  // arbitrary
   std::vector<double> noise_variance(num_sampled, 0.002);
@@ -1868,7 +3422,8 @@ int EvaluateEIAtPointListTest() {
 
   EvaluateEIAtPointList(*mock_gp_data.gaussian_process_ptr, thread_schedule, initial_guesses.data(),
                         points_being_sampled.data(), num_grid_search_points, num_to_sample,
-                        num_being_sampled, mock_gp_data.best_so_far, max_int_steps, &found_flag,
+                        num_being_sampled, mock_gp_data.best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                        ExpectedImprovementEvaluationTypes::kMonteCarlo, &found_flag,
                         normal_rng_vec.data(), function_values.data(), grid_search_best_point.data());
   if (!found_flag) {
     ++total_errors;
@@ -1894,7 +3449,8 @@ int EvaluateEIAtPointListTest() {
     EvaluateEIAtPointList(*mock_gp_data.gaussian_process_ptr, single_thread_schedule,
                           initial_guesses.data(), points_being_sampled.data(),
                           num_grid_search_points, num_to_sample, num_being_sampled,
-                          mock_gp_data.best_so_far, max_int_steps,
+                          mock_gp_data.best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                          ExpectedImprovementEvaluationTypes::kMonteCarlo,
                           &found_flag, normal_rng_vec.data(),
                           function_values_single_thread.data(),
                           grid_search_best_point_single_thread.data());
@@ -1914,6 +3470,54 @@ int EvaluateEIAtPointListTest() {
     }
   }
 
+  // 2,0-EI: kAnalytic uses the analytic evaluator; kMonteCarlo integrates (here by RQMC) even though q + p is small
+  {
+    const int num_to_sample_qp = 2;
+    const int num_points_qp = 10;
+    const int num_mc_iterations = 1 << 16;
+    const double mc_tolerance = 5.0e-3;
+    std::vector<double> initial_guesses_qp(dim*num_to_sample_qp*num_points_qp);
+    mock_gp_data.domain_ptr->GenerateUniformPointsInDomain(num_to_sample_qp*num_points_qp, &uniform_generator,
+                                                           initial_guesses_qp.data());
+    std::vector<double> analytic_values(num_points_qp);
+    std::vector<double> monte_carlo_values(num_points_qp);
+    std::vector<double> best_point_qp(dim*num_to_sample_qp);
+    EvaluateEIAtPointList(*mock_gp_data.gaussian_process_ptr, thread_schedule, initial_guesses_qp.data(), nullptr,
+                          num_points_qp, num_to_sample_qp, 0, mock_gp_data.best_so_far, 0,
+                          MonteCarloIntegrationTypes::kPseudoRandom, ExpectedImprovementEvaluationTypes::kAnalytic,
+                          &found_flag, nullptr, analytic_values.data(), best_point_qp.data());
+    EvaluateEIAtPointList(*mock_gp_data.gaussian_process_ptr, thread_schedule, initial_guesses_qp.data(), nullptr,
+                          num_points_qp, num_to_sample_qp, 0, mock_gp_data.best_so_far, num_mc_iterations,
+                          MonteCarloIntegrationTypes::kQuasiRandom, ExpectedImprovementEvaluationTypes::kMonteCarlo,
+                          &found_flag, normal_rng_vec.data(), monte_carlo_values.data(), best_point_qp.data());
+
+    AnalyticExpectedImprovementEvaluator ei_evaluator(*mock_gp_data.gaussian_process_ptr, mock_gp_data.best_so_far);
+    std::vector<double> expected_improvement(num_points_qp);
+    for (int i = 0; i < num_points_qp; ++i) {
+      AnalyticExpectedImprovementState ei_state(ei_evaluator, initial_guesses_qp.data() + i*dim*num_to_sample_qp,
+                                                nullptr, num_to_sample_qp, 0, false, nullptr);
+      expected_improvement[i] = ei_evaluator.ComputeExpectedImprovement(&ei_state);
+    }
+
+    // some random points have EI near 0, so the monte-carlo error is measured relative to the largest EI
+    const double max_expected_improvement = *std::max_element(expected_improvement.begin(),
+                                                              expected_improvement.end());
+    bool monte_carlo_used = false;
+    for (int i = 0; i < num_points_qp; ++i) {
+      if (!CheckDoubleWithin(analytic_values[i], expected_improvement[i], 0.0)) {
+        ++total_errors;
+      }
+      if (!CheckDoubleWithin(monte_carlo_values[i], expected_improvement[i], mc_tolerance*max_expected_improvement)) {
+        ++total_errors;
+      }
+      monte_carlo_used = monte_carlo_used || monte_carlo_values[i] != expected_improvement[i];
+    }
+    if (!monte_carlo_used) {
+      OL_PARTIAL_FAILURE_PRINTF("ExpectedImprovementEvaluationTypes::kMonteCarlo computed EI analytically\n");
+      ++total_errors;
+    }
+  }
+
   return total_errors;
 }
 
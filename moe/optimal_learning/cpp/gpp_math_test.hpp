@@ -77,6 +77,51 @@ OL_WARN_UNUSED_RESULT int PingEIGeneralTest();
 \endrst*/
 OL_WARN_UNUSED_RESULT int PingEIOnePotentialSampleTest();
 
+/*!\rst
+  Checks that incrementally adding points to a GP (GaussianProcess::AddPointsToGP) matches building the GP
+  from scratch on all points, and that factoring/extending with several threads matches doing so with one.
+
+  \return
+    number of test failures: 0 if all is working well.
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessAddPointsTest();
+
+/*!\rst
+  Checks that SparseGaussianProcess (VFE) with inducing points equal to the sampled points matches GaussianProcess,
+  that FITC gradients of the mean and variance match finite differences, and that EI optimization runs on it.
+
+  \return
+    number of test failures: 0 if all is working well.
+\endrst*/
+OL_WARN_UNUSED_RESULT int SparseGaussianProcessTest();
+
+/*!\rst
+  Checks that PointsToSampleState::UpdateMovingPoints(), which caches quantities derived from the fixed points,
+  matches rebuilding the state from scratch.
+
+  \return
+    number of test failures: 0 if all is working well.
+\endrst*/
+OL_WARN_UNUSED_RESULT int PointsToSampleStateFixedPointsTest();
+
+/*!\rst
+  Checks that BatchOnePotentialSampleExpectedImprovementEvaluator (and the GP mean/marginal variance kernel it uses)
+  matches evaluating 1,0-EI one point at a time.
+
+  \return
+    number of test failures: 0 if all is working well.
+\endrst*/
+OL_WARN_UNUSED_RESULT int BatchOnePotentialSampleExpectedImprovementTest();
+
+/*!\rst
+  Checks that ComputeMeanAndMarginalVarianceOfPointList() (chunked, multithreaded) matches computing the mean and
+  variance one point at a time.
+
+  \return
+    number of test failures: 0 if all is working well.
+\endrst*/
+OL_WARN_UNUSED_RESULT int MarginalPredictionPointListTest();
+
 /*!\rst
   Runs a battery of tests for the GP and EI functions, including ping tests for:
 
@@ -86,6 +131,15 @@ OL_WARN_UNUSED_RESULT int PingEIOnePotentialSampleTest();
   * Expected Improvement
   * Expected Improvement special case: only *ONE* potential point to sample
 
+  consistency testing for:
+
+  * incremental updates to the GP (AddPointsToGP)
+  * sparse (inducing point) GP vs the exact GP
+  * PointsToSampleState with cached fixed points vs rebuilding it
+  * batched 1,0-EI vs evaluating one point at a time
+  * monte-carlo EI split across a WorkStealingTaskPool vs one thread
+  * chunked mean/marginal variance over a point list vs evaluating one point at a time
+
   and edge case testing for:
 
   * 1D Analytic Expected Improvement
@@ -106,7 +160,8 @@ OL_WARN_UNUSED_RESULT int RunGPTests();
 OL_WARN_UNUSED_RESULT int RunEIConsistencyTests();
 
 /*!\rst
-  Checks that multithreaded EI optimization behaves the same way that single threaded does.
+  Checks that multithreaded EI optimization (and EI evaluation at a point list) gives bitwise the same results as
+  single threaded, for several thread counts and schedules.
 
   \param
     :ei_mode: ei evaluation mode to test (analytic or monte carlo)
@@ -140,6 +195,16 @@ OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationTest(DomainTypes domain
 \endrst*/
 OL_WARN_UNUSED_RESULT int ExpectedImprovementOptimizationMultipleSamplesTest();
 
+/*!\rst
+  Checks that multistarted (projected) L-BFGS, i.e., MultistartOptimizer<LBFGSOptimizer<...>>, optimizes analytic q,p-EI
+  over a RepeatedDomain<TensorProductDomain> at least as well as multistarted gradient descent from the same starts, both
+  directly and through ComputeOptimalPointsToSample() (with and without adaptive multistart).
+
+  \return
+    number of test failures: 0 if L-BFGS EI optimization is working properly
+\endrst*/
+OL_WARN_UNUSED_RESULT int ExpectedImprovementLBFGSOptimizationTest();
+
 /*!\rst
   Tests EvaluateEIAtPointList (computes EI at a specified list of points, multithreaded).
   Checks that the returned best point is in fact the best.
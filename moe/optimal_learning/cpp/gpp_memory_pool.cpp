@@ -0,0 +1,75 @@
+/*!
+  \file gpp_memory_pool.cpp
+  \rst
+  Implementation of ScratchArena; see gpp_memory_pool.hpp for details.
+\endrst*/
+
+#include "gpp_memory_pool.hpp"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+ScratchArena::ScratchArena()
+    : blocks_(),
+      block_sizes_(),
+      block_index_(-1),
+      offset_(0),
+      num_block_allocations_(0) {
+}
+
+ScratchArena::~ScratchArena() = default;
+
+ScratchArena& ScratchArena::ThreadLocal() noexcept {
+  // constructed on first use by each thread; destroyed (freeing its blocks) when that thread exits
+  thread_local ScratchArena arena;
+  return arena;
+}
+
+std::size_t ScratchArena::capacity() const noexcept {
+  return std::accumulate(block_sizes_.begin(), block_sizes_.end(), static_cast<std::size_t>(0));
+}
+
+void * ScratchArena::AllocateBytes(std::size_t num_bytes) {
+  num_bytes = (num_bytes + kAlignment - 1)/kAlignment*kAlignment;
+  if (likely(block_index_ >= 0 && offset_ + num_bytes <= block_sizes_[block_index_])) {
+    void * result = blocks_[block_index_].get() + offset_;
+    offset_ += num_bytes;
+    return result;
+  }
+
+  // current block is full (or there is none yet): move to the next block, creating it if it is missing or too small
+  ++block_index_;
+  const int num_blocks = blocks_.size();
+  if (block_index_ == num_blocks || block_sizes_[block_index_] < num_bytes) {
+    std::size_t block_size = kMinimumBlockSize;
+    if (block_index_ > 0) {
+      block_size = std::max(block_size, 2*block_sizes_[block_index_ - 1]);
+    }
+    block_size = std::max(block_size, num_bytes);
+
+    // value-initialization zero-fills the block, so its pages are first touched by the owning thread
+    std::unique_ptr<unsigned char[]> block(new unsigned char[block_size]());
+    if (block_index_ == num_blocks) {
+      blocks_.push_back(std::move(block));
+      block_sizes_.push_back(block_size);
+    } else {
+      blocks_[block_index_] = std::move(block);
+      block_sizes_[block_index_] = block_size;
+    }
+    ++num_block_allocations_;
+  }
+
+  offset_ = num_bytes;
+  return blocks_[block_index_].get();
+}
+
+}  // end namespace optimal_learning
@@ -0,0 +1,164 @@
+/*!
+  \file gpp_memory_pool.hpp
+  \rst
+  This file contains ScratchArena, a per-thread, stack-like ("bump") allocator for short-lived scratch buffers, and its
+  RAII helper ScratchArena::Frame.
+
+  Optimizers (see gpp_optimization.hpp) need a handful of small temporaries (gradient, step, next point, ...) every
+  time they run.  Each optimization is short, and the multistart optimizers run many of them per call.  Serving
+  high-QPS requests, these ``std::vector`` allocations (and the corresponding frees, often on a different thread's
+  heap arena) show up in profiles.  Instead, each thread owns one ScratchArena (ScratchArena::ThreadLocal()) whose
+  blocks are reused by every subsequent call on that thread:
+
+  1. No calls to the heap allocator once the arena has grown to its high-water mark.
+  2. NUMA locality: a block is allocated and zero-filled (first-touched) by the thread that owns the arena, so with
+     the usual first-touch page placement policy, its pages live on that thread's NUMA node.  OpenMP runtimes keep
+     their worker threads alive between parallel regions, so the same arena is reused across calls (and across
+     requests served by the same process).
+
+  Allocation is LIFO: a Frame marks the arena's current position on construction and releases everything allocated
+  through it on destruction (including during stack unwinding).  Frames nest in the obvious way::
+
+    ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+    double * restrict gradient = scratch.Allocate<double>(problem_size);
+    ...  // calls that open their own Frames on the same arena are fine
+    // gradient is released when scratch goes out of scope
+
+  .. WARNING:: a ScratchArena is NOT THREAD-SAFE; only use ScratchArena::ThreadLocal() from its own thread, and do not
+    let pointers from it outlive their Frame (or cross into other threads after the Frame ends).
+
+  Memory is retained for the life of the thread (it is freed when the thread exits); the high-water mark is the
+  largest total live scratch requested at once, which for the optimizers is a few vectors of length ``problem_size``.
+
+  The arena is for temporaries whose count scales with the work done (per optimizer iteration, per objective
+  evaluation, e.g., the monte-carlo EI batch buffers in gpp_math.cpp).  Evaluator State objects (e.g.,
+  ExpectedImprovementState, LogMarginalLikelihoodState) keep their ``std::vector`` members: a call (e.g., one EI
+  optimization request) builds one State per thread and reuses it for every start and every iteration, so those
+  allocations are a fixed, small number per call.  They also outlive any one Frame, which the arena cannot express.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MEMORY_POOL_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_MEMORY_POOL_HPP_
+
+#include <cstddef>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  Stack-like arena of reusable scratch memory; see file comments for usage.
+
+  The arena is a list of blocks.  Allocations are carved off the current block; when a request does not fit, the
+  arena moves on to the next block (creating or growing it as needed).  Blocks are never freed while the arena
+  lives, so a Frame's destruction just rewinds the (block, offset) position.
+\endrst*/
+class ScratchArena final {
+ public:
+  //! All allocations are aligned to (and rounded up to a multiple of) this many bytes; enough for any scalar type.
+  static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+  //! Size in bytes of the first block allocated; later blocks at least double in size.
+  static constexpr std::size_t kMinimumBlockSize = 4096;
+
+  /*!\rst
+    RAII handle for a LIFO region of a ScratchArena: allocations made through it are released when it is destroyed.
+    Frames on the same arena must be destroyed in reverse order of construction (automatic when they are locals).
+  \endrst*/
+  class Frame final {
+   public:
+    /*!\rst
+      Marks the current position of ``arena``.
+
+      \param
+        :arena[1]: the arena to allocate from; must outlive this object
+    \endrst*/
+    explicit Frame(ScratchArena * arena) OL_NONNULL_POINTERS
+        : arena_(arena),
+          block_index_(arena->block_index_),
+          offset_(arena->offset_) {
+    }
+
+    //! Rewinds the arena to the position marked on construction.
+    ~Frame() {
+      arena_->block_index_ = block_index_;
+      arena_->offset_ = offset_;
+    }
+
+    /*!\rst
+      Allocates uninitialized space for ``size`` objects of type ``ValueType`` (a trivial type, e.g., ``double``).
+      The contents are whatever the previous user of the memory left behind.
+
+      \param
+        :size: number of objects, ``size >= 0``
+      \return
+        pointer to ``size`` objects; valid until this Frame is destroyed
+    \endrst*/
+    template <typename ValueType>
+    OL_WARN_UNUSED_RESULT ValueType * Allocate(int size) {
+      static_assert(std::is_trivial<ValueType>::value, "ScratchArena only holds trivial types.");
+      static_assert(kAlignment % alignof(ValueType) == 0, "ValueType is over-aligned.");
+      return static_cast<ValueType *>(arena_->AllocateBytes(static_cast<std::size_t>(size)*sizeof(ValueType)));
+    }
+
+    OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(Frame);
+
+   private:
+    //! arena this frame allocates from
+    ScratchArena * arena_;
+    //! arena position when this frame was created
+    int block_index_;
+    std::size_t offset_;
+  };
+
+  ScratchArena();
+
+  ~ScratchArena();
+
+  /*!\rst
+    \return
+      the calling thread's arena, created (empty) on first use
+  \endrst*/
+  static ScratchArena& ThreadLocal() noexcept OL_WARN_UNUSED_RESULT;
+
+  //! \return total bytes held by this arena (in use or not)
+  std::size_t capacity() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT;
+
+  //! \return number of heap allocations this arena has made over its lifetime (i.e., number of blocks created)
+  int num_block_allocations() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return num_block_allocations_;
+  }
+
+  OL_DISALLOW_COPY_AND_ASSIGN(ScratchArena);
+
+ private:
+  /*!\rst
+    Carves ``num_bytes`` (rounded up to a multiple of kAlignment) off the current block, moving to (and if needed,
+    creating or enlarging) the next block if the current one is too full.  Blocks past the current one hold no live
+    allocations, so enlarging them is safe.
+
+    \param
+      :num_bytes: number of bytes requested
+    \return
+      pointer to the start of the allocation, aligned to kAlignment
+  \endrst*/
+  void * AllocateBytes(std::size_t num_bytes) OL_WARN_UNUSED_RESULT;
+
+  //! memory blocks; each is zero-filled by the owning thread when created
+  std::vector<std::unique_ptr<unsigned char[]> > blocks_;
+  //! size in bytes of each block
+  std::vector<std::size_t> block_sizes_;
+  //! index of the block currently being allocated from (-1 if the arena is empty)
+  int block_index_;
+  //! bytes already used in blocks_[block_index_]
+  std::size_t offset_;
+  //! lifetime count of blocks created
+  int num_block_allocations_;
+};
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_MEMORY_POOL_HPP_
@@ -0,0 +1,165 @@
+/*!
+  \file gpp_memory_pool_test.cpp
+  \rst
+  This file contains functions for testing ScratchArena in gpp_memory_pool.hpp.
+\endrst*/
+
+#include "gpp_memory_pool_test.hpp"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+#include <omp.h>  // NOLINT(build/include_order)
+
+#include "gpp_common.hpp"
+#include "gpp_logging.hpp"
+#include "gpp_memory_pool.hpp"
+#include "gpp_test_utils.hpp"
+
+namespace optimal_learning {
+
+namespace {  // tests of ScratchArena
+
+/*!\rst
+  Checks alignment, disjointness, LIFO release, reuse, and oversized requests on a single arena.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int ScratchArenaAllocationTest() {
+  int total_errors = 0;
+  ScratchArena arena;
+  if (!CheckIntEquals(arena.capacity(), 0)) {
+    ++total_errors;
+  }
+
+  const std::vector<int> sizes = {1, 7, 100, 3};
+  std::vector<double *> first_pass(sizes.size());
+  {
+    ScratchArena::Frame scratch(&arena);
+    for (int i = 0; i < static_cast<int>(sizes.size()); ++i) {
+      first_pass[i] = scratch.Allocate<double>(sizes[i]);
+      if (reinterpret_cast<std::uintptr_t>(first_pass[i]) % ScratchArena::kAlignment != 0) {
+        ++total_errors;
+      }
+      std::fill(first_pass[i], first_pass[i] + sizes[i], static_cast<double>(i));
+    }
+    int * restrict ints = scratch.Allocate<int>(5);
+    std::fill(ints, ints + 5, -1);
+
+    // earlier allocations were not overwritten by later ones
+    for (int i = 0; i < static_cast<int>(sizes.size()); ++i) {
+      for (int j = 0; j < sizes[i]; ++j) {
+        if (first_pass[i][j] != static_cast<double>(i)) {
+          ++total_errors;
+        }
+      }
+    }
+
+    // a nested frame starts where the outer one is; the outer frame's next allocation reuses the nested space
+    double * nested_allocation;
+    {
+      ScratchArena::Frame nested_scratch(&arena);
+      nested_allocation = nested_scratch.Allocate<double>(10);
+    }
+    if (scratch.Allocate<double>(10) != nested_allocation) {
+      ++total_errors;
+    }
+  }
+
+  // same requests after the frame is gone: same memory, no new blocks
+  const int num_block_allocations = arena.num_block_allocations();
+  {
+    ScratchArena::Frame scratch(&arena);
+    for (int i = 0; i < static_cast<int>(sizes.size()); ++i) {
+      if (scratch.Allocate<double>(sizes[i]) != first_pass[i]) {
+        ++total_errors;
+      }
+    }
+  }
+  if (!CheckIntEquals(arena.num_block_allocations(), num_block_allocations)) {
+    ++total_errors;
+  }
+
+  // requests larger than any block get a new block, which is then reused
+  const int large_size = 10*ScratchArena::kMinimumBlockSize;
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    ScratchArena::Frame scratch(&arena);
+    double * small = scratch.Allocate<double>(4);
+    double * large = scratch.Allocate<double>(large_size);
+    std::fill(large, large + large_size, 1.0);
+    std::fill(small, small + 4, 2.0);
+    if (large[0] != 1.0 || large[large_size - 1] != 1.0) {
+      ++total_errors;
+    }
+  }
+  if (!CheckIntEquals(arena.num_block_allocations(), num_block_allocations + 1)) {
+    ++total_errors;
+  }
+  if (arena.capacity() < large_size*sizeof(double)) {
+    ++total_errors;
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that ScratchArena::ThreadLocal() returns a distinct arena per thread and the same arena on repeat calls.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int ScratchArenaThreadLocalTest() {
+  int total_errors = 0;
+  const int num_threads = 4;
+  std::vector<ScratchArena *> arenas(num_threads, nullptr);
+#pragma omp parallel num_threads(num_threads)
+  {
+    ScratchArena * arena = &ScratchArena::ThreadLocal();
+    arenas[omp_get_thread_num()] = arena;
+    if (arena != &ScratchArena::ThreadLocal()) {
+#pragma omp atomic
+      ++total_errors;
+    }
+  }
+
+  // the runtime may provide fewer threads than requested; those that ran must have distinct arenas
+  arenas.erase(std::remove(arenas.begin(), arenas.end(), nullptr), arenas.end());
+  std::sort(arenas.begin(), arenas.end());
+  if (arenas.empty() || std::adjacent_find(arenas.begin(), arenas.end()) != arenas.end()) {
+    ++total_errors;
+  }
+
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+int RunMemoryPoolTests() {
+  int total_errors = 0;
+  int current_errors = 0;
+
+  current_errors = ScratchArenaAllocationTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("ScratchArena allocation failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = ScratchArenaThreadLocalTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("ScratchArena thread-local instances failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("memory pool tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("memory pool tests passed\n");
+  }
+
+  return total_errors;
+}
+
+}  // end namespace optimal_learning
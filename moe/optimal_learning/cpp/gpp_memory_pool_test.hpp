@@ -0,0 +1,29 @@
+/*!
+  \file gpp_memory_pool_test.hpp
+  \rst
+  Tests for gpp_memory_pool.hpp: the per-thread ScratchArena allocator.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MEMORY_POOL_TEST_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_MEMORY_POOL_TEST_HPP_
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  Checks that ScratchArena is working:
+
+  * allocations are aligned and do not overlap
+  * frames release their allocations in LIFO order, and memory is reused (no new heap allocations) afterward
+  * requests larger than the current block are served
+  * each thread gets its own arena from ScratchArena::ThreadLocal()
+
+  \return
+    number of test failures: 0 if ScratchArena is working properly
+\endrst*/
+OL_WARN_UNUSED_RESULT int RunMemoryPoolTests();
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_MEMORY_POOL_TEST_HPP_
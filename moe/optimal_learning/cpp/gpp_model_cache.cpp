@@ -0,0 +1,301 @@
+/*!
+  \file gpp_model_cache.cpp
+  \rst
+  Implementation of GaussianProcessCache; see gpp_model_cache.hpp for details.
+\endrst*/
+
+#include "gpp_model_cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "gpp_common.hpp"
+#include "gpp_covariance.hpp"
+#include "gpp_logging.hpp"
+#include "gpp_math.hpp"
+
+namespace optimal_learning {
+
+namespace {
+
+/*!\rst
+  Streaming 64-bit hash: FNV-1a over 64-bit words (instead of bytes), finished with the splitmix64 finalizer so that
+  every input bit affects every output bit.  Not cryptographic; GaussianProcessCache verifies matches exactly.
+\endrst*/
+class ContentHasher final {
+ public:
+  ContentHasher() : state_(14695981039346656037ull) {
+  }
+
+  void Add(std::uint64_t word) noexcept {
+    state_ = (state_ ^ word) * 1099511628211ull;
+  }
+
+  //! hashes the bit patterns of values[0:size)
+  void Add(double const * restrict values, int size) noexcept {
+    for (int i = 0; i < size; ++i) {
+      std::uint64_t word;
+      std::memcpy(&word, values + i, sizeof(word));
+      Add(word);
+    }
+  }
+
+  std::uint64_t Finish() const noexcept OL_WARN_UNUSED_RESULT {
+    std::uint64_t hash = state_;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+//! \return true if a[0:size) and b[0:size) have identical bit patterns
+OL_WARN_UNUSED_RESULT bool BitwiseEqual(double const * restrict a, double const * restrict b, int size) noexcept {
+  return size == 0 || std::memcmp(a, b, size*sizeof(double)) == 0;
+}
+
+}  // end unnamed namespace
+
+//! identifies the model requested by GetOrFit(): hashes plus (unowned) inputs for exact comparison
+struct GaussianProcessCache::Key final {
+  Key(const CovarianceInterface& covariance, double const * restrict points_sampled_in,
+      double const * restrict points_sampled_value_in, double const * restrict noise_variance_in,
+      int dim_in, int num_sampled_in)
+      : hash(0), family_hash(0), covariance_type(typeid(covariance)),
+        hyperparameters(covariance.GetNumberOfHyperparameters()), points_sampled(points_sampled_in),
+        points_sampled_value(points_sampled_value_in), noise_variance(noise_variance_in), dim(dim_in),
+        num_sampled(num_sampled_in) {
+    covariance.GetHyperparameters(hyperparameters.data());
+
+    ContentHasher hasher;
+    hasher.Add(covariance_type.hash_code());
+    hasher.Add(hyperparameters.size());
+    hasher.Add(hyperparameters.data(), hyperparameters.size());
+    hasher.Add(dim);
+    family_hash = hasher.Finish();
+
+    hasher.Add(num_sampled);
+    hasher.Add(points_sampled, dim*num_sampled);
+    hasher.Add(points_sampled_value, num_sampled);
+    hasher.Add(noise_variance, num_sampled);
+    hash = hasher.Finish();
+  }
+
+  //! hash of everything below
+  std::uint64_t hash;
+  //! hash of covariance_type, hyperparameters, and dim: models that may extend one another
+  std::uint64_t family_hash;
+  std::type_index covariance_type;
+  std::vector<double> hyperparameters;
+  double const * points_sampled;
+  double const * points_sampled_value;
+  double const * noise_variance;
+  int dim;
+  int num_sampled;
+};
+
+//! a cached model and the (non-data) parts of the key it was fit to
+struct GaussianProcessCache::Entry final {
+  Entry(const Key& key, std::shared_ptr<const GaussianProcess> gaussian_process_in, std::size_t num_bytes_in)
+      : hash(key.hash), family_hash(key.family_hash), covariance_type(key.covariance_type),
+        hyperparameters(key.hyperparameters), gaussian_process(std::move(gaussian_process_in)), num_bytes(num_bytes_in) {
+  }
+
+  //! \return true if this model was fit with the covariance type, hyperparameters, and dim of key
+  bool SameFamily(const Key& key) const noexcept OL_WARN_UNUSED_RESULT {
+    return family_hash == key.family_hash && covariance_type == key.covariance_type &&
+        gaussian_process->dim() == key.dim && hyperparameters.size() == key.hyperparameters.size() &&
+        BitwiseEqual(hyperparameters.data(), key.hyperparameters.data(), hyperparameters.size());
+  }
+
+  //! \return true if this model was fit to the first num_sampled points (and values, noise) of key
+  bool MatchesPrefix(const Key& key, int num_sampled) const noexcept OL_WARN_UNUSED_RESULT {
+    return gaussian_process->num_sampled() == num_sampled && SameFamily(key) &&
+        BitwiseEqual(gaussian_process->points_sampled().data(), key.points_sampled, key.dim*num_sampled) &&
+        BitwiseEqual(gaussian_process->points_sampled_value().data(), key.points_sampled_value, num_sampled) &&
+        BitwiseEqual(gaussian_process->noise_variance().data(), key.noise_variance, num_sampled);
+  }
+
+  std::uint64_t hash;
+  std::uint64_t family_hash;
+  std::type_index covariance_type;
+  std::vector<double> hyperparameters;
+  std::shared_ptr<const GaussianProcess> gaussian_process;
+  //! estimated memory held by gaussian_process
+  std::size_t num_bytes;
+};
+
+GaussianProcessCache::GaussianProcessCache(std::size_t memory_budget)
+    : mutex_(),
+      memory_budget_(memory_budget),
+      entries_(),
+      exact_index_(),
+      family_index_(),
+      memory_used_(0),
+      num_hits_(0),
+      num_extensions_(0),
+      num_fits_(0),
+      num_over_budget_(0) {
+}
+
+GaussianProcessCache::~GaussianProcessCache() = default;
+
+std::size_t GaussianProcessCache::EstimateMemoryUsage(int dim, int num_sampled, int num_hyperparameters) noexcept {
+  // K_chol is num_sampled^2; points_sampled is dim*num_sampled; values, noise, K_inv_y are num_sampled each
+  const std::size_t num_doubles = static_cast<std::size_t>(num_sampled)*num_sampled +
+      static_cast<std::size_t>(dim)*num_sampled + 3*static_cast<std::size_t>(num_sampled) + num_hyperparameters;
+  return sizeof(GaussianProcess) + num_doubles*sizeof(double);
+}
+
+GaussianProcessCache::EntryList::iterator GaussianProcessCache::FindExact(const Key& key) {
+  auto range = exact_index_.equal_range(key.hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->MatchesPrefix(key, key.num_sampled)) {
+      return it->second;
+    }
+  }
+  return entries_.end();
+}
+
+GaussianProcessCache::EntryList::iterator GaussianProcessCache::FindLongestPrefix(const Key& key) {
+  EntryList::iterator best = entries_.end();
+  int best_num_sampled = 0;
+  auto range = family_index_.equal_range(key.family_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const int num_sampled = it->second->gaussian_process->num_sampled();
+    if (num_sampled > best_num_sampled && num_sampled < key.num_sampled && it->second->MatchesPrefix(key, num_sampled)) {
+      best = it->second;
+      best_num_sampled = num_sampled;
+    }
+  }
+  return best;
+}
+
+void GaussianProcessCache::Touch(EntryList::iterator entry) {
+  entries_.splice(entries_.begin(), entries_, entry);
+}
+
+void GaussianProcessCache::Erase(EntryList::iterator entry) {
+  auto RemoveFromIndex = [entry](std::uint64_t hash, EntryIndex * index) {
+    auto range = index->equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == entry) {
+        index->erase(it);
+        return;
+      }
+    }
+  };
+  RemoveFromIndex(entry->hash, &exact_index_);
+  RemoveFromIndex(entry->family_hash, &family_index_);
+  memory_used_ -= entry->num_bytes;
+  entries_.erase(entry);
+}
+
+void GaussianProcessCache::EvictToFit(std::size_t num_bytes) {
+  while (!entries_.empty() && memory_used_ + num_bytes > memory_budget_) {
+    Erase(std::prev(entries_.end()));
+  }
+}
+
+std::shared_ptr<const GaussianProcess> GaussianProcessCache::GetOrFit(const CovarianceInterface& covariance,
+                                                                      double const * restrict points_sampled,
+                                                                      double const * restrict points_sampled_value,
+                                                                      double const * restrict noise_variance,
+                                                                      int dim, int num_sampled) {
+  const Key key(covariance, points_sampled, points_sampled_value, noise_variance, dim, num_sampled);
+
+  std::shared_ptr<const GaussianProcess> prefix_gaussian_process;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EntryList::iterator entry = FindExact(key);
+    if (entry != entries_.end()) {
+      Touch(entry);
+      num_hits_.fetch_add(1, std::memory_order_relaxed);
+      return entry->gaussian_process;
+    }
+    entry = FindLongestPrefix(key);
+    if (entry != entries_.end()) {
+      Touch(entry);
+      prefix_gaussian_process = entry->gaussian_process;
+    }
+  }
+
+  // fit outside of the lock; prefix_gaussian_process stays alive even if it is evicted meanwhile
+  std::shared_ptr<GaussianProcess> gaussian_process;
+  if (prefix_gaussian_process != nullptr) {
+    const int num_cached = prefix_gaussian_process->num_sampled();
+    gaussian_process.reset(prefix_gaussian_process->Clone());
+    gaussian_process->AddPointsToGP(points_sampled + dim*num_cached, points_sampled_value + num_cached,
+                                    noise_variance + num_cached, num_sampled - num_cached);
+    num_extensions_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    gaussian_process = std::make_shared<GaussianProcess>(covariance, points_sampled, points_sampled_value,
+                                                         noise_variance, dim, num_sampled);
+    num_fits_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const std::size_t num_bytes = EstimateMemoryUsage(dim, num_sampled, key.hyperparameters.size());
+  std::lock_guard<std::mutex> lock(mutex_);
+  // another thread may have cached the same model while we were fitting; share theirs
+  EntryList::iterator existing = FindExact(key);
+  if (existing != entries_.end()) {
+    Touch(existing);
+    return existing->gaussian_process;
+  }
+  if (num_bytes > memory_budget_) {
+    // nothing can be evicted to make room; a budget too small for the deployment's models shows up here
+    num_over_budget_.fetch_add(1, std::memory_order_relaxed);
+    OL_WARNING_PRINTF("GaussianProcessCache: model of %lu bytes (num_sampled = %d) exceeds memory budget of %lu bytes, "
+                      "not cached\n", static_cast<unsigned long>(num_bytes), num_sampled,
+                      static_cast<unsigned long>(memory_budget_));
+    return gaussian_process;
+  }
+  EvictToFit(num_bytes);
+  entries_.emplace_front(key, gaussian_process, num_bytes);
+  exact_index_.emplace(key.hash, entries_.begin());
+  family_index_.emplace(key.family_hash, entries_.begin());
+  memory_used_ += num_bytes;
+  return gaussian_process;
+}
+
+void GaussianProcessCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  exact_index_.clear();
+  family_index_.clear();
+  entries_.clear();
+  memory_used_ = 0;
+}
+
+void GaussianProcessCache::SetMemoryBudget(std::size_t memory_budget) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memory_budget_ = memory_budget;
+  EvictToFit(0);
+}
+
+std::size_t GaussianProcessCache::memory_budget() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return memory_budget_;
+}
+
+std::size_t GaussianProcessCache::memory_used() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return memory_used_;
+}
+
+int GaussianProcessCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // end namespace optimal_learning
@@ -0,0 +1,206 @@
+/*!
+  \file gpp_model_cache.hpp
+  \rst
+  This file contains GaussianProcessCache, a thread-safe, memory-bounded LRU cache of fitted GaussianProcess objects
+  keyed by the content of their inputs.
+
+  Constructing a GaussianProcess costs ``O(N^3)`` (factoring ``K``; see GaussianProcess::RecomputeDerivedVariables()).
+  A REST server sees the same experiment history (same covariance, hyperparameters, ``points_sampled``, values, and
+  noise) over and over, and refitting the GP for every request dominates the cost of short requests.  Instead::
+
+    GaussianProcessCache model_cache(memory_budget_in_bytes);
+    std::shared_ptr<const GaussianProcess> gaussian_process = model_cache.GetOrFit(covariance, points_sampled,
+                                                                                   points_sampled_value,
+                                                                                   noise_variance, dim, num_sampled);
+
+  GetOrFit() handles three cases:
+
+  1. Hit: a cached model was fit to exactly these inputs (same covariance type, hyperparameters, and data).  It is
+     returned as-is; no numerical work.
+  2. Append-only growth: a cached model (same covariance type and hyperparameters) was fit to a *prefix* of these inputs;
+     i.e., the history only gained points at the end, the usual pattern as an experiment progresses.  The model is
+     cloned and extended with the new points (GaussianProcess::AddPointsToGP(); ``O(N^2*k)`` for ``k`` new points)
+     instead of refactored.  The longest such prefix is used.
+  3. Miss: a new GaussianProcess is fit from scratch.
+
+  Models are keyed by a 64-bit content hash; entries whose hash matches are compared element-by-element (bitwise) before
+  being returned, so hash collisions cannot produce a wrong model.
+
+  Cached models are SHARED and READ-ONLY (``std::shared_ptr<const GaussianProcess>``): every caller asking for the same
+  inputs gets the same object.  Callers that need to modify a model (e.g., AddPointsToGP()) must Clone() it.  Evicting
+  a model only drops the cache's reference, so models stay valid for as long as callers hold them.
+
+  The cache evicts least recently used models once the (estimated) memory held by cached models exceeds its budget;
+  a model larger than the whole budget is returned but not cached.  So a budget of 0 disables caching.  The budget can
+  be changed at any time (SetMemoryBudget()); shrinking it evicts immediately.
+
+  GetOrFit() is thread-safe.  Fitting happens outside of the cache's lock, so concurrent requests for different models
+  do not serialize; concurrent misses on the same inputs may each fit the model, and the first one cached wins.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_CACHE_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+class CovarianceInterface;
+class GaussianProcess;
+
+/*!\rst
+  Memory-bounded LRU cache of fitted (read-only) GaussianProcess objects; see file comments for details.
+\endrst*/
+class GaussianProcessCache final {
+ public:
+  /*!\rst
+    Constructs an empty cache.
+
+    \param
+      :memory_budget: maximum number of bytes of (estimated) model memory to keep cached
+  \endrst*/
+  explicit GaussianProcessCache(std::size_t memory_budget);
+
+  ~GaussianProcessCache();
+
+  /*!\rst
+    Returns a GaussianProcess fit to the specified inputs: a cached model if one matches, else a cached model extended
+    with appended points if one was fit to a prefix of the inputs, else a newly fit model.  The result is cached (if it
+    fits in the memory budget) and becomes the most recently used entry.
+
+    Inputs are as in the GaussianProcess constructor.
+
+    \param
+      :covariance: the covariance function (type and hyperparameters are part of the cache key)
+      :points_sampled[dim][num_sampled]: points that have already been sampled
+      :points_sampled_value[num_sampled]: values of the already-sampled points
+      :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+    \return
+      shared, read-only GaussianProcess fit to the inputs
+  \endrst*/
+  std::shared_ptr<const GaussianProcess> GetOrFit(const CovarianceInterface& covariance,
+                                                  double const * restrict points_sampled,
+                                                  double const * restrict points_sampled_value,
+                                                  double const * restrict noise_variance,
+                                                  int dim, int num_sampled) OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
+  //! Drops every cached model (models held by callers stay valid).
+  void Clear();
+
+  /*!\rst
+    Changes the memory budget, evicting least recently used models until the cached models fit in it.
+
+    \param
+      :memory_budget: maximum number of bytes of (estimated) model memory to keep cached; 0 disables caching
+  \endrst*/
+  void SetMemoryBudget(std::size_t memory_budget);
+
+  //! \return maximum number of bytes of model memory to keep cached
+  std::size_t memory_budget() const OL_WARN_UNUSED_RESULT;
+
+  //! \return (estimated) number of bytes of model memory currently cached
+  std::size_t memory_used() const OL_WARN_UNUSED_RESULT;
+
+  //! \return number of models currently cached
+  int size() const OL_WARN_UNUSED_RESULT;
+
+  //! \return number of GetOrFit() calls answered by a cached model
+  int num_hits() const noexcept OL_WARN_UNUSED_RESULT {
+    return num_hits_.load(std::memory_order_relaxed);
+  }
+
+  //! \return number of GetOrFit() calls answered by extending a cached model with appended points
+  int num_extensions() const noexcept OL_WARN_UNUSED_RESULT {
+    return num_extensions_.load(std::memory_order_relaxed);
+  }
+
+  //! \return number of GetOrFit() calls that fit a model from scratch
+  int num_fits() const noexcept OL_WARN_UNUSED_RESULT {
+    return num_fits_.load(std::memory_order_relaxed);
+  }
+
+  //! \return number of GetOrFit() calls whose model alone exceeded the memory budget (so it was returned uncached)
+  int num_over_budget() const noexcept OL_WARN_UNUSED_RESULT {
+    return num_over_budget_.load(std::memory_order_relaxed);
+  }
+
+  /*!\rst
+    \param
+      :dim: spatial dimension of the model
+      :num_sampled: number of sampled points in the model
+      :num_hyperparameters: number of covariance hyperparameters
+    \return
+      estimate of the number of bytes held by a GaussianProcess of the specified size (dominated by ``K_chol``)
+  \endrst*/
+  static std::size_t EstimateMemoryUsage(int dim, int num_sampled, int num_hyperparameters) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(GaussianProcessCache);
+
+ private:
+  struct Entry;
+  struct Key;
+  //! LRU list of entries: most recently used first
+  using EntryList = std::list<Entry>;
+  //! hash -> entries with that hash (there may be several if hashes collide)
+  using EntryIndex = std::unordered_multimap<std::uint64_t, EntryList::iterator>;
+
+  /*!\rst
+    Finds the cached entry fit to exactly the inputs described by ``key``.  Caller must hold mutex_.
+
+    \return
+      iterator to the entry, or entries_.end() if there is none
+  \endrst*/
+  EntryList::iterator FindExact(const Key& key);
+
+  /*!\rst
+    Finds the cached entry with the same covariance type and hyperparameters as ``key`` that was fit to the longest
+    proper prefix of its data.  Caller must hold mutex_.
+
+    \return
+      iterator to the entry, or entries_.end() if there is none
+  \endrst*/
+  EntryList::iterator FindLongestPrefix(const Key& key);
+
+  //! moves entry to the front of the LRU list; caller must hold mutex_
+  void Touch(EntryList::iterator entry);
+
+  //! removes entry from the cache; caller must hold mutex_
+  void Erase(EntryList::iterator entry);
+
+  //! evicts least recently used entries until ``num_bytes`` more fit in the budget; caller must hold mutex_
+  void EvictToFit(std::size_t num_bytes);
+
+  //! guards all members below
+  mutable std::mutex mutex_;
+  //! maximum number of bytes of model memory to keep cached
+  std::size_t memory_budget_;
+  //! cached models, most recently used first
+  EntryList entries_;
+  //! content hash -> entry
+  EntryIndex exact_index_;
+  //! hash of (covariance type, hyperparameters, dim) -> entry; candidates for append-only extension
+  EntryIndex family_index_;
+  //! sum of entries' memory estimates
+  std::size_t memory_used_;
+
+  //! statistics
+  std::atomic<int> num_hits_;
+  std::atomic<int> num_extensions_;
+  std::atomic<int> num_fits_;
+  std::atomic<int> num_over_budget_;
+};
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_CACHE_HPP_
@@ -0,0 +1,301 @@
+/*!
+  \file gpp_model_cache_test.cpp
+  \rst
+  This file contains functions for testing GaussianProcessCache in gpp_model_cache.hpp.
+\endrst*/
+
+#include "gpp_model_cache_test.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <boost/random/uniform_real.hpp>  // NOLINT(build/include_order)
+
+#include "gpp_common.hpp"
+#include "gpp_covariance.hpp"
+#include "gpp_logging.hpp"
+#include "gpp_math.hpp"
+#include "gpp_model_cache.hpp"
+#include "gpp_random.hpp"
+#include "gpp_test_utils.hpp"
+
+namespace optimal_learning {
+
+namespace {  // tests of GaussianProcessCache
+
+//! random experiment history (points, values, noise) for cache tests, with a shorthand for fitting it through a cache
+struct CacheTestData final : public RandomGaussianProcessData {
+  CacheTestData(int dim_in, int num_sampled_in, UniformRandomGenerator * uniform_generator)
+      : RandomGaussianProcessData(dim_in, num_sampled_in, 0, 0, 0.01, boost::uniform_real<double>(-2.0, 2.0),
+                                  uniform_generator) {
+  }
+
+  std::shared_ptr<const GaussianProcess> GetOrFit(const CovarianceInterface& covariance, int num_points,
+                                                  GaussianProcessCache * model_cache) const {
+    return model_cache->GetOrFit(covariance, points_sampled.data(), points_sampled_value.data(), noise_variance.data(),
+                                 dim, num_points);
+  }
+};
+
+/*!\rst
+  Checks that two GPs have the same mean and variance at a few random points.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int CheckSameGaussianProcess(const GaussianProcess& gaussian_process,
+                                                   const GaussianProcess& gaussian_process_truth, double tolerance,
+                                                   UniformRandomGenerator * uniform_generator) {
+  const int num_to_sample = 4;
+  const int dim = gaussian_process_truth.dim();
+  std::vector<double> points_to_sample(dim*num_to_sample);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  for (auto& entry : points_to_sample) {
+    entry = uniform_double(uniform_generator->engine);
+  }
+
+  int total_errors = 0;
+  if (!CheckIntEquals(gaussian_process.num_sampled(), gaussian_process_truth.num_sampled())) {
+    ++total_errors;
+  }
+
+  const int num_derivatives = 0;
+  std::vector<double> mean(num_to_sample);
+  std::vector<double> mean_truth(num_to_sample);
+  std::vector<double> variance(Square(num_to_sample));
+  std::vector<double> variance_truth(Square(num_to_sample));
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample.data(), num_to_sample,
+                                                    num_derivatives);
+  GaussianProcess::StateType points_to_sample_state_truth(gaussian_process_truth, points_to_sample.data(),
+                                                          num_to_sample, num_derivatives);
+  gaussian_process.ComputeMeanOfPoints(points_to_sample_state, mean.data());
+  gaussian_process_truth.ComputeMeanOfPoints(points_to_sample_state_truth, mean_truth.data());
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, variance.data());
+  gaussian_process_truth.ComputeVarianceOfPoints(&points_to_sample_state_truth, variance_truth.data());
+  for (int i = 0; i < num_to_sample; ++i) {
+    if (!CheckDoubleWithinRelative(mean[i], mean_truth[i], tolerance)) {
+      ++total_errors;
+    }
+    // variance is only valid in the lower triangle
+    for (int j = i; j < num_to_sample; ++j) {
+      if (!CheckDoubleWithinRelative(variance[i*num_to_sample + j], variance_truth[i*num_to_sample + j], tolerance)) {
+        ++total_errors;
+      }
+    }
+  }
+  return total_errors;
+}
+
+/*!\rst
+  Checks that identical requests (even from different buffers) share one model and that changing the covariance type,
+  hyperparameters, or (non-appended) data fits a new model.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessCacheHitTest() {
+  const int dim = 3;
+  const int num_sampled = 20;
+  UniformRandomGenerator uniform_generator(31415);
+  CacheTestData data(dim, num_sampled, &uniform_generator);
+  SquareExponential covariance(dim, 1.3, 0.8);
+  GaussianProcessCache model_cache(1 << 24);
+  int total_errors = 0;
+
+  auto gaussian_process = data.GetOrFit(covariance, num_sampled, &model_cache);
+  // same content, different buffers
+  CacheTestData data_copy(data);
+  auto gaussian_process_again = data_copy.GetOrFit(covariance, num_sampled, &model_cache);
+  if (gaussian_process_again != gaussian_process) {
+    ++total_errors;
+  }
+  if (!CheckIntEquals(model_cache.num_hits(), 1) || !CheckIntEquals(model_cache.num_fits(), 1)) {
+    ++total_errors;
+  }
+
+  // different hyperparameters
+  SquareExponential covariance_other(dim, 1.3, 0.7);
+  auto gaussian_process_other_hyperparameters = data.GetOrFit(covariance_other, num_sampled, &model_cache);
+  // different covariance type, same hyperparameters
+  MaternNu1p5 covariance_matern(dim, 1.3, 0.8);
+  auto gaussian_process_other_covariance = data.GetOrFit(covariance_matern, num_sampled, &model_cache);
+  // same points, changed value (not an append)
+  data_copy.points_sampled_value[num_sampled/2] += 1.0;
+  auto gaussian_process_other_data = data_copy.GetOrFit(covariance, num_sampled, &model_cache);
+  if (gaussian_process_other_hyperparameters == gaussian_process ||
+      gaussian_process_other_covariance == gaussian_process || gaussian_process_other_data == gaussian_process) {
+    ++total_errors;
+  }
+  if (!CheckIntEquals(model_cache.num_hits(), 1) || !CheckIntEquals(model_cache.num_extensions(), 0) ||
+      !CheckIntEquals(model_cache.num_fits(), 4) || !CheckIntEquals(model_cache.size(), 4)) {
+    ++total_errors;
+  }
+
+  GaussianProcess gaussian_process_truth(covariance_other, data.points_sampled.data(), data.points_sampled_value.data(),
+                                         data.noise_variance.data(), dim, num_sampled);
+  total_errors += CheckSameGaussianProcess(*gaussian_process_other_hyperparameters, gaussian_process_truth, 0.0,
+                                           &uniform_generator);
+  return total_errors;
+}
+
+/*!\rst
+  Checks that requests whose data extends a cached model's data are answered by extending the longest such model, and
+  that the result matches a model fit from scratch.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessCacheExtensionTest() {
+  const int dim = 2;
+  const int num_sampled = 40;
+  UniformRandomGenerator uniform_generator(2718);
+  CacheTestData data(dim, num_sampled, &uniform_generator);
+  SquareExponential covariance(dim, 1.1, 0.6);
+  GaussianProcessCache model_cache(1 << 24);
+  const double tolerance = 5.0e-12;
+  int total_errors = 0;
+
+  auto gaussian_process_initial = data.GetOrFit(covariance, 25, &model_cache);
+  auto gaussian_process_extended = data.GetOrFit(covariance, num_sampled, &model_cache);
+  // the longest cached prefix has 25 points (40 is not a prefix of 33)
+  auto gaussian_process_middle = data.GetOrFit(covariance, 33, &model_cache);
+  auto gaussian_process_hit = data.GetOrFit(covariance, num_sampled, &model_cache);
+  if (gaussian_process_hit != gaussian_process_extended || gaussian_process_initial->num_sampled() != 25) {
+    ++total_errors;
+  }
+  if (!CheckIntEquals(model_cache.num_fits(), 1) || !CheckIntEquals(model_cache.num_extensions(), 2) ||
+      !CheckIntEquals(model_cache.num_hits(), 1)) {
+    ++total_errors;
+  }
+
+  for (int num_points : {33, num_sampled}) {
+    GaussianProcess gaussian_process_truth(covariance, data.points_sampled.data(), data.points_sampled_value.data(),
+                                           data.noise_variance.data(), dim, num_points);
+    const GaussianProcess& gaussian_process = num_points == 33 ? *gaussian_process_middle : *gaussian_process_extended;
+    total_errors += CheckSameGaussianProcess(gaussian_process, gaussian_process_truth, tolerance, &uniform_generator);
+  }
+  return total_errors;
+}
+
+/*!\rst
+  Checks that the cache evicts the least recently used models to stay within budget (including when the budget
+  shrinks), does not cache models larger than the budget, and that evicted models stay usable.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessCacheEvictionTest() {
+  const int dim = 3;
+  const int num_sampled = 15;
+  UniformRandomGenerator uniform_generator(8675309);
+  SquareExponential covariance(dim, 1.0, 0.5);
+  // three different histories of the same size, none a prefix of another
+  std::vector<CacheTestData> data;
+  for (int i = 0; i < 3; ++i) {
+    data.emplace_back(dim, num_sampled, &uniform_generator);
+  }
+  const std::size_t model_size = GaussianProcessCache::EstimateMemoryUsage(dim, num_sampled,
+                                                                           covariance.GetNumberOfHyperparameters());
+  // room for two models
+  GaussianProcessCache model_cache(2*model_size + model_size/2);
+  int total_errors = 0;
+
+  auto gaussian_process_0 = data[0].GetOrFit(covariance, num_sampled, &model_cache);
+  auto gaussian_process_1 = data[1].GetOrFit(covariance, num_sampled, &model_cache);
+  // touch 0 so that 1 is least recently used
+  if (data[0].GetOrFit(covariance, num_sampled, &model_cache) != gaussian_process_0) {
+    ++total_errors;
+  }
+  auto gaussian_process_2 = data[2].GetOrFit(covariance, num_sampled, &model_cache);
+  if (!CheckIntEquals(model_cache.size(), 2) || model_cache.memory_used() > model_cache.memory_budget()) {
+    ++total_errors;
+  }
+  // 0 and 2 are still cached; 1 was evicted
+  if (data[0].GetOrFit(covariance, num_sampled, &model_cache) != gaussian_process_0 ||
+      data[2].GetOrFit(covariance, num_sampled, &model_cache) != gaussian_process_2) {
+    ++total_errors;
+  }
+  if (!CheckIntEquals(model_cache.num_hits(), 3) || !CheckIntEquals(model_cache.num_fits(), 3)) {
+    ++total_errors;
+  }
+
+  // the evicted model is still valid and is refit on request
+  GaussianProcess gaussian_process_truth(covariance, data[1].points_sampled.data(),
+                                         data[1].points_sampled_value.data(), data[1].noise_variance.data(), dim,
+                                         num_sampled);
+  total_errors += CheckSameGaussianProcess(*gaussian_process_1, gaussian_process_truth, 0.0, &uniform_generator);
+  auto gaussian_process_1_refit = data[1].GetOrFit(covariance, num_sampled, &model_cache);
+  if (gaussian_process_1_refit == gaussian_process_1 || !CheckIntEquals(model_cache.num_fits(), 4)) {
+    ++total_errors;
+  }
+
+  // a model larger than the budget is returned but not cached
+  {
+    GaussianProcessCache tiny_model_cache(model_size/2);
+    auto gaussian_process = data[0].GetOrFit(covariance, num_sampled, &tiny_model_cache);
+    total_errors += CheckSameGaussianProcess(*gaussian_process, *gaussian_process_0, 0.0, &uniform_generator);
+    if (!CheckIntEquals(tiny_model_cache.size(), 0) || !CheckIntEquals(tiny_model_cache.memory_used(), 0) ||
+        !CheckIntEquals(tiny_model_cache.num_over_budget(), 1)) {
+      ++total_errors;
+    }
+  }
+
+  // 1 and 2 are cached; shrinking the budget evicts the least recently used (2) right away
+  model_cache.SetMemoryBudget(model_size + model_size/2);
+  if (!CheckIntEquals(model_cache.size(), 1) || model_cache.memory_budget() != model_size + model_size/2 ||
+      data[1].GetOrFit(covariance, num_sampled, &model_cache) != gaussian_process_1_refit) {
+    ++total_errors;
+  }
+  // a budget of 0 disables caching
+  model_cache.SetMemoryBudget(0);
+  if (!CheckIntEquals(model_cache.size(), 0) || !CheckIntEquals(model_cache.memory_used(), 0)) {
+    ++total_errors;
+  }
+  data[0].GetOrFit(covariance, num_sampled, &model_cache);
+  if (!CheckIntEquals(model_cache.size(), 0) || !CheckIntEquals(model_cache.num_over_budget(), 1)) {
+    ++total_errors;
+  }
+
+  model_cache.SetMemoryBudget(2*model_size + model_size/2);
+  data[0].GetOrFit(covariance, num_sampled, &model_cache);
+  model_cache.Clear();
+  if (!CheckIntEquals(model_cache.size(), 0) || !CheckIntEquals(model_cache.memory_used(), 0)) {
+    ++total_errors;
+  }
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+int RunGaussianProcessCacheTests() {
+  int total_errors = 0;
+  int current_errors = 0;
+
+  current_errors = GaussianProcessCacheHitTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GaussianProcessCache hits failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = GaussianProcessCacheExtensionTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GaussianProcessCache append-only extension failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = GaussianProcessCacheEvictionTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GaussianProcessCache LRU eviction failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("model cache tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("model cache tests passed\n");
+  }
+
+  return total_errors;
+}
+
+}  // end namespace optimal_learning
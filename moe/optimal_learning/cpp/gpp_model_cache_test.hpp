@@ -0,0 +1,28 @@
+/*!
+  \file gpp_model_cache_test.hpp
+  \rst
+  Tests for gpp_model_cache.hpp: the GaussianProcessCache of fitted models.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_CACHE_TEST_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_CACHE_TEST_HPP_
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  Checks that GaussianProcessCache is working:
+
+  * repeated requests for the same inputs share one model; different hyperparameters or data get different models
+  * requests that append points to a cached model's data extend it, matching a model fit from scratch
+  * least recently used models are evicted to stay within the memory budget, and evicted models stay usable
+
+  \return
+    number of test failures: 0 if GaussianProcessCache is working properly
+\endrst*/
+OL_WARN_UNUSED_RESULT int RunGaussianProcessCacheTests();
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_CACHE_TEST_HPP_
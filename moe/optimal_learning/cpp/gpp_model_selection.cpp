@@ -246,7 +246,8 @@
       MultistartOptimizer<...>::MultistartOptimize(...) for multistarting (see gpp_optimization.hpp) together with
       NewtonOptimizer::Optimize<ObjectiveFunctionEvaluator, Domain>() (see gpp_optimization.hpp)
 
-  At the moment, we have two choices for the template parameter LogLikelihoodEvaluator: LML and LOO-CV.
+  At the moment, we have three choices for the template parameter LogLikelihoodEvaluator: LML, LOO-CV, and a
+  stochastic (matrix-free) estimate of LML.
   Each of these make additional lower level calls to gpp_linear_algebra routines and gpp_covariance routines.  The
   details (with derivations and optimizations where appropriate) are specified in the function implementation docs and
   will not be repeated here.
@@ -270,11 +271,23 @@
     LogMarginalLikelihoodEvaluator.  Its members require LeaveOneOutLogLikelihoodState, just as before.
 
     In the discussion of LOO-CV, we indicated two possible methods to compute the quantities ``\mu_i, \sigma_i^2``.
-    Both are implemented in the code, although it is currently configured to use the faster computation:
+    Both are implemented in the code, along with a third that combines their advantages:
 
     * LeaveOneOutCoreAccurate() computes \mu_i, \sigma_i^2 the direct way by forming a new GP.  This is slow but well-conditioned.
     * LeaveOneOutCoreWithMatrixInverse() computes \mu_i, \sigma_i^2 using the described "trick".  This is fast but the results
       may be heavily affected by numerical error (if K is poorly conditioned).
+    * LeaveOneOutCoreWithCholeskyDowndate() removes the ``i``-th row/column from the cholesky factor of ``K``.  This costs
+      ``O(N^2)`` per point (``O(N^3)`` total, like the inverse) and never forms ``K^-1``.
+
+    LeaveOneOutComputeTypes selects between the last two; the matrix inverse is the default.
+
+  * StochasticLogMarginalLikelihoodEvaluator:
+
+    Estimates the LML and its gradient for training sets too large to factor ``K``.  Its structure is the same as
+    LogMarginalLikelihoodEvaluator (with StochasticLogMarginalLikelihoodState), but it only ever applies ``K`` to vectors:
+    ``K^-1 y`` and ``K^-1 P^{1/2} w_t`` (for random probes ``w_t``) come from preconditioned conjugate gradients;
+    ``\log(det(K))`` from stochastic Lanczos quadrature on the same solves; and the gradient's trace term from
+    Hutchinson's estimator.
 \endrst*/
 
 #include "gpp_model_selection.hpp"
@@ -282,11 +295,14 @@
 #include <cmath>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <boost/random/uniform_int.hpp>  // NOLINT(build/include_order)
+
 #include "gpp_common.hpp"
 #include "gpp_covariance.hpp"
 #include "gpp_domain.hpp"
@@ -319,7 +335,6 @@ namespace {  // utilities for building covariance matrix and its hyperparameter
     :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
     :noise_variance[num_sampled]: i-th entry is amt of noise variance to add to i-th diagonal entry; i.e., noise measuring i-th point
     :points_sampled[dim][num_sampled]: list of points
-    :dim: spatial dimension of a point
     :num_sampled: number of points
   \output
     :cov_matrix[num_sampled][num_sampled]: computed covariance matrix
@@ -327,15 +342,12 @@ namespace {  // utilities for building covariance matrix and its hyperparameter
 OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const CovarianceInterface& covariance,
                                                                 double const * restrict noise_variance,
                                                                 double const * restrict points_sampled,
-                                                                int dim, int num_sampled,
+                                                                int num_sampled,
                                                                 double * restrict cov_matrix) noexcept {
   // we only work with lower triangular parts of symmetric matrices, so only fill half of it
+  covariance.SymmetricCovarianceMatrix(points_sampled, num_sampled, cov_matrix);
   for (int i = 0; i < num_sampled; ++i) {
-    for (int j = i; j < num_sampled; ++j) {
-      cov_matrix[j] = covariance.Covariance(points_sampled + i*dim, points_sampled+j*dim);
-    }
-    cov_matrix[i] += noise_variance[i];
-    cov_matrix += num_sampled;
+    cov_matrix[i*num_sampled + i] += noise_variance[i];
   }
 }
 
@@ -354,8 +366,8 @@ OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const Covariance
   of its symmetry), so instead of ignoring the upper triangles, we copy them from the
   (already-computed) lower triangles to avoid redundant work.
 
-  Since CovarianceInterface.HyperparameterGradCovariance() returns a vector of size ``|\theta_k|``,
-  the inner loop writes all relevant entries of ``A_{jik}`` simultaneously to prevent recomputation.
+  Each column of the lower triangle (all hyperparameters at once) comes from one call to
+  CovarianceInterface::HyperparameterGradCovarianceMatrix(), which already produces the block structure above.
 
   \param
     :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
@@ -372,7 +384,8 @@ OL_NONNULL_POINTERS void BuildHyperparameterGradCovarianceMatrix(const Covarianc
   const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
   const int offset = num_sampled*num_sampled;
 
-  std::vector<double> grad_covariance(num_hyperparameters);
+  // column i, rows j = i..num_sampled-1, for all hyperparameters
+  std::vector<double> grad_covariance_column(num_hyperparameters*num_sampled);
 
   // pointer to row that we're copying from
   double const * restrict grad_cov_matrix_row = grad_cov_matrix;  // used to index through rows
@@ -385,88 +398,39 @@ OL_NONNULL_POINTERS void BuildHyperparameterGradCovarianceMatrix(const Covarianc
       grad_cov_matrix_row += num_sampled;
     }
     grad_cov_matrix_row -= i*num_sampled;
-    for (int j = i; j < num_sampled; ++j) {
-      // compute all hyperparameter derivs at once for efficiency
-      covariance.HyperparameterGradCovariance(points_sampled + i*dim, points_sampled+j*dim, grad_covariance.data());
-      for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
-        // have to write each deriv to the correct block, due to the block structure of the output
-        grad_cov_matrix[i_hyper*offset + j] = grad_covariance[i_hyper];
-      }
+
+    // compute all hyperparameter derivs of the column at once for efficiency
+    const int num_rows = num_sampled - i;
+    covariance.HyperparameterGradCovarianceMatrix(points_sampled + i*dim, num_rows, points_sampled + i*dim, 1,
+                                                  grad_covariance_column.data());
+    for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+      // have to write each deriv to the correct block, due to the block structure of the output
+      std::copy(grad_covariance_column.data() + i_hyper*num_rows, grad_covariance_column.data() + (i_hyper+1)*num_rows,
+                grad_cov_matrix + i_hyper*offset + i);
     }
     grad_cov_matrix += num_sampled;
     grad_cov_matrix_row += 1;
   }
 }
 
-/*!\rst
-  Builds ``A_{jikl} = \mixpderiv{K_{ij}}{\theta_k}{\theta_l}``, the Hessian matrix of the covariance function wrt the hyperparameters.
-  Hence the outer loop structure is identical to BuildCovarianceMatrix().
-
-  Note the structure of the resulting tensor is ``Square(num_hyperparameters)`` blocks of size
-  ``num_sampled X num_sampled``.  Consumers of this want ``d^2K/(d\theta_k d\theta_l)`` located sequentially.
-  However, for a given pair of points ``(x, y)``, it is more efficient to compute all
-  hyperparameter derivatives at once.  Thus the innermost loop writes to all
-  num_hyperparameters blocks at once.
-
-  Consumers of this result generally require complete storage (i.e., will not take advantage
-  of its symmetry), so instead of ignoring the upper triangles, we copy them from the
-  (already-computed) lower triangles to avoid redundant work.
-
-  Since CovarianceInterface.HyperparameterHessianCovariance() returns an array of size
-  ``Square(|\theta_k|)``, the inner loop writes all relevant entries of ``A_{jikl}`` simultaneously
-  to prevent recomputation.
-
-  \param
-    :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
-    :points_sampled[dim][num_sampled]: list of points
-    :dim: spatial dimension of a point
-    :num_sampled: number of points
-  \output
-    :hessian_cov_matrix[num_sampled][num_sampled][n_hyper][n_hyper]: hessian of covariance matrix wrt hyperparameters
-\endrst*/
-OL_NONNULL_POINTERS void BuildHyperparameterHessianCovarianceMatrix(const CovarianceInterface& covariance,
-                                                                    double const * restrict points_sampled,
-                                                                    int dim, int num_sampled,
-                                                                    double * restrict hessian_cov_matrix) noexcept {
-  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
-  const int offset = num_sampled*num_sampled;
-
-  const int num_hessian_elem = Square(num_hyperparameters);
-  std::vector<double> hessian_hyperparameters(num_hessian_elem);
-
-  // pointer to row that we're copying from
-  double const * restrict hessian_cov_matrix_row = hessian_cov_matrix;
-  // operator is symmetric, so we compute just the lower triangle & copy into the upper triangle
-  for (int i = 0; i < num_sampled; ++i) {
-    for (int j = 0; j < i; ++j) {
-      for (int i_hyper = 0; i_hyper < num_hessian_elem; ++i_hyper) {
-        hessian_cov_matrix[i_hyper*offset + j] = hessian_cov_matrix_row[i_hyper*offset];
-      }
-      hessian_cov_matrix_row += num_sampled;
-    }
-    hessian_cov_matrix_row -= i*num_sampled;
-    for (int j = i; j < num_sampled; ++j) {
-      // compute all hyperparameter derivs at once for efficiency
-      covariance.HyperparameterHessianCovariance(points_sampled + i*dim, points_sampled+j*dim,
-                                                 hessian_hyperparameters.data());
-      for (int i_hyper = 0; i_hyper < num_hessian_elem; ++i_hyper) {
-        // have to write each deriv to the correct block, due to the block structure of the output
-        hessian_cov_matrix[i_hyper*offset + j] = hessian_hyperparameters[i_hyper];
-      }
-    }
-    hessian_cov_matrix += num_sampled;
-    hessian_cov_matrix_row += 1;
-  }
-}
-
 }  // end unnamed namespace
 
 LogMarginalLikelihoodEvaluator::LogMarginalLikelihoodEvaluator(double const * restrict points_sampled_in,
                                                                double const * restrict points_sampled_value_in,
                                                                double const * restrict noise_variance_in,
                                                                int dim_in, int num_sampled_in)
+    : LogMarginalLikelihoodEvaluator(points_sampled_in, points_sampled_value_in, noise_variance_in, dim_in,
+                                     num_sampled_in, LogMarginalLikelihoodGradientTypes::kFullTensor) {
+}
+
+LogMarginalLikelihoodEvaluator::LogMarginalLikelihoodEvaluator(double const * restrict points_sampled_in,
+                                                               double const * restrict points_sampled_value_in,
+                                                               double const * restrict noise_variance_in,
+                                                               int dim_in, int num_sampled_in,
+                                                               LogMarginalLikelihoodGradientTypes gradient_type_in)
     : dim_(dim_in),
       num_sampled_(num_sampled_in),
+      gradient_type_(gradient_type_in),
       points_sampled_(points_sampled_in, points_sampled_in + num_sampled_in*dim_in),
       points_sampled_value_(points_sampled_value_in, points_sampled_value_in + num_sampled_in),
       noise_variance_(noise_variance_in, noise_variance_in + num_sampled_) {
@@ -479,19 +443,11 @@ void LogMarginalLikelihoodEvaluator::BuildHyperparameterGradCovarianceMatrix(
                                                             log_likelihood_state->grad_hyperparameter_cov_matrix.data());
 }
 
-void LogMarginalLikelihoodEvaluator::BuildHyperparameterHessianCovarianceMatrix(
-    LogMarginalLikelihoodState * log_likelihood_state,
-    double * hessian_hyperparameter_cov_matrix) const noexcept {
-  optimal_learning::BuildHyperparameterHessianCovarianceMatrix(*log_likelihood_state->covariance_ptr,
-                                                               points_sampled_.data(), dim_, num_sampled_,
-                                                               hessian_hyperparameter_cov_matrix);
-}
-
 void LogMarginalLikelihoodEvaluator::FillLogLikelihoodState(LogMarginalLikelihoodState * log_likelihood_state) const {
   // K_chol
   optimal_learning::BuildCovarianceMatrixWithNoiseVariance(*log_likelihood_state->covariance_ptr,
                                                            noise_variance_.data(), points_sampled_.data(),
-                                                           dim_, num_sampled_, log_likelihood_state->K_chol.data());
+                                                           num_sampled_, log_likelihood_state->K_chol.data());
 
   // TODO(GH-211): Re-examine ignoring singular covariance matrices here
   int OL_UNUSED(chol_info) = ComputeCholeskyFactorL(num_sampled_,
@@ -560,10 +516,19 @@ double LogMarginalLikelihoodEvaluator::ComputeLogLikelihood(
     = \frac{1}{2} * trace([\alpha_i \alpha_j - K^{-1}_{ij}]*\pderiv{K_{ij}}{\theta_k}),
 
   where ``\alpha_i = K^{-1}_{ij} * y_j``
+
+  With LogMarginalLikelihoodGradientTypes::kFullTensor, we form every ``\pderiv{K}{\theta_k}`` and compute the first form
+  (backsolving against each ``\pderiv{K}{\theta_k}``).  This needs ``num_hyperparameters * N^2`` doubles of temporary storage.
+  With kStreaming, we compute the second form; see ComputeGradLogLikelihoodStreaming().
 \endrst*/
 #define OL_USE_INVERSE 0
 void LogMarginalLikelihoodEvaluator::ComputeGradLogLikelihood(LogMarginalLikelihoodState * log_likelihood_state,
                                                               double * restrict grad_log_marginal) const noexcept {
+  if (gradient_type_ == LogMarginalLikelihoodGradientTypes::kStreaming) {
+    ComputeGradLogLikelihoodStreaming(log_likelihood_state, grad_log_marginal);
+    return;
+  }
+
 #if OL_USE_INVERSE == 1
   std::vector<double> K_inv(num_sampled_*num_sampled_);
   SPDMatrixInverse(log_likelihood_state->K_chol.data(), num_sampled_, K_inv.data());
@@ -611,12 +576,66 @@ void LogMarginalLikelihoodEvaluator::ComputeGradLogLikelihood(LogMarginalLikelih
   }
 }
 
+/*!\rst
+  Computes the gradient of the log marginal likelihood as::
+
+    \pderiv{log(p(y | X, \theta))}{\theta_k} = \frac{1}{2} * \sum_{ij} [\alpha_i \alpha_j - K^{-1}_{ij}] * \pderiv{K_{ij}}{\theta_k}
+
+  ``\pderiv{K}{\theta_k}`` (for all ``k`` at once) is generated in ``kLogMarginalGradientTileSize^2`` tiles covering the lower
+  triangle of ``K``.  Each tile is contracted against ``\alpha\alpha^T - K^-1`` (off-diagonal entries count twice by symmetry)
+  and then overwritten by the next tile.  So the only ``O(N^2)`` storage is ``K^-1`` itself, versus
+  ``num_hyperparameters * N^2`` for the full tensor; and the tiles stay in cache.
+
+  This forms ``K^-1`` explicitly (``O(N^3)``, once) instead of backsolving against each ``\pderiv{K}{\theta_k}``
+  (``O(N^3)`` per hyperparameter), so it is also faster; the price is the usual (mild) loss of accuracy of explicit inverses.
+\endrst*/
+void LogMarginalLikelihoodEvaluator::ComputeGradLogLikelihoodStreaming(LogMarginalLikelihoodState * log_likelihood_state,
+                                                                       double * restrict grad_log_marginal) const noexcept {
+  const int num_hyperparameters = log_likelihood_state->num_hyperparameters;
+  SPDMatrixInverse(log_likelihood_state->K_chol.data(), num_sampled_, log_likelihood_state->K_inv.data());
+
+  double const * restrict K_inv = log_likelihood_state->K_inv.data();
+  double const * restrict K_inv_y = log_likelihood_state->K_inv_y.data();
+  double * restrict grad_hyperparameter_cov_tile = log_likelihood_state->grad_hyperparameter_cov_tile.data();
+  std::fill(grad_log_marginal, grad_log_marginal + num_hyperparameters, 0.0);
+  for (int col_start = 0; col_start < num_sampled_; col_start += kLogMarginalGradientTileSize) {
+    const int num_cols = std::min(kLogMarginalGradientTileSize, num_sampled_ - col_start);
+    // only tiles intersecting the lower triangle are needed
+    for (int row_start = col_start; row_start < num_sampled_; row_start += kLogMarginalGradientTileSize) {
+      const int num_rows = std::min(kLogMarginalGradientTileSize, num_sampled_ - row_start);
+      const int tile_size = num_rows*num_cols;
+      log_likelihood_state->covariance_ptr->HyperparameterGradCovarianceMatrix(points_sampled_.data() + row_start*dim_,
+                                                                               num_rows,
+                                                                               points_sampled_.data() + col_start*dim_,
+                                                                               num_cols, grad_hyperparameter_cov_tile);
+
+      for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+        double const * restrict grad_cov_tile_column = grad_hyperparameter_cov_tile + i_hyper*tile_size;
+        double grad_log_marginal_tile = 0.0;
+        for (int i = col_start; i < col_start + num_cols; ++i) {
+          // in diagonal tiles, skip the strict upper triangle (j < i); the diagonal counts once, the rest twice
+          if (i >= row_start) {
+            grad_log_marginal_tile += 0.5*(Square(K_inv_y[i]) - K_inv[i*num_sampled_ + i]) *
+                grad_cov_tile_column[i - row_start];
+          }
+          for (int j = std::max(i + 1, row_start); j < row_start + num_rows; ++j) {
+            grad_log_marginal_tile += (K_inv_y[j]*K_inv_y[i] - K_inv[i*num_sampled_ + j]) *
+                grad_cov_tile_column[j - row_start];
+          }
+          grad_cov_tile_column += num_rows;
+        }
+        grad_log_marginal[i_hyper] += grad_log_marginal_tile;
+      }
+    }
+  }
+}
+
 /*!\rst
   Computes the Hessian matrix of the log (marginal) likelihood wrt the hyperparameters::
 
     \mixpderiv{log(p(y | X, \theta_k))}{\theta_i}{\theta_j} =
         (-\alpha * \pderiv{K}{\theta_i} * K^-1 * \pderiv{K}{\theta_j} * \alpha)
-      + (\alpha * \mixpderiv{K}{\theta_i}{\theta_j} * \alpha)
+      + 0.5 * (\alpha * \mixpderiv{K}{\theta_i}{\theta_j} * \alpha)
       - 0.5 * tr(-K^-1 * \pderiv{K}{\theta_i} * K^-1 * \pderiv{K}{\theta_j} + K^-1 * \mixpderiv{K}{\theta_i}{\theta_j})
 
   Note that as usual, ``K`` is the covariance matrix (bearing its own two indices, say ``K_{k,l}``) which are omitted here.
@@ -628,103 +647,135 @@ void LogMarginalLikelihoodEvaluator::ComputeGradLogLikelihood(LogMarginalLikelih
   as well as the fact that ``\partial tr(A) = tr(\partial A)``.  That is, since trace is linear, the order can be interchanged
   with the differential operator;
   and the various symmetries of the gradient/hessians of K (see function declaration comments for details on symmetry).
+
+  As in ComputeGradLogLikelihoodStreaming(), the traces are contracted entry by entry so that neither the
+  ``\pderiv{K}{\theta_i}`` (``num_hyperparameters * N^2``) nor the ``\mixpderiv{K}{\theta_i}{\theta_j}``
+  (``num_hyperparameters^2 * N^2``) tensor is ever formed::
+
+    \beta_i = \pderiv{K}{\theta_i} * \alpha
+    H_{ij} = -\beta_i^T * K^-1 * \beta_j
+             + \frac{1}{2} * \sum_{kl} [\alpha_k \alpha_l - K^{-1}_{kl}] * \mixpderiv{K_{kl}}{\theta_i}{\theta_j}
+             + \frac{1}{2} * \sum_{kl} [K^-1 * \pderiv{K}{\theta_i} * K^-1]_{kl} * \pderiv{K_{kl}}{\theta_j}
+
+  The first two terms need one pass over (the lower triangle of) the pairs of points.  The last is computed one ``i`` at
+  a time: ``K^-1 * \pderiv{K}{\theta_i} * K^-1`` is built (with backsolves) in the state's ``temp_matrix`` and then
+  contracted against kLogMarginalGradientTileSize^2 tiles of every ``\pderiv{K}{\theta_j}``.  So the only ``O(N^2)``
+  storage is ``K^-1`` and ``temp_matrix``, both of which are kept in the state across calls.
 \endrst*/
 void LogMarginalLikelihoodEvaluator::ComputeHessianLogLikelihood(LogMarginalLikelihoodState * log_likelihood_state,
                                                                  double * restrict hessian_log_marginal) const noexcept {
-#if OL_USE_INVERSE == 1
-  std::vector<double> K_inv(num_sampled_*num_sampled_);
-  SPDMatrixInverse(log_likelihood_state->K_chol.data(), num_sampled_, K_inv.data());
-#endif
-
   const int num_hyperparameters = log_likelihood_state->num_hyperparameters;
-  std::vector<double> hessian_hyperparameter_cov_matrix(num_sampled_*num_sampled_*Square(num_hyperparameters));
-  BuildHyperparameterGradCovarianceMatrix(log_likelihood_state);
-  BuildHyperparameterHessianCovarianceMatrix(log_likelihood_state, hessian_hyperparameter_cov_matrix.data());
+  const int num_hessian_elem = Square(num_hyperparameters);
+  SPDMatrixInverse(log_likelihood_state->K_chol.data(), num_sampled_, log_likelihood_state->K_inv.data());
 
-  std::vector<double> grad_K_K_inv_y(num_sampled_*num_hyperparameters);
-  double * restrict grad_hyperparameter_cov_matrix_ptr = log_likelihood_state->grad_hyperparameter_cov_matrix.data();
-  // precompute some quantities relating to grad_hyperparameter_cov_matrix that we will need repeatedly
-  for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
-    // grad_K_K_inv_y stores |\theta_k| blocks, each block containing \pderiv{K}{\theta_k} * (K^-1 * y)
-    // where K^-1*y has been precomputed in K_inv_y
-    GeneralMatrixVectorMultiply(grad_hyperparameter_cov_matrix_ptr, 'N', log_likelihood_state->K_inv_y.data(),
-                                1.0, 0.0, num_sampled_, num_sampled_, num_sampled_,
-                                grad_K_K_inv_y.data() + i_hyper*num_sampled_);
+  const CovarianceInterface& covariance = *log_likelihood_state->covariance_ptr;
+  double const * restrict K_chol = log_likelihood_state->K_chol.data();
+  double const * restrict K_inv = log_likelihood_state->K_inv.data();
+  double const * restrict K_inv_y = log_likelihood_state->K_inv_y.data();
+  double * restrict temp_matrix = log_likelihood_state->temp_matrix.data();
+  double * restrict grad_hyperparameter_cov_tile = log_likelihood_state->grad_hyperparameter_cov_tile.data();
+  std::fill(hessian_log_marginal, hessian_log_marginal + num_hessian_elem, 0.0);
+
+  // grad_K_K_inv_y stores |\theta_k| blocks, each block containing \beta_k = \pderiv{K}{\theta_k} * (K^-1 * y)
+  std::vector<double> grad_K_K_inv_y(num_sampled_*num_hyperparameters, 0.0);
+  std::vector<double> grad_hyperparameters(num_hyperparameters);
+  std::vector<double> hessian_hyperparameters(num_hessian_elem);
+  const int outputs = CovarianceInterface::kHyperparameterGradient | CovarianceInterface::kHyperparameterHessian;
+  for (int i = 0; i < num_sampled_; ++i) {
+    for (int j = i; j < num_sampled_; ++j) {
+      covariance.CovarianceWithDerivatives(points_sampled_.data() + i*dim_, points_sampled_.data() + j*dim_, outputs,
+                                           nullptr, grad_hyperparameters.data(), hessian_hyperparameters.data());
+      for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+        grad_K_K_inv_y[i_hyper*num_sampled_ + i] += grad_hyperparameters[i_hyper]*K_inv_y[j];
+      }
+      // the diagonal counts once, the rest twice (as (i, j) and (j, i))
+      double weight = 0.5*(Square(K_inv_y[i]) - K_inv[i*num_sampled_ + i]);
+      if (j != i) {
+        for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+          grad_K_K_inv_y[i_hyper*num_sampled_ + j] += grad_hyperparameters[i_hyper]*K_inv_y[i];
+        }
+        weight = K_inv_y[j]*K_inv_y[i] - K_inv[i*num_sampled_ + j];
+      }
+      // 0.5 * (\alpha * \mixpderiv{K}{\theta_i}{\theta_j} * \alpha) - 0.5 * tr(K^-1 * \mixpderiv{K}{\theta_i}{\theta_j})
+      VectorAXPY(num_hessian_elem, weight, hessian_hyperparameters.data(), hessian_log_marginal);
+    }
+  }
 
-    // previous line is the only other use of grad_hyperparameter_cov_matrix, so we can safely overwite each block with
-    // K^-1 * grad_hyperparameter_cov_matrix
-    // as usual, do not form K^-1 explicitly
-    CholeskyFactorLMatrixMatrixSolve(log_likelihood_state->K_chol.data(), num_sampled_, num_sampled_,
-                                     grad_hyperparameter_cov_matrix_ptr);
-    grad_hyperparameter_cov_matrix_ptr += Square(num_sampled_);
+  // (-\alpha * \pderiv{K}{\theta_i} * K^-1 * \pderiv{K}{\theta_j} * \alpha) = -\beta_i * K^-1 * \beta_j
+  // as usual, do not use K^-1 explicitly where a backsolve will do
+  for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+    std::copy(grad_K_K_inv_y.data() + i_hyper*num_sampled_, grad_K_K_inv_y.data() + (i_hyper+1)*num_sampled_,
+              log_likelihood_state->temp_vec.data());
+    CholeskyFactorLMatrixVectorSolve(K_chol, num_sampled_, log_likelihood_state->temp_vec.data());
+    for (int j_hyper = i_hyper; j_hyper < num_hyperparameters; ++j_hyper) {
+      const double term = DotProduct(grad_K_K_inv_y.data() + j_hyper*num_sampled_,
+                                     log_likelihood_state->temp_vec.data(), num_sampled_);
+      hessian_log_marginal[i_hyper*num_hyperparameters + j_hyper] -= term;
+      if (j_hyper != i_hyper) {
+        hessian_log_marginal[j_hyper*num_hyperparameters + i_hyper] -= term;
+      }
+    }
   }
 
-  double * restrict hessian_hyperparameter_cov_matrix_ptr = hessian_hyperparameter_cov_matrix.data();
-  double * restrict hessian_log_marginal_ptr = hessian_log_marginal;
-  double const * restrict hessian_log_marginal_row = hessian_log_marginal;
-  // now compute the hessian of the log marginal: \mixpderiv{log(p(y | X, \theta_k))}{\theta_i}{\theta_j}
-  // the matrix is symmetric so we compute the lower triangle and copy into the upper triangle
-  // see BuildHyperparameter.*Matrix() functions for simpler examples of this
+  // 0.5*tr(K^-1 * \pderiv{K}{\theta_i} * K^-1 * \pderiv{K}{\theta_j}), one i_hyper at a time
   for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
-    for (int j_hyper = 0; j_hyper < i_hyper; ++j_hyper) {
-      hessian_log_marginal_ptr[j_hyper] = hessian_log_marginal_row[0];
-      hessian_log_marginal_row += num_hyperparameters;
+    // temp_matrix := \pderiv{K}{\theta_i}, from the tiles covering its lower triangle
+    for (int col_start = 0; col_start < num_sampled_; col_start += kLogMarginalGradientTileSize) {
+      const int num_cols = std::min(kLogMarginalGradientTileSize, num_sampled_ - col_start);
+      for (int row_start = col_start; row_start < num_sampled_; row_start += kLogMarginalGradientTileSize) {
+        const int num_rows = std::min(kLogMarginalGradientTileSize, num_sampled_ - row_start);
+        covariance.HyperparameterGradCovarianceMatrix(points_sampled_.data() + row_start*dim_, num_rows,
+                                                      points_sampled_.data() + col_start*dim_, num_cols,
+                                                      grad_hyperparameter_cov_tile);
+        double const * restrict grad_cov_tile_column = grad_hyperparameter_cov_tile + i_hyper*num_rows*num_cols;
+        for (int i = col_start; i < col_start + num_cols; ++i) {
+          for (int j = row_start; j < row_start + num_rows; ++j) {
+            temp_matrix[i*num_sampled_ + j] = grad_cov_tile_column[j - row_start];
+            temp_matrix[j*num_sampled_ + i] = grad_cov_tile_column[j - row_start];
+          }
+          grad_cov_tile_column += num_rows;
+        }
+      }
     }
-    hessian_log_marginal_row -= i_hyper*num_hyperparameters;
-    hessian_hyperparameter_cov_matrix_ptr += i_hyper*Square(num_sampled_);
 
-    for (int j_hyper = i_hyper; j_hyper < num_hyperparameters; ++j_hyper) {
-      // (-\alpha * \pderiv{K}{\theta_i} * K^-1 * \pderiv{K}{\theta_j} * \alpha)
-      // view this as -\beta_i * K^-1 * \beta_j, where \beta_i = \pderiv{K}{\theta_j} * \alpha
-      //  is precomputed in grad_K_K_inv_y
-      // Note: since K^-1 is symmetric (SPD in fact), we equivalently compute -\beta_j * K^-1 * \beta_i
-
-      // TODO(GH-185): the first step computes K^-1 * \beta_i, which is constant over j_hyper and should be lifted out
-      // of this loop. OR this whole block computing -\beta_j * K^-1 * \beta_i should be split into a separate loop over j_hyper.
-      std::copy(grad_K_K_inv_y.data() + i_hyper*num_sampled_, grad_K_K_inv_y.data() + (i_hyper+1)*num_sampled_,
-                log_likelihood_state->temp_vec.data());
-      CholeskyFactorLMatrixVectorSolve(log_likelihood_state->K_chol.data(), num_sampled_,
-                                       log_likelihood_state->temp_vec.data());
-      hessian_log_marginal_ptr[j_hyper] = -DotProduct(grad_K_K_inv_y.data() + j_hyper*num_sampled_,
-                                                      log_likelihood_state->temp_vec.data(), num_sampled_);
-
-      // (\alpha * \mixpderiv{K}{\theta_i}{\theta_j} * \alpha)
-      // mixed deriv term has already been computed, so we first multiply by \alpha
-      GeneralMatrixVectorMultiply(hessian_hyperparameter_cov_matrix_ptr, 'N', log_likelihood_state->K_inv_y.data(),
-                                  1.0, 0.0, num_sampled_, num_sampled_, num_sampled_,
-                                  log_likelihood_state->temp_vec.data());
-      // and then dot the result with \alpha
-      hessian_log_marginal_ptr[j_hyper] += 0.5*DotProduct(log_likelihood_state->K_inv_y.data(),
-                                                          log_likelihood_state->temp_vec.data(), num_sampled_);
-
-      // 0.5*tr(K^-1 * \pderiv{K}{\theta_i} * K^-1 * \pderiv{K}{\theta_j})
-      // note that since tr(A) = tr(A^T), the order of multiplication is irrelevant
-      // we do not need to form the full matrix product first, since only the diagonal of that result is required
-      // finally, recall that grad_hyperparameter_cov_matrix has already been premultiplied by K^-1
-      hessian_log_marginal_ptr[j_hyper] += 0.5*TraceOfGeneralMatrixMatrixMultiply(
-          log_likelihood_state->grad_hyperparameter_cov_matrix.data() + i_hyper*Square(num_sampled_),
-          log_likelihood_state->grad_hyperparameter_cov_matrix.data() + j_hyper*Square(num_sampled_),
-          num_sampled_);
-
-      // - 0.5 * tr(K^-1 * \mixpderiv{K}{\theta_i}{\theta_j})
-#if OL_USE_INVERSE == 1
-      // avoid performing the matrix product (as in previous trace step); only calculate terms needed for trace
-      hessian_log_marginal_ptr[j_hyper] -= 0.5*TraceOfGeneralMatrixMatrixMultiply(
-          K_inv.data(),
-          hessian_hyperparameter_cov_matrix_ptr,
-          num_sampled_);
-#else
-      // overwrites i,j-th block of hessian_hyperparameter_cov_matrix, which we do not need anymore
-      // for maximum numerical stability, we form K^-1*\mixpderiv{K}{\theta_i}{\theta_j} explicitly using backsolves first
-      // then take the trace of the resulting matrix
-      CholeskyFactorLMatrixMatrixSolve(log_likelihood_state->K_chol.data(), num_sampled_, num_sampled_,
-                                       hessian_hyperparameter_cov_matrix_ptr);
-      hessian_log_marginal_ptr[j_hyper] -= 0.5*MatrixTrace(hessian_hyperparameter_cov_matrix_ptr, num_sampled_);
-#endif
-      hessian_hyperparameter_cov_matrix_ptr += Square(num_sampled_);
+    // temp_matrix := K^-1 * \pderiv{K}{\theta_i} * K^-1 = K^-1 * (K^-1 * \pderiv{K}{\theta_i})^T (K, dK are symmetric)
+    CholeskyFactorLMatrixMatrixSolve(K_chol, num_sampled_, num_sampled_, temp_matrix);
+    for (int i = 0; i < num_sampled_; ++i) {
+      for (int j = i + 1; j < num_sampled_; ++j) {
+        std::swap(temp_matrix[i*num_sampled_ + j], temp_matrix[j*num_sampled_ + i]);
+      }
+    }
+    CholeskyFactorLMatrixMatrixSolve(K_chol, num_sampled_, num_sampled_, temp_matrix);
+
+    // contract temp_matrix against each \pderiv{K}{\theta_j}, j_hyper >= i_hyper, tile by tile
+    for (int col_start = 0; col_start < num_sampled_; col_start += kLogMarginalGradientTileSize) {
+      const int num_cols = std::min(kLogMarginalGradientTileSize, num_sampled_ - col_start);
+      for (int row_start = col_start; row_start < num_sampled_; row_start += kLogMarginalGradientTileSize) {
+        const int num_rows = std::min(kLogMarginalGradientTileSize, num_sampled_ - row_start);
+        const int tile_size = num_rows*num_cols;
+        covariance.HyperparameterGradCovarianceMatrix(points_sampled_.data() + row_start*dim_, num_rows,
+                                                      points_sampled_.data() + col_start*dim_, num_cols,
+                                                      grad_hyperparameter_cov_tile);
+        for (int j_hyper = i_hyper; j_hyper < num_hyperparameters; ++j_hyper) {
+          double const * restrict grad_cov_tile_column = grad_hyperparameter_cov_tile + j_hyper*tile_size;
+          double hessian_tile = 0.0;
+          for (int i = col_start; i < col_start + num_cols; ++i) {
+            // in diagonal tiles, skip the strict upper triangle (j < i); the diagonal counts once, the rest twice
+            if (i >= row_start) {
+              hessian_tile += 0.5*temp_matrix[i*num_sampled_ + i]*grad_cov_tile_column[i - row_start];
+            }
+            for (int j = std::max(i + 1, row_start); j < row_start + num_rows; ++j) {
+              hessian_tile += temp_matrix[i*num_sampled_ + j]*grad_cov_tile_column[j - row_start];
+            }
+            grad_cov_tile_column += num_rows;
+          }
+          hessian_log_marginal[i_hyper*num_hyperparameters + j_hyper] += hessian_tile;
+          if (j_hyper != i_hyper) {
+            hessian_log_marginal[j_hyper*num_hyperparameters + i_hyper] += hessian_tile;
+          }
+        }
+      }
     }
-    hessian_log_marginal_ptr += num_hyperparameters;
-    hessian_log_marginal_row += 1;
   }
 }
 
@@ -743,9 +794,15 @@ void LogMarginalLikelihoodState::SetupState(const EvaluatorType& log_likelihood_
     num_sampled = log_likelihood_eval.num_sampled();
     K_chol.resize(num_sampled*num_sampled);
     K_inv_y.resize(num_sampled);
-    grad_hyperparameter_cov_matrix.resize(num_hyperparameters*num_sampled*num_sampled);
     temp_vec.resize(num_sampled);
   }
+  // K_inv, temp_matrix, and the tile are also used by ComputeHessianLogLikelihood(), regardless of gradient type
+  K_inv.resize(num_sampled*num_sampled);
+  temp_matrix.resize(num_sampled*num_sampled);
+  grad_hyperparameter_cov_tile.resize(num_hyperparameters*Square(kLogMarginalGradientTileSize));
+  if (log_likelihood_eval.gradient_type() == LogMarginalLikelihoodGradientTypes::kFullTensor) {
+    grad_hyperparameter_cov_matrix.resize(num_hyperparameters*num_sampled*num_sampled);
+  }
 
   // set hyperparameters and derived quantities
   SetHyperparameters(log_likelihood_eval, hyperparameters);
@@ -759,7 +816,6 @@ LogMarginalLikelihoodState::LogMarginalLikelihoodState(const EvaluatorType& log_
       covariance_ptr(covariance_in.Clone()),
       K_chol(num_sampled*num_sampled),
       K_inv_y(num_sampled),
-      grad_hyperparameter_cov_matrix(num_hyperparameters*num_sampled*num_sampled),
       temp_vec(num_sampled) {
   std::vector<double> hyperparameters(num_hyperparameters);
   covariance_ptr->GetHyperparameters(hyperparameters.data());
@@ -811,9 +867,8 @@ OL_NONNULL_POINTERS void LeaveOneOutCoreAccurate(const CovarianceInterface& cova
   std::copy(noise_variance, noise_variance + index, noise_variance_loo.begin());
   std::copy(noise_variance + (index+1), noise_variance + num_sampled, noise_variance_loo.begin() + index);
 
-  // TODO(GH-191): Update the GP by removing one point. Each GP build is O(N_{sampled}^3) and we do it
-  // N_{sampled} times. This would instead be N applications of an O(N^2) transformation to the covariance matrix,
-  // available through LeaveOneOutLogLikelihoodState.
+  // Each GP build is O(N_{sampled}^3) and we do it N_{sampled} times; LeaveOneOutCoreWithCholeskyDowndate()
+  // gets the same quantities in O(N_{sampled}^2) from the cholesky factor in LeaveOneOutLogLikelihoodState.
   GaussianProcess gaussian_process(covariance, points_sampled_loo.data(), points_sampled_value_loo.data(),
                                    noise_variance_loo.data(), dim, num_sampled - 1);
   int num_derivatives = 0;
@@ -858,14 +913,79 @@ OL_NONNULL_POINTERS void LeaveOneOutCoreWithMatrixInverse(double const * restric
   *variance = 1.0/K_inv[index];
 }
 
+/*!\rst
+  Computes ``\sigma^2_i`` and the residual ``y_i - \mu_i`` (as in LeaveOneOutCoreWithMatrixInverse()) by removing the
+  ``i``-th row and column from the cholesky factor of ``K``.
+
+  Partition ``K = L * L^T`` around index ``i``::
+
+    L = [ L_11    0      0   ]
+        [ l_21^T  l_22   0   ]
+        [ L_31    l_32  L_33 ]
+
+  Deleting row/column ``i`` of ``K`` leaves ``L_11`` and ``L_31`` unchanged; only the trailing block changes, to the factor
+  of the rank-one update ``L_33 * L_33^T + l_32 * l_32^T``.  A cholesky update (e.g., Givens rotations) would form this factor
+  explicitly, but we only need its action on two vectors, so we apply Sherman-Morrison to ``I + u * u^T`` instead, where
+  ``u = L_33^-1 * l_32``.  With ``z = L^-1 * y``, this gives:
+
+  * ``\sigma^2_i = l_22^2 / (1 + u^T u)``
+  * ``y_i - \mu_i = l_22 * (z_i - u^T * z_3) / (1 + u^T u)``
+
+  which are identical to ``1/(K^-1)_ii`` and ``(K^-1 y)_i / (K^-1)_ii``.  The only work is one triangular solve with the
+  ``(N - i - 1)``-sized trailing block of ``L``, so this is ``O(N^2)`` and (unlike the explicit inverse) backward stable.
+
+  \param
+    :K_chol[num_sampled][num_sampled]: cholesky factor of the covariance matrix over all training points ``X``
+    :L_inv_y[num_sampled]: ``L^-1 * y``
+    :num_sampled: number of already-sampled points
+    :index: ``i``, the index of the point to leave out
+    :temp_vec[num_sampled]: temporary storage
+  \output
+    :temp_vec[num_sampled]: overwritten
+    :residual[1]: ``y_i - \mu_i``, the difference between ``y_i`` and the GP mean evaluated at ``X_i``
+    :variance[1]: the GP variance evaluated at ``X_i`` (including the noise of the ``i``-th measurement)
+\endrst*/
+OL_NONNULL_POINTERS void LeaveOneOutCoreWithCholeskyDowndate(double const * restrict K_chol,
+                                                             double const * restrict L_inv_y,
+                                                             int num_sampled, int index,
+                                                             double * restrict temp_vec,
+                                                             double * restrict residual,
+                                                             double * restrict variance) noexcept {
+  const int num_trailing = num_sampled - index - 1;
+  const double l_22 = K_chol[index*num_sampled + index];
+  double u_norm_squared = 0.0;
+  double u_dot_z = 0.0;
+  if (num_trailing > 0) {
+    // u := L_33^-1 * l_32
+    std::copy(K_chol + index*num_sampled + index + 1, K_chol + (index + 1)*num_sampled, temp_vec);
+    TriangularMatrixVectorSolve(K_chol + (index + 1)*num_sampled + index + 1, 'N', num_trailing, num_sampled,
+                                temp_vec);
+    u_norm_squared = DotProduct(temp_vec, temp_vec, num_trailing);
+    u_dot_z = DotProduct(temp_vec, L_inv_y + index + 1, num_trailing);
+  }
+
+  *variance = Square(l_22)/(1.0 + u_norm_squared);
+  *residual = l_22*(L_inv_y[index] - u_dot_z)/(1.0 + u_norm_squared);
+}
+
 }  // end unnamed namespace
 
 LeaveOneOutLogLikelihoodEvaluator::LeaveOneOutLogLikelihoodEvaluator(double const * restrict points_sampled_in,
                                                                      double const * restrict points_sampled_value_in,
                                                                      double const * restrict noise_variance_in,
                                                                      int dim_in, int num_sampled_in)
+    : LeaveOneOutLogLikelihoodEvaluator(points_sampled_in, points_sampled_value_in, noise_variance_in, dim_in,
+                                        num_sampled_in, LeaveOneOutComputeTypes::kMatrixInverse) {
+}
+
+LeaveOneOutLogLikelihoodEvaluator::LeaveOneOutLogLikelihoodEvaluator(double const * restrict points_sampled_in,
+                                                                     double const * restrict points_sampled_value_in,
+                                                                     double const * restrict noise_variance_in,
+                                                                     int dim_in, int num_sampled_in,
+                                                                     LeaveOneOutComputeTypes compute_type_in)
     : dim_(dim_in),
       num_sampled_(num_sampled_in),
+      compute_type_(compute_type_in),
       points_sampled_(points_sampled_in, points_sampled_in + num_sampled_in*dim_in),
       points_sampled_value_(points_sampled_value_in, points_sampled_value_in + num_sampled_in),
       noise_variance_(noise_variance_in, noise_variance_in + num_sampled_) {
@@ -878,23 +998,51 @@ void LeaveOneOutLogLikelihoodEvaluator::BuildHyperparameterGradCovarianceMatrix(
                                                             log_likelihood_state->grad_hyperparameter_cov_matrix.data());
 }
 
+/*!\rst
+  Forms ``K_chol`` and ``K^-1 * y``, then the LOO predictive variances ``\sigma_i^2`` and residuals ``y_i - \mu_i``
+  using LeaveOneOutCoreWithMatrixInverse() or LeaveOneOutCoreWithCholeskyDowndate(), as specified by ``compute_type_``.
+  ``K^-1`` is only formed in the former case.
+\endrst*/
 void LeaveOneOutLogLikelihoodEvaluator::FillLogLikelihoodState(
     LeaveOneOutLogLikelihoodState * log_likelihood_state) const {
   // K_chol
   optimal_learning::BuildCovarianceMatrixWithNoiseVariance(*log_likelihood_state->covariance_ptr,
                                                            noise_variance_.data(), points_sampled_.data(),
-                                                           dim_, num_sampled_, log_likelihood_state->K_chol.data());
+                                                           num_sampled_, log_likelihood_state->K_chol.data());
   // TODO(GH-211): Re-examine ignoring singular covariance matrices here
   int OL_UNUSED(chol_info) = ComputeCholeskyFactorL(num_sampled_, log_likelihood_state->K_chol.data());
 
-  // K_inv
-  SPDMatrixInverse(log_likelihood_state->K_chol.data(), num_sampled_, log_likelihood_state->K_inv.data());
-
-  // K_inv_y
+  // L_inv_y, K_inv_y
   std::copy(points_sampled_value_.begin(), points_sampled_value_.end(),
+            log_likelihood_state->L_inv_y.begin());
+  TriangularMatrixVectorSolve(log_likelihood_state->K_chol.data(), 'N', num_sampled_, num_sampled_,
+                              log_likelihood_state->L_inv_y.data());
+  std::copy(log_likelihood_state->L_inv_y.begin(), log_likelihood_state->L_inv_y.end(),
             log_likelihood_state->K_inv_y.begin());
-  CholeskyFactorLMatrixVectorSolve(log_likelihood_state->K_chol.data(), num_sampled_,
-                                   log_likelihood_state->K_inv_y.data());
+  TriangularMatrixVectorSolve(log_likelihood_state->K_chol.data(), 'T', num_sampled_, num_sampled_,
+                              log_likelihood_state->K_inv_y.data());
+
+  if (compute_type_ == LeaveOneOutComputeTypes::kCholeskyDowndate) {
+    for (int i = 0; i < num_sampled_; ++i) {
+      LeaveOneOutCoreWithCholeskyDowndate(log_likelihood_state->K_chol.data(),
+                                          log_likelihood_state->L_inv_y.data(), num_sampled_, i,
+                                          log_likelihood_state->temp_vec.data(),
+                                          log_likelihood_state->loo_residual.data() + i,
+                                          log_likelihood_state->loo_variance.data() + i);
+    }
+  } else {
+    // K_inv
+    SPDMatrixInverse(log_likelihood_state->K_chol.data(), num_sampled_, log_likelihood_state->K_inv.data());
+
+    double mean;
+    for (int i = 0; i < num_sampled_; ++i) {
+      // compute \mu_i, \sigma_i^2 using explicit matrix inverse
+      LeaveOneOutCoreWithMatrixInverse(log_likelihood_state->K_inv.data() + i*num_sampled_,
+                                       log_likelihood_state->K_inv_y.data(), points_sampled_value_.data(), i,
+                                       &mean, log_likelihood_state->loo_variance.data() + i);
+      log_likelihood_state->loo_residual[i] = points_sampled_value_[i] - mean;
+    }
+  }
 }
 
 /*!\rst
@@ -909,25 +1057,21 @@ void LeaveOneOutLogLikelihoodEvaluator::FillLogLikelihoodState(
   where ``X_{-i}`` and ``y_{-i}`` are the training data with the ``i``-th point removed.  Then ``X_i`` is taken as the point to sample.
   ``\sigma_i^2`` and ``\mu_i`` are the GP (predicted) variance/mean at the point to sample.
 
-  This function currently uses LeaveOneOutCoreWithMatrixInverse() to compute ``\sigma_i^2`` and ``\mu_i``, which is potentially
-  ill-conditioned.  This has not proven to be an issue in testing, but _accurate() is preferred when loss of prescision is
-  suspected.
+  ``\sigma_i^2`` and ``\mu_i`` are precomputed by FillLogLikelihoodState().  By default, this uses LeaveOneOutCoreWithMatrixInverse(),
+  which is potentially ill-conditioned.  This has not proven to be an issue in testing, but LeaveOneOutComputeTypes::kCholeskyDowndate
+  (LeaveOneOutCoreWithCholeskyDowndate()) is preferred when loss of precision is suspected.
 
   See Rasmussen & Williams 5.4.2 for more details.
 \endrst*/
 double LeaveOneOutLogLikelihoodEvaluator::ComputeLogLikelihood(
     const LeaveOneOutLogLikelihoodState& log_likelihood_state) const noexcept {
-  double mean_fast, variance_fast;
   double loo_fast = 0.0;
   // double mean_accurate, variance_accurate;
   // double loo_accurate = 0.0;
   for (int i = 0; i < num_sampled_; ++i) {
-    // compute \mu_i, \sigma_i^2 using explicit matrix inverse
-    LeaveOneOutCoreWithMatrixInverse(log_likelihood_state.K_inv.data() + i*num_sampled_,
-                                     log_likelihood_state.K_inv_y.data(), points_sampled_value_.data(), i,
-                                     &mean_fast, &variance_fast);
+    const double variance_fast = log_likelihood_state.loo_variance[i];
     double probability_fast = -0.5*std::log(variance_fast) -
-        0.5*Square(points_sampled_value_[i] - mean_fast)/variance_fast - 0.5*kLog2Pi;
+        0.5*Square(log_likelihood_state.loo_residual[i])/variance_fast - 0.5*kLog2Pi;
     loo_fast += probability_fast;
 
     // LeaveOneOutCoreAccurate(covariance_, noise_variance.data(), points_sampled.data(), points_sampled_value.data(), dim_, num_sampled_, i, &mean_accurate, &variance_accurate);
@@ -951,7 +1095,8 @@ double LeaveOneOutLogLikelihoodEvaluator::ComputeLogLikelihood(
     \pderiv{L_{LOO}}{\theta_j} = \sum_{i = 1}^n \frac{1}{(K^-1)_ii} *
                  \left(\alpha_i[Z_j\alpha]_i - 0.5(1 + \frac{\alpha_i^2}{(K^-1)_ii})[Z_j K^-1]_ii \right)
 
-  where ``\alpha = K^-1 * y``, and ``Z_j = K^-1 * \pderiv{K}{\theta_j}``.
+  where ``\alpha = K^-1 * y``, and ``Z_j = K^-1 * \pderiv{K}{\theta_j}``.  Only the diagonal of ``K^-1`` is needed; we take
+  ``1/(K^-1)_ii = \sigma_i^2`` from the state, so this works with either LeaveOneOutComputeTypes.
 
   Note that formation of ``[Z_j * K^-1] = K^-1 * \pderiv{K}{\theta_j} * K^-1`` requires some care.  We prefer not to use the explicit
   inverse whenever possible.  But we are readily able to compute ``A^-1 * B`` via "backsolve" (of a factored ``A``), so we do:
@@ -970,7 +1115,6 @@ void LeaveOneOutLogLikelihoodEvaluator::ComputeGradLogLikelihood(LeaveOneOutLogL
   BuildHyperparameterGradCovarianceMatrix(log_likelihood_state);
 
   double * restrict grad_hyperparameter_cov_matrix_ptr = log_likelihood_state->grad_hyperparameter_cov_matrix.data();
-  double const * restrict K_inv_ptr;
   const int num_hyperparameters = log_likelihood_state->num_hyperparameters;
   for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
     // overwrite grad_hyperparameter_cov_matrix := K^-1 * grad_hyperparameter_cov_matrix, aka Z
@@ -994,12 +1138,12 @@ void LeaveOneOutLogLikelihoodEvaluator::ComputeGradLogLikelihood(LeaveOneOutLogL
                     grad_hyperparameter_cov_matrix_ptr);
 
     grad_loo[i_hyper] = 0.0;
-    K_inv_ptr = log_likelihood_state->K_inv.data();
     for (int i = 0; i < num_sampled_; ++i) {
+      // loo_variance[i] = 1/(K^-1)_ii
+      const double loo_variance = log_likelihood_state->loo_variance[i];
       grad_loo[i_hyper] += (log_likelihood_state->K_inv_y[i]*log_likelihood_state->Z_alpha[i] -
-                            0.5*(1.0 + Square(log_likelihood_state->K_inv_y[i])/K_inv_ptr[i]) *
-                            grad_hyperparameter_cov_matrix_ptr[i]) / K_inv_ptr[i];
-      K_inv_ptr += num_sampled_;
+                            0.5*(1.0 + Square(log_likelihood_state->K_inv_y[i])*loo_variance) *
+                            grad_hyperparameter_cov_matrix_ptr[i]) * loo_variance;
       grad_hyperparameter_cov_matrix_ptr += num_sampled_;
     }
   }
@@ -1029,11 +1173,19 @@ void LeaveOneOutLogLikelihoodState::SetupState(const EvaluatorType& log_likeliho
   if (unlikely(num_sampled != log_likelihood_eval.num_sampled())) {
     num_sampled = log_likelihood_eval.num_sampled();
     K_chol.resize(num_sampled*num_sampled);
-    K_inv.resize(num_sampled*num_sampled);
     K_inv_y.resize(num_sampled);
+    L_inv_y.resize(num_sampled);
+    loo_variance.resize(num_sampled);
+    loo_residual.resize(num_sampled);
     grad_hyperparameter_cov_matrix.resize(num_hyperparameters*num_sampled*num_sampled);
     Z_alpha.resize(num_sampled);
     Z_K_inv.resize(num_sampled*num_sampled);
+    temp_vec.resize(num_sampled);
+  }
+  if (log_likelihood_eval.compute_type() == LeaveOneOutComputeTypes::kMatrixInverse) {
+    K_inv.resize(num_sampled*num_sampled);
+  } else {
+    K_inv.clear();
   }
 
   // set hyperparameters and derived quantities
@@ -1047,11 +1199,15 @@ LeaveOneOutLogLikelihoodState::LeaveOneOutLogLikelihoodState(const EvaluatorType
       num_hyperparameters(covariance_in.GetNumberOfHyperparameters()),
       covariance_ptr(covariance_in.Clone()),
       K_chol(num_sampled*num_sampled),
-      K_inv(num_sampled*num_sampled),
+      K_inv(log_likelihood_eval.compute_type() == LeaveOneOutComputeTypes::kMatrixInverse ? num_sampled*num_sampled : 0),
       K_inv_y(num_sampled),
+      L_inv_y(num_sampled),
+      loo_variance(num_sampled),
+      loo_residual(num_sampled),
       grad_hyperparameter_cov_matrix(num_hyperparameters*num_sampled*num_sampled),
       Z_alpha(num_sampled),
-      Z_K_inv(num_sampled*num_sampled) {
+      Z_K_inv(num_sampled*num_sampled),
+      temp_vec(num_sampled) {
   std::vector<double> hyperparameters(num_hyperparameters);
   covariance_ptr->GetHyperparameters(hyperparameters.data());
   SetupState(log_likelihood_eval, hyperparameters.data());
@@ -1059,4 +1215,509 @@ LeaveOneOutLogLikelihoodState::LeaveOneOutLogLikelihoodState(const EvaluatorType
 
 LeaveOneOutLogLikelihoodState::LeaveOneOutLogLikelihoodState(LeaveOneOutLogLikelihoodState&& OL_UNUSED(other)) = default;
 
+namespace {  // utilities for stochastic (matrix-free) log marginal likelihood computations
+
+/*!\rst
+  Computes ``result = K * vectors`` for a block of ``num_vectors`` vectors, where ``K`` is the covariance matrix of
+  ``points_sampled`` plus noise (see BuildCovarianceMatrixWithNoiseVariance()).  ``K`` is never stored: tiles of its lower
+  triangle are regenerated from the covariance and applied (twice, by symmetry, if off-diagonal) to every vector at once.
+
+  \param
+    :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
+    :noise_variance[num_sampled]: i-th entry is amt of noise variance to add to i-th diagonal entry; i.e., noise measuring i-th point
+    :points_sampled[dim][num_sampled]: list of points
+    :dim: the spatial dimension of a point
+    :num_sampled: number of points
+    :vectors[num_vectors][num_sampled]: vectors to multiply (vector index varies fastest)
+    :num_vectors: number of vectors
+    :cov_tile[kLogMarginalGradientTileSize^2]: temporary storage for one tile of ``K``
+  \output
+    :cov_tile[kLogMarginalGradientTileSize^2]: overwritten
+    :result[num_vectors][num_sampled]: ``K * vectors``
+\endrst*/
+OL_NONNULL_POINTERS void BlockCovarianceMatrixVectorMultiply(const CovarianceInterface& covariance,
+                                                             double const * restrict noise_variance,
+                                                             double const * restrict points_sampled, int dim,
+                                                             int num_sampled, double const * restrict vectors,
+                                                             int num_vectors, double * restrict cov_tile,
+                                                             double * restrict result) noexcept {
+  for (int i = 0; i < num_sampled; ++i) {
+    for (int v = 0; v < num_vectors; ++v) {
+      result[i*num_vectors + v] = noise_variance[i]*vectors[i*num_vectors + v];
+    }
+  }
+
+  for (int col_start = 0; col_start < num_sampled; col_start += kLogMarginalGradientTileSize) {
+    const int num_cols = std::min(kLogMarginalGradientTileSize, num_sampled - col_start);
+    for (int row_start = col_start; row_start < num_sampled; row_start += kLogMarginalGradientTileSize) {
+      const int num_rows = std::min(kLogMarginalGradientTileSize, num_sampled - row_start);
+      covariance.CovarianceMatrix(points_sampled + row_start*dim, num_rows, points_sampled + col_start*dim,
+                                  num_cols, cov_tile);
+
+      for (int j = col_start; j < col_start + num_cols; ++j) {
+        double const * restrict cov_tile_column = cov_tile + (j - col_start)*num_rows;
+        for (int i = row_start; i < row_start + num_rows; ++i) {
+          const double cov_ij = cov_tile_column[i - row_start];
+          for (int v = 0; v < num_vectors; ++v) {
+            result[i*num_vectors + v] += cov_ij*vectors[j*num_vectors + v];
+          }
+          // diagonal tiles are computed in full; off-diagonal tiles also stand in for their (unvisited) transposes
+          if (row_start != col_start) {
+            for (int v = 0; v < num_vectors; ++v) {
+              result[j*num_vectors + v] += cov_ij*vectors[i*num_vectors + v];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!\rst
+  Computes the Gauss quadrature estimate of ``e_1^T \log(T) e_1`` from a symmetric tridiagonal (Lanczos) matrix ``T``:
+
+  ``e_1^T \log(T) e_1 = \sum_k \tau_k^2 \log(\theta_k)``,
+
+  where ``\theta_k`` are the eigenvalues of ``T`` and ``\tau_k`` are the first components of its (unit) eigenvectors.
+
+  Eigenvalues are found with the implicit QL algorithm (with Wilkinson shifts); since only ``\tau_k`` is needed, we
+  accumulate just the first row of the eigenvector matrix.
+
+  \param
+    :diagonal[size]: diagonal of ``T``
+    :sub_diagonal[size]: sub-diagonal of ``T`` in entries ``0 .. size-2``; the last entry is ignored
+    :size: dimension of ``T``
+    :eigenvector_row[size]: temporary storage
+  \output
+    :diagonal[size]: overwritten with eigenvalues
+    :sub_diagonal[size]: destroyed
+    :eigenvector_row[size]: first components of the eigenvectors, ``\tau_k``
+  \return
+    ``\sum_k \tau_k^2 \log(\theta_k)``
+\endrst*/
+OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT double LanczosLogQuadrature(double * restrict diagonal,
+                                                                      double * restrict sub_diagonal, int size,
+                                                                      double * restrict eigenvector_row) noexcept {
+  const int kMaxNumQLIterations = 60;
+  sub_diagonal[size - 1] = 0.0;
+  std::fill(eigenvector_row, eigenvector_row + size, 0.0);
+  eigenvector_row[0] = 1.0;
+
+  for (int l = 0; l < size; ++l) {
+    int num_iterations = 0;
+    int m;
+    do {
+      // look for a negligible sub-diagonal entry to split the matrix
+      for (m = l; m < size - 1; ++m) {
+        const double diagonal_scale = std::fabs(diagonal[m]) + std::fabs(diagonal[m + 1]);
+        if (std::fabs(sub_diagonal[m]) <= std::numeric_limits<double>::epsilon()*diagonal_scale) {
+          break;
+        }
+      }
+      if (m != l) {
+        if (num_iterations++ == kMaxNumQLIterations) {
+          break;
+        }
+        double g = (diagonal[l + 1] - diagonal[l])/(2.0*sub_diagonal[l]);
+        double r = std::hypot(g, 1.0);
+        g = diagonal[m] - diagonal[l] + sub_diagonal[l]/(g + std::copysign(r, g));
+        double s = 1.0, c = 1.0, p = 0.0;
+        int i;
+        for (i = m - 1; i >= l; --i) {
+          double f = s*sub_diagonal[i];
+          const double b = c*sub_diagonal[i];
+          r = std::hypot(f, g);
+          sub_diagonal[i + 1] = r;
+          if (r == 0.0) {
+            diagonal[i + 1] -= p;
+            sub_diagonal[m] = 0.0;
+            break;
+          }
+          s = f/r;
+          c = g/r;
+          g = diagonal[i + 1] - p;
+          r = (diagonal[i] - g)*s + 2.0*c*b;
+          p = s*r;
+          diagonal[i + 1] = g + p;
+          g = c*r - b;
+
+          f = eigenvector_row[i + 1];
+          eigenvector_row[i + 1] = s*eigenvector_row[i] + c*f;
+          eigenvector_row[i] = c*eigenvector_row[i] - s*f;
+        }
+        if (r == 0.0 && i >= l) {
+          continue;
+        }
+        diagonal[l] -= p;
+        sub_diagonal[l] = g;
+        sub_diagonal[m] = 0.0;
+      }
+    } while (m != l);
+  }
+
+  double quadrature = 0.0;
+  for (int k = 0; k < size; ++k) {
+    quadrature += Square(eigenvector_row[k])*std::log(diagonal[k]);
+  }
+  return quadrature;
+}
+
+}  // end unnamed namespace
+
+StochasticLogMarginalLikelihoodEvaluator::StochasticLogMarginalLikelihoodEvaluator(
+    double const * restrict points_sampled_in,
+    double const * restrict points_sampled_value_in,
+    double const * restrict noise_variance_in,
+    int dim_in, int num_sampled_in, int num_probes_in,
+    int max_num_cg_iterations_in, double cg_tolerance_in,
+    UniformRandomGenerator * uniform_generator)
+    : dim_(dim_in),
+      num_sampled_(num_sampled_in),
+      num_probes_(num_probes_in),
+      max_num_cg_iterations_(max_num_cg_iterations_in),
+      cg_tolerance_(cg_tolerance_in),
+      points_sampled_(points_sampled_in, points_sampled_in + num_sampled_in*dim_in),
+      points_sampled_value_(points_sampled_value_in, points_sampled_value_in + num_sampled_in),
+      noise_variance_(noise_variance_in, noise_variance_in + num_sampled_),
+      probes_(num_probes_in*num_sampled_in) {
+  if (unlikely(num_probes_ <= 0)) {
+    OL_THROW_EXCEPTION(LowerBoundException<int>, "num_probes must be positive.", num_probes_, 1);
+  }
+  if (unlikely(max_num_cg_iterations_ <= 0)) {
+    OL_THROW_EXCEPTION(LowerBoundException<int>, "max_num_cg_iterations must be positive.", max_num_cg_iterations_, 1);
+  }
+
+  // Rademacher probes: E[w w^T] = I with the least variance (among i.i.d. probes) in Hutchinson's estimator
+  boost::uniform_int<int> uniform_sign(0, 1);
+  for (auto& entry : probes_) {
+    entry = uniform_sign(uniform_generator->engine) == 0 ? -1.0 : 1.0;
+  }
+}
+
+/*!\rst
+  We solve ``K x_v = b_v`` for ``b_0 = y`` and ``b_t = P^{1/2} w_t`` (``t = 1..T``) with CG preconditioned by ``P = diag(K)``.
+  The systems are advanced in lockstep so each iteration needs one pass over ``K`` (BlockCovarianceMatrixVectorMultiply())
+  for all of them; systems that have converged stop updating.
+
+  PCG on ``K x = P^{1/2} w`` is CG on ``\tilde{K} \tilde{x} = w`` with ``\tilde{K} = P^{-1/2} K P^{-1/2}``,
+  ``\tilde{x} = P^{1/2} x``.  So its coefficients define the Lanczos tridiagonalization of ``\tilde{K}`` started
+  from ``w/\|w\|``; see FillLogLikelihoodState().
+\endrst*/
+void StochasticLogMarginalLikelihoodEvaluator::SolveWithPreconditionedConjugateGradients(
+    StochasticLogMarginalLikelihoodState * log_likelihood_state) const noexcept {
+  const int num_vectors = num_probes_ + 1;
+  double const * restrict preconditioner = log_likelihood_state->preconditioner.data();
+  double * restrict solution = log_likelihood_state->cg_solution.data();
+  double * restrict residual = log_likelihood_state->cg_residual.data();
+  double * restrict preconditioned_residual = log_likelihood_state->cg_preconditioned_residual.data();
+  double * restrict search_direction = log_likelihood_state->cg_search_direction.data();
+  double * restrict cov_search_direction = log_likelihood_state->cg_covariance_times_search_direction.data();
+  double * restrict cg_alpha = log_likelihood_state->cg_alpha.data();
+  double * restrict cg_beta = log_likelihood_state->cg_beta.data();
+  int * restrict cg_num_iterations = log_likelihood_state->cg_num_iterations.data();
+
+  // x = 0, r = b, z = P^-1 r, p = z
+  std::vector<double> residual_dot_preconditioned_residual(num_vectors, 0.0);
+  std::vector<double> residual_tolerance(num_vectors, 0.0);
+  for (int i = 0; i < num_sampled_; ++i) {
+    const double sqrt_preconditioner = std::sqrt(preconditioner[i]);
+    residual[i*num_vectors + 0] = points_sampled_value_[i];
+    for (int t = 0; t < num_probes_; ++t) {
+      residual[i*num_vectors + t + 1] = sqrt_preconditioner*probes_[i*num_probes_ + t];
+    }
+    for (int v = 0; v < num_vectors; ++v) {
+      solution[i*num_vectors + v] = 0.0;
+      preconditioned_residual[i*num_vectors + v] = residual[i*num_vectors + v]/preconditioner[i];
+      search_direction[i*num_vectors + v] = preconditioned_residual[i*num_vectors + v];
+      residual_dot_preconditioned_residual[v] += residual[i*num_vectors + v]*preconditioned_residual[i*num_vectors + v];
+      residual_tolerance[v] += Square(residual[i*num_vectors + v]);
+    }
+  }
+
+  int num_active = 0;
+  std::vector<bool> active(num_vectors);
+  for (int v = 0; v < num_vectors; ++v) {
+    residual_tolerance[v] = Square(cg_tolerance_)*residual_tolerance[v];
+    cg_num_iterations[v] = 0;
+    active[v] = residual_dot_preconditioned_residual[v] > 0.0;
+    num_active += active[v];
+  }
+
+  std::vector<double> search_direction_dot_cov(num_vectors);
+  std::vector<double> residual_norm_squared(num_vectors);
+  std::vector<double> old_residual_dot_preconditioned_residual(num_vectors);
+  for (int iteration = 0; iteration < max_num_cg_iterations_ && num_active > 0; ++iteration) {
+    BlockCovarianceMatrixVectorMultiply(*log_likelihood_state->covariance_ptr, noise_variance_.data(),
+                                        points_sampled_.data(), dim_, num_sampled_, search_direction, num_vectors,
+                                        log_likelihood_state->cov_tile.data(), cov_search_direction);
+
+    // alpha = (r^T z) / (p^T K p); x += alpha p; r -= alpha K p
+    std::fill(search_direction_dot_cov.begin(), search_direction_dot_cov.end(), 0.0);
+    for (int i = 0; i < num_sampled_; ++i) {
+      for (int v = 0; v < num_vectors; ++v) {
+        search_direction_dot_cov[v] += search_direction[i*num_vectors + v]*cov_search_direction[i*num_vectors + v];
+      }
+    }
+    for (int v = 0; v < num_vectors; ++v) {
+      if (active[v]) {
+        cg_alpha[v*max_num_cg_iterations_ + iteration] = residual_dot_preconditioned_residual[v]/search_direction_dot_cov[v];
+      }
+    }
+    std::fill(residual_norm_squared.begin(), residual_norm_squared.end(), 0.0);
+    for (int i = 0; i < num_sampled_; ++i) {
+      for (int v = 0; v < num_vectors; ++v) {
+        if (active[v]) {
+          const double alpha = cg_alpha[v*max_num_cg_iterations_ + iteration];
+          solution[i*num_vectors + v] += alpha*search_direction[i*num_vectors + v];
+          residual[i*num_vectors + v] -= alpha*cov_search_direction[i*num_vectors + v];
+          residual_norm_squared[v] += Square(residual[i*num_vectors + v]);
+        }
+      }
+    }
+
+    // beta = (r_new^T z_new) / (r^T z); p = z_new + beta p
+    for (int v = 0; v < num_vectors; ++v) {
+      if (active[v]) {
+        cg_num_iterations[v] = iteration + 1;
+        if (residual_norm_squared[v] <= residual_tolerance[v]) {
+          active[v] = false;
+          --num_active;
+        }
+      }
+    }
+    std::copy(residual_dot_preconditioned_residual.begin(), residual_dot_preconditioned_residual.end(),
+              old_residual_dot_preconditioned_residual.begin());
+    std::fill(residual_dot_preconditioned_residual.begin(), residual_dot_preconditioned_residual.end(), 0.0);
+    for (int i = 0; i < num_sampled_; ++i) {
+      for (int v = 0; v < num_vectors; ++v) {
+        preconditioned_residual[i*num_vectors + v] = residual[i*num_vectors + v]/preconditioner[i];
+        residual_dot_preconditioned_residual[v] += residual[i*num_vectors + v]*preconditioned_residual[i*num_vectors + v];
+      }
+    }
+    for (int v = 0; v < num_vectors; ++v) {
+      if (active[v]) {
+        cg_beta[v*max_num_cg_iterations_ + iteration] = residual_dot_preconditioned_residual[v]/
+            old_residual_dot_preconditioned_residual[v];
+      }
+    }
+    for (int i = 0; i < num_sampled_; ++i) {
+      for (int v = 0; v < num_vectors; ++v) {
+        if (active[v]) {
+          search_direction[i*num_vectors + v] = preconditioned_residual[i*num_vectors + v] +
+              cg_beta[v*max_num_cg_iterations_ + iteration]*search_direction[i*num_vectors + v];
+        }
+      }
+    }
+  }
+}
+
+/*!\rst
+  Fills the Jacobi preconditioner, ``P = diag(K)``, runs the PCG solves (SolveWithPreconditionedConjugateGradients()),
+  and estimates ``\log(det(K))`` by stochastic Lanczos quadrature.
+
+  Since ``\log(det(K)) = \log(det(P)) + tr(\log(\tilde{K}))`` with ``\tilde{K} = P^{-1/2} K P^{-1/2}``, we only estimate the
+  (better conditioned) second term:
+
+  ``tr(\log(\tilde{K})) \approx \frac{1}{T} \sum_t w_t^T \log(\tilde{K}) w_t \approx \frac{N}{T} \sum_t \sum_k \tau_{t,k}^2 \log(\theta_{t,k})``,
+
+  where ``\|w_t\|^2 = N`` and ``\theta_{t,k}, \tau_{t,k}`` are the eigenvalues and first eigenvector components of the Lanczos
+  tridiagonal matrix from the ``t``-th PCG solve.  With CG step lengths ``\alpha_j`` and direction updates ``\beta_j``,
+  that matrix has entries:
+
+  | ``T_{jj} = 1/\alpha_j + \beta_{j-1}/\alpha_{j-1}`` (no second term for ``j = 0``)
+  | ``T_{j,j+1} = \sqrt{\beta_j}/\alpha_j``
+\endrst*/
+void StochasticLogMarginalLikelihoodEvaluator::FillLogLikelihoodState(
+    StochasticLogMarginalLikelihoodState * log_likelihood_state) const {
+  const CovarianceInterface& covariance = *log_likelihood_state->covariance_ptr;
+  double log_determinant = 0.0;
+  for (int i = 0; i < num_sampled_; ++i) {
+    double const * restrict point = points_sampled_.data() + i*dim_;
+    const double preconditioner = covariance.Covariance(point, point) + noise_variance_[i];
+    log_likelihood_state->preconditioner[i] = preconditioner;
+    log_determinant += std::log(preconditioner);
+    const double inverse_sqrt_preconditioner = 1.0/std::sqrt(preconditioner);
+    for (int t = 0; t < num_probes_; ++t) {
+      log_likelihood_state->scaled_probes[i*num_probes_ + t] = inverse_sqrt_preconditioner*probes_[i*num_probes_ + t];
+    }
+  }
+
+  SolveWithPreconditionedConjugateGradients(log_likelihood_state);
+
+  double * restrict lanczos_diagonal = log_likelihood_state->lanczos_temp.data();
+  double * restrict lanczos_sub_diagonal = lanczos_diagonal + max_num_cg_iterations_;
+  double * restrict eigenvector_row = lanczos_sub_diagonal + max_num_cg_iterations_;
+  double log_determinant_quadrature = 0.0;
+  for (int t = 0; t < num_probes_; ++t) {
+    const int num_iterations = log_likelihood_state->cg_num_iterations[t + 1];
+    double const * restrict cg_alpha = log_likelihood_state->cg_alpha.data() + (t + 1)*max_num_cg_iterations_;
+    double const * restrict cg_beta = log_likelihood_state->cg_beta.data() + (t + 1)*max_num_cg_iterations_;
+    for (int j = 0; j < num_iterations; ++j) {
+      lanczos_diagonal[j] = 1.0/cg_alpha[j];
+      if (j > 0) {
+        lanczos_diagonal[j] += cg_beta[j - 1]/cg_alpha[j - 1];
+      }
+      if (j < num_iterations - 1) {
+        lanczos_sub_diagonal[j] = std::sqrt(cg_beta[j])/cg_alpha[j];
+      }
+    }
+    log_determinant_quadrature += LanczosLogQuadrature(lanczos_diagonal, lanczos_sub_diagonal, num_iterations,
+                                                       eigenvector_row);
+  }
+  log_likelihood_state->log_determinant = log_determinant +
+      static_cast<double>(num_sampled_)/static_cast<double>(num_probes_)*log_determinant_quadrature;
+}
+
+/*!\rst
+  Same as LogMarginalLikelihoodEvaluator::ComputeLogLikelihood(), except ``K^-1 y`` comes from CG and ``\log(det(K))``
+  is the SLQ estimate computed in FillLogLikelihoodState().
+\endrst*/
+double StochasticLogMarginalLikelihoodEvaluator::ComputeLogLikelihood(
+    const StochasticLogMarginalLikelihoodState& log_likelihood_state) const noexcept {
+  const int num_vectors = num_probes_ + 1;
+  double log_marginal_term1 = 0.0;
+  for (int i = 0; i < num_sampled_; ++i) {
+    log_marginal_term1 += points_sampled_value_[i]*log_likelihood_state.cg_solution[i*num_vectors + 0];
+  }
+  log_marginal_term1 *= -0.5;
+
+  double log_marginal_term2 = -0.5*log_likelihood_state.log_determinant;
+  double log_marginal_term3 = -0.5*static_cast<double>(num_sampled_)*kLog2Pi;
+
+  return log_marginal_term1 + log_marginal_term2 + log_marginal_term3;
+}
+
+/*!\rst
+  As in LogMarginalLikelihoodEvaluator::ComputeGradLogLikelihoodStreaming(), we compute::
+
+    \pderiv{log(p(y | X, \theta))}{\theta_k} = \sum_{ij} G_{ij} * \pderiv{K_{ij}}{\theta_k}
+
+  with ``G = \frac{1}{2}(\alpha\alpha^T - K^-1)``, except that ``K^-1`` is replaced by its Hutchinson estimate.  With
+  ``u_t = P^{-1/2} w_t`` and ``x_t = K^-1 P^{1/2} w_t`` (from PCG), ``E[x_t u_t^T] = K^-1 P^{1/2} E[w_t w_t^T] P^{-1/2} = K^-1``, so:
+
+  ``G \approx \frac{1}{2}\alpha\alpha^T - \frac{1}{2T}\sum_t x_t u_t^T``
+
+  ``\pderiv{K}{\theta_k}`` is symmetric, so we visit only ``kLogMarginalGradientTileSize^2`` tiles covering its lower triangle and weight
+  off-diagonal entries by ``G_{ij} + G_{ji}``.  ``G`` itself is never formed.
+\endrst*/
+void StochasticLogMarginalLikelihoodEvaluator::ComputeGradLogLikelihood(
+    StochasticLogMarginalLikelihoodState * log_likelihood_state,
+    double * restrict grad_log_marginal) const noexcept {
+  const int num_hyperparameters = log_likelihood_state->num_hyperparameters;
+  const int num_vectors = num_probes_ + 1;
+  const double probe_normalization = 0.5/static_cast<double>(num_probes_);
+  double const * restrict solution = log_likelihood_state->cg_solution.data();
+  double const * restrict scaled_probes = log_likelihood_state->scaled_probes.data();
+  double * restrict grad_hyperparameter_cov_tile = log_likelihood_state->grad_hyperparameter_cov_tile.data();
+
+  std::fill(grad_log_marginal, grad_log_marginal + num_hyperparameters, 0.0);
+  for (int col_start = 0; col_start < num_sampled_; col_start += kLogMarginalGradientTileSize) {
+    const int num_cols = std::min(kLogMarginalGradientTileSize, num_sampled_ - col_start);
+    for (int row_start = col_start; row_start < num_sampled_; row_start += kLogMarginalGradientTileSize) {
+      const int num_rows = std::min(kLogMarginalGradientTileSize, num_sampled_ - row_start);
+      const int tile_size = num_rows*num_cols;
+      log_likelihood_state->covariance_ptr->HyperparameterGradCovarianceMatrix(points_sampled_.data() + row_start*dim_,
+                                                                               num_rows,
+                                                                               points_sampled_.data() + col_start*dim_,
+                                                                               num_cols, grad_hyperparameter_cov_tile);
+
+      for (int i = col_start; i < col_start + num_cols; ++i) {
+        // in diagonal tiles, skip the strict upper triangle (j < i)
+        for (int j = std::max(i, row_start); j < row_start + num_rows; ++j) {
+          double weight = solution[i*num_vectors + 0]*solution[j*num_vectors + 0];
+          double trace_estimate = 0.0;
+          for (int t = 0; t < num_probes_; ++t) {
+            trace_estimate += solution[i*num_vectors + t + 1]*scaled_probes[j*num_probes_ + t] +
+                solution[j*num_vectors + t + 1]*scaled_probes[i*num_probes_ + t];
+          }
+          weight -= probe_normalization*trace_estimate;
+          // weight is G_ij + G_ji; the diagonal counts once
+          if (j == i) {
+            weight *= 0.5;
+          }
+
+          double const * restrict grad_cov_entry = grad_hyperparameter_cov_tile + (i - col_start)*num_rows + (j - row_start);
+          for (int i_hyper = 0; i_hyper < num_hyperparameters; ++i_hyper) {
+            grad_log_marginal[i_hyper] += weight*grad_cov_entry[i_hyper*tile_size];
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!\rst
+  NOT IMPLEMENTED
+  Kludge to make it so that I can use general template code w/o special casing StochasticLogMarginalLikelihoodEvaluator.
+\endrst*/
+void StochasticLogMarginalLikelihoodEvaluator::ComputeHessianLogLikelihood(
+    StochasticLogMarginalLikelihoodState * OL_UNUSED(log_likelihood_state),
+    double * restrict OL_UNUSED(hessian_log_marginal)) const {
+  OL_THROW_EXCEPTION(OptimalLearningException, "StochasticLogMarginalLikelihoodEvaluator::ComputeHessianLogLikelihood is NOT IMPLEMENTED. Try using Gradient Descent instead of Newton.");
+}
+
+void StochasticLogMarginalLikelihoodState::SetHyperparameters(const EvaluatorType& log_likelihood_eval,
+                                                              double const * restrict hyperparameters) {
+  // update hyperparameters
+  covariance_ptr->SetHyperparameters(hyperparameters);
+
+  // evaluate derived quantities
+  log_likelihood_eval.FillLogLikelihoodState(this);
+}
+
+void StochasticLogMarginalLikelihoodState::SetupState(const EvaluatorType& log_likelihood_eval,
+                                                      double const * restrict hyperparameters) {
+  if (unlikely(num_sampled != log_likelihood_eval.num_sampled() || num_probes != log_likelihood_eval.num_probes() ||
+               max_num_cg_iterations != log_likelihood_eval.max_num_cg_iterations())) {
+    num_sampled = log_likelihood_eval.num_sampled();
+    num_probes = log_likelihood_eval.num_probes();
+    max_num_cg_iterations = log_likelihood_eval.max_num_cg_iterations();
+    const int num_vectors = num_probes + 1;
+    preconditioner.resize(num_sampled);
+    scaled_probes.resize(num_probes*num_sampled);
+    cg_solution.resize(num_vectors*num_sampled);
+    cg_residual.resize(num_vectors*num_sampled);
+    cg_preconditioned_residual.resize(num_vectors*num_sampled);
+    cg_search_direction.resize(num_vectors*num_sampled);
+    cg_covariance_times_search_direction.resize(num_vectors*num_sampled);
+    cg_alpha.resize(max_num_cg_iterations*num_vectors);
+    cg_beta.resize(max_num_cg_iterations*num_vectors);
+    cg_num_iterations.resize(num_vectors);
+    lanczos_temp.resize(3*max_num_cg_iterations);
+  }
+
+  // set hyperparameters and derived quantities
+  SetHyperparameters(log_likelihood_eval, hyperparameters);
+}
+
+StochasticLogMarginalLikelihoodState::StochasticLogMarginalLikelihoodState(const EvaluatorType& log_likelihood_eval,
+                                                                           const CovarianceInterface& covariance_in)
+    : dim(log_likelihood_eval.dim()),
+      num_sampled(log_likelihood_eval.num_sampled()),
+      num_hyperparameters(covariance_in.GetNumberOfHyperparameters()),
+      num_probes(log_likelihood_eval.num_probes()),
+      max_num_cg_iterations(log_likelihood_eval.max_num_cg_iterations()),
+      covariance_ptr(covariance_in.Clone()),
+      preconditioner(num_sampled),
+      scaled_probes(num_probes*num_sampled),
+      cg_solution((num_probes + 1)*num_sampled),
+      log_determinant(0.0),
+      cg_residual((num_probes + 1)*num_sampled),
+      cg_preconditioned_residual((num_probes + 1)*num_sampled),
+      cg_search_direction((num_probes + 1)*num_sampled),
+      cg_covariance_times_search_direction((num_probes + 1)*num_sampled),
+      cg_alpha(max_num_cg_iterations*(num_probes + 1)),
+      cg_beta(max_num_cg_iterations*(num_probes + 1)),
+      cg_num_iterations(num_probes + 1),
+      cov_tile(Square(kLogMarginalGradientTileSize)),
+      grad_hyperparameter_cov_tile(num_hyperparameters*Square(kLogMarginalGradientTileSize)),
+      lanczos_temp(3*max_num_cg_iterations) {
+  std::vector<double> hyperparameters(num_hyperparameters);
+  covariance_ptr->GetHyperparameters(hyperparameters.data());
+  SetupState(log_likelihood_eval, hyperparameters.data());
+}
+
+StochasticLogMarginalLikelihoodState::StochasticLogMarginalLikelihoodState(
+    StochasticLogMarginalLikelihoodState&& OL_UNUSED(other)) = default;
+
 }  // end namespace optimal_learning
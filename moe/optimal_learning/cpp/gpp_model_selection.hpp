@@ -36,11 +36,12 @@
 
   both of which follow the Evaluator/State "idiom" described in gpp_common.hpp.
 
-  For selecting the best hyperparameters, this file provides two multistart optimization wrappers
-  for gradient descent and Newton, that maximize the previous log likelihood measures:
+  For selecting the best hyperparameters, this file provides three multistart optimization wrappers
+  for gradient descent, Newton, and (projected) L-BFGS, that maximize the previous log likelihood measures:
 
   * MultistartGradientDescentHyperparameterOptimization<LogLikelihoodEvaluator, Domain>()
   * MultistartNewtonHyperparameterOptimization<LogLikelihoodEvaluator, Domain>()
+  * MultistartLBFGSHyperparameterOptimization<LogLikelihoodEvaluator>()
 
   These functions are wrappers for templated code in gpp_optimization.hpp.  The wrappers just set up inputs for use
   with the routines in gpp_optimization.hpp.  These are the preferred endpoints for hyperparameter optimization.
@@ -193,6 +194,12 @@
 
           Single start version available in: NewtonHyperparameterOptimization<>().
 
+     iv. MultistartLBFGSHyperparameterOptimization<>():
+
+         Takes in a ``log_likelihood_evaluator`` describing the prior, covariance, domain, config, etc.;
+         searches for the best hyperparameters (of covariance) using multiple projected L-BFGS runs.
+         Needs only gradients (no hessian), so it also works with LeaveOneOutLogLikelihoodEvaluator.
+
      .. NOTE::
          See ``gpp_model_selection.cpp``'s header comments for more detailed implementation notes.
 
@@ -234,9 +241,37 @@ enum class LogLikelihoodTypes {
   kLeaveOneOutLogLikelihood = 1,
 };
 
+/*!\rst
+  Enum for the ways LogMarginalLikelihoodEvaluator can compute the gradient of the log marginal likelihood.
+  See LogMarginalLikelihoodEvaluator::ComputeGradLogLikelihood() for details.
+\endrst*/
+enum class LogMarginalLikelihoodGradientTypes {
+  //! form every ``\pderiv{K}{\theta_k}`` (``num_hyperparameters * N^2`` doubles) and backsolve against each of them
+  kFullTensor = 0,
+  //! stream ``\pderiv{K}{\theta_k}`` in small tiles, contracting each against ``\alpha\alpha^T - K^-1``; ``O(N^2)`` memory
+  kStreaming = 1,
+};
+
+//! Number of points per side of the ``\pderiv{K}{\theta_k}`` tiles used by LogMarginalLikelihoodGradientTypes::kStreaming
+//! and by LogMarginalLikelihoodEvaluator::ComputeHessianLogLikelihood().
+//! Each tile holds ``num_hyperparameters * kLogMarginalGradientTileSize^2`` doubles.
+static constexpr int kLogMarginalGradientTileSize = 32;
+
+/*!\rst
+  Enum for the ways LeaveOneOutLogLikelihoodEvaluator can compute the LOO predictive mean & variance, ``\mu_i, \sigma_i^2``.
+  See the gpp_model_selection.cpp file comments and LeaveOneOutLogLikelihoodEvaluator::FillLogLikelihoodState() for details.
+\endrst*/
+enum class LeaveOneOutComputeTypes {
+  //! read ``\mu_i, \sigma_i^2`` off of the explicit inverse, ``K^-1``; fast but potentially ill-conditioned
+  kMatrixInverse = 0,
+  //! remove the ``i``-th row/column from ``K``'s cholesky factor (O(N^2) per point); never forms ``K^-1``
+  kCholeskyDowndate = 1,
+};
+
 struct UniformRandomGenerator;
 struct LogMarginalLikelihoodState;
 struct LeaveOneOutLogLikelihoodState;
+struct StochasticLogMarginalLikelihoodState;
 
 /*!\rst
   This serves as a quick summary of the Log Marginal Likelihood (LML).  Please see the file comments here and
@@ -281,6 +316,24 @@ class LogMarginalLikelihoodEvaluator final {
                                  double const * restrict noise_variance_in,
                                  int dim_in, int num_sampled_in) OL_NONNULL_POINTERS;
 
+  /*!\rst
+    Constructs a LogMarginalLikelihoodEvaluator object that computes gradients as specified by ``gradient_type``.
+    The 5 argument constructor uses LogMarginalLikelihoodGradientTypes::kFullTensor.
+
+    \param
+      :points_sampled[dim][num_sampled]: points that have already been sampled
+      :points_sampled_value[num_sampled]: values of the already-sampled points
+      :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+      :gradient_type: how to compute the gradient wrt hyperparameters (trades memory for speed)
+  \endrst*/
+  LogMarginalLikelihoodEvaluator(double const * restrict points_sampled_in,
+                                 double const * restrict points_sampled_value_in,
+                                 double const * restrict noise_variance_in,
+                                 int dim_in, int num_sampled_in,
+                                 LogMarginalLikelihoodGradientTypes gradient_type_in) OL_NONNULL_POINTERS;
+
   int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
     return dim_;
   }
@@ -289,6 +342,10 @@ class LogMarginalLikelihoodEvaluator final {
     return num_sampled_;
   }
 
+  LogMarginalLikelihoodGradientTypes gradient_type() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return gradient_type_;
+  }
+
   /*!\rst
     Wrapper for ComputeLogLikelihood(); see that function for details.
   \endrst*/
@@ -388,26 +445,25 @@ class LogMarginalLikelihoodEvaluator final {
   void BuildHyperparameterGradCovarianceMatrix(StateType * log_likelihood_state) const noexcept;
 
   /*!\rst
-    Constructs the tensor of hessians (wrt hyperparameters) of the covariance function at all pairs of ``points_sampled_``.
-    The result is ``\mixpderiv{cov(X_i, X_j)}{\theta_k}{\theta_l}``, stored in ``hessian_hyperparameter_cov_matrix[i][j][k][l]``.
-
-    .. Note:: this tensor has several symmetries: ``A[i][j][k][l] == A[j][i][k][l]`` and ``A[i][j][k][l] == A[i][j][l][k]``.
+    Computes the gradient of the log marginal likelihood (see ComputeGradLogLikelihood()) without storing the full
+    ``\pderiv{K}{\theta_k}`` tensor.  Used for LogMarginalLikelihoodGradientTypes::kStreaming.
 
     \param
       :log_likelihood_state[1]: properly configured state object
     \output
-      :log_likelihood_state[1]: state object with temporary storage modified
-      :hessian_hyperparameter_cov_matrix[num_sampled][num_sampled][n_hyper][n_hyper]:
-        ``(i,j,k,l)``-th entry is ``\mixpderiv{cov(X_i, X_j)}{\theta_k}{\theta_l}``
+      :log_likelihood_state[1]: state with K_inv and grad_hyperparameter_cov_tile modified
+      :grad_log_marginal[n_hyper]: gradient of log marginal likelihood wrt each hyperparameter of covariance
   \endrst*/
-  void BuildHyperparameterHessianCovarianceMatrix(StateType * log_likelihood_state,
-                                                  double * hessian_hyperparameter_cov_matrix) const noexcept;
+  void ComputeGradLogLikelihoodStreaming(StateType * log_likelihood_state,
+                                         double * restrict grad_log_marginal) const noexcept OL_NONNULL_POINTERS;
 
   // size information
   //! spatial dimension (e.g., entries per point of points_sampled)
   const int dim_;
   //! number of points in points_sampled
   int num_sampled_;
+  //! how gradients wrt hyperparameters are computed
+  LogMarginalLikelihoodGradientTypes gradient_type_;
 
   // state variables
   //! coordinates of already-sampled points, X
@@ -512,8 +568,15 @@ struct LogMarginalLikelihoodState final {
   std::vector<double> K_inv_y;
 
   // temporary storage: preallocated space used by LogMarginalLikelihoodEvaluator's member functions
-  //! ``\pderiv{K_{ij}}{\theta_k}``; temporary b/c it is overwritten with each computation of GradLikelihood
+  //! ``\pderiv{K_{ij}}{\theta_k}``; temporary b/c it is overwritten with each computation of GradLikelihood.
+  //! Only allocated for LogMarginalLikelihoodGradientTypes::kFullTensor
   std::vector<double> grad_hyperparameter_cov_matrix;
+  //! ``K^-1``; used by LogMarginalLikelihoodGradientTypes::kStreaming gradients and by the Hessian
+  std::vector<double> K_inv;
+  //! one ``kLogMarginalGradientTileSize^2`` tile of ``\pderiv{K_{ij}}{\theta_k}`` for each hyperparameter
+  std::vector<double> grad_hyperparameter_cov_tile;
+  //! temporary storage space of size ``num_sampled^2``; holds ``K^-1 * \pderiv{K}{\theta_k} * K^-1`` in the Hessian
+  std::vector<double> temp_matrix;
   //! temporary storage space of size ``num_sampled``
   std::vector<double> temp_vec;
 
@@ -570,6 +633,24 @@ class LeaveOneOutLogLikelihoodEvaluator final {
                                     double const * restrict noise_variance_in,
                                     int dim_in, int num_sampled_in) OL_NONNULL_POINTERS;
 
+  /*!\rst
+    Constructs a LeaveOneOutLogLikelihoodEvaluator object that computes ``\mu_i, \sigma_i^2`` as specified by ``compute_type``.
+    The 5 argument constructor uses LeaveOneOutComputeTypes::kMatrixInverse.
+
+    \param
+      :points_sampled[dim][num_sampled]: points that have already been sampled
+      :points_sampled_value[num_sampled]: values of the already-sampled points
+      :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+      :compute_type: how to compute the leave-one-out predictive mean & variance
+  \endrst*/
+  LeaveOneOutLogLikelihoodEvaluator(double const * restrict points_sampled_in,
+                                    double const * restrict points_sampled_value_in,
+                                    double const * restrict noise_variance_in,
+                                    int dim_in, int num_sampled_in,
+                                    LeaveOneOutComputeTypes compute_type_in) OL_NONNULL_POINTERS;
+
   int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
     return dim_;
   }
@@ -578,6 +659,10 @@ class LeaveOneOutLogLikelihoodEvaluator final {
     return num_sampled_;
   }
 
+  LeaveOneOutComputeTypes compute_type() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return compute_type_;
+  }
+
   /*!\rst
     Wrapper for ComputeLogLikelihood(); see that function for details.
   \endrst*/
@@ -675,6 +760,8 @@ class LeaveOneOutLogLikelihoodEvaluator final {
   const int dim_;
   //! number of points in points_sampled
   int num_sampled_;
+  //! how the leave-one-out predictive mean & variance are computed
+  LeaveOneOutComputeTypes compute_type_;
 
   // state variables
   //! coordinates of already-sampled points, ``X``
@@ -775,10 +862,16 @@ struct LeaveOneOutLogLikelihoodState final {
   // derived variables
   //! cholesky factorization of ``K``
   std::vector<double> K_chol;
-  //! ``K^-1``
+  //! ``K^-1``; only formed for LeaveOneOutComputeTypes::kMatrixInverse (empty otherwise)
   std::vector<double> K_inv;
   //! ``K^-1 * y``; computed WITHOUT forming ``K^-1``
   std::vector<double> K_inv_y;
+  //! ``L^-1 * y``, where ``L`` is ``K_chol``
+  std::vector<double> L_inv_y;
+  //! ``\sigma_i^2``, the LOO predictive variance of ``y_i``; i.e., ``1/(K^-1)_ii``
+  std::vector<double> loo_variance;
+  //! ``y_i - \mu_i``, the LOO predictive residual of ``y_i``; i.e., ``(K^-1 * y)_i/(K^-1)_ii``
+  std::vector<double> loo_residual;
 
   // temporary storage: preallocated space used by LeaveOneOutLogLikelihoodEvaluator's member functions
   //! ``\pderiv{K_{ij}}{\theta_k}``; temporary b/c it is overwritten with each computation of GradLikelihood
@@ -787,10 +880,317 @@ struct LeaveOneOutLogLikelihoodState final {
   std::vector<double> Z_alpha;
   //! temporary: ``K^-1 * grad_hyperparameter_cov_matrix * K^-1``
   std::vector<double> Z_K_inv;
+  //! temporary storage space of size ``num_sampled``
+  std::vector<double> temp_vec;
 
   OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(LeaveOneOutLogLikelihoodState);
 };
 
+/*!\rst
+  Estimates the Log Marginal Likelihood (see LogMarginalLikelihoodEvaluator) and its hyperparameter gradient
+  using only matrix-vector products with the covariance matrix, ``K``.
+
+  LogMarginalLikelihoodEvaluator needs the cholesky factor of ``K`` (``O(N^3)`` work, ``O(N^2)`` memory) and, for the
+  gradient, ``K^-1`` or a full backsolve per hyperparameter.  That is out of reach for very large training sets
+  (``N`` above about 20,000).  Instead, this class:
+
+  * solves ``K \alpha = y`` with preconditioned conjugate gradients (PCG) for the data-fit term;
+  * estimates ``\log(det(K))`` with stochastic Lanczos quadrature (SLQ): Hutchinson's estimator,
+    ``tr(A) \approx \frac{1}{T}\sum_t w_t^T A w_t`` with random ``\pm 1`` probes ``w_t``, applied to ``A = \log(K)``.
+    Each quadratic form ``w_t^T \log(K) w_t`` is computed from the Lanczos tridiagonalization that PCG builds implicitly;
+  * estimates the trace term of the gradient, ``tr(K^-1 \pderiv{K}{\theta_k})``, with the same probes and PCG solutions.
+
+  All ``T + 1`` linear systems are solved together so that each (expensive) pass over ``K`` is shared; ``K`` is
+  regenerated from the covariance in small tiles on every pass and never stored.  So the cost is
+  ``O(N^2 * (T + 1) * num_cg_iterations)`` work with ``O(N * T)`` memory.
+
+  The probes are drawn once, at construction; so for fixed inputs the estimates are deterministic functions of the
+  hyperparameters and can be optimized by GradientDescentOptimizer (and multistarted via MultistartOptimizer) exactly
+  like LogMarginalLikelihoodEvaluator.  The estimates have variance ``O(1/T)``; the gradient is an estimate of the
+  true gradient, not the derivative of the estimated log likelihood.  Hessians are not available.
+\endrst*/
+class StochasticLogMarginalLikelihoodEvaluator final {
+ public:
+  //! string name of this log likelihood evaluator for logging
+  constexpr static char const * kName = "stochastic_log_marginal_likelihood";
+
+  using StateType = StochasticLogMarginalLikelihoodState;
+
+  /*!\rst
+    Constructs a StochasticLogMarginalLikelihoodEvaluator object.  All inputs are required; no default constructor nor copy/assignment are allowed.
+
+    \param
+      :points_sampled[dim][num_sampled]: points that have already been sampled
+      :points_sampled_value[num_sampled]: values of the already-sampled points
+      :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+      :num_probes: number of random probe vectors, ``T``, for the trace estimates (more probes => less variance)
+      :max_num_cg_iterations: maximum number of conjugate gradient iterations per solve (also bounds the Lanczos quadrature order)
+      :cg_tolerance: stop conjugate gradients once ``\|r\|_2 <= cg_tolerance * \|b\|_2`` (relative residual)
+      :uniform_generator[1]: a UniformRandomGenerator object providing the random engine for the probe vectors
+    \output
+      :uniform_generator[1]: UniformRandomGenerator object will have its state changed due to random draws
+  \endrst*/
+  StochasticLogMarginalLikelihoodEvaluator(double const * restrict points_sampled_in,
+                                           double const * restrict points_sampled_value_in,
+                                           double const * restrict noise_variance_in,
+                                           int dim_in, int num_sampled_in, int num_probes_in,
+                                           int max_num_cg_iterations_in, double cg_tolerance_in,
+                                           UniformRandomGenerator * uniform_generator) OL_NONNULL_POINTERS;
+
+  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  int num_sampled() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return num_sampled_;
+  }
+
+  int num_probes() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return num_probes_;
+  }
+
+  int max_num_cg_iterations() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return max_num_cg_iterations_;
+  }
+
+  /*!\rst
+    Wrapper for ComputeLogLikelihood(); see that function for details.
+  \endrst*/
+  double ComputeObjectiveFunction(StateType * log_likelihood_state) const noexcept OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT {
+    return ComputeLogLikelihood(*log_likelihood_state);
+  }
+
+  /*!\rst
+    Wrapper for ComputeGradLogLikelihood(); see that function for details.
+  \endrst*/
+  void ComputeGradObjectiveFunction(StateType * log_likelihood_state,
+                                    double * restrict grad_log_marginal) const noexcept OL_NONNULL_POINTERS {
+    ComputeGradLogLikelihood(log_likelihood_state, grad_log_marginal);
+  }
+
+  /*!\rst
+    Wrapper for ComputeHessianLogLikelihood(); see that function for details.
+  \endrst*/
+  void ComputeHessianObjectiveFunction(StateType * log_likelihood_state,
+                                       double * restrict hessian_log_marginal) const OL_NONNULL_POINTERS {
+    ComputeHessianLogLikelihood(log_likelihood_state, hessian_log_marginal);
+  }
+
+  /*!\rst
+    Sets up the StochasticLogMarginalLikelihoodState object so that it can be used to compute log marginal and its gradients.
+    Runs the (block) preconditioned conjugate gradient solves and the Lanczos quadrature.
+    ASSUMES all needed space is ALREADY ALLOCATED.
+
+    This function should not be called directly; instead use StochasticLogMarginalLikelihoodState::SetupState.
+
+    \param
+      :log_likelihood_state[1]: constructed state object with appropriate sized allocations
+    \output
+      :log_likelihood_state[1]: fully configured state object, ready for use by this class's member functions
+  \endrst*/
+  void FillLogLikelihoodState(StateType * log_likelihood_state) const OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Estimates the log marginal likelihood,
+    ``log p(y | X, \theta) = -\frac{1}{2} * y^T * K^-1 * y - \frac{1}{2} * \log(det(K)) - \frac{n}{2} * \log(2*pi)``.
+    ``K^-1 * y`` is computed by conjugate gradients; ``\log(det(K))`` by stochastic Lanczos quadrature.
+
+    \param
+      :log_likelihood_state: properly configured state object
+    \return
+      estimate of the natural log of the marginal likelihood of the GP model
+  \endrst*/
+  double ComputeLogLikelihood(const StateType& log_likelihood_state) const noexcept OL_WARN_UNUSED_RESULT;
+
+  /*!\rst
+    Estimates the (partial) derivatives of the log marginal likelihood with respect to each hyperparameter of our covariance function.
+
+    Let ``n_hyper = covariance_ptr->GetNumberOfHyperparameters();``
+
+    \param
+      :log_likelihood_state[1]: properly configured state object
+    \output
+      :log_likelihood_state[1]: state with temporary storage modified
+      :grad_log_marginal[n_hyper]: estimated gradient of log marginal likelihood wrt each hyperparameter of covariance
+  \endrst*/
+  void ComputeGradLogLikelihood(StateType * log_likelihood_state,
+                                double * restrict grad_log_marginal) const noexcept OL_NONNULL_POINTERS;
+
+  /*!\rst
+    NOT IMPLEMENTED.
+    Exists so that this class can be used with generic (Newton-capable) optimization templates; see
+    LeaveOneOutLogLikelihoodEvaluator::ComputeHessianLogLikelihood().
+  \endrst*/
+  void ComputeHessianLogLikelihood(StateType * log_likelihood_state,
+                                   double * restrict hessian_log_marginal) const OL_NONNULL_POINTERS;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(StochasticLogMarginalLikelihoodEvaluator);
+
+ private:
+  /*!\rst
+    Solves ``K x_v = b_v`` for ``y`` and every probe at once with Jacobi-preconditioned conjugate gradients,
+    recording the CG step lengths (``\alpha_j``) and direction updates (``\beta_j``) for the Lanczos quadrature.
+
+    \param
+      :log_likelihood_state[1]: state with covariance_ptr and preconditioner set
+    \output
+      :log_likelihood_state[1]: state with cg_solution, cg_alpha, cg_beta, and cg_num_iterations filled
+  \endrst*/
+  void SolveWithPreconditionedConjugateGradients(StateType * log_likelihood_state) const noexcept OL_NONNULL_POINTERS;
+
+  // size information
+  //! spatial dimension (e.g., entries per point of points_sampled)
+  const int dim_;
+  //! number of points in points_sampled
+  int num_sampled_;
+  //! number of Hutchinson probe vectors, ``T``
+  int num_probes_;
+  //! maximum number of conjugate gradient iterations per solve
+  int max_num_cg_iterations_;
+  //! relative residual at which conjugate gradients stops
+  double cg_tolerance_;
+
+  // state variables
+  //! coordinates of already-sampled points, ``X``
+  std::vector<double> points_sampled_;
+  //! function values at points_sampled, ``y``
+  std::vector<double> points_sampled_value_;
+  //! ``\sigma_n^2``, the noise variance
+  std::vector<double> noise_variance_;
+  //! Hutchinson probes ``w_t``, entries ``\pm 1``; ordered as ``probes[num_probes][num_sampled]`` (probe index varies fastest)
+  std::vector<double> probes_;
+};
+
+/*!\rst
+  State object for StochasticLogMarginalLikelihoodEvaluator.  This object tracks the covariance object as well as derived quantities
+  that (along with the training points/values in the Evaluator class) fully specify the log marginal likelihood estimate.  Since this
+  is used to optimize the log marginal likelihood, the covariance's hyperparameters are variable.
+
+  Nothing here is ``O(N^2)``; the largest members are ``O(N * num_probes)``.
+
+  See general comments on State structs in gpp_common.hpp's header docs.
+\endrst*/
+struct StochasticLogMarginalLikelihoodState final {
+  using EvaluatorType = StochasticLogMarginalLikelihoodEvaluator;
+
+  /*!\rst
+    Constructs a StochasticLogMarginalLikelihoodState object with a specified covariance object (in particular, new hyperparameters).
+    Ensures all state variables & temporaries are properly sized.
+    Properly sets all state variables so that the Evaluator can be used to compute log marginal likelihood, gradients, etc.
+
+    .. WARNING:: This object's state is INVALIDATED if the log_likelihood_eval used in construction is mutated!
+      SetupState() should be called again in such a situation.
+
+    \param
+      :log_likelihood_eval: StochasticLogMarginalLikelihoodEvaluator object that this state is being used with
+      :covariance_in: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
+  \endrst*/
+  StochasticLogMarginalLikelihoodState(const EvaluatorType& log_likelihood_eval, const CovarianceInterface& covariance_in);
+
+  StochasticLogMarginalLikelihoodState(StochasticLogMarginalLikelihoodState&& other);
+
+  int GetProblemSize() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return num_hyperparameters;
+  }
+
+  void SetCurrentPoint(const EvaluatorType& log_likelihood_eval,
+                       double const * restrict hyperparameters) OL_NONNULL_POINTERS {
+    SetHyperparameters(log_likelihood_eval, hyperparameters);
+  }
+
+  void GetCurrentPoint(double * restrict hyperparameters) OL_NONNULL_POINTERS {
+    GetHyperparameters(hyperparameters);
+  }
+
+  /*!\rst
+    Get hyperparameters of underlying covariance function.
+
+    \output
+      :hyperparameters[num_hyperparameters]: covariance's hyperparameters
+  \endrst*/
+  void GetHyperparameters(double * restrict hyperparameters) const noexcept OL_NONNULL_POINTERS {
+    covariance_ptr->GetHyperparameters(hyperparameters);
+  }
+
+  /*!\rst
+    Change the hyperparameters of the underlying covariance function.
+    Update the state's derived quantities to be consistent with the new hyperparameters.
+
+    \param
+      :log_likelihood_eval: StochasticLogMarginalLikelihoodEvaluator object that this state is being used with
+      :hyperparameters[num_hyperparameters]: hyperparameters to change to
+  \endrst*/
+  void SetHyperparameters(const EvaluatorType& log_likelihood_eval,
+                          double const * restrict hyperparameters) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Configures this state object with new hyperparameters.
+    Ensures all state variables & temporaries are properly sized.
+    Properly sets all state variables for log likelihood (+ gradient) evaluation.
+
+    .. WARNING:: This object's state is INVALIDATED if the log_likelihood used in SetupState is mutated!
+      SetupState() should be called again in such a situation.
+
+    \param
+      :log_likelihood_eval: log likelihood evaluator object that describes the training/already-measured data
+      :hyperparameters[num_hyperparameters]: hyperparameters to change to
+  \endrst*/
+  void SetupState(const EvaluatorType& log_likelihood_eval,
+                  double const * restrict hyperparameters) OL_NONNULL_POINTERS;
+
+  // size information
+  //! spatial dimension (e.g., entries per point of points_sampled)
+  const int dim;
+  //! number of points in points_sampled
+  int num_sampled;
+  //! number of hyperparameters of covariance; i.e., covariance_ptr->GetNumberOfHyperparameters()
+  int num_hyperparameters;
+  //! number of Hutchinson probe vectors, ``T``
+  int num_probes;
+  //! maximum number of conjugate gradient iterations per solve
+  int max_num_cg_iterations;
+
+  // state variables
+  //! covariance class (for computing covariance and its gradients)
+  std::unique_ptr<CovarianceInterface> covariance_ptr;
+
+  // derived variables
+  //! ``P = diag(K)``, the Jacobi preconditioner
+  std::vector<double> preconditioner;
+  //! ``P^{-1/2} w_t``; ordered as ``[num_probes][num_sampled]``
+  std::vector<double> scaled_probes;
+  //! PCG solutions ``[K^-1 y, K^-1 P^{1/2} w_1, ..., K^-1 P^{1/2} w_T]``; ordered as ``[num_probes+1][num_sampled]``
+  std::vector<double> cg_solution;
+  //! estimate of ``\log(det(K))``
+  double log_determinant;
+
+  // temporary storage: preallocated space used by StochasticLogMarginalLikelihoodEvaluator's member functions
+  //! CG residuals, ``r_v``; ordered as ``[num_probes+1][num_sampled]``
+  std::vector<double> cg_residual;
+  //! preconditioned CG residuals, ``P^-1 r_v``; ordered as ``[num_probes+1][num_sampled]``
+  std::vector<double> cg_preconditioned_residual;
+  //! CG search directions, ``p_v``; ordered as ``[num_probes+1][num_sampled]``
+  std::vector<double> cg_search_direction;
+  //! ``K p_v``; ordered as ``[num_probes+1][num_sampled]``
+  std::vector<double> cg_covariance_times_search_direction;
+  //! CG step lengths, ``\alpha_j``, of each system; ordered as ``[max_num_cg_iterations][num_probes+1]``
+  std::vector<double> cg_alpha;
+  //! CG direction updates, ``\beta_j``, of each system; ordered as ``[max_num_cg_iterations][num_probes+1]``
+  std::vector<double> cg_beta;
+  //! number of CG iterations taken by each system
+  std::vector<int> cg_num_iterations;
+  //! one ``kLogMarginalGradientTileSize^2`` tile of ``K``
+  std::vector<double> cov_tile;
+  //! one ``kLogMarginalGradientTileSize^2`` tile of ``\pderiv{K_{ij}}{\theta_k}`` for each hyperparameter
+  std::vector<double> grad_hyperparameter_cov_tile;
+  //! Lanczos tridiagonal matrix (diagonal, then sub-diagonal) and eigenvector components; ``3 * max_num_cg_iterations`` entries
+  std::vector<double> lanczos_temp;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(StochasticLogMarginalLikelihoodState);
+};
+
 /*!\rst
   Converts ``domain_bounds`` input from ``log10``-space to linear-space.
   Uniformly samples ``num_multistarts`` initial guesses from the ``log10``-space domain and converts them all to linear space.
@@ -980,7 +1380,8 @@ OL_NONNULL_POINTERS void RestartedGradientDescentHyperparameterOptimization(
   Let ``n_hyper = covariance_ptr->GetNumberOfHyperparameters();``
 
   \param
-    :log_likelihood_evaluator: object supporting evaluation of gradient + hessian of log likelihood
+    :log_likelihood_evaluator: object supporting evaluation of gradient + hessian of log likelihood; every start uses
+      its compute options (e.g., LeaveOneOutComputeTypes), since the per-thread states are built from it
     :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
     :gd_parameters: GradientDescentParameters object that describes the parameters controlling hyperparameter optimization (e.g., number
       of iterations, tolerances, learning rate)
@@ -1179,6 +1580,100 @@ OL_NONNULL_POINTERS void MultistartNewtonHyperparameterOptimization(
   std::copy(io_container.best_point.begin(), io_container.best_point.end(), next_hyperparameters);
 }
 
+/*!\rst
+  Function to add multistarting on top of (projected) L-BFGS hyperparameter optimization.
+  Generates ``num_multistarts`` initial guesses (random sampling from domain), all within the specified domain, and kicks off
+  an optimization run from each guess.
+
+  Same setup as MultistartNewtonHyperparameterOptimization(); the only difference is the optimizer:
+
+  * The heart of multistarting is in MultistartOptimizer<...>::MultistartOptimize<...>(...) (in gpp_optimization.hpp).
+
+    * The heart of L-BFGS is in LBFGSOptimization() (in gpp_optimization.hpp).
+    * Log likelihood is computed in ComputeLogLikelihood() and its gradient in ComputeGradLogLikelihood(), which must
+      be member functions of the LogLikelihoodEvaluator template parameter.  No hessian is needed.
+
+  Solution is guaranteed to lie within the region specified by "domain"; note that this may not be a
+  true optima (i.e., the gradient may be substantially nonzero).
+
+  .. WARNING:: this function fails if NO improvement can be found!  In that case,
+    ``best_next_point`` will always be the first randomly chosen point.
+    ``found_flag`` will be set to false in this case.
+
+  .. Note:: the domain here must be specified in LOG-10 SPACE!
+
+  Let ``n_hyper = covariance.GetNumberOfHyperparameters();``
+
+  \param
+    :log_likelihood_evaluator: object supporting evaluation of log likelihood and its gradient
+    :covariance: the CovarianceFunction object encoding assumptions about the GP's behavior on our data
+    :lbfgs_parameters: LBFGSParameters object that describes the parameters controlling hyperparameter optimization (e.g.,
+      number of iterations, history size, tolerance)
+    :adaptive_parameters: AdaptiveMultistartParameters to screen the starts with a few L-BFGS steps and fully optimize only
+      the best survivors (see MultistartOptimizer<...>::MultistartOptimizeAdaptive()); nullptr to optimize every start fully
+    :domain[n_hyper]: array of ClosedInterval specifying the boundaries of a n_hyper-dimensional tensor-product domain.
+      Specify in LOG-10 SPACE!
+    :thread_schedule: struct instructing OpenMP on how to schedule threads; i.e., (suggestions in parens)
+      max_num_threads (num cpu cores), schedule type (omp_sched_dynamic), chunk_size (0).
+    :uniform_generator[1]: a UniformRandomGenerator object providing the random engine for uniform random numbers
+  \output
+    :found_flag[1]: true if next_hyperparameters corresponds to a converged solution
+    :uniform_generator[1]: UniformRandomGenerator object will have its state changed due to random draws
+    :next_hyperparameters[n_hyper]: the new hyperparameters found by L-BFGS
+\endrst*/
+template <typename LogLikelihoodEvaluator>
+OL_NONNULL_POINTERS_LIST(5, 7, 8, 9) void MultistartLBFGSHyperparameterOptimization(
+    const LogLikelihoodEvaluator& log_likelihood_evaluator,
+    const CovarianceInterface& covariance,
+    const LBFGSParameters& lbfgs_parameters,
+    AdaptiveMultistartParameters const * adaptive_parameters,
+    ClosedInterval const * restrict domain,
+    const ThreadSchedule& thread_schedule,
+    bool * restrict found_flag,
+    UniformRandomGenerator * uniform_generator,
+    double * restrict next_hyperparameters) {
+  if (unlikely(lbfgs_parameters.num_multistarts <= 0)) {
+    OL_THROW_EXCEPTION(LowerBoundException<int>, "num_multistarts must be > 1", lbfgs_parameters.num_multistarts, 1);
+  }
+
+  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+  std::vector<double> initial_guesses(num_hyperparameters*lbfgs_parameters.num_multistarts);
+  std::vector<ClosedInterval> domain_linearspace_bounds(domain, domain + num_hyperparameters);
+  ConvertFromLogToLinearDomainAndBuildInitialGuesses(num_hyperparameters, lbfgs_parameters.num_multistarts,
+                                                     uniform_generator, &domain_linearspace_bounds, &initial_guesses);
+
+  TensorProductDomain domain_linearspace(domain_linearspace_bounds.data(), num_hyperparameters);
+
+  // we need 1 state object per thread
+  std::vector<typename LogLikelihoodEvaluator::StateType> log_likelihood_state_vector;
+  SetupLogLikelihoodState(log_likelihood_evaluator, covariance, thread_schedule.max_num_threads,
+                          &log_likelihood_state_vector);
+
+  OptimizationIOContainer io_container(log_likelihood_state_vector[0].GetProblemSize());
+  InitializeBestKnownPoint(log_likelihood_evaluator, initial_guesses.data(), num_hyperparameters,
+                           lbfgs_parameters.num_multistarts, log_likelihood_state_vector.data(), &io_container);
+
+  LBFGSOptimizer<LogLikelihoodEvaluator, TensorProductDomain> lbfgs_opt;
+  MultistartOptimizer<LBFGSOptimizer<LogLikelihoodEvaluator, TensorProductDomain> > multistart_optimizer;
+  if (adaptive_parameters == nullptr) {
+    multistart_optimizer.MultistartOptimize(lbfgs_opt, log_likelihood_evaluator, lbfgs_parameters,
+                                            domain_linearspace, thread_schedule, initial_guesses.data(),
+                                            lbfgs_parameters.num_multistarts,
+                                            log_likelihood_state_vector.data(),
+                                            nullptr, &io_container);
+  } else {
+    LBFGSParameters screening_parameters(LBFGSScreeningParameters(lbfgs_parameters, *adaptive_parameters));
+    multistart_optimizer.MultistartOptimizeAdaptive(lbfgs_opt, log_likelihood_evaluator, screening_parameters,
+                                                    lbfgs_parameters, *adaptive_parameters, domain_linearspace,
+                                                    thread_schedule, initial_guesses.data(),
+                                                    lbfgs_parameters.num_multistarts,
+                                                    log_likelihood_state_vector.data(), nullptr, &io_container);
+  }
+
+  *found_flag = io_container.found_flag;
+  std::copy(io_container.best_point.begin(), io_container.best_point.end(), next_hyperparameters);
+}
+
 /*!\rst
   Function to evaluate various log likelihood measures over a specified list of num_multistarts hyperparameters.
   Optionally outputs the log likelihood at each of these hyperparameters.
@@ -11,6 +11,7 @@
         log likelihood + gradient or log likelihood gradient + hessian (derivs wrt hyperparameters).
      b. Ping for derivative accuracy (PingLogLikelihoodTest, which is general enough for gradients and hessian); this is
         for derivatives wrt hyperparameters.  These are for unit testing analytic derivatives.
+     c. StochasticLogMarginalLikelihoodEvaluator is checked against the exact log marginal likelihood (and its optimum).
 
   2. Gradient Descent + Newton unit tests: using polynomials and other simple fucntions with analytically known optima
      to verify that the optimizers are performing correctly.
@@ -27,6 +28,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -37,6 +39,7 @@
 #include "gpp_covariance.hpp"
 #include "gpp_domain.hpp"
 #include "gpp_exception.hpp"
+#include "gpp_linear_algebra.hpp"
 #include "gpp_logging.hpp"
 #include "gpp_math.hpp"
 #include "gpp_mock_optimization_objective_functions.hpp"
@@ -263,6 +266,385 @@ OL_WARN_UNUSED_RESULT int PingLogLikelihoodTest(char const * class_name, int num
   return total_errors;
 }
 
+/*!\rst
+  Checks that LeaveOneOutComputeTypes::kCholeskyDowndate matches a direct LOO computation (building a new GP with
+  each point removed) and that both the LOO-CV likelihood and its gradient match LeaveOneOutComputeTypes::kMatrixInverse.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int LeaveOneOutCholeskyDowndateTest() {
+  int total_errors = 0;
+  const int dim = 3;
+  const int num_sampled = 25;
+
+  UniformRandomGenerator uniform_generator(9173);
+  boost::uniform_real<double> uniform_double(-1.0, 1.0);
+  boost::uniform_real<double> uniform_double_noise(0.001, 0.1);
+  RandomGaussianProcessData gp_data(dim, num_sampled, 0, 0, 0.0, uniform_double, &uniform_generator);
+  for (auto& entry : gp_data.noise_variance) {
+    entry = uniform_double_noise(uniform_generator.engine);
+  }
+
+  std::vector<double> lengths = {0.4, 0.7, 1.1};
+  SquareExponential covariance(dim, 1.3, lengths.data());
+  LeaveOneOutLogLikelihoodEvaluator loo_eval_inverse(gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                                     gp_data.noise_variance.data(), dim, num_sampled,
+                                                     LeaveOneOutComputeTypes::kMatrixInverse);
+  LeaveOneOutLogLikelihoodEvaluator loo_eval_downdate(gp_data.points_sampled.data(),
+                                                      gp_data.points_sampled_value.data(),
+                                                      gp_data.noise_variance.data(), dim, num_sampled,
+                                                      LeaveOneOutComputeTypes::kCholeskyDowndate);
+  LeaveOneOutLogLikelihoodState loo_state_inverse(loo_eval_inverse, covariance);
+  LeaveOneOutLogLikelihoodState loo_state_downdate(loo_eval_downdate, covariance);
+
+  // direct computation: remove each point from the training set, build a GP, and predict (with noise) the removed point
+  double loo_direct = 0.0;
+  std::vector<double> points_sampled_loo(dim*(num_sampled - 1));
+  std::vector<double> points_sampled_value_loo(num_sampled - 1);
+  std::vector<double> noise_variance_loo(num_sampled - 1);
+  for (int i = 0; i < num_sampled; ++i) {
+    for (int j = 0, j_loo = 0; j < num_sampled; ++j) {
+      if (j != i) {
+        std::copy(gp_data.points_sampled.begin() + j*dim, gp_data.points_sampled.begin() + (j + 1)*dim,
+                  points_sampled_loo.begin() + j_loo*dim);
+        points_sampled_value_loo[j_loo] = gp_data.points_sampled_value[j];
+        noise_variance_loo[j_loo] = gp_data.noise_variance[j];
+        ++j_loo;
+      }
+    }
+    GaussianProcess gaussian_process(covariance, points_sampled_loo.data(), points_sampled_value_loo.data(),
+                                     noise_variance_loo.data(), dim, num_sampled - 1);
+    PointsToSampleState points_to_sample_state(gaussian_process, gp_data.points_sampled.data() + i*dim, 1, 0);
+    double mean, variance;
+    gaussian_process.ComputeMeanOfPoints(points_to_sample_state, &mean);
+    gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, &variance);
+    variance += gp_data.noise_variance[i];
+
+    if (!CheckDoubleWithinRelative(loo_state_downdate.loo_variance[i], variance, 1.0e-12)) {
+      ++total_errors;
+    }
+    if (!CheckDoubleWithinRelative(loo_state_downdate.loo_residual[i], gp_data.points_sampled_value[i] - mean,
+                                   1.0e-11)) {
+      ++total_errors;
+    }
+    loo_direct += -0.5*std::log(variance) - 0.5*Square(gp_data.points_sampled_value[i] - mean)/variance - 0.5*kLog2Pi;
+  }
+
+  double loo_inverse = loo_eval_inverse.ComputeLogLikelihood(loo_state_inverse);
+  double loo_downdate = loo_eval_downdate.ComputeLogLikelihood(loo_state_downdate);
+  if (!CheckDoubleWithinRelative(loo_downdate, loo_direct, 1.0e-12)) {
+    ++total_errors;
+  }
+  if (!CheckDoubleWithinRelative(loo_downdate, loo_inverse, 1.0e-10)) {
+    ++total_errors;
+  }
+
+  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+  std::vector<double> grad_loo_inverse(num_hyperparameters);
+  std::vector<double> grad_loo_downdate(num_hyperparameters);
+  loo_eval_inverse.ComputeGradLogLikelihood(&loo_state_inverse, grad_loo_inverse.data());
+  loo_eval_downdate.ComputeGradLogLikelihood(&loo_state_downdate, grad_loo_downdate.data());
+  for (int i = 0; i < num_hyperparameters; ++i) {
+    if (!CheckDoubleWithinRelative(grad_loo_downdate[i], grad_loo_inverse[i], 1.0e-10)) {
+      ++total_errors;
+    }
+  }
+
+  // the downdate never forms K^-1
+  if (!loo_state_downdate.K_inv.empty()) {
+    ++total_errors;
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("leave one out cholesky downdate failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("leave one out cholesky downdate passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that LogMarginalLikelihoodGradientTypes::kStreaming produces the same gradient (and hessian) as kFullTensor,
+  and that the (tiled) hessian matches a dense computation.
+  ``num_sampled`` is not a multiple of kLogMarginalGradientTileSize so that partial tiles are exercised.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int LogMarginalLikelihoodStreamingGradientTest() {
+  int total_errors = 0;
+  const int dim = 3;
+  const int num_sampled = 2*kLogMarginalGradientTileSize + 7;
+
+  UniformRandomGenerator uniform_generator(4217);
+  boost::uniform_real<double> uniform_double(-1.0, 1.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, 0, 0, 0.01, uniform_double, &uniform_generator);
+
+  std::vector<double> lengths = {0.6, 0.9, 1.2};
+  SquareExponential covariance(dim, 1.3, lengths.data());
+  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+  LogMarginalLikelihoodEvaluator log_marginal_eval_full(gp_data.points_sampled.data(),
+                                                        gp_data.points_sampled_value.data(),
+                                                        gp_data.noise_variance.data(), dim, num_sampled,
+                                                        LogMarginalLikelihoodGradientTypes::kFullTensor);
+  LogMarginalLikelihoodEvaluator log_marginal_eval_streaming(gp_data.points_sampled.data(),
+                                                             gp_data.points_sampled_value.data(),
+                                                             gp_data.noise_variance.data(), dim, num_sampled,
+                                                             LogMarginalLikelihoodGradientTypes::kStreaming);
+  LogMarginalLikelihoodState log_marginal_state_full(log_marginal_eval_full, covariance);
+  LogMarginalLikelihoodState log_marginal_state_streaming(log_marginal_eval_streaming, covariance);
+
+  // streaming mode does not allocate the full dK/d\theta tensor
+  if (!log_marginal_state_streaming.grad_hyperparameter_cov_matrix.empty()) {
+    ++total_errors;
+  }
+
+  std::vector<double> grad_full(num_hyperparameters);
+  std::vector<double> grad_streaming(num_hyperparameters);
+  log_marginal_eval_full.ComputeGradLogLikelihood(&log_marginal_state_full, grad_full.data());
+  log_marginal_eval_streaming.ComputeGradLogLikelihood(&log_marginal_state_streaming, grad_streaming.data());
+  for (int i = 0; i < num_hyperparameters; ++i) {
+    if (!CheckDoubleWithinRelative(grad_streaming[i], grad_full[i], 1.0e-10)) {
+      ++total_errors;
+    }
+  }
+
+  std::vector<double> hessian_full(Square(num_hyperparameters));
+  std::vector<double> hessian_streaming(Square(num_hyperparameters));
+  log_marginal_eval_full.ComputeHessianLogLikelihood(&log_marginal_state_full, hessian_full.data());
+  log_marginal_eval_streaming.ComputeHessianLogLikelihood(&log_marginal_state_streaming, hessian_streaming.data());
+  for (int i = 0; i < Square(num_hyperparameters); ++i) {
+    if (!CheckDoubleWithinRelative(hessian_streaming[i], hessian_full[i], 1.0e-14)) {
+      ++total_errors;
+    }
+  }
+
+  // the hessian is always tiled; check it against a dense reference built from every \pderiv{K}{\theta_k},
+  // \mixpderiv{K}{\theta_k}{\theta_l}, and K^-1
+  const int num_cov_elem = Square(num_sampled);
+  std::vector<double> grad_cov(num_hyperparameters*num_cov_elem);
+  std::vector<double> hessian_cov(Square(num_hyperparameters)*num_cov_elem);
+  std::vector<double> grad_hyperparameters(num_hyperparameters);
+  std::vector<double> hessian_hyperparameters(Square(num_hyperparameters));
+  const int outputs = CovarianceInterface::kHyperparameterGradient | CovarianceInterface::kHyperparameterHessian;
+  for (int i = 0; i < num_sampled; ++i) {
+    for (int j = 0; j < num_sampled; ++j) {
+      covariance.CovarianceWithDerivatives(gp_data.points_sampled.data() + i*dim,
+                                           gp_data.points_sampled.data() + j*dim, outputs, nullptr,
+                                           grad_hyperparameters.data(), hessian_hyperparameters.data());
+      for (int k = 0; k < num_hyperparameters; ++k) {
+        grad_cov[k*num_cov_elem + i*num_sampled + j] = grad_hyperparameters[k];
+      }
+      for (int k = 0; k < Square(num_hyperparameters); ++k) {
+        hessian_cov[k*num_cov_elem + i*num_sampled + j] = hessian_hyperparameters[k];
+      }
+    }
+  }
+  std::vector<double> K_inv(num_cov_elem);
+  SPDMatrixInverse(log_marginal_state_full.K_chol.data(), num_sampled, K_inv.data());
+  const std::vector<double>& K_inv_y = log_marginal_state_full.K_inv_y;
+
+  // K_inv_grad_cov[k] = K^-1 * \pderiv{K}{\theta_k}; grad_cov_K_inv_y[k] = \pderiv{K}{\theta_k} * \alpha
+  std::vector<double> K_inv_grad_cov(num_hyperparameters*num_cov_elem, 0.0);
+  std::vector<double> grad_cov_K_inv_y(num_hyperparameters*num_sampled, 0.0);
+  for (int k = 0; k < num_hyperparameters; ++k) {
+    for (int i = 0; i < num_sampled; ++i) {
+      for (int j = 0; j < num_sampled; ++j) {
+        grad_cov_K_inv_y[k*num_sampled + i] += grad_cov[k*num_cov_elem + i*num_sampled + j]*K_inv_y[j];
+        for (int l = 0; l < num_sampled; ++l) {
+          K_inv_grad_cov[k*num_cov_elem + i*num_sampled + j] +=
+              K_inv[i*num_sampled + l]*grad_cov[k*num_cov_elem + l*num_sampled + j];
+        }
+      }
+    }
+  }
+
+  for (int k = 0; k < num_hyperparameters; ++k) {
+    for (int l = 0; l < num_hyperparameters; ++l) {
+      double hessian_dense = 0.0;
+      for (int i = 0; i < num_sampled; ++i) {
+        for (int j = 0; j < num_sampled; ++j) {
+          // -\alpha * \pderiv{K}{\theta_k} * K^-1 * \pderiv{K}{\theta_l} * \alpha
+          hessian_dense -= grad_cov_K_inv_y[k*num_sampled + i]*K_inv[i*num_sampled + j] *
+              grad_cov_K_inv_y[l*num_sampled + j];
+          // 0.5 * \alpha * \mixpderiv{K}{\theta_k}{\theta_l} * \alpha - 0.5 * tr(K^-1 * \mixpderiv{K}{\theta_k}{\theta_l})
+          hessian_dense += 0.5*(K_inv_y[i]*K_inv_y[j] - K_inv[i*num_sampled + j]) *
+              hessian_cov[(k*num_hyperparameters + l)*num_cov_elem + i*num_sampled + j];
+          // 0.5 * tr(K^-1 * \pderiv{K}{\theta_k} * K^-1 * \pderiv{K}{\theta_l})
+          hessian_dense += 0.5*K_inv_grad_cov[k*num_cov_elem + i*num_sampled + j] *
+              K_inv_grad_cov[l*num_cov_elem + j*num_sampled + i];
+        }
+      }
+      if (!CheckDoubleWithinRelative(hessian_full[k*num_hyperparameters + l], hessian_dense, 1.0e-10)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("streaming log marginal gradient failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("streaming log marginal gradient passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks StochasticLogMarginalLikelihoodEvaluator against the exact LogMarginalLikelihoodEvaluator:
+
+  1. conjugate gradients reproduces ``K^-1 y``
+  2. with many probes, the log likelihood and gradient estimates agree with the exact values to within their
+     statistical error (the probes are fixed by the seed, so this test is deterministic)
+  3. multistarted gradient descent (MultistartGradientDescentHyperparameterOptimization) on the estimate, using few
+     probes, improves the exact log marginal likelihood to nearly its optimal value
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int StochasticLogMarginalLikelihoodTest() {
+  int total_errors = 0;
+  int current_errors = 0;
+
+  {
+    const int dim = 3;
+    const int num_sampled = 2*kLogMarginalGradientTileSize + 7;
+    const int num_probes = 1000;
+
+    UniformRandomGenerator uniform_generator(4217);
+    boost::uniform_real<double> uniform_double(-1.0, 1.0);
+    RandomGaussianProcessData gp_data(dim, num_sampled, 0, 0, 0.1, uniform_double, &uniform_generator);
+
+    std::vector<double> lengths = {0.6, 0.9, 1.2};
+    SquareExponential covariance(dim, 1.3, lengths.data());
+    const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+    LogMarginalLikelihoodEvaluator log_marginal_eval(gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                                     gp_data.noise_variance.data(), dim, num_sampled);
+    StochasticLogMarginalLikelihoodEvaluator stochastic_log_marginal_eval(gp_data.points_sampled.data(),
+                                                                          gp_data.points_sampled_value.data(),
+                                                                          gp_data.noise_variance.data(), dim,
+                                                                          num_sampled, num_probes, num_sampled, 1.0e-12,
+                                                                          &uniform_generator);
+    LogMarginalLikelihoodState log_marginal_state(log_marginal_eval, covariance);
+    StochasticLogMarginalLikelihoodState stochastic_log_marginal_state(stochastic_log_marginal_eval, covariance);
+
+    current_errors = 0;
+    for (int i = 0; i < num_sampled; ++i) {
+      if (!CheckDoubleWithinRelative(stochastic_log_marginal_state.cg_solution[i*(num_probes + 1)],
+                                     log_marginal_state.K_inv_y[i], 1.0e-8)) {
+        ++current_errors;
+      }
+    }
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("stochastic log marginal: conjugate gradient K^-1 y failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+
+    // Hutchinson's estimates have standard deviation O(1/sqrt(num_probes)); these tolerances are several of those
+    current_errors = 0;
+    const double log_likelihood = log_marginal_eval.ComputeLogLikelihood(log_marginal_state);
+    const double stochastic_log_likelihood = stochastic_log_marginal_eval.ComputeLogLikelihood(stochastic_log_marginal_state);
+    if (!CheckDoubleWithinRelative(stochastic_log_likelihood, log_likelihood, 1.0e-2)) {
+      ++current_errors;
+    }
+
+    std::vector<double> grad_log_marginal(num_hyperparameters);
+    std::vector<double> stochastic_grad_log_marginal(num_hyperparameters);
+    log_marginal_eval.ComputeGradLogLikelihood(&log_marginal_state, grad_log_marginal.data());
+    stochastic_log_marginal_eval.ComputeGradLogLikelihood(&stochastic_log_marginal_state,
+                                                          stochastic_grad_log_marginal.data());
+    const double grad_tolerance = 2.0e-2*VectorNorm(grad_log_marginal.data(), num_hyperparameters);
+    for (int i = 0; i < num_hyperparameters; ++i) {
+      if (!CheckDoubleWithin(stochastic_grad_log_marginal[i], grad_log_marginal[i], grad_tolerance)) {
+        ++current_errors;
+      }
+    }
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("stochastic log marginal: estimates failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    using DomainType = TensorProductDomain;
+    const int dim = 2;
+    const int num_sampled = 40;
+    const int num_probes = 32;
+
+    UniformRandomGenerator uniform_generator(3141);
+    boost::uniform_real<double> uniform_double_hyperparameter(1.0, 2.5);
+    boost::uniform_real<double> uniform_double_lower_bound(-2.0, 0.5);
+    boost::uniform_real<double> uniform_double_upper_bound(1.5, 2.7);
+
+    std::vector<double> noise_variance(num_sampled, 0.1);
+    MockGaussianProcessPriorData<DomainType> mock_gp_data(SquareExponential(dim, 1.0, 1.0), noise_variance, dim,
+                                                          num_sampled, uniform_double_lower_bound,
+                                                          uniform_double_upper_bound,
+                                                          uniform_double_hyperparameter, &uniform_generator);
+    const int num_hyperparameters = mock_gp_data.covariance_ptr->GetNumberOfHyperparameters();
+
+    LogMarginalLikelihoodEvaluator log_marginal_eval(mock_gp_data.gaussian_process_ptr->points_sampled().data(),
+                                                     mock_gp_data.gaussian_process_ptr->points_sampled_value().data(),
+                                                     mock_gp_data.gaussian_process_ptr->noise_variance().data(),
+                                                     dim, num_sampled);
+    StochasticLogMarginalLikelihoodEvaluator stochastic_log_marginal_eval(
+        mock_gp_data.gaussian_process_ptr->points_sampled().data(),
+        mock_gp_data.gaussian_process_ptr->points_sampled_value().data(),
+        mock_gp_data.gaussian_process_ptr->noise_variance().data(),
+        dim, num_sampled, num_probes, num_sampled, 1.0e-6, &uniform_generator);
+    LogMarginalLikelihoodState log_marginal_state(log_marginal_eval, *mock_gp_data.covariance_ptr);
+    const double initial_likelihood = log_marginal_eval.ComputeLogLikelihood(log_marginal_state);
+
+    const int num_multistarts = 4;
+    GradientDescentParameters gd_parameters(num_multistarts, 100, 2, 0, 0.5, 0.5, 0.02, 1.0e-7);
+    ThreadSchedule thread_schedule(4, omp_sched_dynamic);
+    std::vector<ClosedInterval> hyperparameter_log_domain_bounds(num_hyperparameters, {-1.0, 1.0});
+    std::vector<double> hyperparameters_exact(num_hyperparameters);
+    std::vector<double> hyperparameters_stochastic(num_hyperparameters);
+    bool found_flag = false;
+
+    UniformRandomGenerator multistart_uniform_generator(2718);
+    MultistartGradientDescentHyperparameterOptimization(log_marginal_eval, *mock_gp_data.covariance_ptr, gd_parameters,
+                                                        hyperparameter_log_domain_bounds.data(), thread_schedule,
+                                                        &found_flag, &multistart_uniform_generator,
+                                                        hyperparameters_exact.data());
+    multistart_uniform_generator.SetExplicitSeed(2718);
+    MultistartGradientDescentHyperparameterOptimization(stochastic_log_marginal_eval, *mock_gp_data.covariance_ptr,
+                                                        gd_parameters, hyperparameter_log_domain_bounds.data(),
+                                                        thread_schedule, &found_flag, &multistart_uniform_generator,
+                                                        hyperparameters_stochastic.data());
+
+    log_marginal_state.SetHyperparameters(log_marginal_eval, hyperparameters_exact.data());
+    const double exact_optimized_likelihood = log_marginal_eval.ComputeLogLikelihood(log_marginal_state);
+    log_marginal_state.SetHyperparameters(log_marginal_eval, hyperparameters_stochastic.data());
+    const double stochastic_optimized_likelihood = log_marginal_eval.ComputeLogLikelihood(log_marginal_state);
+    OL_VERBOSE_PRINTF("likelihood: initial %.18E, exact optimum %.18E, stochastic optimum %.18E\n",
+                      initial_likelihood, exact_optimized_likelihood, stochastic_optimized_likelihood);
+
+    current_errors = 0;
+    if (stochastic_optimized_likelihood <= initial_likelihood) {
+      ++current_errors;
+    }
+    if (!CheckDoubleWithinRelative(stochastic_optimized_likelihood, exact_optimized_likelihood, 2.0e-2)) {
+      ++current_errors;
+    }
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("stochastic log marginal: optimization failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("stochastic log marginal failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("stochastic log marginal passed\n");
+  }
+
+  return total_errors;
+}
+
 }  // end unnamed namespace
 
 int RunLogLikelihoodPingTests() {
@@ -314,6 +696,30 @@ int RunLogLikelihoodPingTests() {
     total_errors += current_errors;
   }
 
+  {
+    current_errors = LogMarginalLikelihoodStreamingGradientTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("streaming log marginal gradient failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = StochasticLogMarginalLikelihoodTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("stochastic log marginal failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
+  {
+    current_errors = LeaveOneOutCholeskyDowndateTest();
+    if (current_errors != 0) {
+      OL_PARTIAL_FAILURE_PRINTF("leave one out cholesky downdate failed with %d errors\n", current_errors);
+    }
+    total_errors += current_errors;
+  }
+
   if (total_errors != 0) {
     OL_PARTIAL_FAILURE_PRINTF("Pinging GP functions failed with %d errors\n\n", total_errors);
   } else {
@@ -823,6 +1229,303 @@ OL_WARN_UNUSED_RESULT int MultistartHyperparameterLikelihoodNewtonOptimizationTe
   return total_errors;
 }
 
+/*!\rst
+  Tests multistarted (projected) L-BFGS optimization for hyperparameters, i.e., MultistartOptimizer<LBFGSOptimizer<...>>
+  on a log likelihood evaluator.  Uses the same problem as MultistartHyperparameterLikelihoodNewtonOptimizationTestCore()
+  and compares to multistart Newton, which converges to near machine precision on it.
+
+  **CHECK**
+
+    1. L-BFGS, with and without adaptive multistart, finds an update (found_flag) and its hyperparameters match Newton's
+    2. the gradient of the log likelihood at the L-BFGS solution is small
+    3. the log likelihood improved over the initial hyperparameters
+\endrst*/
+template <typename LogLikelihoodEvaluator, typename CovarianceClass>
+OL_WARN_UNUSED_RESULT int MultistartHyperparameterLikelihoodLBFGSOptimizationTestCore(LogLikelihoodTypes OL_UNUSED(objective_mode)) {
+  using DomainType = TensorProductDomain;
+  const int num_sampled = 42;
+  const int dim = 2;
+
+  // newton parameters (reference solution)
+  const double gamma = 1.1;
+  const double pre_mult = 1.0e-1;
+  const double max_relative_change = 1.0;
+  const double newton_tolerance = 1.0e-14;
+  const int max_newton_steps = 100;
+  const int num_multistarts = 16;
+  NewtonParameters newton_parameters(num_multistarts, max_newton_steps, gamma, pre_mult, max_relative_change,
+                                     newton_tolerance);
+
+  // l-bfgs parameters
+  const int max_lbfgs_steps = 200;
+  const int history_size = 10;
+  const int max_num_line_search_steps = 30;
+  const double lbfgs_tolerance = 1.0e-12;
+  LBFGSParameters lbfgs_parameters(num_multistarts, max_lbfgs_steps, history_size, max_num_line_search_steps,
+                                   lbfgs_tolerance);
+
+  const int max_num_threads = 4;
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
+
+  int total_errors = 0;
+
+  // seed randoms
+  UniformRandomGenerator uniform_generator(5762);
+  boost::uniform_real<double> uniform_double_hyperparameter(1.0, 2.5);
+  boost::uniform_real<double> uniform_double_lower_bound(-2.0, 0.5);
+  boost::uniform_real<double> uniform_double_upper_bound(2.0, 3.5);
+
+  std::vector<double> noise_variance(num_sampled, 0.1);
+  MockGaussianProcessPriorData<DomainType> mock_gp_data(CovarianceClass(dim, 1.0, 1.0), noise_variance, dim,
+                                                        num_sampled, uniform_double_lower_bound,
+                                                        uniform_double_upper_bound,
+                                                        uniform_double_hyperparameter, &uniform_generator);
+  const int num_hyperparameters = mock_gp_data.covariance_ptr->GetNumberOfHyperparameters();
+
+  // allows initial guesses to range over [0.01, 10]
+  std::vector<ClosedInterval> hyperparameter_log_domain_bounds(num_hyperparameters, {-2.0, 1.0});
+
+  LogLikelihoodEvaluator log_likelihood_eval(mock_gp_data.gaussian_process_ptr->points_sampled().data(),
+                                             mock_gp_data.gaussian_process_ptr->points_sampled_value().data(),
+                                             mock_gp_data.gaussian_process_ptr->noise_variance().data(),
+                                             dim, num_sampled);
+  typename LogLikelihoodEvaluator::StateType log_likelihood_state(log_likelihood_eval, *mock_gp_data.covariance_ptr);
+  const double initial_likelihood = log_likelihood_eval.ComputeLogLikelihood(log_likelihood_state);
+
+  std::vector<double> hyperparameters_newton(num_hyperparameters);
+  std::vector<double> hyperparameters_lbfgs(num_hyperparameters);
+  bool found_flag_newton = false;
+  bool found_flag_lbfgs = false;
+  MultistartNewtonHyperparameterOptimization(log_likelihood_eval, *mock_gp_data.covariance_ptr,
+                                             newton_parameters, hyperparameter_log_domain_bounds.data(),
+                                             thread_schedule, &found_flag_newton, &uniform_generator,
+                                             hyperparameters_newton.data());
+  MultistartLBFGSHyperparameterOptimization(log_likelihood_eval, *mock_gp_data.covariance_ptr,
+                                            lbfgs_parameters, nullptr, hyperparameter_log_domain_bounds.data(),
+                                            thread_schedule, &found_flag_lbfgs, &uniform_generator,
+                                            hyperparameters_lbfgs.data());
+  if (!found_flag_newton || !found_flag_lbfgs) {
+    ++total_errors;
+  }
+
+  for (int i = 0; i < num_hyperparameters; ++i) {
+    if (!CheckDoubleWithinRelative(hyperparameters_lbfgs[i], hyperparameters_newton[i], 1.0e-8)) {
+      ++total_errors;
+    }
+  }
+
+  // adaptive multistart: screen with a few steps, fully optimize the best few; must reach the same optimum
+  {
+    const int num_screening_steps = 3;
+    AdaptiveMultistartParameters adaptive_parameters(num_screening_steps, 0.5, max_num_threads,
+                                                     std::numeric_limits<double>::infinity());
+    std::vector<double> hyperparameters_adaptive(num_hyperparameters);
+    bool found_flag_adaptive = false;
+    MultistartLBFGSHyperparameterOptimization(log_likelihood_eval, *mock_gp_data.covariance_ptr,
+                                              lbfgs_parameters, &adaptive_parameters,
+                                              hyperparameter_log_domain_bounds.data(), thread_schedule,
+                                              &found_flag_adaptive, &uniform_generator,
+                                              hyperparameters_adaptive.data());
+    if (!found_flag_adaptive) {
+      ++total_errors;
+    }
+    for (int i = 0; i < num_hyperparameters; ++i) {
+      if (!CheckDoubleWithinRelative(hyperparameters_adaptive[i], hyperparameters_newton[i], 1.0e-8)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  log_likelihood_state.SetHyperparameters(log_likelihood_eval, hyperparameters_lbfgs.data());
+  const double final_likelihood = log_likelihood_eval.ComputeLogLikelihood(log_likelihood_state);
+  std::vector<double> grad_log_marginal(num_hyperparameters);
+  log_likelihood_eval.ComputeGradLogLikelihood(&log_likelihood_state, grad_log_marginal.data());
+  for (const auto& entry : grad_log_marginal) {
+    if (!CheckDoubleWithinRelative(entry, 0.0, 1.0e-8)) {
+      ++total_errors;
+    }
+  }
+
+  if (final_likelihood <= initial_likelihood) {
+    OL_PARTIAL_FAILURE_PRINTF("final likelihood = %.18E is worse than initial likelihood = %.18E\n", final_likelihood, initial_likelihood);
+    ++total_errors;
+  }
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("multistart l-bfgs hyperparameter optimization failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("multistart l-bfgs hyperparameter optimization passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Runs MultistartGradientDescentHyperparameterOptimization() (same starts, same domain) with two evaluators of the same
+  log likelihood measure that differ only in how they compute it, and checks that both find the same optimum.
+
+  \param
+    :log_likelihood_eval_reference: evaluator using the default computation
+    :log_likelihood_eval: evaluator using the alternative computation being tested
+    :covariance: covariance with the initial hyperparameters
+  \return
+    number of test failures
+\endrst*/
+template <typename LogLikelihoodEvaluator>
+OL_WARN_UNUSED_RESULT int MultistartHyperparameterLikelihoodComputeTypeTestCore(
+    const LogLikelihoodEvaluator& log_likelihood_eval_reference, const LogLikelihoodEvaluator& log_likelihood_eval,
+    const CovarianceInterface& covariance) {
+  int total_errors = 0;
+  const int num_hyperparameters = covariance.GetNumberOfHyperparameters();
+  const int num_multistarts = 6;
+  const int max_num_threads = 2;
+  GradientDescentParameters gd_parameters(num_multistarts, 400, 5, 0, 0.5, 0.5, 0.02, 1.0e-10);
+  // domain in LOG-10 SPACE
+  std::vector<ClosedInterval> hyperparameter_log_domain(num_hyperparameters, {-1.0, 1.0});
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
+
+  bool found_flag_reference = false;
+  bool found_flag = false;
+  std::vector<double> hyperparameters_reference(num_hyperparameters);
+  std::vector<double> hyperparameters(num_hyperparameters);
+  const int seed = 7412;
+  UniformRandomGenerator uniform_generator_reference(seed);
+  UniformRandomGenerator uniform_generator(seed);
+  MultistartGradientDescentHyperparameterOptimization(log_likelihood_eval_reference, covariance, gd_parameters,
+                                                      hyperparameter_log_domain.data(), thread_schedule,
+                                                      &found_flag_reference, &uniform_generator_reference,
+                                                      hyperparameters_reference.data());
+  MultistartGradientDescentHyperparameterOptimization(log_likelihood_eval, covariance, gd_parameters,
+                                                      hyperparameter_log_domain.data(), thread_schedule,
+                                                      &found_flag, &uniform_generator, hyperparameters.data());
+  if (!found_flag_reference || !found_flag) {
+    ++total_errors;
+  }
+  // gradient descent stops short of the exact optimum, so the two runs only agree to about the GD tolerance
+  for (int i = 0; i < num_hyperparameters; ++i) {
+    if (!CheckDoubleWithinRelative(hyperparameters[i], hyperparameters_reference[i], 1.0e-2)) {
+      ++total_errors;
+    }
+  }
+
+  typename LogLikelihoodEvaluator::StateType log_likelihood_state_reference(log_likelihood_eval_reference, covariance);
+  typename LogLikelihoodEvaluator::StateType log_likelihood_state(log_likelihood_eval, covariance);
+  const double initial_log_likelihood = log_likelihood_eval_reference.ComputeLogLikelihood(log_likelihood_state_reference);
+
+  // both evaluators agree on the log likelihood at the optimum found with the alternative computation
+  log_likelihood_state_reference.SetHyperparameters(log_likelihood_eval_reference, hyperparameters.data());
+  log_likelihood_state.SetHyperparameters(log_likelihood_eval, hyperparameters.data());
+  const double log_likelihood = log_likelihood_eval_reference.ComputeLogLikelihood(log_likelihood_state_reference);
+  if (!CheckDoubleWithinRelative(log_likelihood_eval.ComputeLogLikelihood(log_likelihood_state), log_likelihood,
+                                 1.0e-10)) {
+    ++total_errors;
+  }
+
+  // and that optimum is as good as the reference optimum (and better than the initial guess)
+  log_likelihood_state_reference.SetHyperparameters(log_likelihood_eval_reference, hyperparameters_reference.data());
+  const double log_likelihood_reference =
+      log_likelihood_eval_reference.ComputeLogLikelihood(log_likelihood_state_reference);
+  if (!CheckDoubleWithinRelative(log_likelihood, log_likelihood_reference, 1.0e-4)) {
+    ++total_errors;
+  }
+  if (!(log_likelihood > initial_log_likelihood)) {
+    ++total_errors;
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Fills uniform random training data in ``[-1, 1]`` (fixed seed) for the compute type optimization tests below.
+
+  \param
+    :dim: the spatial dimension of a point
+    :num_sampled: number of points to generate
+  \output
+    :points_sampled[dim][num_sampled]: random points
+    :points_sampled_value[num_sampled]: random values
+\endrst*/
+void FillComputeTypeTestData(int dim, int num_sampled, double * restrict points_sampled,
+                             double * restrict points_sampled_value) {
+  UniformRandomGenerator uniform_generator(5821);
+  boost::uniform_real<double> uniform_double(-1.0, 1.0);
+  for (int i = 0; i < dim*num_sampled; ++i) {
+    points_sampled[i] = uniform_double(uniform_generator.engine);
+  }
+  for (int i = 0; i < num_sampled; ++i) {
+    points_sampled_value[i] = uniform_double(uniform_generator.engine);
+  }
+}
+
+/*!\rst
+  Checks that multistart gradient descent hyperparameter optimization of LOO-CV gives the same optimum with
+  LeaveOneOutComputeTypes::kCholeskyDowndate as with kMatrixInverse.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int LeaveOneOutCholeskyDowndateOptimizationTest() {
+  const int dim = 2;
+  const int num_sampled = 30;
+
+  std::vector<double> points_sampled(dim*num_sampled);
+  std::vector<double> points_sampled_value(num_sampled);
+  std::vector<double> noise_variance(num_sampled, 0.01);
+  FillComputeTypeTestData(dim, num_sampled, points_sampled.data(), points_sampled_value.data());
+
+  SquareExponential covariance(dim, 1.0, 0.5);
+  LeaveOneOutLogLikelihoodEvaluator loo_eval_inverse(points_sampled.data(), points_sampled_value.data(),
+                                                     noise_variance.data(), dim, num_sampled,
+                                                     LeaveOneOutComputeTypes::kMatrixInverse);
+  LeaveOneOutLogLikelihoodEvaluator loo_eval_downdate(points_sampled.data(), points_sampled_value.data(),
+                                                      noise_variance.data(), dim, num_sampled,
+                                                      LeaveOneOutComputeTypes::kCholeskyDowndate);
+  int total_errors = MultistartHyperparameterLikelihoodComputeTypeTestCore(loo_eval_inverse, loo_eval_downdate,
+                                                                            covariance);
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("LOO cholesky downdate hyperparameter optimization failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("LOO cholesky downdate hyperparameter optimization passed\n");
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that multistart gradient descent hyperparameter optimization of the log marginal likelihood gives the same
+  optimum with LogMarginalLikelihoodGradientTypes::kStreaming as with kFullTensor.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int LogMarginalLikelihoodStreamingOptimizationTest() {
+  const int dim = 2;
+  const int num_sampled = 30;
+  std::vector<double> points_sampled(dim*num_sampled);
+  std::vector<double> points_sampled_value(num_sampled);
+  std::vector<double> noise_variance(num_sampled, 0.01);
+  FillComputeTypeTestData(dim, num_sampled, points_sampled.data(), points_sampled_value.data());
+
+  SquareExponential covariance(dim, 1.0, 0.5);
+  LogMarginalLikelihoodEvaluator log_marginal_eval_full(points_sampled.data(), points_sampled_value.data(),
+                                                        noise_variance.data(), dim, num_sampled,
+                                                        LogMarginalLikelihoodGradientTypes::kFullTensor);
+  LogMarginalLikelihoodEvaluator log_marginal_eval_streaming(points_sampled.data(), points_sampled_value.data(),
+                                                             noise_variance.data(), dim, num_sampled,
+                                                             LogMarginalLikelihoodGradientTypes::kStreaming);
+  int total_errors = MultistartHyperparameterLikelihoodComputeTypeTestCore(log_marginal_eval_full,
+                                                                            log_marginal_eval_streaming, covariance);
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("log marginal streaming hyperparameter optimization failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("log marginal streaming hyperparameter optimization passed\n");
+  }
+
+  return total_errors;
+}
+
 }  // end unnamed namespace
 
 int HyperparameterLikelihoodOptimizationTest(OptimizerTypes optimizer_type, LogLikelihoodTypes objective_mode) {
@@ -861,6 +1564,17 @@ int HyperparameterLikelihoodOptimizationTest(OptimizerTypes optimizer_type, LogL
         }
       }  // end switch over objective_mode
     }  // end case kNewton
+    case OptimizerTypes::kLBFGS: {
+      switch (objective_mode) {
+        case LogLikelihoodTypes::kLogMarginalLikelihood: {
+          return MultistartHyperparameterLikelihoodLBFGSOptimizationTestCore<LogMarginalLikelihoodEvaluator, SquareExponential>(objective_mode);
+        }
+        default: {
+          OL_ERROR_PRINTF("%s: INVALID objective_mode choice: %d\n", OL_CURRENT_FUNCTION_NAME, static_cast<int>(objective_mode));
+          return 1;
+        }
+      }  // end switch over objective_mode
+    }  // end case kLBFGS
     default: {
       OL_ERROR_PRINTF("%s: INVALID optimizer_type choice: %d\n", OL_CURRENT_FUNCTION_NAME, optimizer_type);
       return 1;
@@ -868,6 +1582,21 @@ int HyperparameterLikelihoodOptimizationTest(OptimizerTypes optimizer_type, LogL
   }  // end switch over optimizer_type
 }
 
+int HyperparameterLikelihoodComputeTypeOptimizationTest(LogLikelihoodTypes objective_mode) {
+  switch (objective_mode) {
+    case LogLikelihoodTypes::kLogMarginalLikelihood: {
+      return LogMarginalLikelihoodStreamingOptimizationTest();
+    }
+    case LogLikelihoodTypes::kLeaveOneOutLogLikelihood: {
+      return LeaveOneOutCholeskyDowndateOptimizationTest();
+    }
+    default: {
+      OL_ERROR_PRINTF("%s: INVALID objective_mode choice: %d\n", OL_CURRENT_FUNCTION_NAME, static_cast<int>(objective_mode));
+      return 1;
+    }
+  }  // end switch over objective_mode
+}
+
 int EvaluateLogLikelihoodAtPointListTest() {
   using DomainType = TensorProductDomain;
   using HyperparameterDomainType = TensorProductDomain;
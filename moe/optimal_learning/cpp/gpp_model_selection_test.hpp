@@ -45,10 +45,10 @@ OL_WARN_UNUSED_RESULT int RunLogLikelihoodPingTests();
 
 /*!\rst
   Checks that hyperparameter optimization is working for the selected combination of
-  OptimizerTypes (gradient descent, newton) and LogLikelihoodTypes (log marginal
+  OptimizerTypes (gradient descent, newton, l-bfgs) and LogLikelihoodTypes (log marginal
   likelihood, leave-one-out cross-validation log pseudo-likelihood).
 
-  .. Note:: newton and leave-one-out is not implemented.
+  .. Note:: newton and leave-one-out is not implemented; l-bfgs is only tested with the log marginal likelihood.
 
   \param
     :optimizer_type: which optimizer to use
@@ -58,6 +58,19 @@ OL_WARN_UNUSED_RESULT int RunLogLikelihoodPingTests();
 \endrst*/
 OL_WARN_UNUSED_RESULT int HyperparameterLikelihoodOptimizationTest(OptimizerTypes optimizer_type, LogLikelihoodTypes objective_mode);
 
+/*!\rst
+  Checks that multistart gradient descent hyperparameter optimization finds the same optimum whichever way the
+  evaluator of the selected LogLikelihoodTypes computes it: LogMarginalLikelihoodGradientTypes::kStreaming vs.
+  kFullTensor for kLogMarginalLikelihood, and LeaveOneOutComputeTypes::kCholeskyDowndate vs. kMatrixInverse for
+  kLeaveOneOutLogLikelihood.
+
+  \param
+    :objective_mode: which log likelihood measure to use
+  \return
+    number of test failures: 0 if every computation finds the same optimum
+\endrst*/
+OL_WARN_UNUSED_RESULT int HyperparameterLikelihoodComputeTypeOptimizationTest(LogLikelihoodTypes objective_mode);
+
 /*!\rst
   Tests EvaluateLogLikelihoodAtPointList (computes log likelihood at a specified list of hyperparameters, multithreaded).
   Checks that the returned best point is in fact the best.
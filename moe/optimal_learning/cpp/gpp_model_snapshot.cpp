@@ -0,0 +1,345 @@
+/*!
+  \file gpp_model_snapshot.cpp
+  \rst
+  Implementation of GaussianProcess snapshots; see gpp_model_snapshot.hpp for the file format.
+\endrst*/
+
+#include "gpp_model_snapshot.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gpp_common.hpp"
+#include "gpp_covariance.hpp"
+#include "gpp_exception.hpp"
+#include "gpp_math.hpp"
+
+namespace optimal_learning {
+
+namespace {
+
+//! first bytes of every snapshot file
+constexpr char kSnapshotMagic[8] = {'M', 'O', 'E', 'G', 'P', 'S', 'N', 'P'};
+//! reads back as 0x01020304 only in the byte order the file was written in
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+//! covariance type tags stored in the header
+enum class SnapshotCovarianceTypes : std::uint32_t {
+  kSquareExponential = 0,
+  kSquareExponentialSingleLength = 1,
+  kMaternNu1p5 = 2,
+  kMaternNu2p5 = 3,
+};
+
+//! fixed-size file header; the payload starts right after it
+struct SnapshotHeader final {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order_mark;
+  std::uint32_t covariance_type;
+  std::int32_t dim;
+  std::int32_t num_sampled;
+  std::int32_t num_hyperparameters;
+  std::uint64_t payload_size;
+  char padding[24];
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must be 64 bytes; see gpp_model_snapshot.hpp");
+
+//! \return number of float64 entries in the payload of a snapshot of the specified size
+std::uint64_t NumPayloadEntries(int dim, int num_sampled, int num_hyperparameters) noexcept {
+  const std::uint64_t num_sampled_64 = num_sampled;
+  return num_hyperparameters + dim*num_sampled_64 + 3*num_sampled_64 + num_sampled_64*num_sampled_64;
+}
+
+/*!\rst
+  \return
+    the covariance type tag of ``covariance``
+  \raise
+    OptimalLearningException if snapshots do not support this covariance type
+\endrst*/
+SnapshotCovarianceTypes GetCovarianceType(const CovarianceInterface& covariance) {
+  if (dynamic_cast<const SquareExponential *>(&covariance) != nullptr) {
+    return SnapshotCovarianceTypes::kSquareExponential;
+  } else if (dynamic_cast<const SquareExponentialSingleLength *>(&covariance) != nullptr) {
+    return SnapshotCovarianceTypes::kSquareExponentialSingleLength;
+  } else if (dynamic_cast<const MaternNu1p5 *>(&covariance) != nullptr) {
+    return SnapshotCovarianceTypes::kMaternNu1p5;
+  } else if (dynamic_cast<const MaternNu2p5 *>(&covariance) != nullptr) {
+    return SnapshotCovarianceTypes::kMaternNu2p5;
+  }
+  OL_THROW_EXCEPTION(OptimalLearningException, "Covariance type not supported by GaussianProcess snapshots.");
+}
+
+/*!\rst
+  \return
+    a covariance of the specified type and dim (with placeholder hyperparameters)
+  \raise
+    OptimalLearningException if the type tag is invalid
+\endrst*/
+std::unique_ptr<CovarianceInterface> MakeCovariance(std::uint32_t covariance_type, int dim) {
+  const double placeholder = 1.0;
+  switch (static_cast<SnapshotCovarianceTypes>(covariance_type)) {
+    case SnapshotCovarianceTypes::kSquareExponential: {
+      return std::unique_ptr<CovarianceInterface>(new SquareExponential(dim, placeholder, placeholder));
+    }
+    case SnapshotCovarianceTypes::kSquareExponentialSingleLength: {
+      return std::unique_ptr<CovarianceInterface>(new SquareExponentialSingleLength(dim, placeholder, placeholder));
+    }
+    case SnapshotCovarianceTypes::kMaternNu1p5: {
+      return std::unique_ptr<CovarianceInterface>(new MaternNu1p5(dim, placeholder, placeholder));
+    }
+    case SnapshotCovarianceTypes::kMaternNu2p5: {
+      return std::unique_ptr<CovarianceInterface>(new MaternNu2p5(dim, placeholder, placeholder));
+    }
+    default: {
+      // unknown tag (e.g., a corrupt or newer file); handled below
+      break;
+    }
+  }
+  OL_THROW_EXCEPTION(OptimalLearningException, "Invalid covariance type in GaussianProcess snapshot.");
+}
+
+/*!\rst
+  Uniquely named (``mkstemp``) temporary file in the same directory as ``filename``, for writing a file that then
+  replaces ``filename`` atomically (Commit()).  The temporary file is removed on destruction unless it was committed.
+\endrst*/
+class TemporarySnapshotFile final {
+ public:
+  /*!\rst
+    \param
+      :filename: path of the file that Commit() will replace
+    \raise
+      OptimalLearningException if the temporary file cannot be created
+  \endrst*/
+  explicit TemporarySnapshotFile(const std::string& filename)
+      : filename_(filename), temporary_filename_(filename + ".XXXXXX"), file_descriptor_(-1), committed_(false) {
+    std::vector<char> filename_template(temporary_filename_.begin(), temporary_filename_.end());
+    filename_template.push_back('\0');
+    file_descriptor_ = mkstemp(filename_template.data());
+    if (file_descriptor_ < 0) {
+      OL_THROW_EXCEPTION(OptimalLearningException, ("Could not write GaussianProcess snapshot: " + filename_).c_str());
+    }
+    temporary_filename_ = filename_template.data();
+  }
+
+  ~TemporarySnapshotFile() {
+    if (file_descriptor_ >= 0) {
+      close(file_descriptor_);
+    }
+    if (!committed_) {
+      unlink(temporary_filename_.c_str());
+    }
+  }
+
+  //! writes data[0:size) to the temporary file
+  void WriteArray(double const * restrict data, std::uint64_t size) {
+    Write(reinterpret_cast<char const *>(data), size*sizeof(double));
+  }
+
+  //! writes bytes[0:num_bytes) to the temporary file, retrying partial and interrupted writes
+  void Write(char const * restrict bytes, std::size_t num_bytes) {
+    while (num_bytes > 0) {
+      const ssize_t num_written = write(file_descriptor_, bytes, num_bytes);
+      if (num_written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ThrowWriteError();
+      }
+      bytes += num_written;
+      num_bytes -= num_written;
+    }
+  }
+
+  /*!\rst
+    Flushes the temporary file to disk and renames it over ``filename``, then flushes the directory so that the rename
+    itself survives a crash.  ``mkstemp`` creates files readable only by their owner; snapshots are made readable by
+    everyone (like files from ``std::ofstream`` under the usual umask) so other server processes can load them.
+
+    \raise
+      OptimalLearningException if any step fails; ``filename`` is then either untouched or fully replaced
+  \endrst*/
+  void Commit() {
+    if (fchmod(file_descriptor_, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) != 0 || fsync(file_descriptor_) != 0) {
+      ThrowWriteError();
+    }
+    const int file_descriptor = file_descriptor_;
+    file_descriptor_ = -1;
+    if (close(file_descriptor) != 0 || std::rename(temporary_filename_.c_str(), filename_.c_str()) != 0) {
+      ThrowWriteError();
+    }
+    committed_ = true;
+
+    const std::string::size_type separator = filename_.find_last_of('/');
+    const std::string directory = separator == std::string::npos ? "." : filename_.substr(0, separator + 1);
+    const int directory_descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory_descriptor < 0) {
+      ThrowWriteError();
+    }
+    const bool synced = fsync(directory_descriptor) == 0;
+    close(directory_descriptor);
+    if (!synced) {
+      ThrowWriteError();
+    }
+  }
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(TemporarySnapshotFile);
+
+ private:
+  //! throws the OptimalLearningException reported for any failure to write filename_
+  OL_NORETURN void ThrowWriteError() const {
+    OL_THROW_EXCEPTION(OptimalLearningException, ("Could not write GaussianProcess snapshot: " + filename_).c_str());
+  }
+
+  //! path of the file to replace
+  std::string filename_;
+  //! path of the temporary file
+  std::string temporary_filename_;
+  //! open descriptor of the temporary file; -1 once closed
+  int file_descriptor_;
+  //! whether the temporary file was renamed over filename_
+  bool committed_;
+};
+
+/*!\rst
+  Read-only, shared memory mapping of a whole file; unmapped on destruction.
+\endrst*/
+class MappedFile final {
+ public:
+  /*!\rst
+    \param
+      :filename: path of the file to map
+    \raise
+      OptimalLearningException if the file cannot be opened or mapped, or is too small to hold a SnapshotHeader
+  \endrst*/
+  explicit MappedFile(const std::string& filename) : data_(nullptr), size_(0) {
+    const int file_descriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0) {
+      OL_THROW_EXCEPTION(OptimalLearningException, ("Could not open GaussianProcess snapshot: " + filename).c_str());
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0 || file_status.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+      close(file_descriptor);
+      OL_THROW_EXCEPTION(OptimalLearningException, ("Truncated GaussianProcess snapshot: " + filename).c_str());
+    }
+    size_ = file_status.st_size;
+    void * data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    // the mapping stays valid after closing its descriptor
+    close(file_descriptor);
+    if (data == MAP_FAILED) {
+      OL_THROW_EXCEPTION(OptimalLearningException, ("Could not map GaussianProcess snapshot: " + filename).c_str());
+    }
+    data_ = static_cast<char const *>(data);
+  }
+
+  ~MappedFile() {
+    munmap(const_cast<char *>(data_), size_);
+  }
+
+  char const * data() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return data_;
+  }
+
+  std::size_t size() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return size_;
+  }
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(MappedFile);
+
+ private:
+  //! start of the mapping
+  char const * data_;
+  //! size of the mapping (= file size) in bytes
+  std::size_t size_;
+};
+
+}  // end unnamed namespace
+
+void WriteGaussianProcessSnapshot(const GaussianProcess& gaussian_process, const std::string& filename) {
+  const CovarianceInterface& covariance = gaussian_process.covariance();
+  const int dim = gaussian_process.dim();
+  const int num_sampled = gaussian_process.num_sampled();
+  std::vector<double> hyperparameters(covariance.GetNumberOfHyperparameters());
+  covariance.GetHyperparameters(hyperparameters.data());
+
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kGaussianProcessSnapshotVersion;
+  header.byte_order_mark = kByteOrderMark;
+  header.covariance_type = static_cast<std::uint32_t>(GetCovarianceType(covariance));
+  header.dim = dim;
+  header.num_sampled = num_sampled;
+  header.num_hyperparameters = hyperparameters.size();
+  header.payload_size = NumPayloadEntries(dim, num_sampled, hyperparameters.size())*sizeof(double);
+
+  // write a temporary file and rename it, so that processes mapping the old snapshot never see a partial one
+  TemporarySnapshotFile file(filename);
+  file.Write(reinterpret_cast<char const *>(&header), sizeof(header));
+  file.WriteArray(hyperparameters.data(), hyperparameters.size());
+  file.WriteArray(gaussian_process.points_sampled().data(), static_cast<std::uint64_t>(dim)*num_sampled);
+  file.WriteArray(gaussian_process.points_sampled_value().data(), num_sampled);
+  file.WriteArray(gaussian_process.noise_variance().data(), num_sampled);
+  file.WriteArray(gaussian_process.K_inv_y().data(), num_sampled);
+  file.WriteArray(gaussian_process.K_chol(), static_cast<std::uint64_t>(num_sampled)*num_sampled);
+  file.Commit();
+}
+
+std::unique_ptr<GaussianProcess> LoadGaussianProcessSnapshot(const std::string& filename) {
+  std::shared_ptr<const MappedFile> mapped_file(new MappedFile(filename));
+
+  SnapshotHeader header;
+  std::memcpy(&header, mapped_file->data(), sizeof(header));
+  if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0) {
+    OL_THROW_EXCEPTION(OptimalLearningException, ("Not a GaussianProcess snapshot: " + filename).c_str());
+  }
+  if (header.byte_order_mark != kByteOrderMark) {
+    OL_THROW_EXCEPTION(OptimalLearningException,
+                       ("GaussianProcess snapshot was written with a different byte order: " + filename).c_str());
+  }
+  if (header.version != kGaussianProcessSnapshotVersion) {
+    OL_THROW_EXCEPTION(InvalidValueException<int>, "Unsupported GaussianProcess snapshot version.",
+                       static_cast<int>(header.version), static_cast<int>(kGaussianProcessSnapshotVersion));
+  }
+  if (header.dim <= 0 || header.num_sampled < 0 || header.num_hyperparameters < 0 ||
+      header.payload_size != mapped_file->size() - sizeof(header) ||
+      header.payload_size != NumPayloadEntries(header.dim, header.num_sampled, header.num_hyperparameters)*sizeof(double)) {
+    OL_THROW_EXCEPTION(OptimalLearningException,
+                       ("GaussianProcess snapshot sizes are inconsistent (truncated file?): " + filename).c_str());
+  }
+
+  std::unique_ptr<CovarianceInterface> covariance = MakeCovariance(header.covariance_type, header.dim);
+  if (header.num_hyperparameters != covariance->GetNumberOfHyperparameters()) {
+    OL_THROW_EXCEPTION(InvalidValueException<int>, "Wrong number of hyperparameters in GaussianProcess snapshot.",
+                       header.num_hyperparameters, covariance->GetNumberOfHyperparameters());
+  }
+
+  const int dim = header.dim;
+  const int num_sampled = header.num_sampled;
+  double const * hyperparameters = reinterpret_cast<double const *>(mapped_file->data() + sizeof(header));
+  double const * points_sampled = hyperparameters + header.num_hyperparameters;
+  double const * points_sampled_value = points_sampled + static_cast<std::uint64_t>(dim)*num_sampled;
+  double const * noise_variance = points_sampled_value + num_sampled;
+  double const * K_inv_y = noise_variance + num_sampled;
+  double const * K_chol = K_inv_y + num_sampled;
+  covariance->SetHyperparameters(hyperparameters);
+
+  return std::unique_ptr<GaussianProcess>(new GaussianProcess(*covariance, points_sampled, points_sampled_value,
+                                                              noise_variance, K_chol, K_inv_y, mapped_file,
+                                                              dim, num_sampled));
+}
+
+}  // end namespace optimal_learning
@@ -0,0 +1,100 @@
+/*!
+  \file gpp_model_snapshot.hpp
+  \rst
+  This file contains functions to save a fitted GaussianProcess to a binary snapshot file and to load it back without
+  refactoring ``K``.
+
+  Fitting a GaussianProcess costs ``O(N^3)`` (GaussianProcess::RecomputeDerivedVariables()), which every process restart
+  or new worker pays again.  A snapshot stores the GP's data and its derived quantities (``K_chol``, ``K^-1 * y``), so::
+
+    WriteGaussianProcessSnapshot(gaussian_process, "model.gpsnap");
+    ...  // in another process
+    std::unique_ptr<GaussianProcess> gaussian_process = LoadGaussianProcessSnapshot("model.gpsnap");
+
+  LoadGaussianProcessSnapshot() memory-maps the file (read-only, shared) and builds a GaussianProcess that reads its
+  cholesky factor (``N^2`` doubles, e.g., 800MB at ``N = 10^4``) IN PLACE from the mapping; see the derived-quantities
+  constructor of GaussianProcess.  Loading costs ``O(N*dim)`` copying plus page faults on first use, and processes
+  loading the same file (e.g., prefork workers) share one copy of the factor in the page cache.  The other arrays are
+  ``O(N*dim)`` and are copied (GaussianProcess keeps them in ``std::vector``).  Changing the loaded GP's data or
+  hyperparameters (e.g., AddPointsToGP()) first copies the factor into private memory (copy-on-write).
+
+  **File format (version 1)**
+
+  All values are in native byte order (checked on load; snapshots are not portable across byte orders).  A 64 byte
+  header::
+
+    offset  type       field
+         0  char[8]    magic: "MOEGPSNP"
+         8  uint32     version: kGaussianProcessSnapshotVersion
+        12  uint32     byte order mark: 0x01020304
+        16  uint32     covariance type: 0 = SquareExponential, 1 = SquareExponentialSingleLength,
+                                        2 = MaternNu1p5, 3 = MaternNu2p5
+        20  int32      dim
+        24  int32      num_sampled (N)
+        28  int32      num_hyperparameters
+        32  uint64     payload size in bytes
+        40  char[24]   zero padding
+
+  followed by the payload of float64 arrays, back to back (the header size keeps them 8 byte aligned)::
+
+    hyperparameters[num_hyperparameters], points_sampled[N][dim], points_sampled_value[N], noise_variance[N],
+    K_inv_y[N], K_chol[N][N]
+
+  Readers reject files with a different version; any change to the layout must bump kGaussianProcessSnapshotVersion.
+
+  Files are written to a uniquely named temporary file (``mkstemp``) in the directory of ``filename`` that is then
+  renamed over ``filename``, so rewriting a snapshot never modifies a file that other processes have mapped, and
+  concurrent writers never share a temporary file.  The file is ``fsync``-ed before the rename and the directory
+  after it, so after a crash ``filename`` holds either the old or the new snapshot in full.  Writing and loading
+  require POSIX (``mkstemp``, ``fsync``, ``mmap``).
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_SNAPSHOT_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_SNAPSHOT_HPP_
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+class GaussianProcess;
+
+//! version of the snapshot file format written by WriteGaussianProcessSnapshot()
+constexpr std::uint32_t kGaussianProcessSnapshotVersion = 1;
+
+/*!\rst
+  Writes a snapshot of a GaussianProcess (data, covariance, and derived quantities) to a file; see file comments for
+  the format.  Replaces ``filename`` atomically if it exists.
+
+  \param
+    :gaussian_process: the GP to save; its covariance must be one of the types listed in the file format
+    :filename: path of the snapshot file
+  \raise
+    OptimalLearningException if the covariance type is not supported or the file cannot be written
+\endrst*/
+void WriteGaussianProcessSnapshot(const GaussianProcess& gaussian_process, const std::string& filename);
+
+/*!\rst
+  Loads a GaussianProcess from a snapshot file written by WriteGaussianProcessSnapshot(), without refactoring ``K``.
+  The cholesky factor is read in place from a read-only memory mapping of the file, which stays mapped as long as
+  the returned GP (or any of its clones) uses it; see file comments.
+
+  The returned GP's normal RNG is seeded with GaussianProcess::kDefaultSeed (RNG state is not saved).
+
+  \param
+    :filename: path of the snapshot file
+  \return
+    the loaded GaussianProcess
+  \raise
+    OptimalLearningException if the file cannot be read or is not a valid snapshot;
+    InvalidValueException<int> if the snapshot has a different format version or is inconsistent
+\endrst*/
+std::unique_ptr<GaussianProcess> LoadGaussianProcessSnapshot(const std::string& filename) OL_WARN_UNUSED_RESULT;
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_SNAPSHOT_HPP_
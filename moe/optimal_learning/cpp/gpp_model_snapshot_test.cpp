@@ -0,0 +1,382 @@
+/*!
+  \file gpp_model_snapshot_test.cpp
+  \rst
+  This file contains functions for testing GaussianProcess snapshots in gpp_model_snapshot.hpp.
+\endrst*/
+
+#include "gpp_model_snapshot_test.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/random/uniform_real.hpp>  // NOLINT(build/include_order)
+
+#include "gpp_common.hpp"
+#include "gpp_covariance.hpp"
+#include "gpp_exception.hpp"
+#include "gpp_logging.hpp"
+#include "gpp_math.hpp"
+#include "gpp_model_snapshot.hpp"
+#include "gpp_random.hpp"
+#include "gpp_test_utils.hpp"
+
+namespace optimal_learning {
+
+namespace {  // tests of GaussianProcess snapshots
+
+//! creates a uniquely named (empty) temporary file on construction and removes it on destruction
+class ScopedTemporaryFile final {
+ public:
+  ScopedTemporaryFile() : filename_("/tmp/gpp_model_snapshot_test_XXXXXX") {
+    std::vector<char> filename_template(filename_.begin(), filename_.end());
+    filename_template.push_back('\0');
+    const int file_descriptor = mkstemp(filename_template.data());
+    if (file_descriptor < 0) {
+      OL_THROW_EXCEPTION(OptimalLearningException, "Could not create a temporary file.");
+    }
+    close(file_descriptor);
+    filename_ = filename_template.data();
+  }
+
+  ~ScopedTemporaryFile() {
+    std::remove(filename_.c_str());
+  }
+
+  const std::string& filename() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return filename_;
+  }
+
+  OL_DISALLOW_COPY_AND_ASSIGN(ScopedTemporaryFile);
+
+ private:
+  std::string filename_;
+};
+
+/*!\rst
+  Checks that two GPs have the same data and the same mean and variance at a few random points.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int CheckSameGaussianProcess(const GaussianProcess& gaussian_process,
+                                                   const GaussianProcess& gaussian_process_truth, double tolerance,
+                                                   UniformRandomGenerator * uniform_generator) {
+  const int num_to_sample = 4;
+  const int dim = gaussian_process_truth.dim();
+  std::vector<double> points_to_sample(dim*num_to_sample);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  for (auto& entry : points_to_sample) {
+    entry = uniform_double(uniform_generator->engine);
+  }
+
+  int total_errors = 0;
+  if (!CheckIntEquals(gaussian_process.dim(), dim) ||
+      !CheckIntEquals(gaussian_process.num_sampled(), gaussian_process_truth.num_sampled()) ||
+      gaussian_process.points_sampled() != gaussian_process_truth.points_sampled() ||
+      gaussian_process.points_sampled_value() != gaussian_process_truth.points_sampled_value() ||
+      gaussian_process.noise_variance() != gaussian_process_truth.noise_variance()) {
+    ++total_errors;
+  }
+
+  const int num_derivatives = num_to_sample;
+  std::vector<double> mean(num_to_sample);
+  std::vector<double> mean_truth(num_to_sample);
+  std::vector<double> variance(Square(num_to_sample));
+  std::vector<double> variance_truth(Square(num_to_sample));
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample.data(), num_to_sample,
+                                                    num_derivatives);
+  GaussianProcess::StateType points_to_sample_state_truth(gaussian_process_truth, points_to_sample.data(),
+                                                          num_to_sample, num_derivatives);
+  gaussian_process.ComputeMeanOfPoints(points_to_sample_state, mean.data());
+  gaussian_process_truth.ComputeMeanOfPoints(points_to_sample_state_truth, mean_truth.data());
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, variance.data());
+  gaussian_process_truth.ComputeVarianceOfPoints(&points_to_sample_state_truth, variance_truth.data());
+  for (int i = 0; i < num_to_sample; ++i) {
+    if (!CheckDoubleWithinRelative(mean[i], mean_truth[i], tolerance)) {
+      ++total_errors;
+    }
+    // variance is only valid in the lower triangle
+    for (int j = i; j < num_to_sample; ++j) {
+      if (!CheckDoubleWithinRelative(variance[i*num_to_sample + j], variance_truth[i*num_to_sample + j], tolerance)) {
+        ++total_errors;
+      }
+    }
+  }
+  return total_errors;
+}
+
+/*!\rst
+  Checks that saving and loading a GP reproduces it exactly (for every supported covariance), that loaded GPs outlive
+  their source and can be cloned, and that modifying a loaded GP (copy-on-write of its factor) works.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessSnapshotRoundTripTest() {
+  const int dim = 3;
+  const int num_sampled = 30;
+  const int num_added = 5;
+  UniformRandomGenerator uniform_generator(1618);
+  boost::uniform_real<double> uniform_double(-2.0, 2.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled + num_added, 0, 0, 0.02, uniform_double, &uniform_generator);
+
+  const std::vector<double> lengths = {0.6, 0.9, 1.2};
+  std::vector<std::unique_ptr<CovarianceInterface> > covariances;
+  covariances.emplace_back(new SquareExponential(dim, 1.3, lengths));
+  covariances.emplace_back(new SquareExponentialSingleLength(dim, 1.3, 0.8));
+  covariances.emplace_back(new MaternNu1p5(dim, 1.3, lengths));
+  covariances.emplace_back(new MaternNu2p5(dim, 1.3, lengths));
+
+  const double tolerance = 5.0e-12;
+  int total_errors = 0;
+  for (const auto& covariance : covariances) {
+    ScopedTemporaryFile snapshot_file;
+    std::unique_ptr<GaussianProcess> gaussian_process_loaded;
+    {
+      GaussianProcess gaussian_process(*covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                       gp_data.noise_variance.data(), dim, num_sampled);
+      WriteGaussianProcessSnapshot(gaussian_process, snapshot_file.filename());
+      gaussian_process_loaded = LoadGaussianProcessSnapshot(snapshot_file.filename());
+      total_errors += CheckSameGaussianProcess(*gaussian_process_loaded, gaussian_process, 0.0, &uniform_generator);
+    }
+    // the mapping stays valid after the file is removed and the source GP is gone
+    std::remove(snapshot_file.filename().c_str());
+    std::unique_ptr<GaussianProcess> gaussian_process_clone(gaussian_process_loaded->Clone());
+    gaussian_process_loaded.reset();
+
+    GaussianProcess gaussian_process_truth(*covariance, gp_data.points_sampled.data(),
+                                           gp_data.points_sampled_value.data(), gp_data.noise_variance.data(), dim,
+                                           num_sampled);
+    total_errors += CheckSameGaussianProcess(*gaussian_process_clone, gaussian_process_truth, 0.0, &uniform_generator);
+
+    // modifying the loaded GP copies its factor out of the (read-only) mapping first
+    std::unique_ptr<GaussianProcess> gaussian_process_extended(gaussian_process_clone->Clone());
+    gaussian_process_extended->AddPointsToGP(gp_data.points_sampled.data() + dim*num_sampled,
+                                             gp_data.points_sampled_value.data() + num_sampled,
+                                             gp_data.noise_variance.data() + num_sampled, num_added);
+    gaussian_process_truth.AddPointsToGP(gp_data.points_sampled.data() + dim*num_sampled,
+                                         gp_data.points_sampled_value.data() + num_sampled,
+                                         gp_data.noise_variance.data() + num_sampled, num_added);
+    total_errors += CheckSameGaussianProcess(*gaussian_process_extended, gaussian_process_truth, tolerance,
+                                             &uniform_generator);
+
+    std::vector<double> hyperparameters(covariance->GetNumberOfHyperparameters(), 0.7);
+    gaussian_process_clone->SetCovarianceHyperparameters(hyperparameters.data());
+    std::unique_ptr<CovarianceInterface> covariance_new(covariance->Clone());
+    covariance_new->SetHyperparameters(hyperparameters.data());
+    GaussianProcess gaussian_process_new_hyperparameters(*covariance_new, gp_data.points_sampled.data(),
+                                                         gp_data.points_sampled_value.data(),
+                                                         gp_data.noise_variance.data(), dim, num_sampled);
+    total_errors += CheckSameGaussianProcess(*gaussian_process_clone, gaussian_process_new_hyperparameters, 0.0,
+                                             &uniform_generator);
+  }
+  return total_errors;
+}
+
+/*!\rst
+  Overwrites ``size`` bytes at ``offset`` of a file.
+\endrst*/
+void OverwriteBytes(const std::string& filename, std::int64_t offset, char const * bytes, int size) {
+  std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(offset);
+  file.write(bytes, size);
+}
+
+/*!\rst
+  Checks that loading a snapshot throws ExceptionType.
+
+  \return
+    number of test failures: 0 if the exception was thrown
+\endrst*/
+template <typename ExceptionType>
+OL_WARN_UNUSED_RESULT int CheckLoadThrows(const std::string& filename) {
+  try {
+    std::unique_ptr<GaussianProcess> gaussian_process = LoadGaussianProcessSnapshot(filename);
+  } catch (const ExceptionType& exception) {
+    return 0;
+  }
+  OL_ERROR_PRINTF("loading %s did not throw\n", filename.c_str());
+  return 1;
+}
+
+/*!\rst
+  Checks that missing, truncated, corrupted, and wrong-version snapshots are rejected.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessSnapshotInvalidFileTest() {
+  const int dim = 2;
+  const int num_sampled = 8;
+  UniformRandomGenerator uniform_generator(4669);
+  boost::uniform_real<double> uniform_double(-1.0, 1.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, 0, 0, 0.1, uniform_double, &uniform_generator);
+  SquareExponential covariance(dim, 1.0, 0.5);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+  int total_errors = 0;
+
+  {
+    ScopedTemporaryFile snapshot_file;
+    std::remove(snapshot_file.filename().c_str());
+    total_errors += CheckLoadThrows<OptimalLearningException>(snapshot_file.filename());
+  }
+  {
+    // empty file
+    ScopedTemporaryFile snapshot_file;
+    total_errors += CheckLoadThrows<OptimalLearningException>(snapshot_file.filename());
+  }
+  {
+    ScopedTemporaryFile snapshot_file;
+    WriteGaussianProcessSnapshot(gaussian_process, snapshot_file.filename());
+    const char bad_magic[] = "MOEGPXXX";
+    OverwriteBytes(snapshot_file.filename(), 0, bad_magic, 8);
+    total_errors += CheckLoadThrows<OptimalLearningException>(snapshot_file.filename());
+  }
+  {
+    ScopedTemporaryFile snapshot_file;
+    WriteGaussianProcessSnapshot(gaussian_process, snapshot_file.filename());
+    const std::uint32_t bad_version = kGaussianProcessSnapshotVersion + 1;
+    OverwriteBytes(snapshot_file.filename(), 8, reinterpret_cast<char const *>(&bad_version), sizeof(bad_version));
+    total_errors += CheckLoadThrows<InvalidValueException<int> >(snapshot_file.filename());
+  }
+  {
+    ScopedTemporaryFile snapshot_file;
+    WriteGaussianProcessSnapshot(gaussian_process, snapshot_file.filename());
+    const std::uint32_t bad_covariance_type = 17;
+    OverwriteBytes(snapshot_file.filename(), 16, reinterpret_cast<char const *>(&bad_covariance_type),
+                   sizeof(bad_covariance_type));
+    total_errors += CheckLoadThrows<OptimalLearningException>(snapshot_file.filename());
+  }
+  {
+    // drop the last row of K_chol
+    ScopedTemporaryFile snapshot_file;
+    WriteGaussianProcessSnapshot(gaussian_process, snapshot_file.filename());
+    const std::int64_t file_size = 64 + sizeof(double)*(dim + 1 + dim*num_sampled + 3*num_sampled + Square(num_sampled));
+    if (truncate(snapshot_file.filename().c_str(), file_size - sizeof(double)*num_sampled) != 0) {
+      ++total_errors;
+    }
+    total_errors += CheckLoadThrows<OptimalLearningException>(snapshot_file.filename());
+  }
+  return total_errors;
+}
+
+/*!\rst
+  \return
+    number of entries (other than ``.`` and ``..``) in a directory, or -1 if it cannot be read
+\endrst*/
+int CountDirectoryEntries(const std::string& directory) {
+  DIR * directory_stream = opendir(directory.c_str());
+  if (directory_stream == nullptr) {
+    return -1;
+  }
+  int num_entries = 0;
+  for (struct dirent * entry = readdir(directory_stream); entry != nullptr; entry = readdir(directory_stream)) {
+    const std::string name(entry->d_name);
+    if (name != "." && name != "..") {
+      ++num_entries;
+    }
+  }
+  closedir(directory_stream);
+  return num_entries;
+}
+
+/*!\rst
+  Checks that writing a snapshot (including over an existing one) leaves no temporary files behind, produces a file
+  other processes can read, and that a failed write throws without creating anything.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int GaussianProcessSnapshotWriteTest() {
+  const int dim = 2;
+  const int num_sampled = 8;
+  UniformRandomGenerator uniform_generator(2718);
+  boost::uniform_real<double> uniform_double(-1.0, 1.0);
+  RandomGaussianProcessData gp_data(dim, num_sampled, 0, 0, 0.1, uniform_double, &uniform_generator);
+  SquareExponential covariance(dim, 1.0, 0.5);
+  GaussianProcess gaussian_process(covariance, gp_data.points_sampled.data(), gp_data.points_sampled_value.data(),
+                                   gp_data.noise_variance.data(), dim, num_sampled);
+
+  char directory_template[] = "/tmp/gpp_model_snapshot_test_XXXXXX";
+  if (mkdtemp(directory_template) == nullptr) {
+    OL_ERROR_PRINTF("could not create a temporary directory\n");
+    return 1;
+  }
+  const std::string directory(directory_template);
+  const std::string filename = directory + "/gp.snapshot";
+  int total_errors = 0;
+
+  // write, then overwrite the existing snapshot
+  for (int i = 0; i < 2; ++i) {
+    WriteGaussianProcessSnapshot(gaussian_process, filename);
+    if (CountDirectoryEntries(directory) != 1) {
+      ++total_errors;
+    }
+  }
+  struct stat file_status;
+  if (stat(filename.c_str(), &file_status) != 0 || (file_status.st_mode & S_IROTH) == 0) {
+    ++total_errors;
+  }
+  std::unique_ptr<GaussianProcess> gaussian_process_loaded = LoadGaussianProcessSnapshot(filename);
+  total_errors += CheckSameGaussianProcess(*gaussian_process_loaded, gaussian_process, 0.0, &uniform_generator);
+
+  try {
+    WriteGaussianProcessSnapshot(gaussian_process, directory + "/missing/gp.snapshot");
+    OL_ERROR_PRINTF("writing into a missing directory did not throw\n");
+    ++total_errors;
+  } catch (const OptimalLearningException& exception) {
+  }
+  if (CountDirectoryEntries(directory) != 1) {
+    ++total_errors;
+  }
+
+  std::remove(filename.c_str());
+  rmdir(directory.c_str());
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+int RunGaussianProcessSnapshotTests() {
+  int total_errors = 0;
+  int current_errors = 0;
+
+  current_errors = GaussianProcessSnapshotRoundTripTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GaussianProcess snapshot round trip failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = GaussianProcessSnapshotInvalidFileTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GaussianProcess snapshot invalid file handling failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = GaussianProcessSnapshotWriteTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("GaussianProcess snapshot writing failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("model snapshot tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("model snapshot tests passed\n");
+  }
+
+  return total_errors;
+}
+
+}  // end namespace optimal_learning
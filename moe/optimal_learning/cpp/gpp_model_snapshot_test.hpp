@@ -0,0 +1,29 @@
+/*!
+  \file gpp_model_snapshot_test.hpp
+  \rst
+  Tests for gpp_model_snapshot.hpp: saving and (memory-mapped) loading of GaussianProcess snapshots.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_SNAPSHOT_TEST_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_SNAPSHOT_TEST_HPP_
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  Checks that GaussianProcess snapshots are working:
+
+  * loaded GPs (every supported covariance type) reproduce the saved GP's mean and variance exactly
+  * loaded GPs can be cloned and modified (AddPointsToGP, new hyperparameters) like any other GP
+  * missing, truncated, corrupted, and wrong-version files are rejected
+  * writing (or overwriting) leaves no temporary files behind, and failed writes throw
+
+  \return
+    number of test failures: 0 if snapshots are working properly
+\endrst*/
+OL_WARN_UNUSED_RESULT int RunGaussianProcessSnapshotTests();
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_MODEL_SNAPSHOT_TEST_HPP_
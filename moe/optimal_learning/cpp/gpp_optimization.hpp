@@ -17,6 +17,7 @@
         ii. IMPLEMENTATION DETAILS
 
      c. MULTISTART OPTIMIZATION
+     d. PROJECTED L-BFGS (L-BFGS-B)
 
   3. CODE HIERARCHY / CALL-TREE
 
@@ -41,7 +42,8 @@
   state otherwise, "optima" and "optimization" refer to "maxima" and "maximization," respectively.  (Note that
   minimizing ``g(x)`` is equivalent to maximizing ``f(x) = -1 * g(x)``.)
 
-  This file contains templates for some common optimization techniques: gradient descent (GD) and Newton's method.
+  This file contains templates for some common optimization techniques: gradient descent (GD), Newton's method, and
+  (projected) L-BFGS.
   We provide constrained implementations (constraint via heuristics like restricting updates to 50% of the distance
   to the nearest wall) of these optimizers.  For unconstrained, just set the domain to be huge: ``[-DBL_MAX, DBL_MAX]``.
 
@@ -63,6 +65,10 @@
   section 3a) of this header (below) for details on precisely what functions/interface a (Evaluator, State) tuple are
   required to provide in order to be used with the optimizers in this file.
 
+  The optimizers' own temporaries (trial points, gradients, search directions, L-BFGS history, the per-thread best
+  point in MultistartOptimize) come from the calling thread's ScratchArena (see gpp_memory_pool.hpp) instead of the
+  heap, so repeated optimizations do not allocate once the arena reaches its high-water mark.
+
   **2. OPTIMIZATION OF OBJECTIVE FUNCTIONS**
 
   **2a. GRADIENT DESCENT (GD)**
@@ -179,11 +185,32 @@
 
   TODO(GH-165): Improve multistart heuristics.
 
+  With hundreds or thousands of initial guesses, most of the time goes to polishing starts that cannot win.
+  MultistartOptimizer::MultistartOptimizeAdaptive() screens every start with a cheap, truncated run of the optimizer and
+  applies successive halving (keep the best fraction, screen again, ...) until a few starts remain; only those are fully
+  optimized.  Threads pull starts from a shared queue and share the best objective value found (a lock-free atomic),
+  which lets them drop survivors that are already far behind.  This is a heuristic: a start that looks poor early on
+  could have gone on to win.
+
   Finally, MultistartOptimizer::MultistartOptimize() is also used to provide 'dumb' search functionality (optimization
   by just evaluating the objective at numerous points).  For sufficiently complex problems, gradient descent, Newton, etc.
   can have exceptionally poor convergence characteristics or run too slowly.  In cases where these more advanced techniques
   fail, we commonly fall back to 'dumb' search.
 
+  **2d. PROJECTED L-BFGS (L-BFGS-B)**
+
+  L-BFGS is a limited-memory quasi-Newton method: like Newton, it steps along ``H * \nabla f``, but ``H`` (an approximation
+  to the inverse Hessian) is built from the last few steps and gradient changes instead of second derivatives.  So it needs
+  only gradients (like GD) but converges superlinearly near an optimum (nearly like Newton), and a line search replaces
+  the step size heuristics of GD (learning rate, ``max_relative_change``) and Newton (diagonal dominance).
+
+  Box constraints (e.g., TensorProductDomain) are handled by projection: iterates are clamped onto the domain, and
+  coordinates pinned to a boundary by the gradient are frozen when computing the step.  Hence the optimizer can converge
+  to optima that lie exactly on a boundary, which the update limiting used by GD and Newton cannot.
+
+  L-BFGS is implemented here: LBFGSOptimizer::Optimize() (which calls LBFGSOptimization()).  Domains must additionally
+  provide ProjectPointIntoDomain() (see 3a).
+
   **3. CODE HIERARCHY / CALL-TREE**
 
   **3a. REQUIREMENTS OF TEMPLATE (CLASS) PARAMETERS**
@@ -199,6 +226,8 @@
   void LimitUpdate(double max_relative_change, double const * restrict current_point, double * restrict update_vector);
   and with debugging on,
   bool CheckPointInside(double const * restrict point);
+  and for LBFGSOptimizer,
+  void ProjectPointIntoDomain(double * restrict point);
 
   Now let's talk about (Evaluate, State) template parameters and the optimzation classes in this file.  In ADDITION
   to the requirements/guidelines laid out in gpp_common.hpp, an (Evaluate, State) tuple MUST provide the following
@@ -315,16 +344,33 @@
         and ComputeHessianObjectiveFunction()
       * Inner loop also calls ComputePLUFactorization() and PLUMatrixVectorSolve() from gpp_linear_algebra
 
+  class LBFGSOptimizer<ObjectiveFunctionEvaluator, Domain>:
+  LBFGSOptimizer<...>::Optimize() (projected L-BFGS)
+
+    * This calls:
+      LBFGSOptimization<ObjectiveFunctionEvaluator, Domain>() (projected L-BFGS with backtracking line search)
+
+      * Performs L-BFGS iteration to optimize the templated objective function
+      * Ensures (by projecting onto the domain) that solutions remain in the specified domain
+      * Calls out to ObjectiveFunctionEvaluator::ComputeObjectiveFunction() and ComputeGradObjectiveFunction()
+
    **3b, iii. MULTISTART OPTIMIZATION**
    class MultistartOptimizer<Optimizer<ObjectiveFunctionEvaluator, Domain> >:
    MultistartOptimizer<...>::MultistartOptimize() (multistarts any Optimizer from section 3b, ii.)
 
      * Calls Optimizer::Optimize() once for each point in the provided list of initial guesses
-     * Multithreaded using OpenMP for performance
+     * Multithreaded using OpenMP for performance; an overload runs the starts on a work-stealing pool
+       (WorkStealingTaskPool, gpp_task_pool.hpp) to balance starts of very uneven cost
      * Reports the best result overall (and optionally each individual result)
      * Proxy for finding the global maximum since it is difficult/impossible to guarantee an optimum is global
        in general. See function comments (below) and header comments (above, 2c) for details.
 
+   MultistartOptimizer<...>::MultistartOptimizeAdaptive() (successive halving + pruning over the multistarts)
+
+     * Screens every start with truncated Optimizer::Optimize() runs, repeatedly keeping the best fraction of starts
+     * Fully optimizes the few survivors; threads share the best objective (atomic) to prune dominated survivors
+     * Threads pull starts from a shared (atomic) work queue
+
      .. NOTE:: uses OptimizationIOContainer class (see declaration below for details) for inputting/outputting
         information about currently best-known objective values/points and the optimization result.
 \endrst*/
@@ -341,142 +387,27 @@
 #include <cmath>
 
 #include <algorithm>
+#include <atomic>
 #include <exception>
+#include <limits>
 #include <mutex>
+#include <numeric>
 #include <vector>
 
 #include <omp.h>  // NOLINT(build/include_order)
 
 #include "gpp_common.hpp"
 #include "gpp_domain.hpp"
+#include "gpp_exception.hpp"
 #include "gpp_linear_algebra.hpp"
 #include "gpp_logging.hpp"
+#include "gpp_memory_pool.hpp"
 #include "gpp_optimizer_parameters.hpp"
+#include "gpp_task_pool.hpp"
+#include "gpp_thread_schedule.hpp"
 
 namespace optimal_learning {
 
-/*!\rst
-  **Overview**
-
-  When we ask openmp to parallelize a for loop, we can give it additional information on how to
-  distribute the work. In particular, the overall work (N iterations) needs to be divided up amongst
-  the threads. We have two major ways to affect how openmp structures the loop:
-  ``schedule`` and ``chunk_size``.
-
-  ``chunk_size`` changes meaning depending on ``schedule``. Here we list out the options for
-  ``schedule`` as ``name (ENV_NAME, enum_name)`` where ``ENV_NAME`` is the corresponding value
-  of ``OMP_SCHEDULE`` (not used by ``optimal_learning``) and ``enum_name`` is the corresponding
-  type from ``opm_sched_t`` in ``omp.h``. Below, "work" refers to loop iterations (``N`` total).
-
-  **Schedule Types**
-
-  a. static ("static", omp_sched_static):
-
-     Work is divided into ``N/chunk_size`` *contiguous* chunks (of ``chunk_size`` iterations) and
-     distributed amongst the threads statically in a round-robin fashion. Use when you are
-     confident all chunks will take the same amount of time.
-
-     Low control overhead but high waste if one iteration is very slow (since the other
-     threads will sit idle).
-
-     Default ``chunk_size``: ``N / number_of_threads``.
-
-     This schedule type is *repeatable*: repeated runs/calls (with the same work) will produce the
-     same mapping of loop iterations to threads every time.
-
-  b. dynamic ("dynamic", omp_sched_dynamic):
-
-     Work is divided into ``N/chunk_size`` *contiguous* chunks (of ``chunk_size`` iterations) and
-     distributed to threads as they complete their work, first-come first-serve. If there is
-     a chunk that is very slow, the other threads can finish all remaining work instead of
-     sitting idle.
-
-     High control overhead, use when you have no idea how long each chunk will take.
-
-     Default ``chunk_size``: 1.
-
-     This schedule type does not produce repeatable mappings of iterations to threads.
-
-  c. guided ("guided", omp_sched_guided):
-
-     Work is divided into progressively smaller chunks; ``chunk_size`` sets the minimum value.
-     As with dynamic, chunks are assigned on a first-come, first-serve basis.  Less overhead than
-     dynamic (b/c ``chunk_size`` scale down).
-
-     Useful when iteration times are similar but not identical.  Less overhead than dynamic while
-     guaranteeing the waste case of static doesn't arise.
-
-     Default ``chunk_size``: approximately ``N / number_of_threads``.
-
-     This schedule type does not produce repeatable mappings of iterations to threads.
-
-  d. auto ("auto", omp_sched_auto):
-
-     The compiler decides how to map iterations to threads; this mapping is not required
-     to be one of the previous choices.
-
-     chunk_size has *no meaning* when the schedule is auto.
-     See: https://gcc.gnu.org/onlinedocs/libgomp/omp_005fset_005fschedule.html
-
-     This schedule type is not guaranteed to be repeatable.
-
-  Further documentation:
-  http://openmp.org/mp-documents/OpenMP3.1-CCard.pdf
-  https://software.intel.com/en-us/articles/openmp-loop-scheduling
-  http://publib.boulder.ibm.com/infocenter/comphelp/v8v101/index.jsp?topic=%2Fcom.ibm.xlcpp8a.doc%2Fcompiler%2Fref%2Fruompfor.htm
-\endrst*/
-struct ThreadSchedule {
-  /*!\rst
-    Construct a ThreadSchedule using the specified number of threads, schedule type, and chunk_size.
-
-    \param
-      :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
-      :schedule: static, dynamic, guided, or auto. See class comments for more details.
-      :chunk_size: how to distribute work to threads; the precise meaning depends on schedule.
-        Zero or negative chunk_size ask OpenMP to use its default behavior. See class comments for details.
-  \endrst*/
-  ThreadSchedule(int max_num_threads_in, omp_sched_t schedule_in, int chunk_size_in)
-      : max_num_threads(max_num_threads_in), schedule(schedule_in), chunk_size(chunk_size_in) {
-  }
-
-  /*!\rst
-    Construct a ThreadSchedule using the specified number of threads and schedule type with default chunk_size.
-
-    \param
-      :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
-      :schedule: static, dynamic, guided, or auto. See class comments for more details.
-  \endrst*/
-  ThreadSchedule(int max_num_threads_in, omp_sched_t schedule_in) : ThreadSchedule(max_num_threads_in, schedule_in, 0) {
-  }
-
-  /*!\rst
-    Construct a ThreadSchedule using the specified number of threads with default schedule type and chunk_size.
-
-    \param
-      :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
-  \endrst*/
-  explicit ThreadSchedule(int max_num_threads_in) : ThreadSchedule(max_num_threads_in, omp_sched_auto) {
-  }
-
-  /*!\rst
-    Construct a ThreadSchedule using the default number of threads, schedule type, and chunk_size.
-  \endrst*/
-  ThreadSchedule() : ThreadSchedule(0) {
-  }
-
-  //! The maximum number of threads for use by OpenMP (generally should be <= # cores).
-  //! The (default) value of 0 results in omp_get_num_procs() threads; note that this
-  //! is limited by omp_get_thread_limit() (set in OMP_THREAD_LIMIT).
-  int max_num_threads;
-
-  //! The thread schedule to use: static, dynamic, guided, or auto. See class comments for more details.
-  omp_sched_t schedule;
-
-  //! Chunk size to use when distributing work to threads; the precise meaning depends on schedule.
-  //! Zero or negative chunk_size ask OpenMP to use its default behavior. See class comments for details.
-  int chunk_size;
-};
-
 /*!\rst
   This object holds the input/output fields for optimizers (maximization).  On input, this can be used to specify the current
   best known point (i.e., the optimizer will indicate no new optima found if it cannot beat this value).
@@ -623,29 +554,30 @@ OL_NONNULL_POINTERS void GradientDescentOptimization(
     const DomainType& domain,
     typename ObjectiveFunctionEvaluator::StateType * objective_state) {
   const int problem_size = objective_state->GetProblemSize();
-  std::vector<double> grad_objective(problem_size);
-  std::vector<double> step(problem_size);
-  std::vector<double> next_point(problem_size);
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict grad_objective = scratch.Allocate<double>(problem_size);
+  double * restrict step = scratch.Allocate<double>(problem_size);
+  double * restrict next_point = scratch.Allocate<double>(problem_size);
 
   // read out starting point coordinates
-  objective_state->GetCurrentPoint(next_point.data());
+  objective_state->GetCurrentPoint(next_point);
 
   // save off some data for reporting if needed
 #ifdef OL_VERBOSE_PRINT
   std::vector<double> initial_point(problem_size);
   // initial value of the objective function
   double obj_func_initial = objective_evaluator.ComputeObjectiveFunction(objective_state);
-  std::copy(next_point.begin(), next_point.end(), initial_point.begin());
+  std::copy(next_point, next_point + problem_size, initial_point.begin());
 #endif
 
   const double step_tolerance = gd_parameters.tolerance / static_cast<double>(gd_parameters.max_num_steps);
   for (int i = 0; i < gd_parameters.max_num_steps; ++i) {
     double alpha_n = gd_parameters.pre_mult*std::pow(static_cast<double>(i+1), -gd_parameters.gamma);
-    objective_evaluator.ComputeGradObjectiveFunction(objective_state, grad_objective.data());
+    objective_evaluator.ComputeGradObjectiveFunction(objective_state, grad_objective);
 #ifdef OL_VERBOSE_PRINT
     if (i == 0) {
       OL_VERBOSE_PRINTF("objective fcn gradients, pre: ");
-      PrintMatrix(grad_objective.data(), 1, problem_size);
+      PrintMatrix(grad_objective, 1, problem_size);
     }
 #endif
 
@@ -654,16 +586,16 @@ OL_NONNULL_POINTERS void GradientDescentOptimization(
       step[j] = alpha_n*grad_objective[j];
     }
     // limit step size to ensure we stay inside the domain
-    domain.LimitUpdate(gd_parameters.max_relative_change, next_point.data(), step.data());
+    domain.LimitUpdate(gd_parameters.max_relative_change, next_point, step);
     // take the step
     for (int j = 0; j < problem_size; ++j) {
       next_point[j] += step[j];
     }
 
     // update state
-    objective_state->SetCurrentPoint(objective_evaluator, next_point.data());
+    objective_state->SetCurrentPoint(objective_evaluator, next_point);
 
-    double norm_step = VectorNorm(step.data(), problem_size);
+    double norm_step = VectorNorm(step, problem_size);
     if (norm_step < step_tolerance) {
       ++i;
       break;
@@ -699,7 +631,7 @@ OL_NONNULL_POINTERS void GradientDescentOptimization(
 
 #ifdef OL_VERBOSE_PRINT
   OL_VERBOSE_PRINTF("objective fcn gradients, post: ");
-  PrintMatrix(grad_objective.data(), 1, problem_size);
+  PrintMatrix(grad_objective, 1, problem_size);
 #endif
 }
 
@@ -826,15 +758,16 @@ OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int NewtonOptimization(
     return 0;
   }
   const int problem_size = objective_state->GetProblemSize();
-  std::vector<double> next_point(problem_size);
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict next_point = scratch.Allocate<double>(problem_size);
 
   // read out starting point coordinates from state
-  objective_state->GetCurrentPoint(next_point.data());
+  objective_state->GetCurrentPoint(next_point);
 
-  std::vector<int> pivot(problem_size);
-  std::vector<double> step(problem_size);
-  std::vector<double> gradient_objective(problem_size);
-  std::vector<double> hessian_objective(Square(problem_size));
+  int * restrict pivot = scratch.Allocate<int>(problem_size);
+  double * restrict step = scratch.Allocate<double>(problem_size);
+  double * restrict gradient_objective = scratch.Allocate<double>(problem_size);
+  double * restrict hessian_objective = scratch.Allocate<double>(Square(problem_size));
 
   // const double relaxation_factor = 1.0;  // under/over-relxation of newton updates
   const double step_tolerance = newton_parameters.tolerance / static_cast<double>(newton_parameters.max_num_steps*10);
@@ -844,12 +777,12 @@ OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int NewtonOptimization(
   int error = 0;
   int newton_iter;  // track the number of newton iterations
   for (newton_iter = 0; newton_iter < newton_parameters.max_num_steps; ++newton_iter) {
-    objective_evaluator.ComputeGradObjectiveFunction(objective_state, gradient_objective.data());
+    objective_evaluator.ComputeGradObjectiveFunction(objective_state, gradient_objective);
 
-    double norm_gradient_objective = VectorNorm(gradient_objective.data(), problem_size);
+    double norm_gradient_objective = VectorNorm(gradient_objective, problem_size);
 #ifdef OL_VERBOSE_PRINT
     OL_VERBOSE_PRINTF("iter %d: CFL: %.18E, objective fcn: %.18E, norm gradient: %.18E\n", newton_iter, time_factor, objective_evaluator.ComputeObjectiveFunction(objective_state), norm_gradient_objective);
-    PrintMatrix(gradient_objective.data(), 1, problem_size);
+    PrintMatrix(gradient_objective, 1, problem_size);
     OL_VERBOSE_PRINTF("iter %d: norm gradient: %.18E\n", newton_iter, norm_gradient_objective);
 #endif
     // if (unlikely(norm_gradient_objective <= tolerance && newton_iter > 0)) {
@@ -859,7 +792,7 @@ OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int NewtonOptimization(
       break;  // coordinates are no longer changing notably, so stop
     }
 
-    objective_evaluator.ComputeHessianObjectiveFunction(objective_state, hessian_objective.data());
+    objective_evaluator.ComputeHessianObjectiveFunction(objective_state, hessian_objective);
 
     // add diagonal dominance to the Hessian
     for (int j = 0; j < problem_size; ++j) {
@@ -878,40 +811,40 @@ OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int NewtonOptimization(
     // requires a secondary Newton run starting at the "converged" location with time_factor = 1e30 (huge) to double check it
 
 #ifdef OL_VERBOSE_PRINT
-    PrintMatrix(hessian_objective.data(), problem_size, problem_size);
+    PrintMatrix(hessian_objective, problem_size, problem_size);
     OL_VERBOSE_PRINTF("\n");
 #endif
     // PLU-factor the Hessian and compute the Newton update vector by solving the system of eqns:
     // H_f(\theta_n) * update_n = \nabla f(\theta_n)
-    error = ComputePLUFactorization(problem_size, pivot.data(), hessian_objective.data());
+    error = ComputePLUFactorization(problem_size, pivot, hessian_objective);
 #ifdef OL_VERBOSE_PRINT
-    PrintMatrix(hessian_objective.data(), problem_size, problem_size);
+    PrintMatrix(hessian_objective, problem_size, problem_size);
 #endif
     if (unlikely(error != 0)) {
       break;  // system is singular, stop
     }
-    PLUMatrixVectorSolve(problem_size, hessian_objective.data(), pivot.data(), gradient_objective.data());
+    PLUMatrixVectorSolve(problem_size, hessian_objective, pivot, gradient_objective);
 
     // set up desired step size
     for (int j = 0; j < problem_size; ++j) {
       step[j] = -gradient_objective[j];
     }
     // limit step size to ensure we stay inside the domain
-    domain.LimitUpdate(newton_parameters.max_relative_change, next_point.data(), step.data());
+    domain.LimitUpdate(newton_parameters.max_relative_change, next_point, step);
     // take the step
     for (int j = 0; j < problem_size; ++j) {
       next_point[j] += step[j];
     }
 
     // set new point for next run
-    objective_state->SetCurrentPoint(objective_evaluator, next_point.data());
+    objective_state->SetCurrentPoint(objective_evaluator, next_point);
 #ifdef OL_VERBOSE_PRINT
-    norm_gradient_objective = VectorNorm(gradient_objective.data(), problem_size);
+    norm_gradient_objective = VectorNorm(gradient_objective, problem_size);
     OL_VERBOSE_PRINTF("iter %d: norm update: %.18E, coord:\n", newton_iter, norm_gradient_objective);
-    PrintMatrix(next_point.data(), 1, problem_size);
+    PrintMatrix(next_point, 1, problem_size);
 #endif
 
-    double norm_step = VectorNorm(step.data(), problem_size);
+    double norm_step = VectorNorm(step, problem_size);
     if (norm_step < step_tolerance) {
       ++newton_iter;
       break;
@@ -919,14 +852,240 @@ OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT int NewtonOptimization(
   }  // end loop over newton_iter
 
 #ifdef OL_OPTIMIZATION_VERBOSE_PRINT
-  double norm_gradient_objective = VectorNorm(gradient_objective.data(), problem_size);
+  double norm_gradient_objective = VectorNorm(gradient_objective, problem_size);
   OL_VERBOSE_PRINTF("iter %d: norm gradient: %.18E\n", newton_iter, norm_gradient_objective);
-  PrintMatrix(next_point.data(), 1, problem_size);
+  PrintMatrix(next_point, 1, problem_size);
 #endif
 
   return error;
 }
 
+/*!\rst
+  Projected L-BFGS (a simplified L-BFGS-B) to optimize objective function ``f(x)`` over a box-shaped domain::
+
+    input: initial_guess
+
+    x = P(initial_guess), where P() projects onto the domain (DomainType::ProjectPointIntoDomain())
+    while (not converged) {
+      active set = coordinates where x is on a boundary and the gradient points out of the domain
+      direction = H * gradient, restricted to the free (non-active) coordinates
+      backtrack: step_size = 1, 1/2, 1/4, ... until x_new = P(x + step_size * direction) satisfies
+        f(x_new) >= f(x) + c * gradient^T (x_new - x)  (Armijo condition, c = 1.0e-4)
+      store the pair (x_new - x, gradient(x) - gradient(x_new)) and x = x_new
+    }
+
+  ``H`` approximates the inverse of the (negated) Hessian using the most recent ``history_size`` pairs via the standard
+  L-BFGS two-loop recursion (Nocedal & Wright, Algorithm 7.4), scaled by ``s^T y / y^T y`` of the newest pair.  A pair is
+  only stored if it preserves positive definiteness (``s^T y > 0``).  If ``H * gradient`` is not an ascent direction, the
+  history is discarded and we fall back to the (free part of the) gradient, scaled so its largest component is at most 1.
+
+  Unlike gradient descent and Newton, this method does not need step size heuristics (learning rate, max_relative_change,
+  diagonal dominance): the line search controls the step length and the projection enforces the domain.  So it can also
+  land *on* a boundary and find constrained optima there.  Each iteration costs one gradient evaluation and (usually) one
+  objective evaluation; L-BFGS typically needs far fewer iterations than GD, without the Hessian that Newton requires.
+
+  Projection can map distinct coordinates onto the same boundary point (e.g., two of the ``q`` points in q,p-EI pushed
+  into the same corner of a RepeatedDomain), where the objective is undefined.  A trial point whose evaluation throws
+  SingularMatrixException is treated like one failing the Armijo condition: the line search tries a shorter step.
+
+  We stop when the projected gradient, ``P(x + gradient) - x``, or the most recent step is smaller than ``tolerance``
+  (both measured in the max-norm), after max_num_steps iterations, or when the line search fails to find an improvement
+  (at the resolution allowed by max_num_line_search_steps).
+
+  Differences from full L-BFGS-B (Byrd, Lu, Nocedal, Zhu 1995): we do not compute the generalized Cauchy point or do
+  subspace minimization; the active set is identified from the gradient at the current iterate instead.  This is simpler and
+  works well when few bounds are active at the optimum.
+
+  .. Note:: the domain must provide ProjectPointIntoDomain() (e.g., TensorProductDomain, RepeatedDomain<TensorProductDomain>);
+         simplex-constrained domains are not supported.
+
+  .. Note:: in general, you should not call/instantiate this function directly.  Instead, create a LBFGSOptimizer object
+         and call its ::Optimize() function.
+
+  problem_size refers to objective_state->GetProblemSize(), the number of dimensions in a "point" aka the number of
+  variables being optimized.  (This might be the spatial dimension for EI or the number of hyperparameters for log likelihood.)
+
+  \param
+    :objective_evaluator: reference to object that can compute the objective function and its gradient
+    :lbfgs_parameters: LBFGSParameters object that describes the parameters controlling L-BFGS optimization
+      (e.g., number of iterations, history size, tolerance)
+    :domain: object specifying the domain to optimize over (see gpp_domain.hpp)
+    :objective_state[1]: a properly configured state object for the ObjectiveFunctionEvaluator template parameter
+                         objective_state.GetCurrentPoint() will be used to obtain the initial guess
+  \output
+    :objective_state[1]: a state object whose temporary data members may have been modified
+                         objective_state.GetCurrentPoint() will return the point yielding the best objective function value
+                         according to L-BFGS
+\endrst*/
+template <typename ObjectiveFunctionEvaluator, typename DomainType>
+OL_NONNULL_POINTERS void LBFGSOptimization(
+    const ObjectiveFunctionEvaluator& objective_evaluator,
+    const LBFGSParameters& lbfgs_parameters,
+    const DomainType& domain,
+    typename ObjectiveFunctionEvaluator::StateType * objective_state) {
+  // sufficient increase parameter of the Armijo condition
+  const double armijo_factor = 1.0e-4;
+  // minimum relative curvature, s^T y / y^T y, for a pair to be stored
+  const double min_curvature = std::numeric_limits<double>::epsilon();
+
+  const int problem_size = objective_state->GetProblemSize();
+  const int history_size = std::max(lbfgs_parameters.history_size, 0);
+  ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+  double * restrict current_point = scratch.Allocate<double>(problem_size);
+  double * restrict next_point = scratch.Allocate<double>(problem_size);
+  double * restrict gradient = scratch.Allocate<double>(problem_size);
+  double * restrict next_gradient = scratch.Allocate<double>(problem_size);
+  double * restrict direction = scratch.Allocate<double>(problem_size);
+  int * restrict active_set = scratch.Allocate<int>(problem_size);
+  // pairs are stored in a circular buffer; newest_pair is the index of the most recent one
+  double * restrict step_history = scratch.Allocate<double>(history_size*problem_size);
+  double * restrict gradient_change_history = scratch.Allocate<double>(history_size*problem_size);
+  double * restrict rho_history = scratch.Allocate<double>(history_size);
+  double * restrict alpha = scratch.Allocate<double>(history_size);
+  int num_pairs = 0;
+  int newest_pair = -1;
+  double gamma = 1.0;  // initial inverse Hessian scaling, s^T y / y^T y from the newest pair
+
+  // start from the projection of the initial guess so that every iterate is inside the domain
+  objective_state->GetCurrentPoint(current_point);
+  domain.ProjectPointIntoDomain(current_point);
+  objective_state->SetCurrentPoint(objective_evaluator, current_point);
+  double objective = objective_evaluator.ComputeObjectiveFunction(objective_state);
+  objective_evaluator.ComputeGradObjectiveFunction(objective_state, gradient);
+
+  for (int lbfgs_iter = 0; lbfgs_iter < lbfgs_parameters.max_num_steps; ++lbfgs_iter) {
+    // projected gradient, P(x + g) - x: zero in coordinates that are on a boundary with g pointing out
+    for (int j = 0; j < problem_size; ++j) {
+      next_point[j] = current_point[j] + gradient[j];
+    }
+    domain.ProjectPointIntoDomain(next_point);
+    double norm_projected_gradient = 0.0;
+    for (int j = 0; j < problem_size; ++j) {
+      const double projected_gradient = next_point[j] - current_point[j];
+      norm_projected_gradient = std::fmax(norm_projected_gradient, std::fabs(projected_gradient));
+      active_set[j] = (projected_gradient == 0.0 && gradient[j] != 0.0);
+    }
+    OL_VERBOSE_PRINTF("iter %d: objective fcn: %.18E, norm projected gradient: %.18E\n", lbfgs_iter, objective, norm_projected_gradient);
+    if (unlikely(norm_projected_gradient < lbfgs_parameters.tolerance)) {
+      break;  // (constrained) first order optimality holds, so stop
+    }
+
+    // two-loop recursion: direction = H * gradient, restricted to the free coordinates
+    for (int j = 0; j < problem_size; ++j) {
+      direction[j] = active_set[j] ? 0.0 : gradient[j];
+    }
+    for (int k = 0, i = newest_pair; k < num_pairs; ++k, i = (i + history_size - 1) % history_size) {
+      alpha[i] = rho_history[i]*DotProduct(step_history + i*problem_size, direction, problem_size);
+      VectorAXPY(problem_size, -alpha[i], gradient_change_history + i*problem_size, direction);
+    }
+    double scale = gamma;
+    if (num_pairs == 0) {
+      // no curvature information yet: limit the first step to unit length (max-norm)
+      scale = std::fmin(1.0, 1.0/norm_projected_gradient);
+    }
+    VectorScale(problem_size, scale, direction);
+    for (int k = 0, i = (newest_pair - num_pairs + 1 + history_size) % std::max(history_size, 1); k < num_pairs;
+         ++k, i = (i + 1) % history_size) {
+      const double beta = rho_history[i]*DotProduct(gradient_change_history + i*problem_size, direction, problem_size);
+      VectorAXPY(problem_size, alpha[i] - beta, step_history + i*problem_size, direction);
+    }
+    for (int j = 0; j < problem_size; ++j) {
+      if (active_set[j]) {
+        direction[j] = 0.0;
+      }
+    }
+
+    if (unlikely(DotProduct(gradient, direction, problem_size) <= 0.0)) {
+      // the curvature pairs produced a non-ascent direction; forget them and use the (free) gradient instead
+      num_pairs = 0;
+      const double gradient_scale = std::fmin(1.0, 1.0/norm_projected_gradient);
+      for (int j = 0; j < problem_size; ++j) {
+        direction[j] = active_set[j] ? 0.0 : gradient_scale*gradient[j];
+      }
+    }
+
+    // backtracking line search along the projected path P(x + step_size * direction)
+    double step_size = 1.0;
+    double next_objective = objective;
+    bool sufficient_increase = false;
+    for (int i = 0; i <= lbfgs_parameters.max_num_line_search_steps; ++i, step_size *= 0.5) {
+      for (int j = 0; j < problem_size; ++j) {
+        next_point[j] = current_point[j] + step_size*direction[j];
+      }
+      domain.ProjectPointIntoDomain(next_point);
+      double predicted_increase = 0.0;
+      for (int j = 0; j < problem_size; ++j) {
+        predicted_increase += gradient[j]*(next_point[j] - current_point[j]);
+      }
+      if (predicted_increase <= 0.0) {
+        continue;  // projection turned the step away from ascent; try a shorter one
+      }
+
+      try {
+        objective_state->SetCurrentPoint(objective_evaluator, next_point);
+        next_objective = objective_evaluator.ComputeObjectiveFunction(objective_state);
+      } catch (const SingularMatrixException&) {
+        continue;  // objective is undefined here (e.g., projection merged two points); try a shorter step
+      }
+      if (next_objective >= objective + armijo_factor*predicted_increase) {
+        sufficient_increase = true;
+        break;
+      }
+    }
+    if (unlikely(sufficient_increase == false)) {
+      // no improvement found; leave the state at the best point found
+      objective_state->SetCurrentPoint(objective_evaluator, current_point);
+      break;
+    }
+
+    objective_evaluator.ComputeGradObjectiveFunction(objective_state, next_gradient);
+
+    // s = x_new - x, y = g - g_new (since we maximize f, i.e., minimize -f); store into the slot after newest_pair
+    double norm_step = 0.0;
+    for (int j = 0; j < problem_size; ++j) {
+      norm_step = std::fmax(norm_step, std::fabs(next_point[j] - current_point[j]));
+    }
+    if (history_size > 0) {
+      const int slot = (newest_pair + 1) % history_size;
+      double * restrict step = step_history + slot*problem_size;
+      double * restrict gradient_change = gradient_change_history + slot*problem_size;
+      double step_dot_gradient_change = 0.0;
+      double norm_gradient_change_squared = 0.0;
+      for (int j = 0; j < problem_size; ++j) {
+        const double step_j = next_point[j] - current_point[j];
+        const double gradient_change_j = gradient[j] - next_gradient[j];
+        step_dot_gradient_change += step_j*gradient_change_j;
+        norm_gradient_change_squared += Square(gradient_change_j);
+      }
+      // only keep pairs with (sufficiently) positive curvature so that H stays positive definite;
+      // if the oldest pair lives in this slot, it is only overwritten once we know the new pair is kept
+      if (step_dot_gradient_change > min_curvature*norm_gradient_change_squared) {
+        for (int j = 0; j < problem_size; ++j) {
+          step[j] = next_point[j] - current_point[j];
+          gradient_change[j] = gradient[j] - next_gradient[j];
+        }
+        rho_history[slot] = 1.0/step_dot_gradient_change;
+        gamma = step_dot_gradient_change/norm_gradient_change_squared;
+        newest_pair = slot;
+        num_pairs = std::min(num_pairs + 1, history_size);
+      }
+    }
+
+    std::copy(next_point, next_point + problem_size, current_point);
+    std::copy(next_gradient, next_gradient + problem_size, gradient);
+    objective = next_objective;
+
+    if (norm_step < lbfgs_parameters.tolerance) {
+      break;  // coordinates are no longer changing notably, so stop
+    }
+  }  // end loop over lbfgs_iter
+
+#ifdef OL_OPTIMIZATION_VERBOSE_PRINT
+  OL_VERBOSE_PRINTF("L-BFGS final objective fcn: %.18E\n", objective);
+  PrintMatrix(current_point, 1, problem_size);
+#endif
+}
+
 /*!\rst
   The "null" or identity optimizer: it does nothing, giving the same output its inputs
   This is useful to allow the multistart optimizer template to be reused for 'dumb' searches and
@@ -1024,24 +1183,25 @@ class GradientDescentOptimizer final {
       return 0;
     }
     const int problem_size = objective_state->GetProblemSize();
-    std::vector<double> current_point(problem_size);
-    std::vector<double> next_point(problem_size);
+    ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+    double * restrict current_point = scratch.Allocate<double>(problem_size);
+    double * restrict next_point = scratch.Allocate<double>(problem_size);
 
     // loop structure expects that "next_point" contains the new current location at the start of each iteration
-    objective_state->GetCurrentPoint(next_point.data());
+    objective_state->GetCurrentPoint(next_point);
 
     for (int i = 0; i < gd_parameters.max_num_restarts; ++i) {
       // save off current location so we can compute the update norm
-      std::copy(next_point.begin(), next_point.end(), current_point.begin());
+      std::copy(next_point, next_point + problem_size, current_point);
       // get next gradient descent update
       GradientDescentOptimization(objective_evaluator, gd_parameters, domain, objective_state);
-      objective_state->GetCurrentPoint(next_point.data());
+      objective_state->GetCurrentPoint(next_point);
 
       // compute norm of the update
       for (int j = 0; j < problem_size; ++j) {
         current_point[j] -= next_point[j];
       }
-      double norm_delta_coord = VectorNorm(current_point.data(), problem_size);
+      double norm_delta_coord = VectorNorm(current_point, problem_size);
       OL_VERBOSE_PRINTF("norm of coord change: %.18E\n", norm_delta_coord);
       OL_VERBOSE_PRINTF("^Step %d^\n", i+1);
 
@@ -1129,9 +1289,98 @@ class NewtonOptimizer final {
   OL_DISALLOW_COPY_AND_ASSIGN(NewtonOptimizer);
 };
 
+/*!\rst
+  Projected L-BFGS optimization (for box-shaped domains).  This class optimizes using LBFGSOptimization() (see comments on
+  the Optimize()) function.
+\endrst*/
+template <typename ObjectiveFunctionEvaluator_, typename DomainType_>
+class LBFGSOptimizer final {
+ public:
+  using ObjectiveFunctionEvaluator = ObjectiveFunctionEvaluator_;
+  using DomainType = DomainType_;
+  using ParameterStruct = LBFGSParameters;
+
+  LBFGSOptimizer() = default;
+
+  /*!\rst
+    Uses projected L-BFGS to optimize the value of an objective function, f (e.g., EI or log marginal likelihood).
+    L-BFGS builds its own curvature model from successive gradients and chooses step lengths by line search, so it
+    needs no restarts and no step size tuning; it usually converges in far fewer objective/gradient evaluations
+    than gradient descent.
+
+    See section 2d) and 3b, ii) in the header docs and the docs for LBFGSOptimization() for more details.
+
+    Solution is guaranteed to lie within the region specified by "domain"; note that this may not be a
+    true optima (i.e., the gradient may be substantially nonzero).  The domain must provide ProjectPointIntoDomain().
+
+    problem_size refers to objective_state->GetProblemSize(), the number of dimensions in a "point" aka the number of
+    variables being optimized.  (This might be the spatial dimension for EI or the number of hyperparameters for log likelihood.)
+
+    \param
+      :objective_evaluator: reference to object that can compute the objective function and its gradient
+      :lbfgs_parameters: LBFGSParameters object that describes the parameters controlling L-BFGS optimization
+        (e.g., number of iterations, history size, tolerance)
+      :domain: object specifying the domain to optimize over (see gpp_domain.hpp)
+      :objective_state[1]: a properly configured state object for the ObjectiveFunctionEvaluator template parameter
+                           objective_state.GetCurrentPoint() will be used to obtain the initial guess
+    \output
+      :objective_state[1]: a state object whose temporary data members may have been modified
+                           objective_state.GetCurrentPoint() will return the point yielding the best objective function value
+                           according to L-BFGS
+    \return
+      number of errors, always 0
+  \endrst*/
+  int Optimize(const ObjectiveFunctionEvaluator& objective_evaluator, const ParameterStruct& lbfgs_parameters,
+               const DomainType& domain, typename ObjectiveFunctionEvaluator::StateType * objective_state)
+      const OL_NONNULL_POINTERS {
+    LBFGSOptimization(objective_evaluator, lbfgs_parameters, domain, objective_state);
+    return 0;
+  }
+
+  OL_DISALLOW_COPY_AND_ASSIGN(LBFGSOptimizer);
+};
+
+/*!\rst
+  Builds the parameters for the screening rounds of MultistartOptimizer<LBFGSOptimizer<...>>::MultistartOptimizeAdaptive():
+  ``lbfgs_parameters`` with ``max_num_steps`` replaced by ``adaptive_parameters.num_screening_steps``.
+
+  \param
+    :lbfgs_parameters: LBFGSParameters used to fully optimize the survivors
+    :adaptive_parameters: AdaptiveMultistartParameters controlling successive halving and pruning
+  \return
+    LBFGSParameters for the screening rounds
+  \raise
+    LowerBoundException if ``num_screening_steps < 1``
+\endrst*/
+inline LBFGSParameters LBFGSScreeningParameters(const LBFGSParameters& lbfgs_parameters,
+                                                const AdaptiveMultistartParameters& adaptive_parameters) {
+  if (unlikely(adaptive_parameters.num_screening_steps < 1)) {
+    OL_THROW_EXCEPTION(LowerBoundException<int>, "num_screening_steps must be positive.",
+                       adaptive_parameters.num_screening_steps, 1);
+  }
+  return LBFGSParameters(lbfgs_parameters.num_multistarts, adaptive_parameters.num_screening_steps,
+                         lbfgs_parameters.history_size, lbfgs_parameters.max_num_line_search_steps,
+                         lbfgs_parameters.tolerance);
+}
+
+/*!\rst
+  Called by MultistartOptimizer on the state that is about to run the ``multistart_index``-th start, right before its
+  ``SetCurrentPoint()``.  Does nothing by default.  State types whose results should depend only on the start (and not on
+  which thread or worker runs it, or on what that state ran before) overload this in their own namespace; e.g., the
+  monte-carlo EI state selects the random stream of the start (see gpp_math.hpp).
+
+  \param
+    :objective_state[1]: state that will run the start
+    :multistart_index: index of the start in ``initial_guesses``
+\endrst*/
+template <typename ObjectiveStateType>
+inline OL_NONNULL_POINTERS void BeginMultistart(ObjectiveStateType * OL_UNUSED(objective_state),
+                                                int OL_UNUSED(multistart_index)) noexcept {
+}
+
 /*!\rst
   This is a general, template class for multistart optimization.  It is designed to be used with the various Optimizer
-  classes in this file (e.g., NullOptimizer, GradientDescentOptimizer, NewtonOptimizer).  The multistart process is
+  classes in this file (e.g., NullOptimizer, GradientDescentOptimizer, NewtonOptimizer, LBFGSOptimizer).  The multistart process is
   multithreaded using OpenMP so that we can start from multiple initial guesses across multiple threads simultaneously.
   See section 2c) and 3b, iii) in the header docs at the top of the file for more details.
 
@@ -1193,6 +1442,9 @@ class MultistartOptimizer final {
     aka the number of variables being optimized.  (This might be the spatial dimension for EI or the
     number of hyperparameters for log likelihood.)
 
+    Before the ``i``-th start, ``BeginMultistart(&objective_state, i)`` is called on the state that runs it (see
+    BeginMultistart()), so states can key per-start resources (e.g., random streams) by ``i`` instead of by thread.
+
     \param
       :optimizer: object with the desired Optimize() functionality (e.g., do nothing for
         'dumb' search, gradient descent, etc.)
@@ -1253,8 +1505,9 @@ class MultistartOptimizer final {
     {
       double best_objective_value_so_far_local = best_objective_value_so_far_init;
       double objective_value;
-      std::vector<double> next_point_local(problem_size);
-      std::vector<double> best_next_point_local(problem_size);
+      ScratchArena::Frame scratch(&ScratchArena::ThreadLocal());
+      double * restrict next_point_local = scratch.Allocate<double>(problem_size);
+      double * restrict best_next_point_local = scratch.Allocate<double>(problem_size);
       int thread_id = omp_get_thread_num();
 
 #pragma omp for nowait schedule(runtime) reduction(+:total_errors)
@@ -1273,6 +1526,7 @@ class MultistartOptimizer final {
         // exception out of this structured block, we will capture an active exception into a std::exception_ptr.
         // Typically, the *first* exception thrown (temporally) will be captured.
         try {
+          BeginMultistart(objective_state_vector + thread_id, i);
           objective_state_vector[thread_id].SetCurrentPoint(objective_evaluator, initial_guesses + i*problem_size);
 
           if (unlikely(optimizer.Optimize(objective_evaluator, optimizer_parameters, domain, objective_state_vector + thread_id) != 0)) {
@@ -1288,14 +1542,14 @@ class MultistartOptimizer final {
 
           // update thread-locally if we found improvement
           if (best_objective_value_so_far_local < objective_value) {
-            objective_state_vector[thread_id].GetCurrentPoint(next_point_local.data());
+            objective_state_vector[thread_id].GetCurrentPoint(next_point_local);
             best_objective_value_so_far_local = objective_value;
-            std::copy(next_point_local.begin(), next_point_local.end(), best_next_point_local.begin());
+            std::copy(next_point_local, next_point_local + problem_size, best_next_point_local);
 
 #ifdef OL_OPTIMIZATION_VERBOSE_PRINT
-            if (domain.CheckPointInside(best_next_point_local.data()) == false) {
+            if (domain.CheckPointInside(best_next_point_local) == false) {
               OL_VERBOSE_PRINTF("WARNING: point outside of domain! point:\n");
-              PrintMatrix(best_next_point_local.data(), 1, problem_size);
+              PrintMatrix(best_next_point_local, 1, problem_size);
             }
 #endif
           }
@@ -1318,7 +1572,7 @@ class MultistartOptimizer final {
         if (io_container->best_objective_value_so_far < best_objective_value_so_far_local) {
           io_container->found_flag = true;
           io_container->best_objective_value_so_far = best_objective_value_so_far_local;
-          std::copy(best_next_point_local.begin(), best_next_point_local.end(), io_container->best_point.begin());
+          std::copy(best_next_point_local, best_next_point_local + problem_size, io_container->best_point.begin());
         }
       }
     }  // end omp parallel region
@@ -1341,7 +1595,270 @@ class MultistartOptimizer final {
     }
   }
 
+  /*!\rst
+    Same as MultistartOptimize() above, but the multistarts are run as tasks on a work-stealing pool
+    (see gpp_task_pool.hpp) instead of an ``omp for`` loop.  Use this when the cost of individual optimization
+    runs varies widely (e.g., Newton runs that stop early on a singular Hessian next to gradient descent runs that
+    use every restart): idle threads steal remaining starts from busy ones, so no thread sits idle while work
+    remains, and no shared counter is contended.
+
+    Starts may use ``task_pool->NestedParallelFor()`` (through the objective evaluator) to split their own work
+    across idle workers; the ``worker_id`` of each start selects its state from ``objective_state_vector``.
+
+    All inputs, outputs, and exception behavior are as in the ThreadSchedule version, except:
+
+    \param
+      :task_pool[1]: work-stealing pool to run the multistarts on
+      :objective_state_vector[task_pool->max_num_workers()]: properly constructed/configured
+        ObjectiveFunctionEvaluator::State objects, one per worker
+  \endrst*/
+  void MultistartOptimize(const Optimizer& optimizer, const ObjectiveFunctionEvaluator& objective_evaluator,
+                          const ParameterStruct& optimizer_parameters, const DomainType& domain,
+                          WorkStealingTaskPool * task_pool, double const * restrict initial_guesses,
+                          int num_multistarts,
+                          typename ObjectiveFunctionEvaluator::StateType * objective_state_vector,
+                          double * restrict function_values, OptimizationIOContainer * restrict io_container) {
+    const int problem_size = objective_state_vector[0].GetProblemSize();
+    const int num_workers = task_pool->max_num_workers();
+
+    io_container->found_flag = false;
+    // per-worker best value and point; reduced after the pool finishes
+    std::vector<double> best_objective_value_per_worker(num_workers, io_container->best_objective_value_so_far);
+    std::vector<double> best_point_per_worker(num_workers*problem_size);
+    std::atomic<int> total_errors(0);
+
+    std::exception_ptr captured_exception;
+    try {
+      task_pool->ParallelFor(num_multistarts, [&](int i, int worker_id) {
+          typename ObjectiveFunctionEvaluator::StateType * objective_state = objective_state_vector + worker_id;
+          BeginMultistart(objective_state, i);
+          objective_state->SetCurrentPoint(objective_evaluator, initial_guesses + i*problem_size);
+
+          if (unlikely(optimizer.Optimize(objective_evaluator, optimizer_parameters, domain, objective_state) != 0)) {
+            ++total_errors;
+          }
+
+          // compute objective at the new potential optimum; note Optimize() guarantees optimum point is already in state
+          const double objective_value = objective_evaluator.ComputeObjectiveFunction(objective_state);
+          if (unlikely(function_values != nullptr)) {
+            function_values[i] = objective_value;
+          }
+
+          // update worker-locally if we found improvement
+          if (best_objective_value_per_worker[worker_id] < objective_value) {
+            best_objective_value_per_worker[worker_id] = objective_value;
+            objective_state->GetCurrentPoint(best_point_per_worker.data() + worker_id*problem_size);
+          }
+        });
+    } catch (const std::exception& except) {
+      OL_ERROR_PRINTF("Multistart optimization failed on the work-stealing pool. Message:\n%s\n", except.what());
+      // the pool already ran every other start; finish the reduction so that io_container is valid, then rethrow
+      captured_exception = std::current_exception();
+    }
+
+    for (int i = 0; i < num_workers; ++i) {
+      if (io_container->best_objective_value_so_far < best_objective_value_per_worker[i]) {
+        io_container->found_flag = true;
+        io_container->best_objective_value_so_far = best_objective_value_per_worker[i];
+        std::copy(best_point_per_worker.data() + i*problem_size, best_point_per_worker.data() + (i+1)*problem_size,
+                  io_container->best_point.begin());
+      }
+    }
+
+    if (unlikely(total_errors != 0)) {
+      OL_WARNING_PRINTF("WARNING: %d newton runs exited due to singular Hessian matrices.\n", total_errors.load());
+    }
+
+    if (captured_exception != nullptr) {
+      // rethrowing nullptr is illegal
+      std::rethrow_exception(captured_exception);
+    }
+  }
+
+  /*!\rst
+    Adaptive version of MultistartOptimize(): instead of fully optimizing every start, it spends most of the optimizer
+    time on the starts that can still win.  See AdaptiveMultistartParameters (gpp_optimizer_parameters.hpp) for the
+    parameters and section 2c) in the header docs for more information.
+
+    1. **Successive halving.** Every start runs ``optimizer`` with ``screening_parameters`` (a small budget, e.g., a few
+       iterations).  The best ``survivor_fraction`` of the starts (by objective value) run another screening round,
+       continuing from where they stopped; this repeats until at most ``min_num_survivors`` starts remain.
+    2. **Full optimization.** The survivors continue with ``optimizer_parameters``, best-first.  Threads share the best
+       objective value found so far through a lock-free atomic; a survivor whose objective trails it by more than
+       ``prune_gap`` is dropped without further optimization.
+
+    Threads pull starts from a shared queue (an atomic counter), so a few slow starts do not leave other threads idle;
+    ``thread_schedule.schedule`` and ``chunk_size`` are therefore not used.
+
+    Each round calls ``optimizer.Optimize()`` again from the point where the previous round stopped, so any internal
+    optimizer state (e.g., the L-BFGS history) is rebuilt each round.  Use this mode with iterative optimizers whose
+    parameter structs bound the number of steps (e.g., GradientDescentOptimizer, LBFGSOptimizer).  With
+    ``num_multistarts`` in the hundreds or thousands and ``min_num_survivors`` around the number of threads, nearly all
+    starts stop after screening.
+
+    Inputs, outputs, and exception behavior are as in MultistartOptimize(); the additional inputs are below.  Dropped
+    starts report their last (screened) objective value in ``function_values``.
+
+    L-BFGS EI and hyperparameter optimization (ComputeOptimalPointsToSampleViaMultistartLBFGS() in gpp_math.hpp and
+    MultistartLBFGSHyperparameterOptimization() in gpp_model_selection.hpp) run this when given AdaptiveMultistartParameters,
+    screening with LBFGSScreeningParameters().
+
+    \param
+      :screening_parameters: Optimizer::ParameterStruct for the (cheap) screening rounds
+      :optimizer_parameters: Optimizer::ParameterStruct for fully optimizing the survivors
+      :adaptive_parameters: AdaptiveMultistartParameters controlling successive halving and pruning
+    \raise
+      BoundsException if ``survivor_fraction`` is not in ``(0, 1)``; LowerBoundException if ``min_num_survivors < 1``;
+      otherwise as in MultistartOptimize()
+  \endrst*/
+  void MultistartOptimizeAdaptive(const Optimizer& optimizer, const ObjectiveFunctionEvaluator& objective_evaluator,
+                                  const ParameterStruct& screening_parameters,
+                                  const ParameterStruct& optimizer_parameters,
+                                  const AdaptiveMultistartParameters& adaptive_parameters, const DomainType& domain,
+                                  const ThreadSchedule& thread_schedule, double const * restrict initial_guesses,
+                                  int num_multistarts,
+                                  typename ObjectiveFunctionEvaluator::StateType * objective_state_vector,
+                                  double * restrict function_values, OptimizationIOContainer * restrict io_container) {
+    if (unlikely(!(adaptive_parameters.survivor_fraction > 0.0 && adaptive_parameters.survivor_fraction < 1.0))) {
+      OL_THROW_EXCEPTION(BoundsException<double>, "survivor_fraction must lie in (0, 1).",
+                         adaptive_parameters.survivor_fraction, 0.0, 1.0);
+    }
+    if (unlikely(adaptive_parameters.min_num_survivors < 1)) {
+      OL_THROW_EXCEPTION(LowerBoundException<int>, "min_num_survivors must be positive.",
+                         adaptive_parameters.min_num_survivors, 1);
+    }
+    const int problem_size = objective_state_vector[0].GetProblemSize();
+
+    // see MultistartOptimize() for how exceptions are captured from the OpenMP parallel regions
+    std::once_flag exception_capture_flag;
+    std::exception_ptr captured_exception;
+    std::atomic<int> total_errors(0);
+
+    // each start resumes from where its previous round stopped
+    std::vector<double> current_points(initial_guesses, initial_guesses + num_multistarts*problem_size);
+    std::vector<double> objective_values(num_multistarts, -std::numeric_limits<double>::infinity());
+    std::atomic<double> best_objective_value(io_container->best_objective_value_so_far);
+    auto better_start = [&objective_values](int i, int j) {
+      return objective_values[i] > objective_values[j];
+    };
+
+    std::vector<int> survivors(num_multistarts);
+    std::iota(survivors.begin(), survivors.end(), 0);
+    const double no_pruning = std::numeric_limits<double>::infinity();
+    while (true) {
+      OptimizeStarts(optimizer, objective_evaluator, screening_parameters, domain, thread_schedule, survivors,
+                     no_pruning, objective_state_vector, current_points.data(), objective_values.data(),
+                     &best_objective_value, &total_errors, &exception_capture_flag, &captured_exception);
+      const int num_survivors = survivors.size();
+      if (num_survivors <= adaptive_parameters.min_num_survivors) {
+        break;
+      }
+      // keep the best survivor_fraction (at least min_num_survivors and always at least one fewer than now)
+      int num_kept = static_cast<int>(std::ceil(adaptive_parameters.survivor_fraction*static_cast<double>(num_survivors)));
+      num_kept = std::min(std::max(num_kept, adaptive_parameters.min_num_survivors), num_survivors - 1);
+      std::nth_element(survivors.begin(), survivors.begin() + (num_kept - 1), survivors.end(), better_start);
+      survivors.resize(num_kept);
+    }
+
+    // fully optimize the survivors, best first so that the pruning bound tightens early
+    std::sort(survivors.begin(), survivors.end(), better_start);
+    OptimizeStarts(optimizer, objective_evaluator, optimizer_parameters, domain, thread_schedule, survivors,
+                   adaptive_parameters.prune_gap, objective_state_vector, current_points.data(),
+                   objective_values.data(), &best_objective_value, &total_errors, &exception_capture_flag,
+                   &captured_exception);
+
+    io_container->found_flag = false;
+    for (int i = 0; i < num_multistarts; ++i) {
+      if (unlikely(function_values != nullptr)) {
+        function_values[i] = objective_values[i];
+      }
+      if (io_container->best_objective_value_so_far < objective_values[i]) {
+        io_container->found_flag = true;
+        io_container->best_objective_value_so_far = objective_values[i];
+        std::copy(current_points.data() + i*problem_size, current_points.data() + (i+1)*problem_size,
+                  io_container->best_point.begin());
+      }
+    }
+
+    if (unlikely(total_errors != 0)) {
+      OL_WARNING_PRINTF("WARNING: %d optimizer runs reported errors.\n", total_errors.load());
+    }
+
+    if (captured_exception != nullptr) {
+      // rethrowing nullptr is illegal
+      std::rethrow_exception(captured_exception);
+    }
+  }
+
   OL_DISALLOW_COPY_AND_ASSIGN(MultistartOptimizer);
+
+ private:
+  /*!\rst
+    Runs ``optimizer`` (with ``parameters``) on each start listed in ``starts``, in order of the list, resuming from
+    ``current_points``.  Threads pull starts from a shared queue.  Starts whose objective trails ``best_objective_value``
+    by more than ``prune_gap`` are skipped.  Exceptions are captured (once) into ``captured_exception``; the start that
+    threw gets an objective value of ``-infinity``.
+
+    \param
+      :starts[num_starts]: indices of the starts to optimize
+      :prune_gap: skip starts whose objective is below ``best_objective_value - prune_gap``
+      :current_points[problem_size][num_multistarts]: point each start resumes from
+      :objective_values[num_multistarts]: objective value at each point of current_points
+      :best_objective_value[1]: best objective value found so far (shared by all threads)
+    \output
+      :objective_state_vector[thread_schedule.max_num_threads]: internal states of state objects may be modified
+      :current_points[problem_size][num_multistarts]: end point of the optimized starts
+      :objective_values[num_multistarts]: objective value at the end point of the optimized starts
+      :best_objective_value[1]: updated with the best value found
+      :total_errors[1]: incremented for each run where Optimize() reported errors
+  \endrst*/
+  static void OptimizeStarts(const Optimizer& optimizer, const ObjectiveFunctionEvaluator& objective_evaluator,
+                             const ParameterStruct& parameters, const DomainType& domain,
+                             const ThreadSchedule& thread_schedule, const std::vector<int>& starts, double prune_gap,
+                             typename ObjectiveFunctionEvaluator::StateType * objective_state_vector,
+                             double * restrict current_points, double * restrict objective_values,
+                             std::atomic<double> * best_objective_value, std::atomic<int> * total_errors,
+                             std::once_flag * exception_capture_flag, std::exception_ptr * captured_exception) {
+    const int problem_size = objective_state_vector[0].GetProblemSize();
+    const int num_starts = starts.size();
+    // shared work queue: the next entry of starts to hand out
+    std::atomic<int> next_start(0);
+
+#pragma omp parallel num_threads(thread_schedule.max_num_threads)
+    {
+      const int thread_id = omp_get_thread_num();
+      for (int k = next_start++; k < num_starts; k = next_start++) {
+        const int i = starts[k];
+        if (objective_values[i] < best_objective_value->load(std::memory_order_relaxed) - prune_gap) {
+          continue;  // dominated by the best start so far; not worth optimizing
+        }
+
+        // exceptions cannot leave the parallel region; see MultistartOptimize()
+        try {
+          BeginMultistart(objective_state_vector + thread_id, i);
+          objective_state_vector[thread_id].SetCurrentPoint(objective_evaluator, current_points + i*problem_size);
+          if (unlikely(optimizer.Optimize(objective_evaluator, parameters, domain, objective_state_vector + thread_id) != 0)) {
+            ++(*total_errors);
+          }
+          const double objective_value = objective_evaluator.ComputeObjectiveFunction(objective_state_vector + thread_id);
+          objective_state_vector[thread_id].GetCurrentPoint(current_points + i*problem_size);
+          objective_values[i] = objective_value;
+
+          // publish a new global best (lock-free max)
+          double best_so_far = best_objective_value->load(std::memory_order_relaxed);
+          while (best_so_far < objective_value &&
+                 !best_objective_value->compare_exchange_weak(best_so_far, objective_value, std::memory_order_relaxed)) {
+          }
+        } catch (const std::exception& except) {
+          OL_ERROR_PRINTF("Thread %d of %d failed on start %d. Message:\n%s\n", thread_id, thread_schedule.max_num_threads, i, except.what());
+          objective_values[i] = -std::numeric_limits<double>::infinity();
+          std::call_once(*exception_capture_flag, [captured_exception]() {
+              *captured_exception = std::current_exception();
+            });
+        }
+      }
+    }  // end omp parallel region
+  }
 };
 
 }  // end namespace optimal_learning
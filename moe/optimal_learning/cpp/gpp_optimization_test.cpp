@@ -57,6 +57,8 @@
 #include <cmath>
 
 #include <algorithm>
+#include <limits>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -67,6 +69,8 @@
 #include "gpp_mock_optimization_objective_functions.hpp"
 #include "gpp_optimization.hpp"
 #include "gpp_optimizer_parameters.hpp"
+#include "gpp_random.hpp"
+#include "gpp_task_pool.hpp"
 #include "gpp_test_utils.hpp"
 
 namespace optimal_learning {
@@ -734,6 +738,258 @@ OL_WARN_UNUSED_RESULT int MockObjectiveNewtonConstrainedOptimizationTestCore() {
   return total_errors;
 }
 
+/*!\rst
+  Test L-BFGS's ability to optimize the function represented by MockEvaluator in an unconstrained setting, both
+  directly and through MultistartOptimizer.
+
+  \return
+    number of test failures (invalid results, non-convergence, etc.)
+\endrst*/
+template <typename MockEvaluator>
+OL_WARN_UNUSED_RESULT int MockObjectiveLBFGSOptimizationTestCore() {
+  using DomainType = TensorProductDomain;
+  const int dim = 3;
+
+  double initial_objective;
+  double final_objective;
+
+  // l-bfgs parameters
+  const int history_size = 5;
+  const int max_num_line_search_steps = 30;
+  const double tolerance = 1.0e-13;
+  const int max_lbfgs_steps = 100;
+  LBFGSParameters lbfgs_parameters(1, max_lbfgs_steps, history_size, max_num_line_search_steps, tolerance);
+
+  int total_errors = 0;
+  int current_errors = 0;
+
+  std::vector<ClosedInterval> domain_bounds(dim, {-1.0, 1.0});
+  DomainType domain(domain_bounds.data(), dim);
+
+  std::vector<double> maxima_point_input(dim, 0.5);
+
+  std::vector<double> wrong_point(dim, 0.2);
+
+  std::vector<double> point_optimized(dim);
+  std::vector<double> temp_point(dim);
+
+  MockEvaluator objective_eval(maxima_point_input.data(), dim);
+
+  // get optima data
+  objective_eval.GetOptimumPoint(temp_point.data());
+  const std::vector<double> maxima_point(temp_point);
+  const double maxima_value = objective_eval.GetOptimumValue();
+
+  // build state, setting initial point to maxima_point
+  typename MockEvaluator::StateType objective_state(objective_eval, maxima_point.data());
+
+  // create l-bfgs optimizer
+  LBFGSOptimizer<MockEvaluator, DomainType> lbfgs_opt;
+
+  // verify that l-bfgs does not move from the optima if we start it there
+  total_errors += lbfgs_opt.Optimize(objective_eval, lbfgs_parameters, domain, &objective_state);
+  objective_state.GetCurrentPoint(point_optimized.data());
+  for (int i = 0; i < dim; ++i) {
+    if (!CheckDoubleWithinRelative(point_optimized[i], maxima_point[i], 0.0)) {
+      ++total_errors;
+    }
+  }
+
+  // store initial objective function
+  objective_state.SetCurrentPoint(objective_eval, wrong_point.data());
+  initial_objective = objective_eval.ComputeObjectiveFunction(&objective_state);
+
+  // verify that l-bfgs can find the optima
+  total_errors += lbfgs_opt.Optimize(objective_eval, lbfgs_parameters, domain, &objective_state);
+  objective_state.GetCurrentPoint(point_optimized.data());
+#ifdef OL_VERBOSE_PRINT
+  PrintMatrix(point_optimized.data(), 1, dim);
+#endif
+
+  for (int i = 0; i < dim; ++i) {
+    if (!CheckDoubleWithinRelative(point_optimized[i], maxima_point[i], tolerance)) {
+      ++total_errors;
+    }
+  }
+  final_objective = objective_eval.ComputeObjectiveFunction(&objective_state);
+  // objective function value at optima should be correct
+  if (!CheckDoubleWithin(final_objective, maxima_value, tolerance)) {
+    ++total_errors;
+  }
+  // objective function cannot get worse
+  if (final_objective < initial_objective) {
+    ++total_errors;
+  }
+
+  // check that objective function gradients are small
+  std::vector<double> grad_objective(dim);
+  objective_eval.ComputeGradObjectiveFunction(&objective_state, grad_objective.data());
+
+  current_errors = 0;
+  for (const auto& entry : grad_objective) {
+    if (!CheckDoubleWithin(entry, 0.0, tolerance)) {
+      ++current_errors;
+    }
+  }
+  total_errors += current_errors;
+
+  // verify that l-bfgs works unchanged inside the multistart optimizer
+  const int num_multistarts = 8;
+  const int max_num_threads = 2;
+  std::vector<double> initial_guesses(dim*num_multistarts);
+  for (int i = 0; i < num_multistarts; ++i) {
+    for (int j = 0; j < dim; ++j) {
+      initial_guesses[i*dim + j] = -0.9 + 0.25*static_cast<double>(i) - 0.1*static_cast<double>(j);
+    }
+  }
+  std::vector<typename MockEvaluator::StateType> state_vector;
+  state_vector.reserve(max_num_threads);
+  for (int i = 0; i < max_num_threads; ++i) {
+    state_vector.emplace_back(objective_eval, wrong_point.data());
+  }
+  std::vector<double> function_values(num_multistarts);
+  OptimizationIOContainer io_container(dim, initial_objective, wrong_point.data());
+  MultistartOptimizer<LBFGSOptimizer<MockEvaluator, DomainType> > multistart_optimizer;
+  multistart_optimizer.MultistartOptimize(lbfgs_opt, objective_eval, lbfgs_parameters, domain,
+                                          ThreadSchedule(max_num_threads), initial_guesses.data(), num_multistarts,
+                                          state_vector.data(), function_values.data(), &io_container);
+  if (!io_container.found_flag) {
+    ++total_errors;
+  }
+  for (int i = 0; i < dim; ++i) {
+    if (!CheckDoubleWithinRelative(io_container.best_point[i], maxima_point[i], tolerance)) {
+      ++total_errors;
+    }
+  }
+  for (const auto& value : function_values) {
+    if (!CheckDoubleWithin(value, maxima_value, tolerance)) {
+      ++total_errors;
+    }
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Test L-BFGS's ability to optimize the function represented by MockEvaluator in a constrained setting.
+  Unlike GD and Newton, L-BFGS projects onto the domain, so it should land exactly on the boundary.
+
+  \return
+    number of test failures (invalid results, non-convergence, etc.)
+\endrst*/
+template <typename MockEvaluator>
+OL_WARN_UNUSED_RESULT int MockObjectiveLBFGSConstrainedOptimizationTestCore() {
+  using DomainType = TensorProductDomain;
+  const int dim = 3;
+
+  double initial_objective;
+  double final_objective;
+
+  // l-bfgs parameters
+  const int history_size = 5;
+  const int max_num_line_search_steps = 30;
+  const double tolerance = 1.0e-13;
+  const int max_lbfgs_steps = 100;
+  LBFGSParameters lbfgs_parameters(1, max_lbfgs_steps, history_size, max_num_line_search_steps, tolerance);
+
+  int total_errors = 0;
+  int current_errors = 0;
+
+  std::vector<double> maxima_point_input(dim, 0.5);
+
+  // start outside the domain too: l-bfgs projects the initial guess onto the domain
+  std::vector<std::vector<double> > wrong_points = {
+    std::vector<double>(dim, 0.2),
+    {0.9, -0.3, 0.1}};
+
+  std::vector<double> point_optimized(dim);
+  std::vector<double> temp_point(dim);
+
+  std::vector<ClosedInterval> domain_bounds = {
+    {0.05, 0.32},
+    {0.05, 0.6},
+    {0.05, 0.32}};
+  DomainType domain(domain_bounds.data(), dim);
+
+  MockEvaluator objective_eval(maxima_point_input.data(), dim);
+
+  // get optima data
+  objective_eval.GetOptimumPoint(temp_point.data());
+  const std::vector<double> maxima_point(temp_point);
+
+  // work out what the maxima point would be given the domain constraints
+  std::vector<double> best_in_domain_point(maxima_point);
+  for (int i = 0; i < dim; ++i) {
+    if (best_in_domain_point[i] > domain_bounds[i].max) {
+      best_in_domain_point[i] = domain_bounds[i].max;
+    } else if (best_in_domain_point[i] < domain_bounds[i].min) {
+      best_in_domain_point[i] = domain_bounds[i].min;
+    }
+  }
+
+  // build state, setting point initially to the constrained maxima
+  typename MockEvaluator::StateType objective_state(objective_eval, best_in_domain_point.data());
+
+  // create l-bfgs optimizer
+  LBFGSOptimizer<MockEvaluator, DomainType> lbfgs_opt;
+
+  // verify that l-bfgs does not move from the optima if we start it there
+  total_errors += lbfgs_opt.Optimize(objective_eval, lbfgs_parameters, domain, &objective_state);
+  objective_state.GetCurrentPoint(point_optimized.data());
+  for (int i = 0; i < dim; ++i) {
+    if (!CheckDoubleWithinRelative(point_optimized[i], best_in_domain_point[i], 0.0)) {
+      ++total_errors;
+    }
+  }
+
+  for (const auto& wrong_point : wrong_points) {
+    // store initial objective function (at the projection of wrong_point)
+    temp_point = wrong_point;
+    domain.ProjectPointIntoDomain(temp_point.data());
+    objective_state.SetCurrentPoint(objective_eval, temp_point.data());
+    initial_objective = objective_eval.ComputeObjectiveFunction(&objective_state);
+
+    // verify that l-bfgs can find the optima
+    objective_state.SetCurrentPoint(objective_eval, wrong_point.data());
+    total_errors += lbfgs_opt.Optimize(objective_eval, lbfgs_parameters, domain, &objective_state);
+    objective_state.GetCurrentPoint(point_optimized.data());
+#ifdef OL_VERBOSE_PRINT
+    PrintMatrix(point_optimized.data(), 1, dim);
+#endif
+
+    if (!domain.CheckPointInside(point_optimized.data())) {
+      ++total_errors;
+    }
+    for (int i = 0; i < dim; ++i) {
+      if (!CheckDoubleWithinRelative(point_optimized[i], best_in_domain_point[i], tolerance)) {
+        ++total_errors;
+      }
+    }
+    final_objective = objective_eval.ComputeObjectiveFunction(&objective_state);
+    // objective function cannot get worse
+    if (final_objective < initial_objective) {
+      ++total_errors;
+    }
+
+    // check that objective function gradients are small
+    std::vector<double> grad_objective(dim);
+    objective_eval.ComputeGradObjectiveFunction(&objective_state, grad_objective.data());
+
+    current_errors = 0;
+    for (IdentifyType<decltype(grad_objective)>::type::size_type i = 0, size = grad_objective.size(); i < size; ++i) {
+      // only get 0 gradients if the true optima lies inside the domain (in a particular dimension dimension)
+      if (domain_bounds[i].IsInside(maxima_point[i])) {
+        if (!CheckDoubleWithin(grad_objective[i], 0.0, tolerance)) {
+          ++current_errors;
+        }
+      }
+    }
+    total_errors += current_errors;
+  }
+
+  return total_errors;
+}
+
 int MultistartOptimizeExceptionHandlingTest() {
   using DomainType = DummyDomain;
   DomainType dummy_domain;
@@ -817,11 +1073,222 @@ int MultistartOptimizeExceptionHandlingTest() {
   return total_errors;
 }
 
+/*!\rst
+  Checks that MultistartOptimize() on a WorkStealingTaskPool matches the OpenMP (ThreadSchedule) version: same
+  function_values and best point, and the same exception handling.
+
+  \return
+    number of test failures: 0 if the work-stealing backend is working properly
+\endrst*/
+int MultistartOptimizeWorkStealingTest() {
+  const int max_num_threads = 4;
+  WorkStealingTaskPool task_pool(max_num_threads);
+  int total_errors = 0;
+
+  // l-bfgs on the quadratic: both backends run the same starts, so results must be identical
+  {
+    using DomainType = TensorProductDomain;
+    using OptimizerType = LBFGSOptimizer<SimpleQuadraticEvaluator, DomainType>;
+    const int dim = 3;
+    const int num_multistarts = 100;
+    std::vector<ClosedInterval> domain_bounds(dim, {-1.0, 1.0});
+    DomainType domain(domain_bounds.data(), dim);
+    std::vector<double> maxima_point(dim, 0.5);
+    SimpleQuadraticEvaluator objective_eval(maxima_point.data(), dim);
+    LBFGSParameters lbfgs_parameters(num_multistarts, 100, 5, 30, 1.0e-13);
+
+    UniformRandomGenerator uniform_generator(2718);
+    std::vector<double> initial_guesses(dim*num_multistarts);
+    domain.GenerateUniformPointsInDomain(num_multistarts, &uniform_generator, initial_guesses.data());
+
+    std::vector<typename SimpleQuadraticEvaluator::StateType> state_vector;
+    state_vector.reserve(max_num_threads);
+    for (int i = 0; i < max_num_threads; ++i) {
+      state_vector.emplace_back(objective_eval, initial_guesses.data());
+    }
+
+    OptimizerType lbfgs_opt;
+    MultistartOptimizer<OptimizerType> multistart_optimizer;
+    std::vector<double> function_values_omp(num_multistarts);
+    std::vector<double> function_values_pool(num_multistarts);
+    OptimizationIOContainer io_container_omp(dim, -std::numeric_limits<double>::max(), initial_guesses.data());
+    OptimizationIOContainer io_container_pool(dim, -std::numeric_limits<double>::max(), initial_guesses.data());
+    multistart_optimizer.MultistartOptimize(lbfgs_opt, objective_eval, lbfgs_parameters, domain,
+                                            ThreadSchedule(max_num_threads, omp_sched_static), initial_guesses.data(),
+                                            num_multistarts, state_vector.data(), function_values_omp.data(),
+                                            &io_container_omp);
+    multistart_optimizer.MultistartOptimize(lbfgs_opt, objective_eval, lbfgs_parameters, domain, &task_pool,
+                                            initial_guesses.data(), num_multistarts, state_vector.data(),
+                                            function_values_pool.data(), &io_container_pool);
+
+    if (function_values_omp != function_values_pool) {
+      ++total_errors;
+    }
+    if (!io_container_pool.found_flag ||
+        io_container_pool.best_objective_value_so_far != io_container_omp.best_objective_value_so_far) {
+      ++total_errors;
+    }
+    for (int i = 0; i < dim; ++i) {
+      if (!CheckDoubleWithinRelative(io_container_pool.best_point[i], maxima_point[i], 1.0e-13)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // exceptions: only x == 1.0 throws; every other start still runs and io_container is valid
+  {
+    using DomainType = DummyDomain;
+    DomainType dummy_domain;
+    NullOptimizer<ExceptionEvaluator, DomainType> null_opt;
+    typename NullOptimizer<ExceptionEvaluator, DomainType>::ParameterStruct null_parameters;
+    MultistartOptimizer<NullOptimizer<ExceptionEvaluator, DomainType> > multistart_optimizer;
+
+    const int num_multistarts = 100;
+    std::vector<double> initial_guesses(num_multistarts);
+    std::iota(initial_guesses.begin(), initial_guesses.end(), -20.0);
+    const double max_value = *std::max_element(initial_guesses.begin(), initial_guesses.end());
+
+    double current_point = 0.0;
+    ExceptionEvaluator exception_eval("x == 1");
+    std::vector<typename ExceptionEvaluator::StateType> state_vector;
+    state_vector.reserve(max_num_threads);
+    for (int i = 0; i < max_num_threads; ++i) {
+      state_vector.emplace_back(exception_eval, &current_point);
+    }
+
+    double dummy_value = -100.0;
+    OptimizationIOContainer io_container(state_vector[0].GetProblemSize(), dummy_value, &dummy_value);
+    try {
+      // increment errors: we must catch an exception to decrement
+      total_errors += 1;
+      multistart_optimizer.MultistartOptimize(null_opt, exception_eval, null_parameters, dummy_domain, &task_pool,
+                                              initial_guesses.data(), num_multistarts, state_vector.data(), nullptr,
+                                              &io_container);
+    } catch (const InvalidValueException<double>& except) {
+      if (except.value() != 1.0) {
+        ++total_errors;
+      }
+      // exception occurred, good! remove the increment from the try block.
+      total_errors -= 1;
+    }
+
+    if (io_container.best_objective_value_so_far != max_value || io_container.best_point[0] != max_value) {
+      ++total_errors;
+    }
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that MultistartOptimizer::MultistartOptimizeAdaptive() (successive halving + pruning) finds the optimum, reports
+  consistent function_values and io_container contents, prunes starts that cannot beat the known best, and rejects invalid
+  parameters.
+
+  \return
+    number of test failures: 0 if adaptive multistart optimization is working properly
+\endrst*/
+int MultistartOptimizeAdaptiveTest() {
+  using DomainType = TensorProductDomain;
+  using OptimizerType = LBFGSOptimizer<SimpleQuadraticEvaluator, DomainType>;
+  const int dim = 3;
+  const int num_multistarts = 200;
+  const int max_num_threads = 4;
+  const double tolerance = 1.0e-13;
+
+  std::vector<ClosedInterval> domain_bounds(dim, {-1.0, 1.0});
+  DomainType domain(domain_bounds.data(), dim);
+  std::vector<double> maxima_point(dim, 0.5);
+  SimpleQuadraticEvaluator objective_eval(maxima_point.data(), dim);
+
+  // screening takes a single step; survivors are optimized fully
+  LBFGSParameters screening_parameters(num_multistarts, 1, 5, 30, tolerance);
+  LBFGSParameters lbfgs_parameters(num_multistarts, 100, 5, 30, tolerance);
+
+  UniformRandomGenerator uniform_generator(31415);
+  std::vector<double> initial_guesses(dim*num_multistarts);
+  domain.GenerateUniformPointsInDomain(num_multistarts, &uniform_generator, initial_guesses.data());
+
+  std::vector<typename SimpleQuadraticEvaluator::StateType> state_vector;
+  state_vector.reserve(max_num_threads);
+  for (int i = 0; i < max_num_threads; ++i) {
+    state_vector.emplace_back(objective_eval, initial_guesses.data());
+  }
+
+  OptimizerType lbfgs_opt;
+  MultistartOptimizer<OptimizerType> multistart_optimizer;
+  std::vector<double> function_values(num_multistarts);
+  int total_errors = 0;
+
+  // successive halving down to 4 survivors, no pruning: must find the optimum
+  {
+    AdaptiveMultistartParameters adaptive_parameters(1, 0.5, max_num_threads, std::numeric_limits<double>::infinity());
+    OptimizationIOContainer io_container(dim, -std::numeric_limits<double>::max(), initial_guesses.data());
+    multistart_optimizer.MultistartOptimizeAdaptive(lbfgs_opt, objective_eval, screening_parameters, lbfgs_parameters,
+                                                    adaptive_parameters, domain, ThreadSchedule(max_num_threads),
+                                                    initial_guesses.data(), num_multistarts, state_vector.data(),
+                                                    function_values.data(), &io_container);
+    if (!io_container.found_flag) {
+      ++total_errors;
+    }
+    for (int i = 0; i < dim; ++i) {
+      if (!CheckDoubleWithinRelative(io_container.best_point[i], maxima_point[i], tolerance)) {
+        ++total_errors;
+      }
+    }
+    if (!CheckDoubleWithin(io_container.best_objective_value_so_far, objective_eval.GetOptimumValue(), tolerance)) {
+      ++total_errors;
+    }
+    // io_container reports the best of function_values; every value is finite and at most the optimum
+    if (*std::max_element(function_values.begin(), function_values.end()) != io_container.best_objective_value_so_far) {
+      ++total_errors;
+    }
+    for (const auto& value : function_values) {
+      if (!std::isfinite(value) || value > objective_eval.GetOptimumValue()) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // the known best is already optimal and prune_gap = 0: every survivor is pruned, nothing improves
+  {
+    AdaptiveMultistartParameters adaptive_parameters(1, 0.5, max_num_threads, 0.0);
+    OptimizationIOContainer io_container(dim, objective_eval.GetOptimumValue(), maxima_point.data());
+    multistart_optimizer.MultistartOptimizeAdaptive(lbfgs_opt, objective_eval, screening_parameters, lbfgs_parameters,
+                                                    adaptive_parameters, domain, ThreadSchedule(max_num_threads),
+                                                    initial_guesses.data(), num_multistarts, state_vector.data(),
+                                                    nullptr, &io_container);
+    if (io_container.found_flag || io_container.best_point != maxima_point) {
+      ++total_errors;
+    }
+  }
+
+  // survivor_fraction must lie in (0, 1)
+  {
+    AdaptiveMultistartParameters adaptive_parameters(1, 1.0, max_num_threads, 0.0);
+    OptimizationIOContainer io_container(dim);
+    try {
+      // increment errors: we must catch an exception to decrement
+      total_errors += 1;
+      multistart_optimizer.MultistartOptimizeAdaptive(lbfgs_opt, objective_eval, screening_parameters, lbfgs_parameters,
+                                                      adaptive_parameters, domain, ThreadSchedule(max_num_threads),
+                                                      initial_guesses.data(), num_multistarts, state_vector.data(),
+                                                      nullptr, &io_container);
+    } catch (const BoundsException<double>&) {
+      // exception occurred, good! remove the increment from the try block.
+      total_errors -= 1;
+    }
+  }
+
+  return total_errors;
+}
+
 /*!\rst
   Checks that specified optimizer is working correctly:
 
   * kGradientDescent
   * kNewton
+  * kLBFGS
 
   Checks unconstrained and constrained optimization against polynomial
   objective function(s).
@@ -845,6 +1312,12 @@ int RunSimpleObjectiveOptimizationTests(OptimizerTypes optimizer_type) {
       errors += MockObjectiveNewtonConstrainedOptimizationTestCore<SimpleQuadraticEvaluator>();
       return errors;
     }
+    case OptimizerTypes::kLBFGS: {  // l-bfgs tests
+      int errors = 0;
+      errors += MockObjectiveLBFGSOptimizationTestCore<SimpleQuadraticEvaluator>();
+      errors += MockObjectiveLBFGSConstrainedOptimizationTestCore<SimpleQuadraticEvaluator>();
+      return errors;
+    }
     default: {
       OL_ERROR_PRINTF("%s: INVALID optimizer_type choice: %d\n", OL_CURRENT_FUNCTION_NAME, optimizer_type);
       return 1;
@@ -858,7 +1331,10 @@ int RunOptimizationTests() {
   int total_errors = 0;
   total_errors += RunSimpleObjectiveOptimizationTests(OptimizerTypes::kGradientDescent);
   total_errors += RunSimpleObjectiveOptimizationTests(OptimizerTypes::kNewton);
+  total_errors += RunSimpleObjectiveOptimizationTests(OptimizerTypes::kLBFGS);
   total_errors += MultistartOptimizeExceptionHandlingTest();
+  total_errors += MultistartOptimizeWorkStealingTest();
+  total_errors += MultistartOptimizeAdaptiveTest();
   return total_errors;
 }
 
@@ -20,11 +20,14 @@ namespace optimal_learning {
 
   * kGradientDescent
   * kNewton
+  * kLBFGS
 
   by checking unconstrained and constrained optimization against polynomial
   objective function(s).
 
-  Also checks that MultistartOptimizer::MultistartOptimize() handles exceptions correctly and without crashing.
+  Also checks that MultistartOptimizer::MultistartOptimize() handles exceptions correctly and without crashing, that the
+  work-stealing (WorkStealingTaskPool) version matches the OpenMP version, and
+  that MultistartOptimizer::MultistartOptimizeAdaptive() (successive halving + pruning) finds the optimum.
 
   \return
     number of test failures: 0 if optimizer is working properly
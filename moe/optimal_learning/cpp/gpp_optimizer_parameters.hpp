@@ -1,7 +1,7 @@
 /*!
   \file gpp_optimizer_parameters.hpp
   \rst
-  This file specifies OptimizerParameters structs (e.g., GradientDescent, Newton) for holding values that control the behavior
+  This file specifies OptimizerParameters structs (e.g., GradientDescent, Newton, L-BFGS) for holding values that control the behavior
   of the optimizers in gpp_optimization.hpp.  For example, max step sizes, number of iterations, step size control, etc. are all
   specified through these structs.
 
@@ -28,6 +28,8 @@ enum class OptimizerTypes {
   kGradientDescent = 1,
   //! NewtonOptimizer<>
   kNewton = 2,
+  //! LBFGSOptimizer<>
+  kLBFGS = 3,
 };
 
 // TODO(GH-167): Remove num_multistarts from ALL OptimizerParameter structs. num_multistarts doesn't
@@ -195,6 +197,105 @@ struct NewtonParameters {
   double tolerance;
 };
 
+/*!\rst
+  Container to hold parameters that specify the behavior of (projected) L-BFGS; see LBFGSOptimization() in
+  gpp_optimization.hpp.
+
+  **Iterations**
+
+  The total number of L-BFGS iterations is at most ``num_multistarts * max_num_steps``.  Each iteration costs one gradient
+  evaluation plus one objective evaluation per line search step; typically the first trial step is accepted.
+
+  **History**
+
+  ``history_size`` is the number of (step, gradient change) pairs used to approximate the inverse Hessian.  Memory and the
+  per-iteration overhead grow linearly in ``history_size * problem_size``; values beyond 10-20 rarely help.
+\endrst*/
+struct LBFGSParameters {
+  // Users must set parameters explicitly.
+  LBFGSParameters() = delete;
+
+  /*!\rst
+    Construct a LBFGSParameters object.  Default, copy, and assignment constructor are disallowed.
+
+    INPUTS:
+    See member declarations below for a description of each parameter.
+  \endrst*/
+  LBFGSParameters(int num_multistarts_in, int max_num_steps_in, int history_size_in,
+                  int max_num_line_search_steps_in, double tolerance_in)
+      : num_multistarts(num_multistarts_in),
+        max_num_steps(max_num_steps_in),
+        history_size(history_size_in),
+        max_num_line_search_steps(max_num_line_search_steps_in),
+        tolerance(tolerance_in) {
+  }
+
+  LBFGSParameters(LBFGSParameters&& OL_UNUSED(other)) = default;
+
+  // iteration control
+  //! number of initial guesses for multistarting (suggest: a few hundred)
+  int num_multistarts;
+  //! maximum number of L-BFGS iterations (per initial guess) (suggest: 100)
+  int max_num_steps;
+  //! maximum number of L-BFGS restarts (fixed; not used by L-BFGS)
+  const int max_num_restarts = 1;
+
+  // quasi-Newton and line search control
+  //! number of correction pairs kept for the inverse Hessian approximation (suggest: 5-10)
+  int history_size;
+  //! maximum number of step halvings in the backtracking line search (suggest: 20-30)
+  int max_num_line_search_steps;
+
+  // tolerance control
+  //! when the projected gradient or the step falls below this value (max-norm), stop (suggest: 1.0e-7)
+  double tolerance;
+};
+
+/*!\rst
+  Container to hold parameters that control MultistartOptimizer<...>::MultistartOptimizeAdaptive() (see gpp_optimization.hpp).
+
+  **Successive halving**
+
+  Every start first runs a short, "screening" optimization (e.g., ``num_screening_steps`` L-BFGS or GD steps).  Then only the best
+  ``survivor_fraction`` of the starts (by objective value) continue with another screening run from where they stopped;
+  this repeats until at most ``min_num_survivors`` remain.  The survivors are then optimized fully.  With ``survivor_fraction = 0.5``
+  (halving), the screening cost is at most twice that of screening every start once.
+
+  **Pruning**
+
+  Survivors are fully optimized best-first, and the best objective value found so far is shared between threads.  A survivor
+  whose screened objective trails that value by more than ``prune_gap`` is dropped without being optimized.  Use
+  ``prune_gap = std::numeric_limits<double>::infinity()`` to disable pruning.
+\endrst*/
+struct AdaptiveMultistartParameters {
+  // Users must set parameters explicitly.
+  AdaptiveMultistartParameters() = delete;
+
+  /*!\rst
+    Construct an AdaptiveMultistartParameters object.
+
+    INPUTS:
+    See member declarations below for a description of each parameter.
+  \endrst*/
+  AdaptiveMultistartParameters(int num_screening_steps_in, double survivor_fraction_in, int min_num_survivors_in,
+                               double prune_gap_in)
+      : num_screening_steps(num_screening_steps_in),
+        survivor_fraction(survivor_fraction_in),
+        min_num_survivors(min_num_survivors_in),
+        prune_gap(prune_gap_in) {
+  }
+
+  //! maximum number of optimizer iterations per screening round, i.e., ``max_num_steps`` of the screening parameters built
+  //! by the EI and hyperparameter optimization entry points (suggest: 2-10)
+  int num_screening_steps;
+  //! fraction of starts kept after each screening round, in ``(0, 1)`` (suggest: 0.5)
+  double survivor_fraction;
+  //! screening stops once at most this many starts remain; these are fully optimized (suggest: 5-20, or more threads)
+  int min_num_survivors;
+  //! drop survivors whose screened objective is more than this far below the best found so far (suggest: problem dependent)
+  double prune_gap;
+};
+
 }  // end namespace optimal_learning
 
 #endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_OPTIMIZER_PARAMETERS_HPP_
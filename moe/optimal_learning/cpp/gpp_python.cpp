@@ -547,7 +547,7 @@ BOOST_PYTHON_MODULE(GPP) {
       * GaussianProcess: for one set of historical data (and hyperparameters), this represents the GP model. It is fairly
         expensive to create, so the intention is that users create it once and pass it to all functions in this module
         that need it (as opposed to recreating it every time).  Constructing the GP is noted as step 2 of MOE above.
-      * GradientDescentParameters, NewtonParameters: structs that hold tolerances, max step counts, learning rates, etc.
+      * GradientDescentParameters, NewtonParameters, LBFGSParameters: structs that hold tolerances, max step counts, learning rates, etc.
         that control the behavior of the derivative-based optimizers
       * RandomnessSourceContainer: container for a uniform RNG and a normal (gaussian) RNG. These are needed by the C++ to
         guarantee that multi-threaded runs see different (and consistent) randomness. This class also exposes several
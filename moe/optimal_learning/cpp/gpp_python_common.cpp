@@ -15,6 +15,8 @@
 #include "gpp_python_common.hpp"
 
 // NOLINT-ing the C, C++ header includes as well; otherwise cpplint gets confused
+#include <cinttypes>  // NOLINT(build/include_order)
+#include <cstdint>  // NOLINT(build/include_order)
 #include <cstdio>  // NOLINT(build/include_order)
 
 #include <vector>  // NOLINT(build/include_order)
@@ -27,7 +29,9 @@
 
 #include "gpp_common.hpp"
 #include "gpp_domain.hpp"
+#include "gpp_exception.hpp"
 #include "gpp_logging.hpp"
+#include "gpp_math.hpp"
 #include "gpp_model_selection.hpp"
 #include "gpp_optimizer_parameters.hpp"
 #include "gpp_random.hpp"
@@ -49,6 +53,24 @@ void CopyPylistToClosedIntervalVector(const boost::python::list& input, int size
   }
 }
 
+void CopyBufferToClosedIntervalVector(const boost::python::object& input, int size, std::vector<ClosedInterval>& output) {
+  PythonBufferView input_view(input, 2*size, false);
+  output.resize(size);
+  for (int i = 0; i < size; ++i) {
+    output[i].min = input_view.data()[2*i + 0];
+    output[i].max = input_view.data()[2*i + 1];
+  }
+}
+
+AdaptiveMultistartParameters const * GetAdaptiveMultistartParameters(const boost::python::object& optimizer_parameters) {
+  boost::python::object adaptive_parameters = boost::python::getattr(optimizer_parameters, "adaptive_parameters",
+                                                                     boost::python::object());
+  if (adaptive_parameters.is_none()) {
+    return nullptr;
+  }
+  return &boost::python::extract<AdaptiveMultistartParameters&>(adaptive_parameters)();
+}
+
 boost::python::list VectorToPylist(const std::vector<double>& input) {
   boost::python::list result;
   for (const auto& entry : input) {
@@ -57,6 +79,83 @@ boost::python::list VectorToPylist(const std::vector<double>& input) {
   return result;
 }
 
+namespace {
+
+/*!\rst
+  \return
+    true if ``format`` (a ``struct`` module format string, as in ``Py_buffer::format``) describes a single native double
+\endrst*/
+OL_WARN_UNUSED_RESULT bool IsFloat64BufferFormat(char const * format) noexcept {
+  if (format == nullptr) {
+    return false;  // nullptr means unsigned bytes
+  }
+  // skip the (optional) byte order, size, and alignment character; doubles are 8 bytes in native and standard mode
+  switch (format[0]) {
+    case '@':
+    case '=': {
+      ++format;
+      break;
+    }
+    case '<': {
+      if (!PY_LITTLE_ENDIAN) {
+        return false;
+      }
+      ++format;
+      break;
+    }
+    case '>':
+    case '!': {
+      if (PY_LITTLE_ENDIAN) {
+        return false;
+      }
+      ++format;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+  return format[0] == 'd' && format[1] == '\0';
+}
+
+}  // end unnamed namespace
+
+PythonBufferView::PythonBufferView(const boost::python::object& source, int size, bool writable)
+    : buffer_(), has_buffer_(false), data_(nullptr), size_(0) {
+  if (size == 0 && source.is_none()) {
+    return;
+  }
+
+  int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+  if (writable) {
+    flags |= PyBUF_WRITABLE;
+  }
+  if (PyObject_GetBuffer(source.ptr(), &buffer_, flags) != 0) {
+    boost::python::throw_error_already_set();
+  }
+
+  // the dtor does not run if the ctor throws, so release the buffer before throwing
+  if (unlikely(buffer_.itemsize != sizeof(double) || !IsFloat64BufferFormat(buffer_.format))) {
+    PyBuffer_Release(&buffer_);
+    OL_THROW_EXCEPTION(OptimalLearningException, "Buffer must hold float64 (format 'd'); e.g., use numpy.ascontiguousarray(x, dtype=numpy.float64).");
+  }
+  const Py_ssize_t num_elements = buffer_.len / buffer_.itemsize;
+  if (unlikely(num_elements != size)) {
+    PyBuffer_Release(&buffer_);
+    OL_THROW_EXCEPTION(InvalidValueException<int>, "Buffer size (value) does not match the expected number of float64 (truth).", static_cast<int>(num_elements), size);
+  }
+
+  has_buffer_ = true;
+  data_ = static_cast<double *>(buffer_.buf);
+  size_ = size;
+}
+
+PythonBufferView::~PythonBufferView() {
+  if (has_buffer_) {
+    PyBuffer_Release(&buffer_);
+  }
+}
+
 PythonInterfaceInputContainer::PythonInterfaceInputContainer(const boost::python::list& points_to_sample_in, int dim_in, int num_to_sample_in)
     : dim(dim_in),
       num_to_sample(num_to_sample_in),
@@ -113,14 +212,14 @@ void RandomnessSourceContainer::ResetUniformGeneratorState() {
 
 void RandomnessSourceContainer::SetExplicitNormalRNGSeed(NormalRNG::EngineType::result_type seed) {
   for (IdentifyType<decltype(normal_rng_vec)>::type::size_type i = 0, size = normal_rng_vec.size(); i < size; ++i) {
-    normal_rng_vec[i].SetExplicitSeed(seed + i);
+    normal_rng_vec[i].SetExplicitSeed(seed);
   }
 }
 
 void RandomnessSourceContainer::SetRandomizedNormalRNGSeed(NormalRNG::EngineType::result_type seed) {
-  for (IdentifyType<decltype(normal_rng_vec)>::type::size_type i = 0, size = normal_rng_vec.size(); i < size; ++i) {
-    normal_rng_vec[i].SetRandomizedSeed(seed, i);
-  }
+  UniformRandomGenerator seed_generator;
+  seed_generator.SetRandomizedSeed(seed, 0);  // one seed shared by all threads, so thread_id = 0
+  SetExplicitNormalRNGSeed(seed_generator.last_seed());
 }
 
 bool RandomnessSourceContainer::SetNormalRNGSeedPythonList(const boost::python::list& seed_list, const boost::python::list& seed_flag_list) {
@@ -156,8 +255,8 @@ void RandomnessSourceContainer::PrintState() {
   std::printf("Uniform:\n");
   uniform_generator.PrintState(&std::cout);
   for (IdentifyType<decltype(normal_rng_vec)>::type::size_type i = 0, size = normal_rng_vec.size(); i < size; ++i) {
-    std::printf("NormalRNG %lu:\n", i);
-    normal_rng_vec[i].PrintState(&std::cout);
+    std::printf("NormalRNG %zu: seed %" PRIu64 ", stream %" PRIu64 ", draw %" PRIu64 "\n", i,
+                normal_rng_vec[i].last_seed(), normal_rng_vec[i].stream(), normal_rng_vec[i].draw_index());
   }
 }
 
@@ -168,10 +267,12 @@ void ExportEnumTypes() {
     * ``kNull``: null optimizer (use for 'dumb' search)
     * ``kGradientDescent``: gradient descent
     * ``kNewton``: Newton's Method
+    * ``kLBFGS``: projected L-BFGS (box-shaped domains only)
       )%%")
       .value("null", OptimizerTypes::kNull)
       .value("gradient_descent", OptimizerTypes::kGradientDescent)
       .value("newton", OptimizerTypes::kNewton)
+      .value("lbfgs", OptimizerTypes::kLBFGS)
       ;  // NOLINT, this is boost style
 
   boost::python::enum_<DomainTypes>("DomainTypes", R"%%(
@@ -202,6 +303,51 @@ void ExportEnumTypes() {
       .value("log_marginal_likelihood", LogLikelihoodTypes::kLogMarginalLikelihood)
       .value("leave_one_out_log_likelihood", LogLikelihoodTypes::kLeaveOneOutLogLikelihood)
       ;  // NOLINT, this is boost style
+
+  boost::python::enum_<LogMarginalLikelihoodGradientTypes>("LogMarginalLikelihoodGradientTypes", R"%%(
+    C++ enums to describe how kLogMarginalLikelihood computes its gradient wrt hyperparameters
+    (both give the same gradient):
+
+    * ``kFullTensor``: form every ``\pderiv{K}{\theta_k}`` and backsolve against each; ``O(d*N^2)`` memory
+    * ``kStreaming``: contract small tiles of ``\pderiv{K}{\theta_k}`` against ``\alpha\alpha^T - K^-1``;
+      ``O(N^2)`` memory
+      )%%")
+      .value("full_tensor", LogMarginalLikelihoodGradientTypes::kFullTensor)
+      .value("streaming", LogMarginalLikelihoodGradientTypes::kStreaming)
+      ;  // NOLINT, this is boost style
+
+  boost::python::enum_<LeaveOneOutComputeTypes>("LeaveOneOutComputeTypes", R"%%(
+    C++ enums to describe how kLeaveOneOutLogLikelihood computes the leave one out predictive mean & variance
+    (both cost ``O(N^3)`` in total and give the same measure):
+
+    * ``kMatrixInverse``: read them off of the explicit inverse, ``K^-1``; potentially ill-conditioned
+    * ``kCholeskyDowndate``: remove each point's row/column from the cholesky factor of ``K`` (``O(N^2)`` per point);
+      never forms ``K^-1``, so it is better conditioned
+      )%%")
+      .value("matrix_inverse", LeaveOneOutComputeTypes::kMatrixInverse)
+      .value("cholesky_downdate", LeaveOneOutComputeTypes::kCholeskyDowndate)
+      ;  // NOLINT, this is boost style
+
+  boost::python::enum_<MonteCarloIntegrationTypes>("MonteCarloIntegrationTypes", R"%%(
+    C++ enums to describe the available sources of sample points for monte-carlo q,p-EI:
+
+    * ``kPseudoRandom``: plain monte-carlo with IID pseudo-random normals
+    * ``kQuasiRandom``: randomized quasi-monte-carlo with randomly shifted Sobol points; typically reaches the
+      accuracy of kPseudoRandom with 10-100x fewer samples
+      )%%")
+      .value("pseudo_random", MonteCarloIntegrationTypes::kPseudoRandom)
+      .value("quasi_random", MonteCarloIntegrationTypes::kQuasiRandom)
+      ;  // NOLINT, this is boost style
+
+  boost::python::enum_<ExpectedImprovementEvaluationTypes>("ExpectedImprovementEvaluationTypes", R"%%(
+    C++ enums to describe how EI optimization computes q,p-EI other than 1,0-EI (which is always analytic):
+
+    * ``kMonteCarlo``: monte-carlo integration with the given number of iterations and MonteCarloIntegrationTypes
+    * ``kAnalytic``: multivariate normal CDFs (exact and much faster) if q + p <= 4; monte-carlo otherwise
+      )%%")
+      .value("monte_carlo", ExpectedImprovementEvaluationTypes::kMonteCarlo)
+      .value("analytic", ExpectedImprovementEvaluationTypes::kAnalytic)
+      ;  // NOLINT, this is boost style
 }
 
 void ExportOptimizerParameterStructs() {
@@ -262,13 +408,54 @@ void ExportOptimizerParameterStructs() {
       .def_readwrite("max_relative_change", &NewtonParameters::max_relative_change, "max change allowed per update (as a relative fraction of current distance to wall) (Newton may ignore this) (suggest: 1.0)")
       .def_readwrite("tolerance", &NewtonParameters::tolerance, "when the magnitude of the gradient falls below this value, stop (suggest: 1.0e-10)")
       ;  // NOLINT, this is boost style
+
+  boost::python::class_<LBFGSParameters, boost::noncopyable>("LBFGSParameters", boost::python::init<int, int, int, int, double>(
+      (boost::python::arg("num_multistarts"), "max_num_steps", "history_size", "max_num_line_search_steps", "tolerance"), R"%%(
+    Constructor for a LBFGSParameters object.
+
+    :param num_multistarts: number of initial guesses to try in multistarted l-bfgs (suggest: a few hundred)
+    :type num_multistarts: int > 0
+    :param max_num_steps: maximum number of l-bfgs iterations (per initial guess) (suggest: 100)
+    :type max_num_steps: int > 0
+    :param history_size: number of correction pairs kept for the inverse Hessian approximation (suggest: 5-10)
+    :type history_size: int > 0
+    :param max_num_line_search_steps: maximum number of step halvings in the backtracking line search (suggest: 20-30)
+    :type max_num_line_search_steps: int > 0
+    :param tolerance: when the projected gradient or the step falls below this value (max-norm), stop (suggest: 1.0e-7)
+    :type tolerance: float64 >= 0.0
+    )%%"))
+      .def_readwrite("num_multistarts", &LBFGSParameters::num_multistarts, "number of initial guesses to try in multistarted l-bfgs (suggest: a few hundred)")
+      .def_readwrite("max_num_steps", &LBFGSParameters::max_num_steps, "maximum number of l-bfgs iterations (per initial guess) (suggest: 100)")
+      .def_readwrite("history_size", &LBFGSParameters::history_size, "number of correction pairs kept for the inverse Hessian approximation (suggest: 5-10)")
+      .def_readwrite("max_num_line_search_steps", &LBFGSParameters::max_num_line_search_steps, "maximum number of step halvings in the backtracking line search (suggest: 20-30)")
+      .def_readwrite("tolerance", &LBFGSParameters::tolerance, "when the projected gradient or the step falls below this value (max-norm), stop (suggest: 1.0e-7)")
+      ;  // NOLINT, this is boost style
+
+  boost::python::class_<AdaptiveMultistartParameters, boost::noncopyable>("AdaptiveMultistartParameters", boost::python::init<int, double, int, double>(
+      (boost::python::arg("num_screening_steps"), "survivor_fraction", "min_num_survivors", "prune_gap"), R"%%(
+    Constructor for an AdaptiveMultistartParameters object (adaptive multistart: successive halving + pruning).
+
+    :param num_screening_steps: maximum number of optimizer iterations per screening round (suggest: 2-10)
+    :type num_screening_steps: int > 0
+    :param survivor_fraction: fraction of starts kept after each screening round (suggest: 0.5)
+    :type survivor_fraction: float64 in (0, 1)
+    :param min_num_survivors: screening stops once at most this many starts remain; these are fully optimized (suggest: 5-20, or more threads)
+    :type min_num_survivors: int > 0
+    :param prune_gap: drop survivors whose screened objective is more than this far below the best found so far (inf disables pruning)
+    :type prune_gap: float64 >= 0.0
+    )%%"))
+      .def_readwrite("num_screening_steps", &AdaptiveMultistartParameters::num_screening_steps, "maximum number of optimizer iterations per screening round (suggest: 2-10)")
+      .def_readwrite("survivor_fraction", &AdaptiveMultistartParameters::survivor_fraction, "fraction of starts kept after each screening round, in (0, 1) (suggest: 0.5)")
+      .def_readwrite("min_num_survivors", &AdaptiveMultistartParameters::min_num_survivors, "screening stops once at most this many starts remain; these are fully optimized (suggest: 5-20, or more threads)")
+      .def_readwrite("prune_gap", &AdaptiveMultistartParameters::prune_gap, "drop survivors whose screened objective is more than this far below the best found so far")
+      ;  // NOLINT, this is boost style
 }
 
 void ExportRandomnessContainer() {
   boost::python::class_<RandomnessSourceContainer, boost::noncopyable>("RandomnessSourceContainer", boost::python::init<int>(R"%%(
     Constructor for a RandomnessSourceContainer with enough random sources for at most num_threads simultaneous accesses.
 
-    Random sources are seeded to a repeatable combination of the default seed and the thread id.
+    Random sources are seeded to the (repeatable) default seed.
     Call SetRandomizedUniformGeneratorSeed() and/or SetRandomizedNormalRNGSeed to use
     an automatically generated (and less repeatable) seed(s).
 
@@ -296,30 +483,25 @@ void ExportRandomnessContainer() {
     Resets Uniform RNG to most recently specified seed value.  Useful for testing.
       )%%")
       .def("SetExplicitNormalRNGSeed", &RandomnessSourceContainer::SetExplicitNormalRNGSeed, R"%%(
-    Seeds RNG of thread ``i`` to ``f_i(seed, thread_id_i)`` such that ``f_i != f_j`` for ``i != j``.  ``f_i`` is repeatable.
-    So each thread gets a distinct seed that is easily repeatable for testing.
-
-    .. NOTE:: every thread is GUARANTEED to have a different seed
+    Seeds the RNG of every thread with ``seed``.  Threads do not need distinct seeds: each unit of work (e.g., a
+    multistart) draws from its own stream, so results do not depend on the number of threads.
 
-    :param seed: base seed value to use
+    :param seed: seed value to use
     :type seed: unsigned int
       )%%")
       .def("SetRandomizedNormalRNGSeed", &RandomnessSourceContainer::SetRandomizedNormalRNGSeed, R"%%(
-    Set a new seed for the random number generator.  A "random" seed is selected based on
-    the input seed value, the current time, and the thread_id.
+    Set a new seed for the random number generators.  A "random" seed is selected based on
+    the input seed value and the current time; all threads share it.
 
     :param seed: base seed value to use
     :type seed: unsigned int
-    :param thread_id: id of the thread using this object
-    :type thread_id: int >= 0
       )%%")
       .def("SetNormalRNGSeedPythonList", &RandomnessSourceContainer::SetNormalRNGSeedPythonList, R"%%(
     If ``seed_flag_list[i]`` is true, sets the normal rng seed of the ``i``-th thread to the value of ``seed_list[i]``.
 
     If sizes are invalid (i.e., number of seeds != number of generators), then no changes are made and an error code is returned.
 
-    .. NOTE:: Does not guarantee that all threads receive unique seeds!  If that is desired, seed_list should be
-        checked BEFORE calling this function.
+    .. NOTE:: Results only stay independent of the number of threads if every entry gets the same seed.
 
     :return: true if success, false if failure (due to invalid sizes)
     :rtype: bool
@@ -9,6 +9,7 @@
 
      a. PythonInterfaceInputContainer: captures the most common set of inputs used in gpp_python
      b. utilities for copying between std::vector and boost::python::list
+     c. PythonBufferView: zero-copy access to float64 buffers (e.g., numpy arrays)
 
   2. A RandomnessSourceContainer for moving consistent RNG state between C++, Python
   3. Export*() functions for giving Python access to various C++ calls via boost::python.
@@ -28,6 +29,12 @@
 
   See other gpp_python_*.cpp files for examples (e.g., gpp_python_expected_improvement.cpp or gpp_python_model_selection.cpp).
 
+  Copying element by element from (and appending to) boost::python::list boxes/unboxes every double; for large inputs
+  (e.g., thousands of ``points_sampled``) that can cost more than the computation itself.  So the most heavily used
+  functions also accept any object supporting the buffer protocol (e.g., a C-contiguous numpy array of float64) in place
+  of each list.  These overloads skip steps 1) and 4): they read inputs in place through PythonBufferView (item 1c) and
+  write results into caller-preallocated output buffers.
+
   General notes about the Python interface:
 
   1. We use raw strings (C++11) to pass multiline string
@@ -46,6 +53,13 @@
      `` 81  2  93 0]``
      would be FLATTENED into an array:
      ``A_flat[12] = [4 32 5 2 53 12 8 1 81 2 93 0]``
+
+  3. Long-running calls (e.g., multistart optimization) release the GIL (see ScopedGILRelease) while C++ computes, so
+     other Python threads (e.g., web server workers) keep running.  Inputs are copied to C++ (step 1) and outputs are
+     built (step 4) with the GIL held.  C++ objects owned by Python (e.g., GaussianProcess, RandomnessSourceContainer)
+     may be shared across Python threads, so they are copied (with the GIL held) before the GIL is released: the GP
+     via GaussianProcess::Clone() and the RNG state via ScopedRandomnessSourceCopy, which writes the advanced state
+     back once the GIL is reacquired.  Immutable objects (e.g., estimation policies) are used in place.
 \endrst*/
 
 #ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_PYTHON_COMMON_HPP_
@@ -55,8 +69,10 @@
 
 #include <boost/python/extract.hpp>  // NOLINT(build/include_order)
 #include <boost/python/list.hpp>  // NOLINT(build/include_order)
+#include <boost/python/object.hpp>  // NOLINT(build/include_order)
 
 #include "gpp_common.hpp"
+#include "gpp_optimizer_parameters.hpp"
 #include "gpp_random.hpp"
 
 namespace optimal_learning {
@@ -127,7 +143,9 @@ struct PythonInterfaceInputContainer {
   Python generally has minimal interaction with this class; it is meant to be constructed in Python and then passed back to
   C++ for use.
 
-  This class will track enough enough sources so that multithreaded computation is well-defined.
+  This class will track enough enough sources so that multithreaded computation is well-defined.  The normal sources are
+  counter-based (PhiloxNormalRNG) and share one seed; multistart EI keys its draws by start (see BasicExpectedImprovementState
+  in gpp_math.hpp), so results depend on the seed but not on the number of threads.
 
   This class exposes its member functions directly to Python; these member functions are for setting and resetting seed
   values for the randomness sources.
@@ -140,7 +158,7 @@ class RandomnessSourceContainer {
   /*!\rst
     Creates the randomness container with enough random sources for at most num_threads simultaneous accesses.
 
-    Random sources are seeded to a repeatable combination of the default seed and the thread id.
+    Random sources are seeded to the (repeatable) default seed.
   \endrst*/
   explicit RandomnessSourceContainer(int num_threads);
 
@@ -173,18 +191,16 @@ class RandomnessSourceContainer {
   void ResetUniformGeneratorState();
 
   /*!\rst
-    Seeds RNG of thread i to f_i(seed, thread_id_i) such that f_i != f_j for i != j.  f_i is repeatable.
-    so each thread gets a distinct seed that is easily repeatable for testing
-
-    .. NOTE:: every thread is GUARANTEED to have a different seed
+    Seeds the RNG of every thread with ``seed``.  Threads do not need distinct seeds: each unit of work (e.g., a multistart)
+    draws from its own stream.
 
     \param
-      :seed: base seed value to use
+      :seed: seed value to use
   \endrst*/
   void SetExplicitNormalRNGSeed(NormalRNG::EngineType::result_type seed);
 
   /*!\rst
-    Seeds each thread with a combination of current time, thread_id, and (potentially) other factors.
+    Seeds every thread with the same combination of current time and (potentially) other factors.
     multiple calls to this should produce different seeds modulo aliasing issues
 
     \param
@@ -197,8 +213,7 @@ class RandomnessSourceContainer {
 
     If sizes are invalid (i.e., number of seeds != number of generators), then no changes are made and an error code is returned.
 
-    .. NOTE:: Does not guarantee that all threads receive unique seeds!  If that is desired, seed_list should be
-              checked BEFORE calling this function.
+    .. NOTE:: Results only stay independent of the number of threads if every entry gets the same seed.
 
     \return
       true if successful, false otherwise (due to invalid sizes)
@@ -215,7 +230,7 @@ class RandomnessSourceContainer {
   //! The uniform random generator that will be used by C++ to make uniform draws.
   UniformRandomGenerator uniform_generator;
   //! The normal random generators (one per thread) that will be used by C++ to make N(0, 1)-distributed draws.
-  std::vector<NormalRNG> normal_rng_vec;
+  std::vector<PhiloxNormalRNG> normal_rng_vec;
 
   OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(RandomnessSourceContainer);
 
@@ -252,6 +267,30 @@ void CopyPylistToVector(const boost::python::list& input, int size, std::vector<
 \endrst*/
 void CopyPylistToClosedIntervalVector(const boost::python::list& input, int size, std::vector<ClosedInterval>& output);
 
+/*!\rst
+  Same as CopyPylistToClosedIntervalVector() except ``input`` is read through a PythonBufferView (declared below); e.g.,
+  a C-contiguous numpy array of float64 with shape (size, 2).
+
+  \param
+    :input: Python object exposing a buffer of 2*size float64
+    :size: number of pairs to copy
+  \output
+    :output: std::vector with copies of the size pairs of input
+\endrst*/
+void CopyBufferToClosedIntervalVector(const boost::python::object& input, int size, std::vector<ClosedInterval>& output);
+
+/*!\rst
+  Reads the optional ``adaptive_parameters`` attribute of an ``optimizer_parameters`` object from Python (see
+  ``_CppOptimizerParameters`` in cpp_wrappers/optimization.py).
+
+  \param
+    :optimizer_parameters: python object that may have an ``adaptive_parameters`` attribute
+  \return
+    the AdaptiveMultistartParameters held by ``optimizer_parameters.adaptive_parameters``, or nullptr if that attribute
+    is missing or None.  Valid while ``optimizer_parameters`` holds the object.
+\endrst*/
+AdaptiveMultistartParameters const * GetAdaptiveMultistartParameters(const boost::python::object& optimizer_parameters);
+
 /*!\rst
   Produces a PyList with the same size as the input vector and that is
   element-wise equal to the input vector.
@@ -263,6 +302,140 @@ void CopyPylistToClosedIntervalVector(const boost::python::list& input, int size
 \endrst*/
 boost::python::list VectorToPylist(const std::vector<double>& input);
 
+/*!\rst
+  Zero-copy view of the float64 data held by a Python object supporting the buffer protocol (PEP 3118); e.g., a
+  C-contiguous ``numpy.ndarray`` with ``dtype=numpy.float64``, an ``array.array('d')``, or a ``memoryview`` of one.
+
+  data() points directly into the object's memory.  The buffer (and hence the object) is held until this view is
+  destroyed, so the pointer stays valid for the view's lifetime.  Writes through a writable view are visible to Python.
+
+  Shape is not checked (inputs are flattened anyway; see file comments), only the total number of elements.
+  ``None`` is accepted in place of an empty buffer (``size == 0``); data() is then nullptr.
+\endrst*/
+class PythonBufferView final {
+ public:
+  /*!\rst
+    Acquires the buffer of ``source``.
+
+    \param
+      :source: Python object exposing a C-contiguous buffer of float64 (format ``d``)
+      :size: number of doubles the buffer must hold
+      :writable: true to request a writable buffer (e.g., for outputs)
+    \raise
+      boost::python::error_already_set (Python ``BufferError``/``TypeError``) if ``source`` does not support the buffer
+      protocol or its buffer is not C-contiguous (or not writable, if requested)
+      OptimalLearningException if the buffer does not hold float64
+      InvalidValueException<int> if the buffer does not hold exactly ``size`` doubles
+  \endrst*/
+  PythonBufferView(const boost::python::object& source, int size, bool writable);
+
+  //! Releases the buffer.
+  ~PythonBufferView();
+
+  //! \return pointer to the (first element of the) buffer's data
+  double * data() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return data_;
+  }
+
+  //! \return number of doubles in the buffer
+  int size() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return size_;
+  }
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(PythonBufferView);
+
+ private:
+  //! the buffer acquired from Python; only valid if has_buffer_
+  Py_buffer buffer_;
+  //! whether buffer_ was acquired (and must be released)
+  bool has_buffer_;
+  //! start of the buffer's data
+  double * data_;
+  //! number of doubles in the buffer
+  int size_;
+};
+
+/*!\rst
+  RAII guard that releases the Python GIL (global interpreter lock) for its lifetime, letting other Python threads run
+  while C++ computes.  The GIL is reacquired on destruction, including during stack unwinding, so C++ exceptions reach
+  the boost::python exception translators (gpp_python.cpp) with the GIL held.
+
+  Usage::
+
+    // extract everything needed from Python objects first
+    {
+      ScopedGILRelease gil_release;
+      ComputeOptimalPointsToSample(...);  // pure C++
+    }
+    status["found_update"] = found_flag;  // back under the GIL
+
+  .. WARNING:: while a guard is alive, do NOT touch Python objects (boost::python::object/list/dict, extract, etc.)
+    or call the Python C-API.  Raw pointers into buffers held by a live PythonBufferView are fine; the view itself must
+    be created before and destroyed after the guard.
+\endrst*/
+class ScopedGILRelease final {
+ public:
+  //! Releases the GIL; the calling thread must hold it.
+  ScopedGILRelease() : thread_state_(PyEval_SaveThread()) {
+  }
+
+  //! Reacquires the GIL.
+  ~ScopedGILRelease() {
+    PyEval_RestoreThread(thread_state_);
+  }
+
+  OL_DISALLOW_COPY_AND_ASSIGN(ScopedGILRelease);
+
+ private:
+  //! state of the calling Python thread, saved while the GIL is released
+  PyThreadState * thread_state_;
+};
+
+/*!\rst
+  Private copy of the state of a RandomnessSourceContainer for use while the GIL is released (see ScopedGILRelease).
+  Another Python thread may use (or reseed) the same container meanwhile, so C++ must not advance the shared
+  generators in place.  The copy is taken on construction and the advanced state is written back on destruction;
+  both happen with the GIL held, so construct this object BEFORE (i.e., in an enclosing scope of) the ScopedGILRelease.
+
+  If several threads share one container, each call draws from the state the container had when the call started and
+  the last call to finish determines the container's final state.
+
+  Members mirror RandomnessSourceContainer so call sites read the same; e.g.::
+
+    ScopedRandomnessSourceCopy randomness_source_copy(&randomness_source);
+    {
+      ScopedGILRelease gil_release;
+      ComputeOptimalPointsToSample(..., &randomness_source_copy.uniform_generator,
+                                   randomness_source_copy.normal_rng_vec.data(), ...);
+    }
+\endrst*/
+class ScopedRandomnessSourceCopy final {
+ public:
+  //! Copies the generators of ``randomness_source``; the calling thread must hold the GIL.
+  explicit ScopedRandomnessSourceCopy(RandomnessSourceContainer * randomness_source)
+      : uniform_generator(randomness_source->uniform_generator),
+        normal_rng_vec(randomness_source->normal_rng_vec),
+        randomness_source_(randomness_source) {
+  }
+
+  //! Writes the (advanced) generators back to the source container; the calling thread must hold the GIL.
+  ~ScopedRandomnessSourceCopy() {
+    randomness_source_->uniform_generator = uniform_generator;
+    randomness_source_->normal_rng_vec = normal_rng_vec;
+  }
+
+  //! copy of RandomnessSourceContainer::uniform_generator
+  UniformRandomGenerator uniform_generator;
+  //! copy of RandomnessSourceContainer::normal_rng_vec
+  std::vector<PhiloxNormalRNG> normal_rng_vec;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(ScopedRandomnessSourceCopy);
+
+ private:
+  //! the container whose state is copied in and written back
+  RandomnessSourceContainer * randomness_source_;
+};
+
 /*!\rst
   Export C++'s enum classes to Python; e.g., DomainTypes, OptimizerTypes, etc. Includes docstrings.
 \endrst*/
@@ -16,6 +16,7 @@
 #include "gpp_python_expected_improvement.hpp"
 
 // NOLINT-ing the C, C++ header includes as well; otherwise cpplint gets confused
+#include <memory>  // NOLINT(build/include_order)
 #include <string>  // NOLINT(build/include_order)
 #include <vector>  // NOLINT(build/include_order)
 
@@ -42,35 +43,107 @@ namespace optimal_learning {
 
 namespace {
 
-double ComputeExpectedImprovementWrapper(const GaussianProcess& gaussian_process,
-                                         const boost::python::list& points_to_sample,
-                                         const boost::python::list& points_being_sampled,
-                                         int num_to_sample, int num_being_sampled,
-                                         int max_int_steps, double best_so_far,
-                                         bool force_monte_carlo,
-                                         RandomnessSourceContainer& randomness_source) {
-  PythonInterfaceInputContainer input_container(points_to_sample, points_being_sampled,
-                                                gaussian_process.dim(), num_to_sample, num_being_sampled);
+/*!\rst
+  Computes q,p-EI; shared by the list and buffer wrappers.  See the ``compute_expected_improvement`` docstring in
+  ExportExpectedImprovementFunctions() for details.
 
+  \param
+    :points_to_sample[dim][num_to_sample]: points at which to evaluate EI
+    :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
+    (other inputs as in ``compute_expected_improvement``)
+  \return
+    EI evaluated at ``points_to_sample``
+\endrst*/
+double ComputeExpectedImprovement(const GaussianProcess& gaussian_process,
+                                  double const * restrict points_to_sample,
+                                  double const * restrict points_being_sampled,
+                                  int num_to_sample, int num_being_sampled,
+                                  int max_int_steps, double best_so_far,
+                                  bool force_monte_carlo,
+                                  RandomnessSourceContainer& randomness_source) {
   bool configure_for_gradients = false;
   if ((num_to_sample == 1) && (num_being_sampled == 0) && (force_monte_carlo == false)) {
     OnePotentialSampleExpectedImprovementEvaluator ei_evaluator(gaussian_process, best_so_far);
-    OnePotentialSampleExpectedImprovementEvaluator::StateType ei_state(ei_evaluator,
-                                                                       input_container.points_to_sample.data(),
+    OnePotentialSampleExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, points_to_sample,
                                                                        configure_for_gradients);
     return ei_evaluator.ComputeExpectedImprovement(&ei_state);
   } else {
     ExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far);
-    ExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, input_container.points_to_sample.data(),
-                                                     input_container.points_being_sampled.data(),
-                                                     input_container.num_to_sample,
-                                                     input_container.num_being_sampled,
+    ExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, points_to_sample, points_being_sampled,
+                                                     num_to_sample, num_being_sampled,
                                                      configure_for_gradients,
                                                      randomness_source.normal_rng_vec.data());
     return ei_evaluator.ComputeExpectedImprovement(&ei_state);
   }
 }
 
+/*!\rst
+  Computes the gradient of q,p-EI wrt ``points_to_sample``; shared by the list and buffer wrappers.  See the
+  ``compute_grad_expected_improvement`` docstring in ExportExpectedImprovementFunctions() for details.
+
+  \param
+    :points_to_sample[dim][num_to_sample]: points at which to evaluate the gradient of EI
+    :points_being_sampled[dim][num_being_sampled]: points being sampled in concurrent experiments
+    (other inputs as in ``compute_grad_expected_improvement``)
+  \output
+    :grad_EI[dim][num_to_sample]: gradient of EI wrt each of ``points_to_sample``
+\endrst*/
+void ComputeGradExpectedImprovement(const GaussianProcess& gaussian_process,
+                                    double const * restrict points_to_sample,
+                                    double const * restrict points_being_sampled,
+                                    int num_to_sample, int num_being_sampled,
+                                    int max_int_steps, double best_so_far,
+                                    bool force_monte_carlo,
+                                    RandomnessSourceContainer& randomness_source,
+                                    double * restrict grad_EI) {
+  bool configure_for_gradients = true;
+  if ((num_to_sample == 1) && (num_being_sampled == 0) && (force_monte_carlo == false)) {
+    OnePotentialSampleExpectedImprovementEvaluator ei_evaluator(gaussian_process, best_so_far);
+    OnePotentialSampleExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, points_to_sample,
+                                                                       configure_for_gradients);
+    ei_evaluator.ComputeGradExpectedImprovement(&ei_state, grad_EI);
+  } else {
+    ExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far);
+    ExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, points_to_sample, points_being_sampled,
+                                                     num_to_sample, num_being_sampled,
+                                                     configure_for_gradients,
+                                                     randomness_source.normal_rng_vec.data());
+    ei_evaluator.ComputeGradExpectedImprovement(&ei_state, grad_EI);
+  }
+}
+
+double ComputeExpectedImprovementWrapper(const GaussianProcess& gaussian_process,
+                                         const boost::python::list& points_to_sample,
+                                         const boost::python::list& points_being_sampled,
+                                         int num_to_sample, int num_being_sampled,
+                                         int max_int_steps, double best_so_far,
+                                         bool force_monte_carlo,
+                                         RandomnessSourceContainer& randomness_source) {
+  PythonInterfaceInputContainer input_container(points_to_sample, points_being_sampled,
+                                                gaussian_process.dim(), num_to_sample, num_being_sampled);
+
+  return ComputeExpectedImprovement(gaussian_process, input_container.points_to_sample.data(),
+                                    input_container.points_being_sampled.data(), num_to_sample,
+                                    num_being_sampled, max_int_steps, best_so_far, force_monte_carlo,
+                                    randomness_source);
+}
+
+double ComputeExpectedImprovementBufferWrapper(const GaussianProcess& gaussian_process,
+                                               const boost::python::object& points_to_sample,
+                                               const boost::python::object& points_being_sampled,
+                                               int num_to_sample, int num_being_sampled,
+                                               int max_int_steps, double best_so_far,
+                                               bool force_monte_carlo,
+                                               RandomnessSourceContainer& randomness_source) {
+  const bool writable = false;
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, writable);
+  PythonBufferView points_being_sampled_view(points_being_sampled, gaussian_process.dim()*num_being_sampled, writable);
+
+  return ComputeExpectedImprovement(gaussian_process, points_to_sample_view.data(), points_being_sampled_view.data(),
+                                    num_to_sample, num_being_sampled, max_int_steps, best_so_far, force_monte_carlo,
+                                    randomness_source);
+}
+
 boost::python::list ComputeGradExpectedImprovementWrapper(const GaussianProcess& gaussian_process,
                                                           const boost::python::list& points_to_sample,
                                                           const boost::python::list& points_being_sampled,
@@ -82,27 +155,74 @@ boost::python::list ComputeGradExpectedImprovementWrapper(const GaussianProcess&
                                                 num_to_sample, num_being_sampled);
 
   std::vector<double> grad_EI(num_to_sample*input_container.dim);
-  bool configure_for_gradients = true;
-  if ((num_to_sample == 1) && (num_being_sampled == 0) && (force_monte_carlo == false)) {
-    OnePotentialSampleExpectedImprovementEvaluator ei_evaluator(gaussian_process, best_so_far);
-    OnePotentialSampleExpectedImprovementEvaluator::StateType ei_state(ei_evaluator,
-                                                                       input_container.points_to_sample.data(),
-                                                                       configure_for_gradients);
-    ei_evaluator.ComputeGradExpectedImprovement(&ei_state, grad_EI.data());
-  } else {
-    ExpectedImprovementEvaluator ei_evaluator(gaussian_process, max_int_steps, best_so_far);
-    ExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, input_container.points_to_sample.data(),
-                                                     input_container.points_being_sampled.data(),
-                                                     input_container.num_to_sample,
-                                                     input_container.num_being_sampled,
-                                                     configure_for_gradients,
-                                                     randomness_source.normal_rng_vec.data());
-    ei_evaluator.ComputeGradExpectedImprovement(&ei_state, grad_EI.data());
-  }
+  ComputeGradExpectedImprovement(gaussian_process, input_container.points_to_sample.data(),
+                                 input_container.points_being_sampled.data(), num_to_sample, num_being_sampled,
+                                 max_int_steps, best_so_far, force_monte_carlo, randomness_source, grad_EI.data());
 
   return VectorToPylist(grad_EI);
 }
 
+void ComputeGradExpectedImprovementBufferWrapper(const GaussianProcess& gaussian_process,
+                                                 const boost::python::object& points_to_sample,
+                                                 const boost::python::object& points_being_sampled,
+                                                 int num_to_sample, int num_being_sampled,
+                                                 int max_int_steps, double best_so_far,
+                                                 bool force_monte_carlo,
+                                                 RandomnessSourceContainer& randomness_source,
+                                                 const boost::python::object& grad_EI) {
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, false);
+  PythonBufferView points_being_sampled_view(points_being_sampled, gaussian_process.dim()*num_being_sampled, false);
+  PythonBufferView grad_EI_view(grad_EI, gaussian_process.dim()*num_to_sample, true);
+
+  ComputeGradExpectedImprovement(gaussian_process, points_to_sample_view.data(), points_being_sampled_view.data(),
+                                 num_to_sample, num_being_sampled, max_int_steps, best_so_far, force_monte_carlo,
+                                 randomness_source, grad_EI_view.data());
+}
+
+/*!\rst
+  ComputeOptimalPointsToSample() with multistart L-BFGS (adaptive if ``adaptive_parameters`` is not nullptr).  L-BFGS
+  projects its iterates onto the domain, which only box-shaped domains support; the SimplexIntersectTensorProductDomain
+  overload throws.
+
+  \raise
+    OptimalLearningException for SimplexIntersectTensorProductDomain
+\endrst*/
+void ComputeOptimalPointsToSampleViaLBFGS(const GaussianProcess& gaussian_process,
+                                          const LBFGSParameters& lbfgs_parameters,
+                                          AdaptiveMultistartParameters const * adaptive_parameters,
+                                          const TensorProductDomain& domain,
+                                          const ThreadSchedule& thread_schedule,
+                                          double const * restrict points_being_sampled, int num_to_sample,
+                                          int num_being_sampled, double best_so_far, int max_int_steps,
+                                          MonteCarloIntegrationTypes integration_type,
+                                          ExpectedImprovementEvaluationTypes evaluation_type, bool lhc_search_only,
+                                          int num_lhc_samples, bool * restrict found_flag,
+                                          UniformRandomGenerator * uniform_generator, PhiloxNormalRNG * normal_rng,
+                                          double * restrict best_points_to_sample) {
+  ComputeOptimalPointsToSample(gaussian_process, lbfgs_parameters, adaptive_parameters, domain, thread_schedule,
+                               points_being_sampled, num_to_sample, num_being_sampled, best_so_far, max_int_steps,
+                               integration_type, evaluation_type, lhc_search_only, num_lhc_samples, found_flag,
+                               uniform_generator, normal_rng, best_points_to_sample);
+}
+
+void ComputeOptimalPointsToSampleViaLBFGS(const GaussianProcess& OL_UNUSED(gaussian_process),
+                                          const LBFGSParameters& OL_UNUSED(lbfgs_parameters),
+                                          AdaptiveMultistartParameters const * OL_UNUSED(adaptive_parameters),
+                                          const SimplexIntersectTensorProductDomain& OL_UNUSED(domain),
+                                          const ThreadSchedule& OL_UNUSED(thread_schedule),
+                                          double const * restrict OL_UNUSED(points_being_sampled),
+                                          int OL_UNUSED(num_to_sample), int OL_UNUSED(num_being_sampled),
+                                          double OL_UNUSED(best_so_far), int OL_UNUSED(max_int_steps),
+                                          MonteCarloIntegrationTypes OL_UNUSED(integration_type),
+                                          ExpectedImprovementEvaluationTypes OL_UNUSED(evaluation_type),
+                                          bool OL_UNUSED(lhc_search_only), int OL_UNUSED(num_lhc_samples),
+                                          bool * restrict OL_UNUSED(found_flag),
+                                          UniformRandomGenerator * OL_UNUSED(uniform_generator),
+                                          PhiloxNormalRNG * OL_UNUSED(normal_rng),
+                                          double * restrict OL_UNUSED(best_points_to_sample)) {
+  OL_THROW_EXCEPTION(OptimalLearningException, "L-BFGS EI optimization requires a tensor product (box) domain.");
+}
+
 /*!\rst
   Utility that dispatches EI optimization based on optimizer type and num_to_sample.
   This is just used to reduce copy-pasted code.
@@ -113,15 +233,18 @@ boost::python::list ComputeGradExpectedImprovementWrapper(const GaussianProcess&
       appropriate parameter structs e.g., NewtonParameters for type kNewton).
       See comments on the python interface for multistart_expected_improvement_optimization_wrapper
     :gaussian_process: GaussianProcess object (holds points_sampled, values, noise_variance, derived quantities) that describes the
-      underlying GP
-    :input_container: PythonInterfaceInputContainer object containing data about points_being_sampled
+      underlying GP; a private copy, since it is read with the GIL released
+    :points_being_sampled[dim][num_being_sampled]: points that are being sampled in concurrent experiments
     :domain: object specifying the domain to optimize over (see gpp_domain.hpp)
-    :optimizer_type: type of optimization to use (e.g., null, gradient descent)
+    :optimizer_type: type of optimization to use (e.g., null, gradient descent, L-BFGS)
     :num_to_sample: how many simultaneous experiments you would like to run (i.e., the q in q,p-EI)
+    :num_being_sampled: number of points being sampled concurrently (i.e., the p in q,p-EI)
     :best_so_far: value of the best sample so far (must be min(points_sampled_value))
     :max_int_steps: maximum number of MC iterations
+    :integration_type: source of the sample points for MC integration (pseudo-random or quasi-random)
+    :evaluation_type: how q,p-EI with ``q + p > 1`` is computed: analytically (if ``q + p`` is small enough) or by MC
     :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
-    :randomness_source: object containing randomness sources (sufficient for multithreading) used in EI computation
+    :randomness_source: private copy of the randomness sources (sufficient for multithreading) used in EI computation
     :status: pydict object; cannot be None
   \output
     :randomness_source: PRNG internal states modified
@@ -131,18 +254,22 @@ boost::python::list ComputeGradExpectedImprovementWrapper(const GaussianProcess&
 template <typename DomainType>
 void DispatchExpectedImprovementOptimization(const boost::python::object& optimizer_parameters,
                                              const GaussianProcess& gaussian_process,
-                                             const PythonInterfaceInputContainer& input_container,
+                                             double const * restrict points_being_sampled,
                                              const DomainType& domain,
                                              OptimizerTypes optimizer_type,
-                                             int num_to_sample, double best_so_far,
-                                             int max_int_steps, int max_num_threads,
-                                             bool use_gpu, int which_gpu,
-                                             RandomnessSourceContainer& randomness_source,
+                                             int num_to_sample, int num_being_sampled, double best_so_far,
+                                             int max_int_steps, MonteCarloIntegrationTypes integration_type,
+                                             ExpectedImprovementEvaluationTypes evaluation_type,
+                                             int max_num_threads, bool use_gpu, int which_gpu,
+                                             ScopedRandomnessSourceCopy& randomness_source,
                                              boost::python::dict& status,
                                              double * restrict best_points_to_sample) {
 #ifndef OL_GPU_ENABLED
   (void) which_gpu;  // quiet the compiler warning (unused variable)
 #endif
+  if (unlikely(use_gpu == true && integration_type != MonteCarloIntegrationTypes::kPseudoRandom)) {
+    OL_THROW_EXCEPTION(OptimalLearningException, "GPU EI only supports pseudo-random MC integration!");
+  }
 
   bool found_flag = false;
   switch (optimizer_type) {
@@ -153,10 +280,11 @@ void DispatchExpectedImprovementOptimization(const boost::python::object& optimi
 
       if (use_gpu == true) {
 #ifdef OL_GPU_ENABLED
+        ScopedGILRelease gil_release;
         CudaComputeOptimalPointsToSampleViaLatinHypercubeSearch(gaussian_process, domain, thread_schedule,
-                                                                input_container.points_being_sampled.data(),
+                                                                points_being_sampled,
                                                                 num_random_samples, num_to_sample,
-                                                                input_container.num_being_sampled,
+                                                                num_being_sampled,
                                                                 best_so_far, max_int_steps, which_gpu, &found_flag,
                                                                 &randomness_source.uniform_generator,
                                                                 best_points_to_sample);
@@ -164,12 +292,14 @@ void DispatchExpectedImprovementOptimization(const boost::python::object& optimi
         OL_THROW_EXCEPTION(OptimalLearningException, "GPU is not installed or enabled!");
 #endif
       } else {
+        ScopedGILRelease gil_release;
         ComputeOptimalPointsToSampleViaLatinHypercubeSearch(gaussian_process, domain, thread_schedule,
-                                                            input_container.points_being_sampled.data(),
+                                                            points_being_sampled,
                                                             num_random_samples, num_to_sample,
-                                                            input_container.num_being_sampled,
-                                                            best_so_far, max_int_steps,
-                                                            &found_flag, &randomness_source.uniform_generator,
+                                                            num_being_sampled,
+                                                            best_so_far, max_int_steps, integration_type,
+                                                            evaluation_type, &found_flag,
+                                                            &randomness_source.uniform_generator,
                                                             randomness_source.normal_rng_vec.data(),
                                                             best_points_to_sample);
       }
@@ -186,42 +316,86 @@ void DispatchExpectedImprovementOptimization(const boost::python::object& optimi
       bool random_search_only = false;
       if (use_gpu == true) {
 #ifdef OL_GPU_ENABLED
+        ScopedGILRelease gil_release;
         CudaComputeOptimalPointsToSample(gaussian_process, gradient_descent_parameters, domain, thread_schedule,
-                                         input_container.points_being_sampled.data(), num_to_sample,
-                                         input_container.num_being_sampled, best_so_far, max_int_steps,
+                                         points_being_sampled, num_to_sample,
+                                         num_being_sampled, best_so_far, max_int_steps,
                                          random_search_only, num_random_samples, which_gpu, &found_flag,
                                          &randomness_source.uniform_generator, best_points_to_sample);
 #else
         OL_THROW_EXCEPTION(OptimalLearningException, "GPU is not installed or enabled!");
 #endif
       } else {
+        ScopedGILRelease gil_release;
         ComputeOptimalPointsToSample(gaussian_process, gradient_descent_parameters, domain, thread_schedule,
-                                     input_container.points_being_sampled.data(), num_to_sample,
-                                     input_container.num_being_sampled, best_so_far, max_int_steps,
-                                     random_search_only, num_random_samples, &found_flag,
+                                     points_being_sampled, num_to_sample,
+                                     num_being_sampled, best_so_far, max_int_steps,
+                                     integration_type, evaluation_type, random_search_only, num_random_samples,
+                                     &found_flag,
                                      &randomness_source.uniform_generator,
                                      randomness_source.normal_rng_vec.data(), best_points_to_sample);
       }
       status[std::string("gradient_descent_") + domain.kName + "_domain_found_update"] = found_flag;
       break;
     }  // end case kGradientDescent optimizer_type
+    case OptimizerTypes::kLBFGS: {
+      // optimizer_parameters must contain a optimizer_parameters field
+      // of type LBFGSParameters. extract it
+      const LBFGSParameters& lbfgs_parameters = boost::python::extract<LBFGSParameters&>(optimizer_parameters.attr("optimizer_parameters"));
+      AdaptiveMultistartParameters const * adaptive_parameters = GetAdaptiveMultistartParameters(optimizer_parameters);
+      ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
+      int num_random_samples = boost::python::extract<int>(optimizer_parameters.attr("num_random_samples"));
+
+      if (use_gpu == true) {
+        OL_THROW_EXCEPTION(OptimalLearningException, "GPU EI optimization only supports gradient descent!");
+      }
+      bool random_search_only = false;
+      {
+        ScopedGILRelease gil_release;
+        ComputeOptimalPointsToSampleViaLBFGS(gaussian_process, lbfgs_parameters, adaptive_parameters, domain,
+                                             thread_schedule, points_being_sampled, num_to_sample, num_being_sampled,
+                                             best_so_far, max_int_steps, integration_type, evaluation_type,
+                                             random_search_only,
+                                             num_random_samples, &found_flag, &randomness_source.uniform_generator,
+                                             randomness_source.normal_rng_vec.data(), best_points_to_sample);
+      }
+      status[std::string("lbfgs_") + domain.kName + "_domain_found_update"] = found_flag;
+      break;
+    }  // end case kLBFGS optimizer_type
     default: {
-      std::fill(best_points_to_sample, best_points_to_sample + input_container.dim*num_to_sample, 0.0);
+      std::fill(best_points_to_sample, best_points_to_sample + gaussian_process.dim()*num_to_sample, 0.0);
       OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid optimizer choice. Setting all coordinates to 0.0.");
       break;
     }
   }  // end switch over optimizer_type
 }
 
-boost::python::list MultistartExpectedImprovementOptimizationWrapper(const boost::python::object& optimizer_parameters,
-                                                                     const GaussianProcess& gaussian_process,
-                                                                     const boost::python::list& domain_bounds,
-                                                                     const boost::python::list& points_being_sampled,
-                                                                     int num_to_sample, int num_being_sampled,
-                                                                     double best_so_far, int max_int_steps,
-                                                                     int max_num_threads, bool use_gpu, int which_gpu,
-                                                                     RandomnessSourceContainer& randomness_source,
-                                                                     boost::python::dict& status) {
+/*!\rst
+  Optimizes q,p-EI over the domain selected by ``optimizer_parameters.domain_type``; shared by the list and buffer
+  wrappers.  See the ``multistart_expected_improvement_optimization`` docstring in ExportExpectedImprovementFunctions()
+  for details.
+
+  \param
+    :domain_bounds[dim]: [lower, upper] bounds for each dimension
+    :points_being_sampled[dim][num_being_sampled]: points that are being sampled in concurrent experiments
+    (other inputs as in ``multistart_expected_improvement_optimization``)
+  \output
+    :randomness_source: PRNG internal states modified
+    :status: modified on exit to describe whether convergence occurred
+    :best_points_to_sample[dim][num_to_sample]: next set of points to evaluate
+\endrst*/
+void MultistartExpectedImprovementOptimization(const boost::python::object& optimizer_parameters,
+                                               const GaussianProcess& gaussian_process,
+                                               ClosedInterval const * restrict domain_bounds,
+                                               double const * restrict points_being_sampled,
+                                               int num_to_sample, int num_being_sampled,
+                                               double best_so_far, int max_int_steps,
+                                               MonteCarloIntegrationTypes integration_type,
+                                               ExpectedImprovementEvaluationTypes evaluation_type,
+                                               int max_num_threads, bool use_gpu, int which_gpu,
+                                               RandomnessSourceContainer& randomness_source,
+                                               boost::python::dict& status,
+                                               double * restrict best_points_to_sample) {
   // TODO(GH-131): make domain objects constructible from python; and pass them in through
   // the optimizer_parameters python object
 
@@ -230,47 +404,117 @@ boost::python::list MultistartExpectedImprovementOptimizationWrapper(const boost
     OL_THROW_EXCEPTION(LowerBoundException<int>, "Fewer randomness_sources than max_num_threads.", randomness_source.normal_rng_vec.size(), max_num_threads);
   }
 
-  int num_to_sample_input = 0;  // No points to sample; we are generating these via EI optimization
-  const boost::python::list points_to_sample_dummy;
-  PythonInterfaceInputContainer input_container(points_to_sample_dummy, points_being_sampled, gaussian_process.dim(), num_to_sample_input, num_being_sampled);
-  std::vector<ClosedInterval> domain_bounds_C(input_container.dim);
-  CopyPylistToClosedIntervalVector(domain_bounds, input_container.dim, domain_bounds_C);
-
-  std::vector<double> best_points_to_sample_C(input_container.dim*num_to_sample);
-
+  const int dim = gaussian_process.dim();
   DomainTypes domain_type = boost::python::extract<DomainTypes>(optimizer_parameters.attr("domain_type"));
   OptimizerTypes optimizer_type = boost::python::extract<OptimizerTypes>(optimizer_parameters.attr("optimizer_type"));
+  // other Python threads may modify gaussian_process or use randomness_source while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  ScopedRandomnessSourceCopy randomness_source_copy(&randomness_source);
   switch (domain_type) {
     case DomainTypes::kTensorProduct: {
-      TensorProductDomain domain(domain_bounds_C.data(), input_container.dim);
-
-      DispatchExpectedImprovementOptimization(optimizer_parameters, gaussian_process, input_container,
-                                              domain, optimizer_type, num_to_sample, best_so_far,
-                                              max_int_steps, max_num_threads, use_gpu, which_gpu,
-                                              randomness_source,
-                                              status, best_points_to_sample_C.data());
+      TensorProductDomain domain(domain_bounds, dim);
+
+      DispatchExpectedImprovementOptimization(optimizer_parameters, *gaussian_process_copy, points_being_sampled,
+                                              domain, optimizer_type, num_to_sample, num_being_sampled, best_so_far,
+                                              max_int_steps, integration_type, evaluation_type, max_num_threads,
+                                              use_gpu, which_gpu,
+                                              randomness_source_copy,
+                                              status, best_points_to_sample);
       break;
     }  // end case OptimizerTypes::kTensorProduct
     case DomainTypes::kSimplex: {
-      SimplexIntersectTensorProductDomain domain(domain_bounds_C.data(), input_container.dim);
-
-      DispatchExpectedImprovementOptimization(optimizer_parameters, gaussian_process, input_container,
-                                              domain, optimizer_type, num_to_sample, best_so_far,
-                                              max_int_steps, max_num_threads, use_gpu, which_gpu,
-                                              randomness_source,
-                                              status, best_points_to_sample_C.data());
+      SimplexIntersectTensorProductDomain domain(domain_bounds, dim);
+
+      DispatchExpectedImprovementOptimization(optimizer_parameters, *gaussian_process_copy, points_being_sampled,
+                                              domain, optimizer_type, num_to_sample, num_being_sampled, best_so_far,
+                                              max_int_steps, integration_type, evaluation_type, max_num_threads,
+                                              use_gpu, which_gpu,
+                                              randomness_source_copy,
+                                              status, best_points_to_sample);
       break;
     }  // end case OptimizerTypes::kSimplex
     default: {
-      std::fill(best_points_to_sample_C.begin(), best_points_to_sample_C.end(), 0.0);
+      std::fill(best_points_to_sample, best_points_to_sample + dim*num_to_sample, 0.0);
       OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid domain choice. Setting all coordinates to 0.0.");
       break;
     }
   }  // end switch over domain_type
 
+  // report the randomized-QMC estimate (and its standard error) of q,p-EI at the solution, if it was optimized by RQMC
+  const bool monte_carlo = !(num_to_sample == 1 && num_being_sampled == 0) &&
+      (evaluation_type == ExpectedImprovementEvaluationTypes::kMonteCarlo ||
+       num_to_sample + num_being_sampled > AnalyticExpectedImprovementEvaluator::kMaxNumUnion);
+  if (integration_type == MonteCarloIntegrationTypes::kQuasiRandom && monte_carlo) {
+    ExpectedImprovementEvaluator ei_evaluator(*gaussian_process_copy, max_int_steps, best_so_far, integration_type);
+    bool configure_for_gradients = false;
+    ExpectedImprovementEvaluator::StateType ei_state(ei_evaluator, best_points_to_sample, points_being_sampled,
+                                                     num_to_sample, num_being_sampled, configure_for_gradients,
+                                                     randomness_source_copy.normal_rng_vec.data());
+    double expected_improvement;
+    double standard_error;
+    {
+      ScopedGILRelease gil_release;
+      expected_improvement = ei_evaluator.ComputeExpectedImprovementWithErrorEstimate(&ei_state, &standard_error);
+    }
+    status["expected_improvement"] = expected_improvement;
+    status["expected_improvement_standard_error"] = standard_error;
+  }
+}
+
+boost::python::list MultistartExpectedImprovementOptimizationWrapper(const boost::python::object& optimizer_parameters,
+                                                                     const GaussianProcess& gaussian_process,
+                                                                     const boost::python::list& domain_bounds,
+                                                                     const boost::python::list& points_being_sampled,
+                                                                     int num_to_sample, int num_being_sampled,
+                                                                     double best_so_far, int max_int_steps,
+                                                                     MonteCarloIntegrationTypes integration_type,
+                                                                     ExpectedImprovementEvaluationTypes evaluation_type,
+                                                                     int max_num_threads, bool use_gpu, int which_gpu,
+                                                                     RandomnessSourceContainer& randomness_source,
+                                                                     boost::python::dict& status) {
+  int num_to_sample_input = 0;  // No points to sample; we are generating these via EI optimization
+  const boost::python::list points_to_sample_dummy;
+  PythonInterfaceInputContainer input_container(points_to_sample_dummy, points_being_sampled, gaussian_process.dim(), num_to_sample_input, num_being_sampled);
+  std::vector<ClosedInterval> domain_bounds_C(input_container.dim);
+  CopyPylistToClosedIntervalVector(domain_bounds, input_container.dim, domain_bounds_C);
+
+  std::vector<double> best_points_to_sample_C(input_container.dim*num_to_sample);
+
+  MultistartExpectedImprovementOptimization(optimizer_parameters, gaussian_process, domain_bounds_C.data(),
+                                            input_container.points_being_sampled.data(), num_to_sample,
+                                            input_container.num_being_sampled, best_so_far, max_int_steps,
+                                            integration_type, evaluation_type, max_num_threads, use_gpu, which_gpu,
+                                            randomness_source, status, best_points_to_sample_C.data());
+
   return VectorToPylist(best_points_to_sample_C);
 }
 
+void MultistartExpectedImprovementOptimizationBufferWrapper(const boost::python::object& optimizer_parameters,
+                                                            const GaussianProcess& gaussian_process,
+                                                            const boost::python::object& domain_bounds,
+                                                            const boost::python::object& points_being_sampled,
+                                                            int num_to_sample, int num_being_sampled,
+                                                            double best_so_far, int max_int_steps,
+                                                            MonteCarloIntegrationTypes integration_type,
+                                                            ExpectedImprovementEvaluationTypes evaluation_type,
+                                                            int max_num_threads, bool use_gpu, int which_gpu,
+                                                            RandomnessSourceContainer& randomness_source,
+                                                            boost::python::dict& status,
+                                                            const boost::python::object& best_points_to_sample) {
+  const int dim = gaussian_process.dim();
+  std::vector<ClosedInterval> domain_bounds_C(dim);
+  CopyBufferToClosedIntervalVector(domain_bounds, dim, domain_bounds_C);
+
+  PythonBufferView points_being_sampled_view(points_being_sampled, dim*num_being_sampled, false);
+  PythonBufferView best_points_to_sample_view(best_points_to_sample, dim*num_to_sample, true);
+
+  MultistartExpectedImprovementOptimization(optimizer_parameters, gaussian_process, domain_bounds_C.data(),
+                                            points_being_sampled_view.data(), num_to_sample, num_being_sampled,
+                                            best_so_far, max_int_steps, integration_type, evaluation_type,
+                                            max_num_threads, use_gpu, which_gpu, randomness_source, status,
+                                            best_points_to_sample_view.data());
+}
+
 /*!\rst
   Utility that dispatches heuristic EI optimization (solving q,0-EI) based on optimizer type and num_to_sample.
   This is just used to reduce copy-pasted code.
@@ -281,14 +525,15 @@ boost::python::list MultistartExpectedImprovementOptimizationWrapper(const boost
       appropriate parameter structs e.g., NewtonParameters for type kNewton).
       See comments on the python interface for multistart_expected_improvement_optimization_wrapper
     :gaussian_process: GaussianProcess object (holds points_sampled, values, noise_variance, derived quantities) that describes the
-      underlying GP
+      underlying GP; a private copy, since it is read with the GIL released
     :domain: object specifying the domain to optimize over (see gpp_domain.hpp)
     :optimizer_type: type of optimization to use (e.g., null, gradient descent)
-    :estimation_policy: the policy to use to produce (heuristic) objective function estimates during multi-points EI optimization
+    :estimation_policy: the policy to use to produce (heuristic) objective function estimates during multi-points EI
+      optimization; used in place since policies are immutable after construction
     :num_to_sample: how many simultaneous experiments you would like to run (i.e., the q in q,0-EI)
     :best_so_far: value of the best sample so far (must be min(points_sampled_value))
     :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
-    :randomness_source: object containing randomness sources (sufficient for multithreading) used in EI computation
+    :randomness_source: private copy of the randomness sources (sufficient for multithreading) used in EI computation
     :status: pydict object; cannot be None
   \output
     :randomness_source: PRNG internal states modified
@@ -302,7 +547,7 @@ void DispatchHeuristicExpectedImprovementOptimization(const boost::python::objec
                                                       OptimizerTypes optimizer_type,
                                                       const ObjectiveEstimationPolicyInterface& estimation_policy,
                                                       int num_to_sample, double best_so_far, int max_num_threads,
-                                                      RandomnessSourceContainer& randomness_source,
+                                                      ScopedRandomnessSourceCopy& randomness_source,
                                                       boost::python::dict& status,
                                                       double * restrict best_points_to_sample) {
   ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
@@ -314,11 +559,14 @@ void DispatchHeuristicExpectedImprovementOptimization(const boost::python::objec
 
       bool random_search_only = true;
       GradientDescentParameters gradient_descent_parameters(0, 0, 0, 0, 1.0, 1.0, 1.0, 0.0);  // dummy struct; we aren't using gradient descent
-      ComputeHeuristicPointsToSample(gaussian_process, gradient_descent_parameters, domain,
-                                     estimation_policy, thread_schedule, best_so_far,
-                                     random_search_only, num_random_samples, num_to_sample,
-                                     &found_flag, &randomness_source.uniform_generator,
-                                     best_points_to_sample);
+      {
+        ScopedGILRelease gil_release;
+        ComputeHeuristicPointsToSample(gaussian_process, gradient_descent_parameters, domain,
+                                       estimation_policy, thread_schedule, best_so_far,
+                                       random_search_only, num_random_samples, num_to_sample,
+                                       &found_flag, &randomness_source.uniform_generator,
+                                       best_points_to_sample);
+      }
 
       status[std::string("lhc_") + domain.kName + "_domain_found_update"] = found_flag;
       break;
@@ -330,11 +578,14 @@ void DispatchHeuristicExpectedImprovementOptimization(const boost::python::objec
       int num_random_samples = boost::python::extract<int>(optimizer_parameters.attr("num_random_samples"));
 
       bool random_search_only = false;
-      ComputeHeuristicPointsToSample(gaussian_process, gradient_descent_parameters, domain,
-                                     estimation_policy, thread_schedule, best_so_far,
-                                     random_search_only, num_random_samples, num_to_sample,
-                                     &found_flag, &randomness_source.uniform_generator,
-                                     best_points_to_sample);
+      {
+        ScopedGILRelease gil_release;
+        ComputeHeuristicPointsToSample(gaussian_process, gradient_descent_parameters, domain,
+                                       estimation_policy, thread_schedule, best_so_far,
+                                       random_search_only, num_random_samples, num_to_sample,
+                                       &found_flag, &randomness_source.uniform_generator,
+                                       best_points_to_sample);
+      }
 
       status[std::string("gradient_descent_") + domain.kName + "_domain_found_update"] = found_flag;
       break;
@@ -347,58 +598,105 @@ void DispatchHeuristicExpectedImprovementOptimization(const boost::python::objec
   }  // end switch over optimizer_type
 }
 
-boost::python::list HeuristicExpectedImprovementOptimizationWrapper(const boost::python::object& optimizer_parameters,
-                                                                    const GaussianProcess& gaussian_process,
-                                                                    const boost::python::list& domain_bounds,
-                                                                    const ObjectiveEstimationPolicyInterface& estimation_policy,
-                                                                    int num_to_sample, double best_so_far, int max_num_threads,
-                                                                    RandomnessSourceContainer& randomness_source,
-                                                                    boost::python::dict& status) {
+/*!\rst
+  Heuristically optimizes q,0-EI over the domain selected by ``optimizer_parameters.domain_type``; shared by the list
+  and buffer wrappers.  See the ``heuristic_expected_improvement_optimization`` docstring in
+  ExportExpectedImprovementFunctions() for details.
+
+  \param
+    :domain_bounds[dim]: [lower, upper] bounds for each dimension
+    (other inputs as in ``heuristic_expected_improvement_optimization``)
+  \output
+    :randomness_source: PRNG internal states modified
+    :status: modified on exit to describe whether convergence occurred
+    :best_points_to_sample[dim][num_to_sample]: next set of points to evaluate
+\endrst*/
+void HeuristicExpectedImprovementOptimization(const boost::python::object& optimizer_parameters,
+                                              const GaussianProcess& gaussian_process,
+                                              ClosedInterval const * restrict domain_bounds,
+                                              const ObjectiveEstimationPolicyInterface& estimation_policy,
+                                              int num_to_sample, double best_so_far, int max_num_threads,
+                                              RandomnessSourceContainer& randomness_source,
+                                              boost::python::dict& status,
+                                              double * restrict best_points_to_sample) {
   // TODO(GH-131): make domain objects constructible from python; and pass them in through
   // the optimizer_parameters python object
   int dim = gaussian_process.dim();
-  std::vector<ClosedInterval> domain_bounds_C(dim);
-  CopyPylistToClosedIntervalVector(domain_bounds, dim, domain_bounds_C);
-
-  std::vector<double> best_points_to_sample_C(dim*num_to_sample);
-
   DomainTypes domain_type = boost::python::extract<DomainTypes>(optimizer_parameters.attr("domain_type"));
   OptimizerTypes optimizer_type = boost::python::extract<OptimizerTypes>(optimizer_parameters.attr("optimizer_type"));
+  // other Python threads may modify gaussian_process or use randomness_source while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  ScopedRandomnessSourceCopy randomness_source_copy(&randomness_source);
   switch (domain_type) {
     case DomainTypes::kTensorProduct: {
-      TensorProductDomain domain(domain_bounds_C.data(), dim);
+      TensorProductDomain domain(domain_bounds, dim);
 
-      DispatchHeuristicExpectedImprovementOptimization(optimizer_parameters, gaussian_process, domain,
+      DispatchHeuristicExpectedImprovementOptimization(optimizer_parameters, *gaussian_process_copy, domain,
                                                        optimizer_type, estimation_policy, num_to_sample,
-                                                       best_so_far, max_num_threads, randomness_source,
-                                                       status, best_points_to_sample_C.data());
+                                                       best_so_far, max_num_threads, randomness_source_copy,
+                                                       status, best_points_to_sample);
       break;
     }  // end case OptimizerTypes::kTensorProduct
     case DomainTypes::kSimplex: {
-      SimplexIntersectTensorProductDomain domain(domain_bounds_C.data(), dim);
+      SimplexIntersectTensorProductDomain domain(domain_bounds, dim);
 
-      DispatchHeuristicExpectedImprovementOptimization(optimizer_parameters, gaussian_process, domain,
+      DispatchHeuristicExpectedImprovementOptimization(optimizer_parameters, *gaussian_process_copy, domain,
                                                        optimizer_type, estimation_policy, num_to_sample,
-                                                       best_so_far, max_num_threads, randomness_source,
-                                                       status, best_points_to_sample_C.data());
+                                                       best_so_far, max_num_threads, randomness_source_copy,
+                                                       status, best_points_to_sample);
       break;
     }  // end case OptimizerTypes::kSimplex
     default: {
-      std::fill(best_points_to_sample_C.begin(), best_points_to_sample_C.end(), 0.0);
+      std::fill(best_points_to_sample, best_points_to_sample + dim*num_to_sample, 0.0);
       OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid domain choice. Setting all coordinates to 0.0.");
       break;
     }
   }  // end switch over domain_type
+}
+
+boost::python::list HeuristicExpectedImprovementOptimizationWrapper(const boost::python::object& optimizer_parameters,
+                                                                    const GaussianProcess& gaussian_process,
+                                                                    const boost::python::list& domain_bounds,
+                                                                    const ObjectiveEstimationPolicyInterface& estimation_policy,
+                                                                    int num_to_sample, double best_so_far, int max_num_threads,
+                                                                    RandomnessSourceContainer& randomness_source,
+                                                                    boost::python::dict& status) {
+  int dim = gaussian_process.dim();
+  std::vector<ClosedInterval> domain_bounds_C(dim);
+  CopyPylistToClosedIntervalVector(domain_bounds, dim, domain_bounds_C);
+
+  std::vector<double> best_points_to_sample_C(dim*num_to_sample);
+  HeuristicExpectedImprovementOptimization(optimizer_parameters, gaussian_process, domain_bounds_C.data(),
+                                           estimation_policy, num_to_sample, best_so_far, max_num_threads,
+                                           randomness_source, status, best_points_to_sample_C.data());
 
   return VectorToPylist(best_points_to_sample_C);
 }
 
+void HeuristicExpectedImprovementOptimizationBufferWrapper(const boost::python::object& optimizer_parameters,
+                                                           const GaussianProcess& gaussian_process,
+                                                           const boost::python::object& domain_bounds,
+                                                           const ObjectiveEstimationPolicyInterface& estimation_policy,
+                                                           int num_to_sample, double best_so_far, int max_num_threads,
+                                                           RandomnessSourceContainer& randomness_source,
+                                                           boost::python::dict& status,
+                                                           const boost::python::object& best_points_to_sample) {
+  int dim = gaussian_process.dim();
+  std::vector<ClosedInterval> domain_bounds_C(dim);
+  CopyBufferToClosedIntervalVector(domain_bounds, dim, domain_bounds_C);
+
+  PythonBufferView best_points_to_sample_view(best_points_to_sample, dim*num_to_sample, true);
+  HeuristicExpectedImprovementOptimization(optimizer_parameters, gaussian_process, domain_bounds_C.data(),
+                                           estimation_policy, num_to_sample, best_so_far, max_num_threads,
+                                           randomness_source, status, best_points_to_sample_view.data());
+}
+
 boost::python::list EvaluateEIAtPointListWrapper(const GaussianProcess& gaussian_process,
                                                  const boost::python::list& initial_guesses,
                                                  const boost::python::list& points_being_sampled,
                                                  int num_multistarts, int num_to_sample,
                                                  int num_being_sampled, double best_so_far,
-                                                 int max_int_steps, int max_num_threads,
+                                                 int max_int_steps, bool force_monte_carlo, int max_num_threads,
                                                  RandomnessSourceContainer& randomness_source,
                                                  boost::python::dict& status) {
   // abort if we do not have enough sources of randomness to run with max_num_threads
@@ -418,17 +716,65 @@ boost::python::list EvaluateEIAtPointListWrapper(const GaussianProcess& gaussian
 
   ThreadSchedule thread_schedule(max_num_threads, omp_sched_static);
   bool found_flag = false;
-  EvaluateEIAtPointList(gaussian_process, thread_schedule, initial_guesses_C.data(),
-                        input_container.points_being_sampled.data(), num_multistarts,
-                        num_to_sample, input_container.num_being_sampled, best_so_far,
-                        max_int_steps, &found_flag, randomness_source.normal_rng_vec.data(),
-                        result_function_values_C.data(), result_point_C.data());
+  // other Python threads may modify gaussian_process or use randomness_source while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  ScopedRandomnessSourceCopy randomness_source_copy(&randomness_source);
+  {
+    ScopedGILRelease gil_release;
+    EvaluateEIAtPointList(*gaussian_process_copy, thread_schedule, initial_guesses_C.data(),
+                          input_container.points_being_sampled.data(), num_multistarts,
+                          num_to_sample, input_container.num_being_sampled, best_so_far,
+                          max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                          force_monte_carlo ? ExpectedImprovementEvaluationTypes::kMonteCarlo :
+                          ExpectedImprovementEvaluationTypes::kAnalytic, &found_flag,
+                          randomness_source_copy.normal_rng_vec.data(),
+                          result_function_values_C.data(), result_point_C.data());
+  }
 
   status["evaluate_EI_at_point_list"] = found_flag;
 
   return VectorToPylist(result_function_values_C);
 }
 
+void EvaluateEIAtPointListBufferWrapper(const GaussianProcess& gaussian_process,
+                                        const boost::python::object& initial_guesses,
+                                        const boost::python::object& points_being_sampled,
+                                        int num_multistarts, int num_to_sample,
+                                        int num_being_sampled, double best_so_far,
+                                        int max_int_steps, bool force_monte_carlo, int max_num_threads,
+                                        RandomnessSourceContainer& randomness_source,
+                                        boost::python::dict& status,
+                                        const boost::python::object& function_values) {
+  // abort if we do not have enough sources of randomness to run with max_num_threads
+  if (unlikely(max_num_threads > static_cast<int>(randomness_source.normal_rng_vec.size()))) {
+    OL_THROW_EXCEPTION(LowerBoundException<int>, "Fewer randomness_sources than max_num_threads.", randomness_source.normal_rng_vec.size(), max_num_threads);
+  }
+
+  const int dim = gaussian_process.dim();
+  PythonBufferView initial_guesses_view(initial_guesses, dim*num_to_sample*num_multistarts, false);
+  PythonBufferView points_being_sampled_view(points_being_sampled, dim*num_being_sampled, false);
+  PythonBufferView function_values_view(function_values, num_multistarts, true);
+  std::vector<double> result_point_C(dim*num_to_sample);  // not used
+
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_static);
+  bool found_flag = false;
+  // other Python threads may modify gaussian_process or use randomness_source while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  ScopedRandomnessSourceCopy randomness_source_copy(&randomness_source);
+  {
+    ScopedGILRelease gil_release;
+    EvaluateEIAtPointList(*gaussian_process_copy, thread_schedule, initial_guesses_view.data(),
+                          points_being_sampled_view.data(), num_multistarts, num_to_sample, num_being_sampled,
+                          best_so_far, max_int_steps, MonteCarloIntegrationTypes::kPseudoRandom,
+                          force_monte_carlo ? ExpectedImprovementEvaluationTypes::kMonteCarlo :
+                          ExpectedImprovementEvaluationTypes::kAnalytic, &found_flag,
+                          randomness_source_copy.normal_rng_vec.data(), function_values_view.data(),
+                          result_point_C.data());
+  }
+
+  status["evaluate_EI_at_point_list"] = found_flag;
+}
+
 }  // end unnamed namespace
 
 void ExportEstimationPolicies() {
@@ -475,6 +821,14 @@ void ExportEstimationPolicies() {
 }
 
 void ExportExpectedImprovementFunctions() {
+  // boost::python tries overloads in reverse order of registration, so buffer overloads with the same arity as a list
+  // overload are registered FIRST (see ExportGaussianProcessFunctions() in gpp_python_gaussian_process.cpp).
+  boost::python::def("compute_expected_improvement", ComputeExpectedImprovementBufferWrapper, R"%%(
+    Same as the list overload (below) except ``points_to_sample`` and ``points_being_sampled`` are read in place from
+    buffers (e.g., C-contiguous numpy arrays of float64) with the same shapes.  ``points_being_sampled`` may be None if
+    ``num_being_sampled == 0``.
+    )%%");
+
   boost::python::def("compute_expected_improvement", ComputeExpectedImprovementWrapper, R"%%(
     Compute expected improvement.
     If ``num_to_sample == 1`` and ``num_being_sampled == 0`` AND ``force_monte_carlo is false``, this will
@@ -533,6 +887,17 @@ void ExportExpectedImprovementFunctions() {
     :rtype: list of float64 with shape (num_to_sample, dim)
     )%%");
 
+  boost::python::def("compute_grad_expected_improvement", ComputeGradExpectedImprovementBufferWrapper, R"%%(
+    Compute the gradient of expected improvement into a preallocated buffer (zero-copy).
+
+    Same as the list overload except ``points_to_sample`` and ``points_being_sampled`` are buffers (e.g., C-contiguous
+    numpy arrays of float64) with the same shapes (``points_being_sampled`` may be None if ``num_being_sampled == 0``),
+    and the result is written into ``grad_EI`` instead of returned.
+
+    :param grad_EI: (output) gradient of EI (computed at points_to_sample + points_being_sampled, wrt points_to_sample)
+    :type grad_EI: writable buffer of float64 with shape (num_to_sample, dim)
+    )%%");
+
   boost::python::def("multistart_expected_improvement_optimization", MultistartExpectedImprovementOptimizationWrapper, R"%%(
     Optimize expected improvement (i.e., solve q,p-EI) over the specified domain using the specified optimization method.
     Can optimize for num_to_sample new points to sample (i.e., aka "q", experiments to run) simultaneously.
@@ -574,6 +939,13 @@ void ExportExpectedImprovementFunctions() {
     :type best_so_far: float64
     :param max_int_steps: number of MC integration points in EI
     :type max_int_steps: int >= 0
+    :param integration_type: source of the MC integration points: pseudo-random (plain MC) or quasi-random
+      (randomized QMC; not supported with use_gpu). If q,p-EI is optimized with quasi_random MC, ``status`` also
+      receives ``expected_improvement`` and ``expected_improvement_standard_error`` (RQMC estimate at the result).
+    :type integration_type: MonteCarloIntegrationTypes
+    :param evaluation_type: how q,p-EI other than 1,0-EI is computed: monte_carlo (with max_int_steps and
+      integration_type) or analytic (multivariate normal CDFs; only if q + p <= 4, monte_carlo otherwise)
+    :type evaluation_type: ExpectedImprovementEvaluationTypes
     :param max_num_threads: max number of threads to use during EI optimization
     :type max_num_threads: int >= 1
     :param use_gpu: set to 1 if user wants to use GPU for MC computation
@@ -588,6 +960,17 @@ void ExportExpectedImprovementFunctions() {
     :rtype: list of float64 with shape (num_to_sample, dim)
     )%%");
 
+  boost::python::def("multistart_expected_improvement_optimization", MultistartExpectedImprovementOptimizationBufferWrapper, R"%%(
+    Optimize expected improvement (i.e., solve q,p-EI) into a preallocated buffer (zero-copy).
+
+    Same as the list overload except ``domain`` and ``points_being_sampled`` are buffers (e.g., C-contiguous numpy
+    arrays of float64) with the same shapes (``points_being_sampled`` may be None if ``num_being_sampled == 0``), and
+    the result is written into ``best_points_to_sample`` instead of returned.
+
+    :param best_points_to_sample: (output) next set of points to eval
+    :type best_points_to_sample: writable buffer of float64 with shape (num_to_sample, dim)
+    )%%");
+
   boost::python::def("heuristic_expected_improvement_optimization", HeuristicExpectedImprovementOptimizationWrapper, R"%%(
     Compute a heuristic approximation to the result of multistart_expected_improvement_optimization(). That is, it
     optimizes an approximation to q,0-EI over the specified domain using the specified optimization method.
@@ -647,6 +1030,16 @@ void ExportExpectedImprovementFunctions() {
     :rtype: list of float64 with shape (num_to_sample, dim)
     )%%");
 
+  boost::python::def("heuristic_expected_improvement_optimization", HeuristicExpectedImprovementOptimizationBufferWrapper, R"%%(
+    Heuristically optimize q,0-EI into a preallocated buffer (zero-copy).
+
+    Same as the list overload except ``domain`` is a buffer (e.g., a C-contiguous numpy array of float64) with the same
+    shape, and the result is written into ``best_points_to_sample`` instead of returned.
+
+    :param best_points_to_sample: (output) next set of points to eval
+    :type best_points_to_sample: writable buffer of float64 with shape (num_to_sample, dim)
+    )%%");
+
   boost::python::def("evaluate_EI_at_point_list", EvaluateEIAtPointListWrapper, R"%%(
     Evaluates the expected improvement at each point in initial_guesses; can handle q,p-EI.
     Useful for plotting.
@@ -682,6 +1075,9 @@ void ExportExpectedImprovementFunctions() {
     :type best_so_far: float64
     :param max_int_steps: number of MC integration points in EI
     :type max_int_steps: int >= 0
+    :param force_monte_carlo: true to force monte carlo evaluation of EI; otherwise q,p-EI with q + p <= 4 is
+      computed analytically
+    :type force_monte_carlo: bool
     :param max_num_threads: max number of threads to use during EI optimization
     :type max_num_threads: int >= 1
     :param randomness_source: object containing randomness sources; only thread 0's source is used
@@ -691,6 +1087,17 @@ void ExportExpectedImprovementFunctions() {
     :return: EI values at each point of the initial_guesses list, in the same order
     :rtype: list of float64 with shape (num_multistarts, )
     )%%");
+
+  boost::python::def("evaluate_EI_at_point_list", EvaluateEIAtPointListBufferWrapper, R"%%(
+    Compute EI at each point of initial_guesses into a preallocated buffer (zero-copy).
+
+    Same as the list overload except ``initial_guesses`` and ``points_being_sampled`` are buffers (e.g., C-contiguous
+    numpy arrays of float64) with the same shapes (``points_being_sampled`` may be None if ``num_being_sampled == 0``),
+    and the result is written into ``function_values`` instead of returned.
+
+    :param function_values: (output) EI values at each point of the initial_guesses list, in the same order
+    :type function_values: writable buffer of float64 with shape (num_multistarts, )
+    )%%");
 }
 
 }  // end namespace optimal_learning
@@ -16,12 +16,17 @@
 #include "gpp_python_gaussian_process.hpp"
 
 // NOLINT-ing the C, C++ header includes as well; otherwise cpplint gets confused
+#include <memory>  // NOLINT(build/include_order)
+#include <string>  // NOLINT(build/include_order)
 #include <vector>  // NOLINT(build/include_order)
 
 #include <boost/python/def.hpp>  // NOLINT(build/include_order)
 #include <boost/python/class.hpp>  // NOLINT(build/include_order)
 #include <boost/python/list.hpp>  // NOLINT(build/include_order)
 #include <boost/python/make_constructor.hpp>  // NOLINT(build/include_order)
+#include <boost/python/object.hpp>  // NOLINT(build/include_order)
+#include <boost/python/return_value_policy.hpp>  // NOLINT(build/include_order)
+#include <boost/python/manage_new_object.hpp>  // NOLINT(build/include_order)
 
 #include "gpp_common.hpp"
 #include "gpp_covariance.hpp"
@@ -29,6 +34,9 @@
 #include "gpp_linear_algebra.hpp"
 #include "gpp_logging.hpp"
 #include "gpp_math.hpp"
+#include "gpp_model_cache.hpp"
+#include "gpp_model_snapshot.hpp"
+#include "gpp_optimization.hpp"
 #include "gpp_python_common.hpp"
 
 namespace optimal_learning {
@@ -61,61 +69,264 @@ GaussianProcess * make_gaussian_process(const boost::python::list& hyperparamete
   return new_gp;
 }
 
+/*!\rst
+  Surrogate "constructor" for GaussianProcess intended only for use by boost::python.  Same as make_gaussian_process()
+  except historical data are read in place from buffers (see PythonBufferView) instead of copied from lists.
+\endrst*/
+GaussianProcess * make_gaussian_process_from_buffers(const boost::python::list& hyperparameters,
+                                                     const boost::python::object& points_sampled,
+                                                     const boost::python::object& points_sampled_value,
+                                                     const boost::python::object& noise_variance,
+                                                     int dim, int num_sampled) {
+  const double alpha = boost::python::extract<double>(hyperparameters[0]);
+  const boost::python::list& lengths_in = boost::python::extract<boost::python::list>(hyperparameters[1]);
+  std::vector<double> lengths(dim);
+  CopyPylistToVector(lengths_in, dim, lengths);
+
+  const bool writable = false;
+  PythonBufferView points_sampled_view(points_sampled, dim*num_sampled, writable);
+  PythonBufferView points_sampled_value_view(points_sampled_value, num_sampled, writable);
+  PythonBufferView noise_variance_view(noise_variance, num_sampled, writable);
+
+  SquareExponential square_exponential(dim, alpha, lengths.data());
+
+  GaussianProcess * new_gp = new GaussianProcess(square_exponential, points_sampled_view.data(),
+                                                 points_sampled_value_view.data(), noise_variance_view.data(),
+                                                 dim, num_sampled);
+  new_gp->SetRandomizedSeed(0);
+  return new_gp;
+}
+
+/*!\rst
+  Computes the GP mean at ``points_to_sample``; shared by the list and buffer wrappers.
+
+  \param
+    :gaussian_process: GP to evaluate
+    :points_to_sample[dim][num_to_sample]: points at which to compute the mean
+    :num_to_sample: number of points
+  \output
+    :to_sample_mean[num_to_sample]: GP mean at each point
+\endrst*/
+void GetMean(const GaussianProcess& gaussian_process, double const * restrict points_to_sample, int num_to_sample,
+             double * restrict to_sample_mean) {
+  int num_derivatives = 0;
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample, num_to_sample, num_derivatives);
+  gaussian_process.ComputeMeanOfPoints(points_to_sample_state, to_sample_mean);
+}
+
+/*!\rst
+  Computes the gradient of the GP mean wrt each of ``points_to_sample``; shared by the list and buffer wrappers.
+
+  \param
+    :gaussian_process: GP to evaluate
+    :points_to_sample[dim][num_to_sample]: points at which to compute the gradient of the mean
+    :num_to_sample: number of points
+  \output
+    :to_sample_grad_mean[dim][num_to_sample]: gradient of the GP mean at each point
+\endrst*/
+void GetGradMean(const GaussianProcess& gaussian_process, double const * restrict points_to_sample, int num_to_sample,
+                 double * restrict to_sample_grad_mean) {
+  int num_derivatives = num_to_sample;
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample, num_to_sample, num_derivatives);
+  gaussian_process.ComputeGradMeanOfPoints(points_to_sample_state, to_sample_grad_mean);
+}
+
+/*!\rst
+  Computes the GP variance at ``points_to_sample``, filling in both triangles (Python expects a full symmetric matrix);
+  shared by the list and buffer wrappers.
+
+  \param
+    :gaussian_process: GP to evaluate
+    :points_to_sample[dim][num_to_sample]: points at which to compute the variance
+    :num_to_sample: number of points
+  \output
+    :to_sample_var[num_to_sample][num_to_sample]: GP variance of the points
+\endrst*/
+void GetVar(const GaussianProcess& gaussian_process, double const * restrict points_to_sample, int num_to_sample,
+            double * restrict to_sample_var) {
+  int num_derivatives = 0;
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample, num_to_sample, num_derivatives);
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, to_sample_var);
+
+  // copy lower triangle of var into its upper triangle b/c python expects a proper symmetric matrix
+  for (int i = 0; i < num_to_sample; ++i) {
+    for (int j = 0; j < i; ++j) {
+      to_sample_var[i*num_to_sample + j] = to_sample_var[j*num_to_sample + i];
+    }
+  }
+}
+
 boost::python::list GetMeanWrapper(const GaussianProcess& gaussian_process,
                                    const boost::python::list& points_to_sample,
                                    int num_to_sample) {
   PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
 
   std::vector<double> to_sample_mean(input_container.num_to_sample);
-  int num_derivatives = 0;
-  GaussianProcess::StateType points_to_sample_state(gaussian_process, input_container.points_to_sample.data(),
-                                                    input_container.num_to_sample, num_derivatives);
-  gaussian_process.ComputeMeanOfPoints(points_to_sample_state, to_sample_mean.data());
+  GetMean(gaussian_process, input_container.points_to_sample.data(), input_container.num_to_sample,
+          to_sample_mean.data());
 
   return VectorToPylist(to_sample_mean);
 }
 
+void GetMeanBufferWrapper(const GaussianProcess& gaussian_process,
+                          const boost::python::object& points_to_sample,
+                          int num_to_sample,
+                          const boost::python::object& to_sample_mean) {
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, false);
+  PythonBufferView to_sample_mean_view(to_sample_mean, num_to_sample, true);
+
+  GetMean(gaussian_process, points_to_sample_view.data(), num_to_sample, to_sample_mean_view.data());
+}
+
 boost::python::list GetGradMeanWrapper(const GaussianProcess& gaussian_process,
                                        const boost::python::list& points_to_sample,
                                        int num_to_sample) {
   PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
 
   std::vector<double> to_sample_grad_mean(input_container.dim*input_container.num_to_sample);
-  int num_derivatives = num_to_sample;
-  GaussianProcess::StateType points_to_sample_state(gaussian_process, input_container.points_to_sample.data(),
-                                                    input_container.num_to_sample, num_derivatives);
-  gaussian_process.ComputeGradMeanOfPoints(points_to_sample_state, to_sample_grad_mean.data());
+  GetGradMean(gaussian_process, input_container.points_to_sample.data(), input_container.num_to_sample,
+              to_sample_grad_mean.data());
 
   return VectorToPylist(to_sample_grad_mean);
 }
 
+void GetGradMeanBufferWrapper(const GaussianProcess& gaussian_process,
+                              const boost::python::object& points_to_sample,
+                              int num_to_sample,
+                              const boost::python::object& to_sample_grad_mean) {
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, false);
+  PythonBufferView to_sample_grad_mean_view(to_sample_grad_mean, gaussian_process.dim()*num_to_sample, true);
+
+  GetGradMean(gaussian_process, points_to_sample_view.data(), num_to_sample, to_sample_grad_mean_view.data());
+}
+
 boost::python::list GetVarWrapper(const GaussianProcess& gaussian_process,
                                   const boost::python::list& points_to_sample,
                                   int num_to_sample) {
   PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
 
   std::vector<double> to_sample_var(Square(input_container.num_to_sample));
-  int num_derivatives = 0;
-  GaussianProcess::StateType points_to_sample_state(gaussian_process, input_container.points_to_sample.data(),
-                                                    input_container.num_to_sample, num_derivatives);
-  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, to_sample_var.data());
+  GetVar(gaussian_process, input_container.points_to_sample.data(), input_container.num_to_sample,
+         to_sample_var.data());
+
+  return VectorToPylist(to_sample_var);
+}
+
+void GetVarBufferWrapper(const GaussianProcess& gaussian_process,
+                         const boost::python::object& points_to_sample,
+                         int num_to_sample,
+                         const boost::python::object& to_sample_var) {
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, false);
+  PythonBufferView to_sample_var_view(to_sample_var, Square(num_to_sample), true);
+
+  GetVar(gaussian_process, points_to_sample_view.data(), num_to_sample, to_sample_var_view.data());
+}
+
+boost::python::list GetMeanAndMarginalVarWrapper(const GaussianProcess& gaussian_process,
+                                                 const boost::python::list& points_to_sample,
+                                                 int num_to_sample, int max_num_threads) {
+  PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
+
+  std::vector<double> to_sample_mean(input_container.num_to_sample);
+  std::vector<double> to_sample_marginal_var(input_container.num_to_sample);
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_static);
+  // other Python threads may modify gaussian_process while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  {
+    ScopedGILRelease gil_release;
+    ComputeMeanAndMarginalVarianceOfPointList(*gaussian_process_copy, thread_schedule,
+                                              input_container.points_to_sample.data(), input_container.num_to_sample,
+                                              to_sample_mean.data(), to_sample_marginal_var.data());
+  }
 
   boost::python::list result;
+  result.append(VectorToPylist(to_sample_mean));
+  result.append(VectorToPylist(to_sample_marginal_var));
+  return result;
+}
 
-  // copy lower triangle of chol_var into its upper triangle b/c python expects a proper symmetric matrix
+void GetMeanAndMarginalVarBufferWrapper(const GaussianProcess& gaussian_process,
+                                        const boost::python::object& points_to_sample,
+                                        int num_to_sample, int max_num_threads,
+                                        const boost::python::object& to_sample_mean,
+                                        const boost::python::object& to_sample_marginal_var) {
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, false);
+  PythonBufferView to_sample_mean_view(to_sample_mean, num_to_sample, true);
+  PythonBufferView to_sample_marginal_var_view(to_sample_marginal_var, num_to_sample, true);
+
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_static);
+  // other Python threads may modify gaussian_process while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  {
+    ScopedGILRelease gil_release;
+    ComputeMeanAndMarginalVarianceOfPointList(*gaussian_process_copy, thread_schedule, points_to_sample_view.data(),
+                                              num_to_sample, to_sample_mean_view.data(),
+                                              to_sample_marginal_var_view.data());
+  }
+}
+
+/*!\rst
+  Computes the cholesky factor of the GP variance at ``points_to_sample``, stored ROW-major with the upper triangle
+  zeroed (the layout Python expects); shared by the list and buffer wrappers.
+
+  \param
+    :gaussian_process: GP to evaluate
+    :points_to_sample[dim][num_to_sample]: points at which to compute the cholesky factor of the variance
+    :num_to_sample: number of points
+  \output
+    :chol_var[num_to_sample][num_to_sample]: cholesky factor (L) of the GP variance of the points
+  \raise
+    SingularMatrixException if the GP variance is singular
+\endrst*/
+void GetCholVar(const GaussianProcess& gaussian_process, double const * restrict points_to_sample, int num_to_sample,
+                double * restrict chol_var) {
+  int num_derivatives = 0;
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample, num_to_sample, num_derivatives);
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, chol_var);
+  int leading_minor = ComputeCholeskyFactorL(num_to_sample, chol_var);
+  if (unlikely(leading_minor != 0)) {
+    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample or points_to_sample duplicating points_sampled with 0 noise.", chol_var, num_to_sample, leading_minor);
+  }
+
+  // transpose the (column-major) lower triangle into the upper triangle and zero the lower triangle
   for (int i = 0; i < num_to_sample; ++i) {
     for (int j = 0; j < i; ++j) {
-      to_sample_var[i*num_to_sample + j] = to_sample_var[j*num_to_sample + i];
+      chol_var[i*num_to_sample + j] = chol_var[j*num_to_sample + i];
+      chol_var[j*num_to_sample + i] = 0.0;
     }
   }
+}
 
-  for (int i = 0; i < num_to_sample; ++i) {
-    for (int j = 0; j < num_to_sample; ++j) {
-      result.append(to_sample_var[j*num_to_sample + i]);
-    }
+/*!\rst
+  Computes the gradient of the GP variance (``with_cholesky == false``) or of its cholesky factor (``with_cholesky ==
+  true``) wrt ``points_to_sample[0:num_derivatives]``; shared by the list and buffer wrappers.
+
+  \param
+    :gaussian_process: GP to evaluate
+    :points_to_sample[dim][num_to_sample]: points at which to compute the gradient
+    :num_to_sample: number of points
+    :num_derivatives: differentiate wrt ``points_to_sample[0:num_derivatives]``
+    :with_cholesky: true to differentiate the cholesky factor of the variance instead of the variance
+  \output
+    :to_sample_grad_var[dim][num_to_sample][num_to_sample][num_derivatives]: gradient of the (cholesky factored) variance
+  \raise
+    SingularMatrixException if ``with_cholesky`` and the GP variance is singular
+\endrst*/
+void GetGradVar(const GaussianProcess& gaussian_process, double const * restrict points_to_sample, int num_to_sample,
+                int num_derivatives, bool with_cholesky, double * restrict to_sample_grad_var) {
+  GaussianProcess::StateType points_to_sample_state(gaussian_process, points_to_sample, num_to_sample, num_derivatives);
+  if (with_cholesky == false) {
+    gaussian_process.ComputeGradVarianceOfPoints(&points_to_sample_state, to_sample_grad_var);
+    return;
   }
 
-  return result;
+  std::vector<double> chol_var(Square(num_to_sample));
+  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, chol_var.data());
+  int leading_minor = ComputeCholeskyFactorL(num_to_sample, chol_var.data());
+  if (unlikely(leading_minor != 0)) {
+    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample or points_to_sample duplicating points_sampled with 0 noise.", chol_var.data(), num_to_sample, leading_minor);
+  }
+  gaussian_process.ComputeGradCholeskyVarianceOfPoints(&points_to_sample_state, chol_var.data(), to_sample_grad_var);
 }
 
 boost::python::list GetCholVarWrapper(const GaussianProcess& gaussian_process,
@@ -124,25 +335,20 @@ boost::python::list GetCholVarWrapper(const GaussianProcess& gaussian_process,
   PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
 
   std::vector<double> chol_var(Square(input_container.num_to_sample));
-  int num_derivatives = 0;
-  GaussianProcess::StateType points_to_sample_state(gaussian_process, input_container.points_to_sample.data(),
-                                                    input_container.num_to_sample, num_derivatives);
-  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, chol_var.data());
-  int leading_minor = ComputeCholeskyFactorL(num_to_sample, chol_var.data());
-  if (unlikely(leading_minor != 0)) {
-    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample or points_to_sample duplicating points_sampled with 0 noise.", chol_var.data(), num_to_sample, leading_minor);
-  }
+  GetCholVar(gaussian_process, input_container.points_to_sample.data(), input_container.num_to_sample,
+             chol_var.data());
 
-  boost::python::list result;
+  return VectorToPylist(chol_var);
+}
 
-  ZeroUpperTriangle(num_to_sample, chol_var.data());
-  for (int i = 0; i < num_to_sample; ++i) {
-    for (int j = 0; j < num_to_sample; ++j) {
-      result.append(chol_var[j*num_to_sample + i]);
-    }
-  }
+void GetCholVarBufferWrapper(const GaussianProcess& gaussian_process,
+                             const boost::python::object& points_to_sample,
+                             int num_to_sample,
+                             const boost::python::object& chol_var) {
+  PythonBufferView points_to_sample_view(points_to_sample, gaussian_process.dim()*num_to_sample, false);
+  PythonBufferView chol_var_view(chol_var, Square(num_to_sample), true);
 
-  return result;
+  GetCholVar(gaussian_process, points_to_sample_view.data(), num_to_sample, chol_var_view.data());
 }
 
 boost::python::list GetGradVarWrapper(const GaussianProcess& gaussian_process,
@@ -151,33 +357,52 @@ boost::python::list GetGradVarWrapper(const GaussianProcess& gaussian_process,
   PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
 
   std::vector<double> to_sample_grad_var(input_container.dim*Square(input_container.num_to_sample)*num_derivatives);
-  GaussianProcess::StateType points_to_sample_state(gaussian_process, input_container.points_to_sample.data(),
-                                                    input_container.num_to_sample, num_derivatives);
-  gaussian_process.ComputeGradVarianceOfPoints(&points_to_sample_state, to_sample_grad_var.data());
+  const bool with_cholesky = false;
+  GetGradVar(gaussian_process, input_container.points_to_sample.data(), input_container.num_to_sample,
+             num_derivatives, with_cholesky, to_sample_grad_var.data());
 
   return VectorToPylist(to_sample_grad_var);
 }
 
+void GetGradVarBufferWrapper(const GaussianProcess& gaussian_process,
+                             const boost::python::object& points_to_sample,
+                             int num_to_sample, int num_derivatives,
+                             const boost::python::object& to_sample_grad_var) {
+  const int dim = gaussian_process.dim();
+  PythonBufferView points_to_sample_view(points_to_sample, dim*num_to_sample, false);
+  PythonBufferView to_sample_grad_var_view(to_sample_grad_var, dim*Square(num_to_sample)*num_derivatives, true);
+
+  const bool with_cholesky = false;
+  GetGradVar(gaussian_process, points_to_sample_view.data(), num_to_sample, num_derivatives, with_cholesky,
+             to_sample_grad_var_view.data());
+}
+
 boost::python::list GetGradCholVarWrapper(const GaussianProcess& gaussian_process,
                                           const boost::python::list& points_to_sample,
                                           int num_to_sample, int num_derivatives) {
   PythonInterfaceInputContainer input_container(points_to_sample, gaussian_process.dim(), num_to_sample);
 
   std::vector<double> to_sample_grad_var(input_container.dim*Square(input_container.num_to_sample)*num_derivatives);
-  std::vector<double> chol_var(Square(input_container.num_to_sample));
-  GaussianProcess::StateType points_to_sample_state(gaussian_process, input_container.points_to_sample.data(),
-                                                    input_container.num_to_sample, num_derivatives);
-  gaussian_process.ComputeVarianceOfPoints(&points_to_sample_state, chol_var.data());
-  int leading_minor = ComputeCholeskyFactorL(input_container.num_to_sample, chol_var.data());
-  if (unlikely(leading_minor != 0)) {
-    OL_THROW_EXCEPTION(SingularMatrixException, "GP-Variance matrix singular. Check for duplicate points_to_sample or points_to_sample duplicating points_sampled with 0 noise.", chol_var.data(), num_to_sample, leading_minor);
-  }
-  gaussian_process.ComputeGradCholeskyVarianceOfPoints(&points_to_sample_state, chol_var.data(),
-                                                       to_sample_grad_var.data());
+  const bool with_cholesky = true;
+  GetGradVar(gaussian_process, input_container.points_to_sample.data(), input_container.num_to_sample,
+             num_derivatives, with_cholesky, to_sample_grad_var.data());
 
   return VectorToPylist(to_sample_grad_var);
 }
 
+void GetGradCholVarBufferWrapper(const GaussianProcess& gaussian_process,
+                                 const boost::python::object& points_to_sample,
+                                 int num_to_sample, int num_derivatives,
+                                 const boost::python::object& to_sample_grad_var) {
+  const int dim = gaussian_process.dim();
+  PythonBufferView points_to_sample_view(points_to_sample, dim*num_to_sample, false);
+  PythonBufferView to_sample_grad_var_view(to_sample_grad_var, dim*Square(num_to_sample)*num_derivatives, true);
+
+  const bool with_cholesky = true;
+  GetGradVar(gaussian_process, points_to_sample_view.data(), num_to_sample, num_derivatives, with_cholesky,
+             to_sample_grad_var_view.data());
+}
+
 void AddPointsToGPWrapper(GaussianProcess * gaussian_process,
                           const boost::python::list& new_points,
                           const boost::python::list& new_points_value,
@@ -196,6 +421,20 @@ void AddPointsToGPWrapper(GaussianProcess * gaussian_process,
                                   new_points_noise_variance_C.data(), num_new_points);
 }
 
+void AddPointsToGPBufferWrapper(GaussianProcess * gaussian_process,
+                                const boost::python::object& new_points,
+                                const boost::python::object& new_points_value,
+                                const boost::python::object& new_points_noise_variance,
+                                int num_new_points) {
+  const bool writable = false;
+  PythonBufferView new_points_view(new_points, gaussian_process->dim()*num_new_points, writable);
+  PythonBufferView new_points_value_view(new_points_value, num_new_points, writable);
+  PythonBufferView new_points_noise_variance_view(new_points_noise_variance, num_new_points, writable);
+
+  gaussian_process->AddPointsToGP(new_points_view.data(), new_points_value_view.data(),
+                                  new_points_noise_variance_view.data(), num_new_points);
+}
+
 double SamplePointFromGPWrapper(GaussianProcess * gaussian_process,
                                 const boost::python::list& point_to_sample,
                                 double noise_variance) {
@@ -205,6 +444,113 @@ double SamplePointFromGPWrapper(GaussianProcess * gaussian_process,
   return gaussian_process->SamplePointFromGP(input_container.points_to_sample.data(), noise_variance);
 }
 
+double SamplePointFromGPBufferWrapper(GaussianProcess * gaussian_process,
+                                      const boost::python::object& point_to_sample,
+                                      double noise_variance) {
+  PythonBufferView point_to_sample_view(point_to_sample, gaussian_process->dim(), false);
+
+  return gaussian_process->SamplePointFromGP(point_to_sample_view.data(), noise_variance);
+}
+
+/*!\rst
+  Looks up (or fits) the GaussianProcess with a square exponential covariance; shared by the list and buffer wrappers.
+  Releases the GIL while fitting.
+
+  Cached models are shared (and const), so Python never receives one: the result is a new GaussianProcess reading the
+  cached model's cholesky factor in place (copy-on-write; see the derived-quantities GaussianProcess constructor) and
+  keeping that model alive.  Modifying the result copies the factor first and never changes the cache.  Like the
+  GaussianProcess constructor wrapper, the result's internal NormalRNG is seeded randomly.
+
+  \param
+    :model_cache: cache to query
+    :hyperparameters: covariance hyperparameters, ``[alpha, [length_0, ..., length_{dim-1}]]``
+    :points_sampled[dim][num_sampled]: points that have already been sampled
+    :points_sampled_value[num_sampled]: values of the already-sampled points
+    :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+    :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+    :num_sampled: number of already-sampled points
+  \return
+    a new (caller-owned) GaussianProcess fit to the inputs
+\endrst*/
+GaussianProcess * GetOrFit(GaussianProcessCache * model_cache,
+                           const boost::python::list& hyperparameters,
+                           double const * restrict points_sampled,
+                           double const * restrict points_sampled_value,
+                           double const * restrict noise_variance,
+                           int dim, int num_sampled) {
+  const double alpha = boost::python::extract<double>(hyperparameters[0]);
+  const boost::python::list& lengths_in = boost::python::extract<boost::python::list>(hyperparameters[1]);
+  std::vector<double> lengths(dim);
+  CopyPylistToVector(lengths_in, dim, lengths);
+  SquareExponential square_exponential(dim, alpha, lengths.data());
+
+  std::shared_ptr<const GaussianProcess> cached_gaussian_process;
+  {
+    ScopedGILRelease gil_release;
+    cached_gaussian_process = model_cache->GetOrFit(square_exponential, points_sampled, points_sampled_value,
+                                                    noise_variance, dim, num_sampled);
+  }
+  std::unique_ptr<GaussianProcess> gaussian_process(
+      new GaussianProcess(cached_gaussian_process->covariance(), cached_gaussian_process->points_sampled().data(),
+                          cached_gaussian_process->points_sampled_value().data(),
+                          cached_gaussian_process->noise_variance().data(), cached_gaussian_process->K_chol(),
+                          cached_gaussian_process->K_inv_y().data(), cached_gaussian_process, dim, num_sampled));
+  gaussian_process->SetRandomizedSeed(0);
+  return gaussian_process.release();
+}
+
+GaussianProcess * GetOrFitWrapper(GaussianProcessCache * model_cache,
+                                  const boost::python::list& hyperparameters,
+                                  const boost::python::list& points_sampled,
+                                  const boost::python::list& points_sampled_value,
+                                  const boost::python::list& noise_variance,
+                                  int dim, int num_sampled) {
+  std::vector<double> points_sampled_C(dim*num_sampled);
+  std::vector<double> points_sampled_value_C(num_sampled);
+  std::vector<double> noise_variance_C(num_sampled);
+  CopyPylistToVector(points_sampled, dim*num_sampled, points_sampled_C);
+  CopyPylistToVector(points_sampled_value, num_sampled, points_sampled_value_C);
+  CopyPylistToVector(noise_variance, num_sampled, noise_variance_C);
+
+  return GetOrFit(model_cache, hyperparameters, points_sampled_C.data(), points_sampled_value_C.data(),
+                  noise_variance_C.data(), dim, num_sampled);
+}
+
+GaussianProcess * GetOrFitBufferWrapper(GaussianProcessCache * model_cache,
+                                        const boost::python::list& hyperparameters,
+                                        const boost::python::object& points_sampled,
+                                        const boost::python::object& points_sampled_value,
+                                        const boost::python::object& noise_variance,
+                                        int dim, int num_sampled) {
+  const bool writable = false;
+  PythonBufferView points_sampled_view(points_sampled, dim*num_sampled, writable);
+  PythonBufferView points_sampled_value_view(points_sampled_value, num_sampled, writable);
+  PythonBufferView noise_variance_view(noise_variance, num_sampled, writable);
+
+  return GetOrFit(model_cache, hyperparameters, points_sampled_view.data(), points_sampled_value_view.data(),
+                  noise_variance_view.data(), dim, num_sampled);
+}
+
+void WriteSnapshotWrapper(const GaussianProcess& gaussian_process, const std::string& filename) {
+  // other Python threads may modify gaussian_process while the GIL is released
+  std::unique_ptr<GaussianProcess> gaussian_process_copy(gaussian_process.Clone());
+  ScopedGILRelease gil_release;
+  WriteGaussianProcessSnapshot(*gaussian_process_copy, filename);
+}
+
+/*!\rst
+  Loads a GaussianProcess snapshot for boost::python (which takes ownership); seeds the RNG like make_gaussian_process().
+\endrst*/
+GaussianProcess * LoadSnapshotWrapper(const std::string& filename) {
+  std::unique_ptr<GaussianProcess> gaussian_process;
+  {
+    ScopedGILRelease gil_release;
+    gaussian_process = LoadGaussianProcessSnapshot(filename);
+  }
+  gaussian_process->SetRandomizedSeed(0);
+  return gaussian_process.release();
+}
+
 void PrintHistoricalData(const GaussianProcess& gaussian_process) {
   PrintMatrixTrans(gaussian_process.points_sampled().data(), gaussian_process.num_sampled(), gaussian_process.dim());
   PrintMatrix(gaussian_process.points_sampled_value().data(), 1, gaussian_process.num_sampled());
@@ -214,7 +560,17 @@ void PrintHistoricalData(const GaussianProcess& gaussian_process) {
 }  // end unnamed namespace
 
 void ExportGaussianProcessFunctions() {
+  // boost::python tries overloads in reverse order of registration.  The buffer overloads take boost::python::object,
+  // which matches anything (including lists), so any buffer overload with the same arity as a list overload must be
+  // registered FIRST; then lists go to the list overload and everything else (e.g., numpy arrays) falls through.
   boost::python::class_<GaussianProcess, boost::noncopyable>("GaussianProcess", boost::python::no_init)
+      .def("__init__", boost::python::make_constructor(&make_gaussian_process_from_buffers), R"%%(
+    Constructor for a ``GPP.GaussianProcess`` object; historical data are read in place from buffers.
+
+    Same as the list overload (below) except ``points_sampled``, ``points_sampled_value``, and ``noise_variance`` are
+    objects supporting the buffer protocol (e.g., C-contiguous numpy arrays of float64) instead of lists.
+    ``hyperparameters`` is still a list.
+          )%%")
       .def("__init__", boost::python::make_constructor(&make_gaussian_process), R"%%(
     Constructor for a ``GPP.GaussianProcess`` object.
 
@@ -246,6 +602,16 @@ void ExportGaussianProcessFunctions() {
         :return: GP mean evaluated at each of ``points_to_sample``
         :rtype: list of float64 with shape (num_to_sample, )
         )%%")
+      .def("compute_mean_of_points", GetMeanBufferWrapper, R"%%(
+        Compute the (predicted) mean of the Gaussian Process posterior into a preallocated buffer (zero-copy).
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: buffer (e.g., C-contiguous numpy array) of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param to_sample_mean: (output) GP mean evaluated at each of ``points_to_sample``
+        :type to_sample_mean: writable buffer of float64 with shape (num_to_sample, )
+        )%%")
       .def("compute_grad_mean_of_points", GetGradMeanWrapper, R"%%(
         Compute the gradient of the (predicted) mean, ``mus``, of the Gaussian Process posterior.
         Gradient is computed wrt each point in points_to_sample.
@@ -263,6 +629,16 @@ void ExportGaussianProcessFunctions() {
             the i-th entry of ``points_to_sample``.
         :rtype: list of float64 with shape (num_to_sample, dim)
         )%%")
+      .def("compute_grad_mean_of_points", GetGradMeanBufferWrapper, R"%%(
+        Compute the gradient of the (predicted) mean of the Gaussian Process posterior into a preallocated buffer (zero-copy).
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: buffer (e.g., C-contiguous numpy array) of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param to_sample_grad_mean: (output) gradient of the mean of the GP; same layout as the list overload's return
+        :type to_sample_grad_mean: writable buffer of float64 with shape (num_to_sample, dim)
+        )%%")
       .def("compute_variance_of_points", GetVarWrapper, R"%%(
         Compute the (predicted) variance, ``Vars``, of the Gaussian Process posterior.
         ``L * L^T = K``
@@ -281,6 +657,48 @@ void ExportGaussianProcessFunctions() {
             ordered as num_to_sample rows of length num_to_sample
         :rtype: list of float64 with shape (num_to_sample, num_to_sample)
         )%%")
+      .def("compute_variance_of_points", GetVarBufferWrapper, R"%%(
+        Compute the (predicted) variance of the Gaussian Process posterior into a preallocated buffer (zero-copy).
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: buffer (e.g., C-contiguous numpy array) of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param to_sample_var: (output) GP variance evaluated at ``points_to_sample`` (symmetric)
+        :type to_sample_var: writable buffer of float64 with shape (num_to_sample, num_to_sample)
+        )%%")
+      .def("compute_mean_and_marginal_variance_of_points", GetMeanAndMarginalVarWrapper, R"%%(
+        Compute the (predicted) mean and marginal variance (the diagonal of ``Vars``; see ``compute_variance_of_points``)
+        of the Gaussian Process posterior at each point.
+
+        Use this instead of ``compute_variance_of_points`` when only per-point variances are needed, e.g., to score
+        a large candidate set: memory is ``O(num_sampled * chunk)`` instead of ``O(num_to_sample^2)``.  Points are
+        processed in fixed-size chunks (split across threads), so results do not depend on ``max_num_threads``.
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: list of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param max_num_threads: maximum number of threads to use
+        :type max_num_threads: int > 0
+        :return: ``[mean, marginal_variance]``: GP mean and variance of each point in ``points_to_sample``
+        :rtype: list of two lists of float64, each with shape (num_to_sample, )
+        )%%")
+      .def("compute_mean_and_marginal_variance_of_points", GetMeanAndMarginalVarBufferWrapper, R"%%(
+        Compute the (predicted) mean and marginal variance of the Gaussian Process posterior into preallocated
+        buffers (zero-copy).  See the list overload for details.
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: buffer (e.g., C-contiguous numpy array) of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param max_num_threads: maximum number of threads to use
+        :type max_num_threads: int > 0
+        :param to_sample_mean: (output) GP mean of each point in ``points_to_sample``
+        :type to_sample_mean: writable buffer of float64 with shape (num_to_sample, )
+        :param to_sample_marginal_var: (output) GP variance of each point in ``points_to_sample``
+        :type to_sample_marginal_var: writable buffer of float64 with shape (num_to_sample, )
+        )%%")
       .def("compute_cholesky_variance_of_points", GetCholVarWrapper, R"%%(
         Computes the Cholesky Decomposition of the predicted GP variance:
         ``L * L^T = Vars``, where Vars is the output of get_var().
@@ -294,10 +712,24 @@ void ExportGaussianProcessFunctions() {
             ordered as num_to_sample rows of length num_to_sample
         :rtype: list of float64 with shape (num_to_sample, num_to_sample)
         )%%")
+      .def("compute_cholesky_variance_of_points", GetCholVarBufferWrapper, R"%%(
+        Compute the Cholesky Decomposition of the predicted GP variance into a preallocated buffer (zero-copy).
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: buffer (e.g., C-contiguous numpy array) of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param chol_var: (output) cholesky factor (L) of the GP variance evaluated at ``points_to_sample``
+        :type chol_var: writable buffer of float64 with shape (num_to_sample, num_to_sample)
+        )%%")
       .def("compute_grad_variance_of_points", GetGradVarWrapper, R"%%(
         Similar to get_grad_chol_var() except this does not include the gradient terms from
         the cholesky factorization.  Description will not be duplicated here.
         )%%")
+      .def("compute_grad_variance_of_points", GetGradVarBufferWrapper, R"%%(
+        Same as the list overload except ``points_to_sample`` is a buffer (e.g., C-contiguous numpy array of float64)
+        and the result is written into the writable buffer ``to_sample_grad_var`` (with the list overload's shape).
+        )%%")
       .def("compute_grad_cholesky_variance_of_points", GetGradCholVarWrapper, R"%%(
         Compute gradient of the Cholesky Factorization of the (predicted) variance, Vars, of the Gaussian Process posterior.
         Gradient is computed wrt points_to_sample[0:num_derivatives].
@@ -322,6 +754,24 @@ void ExportGaussianProcessFunctions() {
           respect to ``x_{d,k}``, the d-th dimension of the k-th entry of ``points_to_sample``
         :rtype: list of float64 with shape (num_derivatives, num_to_sample, num_to_sample, dim)
       )%%")
+      .def("compute_grad_cholesky_variance_of_points", GetGradCholVarBufferWrapper, R"%%(
+        Compute the gradient of the Cholesky Factorization of the (predicted) variance into a preallocated buffer
+        (zero-copy).
+
+        :param points_to_sample: points at which to compute GP-derived quantities (mean, variance, etc.; i.e., make predictions)
+        :type points_to_sample: buffer (e.g., C-contiguous numpy array) of float64 with shape (num_to_sample, dim)
+        :param num_to_sample: number of points to sample
+        :type num_to_sample: int > 0
+        :param num_derivatives: return derivatives wrt ``points_to_sample[0:num_derivatives]``
+        :type num_derivatives: 0 < int <= num_to_sample
+        :param to_sample_grad_chol: (output) gradient of the cholesky-factored variance of the GP; same layout as the
+          list overload's return
+        :type to_sample_grad_chol: writable buffer of float64 with shape (num_derivatives, num_to_sample, num_to_sample, dim)
+        )%%")
+      .def("add_sampled_points", AddPointsToGPBufferWrapper, R"%%(
+        Same as the list overload (below) except the new historical data are read in place from buffers
+        (e.g., C-contiguous numpy arrays of float64) with the same shapes.
+      )%%")
       .def("add_sampled_points", AddPointsToGPWrapper, R"%%(
         Add the specified (point, fcn value, noise variance) historical data to this GP.
 
@@ -336,6 +786,10 @@ void ExportGaussianProcessFunctions() {
         :param num_new_points: number of new points to add to the GP
         :type num_new_points: int
       )%%")
+      .def("sample_point_from_gp", SamplePointFromGPBufferWrapper, R"%%(
+        Same as the list overload (below) except ``point_to_sample`` is read in place from a buffer (e.g., a
+        C-contiguous numpy array of float64) with the same shape.
+      )%%")
       .def("sample_point_from_gp", SamplePointFromGPWrapper, R"%%(
         Sample a function value from a Gaussian Process prior, provided a point at which to sample.
 
@@ -358,6 +812,90 @@ void ExportGaussianProcessFunctions() {
       )%%")
       .def("reset_to_most_recent_seed", &GaussianProcess::ResetToMostRecentSeed, "Seed the internal RNG with the last used seed.")
       .def("print_historical_data", PrintHistoricalData)
+      .def("write_snapshot", WriteSnapshotWrapper, R"%%(
+        Save this GP (historical data, covariance, and its cholesky factorization) to a binary snapshot file.
+        Load it with ``GPP.load_gaussian_process_snapshot``; see gpp_model_snapshot.hpp for the format.
+
+        Only the square exponential and Matern covariances are supported.  Replaces ``filename`` atomically.
+
+        :param filename: path of the snapshot file
+        :type filename: str
+      )%%")
+      ;  // NOLINT, this is boost style
+
+  boost::python::def("load_gaussian_process_snapshot", LoadSnapshotWrapper,
+                     boost::python::return_value_policy<boost::python::manage_new_object>(), R"%%(
+    Load a ``GPP.GaussianProcess`` from a snapshot file written by ``GaussianProcess.write_snapshot``, without refitting.
+
+    The file is memory-mapped read-only and the (``num_sampled^2``) cholesky factor is read in place, so loading is fast
+    and processes loading the same file share its pages.  The GP is otherwise a normal GP; modifying it (e.g.,
+    ``add_sampled_points``) copies the factor first.  Seeds internal NormalRNG randomly.
+
+    :param filename: path of the snapshot file
+    :type filename: str
+    :return: the loaded GP
+    :rtype: GPP.GaussianProcess
+    )%%");
+
+  boost::python::class_<GaussianProcessCache, boost::noncopyable>("GaussianProcessCache", R"%%(
+    Memory-bounded LRU cache of fitted ``GPP.GaussianProcess`` objects (square exponential covariance), keyed by the
+    content of their inputs.  Use one per server process so that requests with the same historical data stop refitting
+    the GP; see gpp_model_cache.hpp for details.  Thread-safe; fitting releases the GIL.
+    )%%", boost::python::init<std::size_t>(R"%%(
+    Constructor for a ``GPP.GaussianProcessCache`` object.
+
+    :param memory_budget: maximum number of bytes of (estimated) model memory to keep cached
+    :type memory_budget: int >= 0
+    )%%"))
+      .def("get_or_fit", GetOrFitBufferWrapper,
+           boost::python::return_value_policy<boost::python::manage_new_object>(), R"%%(
+        Same as the list overload (below) except ``points_sampled``, ``points_sampled_value``, and ``noise_variance``
+        are read in place from buffers (e.g., C-contiguous numpy arrays of float64) with the same shapes.
+      )%%")
+      .def("get_or_fit", GetOrFitWrapper,
+           boost::python::return_value_policy<boost::python::manage_new_object>(), R"%%(
+        Return a ``GPP.GaussianProcess`` fit to the specified inputs (same as the ``GPP.GaussianProcess`` constructor).
+
+        Returns the cached model if one was fit to exactly these inputs; else extends a cached model if one was fit to a
+        prefix of these inputs (only new points were appended); else fits a new model.
+
+        The returned GP belongs to the caller and reads the cached model's cholesky factor in place; modifying it
+        (e.g., ``add_sampled_points``) copies the factor first and never changes the cache.  To reuse the cache after
+        adding points, call ``get_or_fit`` with the extended history instead.  Seeds internal NormalRNG randomly.
+
+        :param hyperparameters: covariance hyperparameters; see "Details on ..." section at the top of ``BOOST_PYTHON_MODULE``
+        :type hyperparameters: list of len 2; index 0 is a float64 ``\alpha`` (signal variance) and index 1 is the length scales (list of floa64 of length ``dim``)
+        :param points_sampled: points that have already been sampled
+        :type points_sampled: list of float64 with shape (num_sampled, dim)
+        :param points_sampled_value: values of the already-sampled points
+        :type points_sampled_value: list of float64 with shape (num_sampled, )
+        :param noise_variance: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+        :type noise_variance: list of float64 with shape (num_sampled, )
+        :param dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+        :type param: int > 0
+        :param num_sampled: number of already-sampled points
+        :type num_sampled: int > 0
+        :return: GP fit to the inputs
+        :rtype: GPP.GaussianProcess
+      )%%")
+      .def("clear", &GaussianProcessCache::Clear, "Drop every cached model (models held by callers stay valid).")
+      .def("set_memory_budget", &GaussianProcessCache::SetMemoryBudget, R"%%(
+        Change the memory budget, evicting least recently used models until the cached models fit in it.
+
+        :param memory_budget: maximum number of bytes of (estimated) model memory to keep cached; 0 disables caching
+        :type memory_budget: int >= 0
+      )%%")
+      .add_property("memory_budget", &GaussianProcessCache::memory_budget, "Return the memory budget in bytes.")
+      .add_property("memory_used", &GaussianProcessCache::memory_used, "Return the (estimated) bytes of cached models.")
+      .add_property("size", &GaussianProcessCache::size, "Return the number of cached models.")
+      .add_property("num_hits", &GaussianProcessCache::num_hits, "Return the number of requests answered by a cached model.")
+      .add_property("num_extensions", &GaussianProcessCache::num_extensions, R"%%(
+        Return the number of requests answered by extending a cached model with appended points.
+      )%%")
+      .add_property("num_fits", &GaussianProcessCache::num_fits, "Return the number of requests that fit a new model.")
+      .add_property("num_over_budget", &GaussianProcessCache::num_over_budget, R"%%(
+        Return the number of requests whose model alone exceeded the memory budget (so it was not cached).
+      )%%")
       ;  // NOLINT, this is boost style
 }
 
@@ -16,7 +16,11 @@ namespace optimal_learning {
   Exports constructor and member functions (with docstrings) from GaussianProcess:
 
   1. Constructor accepting Python structures
-  2. Evaluation of mean, variance, cholesky of variance (and their gradients)
+  2. Evaluation of mean, variance, cholesky of variance (and their gradients); mean and marginal variance of large
+     point sets, chunked and multithreaded
+
+  Also exports GaussianProcessCache (see gpp_model_cache.hpp), which hands out shared, fitted GaussianProcess objects,
+  and saving/loading of GaussianProcess snapshots (see gpp_model_snapshot.hpp).
 \endrst*/
 void ExportGaussianProcessFunctions();
 
@@ -40,38 +40,39 @@ namespace optimal_learning {
 
 namespace {
 
-double ComputeLogLikelihoodWrapper(const boost::python::list& points_sampled,
-                                   const boost::python::list& points_sampled_value,
-                                   int dim, int num_sampled,
-                                   LogLikelihoodTypes objective_type,
-                                   const boost::python::list& hyperparameters,
-                                   const boost::python::list& noise_variance) {
-  const int num_to_sample = 0;
-  const boost::python::list points_to_sample_dummy;
-  PythonInterfaceInputContainer input_container(hyperparameters, points_sampled, points_sampled_value,
-                                                noise_variance, points_to_sample_dummy, dim, num_sampled,
-                                                num_to_sample);
+/*!\rst
+  Computes the specified log likelihood measure; shared by the list and buffer wrappers.  See the
+  ``compute_log_likelihood`` docstring in ExportModelSelectionFunctions() for details.
 
-  SquareExponential square_exponential(input_container.dim, input_container.alpha,
-                                       input_container.lengths.data());
+  \param
+    :points_sampled[dim][num_sampled]: points that have already been sampled
+    :points_sampled_value[num_sampled]: values of the already-sampled points
+    :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+    :square_exponential: covariance (and hyperparameters) at which to evaluate the log likelihood
+    (other inputs as in ``compute_log_likelihood``)
+  \return
+    the log likelihood measure selected by ``objective_type``
+\endrst*/
+double ComputeLogLikelihood(double const * restrict points_sampled,
+                            double const * restrict points_sampled_value,
+                            double const * restrict noise_variance,
+                            int dim, int num_sampled,
+                            LogLikelihoodTypes objective_type,
+                            LeaveOneOutComputeTypes leave_one_out_compute_type,
+                            LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                            const SquareExponential& square_exponential) {
   switch (objective_type) {
     case LogLikelihoodTypes::kLogMarginalLikelihood: {
-      LogMarginalLikelihoodEvaluator log_marginal_eval(input_container.points_sampled.data(),
-                                                       input_container.points_sampled_value.data(),
-                                                       input_container.noise_variance.data(),
-                                                       input_container.dim,
-                                                       input_container.num_sampled);
+      LogMarginalLikelihoodEvaluator log_marginal_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                       num_sampled, log_marginal_gradient_type);
       LogMarginalLikelihoodState log_marginal_state(log_marginal_eval, square_exponential);
 
       double log_likelihood = log_marginal_eval.ComputeLogLikelihood(log_marginal_state);
       return log_likelihood;
     }  // end case LogLikelihoodTypes::kLogMarginalLikelihood
     case LogLikelihoodTypes::kLeaveOneOutLogLikelihood: {
-      LeaveOneOutLogLikelihoodEvaluator leave_one_out_eval(input_container.points_sampled.data(),
-                                                           input_container.points_sampled_value.data(),
-                                                           input_container.noise_variance.data(),
-                                                           input_container.dim,
-                                                           input_container.num_sampled);
+      LeaveOneOutLogLikelihoodEvaluator leave_one_out_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                           num_sampled, leave_one_out_compute_type);
       LeaveOneOutLogLikelihoodState leave_one_out_state(leave_one_out_eval, square_exponential);
 
       double loo_likelihood = leave_one_out_eval.ComputeLogLikelihood(leave_one_out_state);
@@ -85,54 +86,148 @@ double ComputeLogLikelihoodWrapper(const boost::python::list& points_sampled,
   }  // end switch over objective_type
 }
 
-boost::python::list ComputeHyperparameterGradLogLikelihoodWrapper(const boost::python::list& points_sampled,
-                                                                  const boost::python::list& points_sampled_value,
-                                                                  int dim, int num_sampled,
-                                                                  LogLikelihoodTypes objective_type,
-                                                                  const boost::python::list& hyperparameters,
-                                                                  const boost::python::list& noise_variance) {
-  const int num_to_sample = 0;
-  const boost::python::list points_to_sample_dummy;
-  PythonInterfaceInputContainer input_container(hyperparameters, points_sampled, points_sampled_value,
-                                                noise_variance, points_to_sample_dummy, dim, num_sampled,
-                                                num_to_sample);
+/*!\rst
+  Computes the gradient of the specified log likelihood measure wrt hyperparameters; shared by the list and buffer
+  wrappers.  See the ``compute_hyperparameter_grad_log_likelihood`` docstring in ExportModelSelectionFunctions().
 
-  SquareExponential square_exponential(input_container.dim, input_container.alpha,
-                                       input_container.lengths.data());
-  std::vector<double> grad_log_likelihood(square_exponential.GetNumberOfHyperparameters());
+  \param
+    (inputs as in ComputeLogLikelihood())
+  \output
+    :grad_log_likelihood[n_hyper]: gradient of the log likelihood measure wrt each hyperparameter
+\endrst*/
+void ComputeHyperparameterGradLogLikelihood(double const * restrict points_sampled,
+                                            double const * restrict points_sampled_value,
+                                            double const * restrict noise_variance,
+                                            int dim, int num_sampled,
+                                            LogLikelihoodTypes objective_type,
+                                            LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                            LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                            const SquareExponential& square_exponential,
+                                            double * restrict grad_log_likelihood) {
   switch (objective_type) {
     case LogLikelihoodTypes::kLogMarginalLikelihood: {
-      LogMarginalLikelihoodEvaluator log_marginal_eval(input_container.points_sampled.data(),
-                                                       input_container.points_sampled_value.data(),
-                                                       input_container.noise_variance.data(),
-                                                       input_container.dim,
-                                                       input_container.num_sampled);
+      LogMarginalLikelihoodEvaluator log_marginal_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                       num_sampled, log_marginal_gradient_type);
       LogMarginalLikelihoodState log_marginal_state(log_marginal_eval, square_exponential);
 
-      log_marginal_eval.ComputeGradLogLikelihood(&log_marginal_state, grad_log_likelihood.data());
+      log_marginal_eval.ComputeGradLogLikelihood(&log_marginal_state, grad_log_likelihood);
       break;
     }  // end case LogLikelihoodTypes::kLogMarginalLikelihood
     case LogLikelihoodTypes::kLeaveOneOutLogLikelihood: {
-      LeaveOneOutLogLikelihoodEvaluator leave_one_out_eval(input_container.points_sampled.data(),
-                                                           input_container.points_sampled_value.data(),
-                                                           input_container.noise_variance.data(),
-                                                           input_container.dim,
-                                                           input_container.num_sampled);
+      LeaveOneOutLogLikelihoodEvaluator leave_one_out_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                           num_sampled, leave_one_out_compute_type);
       LeaveOneOutLogLikelihoodState leave_one_out_state(leave_one_out_eval, square_exponential);
 
-      leave_one_out_eval.ComputeGradLogLikelihood(&leave_one_out_state, grad_log_likelihood.data());
+      leave_one_out_eval.ComputeGradLogLikelihood(&leave_one_out_state, grad_log_likelihood);
       break;
     }
     default: {
-      std::fill(grad_log_likelihood.begin(), grad_log_likelihood.end(), std::numeric_limits<double>::max());
+      std::fill(grad_log_likelihood, grad_log_likelihood + square_exponential.GetNumberOfHyperparameters(),
+                std::numeric_limits<double>::max());
       OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid objective mode choice. Setting all gradients to DBL_MAX.");
       break;
     }
   }  // end switch over objective_type
+}
+
+double ComputeLogLikelihoodWrapper(const boost::python::list& points_sampled,
+                                   const boost::python::list& points_sampled_value,
+                                   int dim, int num_sampled,
+                                   LogLikelihoodTypes objective_type,
+                                   LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                   LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                   const boost::python::list& hyperparameters,
+                                   const boost::python::list& noise_variance) {
+  const int num_to_sample = 0;
+  const boost::python::list points_to_sample_dummy;
+  PythonInterfaceInputContainer input_container(hyperparameters, points_sampled, points_sampled_value,
+                                                noise_variance, points_to_sample_dummy, dim, num_sampled,
+                                                num_to_sample);
+
+  SquareExponential square_exponential(input_container.dim, input_container.alpha,
+                                       input_container.lengths.data());
+  return ComputeLogLikelihood(input_container.points_sampled.data(), input_container.points_sampled_value.data(),
+                              input_container.noise_variance.data(), input_container.dim,
+                              input_container.num_sampled, objective_type, leave_one_out_compute_type,
+                              log_marginal_gradient_type, square_exponential);
+}
+
+double ComputeLogLikelihoodBufferWrapper(const boost::python::object& points_sampled,
+                                         const boost::python::object& points_sampled_value,
+                                         int dim, int num_sampled,
+                                         LogLikelihoodTypes objective_type,
+                                         LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                         LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                         const boost::python::list& hyperparameters,
+                                         const boost::python::object& noise_variance) {
+  const bool writable = false;
+  PythonBufferView points_sampled_view(points_sampled, dim*num_sampled, writable);
+  PythonBufferView points_sampled_value_view(points_sampled_value, num_sampled, writable);
+  PythonBufferView noise_variance_view(noise_variance, num_sampled, writable);
+
+  const double alpha = boost::python::extract<double>(hyperparameters[0]);
+  std::vector<double> lengths(dim);
+  CopyPylistToVector(boost::python::extract<boost::python::list>(hyperparameters[1]), dim, lengths);
+  SquareExponential square_exponential(dim, alpha, lengths.data());
+
+  return ComputeLogLikelihood(points_sampled_view.data(), points_sampled_value_view.data(),
+                              noise_variance_view.data(), dim, num_sampled, objective_type,
+                              leave_one_out_compute_type, log_marginal_gradient_type, square_exponential);
+}
+
+boost::python::list ComputeHyperparameterGradLogLikelihoodWrapper(const boost::python::list& points_sampled,
+                                                                  const boost::python::list& points_sampled_value,
+                                                                  int dim, int num_sampled,
+                                                                  LogLikelihoodTypes objective_type,
+                                                                  LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                                                  LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                                                  const boost::python::list& hyperparameters,
+                                                                  const boost::python::list& noise_variance) {
+  const int num_to_sample = 0;
+  const boost::python::list points_to_sample_dummy;
+  PythonInterfaceInputContainer input_container(hyperparameters, points_sampled, points_sampled_value,
+                                                noise_variance, points_to_sample_dummy, dim, num_sampled,
+                                                num_to_sample);
+
+  SquareExponential square_exponential(input_container.dim, input_container.alpha,
+                                       input_container.lengths.data());
+  std::vector<double> grad_log_likelihood(square_exponential.GetNumberOfHyperparameters());
+  ComputeHyperparameterGradLogLikelihood(input_container.points_sampled.data(),
+                                         input_container.points_sampled_value.data(),
+                                         input_container.noise_variance.data(), input_container.dim,
+                                         input_container.num_sampled, objective_type, leave_one_out_compute_type,
+                                         log_marginal_gradient_type, square_exponential,
+                                         grad_log_likelihood.data());
 
   return VectorToPylist(grad_log_likelihood);
 }
 
+void ComputeHyperparameterGradLogLikelihoodBufferWrapper(const boost::python::object& points_sampled,
+                                                         const boost::python::object& points_sampled_value,
+                                                         int dim, int num_sampled,
+                                                         LogLikelihoodTypes objective_type,
+                                                         LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                                         LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                                         const boost::python::list& hyperparameters,
+                                                         const boost::python::object& noise_variance,
+                                                         const boost::python::object& grad_log_likelihood) {
+  const double alpha = boost::python::extract<double>(hyperparameters[0]);
+  std::vector<double> lengths(dim);
+  CopyPylistToVector(boost::python::extract<boost::python::list>(hyperparameters[1]), dim, lengths);
+  SquareExponential square_exponential(dim, alpha, lengths.data());
+
+  PythonBufferView points_sampled_view(points_sampled, dim*num_sampled, false);
+  PythonBufferView points_sampled_value_view(points_sampled_value, num_sampled, false);
+  PythonBufferView noise_variance_view(noise_variance, num_sampled, false);
+  PythonBufferView grad_log_likelihood_view(grad_log_likelihood, square_exponential.GetNumberOfHyperparameters(),
+                                            true);
+
+  ComputeHyperparameterGradLogLikelihood(points_sampled_view.data(), points_sampled_value_view.data(),
+                                         noise_variance_view.data(), dim, num_sampled, objective_type,
+                                         leave_one_out_compute_type, log_marginal_gradient_type, square_exponential,
+                                         grad_log_likelihood_view.data());
+}
+
 /*!\rst
   Utility that dispatches log likelihood optimization (wrt hyperparameters) based on optimizer type.
   This is just used to reduce copy-pasted code.
@@ -167,15 +262,20 @@ void DispatchHyperparameterOptimization(const boost::python::object& optimizer_p
                                         RandomnessSourceContainer& randomness_source,
                                         boost::python::dict& status,
                                         double * restrict new_hyperparameters) {
+  // other Python threads may use randomness_source while the GIL is released
+  ScopedRandomnessSourceCopy randomness_source_copy(&randomness_source);
   bool found_flag = false;
   switch (optimizer_type) {
     case OptimizerTypes::kNull: {
       // optimizer_parameters must contain an int num_random_samples field, extract it
       int num_random_samples = boost::python::extract<int>(optimizer_parameters.attr("num_random_samples"));
       ThreadSchedule thread_schedule(max_num_threads, omp_sched_guided);
-      LatinHypercubeSearchHyperparameterOptimization(log_likelihood_eval, covariance, hyperparameter_domain,
-                                                     thread_schedule, num_random_samples, &found_flag,
-                                                     &randomness_source.uniform_generator, new_hyperparameters);
+      {
+        ScopedGILRelease gil_release;
+        LatinHypercubeSearchHyperparameterOptimization(log_likelihood_eval, covariance, hyperparameter_domain,
+                                                       thread_schedule, num_random_samples, &found_flag,
+                                                       &randomness_source_copy.uniform_generator, new_hyperparameters);
+      }
       status[std::string(log_likelihood_eval.kName) + "_lhc_found_update"] = found_flag;
       break;
     }  // end case kNull for optimizer_type
@@ -184,12 +284,15 @@ void DispatchHyperparameterOptimization(const boost::python::object& optimizer_p
       // of type GradientDescentParameters. extract it
       const GradientDescentParameters& gradient_descent_parameters = boost::python::extract<GradientDescentParameters&>(optimizer_parameters.attr("optimizer_parameters"));
       ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
-      MultistartGradientDescentHyperparameterOptimization(log_likelihood_eval, covariance,
-                                                          gradient_descent_parameters,
-                                                          hyperparameter_domain,
-                                                          thread_schedule, &found_flag,
-                                                          &randomness_source.uniform_generator,
-                                                          new_hyperparameters);
+      {
+        ScopedGILRelease gil_release;
+        MultistartGradientDescentHyperparameterOptimization(log_likelihood_eval, covariance,
+                                                            gradient_descent_parameters,
+                                                            hyperparameter_domain,
+                                                            thread_schedule, &found_flag,
+                                                            &randomness_source_copy.uniform_generator,
+                                                            new_hyperparameters);
+      }
       status[std::string(log_likelihood_eval.kName) + "_gradient_descent_found_update"] = found_flag;
       break;
     }  // end case kGradientDescent for optimizer_type
@@ -198,14 +301,34 @@ void DispatchHyperparameterOptimization(const boost::python::object& optimizer_p
       // of type NewtonParameters. extract it
       const NewtonParameters& newton_parameters = boost::python::extract<NewtonParameters&>(optimizer_parameters.attr("optimizer_parameters"));
       ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
-      MultistartNewtonHyperparameterOptimization(log_likelihood_eval, covariance,
-                                                 newton_parameters, hyperparameter_domain,
-                                                 thread_schedule, &found_flag,
-                                                 &randomness_source.uniform_generator,
-                                                 new_hyperparameters);
+      {
+        ScopedGILRelease gil_release;
+        MultistartNewtonHyperparameterOptimization(log_likelihood_eval, covariance,
+                                                   newton_parameters, hyperparameter_domain,
+                                                   thread_schedule, &found_flag,
+                                                   &randomness_source_copy.uniform_generator,
+                                                   new_hyperparameters);
+      }
       status[std::string(log_likelihood_eval.kName) + "_newton_found_update"] = found_flag;
       break;
     }  // end case kNewton for optimizer_type
+    case OptimizerTypes::kLBFGS: {
+      // optimizer_parameters must contain a optimizer_parameters field
+      // of type LBFGSParameters. extract it
+      const LBFGSParameters& lbfgs_parameters = boost::python::extract<LBFGSParameters&>(optimizer_parameters.attr("optimizer_parameters"));
+      AdaptiveMultistartParameters const * adaptive_parameters = GetAdaptiveMultistartParameters(optimizer_parameters);
+      ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
+      {
+        ScopedGILRelease gil_release;
+        MultistartLBFGSHyperparameterOptimization(log_likelihood_eval, covariance,
+                                                  lbfgs_parameters, adaptive_parameters, hyperparameter_domain,
+                                                  thread_schedule, &found_flag,
+                                                  &randomness_source_copy.uniform_generator,
+                                                  new_hyperparameters);
+      }
+      status[std::string(log_likelihood_eval.kName) + "_lbfgs_found_update"] = found_flag;
+      break;
+    }  // end case kLBFGS for optimizer_type
     default: {
       std::fill(new_hyperparameters, new_hyperparameters + covariance.GetNumberOfHyperparameters(), 1.0);
       OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid optimizer choice. Setting all hyperparameters to 1.0.");
@@ -214,11 +337,72 @@ void DispatchHyperparameterOptimization(const boost::python::object& optimizer_p
   }  // end switch over optimzer_type for LogLikelihoodTypes::kLogMarginalLikelihood
 }
 
+/*!\rst
+  Optimizes the log likelihood measure selected by ``optimizer_parameters.objective_type`` wrt hyperparameters; shared
+  by the list and buffer wrappers.  See the ``multistart_hyperparameter_optimization`` docstring in
+  ExportModelSelectionFunctions() for details.
+
+  \param
+    :hyperparameter_domain[n_hyper]: [lower, upper] bounds for each hyperparameter, in LOG-10 SPACE
+    :points_sampled[dim][num_sampled]: points that have already been sampled
+    :points_sampled_value[num_sampled]: values of the already-sampled points
+    :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+    :square_exponential: covariance (and initial hyperparameters)
+    (other inputs as in ``multistart_hyperparameter_optimization``)
+  \output
+    :randomness_source: PRNG internal states modified
+    :status: modified on exit to describe whether convergence occurred
+    :new_hyperparameters[n_hyper]: optimized hyperparameters
+\endrst*/
+void MultistartHyperparameterOptimization(const boost::python::object& optimizer_parameters,
+                                          ClosedInterval const * restrict hyperparameter_domain,
+                                          double const * restrict points_sampled,
+                                          double const * restrict points_sampled_value,
+                                          double const * restrict noise_variance,
+                                          int dim, int num_sampled,
+                                          LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                          LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                          const SquareExponential& square_exponential,
+                                          int max_num_threads,
+                                          RandomnessSourceContainer& randomness_source,
+                                          boost::python::dict& status,
+                                          double * restrict new_hyperparameters) {
+  OptimizerTypes optimizer_type = boost::python::extract<OptimizerTypes>(optimizer_parameters.attr("optimizer_type"));
+  LogLikelihoodTypes objective_type = boost::python::extract<LogLikelihoodTypes>(optimizer_parameters.attr("objective_type"));
+  switch (objective_type) {
+    case LogLikelihoodTypes::kLogMarginalLikelihood: {
+      LogMarginalLikelihoodEvaluator log_likelihood_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                         num_sampled, log_marginal_gradient_type);
+
+      DispatchHyperparameterOptimization(optimizer_parameters, log_likelihood_eval, square_exponential,
+                                         hyperparameter_domain, optimizer_type, max_num_threads,
+                                         randomness_source, status, new_hyperparameters);
+      break;
+    }  // end case LogLikelihoodTypes::kLogMarginalLikelihood
+    case LogLikelihoodTypes::kLeaveOneOutLogLikelihood: {
+      LeaveOneOutLogLikelihoodEvaluator log_likelihood_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                            num_sampled, leave_one_out_compute_type);
+
+      DispatchHyperparameterOptimization(optimizer_parameters, log_likelihood_eval, square_exponential,
+                                         hyperparameter_domain, optimizer_type, max_num_threads,
+                                         randomness_source, status, new_hyperparameters);
+      break;
+    }  // end case LogLikelihoodTypes::kLeaveOneOutLogLikelihood
+    default: {
+      std::fill(new_hyperparameters, new_hyperparameters + square_exponential.GetNumberOfHyperparameters(), 1.0);
+      OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid objective type choice. Setting all hyperparameters to 1.0.");
+      break;
+    }
+  }  // end switch over objective_type
+}
+
 boost::python::list MultistartHyperparameterOptimizationWrapper(const boost::python::object& optimizer_parameters,
                                                                 const boost::python::list& hyperparameter_domain,
                                                                 const boost::python::list& points_sampled,
                                                                 const boost::python::list& points_sampled_value,
                                                                 int dim, int num_sampled,
+                                                                LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                                                LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
                                                                 const boost::python::list& hyperparameters,
                                                                 const boost::python::list& noise_variance,
                                                                 int max_num_threads,
@@ -240,39 +424,115 @@ boost::python::list MultistartHyperparameterOptimizationWrapper(const boost::pyt
   std::vector<ClosedInterval> hyperparameter_domain_C(num_hyperparameters);
   CopyPylistToClosedIntervalVector(hyperparameter_domain, num_hyperparameters, hyperparameter_domain_C);
 
-  OptimizerTypes optimizer_type = boost::python::extract<OptimizerTypes>(optimizer_parameters.attr("optimizer_type"));
-  LogLikelihoodTypes objective_type = boost::python::extract<LogLikelihoodTypes>(optimizer_parameters.attr("objective_type"));
-  switch (objective_type) {
-    case LogLikelihoodTypes::kLogMarginalLikelihood: {
-      LogMarginalLikelihoodEvaluator log_likelihood_eval(input_container.points_sampled.data(),
-                                                         input_container.points_sampled_value.data(),
-                                                         input_container.noise_variance.data(),
-                                                         input_container.dim, input_container.num_sampled);
+  MultistartHyperparameterOptimization(optimizer_parameters, hyperparameter_domain_C.data(),
+                                       input_container.points_sampled.data(),
+                                       input_container.points_sampled_value.data(),
+                                       input_container.noise_variance.data(), input_container.dim,
+                                       input_container.num_sampled, leave_one_out_compute_type,
+                                       log_marginal_gradient_type, square_exponential, max_num_threads,
+                                       randomness_source, status, new_hyperparameters.data());
 
-      DispatchHyperparameterOptimization(optimizer_parameters, log_likelihood_eval, square_exponential,
-                                         hyperparameter_domain_C.data(), optimizer_type, max_num_threads,
-                                         randomness_source, status, new_hyperparameters.data());
+  return VectorToPylist(new_hyperparameters);
+}
+
+void MultistartHyperparameterOptimizationBufferWrapper(const boost::python::object& optimizer_parameters,
+                                                       const boost::python::object& hyperparameter_domain,
+                                                       const boost::python::object& points_sampled,
+                                                       const boost::python::object& points_sampled_value,
+                                                       int dim, int num_sampled,
+                                                       LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                                       LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                                       const boost::python::list& hyperparameters,
+                                                       const boost::python::object& noise_variance,
+                                                       int max_num_threads,
+                                                       RandomnessSourceContainer& randomness_source,
+                                                       boost::python::dict& status,
+                                                       const boost::python::object& new_hyperparameters) {
+  const double alpha = boost::python::extract<double>(hyperparameters[0]);
+  std::vector<double> lengths(dim);
+  CopyPylistToVector(boost::python::extract<boost::python::list>(hyperparameters[1]), dim, lengths);
+  SquareExponential square_exponential(dim, alpha, lengths.data());
+  int num_hyperparameters = square_exponential.GetNumberOfHyperparameters();
+
+  std::vector<ClosedInterval> hyperparameter_domain_C(num_hyperparameters);
+  CopyBufferToClosedIntervalVector(hyperparameter_domain, num_hyperparameters, hyperparameter_domain_C);
+
+  PythonBufferView points_sampled_view(points_sampled, dim*num_sampled, false);
+  PythonBufferView points_sampled_value_view(points_sampled_value, num_sampled, false);
+  PythonBufferView noise_variance_view(noise_variance, num_sampled, false);
+  PythonBufferView new_hyperparameters_view(new_hyperparameters, num_hyperparameters, true);
+
+  MultistartHyperparameterOptimization(optimizer_parameters, hyperparameter_domain_C.data(),
+                                       points_sampled_view.data(), points_sampled_value_view.data(),
+                                       noise_variance_view.data(), dim, num_sampled, leave_one_out_compute_type,
+                                       log_marginal_gradient_type, square_exponential, max_num_threads,
+                                       randomness_source, status, new_hyperparameters_view.data());
+}
+
+/*!\rst
+  Evaluates the specified log likelihood measure at each hyperparameter set; shared by the list and buffer wrappers.
+  See the ``evaluate_log_likelihood_at_hyperparameter_list`` docstring in ExportModelSelectionFunctions() for details.
+
+  \param
+    :hyperparameter_list[num_multistarts][n_hyper]: hyperparameters at which to evaluate the log likelihood
+    :points_sampled[dim][num_sampled]: points that have already been sampled
+    :points_sampled_value[num_sampled]: values of the already-sampled points
+    :noise_variance[num_sampled]: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
+    :square_exponential: covariance (hyperparameters are overwritten by each member of ``hyperparameter_list``)
+    (other inputs as in ``evaluate_log_likelihood_at_hyperparameter_list``)
+  \output
+    :status: modified on exit to describe whether convergence occurred
+    :function_values[num_multistarts]: log likelihood at each member of ``hyperparameter_list``, in the same order
+\endrst*/
+void EvaluateLogLikelihoodAtHyperparameterList(double const * restrict hyperparameter_list,
+                                               double const * restrict points_sampled,
+                                               double const * restrict points_sampled_value,
+                                               double const * restrict noise_variance,
+                                               int dim, int num_sampled,
+                                               LogLikelihoodTypes objective_mode,
+                                               LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                               LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                               const SquareExponential& square_exponential,
+                                               int num_multistarts, int max_num_threads,
+                                               boost::python::dict& status,
+                                               double * restrict function_values) {
+  std::vector<double> new_hyperparameters_C(square_exponential.GetNumberOfHyperparameters());  // not used
+  TensorProductDomain dummy_domain(nullptr, 0);
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_guided);
+
+  bool found_flag = false;
+  switch (objective_mode) {
+    case LogLikelihoodTypes::kLogMarginalLikelihood: {
+      LogMarginalLikelihoodEvaluator log_likelihood_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                         num_sampled, log_marginal_gradient_type);
+      {
+        ScopedGILRelease gil_release;
+        EvaluateLogLikelihoodAtPointList(log_likelihood_eval, square_exponential, dummy_domain, thread_schedule,
+                                         hyperparameter_list, num_multistarts, &found_flag,
+                                         function_values, new_hyperparameters_C.data());
+      }
+      status[std::string("evaluate_") + log_likelihood_eval.kName + "_at_hyperparameter_list"] = found_flag;
       break;
-    }  // end case LogLikelihoodTypes::kLogMarginalLikelihood
+    }
     case LogLikelihoodTypes::kLeaveOneOutLogLikelihood: {
-      LeaveOneOutLogLikelihoodEvaluator log_likelihood_eval(input_container.points_sampled.data(),
-                                                            input_container.points_sampled_value.data(),
-                                                            input_container.noise_variance.data(),
-                                                            input_container.dim, input_container.num_sampled);
-
-      DispatchHyperparameterOptimization(optimizer_parameters, log_likelihood_eval, square_exponential,
-                                         hyperparameter_domain_C.data(), optimizer_type, max_num_threads,
-                                         randomness_source, status, new_hyperparameters.data());
+      LeaveOneOutLogLikelihoodEvaluator log_likelihood_eval(points_sampled, points_sampled_value, noise_variance, dim,
+                                                            num_sampled, leave_one_out_compute_type);
+      {
+        ScopedGILRelease gil_release;
+        EvaluateLogLikelihoodAtPointList(log_likelihood_eval, square_exponential, dummy_domain, thread_schedule,
+                                         hyperparameter_list, num_multistarts, &found_flag,
+                                         function_values, new_hyperparameters_C.data());
+      }
+      status[std::string("evaluate_") + log_likelihood_eval.kName + "_at_hyperparameter_list"] = found_flag;
       break;
-    }  // end case LogLikelihoodTypes::kLeaveOneOutLogLikelihood
+    }
     default: {
-      std::fill(new_hyperparameters.begin(), new_hyperparameters.end(), 1.0);
-      OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid objective type choice. Setting all hyperparameters to 1.0.");
+      std::fill(function_values, function_values + num_multistarts, -std::numeric_limits<double>::max());
+      status["evaluate_invalid_log_likelihood_at_hyperparameter_list"] = found_flag;
+      OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid objective mode choice. Setting all results to -DBL_MAX.");
       break;
     }
-  }  // end switch over objective_type
-
-  return VectorToPylist(new_hyperparameters);
+  }
 }
 
 boost::python::list EvaluateLogLikelihoodAtHyperparameterListWrapper(const boost::python::list& hyperparameter_list,
@@ -280,6 +540,8 @@ boost::python::list EvaluateLogLikelihoodAtHyperparameterListWrapper(const boost
                                                                      const boost::python::list& points_sampled_value,
                                                                      int dim, int num_sampled,
                                                                      LogLikelihoodTypes objective_mode,
+                                                                     LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                                                     LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
                                                                      const boost::python::list& hyperparameters,
                                                                      const boost::python::list& noise_variance,
                                                                      int num_multistarts, int max_num_threads,
@@ -292,53 +554,64 @@ boost::python::list EvaluateLogLikelihoodAtHyperparameterListWrapper(const boost
 
   SquareExponential square_exponential(input_container.dim, input_container.alpha, input_container.lengths.data());
 
-  std::vector<double> new_hyperparameters_C(square_exponential.GetNumberOfHyperparameters());
   std::vector<double> result_function_values_C(num_multistarts);
   std::vector<double> initial_guesses_C(square_exponential.GetNumberOfHyperparameters() * num_multistarts);
 
   CopyPylistToVector(hyperparameter_list, square_exponential.GetNumberOfHyperparameters() * num_multistarts, initial_guesses_C);
 
-  TensorProductDomain dummy_domain(nullptr, 0);
-  ThreadSchedule thread_schedule(max_num_threads, omp_sched_guided);
-
-  bool found_flag = false;
-  switch (objective_mode) {
-    case LogLikelihoodTypes::kLogMarginalLikelihood: {
-      LogMarginalLikelihoodEvaluator log_likelihood_eval(input_container.points_sampled.data(),
-                                                         input_container.points_sampled_value.data(),
-                                                         input_container.noise_variance.data(),
-                                                         input_container.dim, input_container.num_sampled);
-      EvaluateLogLikelihoodAtPointList(log_likelihood_eval, square_exponential, dummy_domain, thread_schedule,
-                                       initial_guesses_C.data(), num_multistarts, &found_flag,
-                                       result_function_values_C.data(), new_hyperparameters_C.data());
-      status[std::string("evaluate_") + log_likelihood_eval.kName + "_at_hyperparameter_list"] = found_flag;
-      break;
-    }
-    case LogLikelihoodTypes::kLeaveOneOutLogLikelihood: {
-      LeaveOneOutLogLikelihoodEvaluator log_likelihood_eval(input_container.points_sampled.data(),
-                                                            input_container.points_sampled_value.data(),
-                                                            input_container.noise_variance.data(),
-                                                            input_container.dim, input_container.num_sampled);
-      EvaluateLogLikelihoodAtPointList(log_likelihood_eval, square_exponential, dummy_domain, thread_schedule,
-                                       initial_guesses_C.data(), num_multistarts, &found_flag,
-                                       result_function_values_C.data(), new_hyperparameters_C.data());
-      status[std::string("evaluate_") + log_likelihood_eval.kName + "_at_hyperparameter_list"] = found_flag;
-      break;
-    }
-    default: {
-      std::fill(result_function_values_C.begin(), result_function_values_C.end(), -std::numeric_limits<double>::max());
-      status["evaluate_invalid_log_likelihood_at_hyperparameter_list"] = found_flag;
-      OL_THROW_EXCEPTION(OptimalLearningException, "ERROR: invalid objective mode choice. Setting all results to -DBL_MAX.");
-      break;
-    }
-  }
+  EvaluateLogLikelihoodAtHyperparameterList(initial_guesses_C.data(), input_container.points_sampled.data(),
+                                            input_container.points_sampled_value.data(),
+                                            input_container.noise_variance.data(), input_container.dim,
+                                            input_container.num_sampled, objective_mode, leave_one_out_compute_type,
+                                            log_marginal_gradient_type, square_exponential, num_multistarts,
+                                            max_num_threads, status,
+                                            result_function_values_C.data());
 
   return VectorToPylist(result_function_values_C);
 }
 
+void EvaluateLogLikelihoodAtHyperparameterListBufferWrapper(const boost::python::object& hyperparameter_list,
+                                                            const boost::python::object& points_sampled,
+                                                            const boost::python::object& points_sampled_value,
+                                                            int dim, int num_sampled,
+                                                            LogLikelihoodTypes objective_mode,
+                                                            LeaveOneOutComputeTypes leave_one_out_compute_type,
+                                                            LogMarginalLikelihoodGradientTypes log_marginal_gradient_type,
+                                                            const boost::python::list& hyperparameters,
+                                                            const boost::python::object& noise_variance,
+                                                            int num_multistarts, int max_num_threads,
+                                                            boost::python::dict& status,
+                                                            const boost::python::object& function_values) {
+  const double alpha = boost::python::extract<double>(hyperparameters[0]);
+  std::vector<double> lengths(dim);
+  CopyPylistToVector(boost::python::extract<boost::python::list>(hyperparameters[1]), dim, lengths);
+  SquareExponential square_exponential(dim, alpha, lengths.data());
+
+  PythonBufferView hyperparameter_list_view(hyperparameter_list,
+                                            square_exponential.GetNumberOfHyperparameters() * num_multistarts, false);
+  PythonBufferView points_sampled_view(points_sampled, dim*num_sampled, false);
+  PythonBufferView points_sampled_value_view(points_sampled_value, num_sampled, false);
+  PythonBufferView noise_variance_view(noise_variance, num_sampled, false);
+  PythonBufferView function_values_view(function_values, num_multistarts, true);
+
+  EvaluateLogLikelihoodAtHyperparameterList(hyperparameter_list_view.data(), points_sampled_view.data(),
+                                            points_sampled_value_view.data(), noise_variance_view.data(), dim,
+                                            num_sampled, objective_mode, leave_one_out_compute_type,
+                                            log_marginal_gradient_type, square_exponential, num_multistarts,
+                                            max_num_threads, status, function_values_view.data());
+}
+
 }  // end unnamed namespace
 
 void ExportModelSelectionFunctions() {
+  // boost::python tries overloads in reverse order of registration, so buffer overloads with the same arity as a list
+  // overload are registered FIRST (see ExportGaussianProcessFunctions() in gpp_python_gaussian_process.cpp).
+  boost::python::def("compute_log_likelihood", ComputeLogLikelihoodBufferWrapper, R"%%(
+    Same as the list overload (below) except ``points_sampled``, ``points_sampled_value``, and ``noise_variance`` are
+    read in place from buffers (e.g., C-contiguous numpy arrays of float64) with the same shapes.
+    ``hyperparameters`` is still a list.
+    )%%");
+
   boost::python::def("compute_log_likelihood", ComputeLogLikelihoodWrapper, R"%%(
     Computes the specified log likelihood measure of model fit using the given
     hyperparameters.
@@ -353,6 +626,10 @@ void ExportModelSelectionFunctions() {
     :type num_sampled: int > 0
     :param objective_mode: describes which log likelihood measure to compute (e.g., kLogMarginalLikelihood)
     :type objective_mode: GPP.LogLikelihoodTypes (enum)
+    :param leave_one_out_compute_type: how kLeaveOneOutLogLikelihood is computed (unused by other measures)
+    :type leave_one_out_compute_type: GPP.LeaveOneOutComputeTypes (enum)
+    :param log_marginal_gradient_type: how the gradient of kLogMarginalLikelihood is computed (unused by other measures)
+    :type log_marginal_gradient_type: GPP.LogMarginalLikelihoodGradientTypes (enum)
     :param hyperparameters: covariance hyperparameters; see "Details on ..." section at the top of ``BOOST_PYTHON_MODULE``
     :type hyperparameters: list of len 2; index 0 is a float64 ``\alpha`` (signal variance) and index 1 is the length scales (list of floa64 of length ``dim``)
     :param noise_variance: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
@@ -377,6 +654,10 @@ void ExportModelSelectionFunctions() {
     :type num_sampled: int > 0
     :param objective_mode: describes which log likelihood measure to compute (e.g., kLogMarginalLikelihood)
     :type objective_mode: GPP.LogLikelihoodTypes (enum)
+    :param leave_one_out_compute_type: how kLeaveOneOutLogLikelihood is computed (unused by other measures)
+    :type leave_one_out_compute_type: GPP.LeaveOneOutComputeTypes (enum)
+    :param log_marginal_gradient_type: how the gradient of kLogMarginalLikelihood is computed (unused by other measures)
+    :type log_marginal_gradient_type: GPP.LogMarginalLikelihoodGradientTypes (enum)
     :param hyperparameters: covariance hyperparameters; see "Details on ..." section at the top of ``BOOST_PYTHON_MODULE``
     :type hyperparameters: list of len 2; index 0 is a float64 ``\alpha`` (signal variance) and index 1 is the length scales (list of floa64 of length ``dim``)
     :param noise_variance: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
@@ -385,6 +666,17 @@ void ExportModelSelectionFunctions() {
     :rtype: list of float64 with shape (num_hyperparameters, )
     )%%");
 
+  boost::python::def("compute_hyperparameter_grad_log_likelihood", ComputeHyperparameterGradLogLikelihoodBufferWrapper, R"%%(
+    Compute the gradient of the specified log likelihood measure into a preallocated buffer (zero-copy).
+
+    Same as the list overload except ``points_sampled``, ``points_sampled_value``, and ``noise_variance`` are buffers
+    (e.g., C-contiguous numpy arrays of float64) with the same shapes, and the result is written into
+    ``grad_log_likelihood`` instead of returned.  ``hyperparameters`` is still a list.
+
+    :param grad_log_likelihood: (output) gradients of log marginal likelihood wrt hyperparameters
+    :type grad_log_likelihood: writable buffer of float64 with shape (num_hyperparameters, )
+    )%%");
+
   boost::python::def("multistart_hyperparameter_optimization", MultistartHyperparameterOptimizationWrapper, R"%%(
     Optimize the specified log likelihood measure over the specified domain using the specified optimization method.
 
@@ -417,6 +709,10 @@ void ExportModelSelectionFunctions() {
     :type dim: int > 0
     :param num_sampled: number of already-sampled points
     :type num_sampled: int > 0
+    :param leave_one_out_compute_type: how kLeaveOneOutLogLikelihood is computed (unused by other measures)
+    :type leave_one_out_compute_type: GPP.LeaveOneOutComputeTypes (enum)
+    :param log_marginal_gradient_type: how the gradient of kLogMarginalLikelihood is computed (unused by other measures)
+    :type log_marginal_gradient_type: GPP.LogMarginalLikelihoodGradientTypes (enum)
     :param hyperparameters: covariance hyperparameters; see "Details on ..." section at the top of ``BOOST_PYTHON_MODULE``
     :type hyperparameters: list of len 2; index 0 is a float64 ``\alpha`` (signal variance) and index 1 is the length scales (list of floa64 of length ``dim``)
     :param noise_variance: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
@@ -431,6 +727,17 @@ void ExportModelSelectionFunctions() {
     :rtype: list of float64 with shape (num_hyperparameters, )
     )%%");
 
+  boost::python::def("multistart_hyperparameter_optimization", MultistartHyperparameterOptimizationBufferWrapper, R"%%(
+    Optimize the specified log likelihood measure into a preallocated buffer (zero-copy).
+
+    Same as the list overload except ``hyperparameter_domain``, ``points_sampled``, ``points_sampled_value``, and
+    ``noise_variance`` are buffers (e.g., C-contiguous numpy arrays of float64) with the same shapes, and the result is
+    written into ``new_hyperparameters`` instead of returned.  ``hyperparameters`` is still a list.
+
+    :param new_hyperparameters: (output) optimized hyperparameters
+    :type new_hyperparameters: writable buffer of float64 with shape (num_hyperparameters, )
+    )%%");
+
   boost::python::def("evaluate_log_likelihood_at_hyperparameter_list", EvaluateLogLikelihoodAtHyperparameterListWrapper, R"%%(
     Evaluates the specified log likelihood measure of model fit at each member of
     hyperparameter_list. Useful for plotting.
@@ -457,6 +764,10 @@ void ExportModelSelectionFunctions() {
     :type num_sampled: int > 0
     :param objective_mode: describes which log likelihood measure to compute (e.g., kLogMarginalLikelihood)
     :type objective_mode: GPP.LogLikelihoodTypes (enum)
+    :param leave_one_out_compute_type: how kLeaveOneOutLogLikelihood is computed (unused by other measures)
+    :type leave_one_out_compute_type: GPP.LeaveOneOutComputeTypes (enum)
+    :param log_marginal_gradient_type: how the gradient of kLogMarginalLikelihood is computed (unused by other measures)
+    :type log_marginal_gradient_type: GPP.LogMarginalLikelihoodGradientTypes (enum)
     :param hyperparameters: covariance hyperparameters; see "Details on ..." section at the top of ``BOOST_PYTHON_MODULE``
     :type hyperparameters: list of len 2; index 0 is a float64 ``\alpha`` (signal variance) and index 1 is the length scales (list of floa64 of length ``dim``)
     :param noise_variance: the ``\sigma_n^2`` (noise variance) associated w/observation, points_sampled_value
@@ -470,6 +781,18 @@ void ExportModelSelectionFunctions() {
     :return: log likelihood values at each point of the hyperparameter_list list, in the same order
     :rtype: list of float64 with shape (num_multistarts, )
     )%%");
+
+  boost::python::def("evaluate_log_likelihood_at_hyperparameter_list", EvaluateLogLikelihoodAtHyperparameterListBufferWrapper, R"%%(
+    Evaluate the specified log likelihood measure at each member of hyperparameter_list into a preallocated buffer
+    (zero-copy).
+
+    Same as the list overload except ``hyperparameter_list``, ``points_sampled``, ``points_sampled_value``, and
+    ``noise_variance`` are buffers (e.g., C-contiguous numpy arrays of float64) with the same shapes, and the result is
+    written into ``function_values`` instead of returned.  ``hyperparameters`` is still a list.
+
+    :param function_values: (output) log likelihood values at each point of the hyperparameter_list list, in the same order
+    :type function_values: writable buffer of float64 with shape (num_multistarts, )
+    )%%");
 }
 
 }  // end namespace optimal_learning
@@ -22,10 +22,14 @@
 #include "gpp_heuristic_expected_improvement_optimization_test.hpp"
 #include "gpp_linear_algebra_test.hpp"
 #include "gpp_math_test.hpp"
+#include "gpp_memory_pool_test.hpp"
+#include "gpp_model_cache_test.hpp"
 #include "gpp_model_selection.hpp"
 #include "gpp_model_selection_test.hpp"
+#include "gpp_model_snapshot_test.hpp"
 #include "gpp_optimization_test.hpp"
 #include "gpp_random_test.hpp"
+#include "gpp_task_pool_test.hpp"
 #include "gpp_test_utils_test.hpp"
 
 namespace optimal_learning {
@@ -140,6 +144,38 @@ int RunCppTestsWrapper() {
   }
   total_errors += error;
 
+  error = RunMemoryPoolTests();
+  if (error != 0) {
+    OL_FAILURE_PRINTF("memory pool (scratch arena) tests failed\n");
+  } else {
+    OL_SUCCESS_PRINTF("memory pool (scratch arena) tests\n");
+  }
+  total_errors += error;
+
+  error = RunTaskPoolTests();
+  if (error != 0) {
+    OL_FAILURE_PRINTF("task pool (work stealing) tests failed\n");
+  } else {
+    OL_SUCCESS_PRINTF("task pool (work stealing) tests\n");
+  }
+  total_errors += error;
+
+  error = RunGaussianProcessCacheTests();
+  if (error != 0) {
+    OL_FAILURE_PRINTF("model cache (fitted GP reuse) tests failed\n");
+  } else {
+    OL_SUCCESS_PRINTF("model cache (fitted GP reuse) tests\n");
+  }
+  total_errors += error;
+
+  error = RunGaussianProcessSnapshotTests();
+  if (error != 0) {
+    OL_FAILURE_PRINTF("model snapshot (save/mmap load) tests failed\n");
+  } else {
+    OL_SUCCESS_PRINTF("model snapshot (save/mmap load) tests\n");
+  }
+  total_errors += error;
+
   error = RunOptimizationTests();
   if (error != 0) {
     OL_FAILURE_PRINTF("basic optimization tests (simple objectives, exception handling)\n");
@@ -164,6 +200,22 @@ int RunCppTestsWrapper() {
   }
   total_errors += error;
 
+  error = HyperparameterLikelihoodComputeTypeOptimizationTest(LogLikelihoodTypes::kLeaveOneOutLogLikelihood);
+  if (error != 0) {
+    OL_FAILURE_PRINTF("LOO (cholesky downdate) likelihood hyperparameter optimization\n");
+  } else {
+    OL_SUCCESS_PRINTF("LOO (cholesky downdate) likelihood hyperparameter optimization\n");
+  }
+  total_errors += error;
+
+  error = HyperparameterLikelihoodComputeTypeOptimizationTest(LogLikelihoodTypes::kLogMarginalLikelihood);
+  if (error != 0) {
+    OL_FAILURE_PRINTF("log likelihood (streaming gradient) hyperparameter optimization\n");
+  } else {
+    OL_SUCCESS_PRINTF("log likelihood (streaming gradient) hyperparameter optimization\n");
+  }
+  total_errors += error;
+
   error = HyperparameterLikelihoodOptimizationTest(OptimizerTypes::kNewton, LogLikelihoodTypes::kLogMarginalLikelihood);
   if (error != 0) {
     OL_FAILURE_PRINTF("log likelihood hyperparameter newton optimization\n");
@@ -172,6 +224,14 @@ int RunCppTestsWrapper() {
   }
   total_errors += error;
 
+  error = HyperparameterLikelihoodOptimizationTest(OptimizerTypes::kLBFGS, LogLikelihoodTypes::kLogMarginalLikelihood);
+  if (error != 0) {
+    OL_FAILURE_PRINTF("log likelihood hyperparameter l-bfgs optimization\n");
+  } else {
+    OL_SUCCESS_PRINTF("log likelihood hyperparameter l-bfgs optimization\n");
+  }
+  total_errors += error;
+
   error = EvaluateLogLikelihoodAtPointListTest();
   if (error != 0) {
     OL_FAILURE_PRINTF("log likelihood evaluation at point list\n");
@@ -236,6 +296,14 @@ int RunCppTestsWrapper() {
   }
   total_errors += error;
 
+  error = ExpectedImprovementLBFGSOptimizationTest();
+  if (error != 0) {
+    OL_FAILURE_PRINTF("l-bfgs EI optimization for multiple simultaneous experiments\n");
+  } else {
+    OL_SUCCESS_PRINTF("l-bfgs EI optimization for multiple simultaneous experiments\n");
+  }
+  total_errors += error;
+
   error = ExpectedImprovementOptimizationTest(DomainTypes::kSimplex, ExpectedImprovementEvaluationMode::kAnalytic);
   if (error != 0) {
     OL_FAILURE_PRINTF("analytic simplex EI optimization\n");
@@ -11,6 +11,7 @@
 #include <sys/time.h>
 
 #include <cmath>
+#include <cstdint>
 
 #include <algorithm>
 #include <limits>
@@ -138,6 +139,267 @@ void NormalRNG::PrintState(std::ostream * out_stream) const {
   uniform_generator.PrintState(out_stream);
 }
 
+PhiloxNormalRNG::PhiloxNormalRNG(SeedType seed, std::uint64_t stream) noexcept
+    : seed_(seed), stream_(stream), next_block_(0), block_position_(kNormalBlockSize) {
+}
+
+PhiloxNormalRNG::PhiloxNormalRNG(SeedType seed) noexcept : PhiloxNormalRNG(seed, 0) {
+}
+
+PhiloxNormalRNG::PhiloxNormalRNG() noexcept : PhiloxNormalRNG(kDefaultSeed) {
+}
+
+/*!\rst
+  Reference: Salmon, Moraes, Dror, Shaw. "Parallel Random Numbers: As Easy as 1, 2, 3." SC11.
+  Each round multiplies two counter words by fixed constants, swaps halves and xors in the (Weyl-bumped) key.
+\endrst*/
+void PhiloxNormalRNG::Philox4x32(std::uint32_t const * restrict counter, std::uint32_t const * restrict key,
+                                 std::uint32_t * restrict result) noexcept {
+  static constexpr std::uint64_t kMultiplier0 = 0xD2511F53;
+  static constexpr std::uint64_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr std::uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr std::uint32_t kWeyl1 = 0xBB67AE85;
+  static constexpr int kNumRounds = 10;
+
+  std::uint32_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+  std::uint32_t k0 = key[0], k1 = key[1];
+  for (int round = 0; round < kNumRounds; ++round) {
+    std::uint64_t product0 = kMultiplier0*x0;
+    std::uint64_t product1 = kMultiplier1*x2;
+    std::uint32_t y0 = static_cast<std::uint32_t>(product1 >> 32) ^ x1 ^ k0;
+    std::uint32_t y1 = static_cast<std::uint32_t>(product1);
+    std::uint32_t y2 = static_cast<std::uint32_t>(product0 >> 32) ^ x3 ^ k1;
+    std::uint32_t y3 = static_cast<std::uint32_t>(product0);
+    x0 = y0; x1 = y1; x2 = y2; x3 = y3;
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+  result[0] = x0;
+  result[1] = x1;
+  result[2] = x2;
+  result[3] = x3;
+}
+
+/*!\rst
+  Block ``b`` encrypts counters ``(4*b + lane, stream)`` for ``lane = 0..3``.  Each 128-bit output gives two 53-bit
+  uniforms: ``u_0 \in (0, 1]`` (so the log is finite) and ``u_1 \in [0, 1)``, which Box-Muller maps to
+  ``sqrt(-2 log u_0) * (cos(2 \pi u_1), sin(2 \pi u_1))``.
+\endrst*/
+void PhiloxNormalRNG::GenerateBlock() noexcept {
+  static constexpr int kNumLanes = kNormalBlockSize/2;
+  static constexpr double kTwoToMinus53 = 1.0/9007199254740992.0;
+  const std::uint32_t key[2] = {static_cast<std::uint32_t>(seed_), static_cast<std::uint32_t>(seed_ >> 32)};
+
+  std::uint32_t bits[kNumLanes][4];
+  for (int lane = 0; lane < kNumLanes; ++lane) {
+    std::uint64_t block_counter = next_block_*kNumLanes + lane;
+    const std::uint32_t counter[4] = {static_cast<std::uint32_t>(block_counter),
+                                      static_cast<std::uint32_t>(block_counter >> 32),
+                                      static_cast<std::uint32_t>(stream_),
+                                      static_cast<std::uint32_t>(stream_ >> 32)};
+    Philox4x32(counter, key, bits[lane]);
+  }
+
+  for (int lane = 0; lane < kNumLanes; ++lane) {
+    std::uint64_t bits_0 = (static_cast<std::uint64_t>(bits[lane][0]) << 32) | bits[lane][1];
+    std::uint64_t bits_1 = (static_cast<std::uint64_t>(bits[lane][2]) << 32) | bits[lane][3];
+    double uniform_0 = static_cast<double>((bits_0 >> 11) + 1)*kTwoToMinus53;
+    double uniform_1 = static_cast<double>(bits_1 >> 11)*kTwoToMinus53;
+    double radius = std::sqrt(-2.0*std::log(uniform_0));
+    double angle = 2.0*kPi*uniform_1;
+    normals_[2*lane + 0] = radius*std::cos(angle);
+    normals_[2*lane + 1] = radius*std::sin(angle);
+  }
+
+  ++next_block_;
+  block_position_ = 0;
+}
+
+double PhiloxNormalRNG::operator()() {
+  if (unlikely(block_position_ == kNormalBlockSize)) {
+    GenerateBlock();
+  }
+  return normals_[block_position_++];
+}
+
+void PhiloxNormalRNG::SetExplicitSeed(SeedType seed) noexcept {
+  seed_ = seed;
+  ResetToMostRecentSeed();
+}
+
+void PhiloxNormalRNG::SetStream(std::uint64_t stream) noexcept {
+  stream_ = stream;
+  ResetToMostRecentSeed();
+}
+
+void PhiloxNormalRNG::SetDrawIndex(std::uint64_t draw_index) noexcept {
+  next_block_ = draw_index/kNormalBlockSize;
+  int position = static_cast<int>(draw_index % kNormalBlockSize);
+  if (position == 0) {
+    block_position_ = kNormalBlockSize;
+  } else {
+    GenerateBlock();
+    block_position_ = position;
+  }
+}
+
+void PhiloxNormalRNG::ResetToMostRecentSeed() noexcept {
+  next_block_ = 0;
+  block_position_ = kNormalBlockSize;
+}
+
+/*!\rst
+  Acklam's algorithm: a rational approximation in the central region ``[p_low, 1 - p_low]`` and in
+  ``\sqrt{-2\log p}`` in the tails.  Refined with one step of Halley's method on ``\Phi(x) - p = 0``; since
+  Halley's method converges cubically, a single step from ~1e-9 relative error suffices.
+\endrst*/
+double InverseStandardNormalCDF(double probability) noexcept {
+  static constexpr double kA[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                   1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+  static constexpr double kB[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                   6.680131188771972e+01, -1.328068155288572e+01};
+  static constexpr double kC[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                   -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+  static constexpr double kD[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                   3.754408661907416e+00};
+  static constexpr double kLowTail = 0.02425;
+  static constexpr double kSqrtHalf = 0.70710678118654752440;
+
+  double x;
+  if (probability < kLowTail) {
+    double q = std::sqrt(-2.0*std::log(probability));
+    x = (((((kC[0]*q + kC[1])*q + kC[2])*q + kC[3])*q + kC[4])*q + kC[5]) /
+        ((((kD[0]*q + kD[1])*q + kD[2])*q + kD[3])*q + 1.0);
+  } else if (probability <= 1.0 - kLowTail) {
+    double q = probability - 0.5;
+    double r = q*q;
+    x = (((((kA[0]*r + kA[1])*r + kA[2])*r + kA[3])*r + kA[4])*r + kA[5])*q /
+        (((((kB[0]*r + kB[1])*r + kB[2])*r + kB[3])*r + kB[4])*r + 1.0);
+  } else {
+    double q = std::sqrt(-2.0*std::log1p(-probability));
+    x = -(((((kC[0]*q + kC[1])*q + kC[2])*q + kC[3])*q + kC[4])*q + kC[5]) /
+        ((((kD[0]*q + kD[1])*q + kD[2])*q + kD[3])*q + 1.0);
+  }
+
+  // Halley refinement; erfc keeps the residual accurate in both tails
+  double residual = 0.5*std::erfc(-x*kSqrtHalf) - probability;
+  double u = residual*std::sqrt(2.0*kPi)*std::exp(0.5*x*x);
+  return x - u/(1.0 + 0.5*x*u);
+}
+
+namespace {
+
+/*!\rst
+  Joe & Kuo (2008) Sobol direction number initializers (new-joe-kuo-6.21201) for dimensions 2 through
+  SobolNormalRNG::kMaxDimension.  Dimension 1 is the van der Corput sequence (all ``m_k = 1``).
+\endrst*/
+struct SobolInitializer {
+  //! degree of the primitive polynomial
+  int degree;
+  //! interior coefficients of the primitive polynomial, as bits (most significant = highest power)
+  std::uint32_t coefficients;
+  //! initial direction integers ``m_1, ..., m_degree`` (odd, ``m_k < 2^k``)
+  std::uint32_t initial_m[7];
+};
+
+constexpr SobolInitializer kSobolInitializers[SobolNormalRNG::kMaxDimension - 1] = {
+  {1, 0, {1}},
+  {2, 1, {1, 3}},
+  {3, 1, {1, 3, 1}},
+  {3, 2, {1, 1, 1}},
+  {4, 1, {1, 1, 3, 3}},
+  {4, 4, {1, 3, 5, 13}},
+  {5, 2, {1, 1, 5, 5, 17}},
+  {5, 4, {1, 1, 5, 5, 5}},
+  {5, 7, {1, 1, 7, 11, 19}},
+  {5, 11, {1, 1, 5, 1, 1}},
+  {5, 13, {1, 1, 1, 3, 11}},
+  {5, 14, {1, 3, 5, 5, 31}},
+  {6, 1, {1, 3, 3, 9, 7, 49}},
+  {6, 13, {1, 1, 1, 15, 21, 21}},
+  {6, 16, {1, 3, 1, 13, 27, 49}},
+  {6, 19, {1, 1, 1, 15, 7, 5}},
+  {6, 22, {1, 3, 1, 15, 13, 25}},
+  {6, 25, {1, 1, 5, 5, 19, 61}},
+  {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+  {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+};
+
+}  // end unnamed namespace
+
+/*!\rst
+  Direction numbers follow Bratley & Fox (1988): ``v_k = m_k 2^{32-k}`` for ``k = 1..s`` and then
+  ``v_k = v_{k-s} \oplus (v_{k-s} >> s) \oplus_{j=1}^{s-1} a_j v_{k-j}``, where ``a_j`` are the polynomial coefficients.
+\endrst*/
+SobolNormalRNG::SobolNormalRNG(int dim)
+    : dim_(dim),
+      direction_numbers_(dim*kNumBits),
+      shift_(dim, 0),
+      point_(dim, 0),
+      point_index_(0),
+      coordinate_(0) {
+  if (unlikely(dim < 1 || dim > kMaxDimension)) {
+    OL_THROW_EXCEPTION(BoundsException<int>, "Invalid Sobol sequence dimension.", dim, 1, kMaxDimension);
+  }
+
+  for (int k = 0; k < kNumBits; ++k) {
+    direction_numbers_[k] = static_cast<std::uint32_t>(1) << (kNumBits - 1 - k);
+  }
+  for (int d = 1; d < dim_; ++d) {
+    const SobolInitializer& initializer = kSobolInitializers[d - 1];
+    const int degree = initializer.degree;
+    std::uint32_t * restrict direction = direction_numbers_.data() + d*kNumBits;
+    for (int k = 0; k < degree; ++k) {
+      direction[k] = initializer.initial_m[k] << (kNumBits - 1 - k);
+    }
+    for (int k = degree; k < kNumBits; ++k) {
+      direction[k] = direction[k - degree] ^ (direction[k - degree] >> degree);
+      for (int j = 1; j < degree; ++j) {
+        if ((initializer.coefficients >> (degree - 1 - j)) & 1) {
+          direction[k] ^= direction[k - j];
+        }
+      }
+    }
+  }
+}
+
+/*!\rst
+  In Gray-code order, point ``n + 1`` is point ``n`` xor the direction number indexed by the number of trailing zeros
+  of ``n + 1``.  Coordinates are mapped to the open interval ``(0, 1)`` by ``(x + 1/2) 2^{-32}`` so that
+  InverseStandardNormalCDF() stays finite.
+\endrst*/
+double SobolNormalRNG::operator()() {
+  if (coordinate_ == dim_) {
+    ++point_index_;
+    const int bit = __builtin_ctz(point_index_);
+    for (int d = 0; d < dim_; ++d) {
+      point_[d] ^= direction_numbers_[d*kNumBits + bit];
+    }
+    coordinate_ = 0;
+  }
+
+  static constexpr double kTwoToMinus32 = 1.0/4294967296.0;
+  const std::uint32_t shifted = point_[coordinate_] ^ shift_[coordinate_];
+  ++coordinate_;
+  return InverseStandardNormalCDF((static_cast<double>(shifted) + 0.5)*kTwoToMinus32);
+}
+
+void SobolNormalRNG::Randomize(NormalRNGInterface * normal_rng) {
+  static constexpr double kTwoTo32 = 4294967296.0;
+  static constexpr double kSqrtHalf = 0.70710678118654752440;
+  for (int d = 0; d < dim_; ++d) {
+    double uniform = 0.5*std::erfc(-(*normal_rng)()*kSqrtHalf);
+    shift_[d] = static_cast<std::uint32_t>(std::min(uniform*kTwoTo32, kTwoTo32 - 1.0));
+  }
+  ResetToMostRecentSeed();
+}
+
+void SobolNormalRNG::ResetToMostRecentSeed() noexcept {
+  std::fill(point_.begin(), point_.end(), 0);
+  point_index_ = 0;
+  coordinate_ = 0;
+}
+
 NormalRNGSimulator::NormalRNGSimulator(const std::vector<double>& random_number_table_in)
     : random_number_table_(random_number_table_in),
       index_(0) {
@@ -5,6 +5,8 @@
 
   1. UniformRandomGenerator (container for a PRNG "engine")
   2. NormalRNG (functor for N(0, 1)-distributed PRNs, uses UniformRandomGenerator)
+  3. PhiloxNormalRNG (functor for N(0, 1)-distributed PRNs from a stateless, counter-based generator)
+  4. SobolNormalRNG (functor for N(0, 1)-distributed quasi-random numbers, for randomized quasi-monte-carlo)
 
   It additionally contains two methods for randomly generating points in a tensor-product domain:
   ``[x_0_min, x_0_max] X [x_1_min, x_1_max] X ... X [x_d_min, x_d_max]``
@@ -25,11 +27,17 @@
   NormalRNG is a functor for generating ``mean = 0, variance = 1``, normally distributed (pseudo) random numbers.  In addition
   to UniformRandomGenerator, NormalRNG also implements operator() to draw from the aforementioned distribution.  N(0, 1) is
   a common choice (and the only one used in gpp_* so far), so NormalRNG wraps the entire number generation process.
+
+  PhiloxNormalRNG is the counter-based alternative to NormalRNG.  Its output is a pure function of
+  ``(seed, stream, draw index)``, so work items (e.g., multistarts) that select their own stream reproduce the same
+  normals regardless of which thread runs them or in what order.
 \endrst*/
 
 #ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_RANDOM_HPP_
 #define MOE_OPTIMAL_LEARNING_CPP_GPP_RANDOM_HPP_
 
+#include <cstdint>
+
 #include <iosfwd>
 #include <vector>
 
@@ -302,6 +310,221 @@ class NormalRNG final : public NormalRNGInterface {
   boost::variate_generator<EngineType&, boost::normal_distribution<double> > normal_random_variable_;
 };
 
+/*!\rst
+  Functor for computing normally distributed (N(0, 1)) random numbers from a counter-based generator.
+
+  Uniform bits come from Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11),
+  a keyed bijection on 128-bit counters.  The 64-bit key is the seed; the 128-bit counter is
+  ``(block index, stream)``.  So the ``n``-th normal drawn from a stream depends only on ``(seed, stream, n)``; there is
+  no hidden state carried between streams.  Callers that need results independent of the ``ThreadSchedule`` assign one
+  stream per work item (e.g., the multistart index) via SetStream() instead of one generator per thread.  Within a
+  stream, MC iteration ``k`` of a consumer drawing ``m`` normals per iteration reads normals ``[k*m, (k+1)*m)``;
+  SetDrawIndex() jumps there directly.
+
+  Normals are produced kNormalBlockSize at a time: the Philox lanes are independent so the block loop vectorizes, and
+  Box-Muller turns each pair of 53-bit uniforms into two normals.  The full state is a few dozen bytes (versus ~2.5 KB
+  for ``mt19937``).
+
+  .. WARNING:: this class is NOT THREAD-SAFE. Construct one object per thread; for reproducible results,
+    key each unit of work by stream rather than by thread.
+\endrst*/
+class PhiloxNormalRNG final : public NormalRNGInterface {
+ public:
+  using SeedType = std::uint64_t;
+
+  //! Default seed value to make reproducing test results simple.
+  static constexpr SeedType kDefaultSeed = 314;
+  //! Number of normals generated per refill: 4 Philox4x32 calls, each giving 4x32 bits -> 2 uniforms -> 2 normals.
+  static constexpr int kNormalBlockSize = 8;
+
+  /*!\rst
+    Default-constructs a PhiloxNormalRNG with kDefaultSeed on stream 0.
+  \endrst*/
+  PhiloxNormalRNG() noexcept;
+
+  /*!\rst
+    Construct a PhiloxNormalRNG positioned at the start of stream 0 with the specified seed.
+
+    \param
+      :seed: new seed (Philox key) to set
+  \endrst*/
+  explicit PhiloxNormalRNG(SeedType seed) noexcept;
+
+  /*!\rst
+    Construct a PhiloxNormalRNG positioned at the start of the specified stream.
+
+    \param
+      :seed: new seed (Philox key) to set
+      :stream: index of the stream to draw from (e.g., multistart index)
+  \endrst*/
+  PhiloxNormalRNG(SeedType seed, std::uint64_t stream) noexcept;
+
+  virtual double operator()();
+
+  /*!\rst
+    Set the seed (Philox key) and rewind to the start of the current stream.
+
+    \param
+      :seed: new seed to set
+  \endrst*/
+  void SetExplicitSeed(SeedType seed) noexcept;
+
+  /*!\rst
+    Switch to the start of the specified stream.  The seed is unchanged.
+
+    \param
+      :stream: index of the stream to draw from (e.g., multistart index)
+  \endrst*/
+  void SetStream(std::uint64_t stream) noexcept;
+
+  /*!\rst
+    Position the generator so that the next call to operator() returns normal number ``draw_index`` (0-based) of the
+    current stream.  O(1): at most one block is generated.
+
+    \param
+      :draw_index: index of the next normal to return
+  \endrst*/
+  void SetDrawIndex(std::uint64_t draw_index) noexcept;
+
+  /*!\rst
+    Rewinds to the start of the current stream.  (The seed and stream are retained.)
+  \endrst*/
+  virtual void ResetToMostRecentSeed() noexcept;
+
+  SeedType last_seed() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return seed_;
+  }
+
+  std::uint64_t stream() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return stream_;
+  }
+
+  /*!\rst
+    Index (within the current stream) of the normal that the next call to operator() will return.
+
+    \return
+      0-based index of the next draw
+  \endrst*/
+  std::uint64_t draw_index() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return next_block_*kNormalBlockSize - (kNormalBlockSize - block_position_);
+  }
+
+  /*!\rst
+    The Philox4x32-10 bijection: encrypts ``counter`` with ``key``.  Exposed for testing against the reference
+    (Random123) known-answer vectors.
+
+    \param
+      :counter[4]: 128-bit counter, least significant word first
+      :key[2]: 64-bit key, least significant word first
+    \output
+      :result[4]: 128 pseudo-random bits
+  \endrst*/
+  static void Philox4x32(std::uint32_t const * restrict counter, std::uint32_t const * restrict key,
+                         std::uint32_t * restrict result) noexcept OL_NONNULL_POINTERS;
+
+ private:
+  /*!\rst
+    Fill ``normals_`` with the ``next_block_``-th block of normals of the current stream and advance ``next_block_``.
+  \endrst*/
+  void GenerateBlock() noexcept;
+
+  //! The seed (Philox key).
+  SeedType seed_;
+  //! The current stream; occupies the upper 64 bits of the Philox counter.
+  std::uint64_t stream_;
+  //! Index of the block that the next GenerateBlock() call will produce.
+  std::uint64_t next_block_;
+  //! Position of the next unused normal in ``normals_``; kNormalBlockSize means the buffer is exhausted.
+  int block_position_;
+  //! The most recently generated block of normals.
+  double normals_[kNormalBlockSize];
+};
+
+/*!\rst
+  Computes the inverse of the standard normal CDF, ``\Phi^{-1}(p)``.
+
+  Uses Acklam's rational approximation (relative error ~1e-9) followed by one Halley step against ``std::erfc``,
+  which brings the result to near machine precision.
+
+  \param
+    :probability: a value in ``(0, 1)``
+  \return
+    ``x`` such that ``\Phi(x) = probability``
+\endrst*/
+double InverseStandardNormalCDF(double probability) noexcept OL_CONST_FUNCTION OL_WARN_UNUSED_RESULT;
+
+/*!\rst
+  Functor for quasi-random "normally distributed" numbers: points of a digitally shifted Sobol sequence in
+  ``[0, 1]^dim`` mapped coordinate-wise through InverseStandardNormalCDF().  Consecutive calls return coordinates
+  ``0, ..., dim-1`` of point 0, then of point 1, etc.; i.e., the same vector-at-a-time order in which monte-carlo
+  consumers draw ``dim``-dimensional normal vectors from a NormalRNGInterface.
+
+  The Sobol sequence is a (t, dim)-sequence in base 2: every aligned block of ``2^k`` consecutive points is evenly
+  stratified, so integrands of bounded variation converge like ``O(\log(n)^{dim}/n)`` instead of monte-carlo's
+  ``O(1/\sqrt{n})``.  Points are generated in Gray-code order (one xor per coordinate per point) from the
+  Joe & Kuo (2008) direction numbers, which are tabulated here for up to kMaxDimension dimensions.
+
+  Randomize() XORs every coordinate with a uniformly random 32-bit digital shift.  Each shifted point is then uniform
+  on the unit cube, so averages over the points are unbiased; averages over several independent shifts give a
+  randomized-QMC error estimate.  Before the first call to Randomize(), the shift is 0 (the plain Sobol sequence).
+
+  .. WARNING:: this class is NOT THREAD-SAFE. You must construct one object per thread.
+\endrst*/
+class SobolNormalRNG final : public NormalRNGInterface {
+ public:
+  //! Maximum supported dimension (number of tabulated direction number sets + 1).
+  static constexpr int kMaxDimension = 21;
+  //! Number of bits in each Sobol coordinate; also the number of direction numbers per dimension.
+  static constexpr int kNumBits = 32;
+
+  /*!\rst
+    Constructs a SobolNormalRNG for points in ``dim`` dimensions, positioned at the first point with no shift.
+
+    \param
+      :dim: number of coordinates per point; ``1 <= dim <= kMaxDimension``
+  \endrst*/
+  explicit SobolNormalRNG(int dim);
+
+  virtual double operator()();
+
+  /*!\rst
+    Draws a new digital shift (one uniform 32-bit integer per dimension) and rewinds to the first point.  The uniforms
+    are computed as ``\Phi(z)`` for ``z`` drawn from ``normal_rng``, so the randomization is reproducible under the
+    usual seeding of ``normal_rng``.
+
+    \param
+      :normal_rng[1]: a properly seeded NormalRNGInterface
+    \output
+      :normal_rng[1]: rng advanced by ``dim`` draws
+  \endrst*/
+  void Randomize(NormalRNGInterface * normal_rng) OL_NONNULL_POINTERS;
+
+  /*!\rst
+    Rewinds to the first point.  (The digital shift is retained.)
+  \endrst*/
+  virtual void ResetToMostRecentSeed() noexcept;
+
+  int dim() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return dim_;
+  }
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(SobolNormalRNG);
+
+ private:
+  //! number of coordinates per point
+  int dim_;
+  //! direction numbers, ``[dim][kNumBits]``; ``v_{d,k} = m_{d,k} * 2^{32 - k - 1}``
+  std::vector<std::uint32_t> direction_numbers_;
+  //! digital shift applied (by xor) to each coordinate, ``[dim]``
+  std::vector<std::uint32_t> shift_;
+  //! current (unshifted) Sobol point as 32-bit integers, ``[dim]``
+  std::vector<std::uint32_t> point_;
+  //! index (in Gray-code order) of the current point
+  std::uint32_t point_index_;
+  //! coordinate of the current point that the next call to operator() returns
+  int coordinate_;
+};
+
 /*!\rst
   RNG that generates normally distributed (N(0,1)) random numbers simply by reading random numbers stored in
   its "random_number_table", a data member in this class.
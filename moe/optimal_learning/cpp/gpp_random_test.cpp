@@ -7,6 +7,9 @@
 
 #include "gpp_random_test.hpp"
 
+#include <cmath>
+#include <cstdint>
+
 #include <algorithm>
 #include <limits>
 #include <unordered_set>
@@ -413,6 +416,248 @@ int NormalRNGSimulatorTest() {
   return total_errors;
 }
 
+/*!\rst
+  Checks that PhiloxNormalRNG is behaving correctly:
+
+  1. The Philox4x32-10 bijection matches the Random123 known-answer vectors
+  2. Output is a pure function of (seed, stream, draw index): reset, SetDrawIndex, and fresh objects all agree
+  3. Distinct streams and distinct seeds produce distinct sequences
+  4. Per-stream results do not depend on the number of threads or the OpenMP schedule
+  5. Sample mean and variance are consistent with N(0, 1)
+
+  \return
+    number of test failures: 0 if PhiloxNormalRNG is behaving correctly
+\endrst*/
+int PhiloxNormalRNGTest() {
+  int total_errors = 0;
+
+  // known-answer tests from Random123 (kat_vectors: philox4x32 10)
+  {
+    const std::uint32_t counters[3][4] = {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+                                          {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                                          {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+    const std::uint32_t keys[3][2] = {{0x00000000, 0x00000000},
+                                      {0xffffffff, 0xffffffff},
+                                      {0xa4093822, 0x299f31d0}};
+    const std::uint32_t truths[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+                                        {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+                                        {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+    for (int i = 0; i < 3; ++i) {
+      std::uint32_t result[4];
+      PhiloxNormalRNG::Philox4x32(counters[i], keys[i], result);
+      for (int j = 0; j < 4; ++j) {
+        if (result[j] != truths[i][j]) {
+          ++total_errors;
+        }
+      }
+    }
+  }
+
+  const int num_draws = 4*PhiloxNormalRNG::kNormalBlockSize + 3;
+  std::vector<double> reference(num_draws);
+  PhiloxNormalRNG normal_rng(31415, 7);
+  for (auto& entry : reference) {
+    entry = normal_rng();
+  }
+  if (normal_rng.draw_index() != static_cast<std::uint64_t>(num_draws)) {
+    ++total_errors;
+  }
+
+  // reset, fresh construction, and random access reproduce the sequence exactly
+  {
+    normal_rng.ResetToMostRecentSeed();
+    PhiloxNormalRNG normal_rng_copy(31415);
+    normal_rng_copy.SetStream(7);
+    for (int i = 0; i < num_draws; ++i) {
+      if (normal_rng() != reference[i] || normal_rng_copy() != reference[i]) {
+        ++total_errors;
+      }
+    }
+
+    for (int i = num_draws - 1; i >= 0; i -= 5) {
+      normal_rng.SetDrawIndex(i);
+      if (normal_rng.draw_index() != static_cast<std::uint64_t>(i) || normal_rng() != reference[i]) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // neighboring streams and seeds differ
+  {
+    PhiloxNormalRNG other_stream(31415, 8);
+    PhiloxNormalRNG other_seed(31416, 7);
+    int num_stream_matches = 0;
+    int num_seed_matches = 0;
+    for (int i = 0; i < num_draws; ++i) {
+      num_stream_matches += (other_stream() == reference[i]);
+      num_seed_matches += (other_seed() == reference[i]);
+    }
+    if (num_stream_matches != 0 || num_seed_matches != 0) {
+      ++total_errors;
+    }
+  }
+
+  // keyed by stream (not thread), results are independent of thread count and schedule
+  {
+    const int num_streams = 37;
+    const int num_draws_per_stream = 101;
+    std::vector<double> serial_sums(num_streams);
+    std::vector<double> parallel_sums(num_streams);
+    for (int i = 0; i < num_streams; ++i) {
+      PhiloxNormalRNG stream_rng(2718, i);
+      for (int j = 0; j < num_draws_per_stream; ++j) {
+        serial_sums[i] += stream_rng();
+      }
+    }
+
+    for (int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      std::fill(parallel_sums.begin(), parallel_sums.end(), 0.0);
+#pragma omp parallel num_threads(num_threads)
+      {
+        PhiloxNormalRNG thread_rng(2718);
+#pragma omp for schedule(dynamic, 3)
+        for (int i = 0; i < num_streams; ++i) {
+          thread_rng.SetStream(i);
+          for (int j = 0; j < num_draws_per_stream; ++j) {
+            parallel_sums[i] += thread_rng();
+          }
+        }
+      }
+      if (parallel_sums != serial_sums) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // moments; tolerances are ~5 standard errors
+  {
+    const int num_samples = 200000;
+    double mean = 0.0;
+    double second_moment = 0.0;
+    normal_rng.SetStream(0);
+    for (int i = 0; i < num_samples; ++i) {
+      double sample = normal_rng();
+      mean += sample;
+      second_moment += sample*sample;
+    }
+    mean /= static_cast<double>(num_samples);
+    double variance = second_moment/static_cast<double>(num_samples) - mean*mean;
+    if (std::fabs(mean) > 5.0/std::sqrt(static_cast<double>(num_samples))) {
+      ++total_errors;
+    }
+    if (std::fabs(variance - 1.0) > 5.0*std::sqrt(2.0/static_cast<double>(num_samples))) {
+      ++total_errors;
+    }
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Tests SobolNormalRNG and InverseStandardNormalCDF():
+
+  1. InverseStandardNormalCDF() inverts ``\Phi`` to near machine precision, including in the tails
+  2. Every aligned block of ``2^k`` points is stratified: each coordinate hits each interval ``[j/2^k, (j+1)/2^k)``
+     exactly once (in every dimension, with and without a digital shift); the first two dimensions are jointly stratified
+  3. Randomize() is reproducible given the seed of the source RNG, and ResetToMostRecentSeed() keeps the shift
+  4. Invalid dimensions are rejected
+
+  \return
+    number of test failures: 0 if SobolNormalRNG is behaving correctly
+\endrst*/
+int SobolNormalRNGTest() {
+  int total_errors = 0;
+  const double kSqrtHalf = std::sqrt(0.5);
+  auto standard_normal_cdf = [kSqrtHalf](double z) {
+    return 0.5*std::erfc(-z*kSqrtHalf);
+  };
+
+  {
+    const double probabilities[] = {1.0e-300, 1.0e-12, 2.0e-4, 0.02425, 0.1, 0.5, 0.7, 0.97575, 0.9999, 1.0 - 1.0e-10};
+    for (const auto probability : probabilities) {
+      double z = InverseStandardNormalCDF(probability);
+      if (!CheckDoubleWithinRelative(standard_normal_cdf(z), probability, 1.0e-12)) {
+        ++total_errors;
+      }
+    }
+    if (InverseStandardNormalCDF(0.5) != 0.0) {
+      ++total_errors;
+    }
+  }
+
+  const int dim = SobolNormalRNG::kMaxDimension;
+  const int log_num_points = 6;
+  const int num_points = 1 << log_num_points;
+  NormalRNG normal_rng(3141);
+  SobolNormalRNG sobol_rng(dim);
+  for (int num_shifts = 0; num_shifts < 3; ++num_shifts) {
+    // two consecutive aligned blocks of num_points points, each stratified on its own
+    for (int block = 0; block < 2; ++block) {
+      std::vector<int> hits(dim*num_points, 0);
+      std::vector<int> joint_hits(num_points, 0);
+      for (int i = 0; i < num_points; ++i) {
+        int joint_index = 0;
+        for (int d = 0; d < dim; ++d) {
+          int bin = static_cast<int>(standard_normal_cdf(sobol_rng())*static_cast<double>(num_points));
+          hits[d*num_points + bin] += 1;
+          if (d < 2) {
+            joint_index = joint_index*(1 << (log_num_points/2)) + (bin >> (log_num_points - log_num_points/2));
+          }
+        }
+        joint_hits[joint_index] += 1;
+      }
+      if (std::any_of(hits.begin(), hits.end(), [](int count) { return count != 1; }) ||
+          std::any_of(joint_hits.begin(), joint_hits.end(), [](int count) { return count != 1; })) {
+        ++total_errors;
+      }
+    }
+    sobol_rng.Randomize(&normal_rng);
+  }
+
+  {
+    const int num_draws = 5*dim + 3;
+    std::vector<double> reference(num_draws);
+    normal_rng.SetExplicitSeed(2718);
+    sobol_rng.Randomize(&normal_rng);
+    for (auto& entry : reference) {
+      entry = sobol_rng();
+    }
+
+    sobol_rng.ResetToMostRecentSeed();
+    SobolNormalRNG sobol_rng_copy(dim);
+    normal_rng.ResetToMostRecentSeed();
+    sobol_rng_copy.Randomize(&normal_rng);
+    int num_mismatches = 0;
+    for (int i = 0; i < num_draws; ++i) {
+      num_mismatches += (sobol_rng() != reference[i]) + (sobol_rng_copy() != reference[i]);
+    }
+    if (num_mismatches != 0) {
+      ++total_errors;
+    }
+
+    // a new shift changes the points
+    sobol_rng.Randomize(&normal_rng);
+    int num_matches = 0;
+    for (int i = 0; i < num_draws; ++i) {
+      num_matches += (sobol_rng() == reference[i]);
+    }
+    if (num_matches != 0) {
+      ++total_errors;
+    }
+  }
+
+  for (const auto invalid_dim : {0, SobolNormalRNG::kMaxDimension + 1}) {
+    try {
+      SobolNormalRNG sobol_rng_invalid(invalid_dim);
+      ++total_errors;
+    } catch (const BoundsException<int>& exception) {
+      // expected
+    }
+  }
+
+  return total_errors;
+}
+
 }  // end unnamed namespace
 
 /*!\rst
@@ -447,6 +692,22 @@ int RandomNumberGeneratorContainerTest() {
   }
   total_errors += current_errors;
 
+  current_errors = PhiloxNormalRNGTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("PhiloxNormalRNG failed with %d errors\n", current_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("PhiloxNormalRNG passed all tests\n");
+  }
+  total_errors += current_errors;
+
+  current_errors = SobolNormalRNGTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("SobolNormalRNG failed with %d errors\n", current_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("SobolNormalRNG passed all tests\n");
+  }
+  total_errors += current_errors;
+
   return total_errors;
 }
 
@@ -36,6 +36,8 @@ int RunRandomPointGeneratorTests() OL_WARN_UNUSED_RESULT;
   * Tests manual seed setting
   * Tests last_seed and reset
   * Tests that in multithreaded environemnts, each thread gets a different seed
+  * Tests that PhiloxNormalRNG is reproducible per (seed, stream, draw index), independent of threading
+  * Tests that SobolNormalRNG points are stratified and that its randomization (digital shift) is reproducible
 
   \return
     number of test failures: 0 if PRNG containers are behaving correctly
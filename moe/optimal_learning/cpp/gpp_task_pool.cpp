@@ -0,0 +1,337 @@
+/*!
+  \file gpp_task_pool.cpp
+  \rst
+  Implementation of WorkStealingTaskPool; see gpp_task_pool.hpp for details.
+\endrst*/
+
+#include "gpp_task_pool.hpp"
+
+#include <cstdint>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <omp.h>  // NOLINT(build/include_order)
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+//! one iteration of a (nested) parallel loop
+struct WorkStealingTaskPool::Task final {
+  //! the loop this task belongs to
+  TaskGroup * group;
+  //! loop index passed to the body
+  int index;
+};
+
+//! one call to ParallelFor() or NestedParallelFor(): its tasks and their completion status
+struct WorkStealingTaskPool::TaskGroup final {
+  TaskGroup(const TaskBody * body_in, int level_in, int num_tasks)
+      : body(body_in), level(level_in), remaining(num_tasks), exception_capture_flag(), captured_exception(),
+        tasks(num_tasks) {
+    for (int i = 0; i < num_tasks; ++i) {
+      tasks[i].group = this;
+      tasks[i].index = i;
+    }
+  }
+
+  //! loop body
+  const TaskBody * body;
+  //! nesting level of the tasks (0 for ParallelFor())
+  int level;
+  //! number of tasks not yet completed; the group is done when this reaches 0
+  std::atomic<int> remaining;
+  //! guards captured_exception so that only the first exception is kept (see MultistartOptimize() in gpp_optimization.hpp)
+  std::once_flag exception_capture_flag;
+  std::exception_ptr captured_exception;
+  //! one task per loop index
+  std::vector<Task> tasks;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(TaskGroup);
+};
+
+/*!\rst
+  Chase-Lev work-stealing deque of Task pointers (lock-free; growable circular array).  Push() and Pop() may only be
+  called by the owning worker; Steal() may be called by any thread.  Memory orderings follow Figure 1 of Le et al.
+  (PPoPP 2013), "Correct and Efficient Work-Stealing for Weak Memory Models."
+
+  Arrays replaced when growing may still be read by in-flight Steal() calls, so they are only freed by Reclaim(), which
+  must be called while no other thread uses the deque.
+\endrst*/
+class WorkStealingTaskPool::TaskDeque final {
+ public:
+  TaskDeque() : top_(0), bottom_(0), array_(nullptr), arrays_() {
+    arrays_.emplace_back(new Array(kInitialCapacity));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  //! owner only: pushes task onto the bottom
+  void Push(Task * task) {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    Array * array = array_.load(std::memory_order_relaxed);
+    if (unlikely(bottom - top > array->capacity - 1)) {
+      array = Grow(array, top, bottom);
+    }
+    array->Put(bottom, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  //! owner only: \return the task at the bottom (most recently pushed), or nullptr if empty
+  Task * Pop() {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array * array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+
+    Task * task = nullptr;
+    if (likely(top <= bottom)) {
+      task = array->Get(bottom);
+      if (top == bottom) {
+        // last task: race against thieves for it
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          task = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  //! any thread: \return the task at the top (least recently pushed), or nullptr if empty or if another thief won the race
+  Task * Steal() {
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top < bottom) {
+      Array * array = array_.load(std::memory_order_acquire);
+      Task * task = array->Get(top);
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      return task;
+    }
+    return nullptr;
+  }
+
+  //! frees all but the current array; only call when no other thread can access this deque
+  void Reclaim() {
+    if (arrays_.size() > 1) {
+      std::unique_ptr<Array> current(std::move(arrays_.back()));
+      arrays_.clear();
+      arrays_.push_back(std::move(current));
+    }
+  }
+
+  OL_DISALLOW_COPY_AND_ASSIGN(TaskDeque);
+
+ private:
+  //! initial number of slots; must be a power of 2
+  static constexpr std::int64_t kInitialCapacity = 64;
+
+  //! circular array of task pointers; capacity is a power of 2
+  struct Array final {
+    explicit Array(std::int64_t capacity_in) : capacity(capacity_in), slots(new std::atomic<Task *>[capacity_in]) {
+    }
+
+    Task * Get(std::int64_t i) const noexcept {
+      return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    void Put(std::int64_t i, Task * task) noexcept {
+      slots[i & (capacity - 1)].store(task, std::memory_order_relaxed);
+    }
+
+    const std::int64_t capacity;
+    std::unique_ptr<std::atomic<Task *>[]> slots;
+  };
+
+  //! owner only: replaces array with one of twice the capacity holding the same tasks; \return the new array
+  Array * Grow(Array * array, std::int64_t top, std::int64_t bottom) {
+    arrays_.emplace_back(new Array(2*array->capacity));
+    Array * new_array = arrays_.back().get();
+    for (std::int64_t i = top; i < bottom; ++i) {
+      new_array->Put(i, array->Get(i));
+    }
+    array_.store(new_array, std::memory_order_release);
+    return new_array;
+  }
+
+  //! index of the next task to steal
+  std::atomic<std::int64_t> top_;
+  //! index one past the most recently pushed task
+  std::atomic<std::int64_t> bottom_;
+  //! current array
+  std::atomic<Array *> array_;
+  //! every array allocated since the last Reclaim() (the current one is last)
+  std::vector<std::unique_ptr<Array> > arrays_;
+};
+
+//! per-worker state
+struct WorkStealingTaskPool::Worker final {
+  explicit Worker(int worker_id) : current_level(-1), random_state(2654435761u*static_cast<std::uint32_t>(worker_id + 1)) {
+  }
+
+  //! \return next value of a xorshift32 generator (for picking steal victims)
+  std::uint32_t NextRandom() noexcept {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+  }
+
+  //! one deque per nesting level
+  TaskDeque deques[kNumLevels];
+  //! level of the task this worker is running (-1 if none)
+  int current_level;
+  //! xorshift32 state; never 0
+  std::uint32_t random_state;
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(Worker);
+};
+
+WorkStealingTaskPool::WorkStealingTaskPool(int max_num_workers)
+    : max_num_workers_(max_num_workers > 0 ? max_num_workers : omp_get_num_procs()),
+      num_active_workers_(0),
+      workers_(),
+      num_steals_(0) {
+  workers_.reserve(max_num_workers_);
+  for (int i = 0; i < max_num_workers_; ++i) {
+    workers_.emplace_back(new Worker(i));
+  }
+}
+
+WorkStealingTaskPool::~WorkStealingTaskPool() = default;
+
+void WorkStealingTaskPool::Execute(Task * task, int worker_id) {
+  Worker& worker = *workers_[worker_id];
+  TaskGroup * group = task->group;
+  const int saved_level = worker.current_level;
+  worker.current_level = group->level;
+  // exceptions cannot leave OpenMP parallel regions; capture the first one for the spawning call to rethrow
+  try {
+    (*group->body)(task->index, worker_id);
+  } catch (...) {
+    std::call_once(group->exception_capture_flag, [group]() {
+        group->captured_exception = std::current_exception();
+      });
+  }
+  worker.current_level = saved_level;
+  // do not touch group after this: the joining worker may destroy it as soon as remaining hits 0
+  group->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool WorkStealingTaskPool::RunOneTask(int worker_id, int min_level) {
+  Worker& worker = *workers_[worker_id];
+  // own work first, deepest level first (finishing nested work unblocks the tasks waiting on it)
+  for (int level = kNumLevels - 1; level >= min_level; --level) {
+    Task * task = worker.deques[level].Pop();
+    if (task != nullptr) {
+      Execute(task, worker_id);
+      return true;
+    }
+  }
+
+  const int num_workers = num_active_workers_.load(std::memory_order_relaxed);
+  for (int level = kNumLevels - 1; level >= min_level; --level) {
+    const int first_victim = worker.NextRandom() % num_workers;
+    for (int k = 0; k < num_workers; ++k) {
+      const int victim = (first_victim + k) % num_workers;
+      if (victim == worker_id) {
+        continue;
+      }
+      Task * task = workers_[victim]->deques[level].Steal();
+      if (task != nullptr) {
+        num_steals_.fetch_add(1, std::memory_order_relaxed);
+        Execute(task, worker_id);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void WorkStealingTaskPool::ParallelFor(int num_tasks, const TaskBody& body) {
+  if (unlikely(num_tasks <= 0)) {
+    return;
+  }
+  // no other thread is using the deques now
+  for (auto& worker : workers_) {
+    for (auto& deque : worker->deques) {
+      deque.Reclaim();
+    }
+  }
+
+  TaskGroup group(&body, 0, num_tasks);
+#pragma omp parallel num_threads(max_num_workers_)
+  {
+    const int worker_id = omp_get_thread_num();
+    const int num_workers = omp_get_num_threads();
+#pragma omp single
+    {
+      num_active_workers_.store(num_workers, std::memory_order_relaxed);
+    }  // implicit barrier: every worker sees num_active_workers_
+
+    // seed each worker with a contiguous block of tasks, pushed in reverse so the owner pops them in order
+    const int begin = static_cast<std::int64_t>(num_tasks)*worker_id/num_workers;
+    const int end = static_cast<std::int64_t>(num_tasks)*(worker_id + 1)/num_workers;
+    for (int i = end - 1; i >= begin; --i) {
+      workers_[worker_id]->deques[0].Push(&group.tasks[i]);
+    }
+
+    while (group.remaining.load(std::memory_order_acquire) > 0) {
+      if (!RunOneTask(worker_id, 0)) {
+        std::this_thread::yield();
+      }
+    }
+  }  // end omp parallel region
+  num_active_workers_.store(0, std::memory_order_relaxed);
+
+  if (group.captured_exception != nullptr) {
+    // rethrowing nullptr is illegal
+    std::rethrow_exception(group.captured_exception);
+  }
+}
+
+void WorkStealingTaskPool::NestedParallelFor(int worker_id, int num_tasks, const TaskBody& body) {
+  const bool inline_loop = num_active_workers_.load(std::memory_order_relaxed) == 0 || worker_id < 0 ||
+      worker_id >= max_num_workers_ || workers_[worker_id]->current_level < 0 ||
+      workers_[worker_id]->current_level + 1 >= kNumLevels;
+  if (inline_loop) {
+    for (int i = 0; i < num_tasks; ++i) {
+      body(i, worker_id);
+    }
+    return;
+  }
+  if (unlikely(num_tasks <= 0)) {
+    return;
+  }
+
+  const int level = workers_[worker_id]->current_level + 1;
+  TaskGroup group(&body, level, num_tasks);
+  for (int i = num_tasks - 1; i >= 0; --i) {
+    workers_[worker_id]->deques[level].Push(&group.tasks[i]);
+  }
+  // help until all subtasks are done, but never start a shallower task: this worker's current task is suspended
+  while (group.remaining.load(std::memory_order_acquire) > 0) {
+    if (!RunOneTask(worker_id, level)) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (group.captured_exception != nullptr) {
+    std::rethrow_exception(group.captured_exception);
+  }
+}
+
+}  // end namespace optimal_learning
@@ -0,0 +1,151 @@
+/*!
+  \file gpp_task_pool.hpp
+  \rst
+  This file contains WorkStealingTaskPool, a work-stealing scheduler for (possibly nested) parallel loops whose iterations
+  have wildly different costs.
+
+  ``#pragma omp for schedule(...)`` must decide up front (static) or with a shared counter (dynamic, guided) which thread
+  runs which iterations.  Multistart optimization is a bad fit: a Newton run that hits a singular Hessian stops almost
+  immediately while a gradient descent run that uses all of its restarts can take 100x longer, so static and guided
+  schedules leave threads idle, and dynamic contends on one counter.  It also cannot split a single expensive iteration
+  over threads that have run out of work.
+
+  WorkStealingTaskPool runs the iterations of a loop as tasks:
+
+  1. Each worker owns a Chase-Lev deque (Chase & Lev, SPAA 2005; memory orderings from Le, Pop, Cohen, Zappa Nardelli,
+     PPoPP 2013) per nesting level.  The owner pushes/pops tasks at the bottom without locks (a CAS is only needed to take
+     the last task); other workers steal from the top.  Tasks start out split evenly over the workers, in contiguous blocks.
+  2. A worker whose deques are empty steals from a randomly chosen victim, so work flows to idle workers only when needed.
+  3. A running task may call NestedParallelFor() to split its own work (e.g., Monte Carlo iterations) into subtasks.  Its
+     worker pushes them onto its nested-level deque and helps run them; idle workers steal them, preferring nested work
+     over starting new top-level tasks (so the expensive task finishes sooner).  While joining, a worker only runs tasks
+     of the nested level, so it never starts a second top-level task on top of the suspended one.  Per-worker resources
+     (e.g., one state object per worker) indexed by ``worker_id`` are therefore safe to use at each level: one for the
+     top-level tasks and a separate one for the nested tasks.
+
+  Workers are the threads of an OpenMP parallel region (opened by ParallelFor()); OpenMP keeps them alive between calls.
+  There are kNumLevels levels: top-level tasks and one level of nested subtasks.  NestedParallelFor() called from a
+  nested subtask (or outside of ParallelFor()) runs its loop inline on the calling thread.
+
+  Exceptions thrown by tasks are captured (the first one, temporally); the remaining tasks still run, and the exception
+  is rethrown by the ParallelFor() or NestedParallelFor() call that spawned the task once all of its tasks are done.
+
+  .. WARNING:: a WorkStealingTaskPool is NOT THREAD-SAFE: do not call ParallelFor() on the same pool from multiple threads
+    at once.  NestedParallelFor() may only be called by tasks of the pool (with their ``worker_id``).
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_TASK_POOL_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_TASK_POOL_HPP_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  Work-stealing scheduler for parallel loops of unevenly sized iterations; see file comments for details.
+
+  Usage::
+
+    WorkStealingTaskPool task_pool(max_num_workers);
+    std::vector<State> states(task_pool.max_num_workers());  // one per worker
+    task_pool.ParallelFor(num_starts, [&](int i, int worker_id) {
+        DoStart(i, &states[worker_id]);  // may call task_pool.NestedParallelFor(worker_id, ...)
+      });
+\endrst*/
+class WorkStealingTaskPool final {
+ public:
+  //! loop body: ``body(index, worker_id)`` with ``0 <= index < num_tasks`` and ``0 <= worker_id < max_num_workers()``
+  using TaskBody = std::function<void(int, int)>;
+
+  //! number of nesting levels: top-level tasks (level 0) and their subtasks (level 1)
+  static constexpr int kNumLevels = 2;
+
+  /*!\rst
+    Builds a pool for up to ``max_num_workers`` workers (threads).
+
+    \param
+      :max_num_workers: maximum number of workers; 0 means ``omp_get_num_procs()``
+  \endrst*/
+  explicit WorkStealingTaskPool(int max_num_workers);
+
+  ~WorkStealingTaskPool();
+
+  //! \return the maximum number of workers, i.e., the bound on ``worker_id`` (size per-worker resources accordingly)
+  int max_num_workers() const noexcept OL_PURE_FUNCTION OL_WARN_UNUSED_RESULT {
+    return max_num_workers_;
+  }
+
+  //! \return total number of tasks stolen (run by a worker other than the one they were pushed to) over the pool's life
+  int num_steals() const noexcept OL_WARN_UNUSED_RESULT {
+    return num_steals_.load(std::memory_order_relaxed);
+  }
+
+  /*!\rst
+    Runs ``body(i, worker_id)`` for each ``i`` in ``[0, num_tasks)`` on up to max_num_workers() threads, using work stealing
+    to balance the load.  Returns once every task (and all of their nested subtasks) completed.
+
+    \param
+      :num_tasks: number of loop iterations
+      :body: loop body; see TaskBody
+    \raise
+      the first exception thrown by any task (all other tasks still run)
+  \endrst*/
+  void ParallelFor(int num_tasks, const TaskBody& body);
+
+  /*!\rst
+    Called by a running task to split its work: runs ``body(i, worker_id')`` for each ``i`` in ``[0, num_tasks)``, sharing
+    the subtasks with idle workers.  The calling worker helps and returns once all subtasks completed.  ``worker_id'`` is
+    the id of the worker running each subtask; it may differ from ``worker_id``.
+
+    Runs the loop inline (with ``worker_id`` for every subtask) if called from a nested subtask or outside of ParallelFor().
+
+    \param
+      :worker_id: the ``worker_id`` passed to the calling task
+      :num_tasks: number of loop iterations
+      :body: loop body; see TaskBody
+    \raise
+      the first exception thrown by any subtask (all other subtasks still run)
+  \endrst*/
+  void NestedParallelFor(int worker_id, int num_tasks, const TaskBody& body);
+
+  OL_DISALLOW_DEFAULT_AND_COPY_AND_ASSIGN(WorkStealingTaskPool);
+
+ private:
+  struct Task;
+  struct TaskGroup;
+  class TaskDeque;
+  struct Worker;
+
+  /*!\rst
+    Runs (at most) one task of level ``min_level`` or deeper: the deepest available task from the worker's own deques,
+    else one stolen from another worker.
+
+    \param
+      :worker_id: id of the calling worker
+      :min_level: shallowest level of tasks to run
+    \return
+      true if a task was run
+  \endrst*/
+  bool RunOneTask(int worker_id, int min_level);
+
+  //! runs task on worker worker_id and marks it complete (capturing any exception into its group)
+  void Execute(Task * task, int worker_id) OL_NONNULL_POINTERS;
+
+  //! maximum number of workers
+  int max_num_workers_;
+  //! number of workers in the currently running ParallelFor() (0 if none)
+  std::atomic<int> num_active_workers_;
+  //! per-worker deques and bookkeeping
+  std::vector<std::unique_ptr<Worker> > workers_;
+  //! number of successful steals
+  std::atomic<int> num_steals_;
+};
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_TASK_POOL_HPP_
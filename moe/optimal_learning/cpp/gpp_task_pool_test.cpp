@@ -0,0 +1,245 @@
+/*!
+  \file gpp_task_pool_test.cpp
+  \rst
+  This file contains functions for testing WorkStealingTaskPool in gpp_task_pool.hpp.
+\endrst*/
+
+#include "gpp_task_pool_test.hpp"
+
+#include <cmath>
+
+#include <vector>
+
+#include "gpp_common.hpp"
+#include "gpp_exception.hpp"
+#include "gpp_logging.hpp"
+#include "gpp_task_pool.hpp"
+#include "gpp_test_utils.hpp"
+
+namespace optimal_learning {
+
+namespace {  // tests of WorkStealingTaskPool
+
+/*!\rst
+  Does an amount of busywork that varies by 100x with index, to create load imbalance.
+
+  \param
+    :index: task index
+  \return
+    a value that depends only on index
+\endrst*/
+OL_WARN_UNUSED_RESULT double UnevenWork(int index) {
+  const int num_iterations = (index % 13 == 0) ? 20000 : 200;
+  double result = 0.0;
+  for (int i = 0; i < num_iterations; ++i) {
+    result += std::sin(static_cast<double>(index + i));
+  }
+  return result;
+}
+
+/*!\rst
+  Checks that every task of a parallel loop runs exactly once, with a valid worker_id and the right result, for loops of
+  uneven tasks that are large enough to grow the deques, over repeated calls on the same pool.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int WorkStealingParallelForTest() {
+  const int max_num_workers = 4;
+  WorkStealingTaskPool task_pool(max_num_workers);
+  int total_errors = 0;
+
+  for (int num_tasks : {1, 3, 1000, 5000}) {
+    std::vector<int> num_runs(num_tasks, 0);
+    std::vector<int> worker_ids(num_tasks, -1);
+    std::vector<double> results(num_tasks, 0.0);
+    task_pool.ParallelFor(num_tasks, [&](int i, int worker_id) {
+        ++num_runs[i];
+        worker_ids[i] = worker_id;
+        results[i] = UnevenWork(i);
+      });
+
+    for (int i = 0; i < num_tasks; ++i) {
+      if (num_runs[i] != 1 || worker_ids[i] < 0 || worker_ids[i] >= task_pool.max_num_workers() ||
+          !CheckDoubleWithinRelative(results[i], UnevenWork(i), 0.0)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // empty loops do nothing
+  task_pool.ParallelFor(0, [&total_errors](int OL_UNUSED(i), int OL_UNUSED(worker_id)) {
+      ++total_errors;
+    });
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks nested loops: every subtask runs exactly once, each outer task sees all of its subtasks complete when
+  NestedParallelFor() returns, and per-worker resources of each level are never used by two tasks at once (i.e., a
+  worker that is joining its subtasks never starts another outer task).  Also checks that NestedParallelFor() runs inline
+  outside of ParallelFor().
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int WorkStealingNestedParallelForTest() {
+  const int max_num_workers = 4;
+  const int num_outer_tasks = 64;
+  const int num_inner_tasks = 50;
+  WorkStealingTaskPool task_pool(max_num_workers);
+  int total_errors = 0;
+
+  // per-worker "resource in use" flags, one set per level; each is only touched by its own worker
+  std::vector<int> outer_in_use(max_num_workers, 0);
+  std::vector<int> inner_in_use(max_num_workers, 0);
+  std::vector<int> num_inner_runs(num_outer_tasks*num_inner_tasks, 0);
+  std::vector<int> outer_errors(num_outer_tasks, 0);
+  std::vector<int> inner_errors(num_outer_tasks*num_inner_tasks, 0);
+  std::vector<double> inner_results(num_outer_tasks*num_inner_tasks, 0.0);
+
+  task_pool.ParallelFor(num_outer_tasks, [&](int i, int worker_id) {
+      if (outer_in_use[worker_id] != 0) {
+        ++outer_errors[i];
+      }
+      outer_in_use[worker_id] = 1;
+
+      task_pool.NestedParallelFor(worker_id, num_inner_tasks, [&, i](int j, int inner_worker_id) {
+          if (inner_in_use[inner_worker_id] != 0) {
+            ++inner_errors[i*num_inner_tasks + j];
+          }
+          inner_in_use[inner_worker_id] = 1;
+          ++num_inner_runs[i*num_inner_tasks + j];
+          inner_results[i*num_inner_tasks + j] = UnevenWork(i + j);
+          inner_in_use[inner_worker_id] = 0;
+        });
+
+      // all subtasks are done once NestedParallelFor() returns
+      for (int j = 0; j < num_inner_tasks; ++j) {
+        if (num_inner_runs[i*num_inner_tasks + j] != 1) {
+          ++outer_errors[i];
+        }
+      }
+      outer_in_use[worker_id] = 0;
+    });
+
+  for (const auto& error : outer_errors) {
+    total_errors += error;
+  }
+  for (const auto& error : inner_errors) {
+    total_errors += error;
+  }
+  for (int i = 0; i < num_outer_tasks; ++i) {
+    for (int j = 0; j < num_inner_tasks; ++j) {
+      if (!CheckDoubleWithinRelative(inner_results[i*num_inner_tasks + j], UnevenWork(i + j), 0.0)) {
+        ++total_errors;
+      }
+    }
+  }
+
+  // outside of ParallelFor(), the loop runs inline with the caller's worker_id
+  std::vector<int> inline_worker_ids;
+  task_pool.NestedParallelFor(2, 5, [&inline_worker_ids](int i, int worker_id) {
+      inline_worker_ids.push_back(i*10 + worker_id);
+    });
+  if (inline_worker_ids != std::vector<int>({2, 12, 22, 32, 42})) {
+    ++total_errors;
+  }
+
+  return total_errors;
+}
+
+/*!\rst
+  Checks that an exception thrown by a task (top-level or nested) is rethrown by the call that spawned it, after every
+  other task ran.
+
+  \return
+    number of test failures
+\endrst*/
+OL_WARN_UNUSED_RESULT int WorkStealingExceptionTest() {
+  const int max_num_workers = 4;
+  const int num_tasks = 200;
+  const int bad_index = 17;
+  WorkStealingTaskPool task_pool(max_num_workers);
+  int total_errors = 0;
+
+  std::vector<int> num_runs(num_tasks, 0);
+  try {
+    // increment errors: we must catch an exception to decrement
+    total_errors += 1;
+    task_pool.ParallelFor(num_tasks, [&](int i, int OL_UNUSED(worker_id)) {
+        ++num_runs[i];
+        if (i == bad_index) {
+          OL_THROW_EXCEPTION(InvalidValueException<int>, "WorkStealingTaskPool test.", i, -1);
+        }
+      });
+  } catch (const InvalidValueException<int>& except) {
+    if (except.value() != bad_index) {
+      ++total_errors;
+    }
+    // exception occurred, good! remove the increment from the try block.
+    total_errors -= 1;
+  }
+  for (const auto& runs : num_runs) {
+    if (runs != 1) {
+      ++total_errors;
+    }
+  }
+
+  // nested: the outer task sees the exception from its subtask
+  std::vector<int> caught(num_tasks, 0);
+  task_pool.ParallelFor(num_tasks, [&](int i, int worker_id) {
+      try {
+        task_pool.NestedParallelFor(worker_id, 10, [i](int j, int OL_UNUSED(inner_worker_id)) {
+            if (j == i % 10) {
+              OL_THROW_EXCEPTION(InvalidValueException<int>, "WorkStealingTaskPool nested test.", j, -1);
+            }
+          });
+      } catch (const InvalidValueException<int>& except) {
+        caught[i] = (except.value() == i % 10);
+      }
+    });
+  for (const auto& flag : caught) {
+    if (flag != 1) {
+      ++total_errors;
+    }
+  }
+
+  return total_errors;
+}
+
+}  // end unnamed namespace
+
+int RunTaskPoolTests() {
+  int total_errors = 0;
+  int current_errors = 0;
+
+  current_errors = WorkStealingParallelForTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("WorkStealingTaskPool parallel for failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = WorkStealingNestedParallelForTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("WorkStealingTaskPool nested parallel for failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  current_errors = WorkStealingExceptionTest();
+  if (current_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("WorkStealingTaskPool exception handling failed with %d errors\n", current_errors);
+  }
+  total_errors += current_errors;
+
+  if (total_errors != 0) {
+    OL_PARTIAL_FAILURE_PRINTF("task pool tests failed with %d errors\n", total_errors);
+  } else {
+    OL_PARTIAL_SUCCESS_PRINTF("task pool tests passed\n");
+  }
+
+  return total_errors;
+}
+
+}  // end namespace optimal_learning
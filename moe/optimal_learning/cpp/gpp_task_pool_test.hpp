@@ -0,0 +1,29 @@
+/*!
+  \file gpp_task_pool_test.hpp
+  \rst
+  Tests for gpp_task_pool.hpp: the WorkStealingTaskPool scheduler.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_TASK_POOL_TEST_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_TASK_POOL_TEST_HPP_
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  Checks that WorkStealingTaskPool is working:
+
+  * every task of (repeated, uneven, large) parallel loops runs exactly once with a valid worker_id
+  * nested loops run every subtask, and a worker never starts a second task of a level while one is suspended
+  * exceptions thrown by tasks are rethrown after all other tasks ran
+  * NestedParallelFor() outside of ParallelFor() runs inline
+
+  \return
+    number of test failures: 0 if WorkStealingTaskPool is working properly
+\endrst*/
+OL_WARN_UNUSED_RESULT int RunTaskPoolTests();
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_TASK_POOL_TEST_HPP_
@@ -129,6 +129,30 @@ void MockGaussianProcessPriorData<DomainType>::InitializeGaussianProcess(Uniform
 template struct MockGaussianProcessPriorData<TensorProductDomain>;
 template struct MockGaussianProcessPriorData<SimplexIntersectTensorProductDomain>;
 
+RandomGaussianProcessData::RandomGaussianProcessData(int dim_in, int num_sampled_in, int num_to_sample_in, int num_being_sampled_in, double noise_variance_in, const boost::uniform_real<double>& uniform_double, UniformRandomGenerator * uniform_generator)
+    : dim(dim_in),
+      num_sampled(num_sampled_in),
+      num_to_sample(num_to_sample_in),
+      num_being_sampled(num_being_sampled_in),
+      points_sampled(dim*num_sampled),
+      points_sampled_value(num_sampled),
+      noise_variance(num_sampled, noise_variance_in),
+      points_to_sample(dim*num_to_sample),
+      points_being_sampled(dim*num_being_sampled) {
+  for (auto& entry : points_sampled) {
+    entry = uniform_double(uniform_generator->engine);
+  }
+  for (auto& entry : points_sampled_value) {
+    entry = uniform_double(uniform_generator->engine);
+  }
+  for (auto& entry : points_to_sample) {
+    entry = uniform_double(uniform_generator->engine);
+  }
+  for (auto& entry : points_being_sampled) {
+    entry = uniform_double(uniform_generator->engine);
+  }
+}
+
 bool CheckIntEquals(int64_t value, int64_t truth) noexcept {
   bool passed = value == truth;
 
@@ -12,7 +12,8 @@
 
   There's also a mock environment class that sets up quantities commonly needed by tests of GP functionality.
   Similarly, there is a mock data class that builds up "history" (points_sampled, points_sampled_value) by
-  constructing a GP with random hyperparameters on a random domain.
+  constructing a GP with random hyperparameters on a random domain, and a simpler one that draws all of its data
+  uniformly at random.
 \endrst*/
 
 #ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_TEST_UTILS_HPP_
@@ -381,6 +382,50 @@ struct MockGaussianProcessPriorData {
 extern template struct MockGaussianProcessPriorData<TensorProductDomain>;
 extern template struct MockGaussianProcessPriorData<SimplexIntersectTensorProductDomain>;
 
+/*!\rst
+  Struct holding random (not GP-distributed; see MockGaussianProcessPriorData for that) data for tests that just need *some*
+  GP and some points to evaluate it at: every coordinate/value of ``points_sampled``, ``points_sampled_value``, ``points_to_sample``,
+  and ``points_being_sampled`` is an IID draw from ``uniform_double``, made in that order.  The noise variance is constant.
+\endrst*/
+struct RandomGaussianProcessData {
+  /*!\rst
+    Allocates and fills all fields.
+
+    \param
+      :dim: the spatial dimension of a point (i.e., number of independent params in experiment)
+      :num_sampled: number of already-sampled points
+      :num_to_sample: number of points to be sampled in future experiments
+      :num_being_sampled: number of points being sampled concurrently
+      :noise_variance: the ``\sigma_n^2`` (noise variance) associated w/every observation
+      :uniform_double: ``[min, max]`` range from which to draw coordinates and values
+      :uniform_generator[1]: a UniformRandomGenerator object providing the random engine for uniform random numbers
+    \output
+      :uniform_generator[1]: UniformRandomGenerator object will have its state changed due to
+        ``(dim + 1)*num_sampled + dim*(num_to_sample + num_being_sampled)`` random draws
+  \endrst*/
+  RandomGaussianProcessData(int dim_in, int num_sampled_in, int num_to_sample_in, int num_being_sampled_in, double noise_variance_in, const boost::uniform_real<double>& uniform_double, UniformRandomGenerator * uniform_generator);
+
+  //! spatial dimension (e.g., entries per point of points_sampled)
+  int dim;
+  //! number of points in points_sampled (history)
+  int num_sampled;
+  //! number of points to be sampled in future experiments (i.e., the q in q,p-EI)
+  int num_to_sample;
+  //! number of points currently being sampled (i.e., the p in q,p-EI)
+  int num_being_sampled;
+
+  //! coordinates of already-sampled points, ``X``
+  std::vector<double> points_sampled;
+  //! function values at points_sampled, ``y``
+  std::vector<double> points_sampled_value;
+  //! ``\sigma_n^2``, the noise variance
+  std::vector<double> noise_variance;
+  //! points to be sampled in experiments (i.e., the q in q,p-EI)
+  std::vector<double> points_to_sample;
+  //! points being sampled in concurrent experiments (i.e., the p in q,p-EI)
+  std::vector<double> points_being_sampled;
+};
+
 /*!\rst
   Checks if ``|value - truth| == 0``
 
@@ -0,0 +1,142 @@
+/*!
+  \file gpp_thread_schedule.hpp
+  \rst
+  This file contains ThreadSchedule, which specifies how OpenMP distributes loop iterations (number of threads, schedule
+  type, chunk size).  It is used by the multistart optimizers (gpp_optimization.hpp) and by the multithreaded linear
+  algebra kernels (gpp_linear_algebra.hpp), so it lives in its own header with no dependencies beyond OpenMP.
+\endrst*/
+
+#ifndef MOE_OPTIMAL_LEARNING_CPP_GPP_THREAD_SCHEDULE_HPP_
+#define MOE_OPTIMAL_LEARNING_CPP_GPP_THREAD_SCHEDULE_HPP_
+
+#include <omp.h>  // NOLINT(build/include_order)
+
+#include "gpp_common.hpp"
+
+namespace optimal_learning {
+
+/*!\rst
+  **Overview**
+
+  When we ask openmp to parallelize a for loop, we can give it additional information on how to
+  distribute the work. In particular, the overall work (N iterations) needs to be divided up amongst
+  the threads. We have two major ways to affect how openmp structures the loop:
+  ``schedule`` and ``chunk_size``.
+
+  ``chunk_size`` changes meaning depending on ``schedule``. Here we list out the options for
+  ``schedule`` as ``name (ENV_NAME, enum_name)`` where ``ENV_NAME`` is the corresponding value
+  of ``OMP_SCHEDULE`` (not used by ``optimal_learning``) and ``enum_name`` is the corresponding
+  type from ``opm_sched_t`` in ``omp.h``. Below, "work" refers to loop iterations (``N`` total).
+
+  **Schedule Types**
+
+  a. static ("static", omp_sched_static):
+
+     Work is divided into ``N/chunk_size`` *contiguous* chunks (of ``chunk_size`` iterations) and
+     distributed amongst the threads statically in a round-robin fashion. Use when you are
+     confident all chunks will take the same amount of time.
+
+     Low control overhead but high waste if one iteration is very slow (since the other
+     threads will sit idle).
+
+     Default ``chunk_size``: ``N / number_of_threads``.
+
+     This schedule type is *repeatable*: repeated runs/calls (with the same work) will produce the
+     same mapping of loop iterations to threads every time.
+
+  b. dynamic ("dynamic", omp_sched_dynamic):
+
+     Work is divided into ``N/chunk_size`` *contiguous* chunks (of ``chunk_size`` iterations) and
+     distributed to threads as they complete their work, first-come first-serve. If there is
+     a chunk that is very slow, the other threads can finish all remaining work instead of
+     sitting idle.
+
+     High control overhead, use when you have no idea how long each chunk will take.
+
+     Default ``chunk_size``: 1.
+
+     This schedule type does not produce repeatable mappings of iterations to threads.
+
+  c. guided ("guided", omp_sched_guided):
+
+     Work is divided into progressively smaller chunks; ``chunk_size`` sets the minimum value.
+     As with dynamic, chunks are assigned on a first-come, first-serve basis.  Less overhead than
+     dynamic (b/c ``chunk_size`` scale down).
+
+     Useful when iteration times are similar but not identical.  Less overhead than dynamic while
+     guaranteeing the waste case of static doesn't arise.
+
+     Default ``chunk_size``: approximately ``N / number_of_threads``.
+
+     This schedule type does not produce repeatable mappings of iterations to threads.
+
+  d. auto ("auto", omp_sched_auto):
+
+     The compiler decides how to map iterations to threads; this mapping is not required
+     to be one of the previous choices.
+
+     chunk_size has *no meaning* when the schedule is auto.
+     See: https://gcc.gnu.org/onlinedocs/libgomp/omp_005fset_005fschedule.html
+
+     This schedule type is not guaranteed to be repeatable.
+
+  Further documentation:
+  http://openmp.org/mp-documents/OpenMP3.1-CCard.pdf
+  https://software.intel.com/en-us/articles/openmp-loop-scheduling
+  http://publib.boulder.ibm.com/infocenter/comphelp/v8v101/index.jsp?topic=%2Fcom.ibm.xlcpp8a.doc%2Fcompiler%2Fref%2Fruompfor.htm
+\endrst*/
+struct ThreadSchedule {
+  /*!\rst
+    Construct a ThreadSchedule using the specified number of threads, schedule type, and chunk_size.
+
+    \param
+      :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
+      :schedule: static, dynamic, guided, or auto. See class comments for more details.
+      :chunk_size: how to distribute work to threads; the precise meaning depends on schedule.
+        Zero or negative chunk_size ask OpenMP to use its default behavior. See class comments for details.
+  \endrst*/
+  ThreadSchedule(int max_num_threads_in, omp_sched_t schedule_in, int chunk_size_in)
+      : max_num_threads(max_num_threads_in), schedule(schedule_in), chunk_size(chunk_size_in) {
+  }
+
+  /*!\rst
+    Construct a ThreadSchedule using the specified number of threads and schedule type with default chunk_size.
+
+    \param
+      :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
+      :schedule: static, dynamic, guided, or auto. See class comments for more details.
+  \endrst*/
+  ThreadSchedule(int max_num_threads_in, omp_sched_t schedule_in) : ThreadSchedule(max_num_threads_in, schedule_in, 0) {
+  }
+
+  /*!\rst
+    Construct a ThreadSchedule using the specified number of threads with default schedule type and chunk_size.
+
+    \param
+      :max_num_threads: maximum number of threads for use by OpenMP (generally should be <= # cores)
+  \endrst*/
+  explicit ThreadSchedule(int max_num_threads_in) : ThreadSchedule(max_num_threads_in, omp_sched_auto) {
+  }
+
+  /*!\rst
+    Construct a ThreadSchedule using the default number of threads, schedule type, and chunk_size.
+  \endrst*/
+  ThreadSchedule() : ThreadSchedule(0) {
+  }
+
+  //! The maximum number of threads for use by OpenMP (generally should be <= # cores).
+  //! The (default) value of 0 results in omp_get_num_procs() threads; note that this
+  //! is limited by omp_get_thread_limit() (set in OMP_THREAD_LIMIT).
+  int max_num_threads;
+
+  //! The thread schedule to use: static, dynamic, guided, or auto. See class comments for more details.
+  omp_sched_t schedule;
+
+  //! Chunk size to use when distributing work to threads; the precise meaning depends on schedule.
+  //! Zero or negative chunk_size ask OpenMP to use its default behavior. See class comments for details.
+  int chunk_size;
+};
+
+}  // end namespace optimal_learning
+
+#endif  // MOE_OPTIMAL_LEARNING_CPP_GPP_THREAD_SCHEDULE_HPP_
@@ -12,6 +12,13 @@ DEFAULT_MAX_NUM_THREADS = 4
 #: TODO(GH-301): make this a server configurable value or set appropriate openmp env var
 MAX_ALLOWED_NUM_THREADS = 10000
 
+# Model cache constants
+#: Default memory budget (in bytes) of the process-wide cache of fitted C++ GaussianProcess models
+#: (see ``GPP.GaussianProcessCache``); 64 MiB holds one model with ~2800 sampled points or many smaller ones.
+#: Change it with :func:`moe.optimal_learning.python.cpp_wrappers.gaussian_process.set_gaussian_process_cache_memory_budget`
+#: or, for the REST server, with the ``gaussian_process_cache.memory_budget`` setting in the ``[app:MOE]`` section of the ini file.
+DEFAULT_GAUSSIAN_PROCESS_CACHE_MEMORY_BUDGET = 1 << 26
+
 # Covariance type names
 SQUARE_EXPONENTIAL_COVARIANCE_TYPE = 'square_exponential'
 
@@ -17,6 +17,20 @@ def cppify(array):
     return list(numpy.ravel(array))
 
 
+def cppify_buffer(array):
+    """Make a C-contiguous float64 array that C++ can read in place (no list copy; see PythonBufferView in gpp_python_common.hpp).
+
+    Returns ``array`` itself when it is already a C-contiguous float64 ndarray.
+
+    :param array: array to convert
+    :type array: array-like (e.g., ndarray, list, etc.) of float64
+    :return: C-contiguous array with the same contents (and shape) as ``array``
+    :rtype: array of float64
+
+    """
+    return numpy.ascontiguousarray(array, dtype=numpy.float64)
+
+
 def uncppify(array, expected_shape):
     """Reshape a copy of the input array into the expected shape.
 
@@ -28,10 +28,13 @@ def multistart_expected_improvement_optimization(
         randomness=None,
         max_num_threads=DEFAULT_MAX_NUM_THREADS,
         status=None,
+        integration_type=None,
+        evaluation_type=None,
 ):
     """Solve the q,p-EI problem, returning the optimal set of q points to sample CONCURRENTLY in future experiments.
 
     When ``points_being_sampled.size == 0 && num_to_sample == 1``, this function will use (fast) analytic EI computations.
+    Other q,p-EI with ``q + p <= 4`` is computed analytically too unless monte-carlo is requested (see ``evaluation_type``).
 
     .. NOTE:: The following comments are copied from gpp_math.hpp, ComputeOptimalPointsToSample().
       These comments are copied into
@@ -54,7 +57,7 @@ def multistart_expected_improvement_optimization(
     The option of using GPU to compute general q,p-EI via MC simulation is also available. To enable it, make sure you have
     installed GPU components of MOE, otherwise, it will throw Runtime excpetion.
 
-    :param ei_optimizer: object that optimizes (e.g., gradient descent, newton) EI over a domain
+    :param ei_optimizer: object that optimizes (null, gradient descent, or L-BFGS; L-BFGS needs a tensor product domain) EI over a domain
     :type ei_optimizer: cpp_wrappers.optimization.*Optimizer object
     :param num_multistarts: number of times to multistart ``ei_optimizer`` (UNUSED, data is in ei_optimizer.optimizer_parameters)
     :type num_multistarts: int > 0
@@ -70,6 +73,14 @@ def multistart_expected_improvement_optimization(
     :type max_num_threads: int > 0
     :param status: (output) status messages from C++ (e.g., reporting on optimizer success, etc.)
     :type status: dict
+    :param integration_type: source of the MC integration points for q,p-EI; quasi_random (randomized QMC) converges
+      faster than the default pseudo_random but is not supported with ``use_gpu``. With quasi_random, ``status`` also
+      reports ``expected_improvement`` and ``expected_improvement_standard_error`` at the result.
+    :type integration_type: C_GP.MonteCarloIntegrationTypes (None means pseudo_random)
+    :param evaluation_type: how q,p-EI other than 1,0-EI is computed: monte_carlo, or analytic (multivariate normal CDFs;
+      exact and much faster, but only for ``q + p <= 4``, falling back to monte_carlo otherwise)
+    :type evaluation_type: C_GP.ExpectedImprovementEvaluationTypes (None means analytic if ``integration_type`` is None,
+      monte_carlo otherwise)
     :return: point(s) that maximize the expected improvement (solving the q,p-EI problem)
     :rtype: array of float64 with shape (num_to_sample, ei_optimizer.objective_function.dim)
 
@@ -85,24 +96,36 @@ def multistart_expected_improvement_optimization(
     if status is None:
         status = {}
 
-    best_points_to_sample = C_GP.multistart_expected_improvement_optimization(
+    # an explicit integration_type asks for monte-carlo EI
+    if evaluation_type is None:
+        if integration_type is None:
+            evaluation_type = C_GP.ExpectedImprovementEvaluationTypes.analytic
+        else:
+            evaluation_type = C_GP.ExpectedImprovementEvaluationTypes.monte_carlo
+
+    if integration_type is None:
+        integration_type = C_GP.MonteCarloIntegrationTypes.pseudo_random
+
+    best_points_to_sample = numpy.empty((num_to_sample, ei_optimizer.objective_function.dim))
+    C_GP.multistart_expected_improvement_optimization(
         ei_optimizer.optimizer_parameters,
         ei_optimizer.objective_function._gaussian_process._gaussian_process,
-        cpp_utils.cppify(ei_optimizer.domain.domain_bounds),
-        cpp_utils.cppify(ei_optimizer.objective_function._points_being_sampled),
+        cpp_utils.cppify_buffer(ei_optimizer.domain.domain_bounds),
+        cpp_utils.cppify_buffer(ei_optimizer.objective_function._points_being_sampled),
         num_to_sample,
         ei_optimizer.objective_function.num_being_sampled,
         ei_optimizer.objective_function._best_so_far,
         ei_optimizer.objective_function._num_mc_iterations,
+        integration_type,
+        evaluation_type,
         max_num_threads,
         use_gpu,
         which_gpu,
         randomness,
         status,
+        best_points_to_sample,
     )
-
-    # reform output to be a list of dim-dimensional points, dim = len(self.domain)
-    return cpp_utils.uncppify(best_points_to_sample, (num_to_sample, ei_optimizer.objective_function.dim))
+    return best_points_to_sample
 
 
 def _heuristic_expected_improvement_optimization(
@@ -203,20 +226,20 @@ def _heuristic_expected_improvement_optimization(
     if status is None:
         status = {}
 
-    best_points_to_sample = C_GP.heuristic_expected_improvement_optimization(
+    best_points_to_sample = numpy.empty((num_to_sample, ei_optimizer.objective_function.dim))
+    C_GP.heuristic_expected_improvement_optimization(
         ei_optimizer.optimizer_parameters,
         ei_optimizer.objective_function._gaussian_process._gaussian_process,
-        cpp_utils.cppify(ei_optimizer.domain._domain_bounds),
+        cpp_utils.cppify_buffer(ei_optimizer.domain._domain_bounds),
         estimation_policy,
         num_to_sample,
         ei_optimizer.objective_function._best_so_far,
         max_num_threads,
         randomness,
         status,
+        best_points_to_sample,
     )
-
-    # reform output to be a list of dim-dimensional points, dim = len(self.domain)
-    return cpp_utils.uncppify(best_points_to_sample, (num_to_sample, ei_optimizer.objective_function.dim))
+    return best_points_to_sample
 
 
 def constant_liar_expected_improvement_optimization(
@@ -449,6 +472,7 @@ class ExpectedImprovement(ExpectedImprovementInterface, OptimizableInterface):
             randomness=None,
             max_num_threads=DEFAULT_MAX_NUM_THREADS,
             status=None,
+            force_monte_carlo=False,
     ):
         """Evaluate Expected Improvement (1,p-EI) over a specified list of ``points_to_evaluate``.
 
@@ -466,6 +490,8 @@ class ExpectedImprovement(ExpectedImprovementInterface, OptimizableInterface):
         :type max_num_threads: int > 0
         :param status: (output) status messages from C++ (e.g., reporting on optimizer success, etc.)
         :type status: dict
+        :param force_monte_carlo: whether to force monte carlo evaluation (vs using fast/accurate analytic eval when possible)
+        :type force_monte_carlo: boolean
         :return: EI evaluated at each of points_to_evaluate
         :rtype: array of float64 with shape (points_to_evaluate.shape[0])
 
@@ -488,20 +514,23 @@ class ExpectedImprovement(ExpectedImprovementInterface, OptimizableInterface):
         # overrides any data inside ei_evaluator
         num_to_evaluate, num_to_sample, _ = points_to_evaluate.shape
 
-        ei_values = C_GP.evaluate_EI_at_point_list(
+        ei_values = numpy.empty(num_to_evaluate)
+        C_GP.evaluate_EI_at_point_list(
             self._gaussian_process._gaussian_process,
-            cpp_utils.cppify(points_to_evaluate),
-            cpp_utils.cppify(self._points_being_sampled),
+            cpp_utils.cppify_buffer(points_to_evaluate),
+            cpp_utils.cppify_buffer(self._points_being_sampled),
             num_to_evaluate,
             num_to_sample,
             self.num_being_sampled,
             self._best_so_far,
             self._num_mc_iterations,
+            force_monte_carlo,
             max_num_threads,
             randomness,
             status,
+            ei_values,
         )
-        return numpy.array(ei_values)
+        return ei_values
 
     def compute_expected_improvement(self, force_monte_carlo=False):
         r"""Compute the expected improvement at ``points_to_sample``, with ``points_being_sampled`` concurrent points being sampled.
@@ -542,8 +571,8 @@ class ExpectedImprovement(ExpectedImprovementInterface, OptimizableInterface):
         """
         return C_GP.compute_expected_improvement(
             self._gaussian_process._gaussian_process,
-            cpp_utils.cppify(self._points_to_sample),
-            cpp_utils.cppify(self._points_being_sampled),
+            cpp_utils.cppify_buffer(self._points_to_sample),
+            cpp_utils.cppify_buffer(self._points_being_sampled),
             self.num_to_sample,
             self.num_being_sampled,
             self._num_mc_iterations,
@@ -581,18 +610,20 @@ class ExpectedImprovement(ExpectedImprovementInterface, OptimizableInterface):
         :rtype: array of float64 with shape (num_to_sample, dim)
 
         """
-        grad_ei = C_GP.compute_grad_expected_improvement(
+        grad_ei = numpy.empty((self.num_to_sample, self.dim))
+        C_GP.compute_grad_expected_improvement(
             self._gaussian_process._gaussian_process,
-            cpp_utils.cppify(self._points_to_sample),
-            cpp_utils.cppify(self._points_being_sampled),
+            cpp_utils.cppify_buffer(self._points_to_sample),
+            cpp_utils.cppify_buffer(self._points_being_sampled),
             self.num_to_sample,
             self.num_being_sampled,
             self._num_mc_iterations,
             self._best_so_far,
             force_monte_carlo,
             self._randomness,
+            grad_ei,
         )
-        return cpp_utils.uncppify(grad_ei, (self.num_to_sample, self.dim))
+        return grad_ei
 
     compute_grad_objective_function = compute_grad_expected_improvement
 
@@ -7,13 +7,53 @@ See :mod:`moe.optimal_learning.python.interfaces.gaussian_process_interface` for
 
 """
 import copy
+import logging
 
 import numpy
 
 import moe.build.GPP as C_GP
 import moe.optimal_learning.python.cpp_wrappers.cpp_utils as cpp_utils
+from moe.optimal_learning.python.constant import DEFAULT_GAUSSIAN_PROCESS_CACHE_MEMORY_BUDGET, DEFAULT_MAX_NUM_THREADS
 from moe.optimal_learning.python.interfaces.gaussian_process_interface import GaussianProcessInterface
 
+#: Process-wide cache of fitted C++ GPs, so that requests with the same historical data (or with points appended to it)
+#: stop refitting from scratch; see ``GPP.GaussianProcessCache``.  Configure it with
+#: :func:`set_gaussian_process_cache_memory_budget` and :func:`clear_gaussian_process_cache`.
+_GAUSSIAN_PROCESS_CACHE = C_GP.GaussianProcessCache(DEFAULT_GAUSSIAN_PROCESS_CACHE_MEMORY_BUDGET)
+
+
+def set_gaussian_process_cache_memory_budget(memory_budget):
+    """Change the memory budget of the process-wide cache of fitted C++ GPs used by :class:`GaussianProcess`.
+
+    Shrinking the budget evicts least recently used models right away.  GaussianProcess objects already constructed
+    are unaffected.
+
+    :param memory_budget: maximum number of bytes of (estimated) model memory to keep cached; 0 disables caching
+    :type memory_budget: int >= 0
+
+    """
+    _GAUSSIAN_PROCESS_CACHE.set_memory_budget(memory_budget)
+
+
+def get_gaussian_process_cache_memory_budget():
+    """Return the memory budget (in bytes) of the process-wide cache of fitted C++ GPs."""
+    return _GAUSSIAN_PROCESS_CACHE.memory_budget
+
+
+def get_gaussian_process_cache_num_over_budget():
+    """Return the number of models too large for the whole memory budget of the process-wide cache (so never cached).
+
+    A count that keeps growing means the budget is too small for this deployment's models; see
+    :func:`set_gaussian_process_cache_memory_budget`.
+
+    """
+    return _GAUSSIAN_PROCESS_CACHE.num_over_budget
+
+
+def clear_gaussian_process_cache():
+    """Drop every model from the process-wide cache of fitted C++ GPs; GaussianProcess objects already constructed stay valid."""
+    _GAUSSIAN_PROCESS_CACHE.clear()
+
 
 class GaussianProcess(GaussianProcessInterface):
 
@@ -68,14 +108,23 @@ class GaussianProcess(GaussianProcessInterface):
         self._historical_data = copy.deepcopy(historical_data)
 
         # C++ will maintain its own copy of the contents of hyperparameters and historical_data
-        self._gaussian_process = C_GP.GaussianProcess(
+        # The returned GP is ours: modifying it (e.g., add_sampled_points) never changes the cached model
+        num_over_budget = _GAUSSIAN_PROCESS_CACHE.num_over_budget
+        self._gaussian_process = _GAUSSIAN_PROCESS_CACHE.get_or_fit(
             cpp_utils.cppify_hyperparameters(self._covariance.hyperparameters),
-            cpp_utils.cppify(historical_data.points_sampled),
-            cpp_utils.cppify(historical_data.points_sampled_value),
-            cpp_utils.cppify(historical_data.points_sampled_noise_variance),
+            cpp_utils.cppify_buffer(historical_data.points_sampled),
+            cpp_utils.cppify_buffer(historical_data.points_sampled_value),
+            cpp_utils.cppify_buffer(historical_data.points_sampled_noise_variance),
             self._historical_data.dim,
             self._historical_data.num_sampled,
         )
+        if _GAUSSIAN_PROCESS_CACHE.memory_budget > 0 and _GAUSSIAN_PROCESS_CACHE.num_over_budget > num_over_budget:
+            logging.getLogger(__name__).warning(
+                'GaussianProcess with %d sampled points exceeds the model cache memory budget of %d bytes and was not '
+                'cached; raise it with set_gaussian_process_cache_memory_budget.',
+                self._historical_data.num_sampled,
+                _GAUSSIAN_PROCESS_CACHE.memory_budget,
+            )
 
     @property
     def dim(self):
@@ -124,11 +173,13 @@ class GaussianProcess(GaussianProcessInterface):
         :rtype: array of float64 with shape (num_to_sample)
 
         """
-        mu = self._gaussian_process.compute_mean_of_points(
-            cpp_utils.cppify(points_to_sample),
+        mu = numpy.empty(points_to_sample.shape[0])
+        self._gaussian_process.compute_mean_of_points(
+            cpp_utils.cppify_buffer(points_to_sample),
             points_to_sample.shape[0],
+            mu,
         )
-        return numpy.array(mu)
+        return mu
 
     def compute_grad_mean_of_points(self, points_to_sample, num_derivatives=-1):
         r"""Compute the gradient of the mean of this GP at each of point of ``Xs`` (``points_to_sample``) wrt ``Xs``.
@@ -154,11 +205,13 @@ class GaussianProcess(GaussianProcessInterface):
 
         """
         num_derivatives = self._clamp_num_derivatives(points_to_sample.shape[0], num_derivatives)
-        grad_mu = self._gaussian_process.compute_grad_mean_of_points(
-            cpp_utils.cppify(points_to_sample[:num_derivatives, ...]),
+        grad_mu = numpy.empty((num_derivatives, self.dim))
+        self._gaussian_process.compute_grad_mean_of_points(
+            cpp_utils.cppify_buffer(points_to_sample[:num_derivatives, ...]),
             num_derivatives,
+            grad_mu,
         )
-        return cpp_utils.uncppify(grad_mu, (num_derivatives, self.dim))
+        return grad_mu
 
     def compute_variance_of_points(self, points_to_sample):
         r"""Compute the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``).
@@ -177,11 +230,41 @@ class GaussianProcess(GaussianProcessInterface):
 
         """
         num_to_sample = points_to_sample.shape[0]
-        variance = self._gaussian_process.compute_variance_of_points(
-            cpp_utils.cppify(points_to_sample),
+        variance = numpy.empty((num_to_sample, num_to_sample))
+        self._gaussian_process.compute_variance_of_points(
+            cpp_utils.cppify_buffer(points_to_sample),
+            num_to_sample,
+            variance,
+        )
+        return variance
+
+    def compute_mean_and_marginal_variance_of_points(self, points_to_sample, max_num_threads=DEFAULT_MAX_NUM_THREADS):
+        r"""Compute the mean and marginal variance (diagonal of the variance matrix) of this GP at each point of ``Xs``.
+
+        Equivalent to ``compute_mean_of_points`` and ``numpy.diag(compute_variance_of_points(...))``, but never forms the
+        ``num_to_sample x num_to_sample`` variance matrix, so it scales to large candidate sets. Points are processed
+        in fixed-size chunks spread over ``max_num_threads`` threads; inputs and outputs are passed to C++ without copying.
+
+        :param points_to_sample: num_to_sample points (in dim dimensions) being sampled from the GP
+        :type points_to_sample: array of float64 with shape (num_to_sample, dim)
+        :param max_num_threads: maximum number of threads to use, >= 1
+        :type max_num_threads: int > 0
+        :return: mean and marginal variance of this GP at each point
+        :rtype: tuple of two arrays of float64, each with shape (num_to_sample, )
+
+        """
+        points_to_sample = numpy.ascontiguousarray(points_to_sample, dtype=numpy.float64)
+        num_to_sample = points_to_sample.shape[0]
+        mean = numpy.empty(num_to_sample)
+        marginal_variance = numpy.empty(num_to_sample)
+        self._gaussian_process.compute_mean_and_marginal_variance_of_points(
+            points_to_sample,
             num_to_sample,
+            max_num_threads,
+            mean,
+            marginal_variance,
         )
-        return cpp_utils.uncppify(variance, (num_to_sample, num_to_sample))
+        return mean, marginal_variance
 
     def compute_cholesky_variance_of_points(self, points_to_sample):
         r"""Compute the cholesky factorization of the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``).
@@ -195,11 +278,13 @@ class GaussianProcess(GaussianProcessInterface):
 
         """
         num_to_sample = points_to_sample.shape[0]
-        cholesky_variance = self._gaussian_process.compute_cholesky_variance_of_points(
-            cpp_utils.cppify(points_to_sample),
+        cholesky_variance = numpy.empty((num_to_sample, num_to_sample))
+        self._gaussian_process.compute_cholesky_variance_of_points(
+            cpp_utils.cppify_buffer(points_to_sample),
             num_to_sample,
+            cholesky_variance,
         )
-        return cpp_utils.uncppify(cholesky_variance, (num_to_sample, num_to_sample))
+        return cholesky_variance
 
     def compute_grad_variance_of_points(self, points_to_sample, num_derivatives=-1):
         r"""Compute the gradient of the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``) wrt ``Xs``.
@@ -223,12 +308,14 @@ class GaussianProcess(GaussianProcessInterface):
         num_derivatives = self._clamp_num_derivatives(points_to_sample.shape[0], num_derivatives)
         num_to_sample = points_to_sample.shape[0]
 
-        grad_variance = self._gaussian_process.compute_grad_variance_of_points(
-            cpp_utils.cppify(points_to_sample),
+        grad_variance = numpy.empty((num_derivatives, num_to_sample, num_to_sample, self.dim))
+        self._gaussian_process.compute_grad_variance_of_points(
+            cpp_utils.cppify_buffer(points_to_sample),
             num_to_sample,
             num_derivatives,
+            grad_variance,
         )
-        return cpp_utils.uncppify(grad_variance, (num_derivatives, num_to_sample, num_to_sample, self.dim))
+        return grad_variance
 
     def compute_grad_cholesky_variance_of_points(self, points_to_sample, num_derivatives=-1):
         r"""Compute the gradient of the cholesky factorization of the variance (matrix) of this GP at each point of ``Xs`` (``points_to_sample``) wrt ``Xs``.
@@ -259,12 +346,14 @@ class GaussianProcess(GaussianProcessInterface):
         num_derivatives = self._clamp_num_derivatives(points_to_sample.shape[0], num_derivatives)
         num_to_sample = points_to_sample.shape[0]
 
-        grad_chol_decomp = self._gaussian_process.compute_grad_cholesky_variance_of_points(
-            cpp_utils.cppify(points_to_sample),
+        grad_chol_decomp = numpy.empty((num_derivatives, num_to_sample, num_to_sample, self.dim))
+        self._gaussian_process.compute_grad_cholesky_variance_of_points(
+            cpp_utils.cppify_buffer(points_to_sample),
             num_to_sample,
             num_derivatives,
+            grad_chol_decomp,
         )
-        return cpp_utils.uncppify(grad_chol_decomp, (num_derivatives, num_to_sample, num_to_sample, self.dim))
+        return grad_chol_decomp
 
     def add_sampled_points(self, sampled_points):
         r"""Add sampled point(s) (point, value, noise) to the GP's prior data.
@@ -283,9 +372,9 @@ class GaussianProcess(GaussianProcessInterface):
 
         # new_historical_data = HistoricalData(self.dim, sampled_points)
         self._gaussian_process.add_sampled_points(
-            cpp_utils.cppify(self._historical_data.points_sampled[num_sampled_prev:, ...]),
-            cpp_utils.cppify(self._historical_data.points_sampled_value[num_sampled_prev:]),
-            cpp_utils.cppify(self._historical_data.points_sampled_noise_variance[num_sampled_prev:]),
+            cpp_utils.cppify_buffer(self._historical_data.points_sampled[num_sampled_prev:, ...]),
+            cpp_utils.cppify_buffer(self._historical_data.points_sampled_value[num_sampled_prev:]),
+            cpp_utils.cppify_buffer(self._historical_data.points_sampled_noise_variance[num_sampled_prev:]),
             num_to_add,
         )
 
@@ -314,6 +403,6 @@ class GaussianProcess(GaussianProcessInterface):
 
         """
         return self._gaussian_process.sample_point_from_gp(
-            cpp_utils.cppify(point_to_sample),
+            cpp_utils.cppify_buffer(point_to_sample),
             noise_variance,
         )
@@ -124,23 +124,27 @@ def multistart_hyperparameter_optimization(
     if status is None:
         status = {}
 
-    # C++ expects the domain in log10 space and in list form
+    # C++ expects the domain in log10 space
     domain_bounds_log10 = numpy.log10(log_likelihood_optimizer.domain._domain_bounds)
 
-    hyperparameters_opt = C_GP.multistart_hyperparameter_optimization(
+    hyperparameters_opt = numpy.empty(log_likelihood_optimizer.objective_function.num_hyperparameters)
+    C_GP.multistart_hyperparameter_optimization(
         log_likelihood_optimizer.optimizer_parameters,
-        cpp_utils.cppify(domain_bounds_log10),
-        cpp_utils.cppify(log_likelihood_optimizer.objective_function._points_sampled),
-        cpp_utils.cppify(log_likelihood_optimizer.objective_function._points_sampled_value),
+        cpp_utils.cppify_buffer(domain_bounds_log10),
+        cpp_utils.cppify_buffer(log_likelihood_optimizer.objective_function._points_sampled),
+        cpp_utils.cppify_buffer(log_likelihood_optimizer.objective_function._points_sampled_value),
         log_likelihood_optimizer.objective_function.dim,
         log_likelihood_optimizer.objective_function._num_sampled,
+        log_likelihood_optimizer.objective_function.leave_one_out_compute_type,
+        log_likelihood_optimizer.objective_function.log_marginal_gradient_type,
         cpp_utils.cppify_hyperparameters(log_likelihood_optimizer.objective_function.hyperparameters),
-        cpp_utils.cppify(log_likelihood_optimizer.objective_function._points_sampled_noise_variance),
+        cpp_utils.cppify_buffer(log_likelihood_optimizer.objective_function._points_sampled_noise_variance),
         max_num_threads,
         randomness,
         status,
+        hyperparameters_opt,
     )
-    return numpy.array(hyperparameters_opt)
+    return hyperparameters_opt
 
 
 def evaluate_log_likelihood_at_hyperparameter_list(
@@ -174,20 +178,24 @@ def evaluate_log_likelihood_at_hyperparameter_list(
 
     # We could just call log_likelihood_evaluator.compute_log_likelihood() in a loop, but instead we do
     # the looping in C++ where it can be multithreaded.
-    log_likelihood_list = C_GP.evaluate_log_likelihood_at_hyperparameter_list(
-        cpp_utils.cppify(hyperparameters_to_evaluate),
-        cpp_utils.cppify(log_likelihood_evaluator._points_sampled),
-        cpp_utils.cppify(log_likelihood_evaluator._points_sampled_value),
+    log_likelihood_list = numpy.empty(hyperparameters_to_evaluate.shape[0])
+    C_GP.evaluate_log_likelihood_at_hyperparameter_list(
+        cpp_utils.cppify_buffer(hyperparameters_to_evaluate),
+        cpp_utils.cppify_buffer(log_likelihood_evaluator._points_sampled),
+        cpp_utils.cppify_buffer(log_likelihood_evaluator._points_sampled_value),
         log_likelihood_evaluator.dim,
         log_likelihood_evaluator._num_sampled,
         log_likelihood_evaluator.objective_type,
+        log_likelihood_evaluator.leave_one_out_compute_type,
+        log_likelihood_evaluator.log_marginal_gradient_type,
         cpp_utils.cppify_hyperparameters(log_likelihood_evaluator.hyperparameters),
-        cpp_utils.cppify(log_likelihood_evaluator._points_sampled_noise_variance),
+        cpp_utils.cppify_buffer(log_likelihood_evaluator._points_sampled_noise_variance),
         hyperparameters_to_evaluate.shape[0],
         max_num_threads,
         status,
+        log_likelihood_list,
     )
-    return numpy.array(log_likelihood_list)
+    return log_likelihood_list
 
 
 class GaussianProcessLogLikelihood(GaussianProcessLogLikelihoodInterface, OptimizableInterface):
@@ -212,7 +220,14 @@ class GaussianProcessLogLikelihood(GaussianProcessLogLikelihoodInterface, Optimi
 
     """
 
-    def __init__(self, covariance_function, historical_data, log_likelihood_type=C_GP.LogLikelihoodTypes.log_marginal_likelihood):
+    def __init__(
+            self,
+            covariance_function,
+            historical_data,
+            log_likelihood_type=C_GP.LogLikelihoodTypes.log_marginal_likelihood,
+            leave_one_out_compute_type=C_GP.LeaveOneOutComputeTypes.matrix_inverse,
+            log_marginal_gradient_type=C_GP.LogMarginalLikelihoodGradientTypes.full_tensor,
+    ):
         """Construct a LogLikelihood object that knows how to call C++ for evaluation of member functions.
 
         :param covariance_function: covariance object encoding assumptions about the GP's behavior on our data
@@ -222,12 +237,20 @@ class GaussianProcessLogLikelihood(GaussianProcessLogLikelihoodInterface, Optimi
         :type historical_data: :class:`moe.optimal_learning.python.data_containers.HistoricalData` object
         :param log_likelihood_type: enum specifying which log likelihood measure to compute
         :type log_likelihood_type: GPP.LogLikelihoodTypes
+        :param leave_one_out_compute_type: enum specifying how leave one out cross validation is computed (the measure
+          is the same either way); unused by other log likelihood measures
+        :type leave_one_out_compute_type: GPP.LeaveOneOutComputeTypes
+        :param log_marginal_gradient_type: enum specifying how the gradient of the log marginal likelihood is computed
+          (the gradient is the same either way; streaming needs less memory); unused by other log likelihood measures
+        :type log_marginal_gradient_type: GPP.LogMarginalLikelihoodGradientTypes
 
         """
         self._covariance = copy.deepcopy(covariance_function)
         self._historical_data = copy.deepcopy(historical_data)
 
         self.objective_type = log_likelihood_type
+        self.leave_one_out_compute_type = leave_one_out_compute_type
+        self.log_marginal_gradient_type = log_marginal_gradient_type
 
     @property
     def dim(self):
@@ -308,13 +331,15 @@ class GaussianProcessLogLikelihood(GaussianProcessLogLikelihoodInterface, Optimi
 
         """
         return C_GP.compute_log_likelihood(
-            cpp_utils.cppify(self._points_sampled),
-            cpp_utils.cppify(self._points_sampled_value),
+            cpp_utils.cppify_buffer(self._points_sampled),
+            cpp_utils.cppify_buffer(self._points_sampled_value),
             self.dim,
             self._num_sampled,
             self.objective_type,
+            self.leave_one_out_compute_type,
+            self.log_marginal_gradient_type,
             cpp_utils.cppify_hyperparameters(self.hyperparameters),
-            cpp_utils.cppify(self._points_sampled_noise_variance),
+            cpp_utils.cppify_buffer(self._points_sampled_noise_variance),
         )
 
     compute_objective_function = compute_log_likelihood
@@ -326,16 +351,20 @@ class GaussianProcessLogLikelihood(GaussianProcessLogLikelihoodInterface, Optimi
         :rtype: array of float64 with shape (num_hyperparameters)
 
         """
-        grad_log_marginal = C_GP.compute_hyperparameter_grad_log_likelihood(
-            cpp_utils.cppify(self._points_sampled),
-            cpp_utils.cppify(self._points_sampled_value),
+        grad_log_marginal = numpy.empty(self.num_hyperparameters)
+        C_GP.compute_hyperparameter_grad_log_likelihood(
+            cpp_utils.cppify_buffer(self._points_sampled),
+            cpp_utils.cppify_buffer(self._points_sampled_value),
             self.dim,
             self._num_sampled,
             self.objective_type,
+            self.leave_one_out_compute_type,
+            self.log_marginal_gradient_type,
             cpp_utils.cppify_hyperparameters(self.hyperparameters),
-            cpp_utils.cppify(self._points_sampled_noise_variance),
+            cpp_utils.cppify_buffer(self._points_sampled_noise_variance),
+            grad_log_marginal,
         )
-        return numpy.array(grad_log_marginal)
+        return grad_log_marginal
 
     compute_grad_objective_function = compute_grad_log_likelihood
 
@@ -375,12 +404,13 @@ class GaussianProcessLogMarginalLikelihood(GaussianProcessLogLikelihood):
 
     """
 
-    def __init__(self, covariance_function, historical_data):
+    def __init__(self, covariance_function, historical_data, log_marginal_gradient_type=C_GP.LogMarginalLikelihoodGradientTypes.full_tensor):
         """Construct a LogLikelihood object configured for Log Marginal Likelihood computation; see superclass ctor for details."""
         super(GaussianProcessLogMarginalLikelihood, self).__init__(
             covariance_function,
             historical_data,
             log_likelihood_type=C_GP.LogLikelihoodTypes.log_marginal_likelihood,
+            log_marginal_gradient_type=log_marginal_gradient_type,
             )
 
 
@@ -414,12 +444,13 @@ class GaussianProcessLeaveOneOutLogLikelihood(GaussianProcessLogLikelihood):
 
     """
 
-    def __init__(self, covariance_function, historical_data):
+    def __init__(self, covariance_function, historical_data, leave_one_out_compute_type=C_GP.LeaveOneOutComputeTypes.matrix_inverse):
         """Construct a LogLikelihood object configured for Leave One Out Cross Validation Log Pseudo-Likelihood computation; see superclass ctor for details."""
         super(GaussianProcessLeaveOneOutLogLikelihood, self).__init__(
             covariance_function,
             historical_data,
             log_likelihood_type=C_GP.LogLikelihoodTypes.leave_one_out_log_likelihood,
+            leave_one_out_compute_type=leave_one_out_compute_type,
             )
 
     def compute_hessian_log_likelihood(self, hyperparameters):
@@ -246,6 +246,74 @@ class NewtonParameters(C_GP.NewtonParameters, EqualityComparisonMixin):
         super(NewtonParameters, self).__init__(*args, **kwargs)
 
 
+class LBFGSParameters(C_GP.LBFGSParameters, EqualityComparisonMixin):
+
+    """Container to hold parameters that specify the behavior of (projected) L-BFGS in a C++-readable form.
+
+    See :func:`~moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSParameters.__init__` docstring for more information.
+
+    """
+
+    __slots__ = ()
+
+    def __init__(self, *args, **kwargs):
+        r"""Build a LBFGSParameters (C++ object) via its ctor; this object specifies multistarted L-BFGS behavior and is required by C++ L-BFGS optimization.
+
+        .. Note:: See gpp_optimizer_parameters.hpp for more details.
+            The following comments are copied from LBFGSParameters struct in gpp_optimizer_parameters.hpp.
+
+        ``history_size`` is the number of (step, gradient change) pairs used to approximate the inverse Hessian.  Memory and the
+        per-iteration overhead grow linearly in ``history_size * problem_size``; values beyond 10-20 rarely help.
+
+        :param num_multistarts: number of initial guesses to try in multistarted l-bfgs (suggest: a few hundred)
+        :type num_multistarts: int > 0
+        :param max_num_steps: maximum number of l-bfgs iterations (per initial guess) (suggest: 100)
+        :type max_num_steps: int > 0
+        :param history_size: number of correction pairs kept for the inverse Hessian approximation (suggest: 5-10)
+        :type history_size: int > 0
+        :param max_num_line_search_steps: maximum number of step halvings in the backtracking line search (suggest: 20-30)
+        :type max_num_line_search_steps: int > 0
+        :param tolerance: when the projected gradient or the step falls below this value (max-norm), stop (suggest: 1.0e-7)
+        :type tolerance: float64 >= 0.0
+
+        """
+        super(LBFGSParameters, self).__init__(*args, **kwargs)
+
+
+class AdaptiveMultistartParameters(C_GP.AdaptiveMultistartParameters, EqualityComparisonMixin):
+
+    """Container to hold parameters that specify adaptive multistart (successive halving + pruning) in a C++-readable form.
+
+    See :func:`~moe.optimal_learning.python.cpp_wrappers.optimization.AdaptiveMultistartParameters.__init__` docstring for more information.
+
+    """
+
+    __slots__ = ()
+
+    def __init__(self, *args, **kwargs):
+        r"""Build an AdaptiveMultistartParameters (C++ object) via its ctor; pass it to LBFGSOptimizer to screen many starts cheaply.
+
+        .. Note:: See gpp_optimizer_parameters.hpp for more details.
+            The following comments are copied from AdaptiveMultistartParameters struct in gpp_optimizer_parameters.hpp.
+
+        Every start first runs a short, "screening" optimization (``num_screening_steps`` L-BFGS steps).  Then only the best
+        ``survivor_fraction`` of the starts (by objective value) continue with another screening run from where they stopped;
+        this repeats until at most ``min_num_survivors`` remain.  The survivors are then optimized fully, best-first; a survivor
+        whose screened objective trails the best found so far by more than ``prune_gap`` is dropped.
+
+        :param num_screening_steps: maximum number of optimizer iterations per screening round (suggest: 2-10)
+        :type num_screening_steps: int > 0
+        :param survivor_fraction: fraction of starts kept after each screening round (suggest: 0.5)
+        :type survivor_fraction: float64 in (0, 1)
+        :param min_num_survivors: screening stops once at most this many starts remain; these are fully optimized (suggest: 5-20, or more threads)
+        :type min_num_survivors: int > 0
+        :param prune_gap: drop survivors whose screened objective is more than this far below the best found so far (inf disables pruning)
+        :type prune_gap: float64 >= 0.0
+
+        """
+        super(AdaptiveMultistartParameters, self).__init__(*args, **kwargs)
+
+
 class GradientDescentParameters(C_GP.GradientDescentParameters, EqualityComparisonMixin):
 
     """Container to hold parameters that specify the behavior of Gradient Descent in a C++-readable form.
@@ -336,6 +404,8 @@ class _CppOptimizerParameters(object):
     :ivar num_random_samples: (*int >= 0*) number of samples to try if using 'dumb' search
     :ivar optimizer_parameters: (*C_GP.\*Parameters* struct, matching ``optimizer_type``) parameters to control
       derviative-based optimizers, e.g., step size control, number of steps tolerance, etc.
+    :ivar adaptive_parameters: (*C_GP.AdaptiveMultistartParameters* or None) if set, C++ screens the multistarts and fully
+      optimizes only the best survivors; only used with ``optimizer_type`` lbfgs
 
     .. NOTE:: ``optimizer_parameters`` this MUST be a C++ object whose type matches objective_type. e.g., if objective_type
         is kNewton, then this must be built via C_GP.NewtonParameters() (i.e., cpp_wrapers.NewtonParameters.newton_data)
@@ -345,7 +415,7 @@ class _CppOptimizerParameters(object):
 
     """
 
-    __slots__ = ('domain_type', 'objective_type', 'optimizer_type', 'num_random_samples', 'optimizer_parameters', )
+    __slots__ = ('domain_type', 'objective_type', 'optimizer_type', 'num_random_samples', 'optimizer_parameters', 'adaptive_parameters', )
 
     def __init__(
             self,
@@ -354,6 +424,7 @@ class _CppOptimizerParameters(object):
             optimizer_type=None,
             num_random_samples=None,
             optimizer_parameters=None,
+            adaptive_parameters=None,
     ):
         """Construct CppOptimizerParameters that specifies optimization behavior to C++."""
         # see gpp_python_common.cpp for .*_type enum definitions. .*_type variables must be from those enums (NOT integers)
@@ -365,6 +436,7 @@ class _CppOptimizerParameters(object):
             self.optimizer_parameters = optimizer_parameters  # must match the optimizer_type
         else:
             self.optimizer_parameters = None
+        self.adaptive_parameters = adaptive_parameters
 
 
 class NullOptimizer(OptimizerInterface):
@@ -474,3 +546,48 @@ class NewtonOptimizer(OptimizerInterface):
     def optimize(self, **kwargs):
         """C++ does not expose this endpoint."""
         raise NotImplementedError("C++ wrapper currently does not support optimization member functions.")
+
+
+class LBFGSOptimizer(OptimizerInterface):
+
+    """Simple container for telling C++ to use (projected) L-BFGS for optimization.
+
+    C++ dispatches L-BFGS for EI (multistart only, not the heuristic methods) and hyperparameter optimization,
+    over tensor product domains only.  With ``adaptive_parameters``, the multistarts are screened with a few L-BFGS steps
+    each and only the best survivors are optimized fully (adaptive multistart).
+    See this module's docstring for some more information or the comments in gpp_optimization.hpp
+    for full details on L-BFGS.
+
+    """
+
+    def __init__(self, domain, optimizable, optimizer_parameters, num_random_samples=None, adaptive_parameters=None):
+        """Construct a LBFGSOptimizer.
+
+        :param domain: the domain that this optimizer operates over
+        :type domain: interfaces.domain_interface.DomainInterface subclass from cpp_wrappers
+        :param optimizable: object representing the objective function being optimized
+        :type optimizable: interfaces.optimization_interface.OptimizableInterface subclass from cpp_wrappers
+        :param optimizer_parameters: parameters describing how to perform optimization (tolerances, iterations, etc.)
+        :type optimizer_parameters: cpp_wrappers.optimization.LBFGSParameters object
+        :params num_random_samples: number of random samples to use if performing 'dumb' search
+        :type num_random_sampes: int >= 0
+        :param adaptive_parameters: parameters for adaptive multistart (screening rounds, survivors, pruning); None to
+          fully optimize every multistart
+        :type adaptive_parameters: cpp_wrappers.optimization.AdaptiveMultistartParameters object or None
+
+        """
+        self.domain = domain
+        self.objective_function = optimizable
+        self.optimizer_type = C_GP.OptimizerTypes.lbfgs
+        self.optimizer_parameters = _CppOptimizerParameters(
+            domain_type=domain._domain_type,
+            objective_type=optimizable.objective_type,
+            optimizer_type=self.optimizer_type,
+            num_random_samples=num_random_samples,
+            optimizer_parameters=optimizer_parameters,
+            adaptive_parameters=adaptive_parameters,
+        )
+
+    def optimize(self, **kwargs):
+        """C++ does not expose this endpoint."""
+        raise NotImplementedError("C++ wrapper currently does not support optimization member functions.")
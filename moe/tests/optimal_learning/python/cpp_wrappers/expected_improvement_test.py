@@ -1,12 +1,18 @@
 # -*- coding: utf-8 -*-
 """Test the C++ implementation of expected improvement against the Python implementation."""
+import threading
+
 import numpy
 
 import pytest
 
+import moe.build.GPP as C_GP
 import moe.optimal_learning.python.cpp_wrappers.covariance
+import moe.optimal_learning.python.cpp_wrappers.domain
 import moe.optimal_learning.python.cpp_wrappers.expected_improvement
 import moe.optimal_learning.python.cpp_wrappers.gaussian_process
+import moe.optimal_learning.python.cpp_wrappers.optimization
+from moe.optimal_learning.python.data_containers import SamplePoint
 from moe.optimal_learning.python.geometry_utils import ClosedInterval
 import moe.optimal_learning.python.python_version.covariance
 import moe.optimal_learning.python.python_version.domain
@@ -89,3 +95,204 @@ class TestExpectedImprovement(GaussianProcessTestCase):
                 cpp_grad_ei = cpp_ei_eval.compute_grad_expected_improvement()
                 python_grad_ei = python_ei_eval.compute_grad_expected_improvement()
                 self.assert_vector_within_relative(python_grad_ei, cpp_grad_ei, grad_ei_tolerance)
+
+    def test_multistart_optimization_from_concurrent_threads(self):
+        """Check that EI optimizations run from several Python threads at once (C++ releases the GIL) match running them one at a time."""
+        num_threads = 4
+        num_random_samples = 2000
+
+        domain, python_gp = self.gp_test_environments[-1]
+        python_cov, historical_data = python_gp.get_core_data_copy()
+        cpp_cov = moe.optimal_learning.python.cpp_wrappers.covariance.SquareExponential(python_cov.hyperparameters)
+        cpp_gp = moe.optimal_learning.python.cpp_wrappers.gaussian_process.GaussianProcess(cpp_cov, historical_data)
+        cpp_domain = moe.optimal_learning.python.cpp_wrappers.domain.TensorProductDomain(domain._domain_bounds)
+        ei_eval = moe.optimal_learning.python.cpp_wrappers.expected_improvement.ExpectedImprovement(cpp_gp)
+        ei_optimizer = moe.optimal_learning.python.cpp_wrappers.optimization.NullOptimizer(
+            cpp_domain,
+            ei_eval,
+            None,
+            num_random_samples=num_random_samples,
+        )
+
+        def optimize(seed):
+            """Run LHC search for the best point, seeding every RNG with ``seed``; each thread gets its own RNGs."""
+            randomness = C_GP.RandomnessSourceContainer(1)
+            randomness.SetExplicitUniformGeneratorSeed(seed)
+            randomness.SetExplicitNormalRNGSeed(seed)
+            return moe.optimal_learning.python.cpp_wrappers.expected_improvement.multistart_expected_improvement_optimization(
+                ei_optimizer,
+                num_random_samples,
+                1,
+                randomness=randomness,
+                max_num_threads=1,
+            )
+
+        serial_results = [optimize(seed) for seed in xrange(num_threads)]
+
+        concurrent_results = [None] * num_threads
+
+        def run(seed):
+            """Store the result of optimize(seed); exceptions leave it as None."""
+            concurrent_results[seed] = optimize(seed)
+
+        threads = [threading.Thread(target=run, args=(seed,)) for seed in xrange(num_threads)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        for serial_result, concurrent_result in zip(serial_results, concurrent_results):
+            assert concurrent_result is not None
+            self.assert_vector_within_relative(concurrent_result, serial_result, 0.0)
+
+    def test_multistart_optimization_sharing_gp_and_randomness_across_threads(self):
+        """Check that EI optimizations from several Python threads can share one GP and one RandomnessSourceContainer while one thread updates the GP."""
+        num_threads = 2
+        num_iterations = 5
+        num_random_samples = 200
+
+        domain, python_gp = self.gp_test_environments[-1]
+        python_cov, historical_data = python_gp.get_core_data_copy()
+        cpp_cov = moe.optimal_learning.python.cpp_wrappers.covariance.SquareExponential(python_cov.hyperparameters)
+        cpp_gp = moe.optimal_learning.python.cpp_wrappers.gaussian_process.GaussianProcess(cpp_cov, historical_data)
+        cpp_domain = moe.optimal_learning.python.cpp_wrappers.domain.TensorProductDomain(domain._domain_bounds)
+        ei_eval = moe.optimal_learning.python.cpp_wrappers.expected_improvement.ExpectedImprovement(cpp_gp)
+        ei_optimizer = moe.optimal_learning.python.cpp_wrappers.optimization.NullOptimizer(
+            cpp_domain,
+            ei_eval,
+            None,
+            num_random_samples=num_random_samples,
+        )
+
+        randomness = C_GP.RandomnessSourceContainer(1)
+        randomness.SetExplicitUniformGeneratorSeed(31)
+        randomness.SetExplicitNormalRNGSeed(31)
+        new_points = [SamplePoint(point, 0.0, self.noise_variance_base)
+                      for point in domain.generate_uniform_random_points_in_domain(num_iterations)]
+
+        results = [[] for _ in xrange(num_threads)]
+        errors = []
+
+        def run(thread_id):
+            """Optimize EI repeatedly on the shared GP and RNGs; thread 0 also adds a point to the GP after each optimization."""
+            try:
+                for i in xrange(num_iterations):
+                    results[thread_id].append(moe.optimal_learning.python.cpp_wrappers.expected_improvement.multistart_expected_improvement_optimization(
+                        ei_optimizer,
+                        num_random_samples,
+                        1,
+                        randomness=randomness,
+                        max_num_threads=1,
+                    ))
+                    if thread_id == 0:
+                        cpp_gp.add_sampled_points([new_points[i]])
+            except Exception as exception:
+                errors.append(exception)
+
+        threads = [threading.Thread(target=run, args=(thread_id,)) for thread_id in xrange(num_threads)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert not errors
+        assert cpp_gp.num_sampled == historical_data.num_sampled + num_iterations
+        for thread_results in results:
+            assert len(thread_results) == num_iterations
+            for result in thread_results:
+                assert numpy.all(numpy.isfinite(result))
+                assert cpp_domain.check_point_inside(result[0, ...])
+
+    def test_multistart_lbfgs_optimization(self):
+        """Check that multistart L-BFGS EI optimization does at least as well as gradient descent, runs adaptively, and rejects simplex domains."""
+        num_multistarts = 20
+        num_random_samples = 100
+        seed = 3141
+
+        domain, python_gp = self.gp_test_environments[-1]
+        python_cov, historical_data = python_gp.get_core_data_copy()
+        cpp_cov = moe.optimal_learning.python.cpp_wrappers.covariance.SquareExponential(python_cov.hyperparameters)
+        cpp_gp = moe.optimal_learning.python.cpp_wrappers.gaussian_process.GaussianProcess(cpp_cov, historical_data)
+        cpp_domain = moe.optimal_learning.python.cpp_wrappers.domain.TensorProductDomain(domain._domain_bounds)
+        ei_eval = moe.optimal_learning.python.cpp_wrappers.expected_improvement.ExpectedImprovement(cpp_gp)
+
+        gd_parameters = moe.optimal_learning.python.cpp_wrappers.optimization.GradientDescentParameters(
+            num_multistarts, 500, 3, 0, 0.5, 1.0, 1.0, 1.0e-7,
+        )
+        lbfgs_parameters = moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSParameters(
+            num_multistarts, 200, 10, 30, 1.0e-7,
+        )
+
+        def optimize(optimizer_class, optimizer_parameters, optimizer_domain, status, **optimizer_kwargs):
+            """Optimize 1,0-EI with a freshly seeded RNG so that both optimizers start from the same points."""
+            ei_optimizer = optimizer_class(
+                optimizer_domain,
+                ei_eval,
+                optimizer_parameters,
+                num_random_samples=num_random_samples,
+                **optimizer_kwargs
+            )
+            randomness = C_GP.RandomnessSourceContainer(1)
+            randomness.SetExplicitUniformGeneratorSeed(seed)
+            randomness.SetExplicitNormalRNGSeed(seed)
+            return moe.optimal_learning.python.cpp_wrappers.expected_improvement.multistart_expected_improvement_optimization(
+                ei_optimizer,
+                num_multistarts,
+                1,
+                randomness=randomness,
+                max_num_threads=1,
+                status=status,
+            )
+
+        gd_status = {}
+        gd_result = optimize(
+            moe.optimal_learning.python.cpp_wrappers.optimization.GradientDescentOptimizer,
+            gd_parameters,
+            cpp_domain,
+            gd_status,
+        )
+        lbfgs_status = {}
+        lbfgs_result = optimize(
+            moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSOptimizer,
+            lbfgs_parameters,
+            cpp_domain,
+            lbfgs_status,
+        )
+        assert gd_status['gradient_descent_tensor_product_domain_found_update']
+        assert lbfgs_status['lbfgs_tensor_product_domain_found_update']
+        assert cpp_domain.check_point_inside(lbfgs_result[0, ...])
+
+        ei_eval.set_current_point(gd_result)
+        gd_ei = ei_eval.compute_expected_improvement()
+        ei_eval.set_current_point(lbfgs_result)
+        lbfgs_ei = ei_eval.compute_expected_improvement()
+        assert lbfgs_ei >= gd_ei * (1.0 - 1.0e-8)
+
+        # adaptive multistart: screen every start with a few L-BFGS steps, fully optimize the best few
+        adaptive_parameters = moe.optimal_learning.python.cpp_wrappers.optimization.AdaptiveMultistartParameters(
+            3, 0.5, 4, float('inf'),
+        )
+        adaptive_status = {}
+        adaptive_result = optimize(
+            moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSOptimizer,
+            lbfgs_parameters,
+            cpp_domain,
+            adaptive_status,
+            adaptive_parameters=adaptive_parameters,
+        )
+        assert adaptive_status['lbfgs_tensor_product_domain_found_update']
+        assert cpp_domain.check_point_inside(adaptive_result[0, ...])
+        # screening is a heuristic (it may drop the start that leads to the global optimum); only check for an improvement
+        ei_eval.set_current_point(adaptive_result)
+        assert ei_eval.compute_expected_improvement() > 0.0
+
+        simplex_domain = moe.optimal_learning.python.cpp_wrappers.domain.SimplexIntersectTensorProductDomain(
+            [ClosedInterval(0.0, 1.0)] * self.dim,
+        )
+        with pytest.raises(C_GP.OptimalLearningException):
+            optimize(
+                moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSOptimizer,
+                lbfgs_parameters,
+                simplex_domain,
+                {},
+            )
@@ -1,12 +1,17 @@
 # -*- coding: utf-8 -*-
 """Test the C++ implementation of Gaussian Process properties (mean, var, gradients thereof) against the Python version."""
 import copy
+import os
+import shutil
+import tempfile
 
 import numpy
 
 import pytest
 
 import moe.build.GPP as C_GP
+from moe.optimal_learning.python.cpp_wrappers import cpp_utils
+import moe.optimal_learning.python.cpp_wrappers.gaussian_process
 from moe.optimal_learning.python.cpp_wrappers.covariance import SquareExponential
 from moe.optimal_learning.python.cpp_wrappers.gaussian_process import GaussianProcess
 from moe.optimal_learning.python.data_containers import HistoricalData, SamplePoint
@@ -161,3 +166,185 @@ class TestGaussianProcess(GaussianProcessTestCase):
                     cpp_grad_var = cpp_gp.compute_grad_cholesky_variance_of_points(points_to_sample)
                     python_grad_var = python_gp.compute_grad_cholesky_variance_of_points(points_to_sample)
                     self.assert_vector_within_relative(python_grad_var, cpp_grad_var, grad_var_tolerance)
+
+    def test_buffer_and_list_overloads_match(self):
+        """Check that the zero-copy (buffer protocol) overloads of the C++ GP reproduce the list overloads exactly."""
+        for test_case in self.gp_test_environments:
+            domain, python_gp = test_case
+            python_cov, historical_data = python_gp.get_core_data_copy()
+
+            list_gp = C_GP.GaussianProcess(
+                cpp_utils.cppify_hyperparameters(python_cov.hyperparameters),
+                cpp_utils.cppify(historical_data.points_sampled),
+                cpp_utils.cppify(historical_data.points_sampled_value),
+                cpp_utils.cppify(historical_data.points_sampled_noise_variance),
+                historical_data.dim,
+                historical_data.num_sampled,
+            )
+            buffer_gp = C_GP.GaussianProcess(
+                cpp_utils.cppify_hyperparameters(python_cov.hyperparameters),
+                numpy.ascontiguousarray(historical_data.points_sampled, dtype=numpy.float64),
+                numpy.ascontiguousarray(historical_data.points_sampled_value, dtype=numpy.float64),
+                numpy.ascontiguousarray(historical_data.points_sampled_noise_variance, dtype=numpy.float64),
+                historical_data.dim,
+                historical_data.num_sampled,
+            )
+
+            for num_to_sample in self.num_to_sample_list:
+                points_to_sample = domain.generate_uniform_random_points_in_domain(num_to_sample)
+                list_points = cpp_utils.cppify(points_to_sample)
+                buffer_points = numpy.ascontiguousarray(points_to_sample, dtype=numpy.float64)
+
+                mu = numpy.empty(num_to_sample)
+                buffer_gp.compute_mean_of_points(buffer_points, num_to_sample, mu)
+                self.assert_vector_within_relative(mu, numpy.array(list_gp.compute_mean_of_points(list_points, num_to_sample)), 0.0)
+
+                grad_mu = numpy.empty((num_to_sample, domain.dim))
+                buffer_gp.compute_grad_mean_of_points(buffer_points, num_to_sample, grad_mu)
+                expected_grad_mu = numpy.array(list_gp.compute_grad_mean_of_points(list_points, num_to_sample))
+                self.assert_vector_within_relative(grad_mu.ravel(), expected_grad_mu, 0.0)
+
+                var = numpy.empty((num_to_sample, num_to_sample))
+                buffer_gp.compute_variance_of_points(buffer_points, num_to_sample, var)
+                expected_var = numpy.array(list_gp.compute_variance_of_points(list_points, num_to_sample))
+                self.assert_vector_within_relative(var.ravel(), expected_var, 0.0)
+
+                chol_var = numpy.empty((num_to_sample, num_to_sample))
+                buffer_gp.compute_cholesky_variance_of_points(buffer_points, num_to_sample, chol_var)
+                expected_chol_var = numpy.array(list_gp.compute_cholesky_variance_of_points(list_points, num_to_sample))
+                self.assert_vector_within_relative(chol_var.ravel(), expected_chol_var, 0.0)
+
+                grad_var = numpy.empty((num_to_sample, num_to_sample, num_to_sample, domain.dim))
+                buffer_gp.compute_grad_variance_of_points(buffer_points, num_to_sample, num_to_sample, grad_var)
+                expected_grad_var = numpy.array(list_gp.compute_grad_variance_of_points(list_points, num_to_sample, num_to_sample))
+                self.assert_vector_within_relative(grad_var.ravel(), expected_grad_var, 0.0)
+
+                buffer_gp.compute_grad_cholesky_variance_of_points(buffer_points, num_to_sample, num_to_sample, grad_var)
+                expected_grad_var = numpy.array(list_gp.compute_grad_cholesky_variance_of_points(list_points, num_to_sample, num_to_sample))
+                self.assert_vector_within_relative(grad_var.ravel(), expected_grad_var, 0.0)
+
+            # buffers of the wrong size or type are rejected
+            with pytest.raises(C_GP.InvalidValueException):
+                buffer_gp.compute_mean_of_points(buffer_points, num_to_sample, numpy.empty(num_to_sample + 1))
+            with pytest.raises(C_GP.OptimalLearningException):
+                buffer_gp.compute_mean_of_points(buffer_points.astype(numpy.float32), num_to_sample, mu)
+
+    def test_gaussian_process_cache(self):
+        """Check that GaussianProcessCache reuses models for repeated inputs, extends them for appended points, and stays unmodified."""
+        for test_case in self.gp_test_environments:
+            domain, python_gp = test_case
+            python_cov, historical_data = python_gp.get_core_data_copy()
+            hyperparameters = cpp_utils.cppify_hyperparameters(python_cov.hyperparameters)
+            points_sampled = numpy.ascontiguousarray(historical_data.points_sampled, dtype=numpy.float64)
+            points_sampled_value = numpy.ascontiguousarray(historical_data.points_sampled_value, dtype=numpy.float64)
+            noise_variance = numpy.ascontiguousarray(historical_data.points_sampled_noise_variance, dtype=numpy.float64)
+            dim = historical_data.dim
+            num_sampled = historical_data.num_sampled
+            num_prefix = num_sampled // 2
+
+            model_cache = C_GP.GaussianProcessCache(1 << 26)
+            model_cache.get_or_fit(hyperparameters, points_sampled[:num_prefix], points_sampled_value[:num_prefix],
+                                   noise_variance[:num_prefix], dim, num_prefix)
+            cached_gp = model_cache.get_or_fit(hyperparameters, points_sampled, points_sampled_value, noise_variance,
+                                               dim, num_sampled)
+            model_cache.get_or_fit(hyperparameters, cpp_utils.cppify(points_sampled), list(points_sampled_value),
+                                   list(noise_variance), dim, num_sampled)
+            assert (model_cache.num_fits, model_cache.num_extensions, model_cache.num_hits) == (1, 1, 1)
+
+            # modifying a returned GP leaves the cached model untouched
+            new_point = numpy.ascontiguousarray(domain.generate_uniform_random_points_in_domain(1), dtype=numpy.float64)
+            cached_gp.add_sampled_points(new_point, numpy.zeros(1), numpy.full(1, noise_variance[0]), 1)
+            assert cached_gp.num_sampled == num_sampled + 1
+            hit_gp = model_cache.get_or_fit(hyperparameters, points_sampled, points_sampled_value, noise_variance,
+                                            dim, num_sampled)
+            assert hit_gp.num_sampled == num_sampled
+            assert (model_cache.num_fits, model_cache.num_extensions, model_cache.num_hits) == (1, 1, 2)
+
+            list_gp = C_GP.GaussianProcess(hyperparameters, cpp_utils.cppify(points_sampled), list(points_sampled_value),
+                                           list(noise_variance), dim, num_sampled)
+            points_to_sample = cpp_utils.cppify(domain.generate_uniform_random_points_in_domain(5))
+            self.assert_vector_within_relative(
+                numpy.array(hit_gp.compute_mean_of_points(points_to_sample, 5)),
+                numpy.array(list_gp.compute_mean_of_points(points_to_sample, 5)),
+                1.0e-11,
+            )
+
+            # shrinking the budget evicts right away; a budget of 0 disables caching
+            model_cache.set_memory_budget(0)
+            assert (model_cache.memory_budget, model_cache.size, model_cache.memory_used) == (0, 0, 0)
+            model_cache.get_or_fit(hyperparameters, points_sampled, points_sampled_value, noise_variance, dim, num_sampled)
+            assert (model_cache.size, model_cache.num_over_budget) == (0, 1)
+
+    def test_gaussian_process_cache_configuration(self):
+        """Check that the process-wide cache used by GaussianProcess can be resized, disabled, and cleared."""
+        gaussian_process_module = moe.optimal_learning.python.cpp_wrappers.gaussian_process
+        model_cache = gaussian_process_module._GAUSSIAN_PROCESS_CACHE
+        memory_budget = gaussian_process_module.get_gaussian_process_cache_memory_budget()
+        domain, python_gp = self.gp_test_environments[0]
+        python_cov, historical_data = python_gp.get_core_data_copy()
+        try:
+            gaussian_process_module.clear_gaussian_process_cache()
+            assert model_cache.size == 0
+
+            gaussian_process_module.set_gaussian_process_cache_memory_budget(0)
+            assert gaussian_process_module.get_gaussian_process_cache_memory_budget() == 0
+            num_over_budget = gaussian_process_module.get_gaussian_process_cache_num_over_budget()
+            gaussian_process = GaussianProcess(SquareExponential(python_cov.hyperparameters), historical_data)
+            assert gaussian_process.num_sampled == historical_data.num_sampled
+            assert model_cache.size == 0
+            assert gaussian_process_module.get_gaussian_process_cache_num_over_budget() == num_over_budget + 1
+
+            gaussian_process_module.set_gaussian_process_cache_memory_budget(memory_budget)
+            GaussianProcess(SquareExponential(python_cov.hyperparameters), historical_data)
+            assert model_cache.size == 1
+            gaussian_process_module.clear_gaussian_process_cache()
+            assert model_cache.size == 0
+        finally:
+            gaussian_process_module.set_gaussian_process_cache_memory_budget(memory_budget)
+
+    def test_snapshot_round_trip(self):
+        """Check that a GP loaded from a snapshot (memory-mapped, not refit) reproduces the saved GP exactly."""
+        for test_case in self.gp_test_environments:
+            domain, python_gp = test_case
+            python_cov, historical_data = python_gp.get_core_data_copy()
+            cpp_gp = GaussianProcess(SquareExponential(python_cov.hyperparameters), historical_data)._gaussian_process
+
+            snapshot_dir = tempfile.mkdtemp()
+            try:
+                snapshot_filename = os.path.join(snapshot_dir, 'gp.snapshot')
+                cpp_gp.write_snapshot(snapshot_filename)
+                loaded_gp = C_GP.load_gaussian_process_snapshot(snapshot_filename)
+            finally:
+                shutil.rmtree(snapshot_dir)
+
+            assert loaded_gp.num_sampled == cpp_gp.num_sampled
+            points_to_sample = cpp_utils.cppify(domain.generate_uniform_random_points_in_domain(5))
+            self.assert_vector_within_relative(
+                numpy.array(loaded_gp.compute_mean_of_points(points_to_sample, 5)),
+                numpy.array(cpp_gp.compute_mean_of_points(points_to_sample, 5)),
+                0.0,
+            )
+            self.assert_vector_within_relative(
+                numpy.array(loaded_gp.compute_variance_of_points(points_to_sample, 5)),
+                numpy.array(cpp_gp.compute_variance_of_points(points_to_sample, 5)),
+                0.0,
+            )
+
+    def test_mean_and_marginal_variance_match_full_variance(self):
+        """Check that the chunked mean/marginal variance matches the mean and the diagonal of the full variance."""
+        tolerance = 3.0e-13
+        num_to_sample = 300
+        for test_case in self.gp_test_environments:
+            domain, python_gp = test_case
+            python_cov, historical_data = python_gp.get_core_data_copy()
+            cpp_gp = GaussianProcess(SquareExponential(python_cov.hyperparameters), historical_data)
+
+            points_to_sample = domain.generate_uniform_random_points_in_domain(num_to_sample)
+            mean, marginal_variance = cpp_gp.compute_mean_and_marginal_variance_of_points(points_to_sample, max_num_threads=4)
+
+            self.assert_vector_within_relative(mean, cpp_gp.compute_mean_of_points(points_to_sample), tolerance)
+            self.assert_vector_within_relative(
+                marginal_variance,
+                numpy.diag(cpp_gp.compute_variance_of_points(points_to_sample)),
+                tolerance,
+            )
@@ -1,7 +1,13 @@
 # -*- coding: utf-8 -*-
 """Test cases to check that C++ and Python implementations of :mod:`moe.optimal_learning.python.interfaces.log_likelihood_interface` match."""
+import numpy
+
+import moe.build.GPP as C_GP
 import moe.optimal_learning.python.cpp_wrappers.covariance
+import moe.optimal_learning.python.cpp_wrappers.cpp_utils as cpp_utils
+import moe.optimal_learning.python.cpp_wrappers.domain
 import moe.optimal_learning.python.cpp_wrappers.log_likelihood
+import moe.optimal_learning.python.cpp_wrappers.optimization
 from moe.optimal_learning.python.geometry_utils import ClosedInterval
 import moe.optimal_learning.python.python_version.covariance
 import moe.optimal_learning.python.python_version.domain
@@ -55,3 +61,95 @@ class TestLogLikelihood(GaussianProcessTestCase):
             python_grad_log_like = python_lml.compute_grad_log_likelihood()
             cpp_grad_log_like = cpp_lml.compute_grad_log_likelihood()
             self.assert_vector_within_relative(python_grad_log_like, cpp_grad_log_like, tolerance_grad_log_like)
+
+    def test_buffer_and_list_overloads_match(self):
+        """Check that the zero-copy (buffer protocol) log likelihood overloads reproduce the list overloads exactly."""
+        for num_sampled in self.num_sampled_list:
+            self.gp_test_environment_input.num_sampled = num_sampled
+            _, python_gp = self._build_gaussian_process_test_data(self.gp_test_environment_input)
+            python_cov, historical_data = python_gp.get_core_data_copy()
+            hyperparameters = cpp_utils.cppify_hyperparameters(python_cov.hyperparameters)
+
+            for objective_type in (C_GP.LogLikelihoodTypes.log_marginal_likelihood, C_GP.LogLikelihoodTypes.leave_one_out_log_likelihood):
+                list_args = (
+                    cpp_utils.cppify(historical_data.points_sampled),
+                    cpp_utils.cppify(historical_data.points_sampled_value),
+                    self.dim,
+                    num_sampled,
+                    objective_type,
+                    C_GP.LeaveOneOutComputeTypes.matrix_inverse,
+                    C_GP.LogMarginalLikelihoodGradientTypes.full_tensor,
+                    hyperparameters,
+                    cpp_utils.cppify(historical_data.points_sampled_noise_variance),
+                )
+                buffer_args = (
+                    cpp_utils.cppify_buffer(historical_data.points_sampled),
+                    cpp_utils.cppify_buffer(historical_data.points_sampled_value),
+                    self.dim,
+                    num_sampled,
+                    objective_type,
+                    C_GP.LeaveOneOutComputeTypes.matrix_inverse,
+                    C_GP.LogMarginalLikelihoodGradientTypes.full_tensor,
+                    hyperparameters,
+                    cpp_utils.cppify_buffer(historical_data.points_sampled_noise_variance),
+                )
+
+                log_like = C_GP.compute_log_likelihood(*buffer_args)
+                self.assert_scalar_within_relative(log_like, C_GP.compute_log_likelihood(*list_args), 0.0)
+
+                grad_log_like = numpy.empty(self.num_hyperparameters)
+                C_GP.compute_hyperparameter_grad_log_likelihood(*(buffer_args + (grad_log_like, )))
+                expected_grad_log_like = numpy.array(C_GP.compute_hyperparameter_grad_log_likelihood(*list_args))
+                self.assert_vector_within_relative(grad_log_like, expected_grad_log_like, 0.0)
+
+    def test_multistart_lbfgs_hyperparameter_optimization(self):
+        """Check that multistart L-BFGS hyperparameter optimization, plain and adaptive, improves the log marginal likelihood."""
+        num_multistarts = 16
+        max_num_threads = 4
+        seed = 5762
+
+        self.gp_test_environment_input.num_sampled = 42
+        _, python_gp = self._build_gaussian_process_test_data(self.gp_test_environment_input)
+        python_cov, historical_data = python_gp.get_core_data_copy()
+        cpp_cov = moe.optimal_learning.python.cpp_wrappers.covariance.SquareExponential(python_cov.hyperparameters)
+        cpp_lml = moe.optimal_learning.python.cpp_wrappers.log_likelihood.GaussianProcessLogMarginalLikelihood(cpp_cov, historical_data)
+        hyperparameter_domain = moe.optimal_learning.python.cpp_wrappers.domain.TensorProductDomain(
+            [ClosedInterval(0.01, 10.0)] * self.num_hyperparameters,
+        )
+
+        lbfgs_parameters = moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSParameters(
+            num_multistarts, 200, 10, 30, 1.0e-12,
+        )
+        adaptive_parameters = moe.optimal_learning.python.cpp_wrappers.optimization.AdaptiveMultistartParameters(
+            3, 0.5, max_num_threads, float('inf'),
+        )
+
+        def optimize(optimizer_adaptive_parameters, status):
+            """Optimize the log marginal likelihood with a freshly seeded RNG so that both runs start from the same points."""
+            optimizer = moe.optimal_learning.python.cpp_wrappers.optimization.LBFGSOptimizer(
+                hyperparameter_domain,
+                cpp_lml,
+                lbfgs_parameters,
+                adaptive_parameters=optimizer_adaptive_parameters,
+            )
+            randomness = C_GP.RandomnessSourceContainer(max_num_threads)
+            randomness.SetExplicitUniformGeneratorSeed(seed)
+            return moe.optimal_learning.python.cpp_wrappers.log_likelihood.multistart_hyperparameter_optimization(
+                optimizer,
+                num_multistarts,
+                randomness=randomness,
+                max_num_threads=max_num_threads,
+                status=status,
+            )
+
+        initial_log_like = cpp_lml.compute_log_likelihood()
+        # screening is a heuristic (it may drop the start that leads to the global optimum); only check for an improvement
+        for optimizer_adaptive_parameters in (None, adaptive_parameters):
+            status = {}
+            hyperparameters = optimize(optimizer_adaptive_parameters, status)
+            assert status['log_marginal_likelihood_lbfgs_found_update']
+            assert hyperparameter_domain.check_point_inside(hyperparameters)
+
+            cpp_lml.set_hyperparameters(hyperparameters)
+            assert cpp_lml.compute_log_likelihood() > initial_log_like
+            cpp_lml.set_hyperparameters(python_cov.hyperparameters)